@@ -20,9 +20,11 @@
 #include "ColorConvNEON.h"
 #include "Common.h"
 #include "CPUDetect.h"
+#include "Common/Math/math_util.h"
 
 #ifdef _M_SSE
 #include <emmintrin.h>
+#include <immintrin.h>
 #endif
 
 #if _M_SSE >= 0x401
@@ -53,6 +55,148 @@ inline u16 RGBA8888toRGBA5551(u32 px) {
 	return ((px >> 3) & 0x001F) | ((px >> 6) & 0x03E0) | ((px >> 9) & 0x7C00) | ((px >> 16) & 0x8000);
 }
 
+#ifdef _M_SSE
+// The AVX2 versions do 16 pixels at a time, and return how many they did.  Unaligned is fine.
+
+// Interleaves RRGG and BBAA into whole pixels.  Unpack works within 128-bit halves, so they're put back in order.
+PPSSPP_TARGET_AVX2
+static inline void StoreRGBA8888AVX2(__m256i *dstp, __m256i rg, __m256i ba) {
+	const __m256i lo = _mm256_unpacklo_epi16(rg, ba);
+	const __m256i hi = _mm256_unpackhi_epi16(rg, ba);
+	_mm256_storeu_si256(dstp + 0, _mm256_permute2x128_si256(lo, hi, 0x20));
+	_mm256_storeu_si256(dstp + 1, _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+PPSSPP_TARGET_AVX2
+static u32 ConvertRGB565ToRGBA8888AVX2(u32 *dst32, const u16 *src, u32 numPixels) {
+	const __m256i mask5 = _mm256_set1_epi16(0x001f);
+	const __m256i mask6 = _mm256_set1_epi16(0x003f);
+	const __m256i mask8 = _mm256_set1_epi16(0x00ff);
+	const __m256i a = _mm256_slli_epi16(mask8, 8);
+
+	const __m256i *srcp = (const __m256i *)src;
+	__m256i *dstp = (__m256i *)dst32;
+	const u32 chunks = numPixels / 16;
+	for (u32 i = 0; i < chunks; ++i) {
+		const __m256i c = _mm256_loadu_si256(&srcp[i]);
+
+		__m256i r = _mm256_and_si256(c, mask5);
+		r = _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2)), mask8);
+		__m256i g = _mm256_and_si256(_mm256_srli_epi16(c, 5), mask6);
+		g = _mm256_slli_epi16(_mm256_or_si256(_mm256_slli_epi16(g, 2), _mm256_srli_epi16(g, 4)), 8);
+		__m256i b = _mm256_srli_epi16(c, 11);
+		b = _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2)), mask8);
+
+		StoreRGBA8888AVX2(&dstp[i * 2], _mm256_or_si256(r, g), _mm256_or_si256(b, a));
+	}
+	return chunks * 16;
+}
+
+PPSSPP_TARGET_AVX2
+static u32 ConvertRGBA5551ToRGBA8888AVX2(u32 *dst32, const u16 *src, u32 numPixels) {
+	const __m256i mask5 = _mm256_set1_epi16(0x001f);
+	const __m256i mask8 = _mm256_set1_epi16(0x00ff);
+
+	const __m256i *srcp = (const __m256i *)src;
+	__m256i *dstp = (__m256i *)dst32;
+	const u32 chunks = numPixels / 16;
+	for (u32 i = 0; i < chunks; ++i) {
+		const __m256i c = _mm256_loadu_si256(&srcp[i]);
+
+		__m256i r = _mm256_and_si256(c, mask5);
+		r = _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2)), mask8);
+		__m256i g = _mm256_and_si256(_mm256_srli_epi16(c, 5), mask5);
+		g = _mm256_slli_epi16(_mm256_or_si256(_mm256_slli_epi16(g, 3), _mm256_srli_epi16(g, 2)), 8);
+		__m256i b = _mm256_and_si256(_mm256_srli_epi16(c, 10), mask5);
+		b = _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2)), mask8);
+		const __m256i a = _mm256_slli_epi16(_mm256_srai_epi16(c, 15), 8);
+
+		StoreRGBA8888AVX2(&dstp[i * 2], _mm256_or_si256(r, g), _mm256_or_si256(b, a));
+	}
+	return chunks * 16;
+}
+
+PPSSPP_TARGET_AVX2
+static u32 ConvertRGBA4444ToRGBA8888AVX2(u32 *dst32, const u16 *src, u32 numPixels) {
+	const __m256i mask4 = _mm256_set1_epi16(0x000f);
+
+	const __m256i *srcp = (const __m256i *)src;
+	__m256i *dstp = (__m256i *)dst32;
+	const u32 chunks = numPixels / 16;
+	for (u32 i = 0; i < chunks; ++i) {
+		const __m256i c = _mm256_loadu_si256(&srcp[i]);
+
+		// Same as SSE: R0G0 and B0A0 first, then swizzle both at once.
+		const __m256i r = _mm256_and_si256(c, mask4);
+		const __m256i g = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(c, 4), mask4), 8);
+		const __m256i b = _mm256_and_si256(_mm256_srli_epi16(c, 8), mask4);
+		const __m256i a = _mm256_slli_epi16(_mm256_srli_epi16(c, 12), 8);
+
+		__m256i rg = _mm256_or_si256(r, g);
+		__m256i ba = _mm256_or_si256(b, a);
+		rg = _mm256_or_si256(rg, _mm256_slli_epi16(rg, 4));
+		ba = _mm256_or_si256(ba, _mm256_slli_epi16(ba, 4));
+
+		StoreRGBA8888AVX2(&dstp[i * 2], rg, ba);
+	}
+	return chunks * 16;
+}
+
+PPSSPP_TARGET_AVX2
+static u32 ConvertRGBA4444ToABGR4444AVX2(u16 *dst, const u16 *src, u32 numPixels) {
+	const __m256i mask0040 = _mm256_set1_epi16(0x00F0);
+
+	const __m256i *srcp = (const __m256i *)src;
+	__m256i *dstp = (__m256i *)dst;
+	const u32 chunks = numPixels / 16;
+	for (u32 i = 0; i < chunks; ++i) {
+		const __m256i c = _mm256_loadu_si256(&srcp[i]);
+		__m256i v = _mm256_srli_epi16(c, 12);
+		v = _mm256_or_si256(v, _mm256_and_si256(_mm256_srli_epi16(c, 4), mask0040));
+		v = _mm256_or_si256(v, _mm256_slli_epi16(_mm256_and_si256(c, mask0040), 4));
+		v = _mm256_or_si256(v, _mm256_slli_epi16(c, 12));
+		_mm256_storeu_si256(&dstp[i], v);
+	}
+	return chunks * 16;
+}
+
+PPSSPP_TARGET_AVX2
+static u32 ConvertRGBA5551ToABGR1555AVX2(u16 *dst, const u16 *src, u32 numPixels) {
+	const __m256i maskB = _mm256_set1_epi16(0x003E);
+	const __m256i maskG = _mm256_set1_epi16(0x07C0);
+
+	const __m256i *srcp = (const __m256i *)src;
+	__m256i *dstp = (__m256i *)dst;
+	const u32 chunks = numPixels / 16;
+	for (u32 i = 0; i < chunks; ++i) {
+		const __m256i c = _mm256_loadu_si256(&srcp[i]);
+		__m256i v = _mm256_srli_epi16(c, 15);
+		v = _mm256_or_si256(v, _mm256_and_si256(_mm256_srli_epi16(c, 9), maskB));
+		v = _mm256_or_si256(v, _mm256_and_si256(_mm256_slli_epi16(c, 1), maskG));
+		v = _mm256_or_si256(v, _mm256_slli_epi16(c, 11));
+		_mm256_storeu_si256(&dstp[i], v);
+	}
+	return chunks * 16;
+}
+
+PPSSPP_TARGET_AVX2
+static u32 ConvertRGB565ToBGR565AVX2(u16 *dst, const u16 *src, u32 numPixels) {
+	const __m256i maskG = _mm256_set1_epi16(0x07E0);
+
+	const __m256i *srcp = (const __m256i *)src;
+	__m256i *dstp = (__m256i *)dst;
+	const u32 chunks = numPixels / 16;
+	for (u32 i = 0; i < chunks; ++i) {
+		const __m256i c = _mm256_loadu_si256(&srcp[i]);
+		__m256i v = _mm256_srli_epi16(c, 11);
+		v = _mm256_or_si256(v, _mm256_and_si256(c, maskG));
+		v = _mm256_or_si256(v, _mm256_slli_epi16(c, 11));
+		_mm256_storeu_si256(&dstp[i], v);
+	}
+	return chunks * 16;
+}
+#endif
+
 // convert 4444 image to 8888, parallelizable
 void convert4444_gl(u16* data, u32* out, int width, int l, int u) {
 	for (int y = l; y < u; ++y) {
@@ -280,6 +424,13 @@ void ConvertRGBA8888ToRGBA4444(u16 *dst, const u32 *src, u32 numPixels) {
 
 void ConvertRGB565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 #ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		const u32 done = ConvertRGB565ToRGBA8888AVX2(dst32, src, numPixels);
+		dst32 += done;
+		src += done;
+		numPixels -= done;
+	}
+
 	const __m128i mask5 = _mm_set1_epi16(0x001f);
 	const __m128i mask6 = _mm_set1_epi16(0x003f);
 	const __m128i mask8 = _mm_set1_epi16(0x00ff);
@@ -334,6 +485,13 @@ void ConvertRGB565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 
 void ConvertRGBA5551ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 #ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		const u32 done = ConvertRGBA5551ToRGBA8888AVX2(dst32, src, numPixels);
+		dst32 += done;
+		src += done;
+		numPixels -= done;
+	}
+
 	const __m128i mask5 = _mm_set1_epi16(0x001f);
 	const __m128i mask8 = _mm_set1_epi16(0x00ff);
 
@@ -388,6 +546,13 @@ void ConvertRGBA5551ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 
 void ConvertRGBA4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 #ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		const u32 done = ConvertRGBA4444ToRGBA8888AVX2(dst32, src, numPixels);
+		dst32 += done;
+		src += done;
+		numPixels -= done;
+	}
+
 	const __m128i mask4 = _mm_set1_epi16(0x000f);
 
 	const __m128i *srcp = (const __m128i *)src;
@@ -507,6 +672,13 @@ void ConvertRGB565ToBGRA8888(u32 *dst, const u16 *src, u32 numPixels) {
 
 void ConvertRGBA4444ToABGR4444Basic(u16 *dst, const u16 *src, u32 numPixels) {
 #ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		const u32 done = ConvertRGBA4444ToABGR4444AVX2(dst, src, numPixels);
+		dst += done;
+		src += done;
+		numPixels -= done;
+	}
+
 	const __m128i mask0040 = _mm_set1_epi16(0x00F0);
 
 	const __m128i *srcp = (const __m128i *)src;
@@ -551,6 +723,13 @@ void ConvertRGBA4444ToABGR4444Basic(u16 *dst, const u16 *src, u32 numPixels) {
 
 void ConvertRGBA5551ToABGR1555Basic(u16 *dst, const u16 *src, u32 numPixels) {
 #ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		const u32 done = ConvertRGBA5551ToABGR1555AVX2(dst, src, numPixels);
+		dst += done;
+		src += done;
+		numPixels -= done;
+	}
+
 	const __m128i maskB = _mm_set1_epi16(0x003E);
 	const __m128i maskG = _mm_set1_epi16(0x07C0);
 
@@ -596,6 +775,13 @@ void ConvertRGBA5551ToABGR1555Basic(u16 *dst, const u16 *src, u32 numPixels) {
 
 void ConvertRGB565ToBGR565Basic(u16 *dst, const u16 *src, u32 numPixels) {
 #ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		const u32 done = ConvertRGB565ToBGR565AVX2(dst, src, numPixels);
+		dst += done;
+		src += done;
+		numPixels -= done;
+	}
+
 	const __m128i maskG = _mm_set1_epi16(0x07E0);
 
 	const __m128i *srcp = (const __m128i *)src;
@@ -635,6 +821,126 @@ void ConvertRGB565ToBGR565Basic(u16 *dst, const u16 *src, u32 numPixels) {
 	}
 }
 
+enum class YUVDest {
+	RGBA8888,
+	RGB565,
+	RGBA5551,
+	RGBA4444,
+};
+
+template <YUVDest format>
+static inline void ConvertYUV420PixelsScalar(void *dst, const u8 *ySrc, const u8 *uSrc, const u8 *vSrc, u32 start, u32 numPixels) {
+	for (u32 x = start; x < numPixels; ++x) {
+		int y = (ySrc[x] - YUV_Y_OFFSET) * YUV_Y_SCALE + 32;
+		int u = uSrc[x >> 1] - 128;
+		int v = vSrc[x >> 1] - 128;
+		int r = clamp_value((y + YUV_V_TO_R * v) >> 6, 0, 255);
+		int g = clamp_value((y - YUV_V_TO_G * v - YUV_U_TO_G * u) >> 6, 0, 255);
+		int b = clamp_value((y + YUV_U_TO_B * u) >> 6, 0, 255);
+		switch (format) {
+		case YUVDest::RGBA8888:
+			((u32 *)dst)[x] = r | (g << 8) | (b << 16);
+			break;
+		case YUVDest::RGB565:
+			((u16 *)dst)[x] = (r >> 3) | ((g >> 2) << 5) | ((b >> 3) << 11);
+			break;
+		case YUVDest::RGBA5551:
+			((u16 *)dst)[x] = (r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10);
+			break;
+		case YUVDest::RGBA4444:
+			((u16 *)dst)[x] = (r >> 4) | ((g >> 4) << 4) | ((b >> 4) << 8);
+			break;
+		}
+	}
+}
+
+#ifdef _M_SSE
+template <YUVDest format>
+static inline __m128i PackYUV420PixelsSSE2(__m128i r, __m128i g, __m128i b) {
+	// r, g, b are clamped 0-255 in 16-bit lanes.
+	switch (format) {
+	case YUVDest::RGB565:
+		return _mm_or_si128(_mm_or_si128(_mm_srli_epi16(r, 3), _mm_slli_epi16(_mm_srli_epi16(g, 2), 5)), _mm_slli_epi16(_mm_srli_epi16(b, 3), 11));
+	case YUVDest::RGBA5551:
+		return _mm_or_si128(_mm_or_si128(_mm_srli_epi16(r, 3), _mm_slli_epi16(_mm_srli_epi16(g, 3), 5)), _mm_slli_epi16(_mm_srli_epi16(b, 3), 10));
+	default:
+		return _mm_or_si128(_mm_or_si128(_mm_srli_epi16(r, 4), _mm_slli_epi16(_mm_srli_epi16(g, 4), 4)), _mm_slli_epi16(_mm_srli_epi16(b, 4), 8));
+	}
+}
+#endif
+
+template <YUVDest format>
+static void ConvertYUV420Pixels(void *dstp, const u8 *ySrc, const u8 *uSrc, const u8 *vSrc, u32 numPixels) {
+	u32 x = 0;
+#ifdef _M_SSE
+	u8 *dst = (u8 *)dstp;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i maxValue = _mm_set1_epi16(255);
+	const __m128i yOffset = _mm_set1_epi16(YUV_Y_OFFSET);
+	const __m128i uvOffset = _mm_set1_epi16(128);
+	const __m128i round = _mm_set1_epi16(32);
+	for (; x + 16 <= numPixels; x += 16) {
+		__m128i yBytes = _mm_loadu_si128((const __m128i *)(ySrc + x));
+		__m128i uBytes = _mm_loadl_epi64((const __m128i *)(uSrc + x / 2));
+		__m128i vBytes = _mm_loadl_epi64((const __m128i *)(vSrc + x / 2));
+		// Each chroma sample covers two pixels.
+		uBytes = _mm_unpacklo_epi8(uBytes, uBytes);
+		vBytes = _mm_unpacklo_epi8(vBytes, vBytes);
+
+		__m128i rgb[2][3];
+		for (int half = 0; half < 2; ++half) {
+			__m128i y = half == 0 ? _mm_unpacklo_epi8(yBytes, zero) : _mm_unpackhi_epi8(yBytes, zero);
+			__m128i u = half == 0 ? _mm_unpacklo_epi8(uBytes, zero) : _mm_unpackhi_epi8(uBytes, zero);
+			__m128i v = half == 0 ? _mm_unpacklo_epi8(vBytes, zero) : _mm_unpackhi_epi8(vBytes, zero);
+			y = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(y, yOffset), _mm_set1_epi16(YUV_Y_SCALE)), round);
+			u = _mm_sub_epi16(u, uvOffset);
+			v = _mm_sub_epi16(v, uvOffset);
+			// Only blue can go past 16 bits, and saturating still clamps it to 255 after the shift.
+			__m128i r = _mm_adds_epi16(y, _mm_mullo_epi16(v, _mm_set1_epi16(YUV_V_TO_R)));
+			__m128i g = _mm_sub_epi16(_mm_sub_epi16(y, _mm_mullo_epi16(v, _mm_set1_epi16(YUV_V_TO_G))), _mm_mullo_epi16(u, _mm_set1_epi16(YUV_U_TO_G)));
+			__m128i b = _mm_adds_epi16(y, _mm_mullo_epi16(u, _mm_set1_epi16(YUV_U_TO_B)));
+			rgb[half][0] = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(r, 6), zero), maxValue);
+			rgb[half][1] = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(g, 6), zero), maxValue);
+			rgb[half][2] = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(b, 6), zero), maxValue);
+		}
+
+		if (format == YUVDest::RGBA8888) {
+			__m128i r = _mm_packus_epi16(rgb[0][0], rgb[1][0]);
+			__m128i g = _mm_packus_epi16(rgb[0][1], rgb[1][1]);
+			__m128i b = _mm_packus_epi16(rgb[0][2], rgb[1][2]);
+			__m128i rgLo = _mm_unpacklo_epi8(r, g);
+			__m128i rgHi = _mm_unpackhi_epi8(r, g);
+			__m128i b0Lo = _mm_unpacklo_epi8(b, zero);
+			__m128i b0Hi = _mm_unpackhi_epi8(b, zero);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 0), _mm_unpacklo_epi16(rgLo, b0Lo));
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), _mm_unpackhi_epi16(rgLo, b0Lo));
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 32), _mm_unpacklo_epi16(rgHi, b0Hi));
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 48), _mm_unpackhi_epi16(rgHi, b0Hi));
+		} else {
+			_mm_storeu_si128((__m128i *)(dst + x * 2 + 0), PackYUV420PixelsSSE2<format>(rgb[0][0], rgb[0][1], rgb[0][2]));
+			_mm_storeu_si128((__m128i *)(dst + x * 2 + 16), PackYUV420PixelsSSE2<format>(rgb[1][0], rgb[1][1], rgb[1][2]));
+		}
+	}
+#endif
+	ConvertYUV420PixelsScalar<format>(dstp, ySrc, uSrc, vSrc, x, numPixels);
+}
+
+void ConvertYUV420ToRGBA8888Basic(u32 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	ConvertYUV420Pixels<YUVDest::RGBA8888>(dst, y, u, v, numPixels);
+}
+
+void ConvertYUV420ToRGB565Basic(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	ConvertYUV420Pixels<YUVDest::RGB565>(dst, y, u, v, numPixels);
+}
+
+void ConvertYUV420ToRGBA5551Basic(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	ConvertYUV420Pixels<YUVDest::RGBA5551>(dst, y, u, v, numPixels);
+}
+
+void ConvertYUV420ToRGBA4444Basic(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	ConvertYUV420Pixels<YUVDest::RGBA4444>(dst, y, u, v, numPixels);
+}
+
 // Reuse the logic from the header - if these aren't defined, we need externs.
 #ifndef ConvertRGBA4444ToABGR4444
 Convert16bppTo16bppFunc ConvertRGBA4444ToABGR4444 = &ConvertRGBA4444ToABGR4444Basic;
@@ -642,12 +948,23 @@ Convert16bppTo16bppFunc ConvertRGBA5551ToABGR1555 = &ConvertRGBA5551ToABGR1555Ba
 Convert16bppTo16bppFunc ConvertRGB565ToBGR565 = &ConvertRGB565ToBGR565Basic;
 #endif
 
+#ifndef ConvertYUV420ToRGBA8888
+ConvertYUV420To32bppFunc ConvertYUV420ToRGBA8888 = &ConvertYUV420ToRGBA8888Basic;
+ConvertYUV420To16bppFunc ConvertYUV420ToRGB565 = &ConvertYUV420ToRGB565Basic;
+ConvertYUV420To16bppFunc ConvertYUV420ToRGBA5551 = &ConvertYUV420ToRGBA5551Basic;
+ConvertYUV420To16bppFunc ConvertYUV420ToRGBA4444 = &ConvertYUV420ToRGBA4444Basic;
+#endif
+
 void SetupColorConv() {
 #if PPSSPP_ARCH(ARM_NEON) && !PPSSPP_ARCH(ARM64)
 	if (cpu_info.bNEON) {
 		ConvertRGBA4444ToABGR4444 = &ConvertRGBA4444ToABGR4444NEON;
 		ConvertRGBA5551ToABGR1555 = &ConvertRGBA5551ToABGR1555NEON;
 		ConvertRGB565ToBGR565 = &ConvertRGB565ToBGR565NEON;
+		ConvertYUV420ToRGBA8888 = &ConvertYUV420ToRGBA8888NEON;
+		ConvertYUV420ToRGB565 = &ConvertYUV420ToRGB565NEON;
+		ConvertYUV420ToRGBA5551 = &ConvertYUV420ToRGBA5551NEON;
+		ConvertYUV420ToRGBA4444 = &ConvertYUV420ToRGBA4444NEON;
 	}
 #endif
 }
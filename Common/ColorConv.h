@@ -158,3 +158,40 @@ extern Convert16bppTo16bppFunc ConvertRGBA5551ToABGR1555;
 #else
 extern Convert16bppTo16bppFunc ConvertRGB565ToBGR565;
 #endif
+
+// One line of BT.601 limited range YUV 4:2:0 (so u and v are half width) to the usual formats.
+// Alpha is left zero, like video on the PSP.  Each chroma sample is just used for two pixels,
+// and the math is fixed point with 6 fractional bits, so every version gives the same result.
+enum {
+	YUV_Y_OFFSET = 16,
+	YUV_Y_SCALE = 74,    // 1.164
+	YUV_V_TO_R = 102,    // 1.596
+	YUV_V_TO_G = 52,     // 0.813
+	YUV_U_TO_G = 25,     // 0.391
+	YUV_U_TO_B = 129,    // 2.018
+};
+
+typedef void (*ConvertYUV420To16bppFunc)(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+typedef void (*ConvertYUV420To32bppFunc)(u32 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+
+void ConvertYUV420ToRGBA8888Basic(u32 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+void ConvertYUV420ToRGB565Basic(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+void ConvertYUV420ToRGBA5551Basic(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+void ConvertYUV420ToRGBA4444Basic(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+
+#if PPSSPP_ARCH(ARM64)
+#define ConvertYUV420ToRGBA8888 ConvertYUV420ToRGBA8888NEON
+#define ConvertYUV420ToRGB565 ConvertYUV420ToRGB565NEON
+#define ConvertYUV420ToRGBA5551 ConvertYUV420ToRGBA5551NEON
+#define ConvertYUV420ToRGBA4444 ConvertYUV420ToRGBA4444NEON
+#elif !PPSSPP_ARCH(ARM)
+#define ConvertYUV420ToRGBA8888 ConvertYUV420ToRGBA8888Basic
+#define ConvertYUV420ToRGB565 ConvertYUV420ToRGB565Basic
+#define ConvertYUV420ToRGBA5551 ConvertYUV420ToRGBA5551Basic
+#define ConvertYUV420ToRGBA4444 ConvertYUV420ToRGBA4444Basic
+#else
+extern ConvertYUV420To32bppFunc ConvertYUV420ToRGBA8888;
+extern ConvertYUV420To16bppFunc ConvertYUV420ToRGB565;
+extern ConvertYUV420To16bppFunc ConvertYUV420ToRGBA5551;
+extern ConvertYUV420To16bppFunc ConvertYUV420ToRGBA4444;
+#endif
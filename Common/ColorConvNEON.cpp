@@ -115,4 +115,98 @@ void ConvertRGB565ToBGR565NEON(u16 *dst, const u16 *src, u32 numPixels) {
 	}
 }
 
+// Converts 16 pixels to r, g, b bytes, 8 at a time.
+static inline void ConvertYUV420PixelsNEON(uint8x8_t rgb[2][3], const u8 *ySrc, const u8 *uSrc, const u8 *vSrc) {
+	const int16x8_t yOffset = vdupq_n_s16(YUV_Y_OFFSET);
+	const int16x8_t uvOffset = vdupq_n_s16(128);
+
+	uint8x16_t yBytes = vld1q_u8(ySrc);
+	// Each chroma sample covers two pixels.
+	uint8x8_t uHalf = vld1_u8(uSrc);
+	uint8x8_t vHalf = vld1_u8(vSrc);
+	uint8x8x2_t uBytes = vzip_u8(uHalf, uHalf);
+	uint8x8x2_t vBytes = vzip_u8(vHalf, vHalf);
+
+	for (int half = 0; half < 2; ++half) {
+		int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(half == 0 ? vget_low_u8(yBytes) : vget_high_u8(yBytes)));
+		int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(uBytes.val[half])), uvOffset);
+		int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vBytes.val[half])), uvOffset);
+		y = vmulq_n_s16(vsubq_s16(y, yOffset), YUV_Y_SCALE);
+		// Only blue can go past 16 bits, and saturating still clamps it to 255 after the shift.
+		int16x8_t r = vqaddq_s16(y, vmulq_n_s16(v, YUV_V_TO_R));
+		int16x8_t g = vsubq_s16(vsubq_s16(y, vmulq_n_s16(v, YUV_V_TO_G)), vmulq_n_s16(u, YUV_U_TO_G));
+		int16x8_t b = vqaddq_s16(y, vmulq_n_s16(u, YUV_U_TO_B));
+		// Rounds, shifts out the fraction, and clamps to 0-255.
+		rgb[half][0] = vqrshrun_n_s16(r, 6);
+		rgb[half][1] = vqrshrun_n_s16(g, 6);
+		rgb[half][2] = vqrshrun_n_s16(b, 6);
+	}
+}
+
+void ConvertYUV420ToRGBA8888NEON(u32 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	u32 x = 0;
+	for (; x + 16 <= numPixels; x += 16) {
+		uint8x8_t rgb[2][3];
+		ConvertYUV420PixelsNEON(rgb, y + x, u + x / 2, v + x / 2);
+
+		uint8x16x4_t rgba;
+		rgba.val[0] = vcombine_u8(rgb[0][0], rgb[1][0]);
+		rgba.val[1] = vcombine_u8(rgb[0][1], rgb[1][1]);
+		rgba.val[2] = vcombine_u8(rgb[0][2], rgb[1][2]);
+		rgba.val[3] = vdupq_n_u8(0);
+		vst4q_u8((u8 *)(dst + x), rgba);
+	}
+	// x is even, so the chroma for the rest starts at x / 2.
+	if (x < numPixels)
+		ConvertYUV420ToRGBA8888Basic(dst + x, y + x, u + x / 2, v + x / 2, numPixels - x);
+}
+
+void ConvertYUV420ToRGB565NEON(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	u32 x = 0;
+	for (; x + 16 <= numPixels; x += 16) {
+		uint8x8_t rgb[2][3];
+		ConvertYUV420PixelsNEON(rgb, y + x, u + x / 2, v + x / 2);
+		for (int half = 0; half < 2; ++half) {
+			uint16x8_t pixels = vmovl_u8(vshr_n_u8(rgb[half][0], 3));
+			pixels = vorrq_u16(pixels, vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb[half][1], 2)), 5));
+			pixels = vorrq_u16(pixels, vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb[half][2], 3)), 11));
+			vst1q_u16(dst + x + half * 8, pixels);
+		}
+	}
+	if (x < numPixels)
+		ConvertYUV420ToRGB565Basic(dst + x, y + x, u + x / 2, v + x / 2, numPixels - x);
+}
+
+void ConvertYUV420ToRGBA5551NEON(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	u32 x = 0;
+	for (; x + 16 <= numPixels; x += 16) {
+		uint8x8_t rgb[2][3];
+		ConvertYUV420PixelsNEON(rgb, y + x, u + x / 2, v + x / 2);
+		for (int half = 0; half < 2; ++half) {
+			uint16x8_t pixels = vmovl_u8(vshr_n_u8(rgb[half][0], 3));
+			pixels = vorrq_u16(pixels, vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb[half][1], 3)), 5));
+			pixels = vorrq_u16(pixels, vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb[half][2], 3)), 10));
+			vst1q_u16(dst + x + half * 8, pixels);
+		}
+	}
+	if (x < numPixels)
+		ConvertYUV420ToRGBA5551Basic(dst + x, y + x, u + x / 2, v + x / 2, numPixels - x);
+}
+
+void ConvertYUV420ToRGBA4444NEON(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels) {
+	u32 x = 0;
+	for (; x + 16 <= numPixels; x += 16) {
+		uint8x8_t rgb[2][3];
+		ConvertYUV420PixelsNEON(rgb, y + x, u + x / 2, v + x / 2);
+		for (int half = 0; half < 2; ++half) {
+			uint16x8_t pixels = vmovl_u8(vshr_n_u8(rgb[half][0], 4));
+			pixels = vorrq_u16(pixels, vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb[half][1], 4)), 4));
+			pixels = vorrq_u16(pixels, vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb[half][2], 4)), 8));
+			vst1q_u16(dst + x + half * 8, pixels);
+		}
+	}
+	if (x < numPixels)
+		ConvertYUV420ToRGBA4444Basic(dst + x, y + x, u + x / 2, v + x / 2, numPixels - x);
+}
+
 #endif // PPSSPP_ARCH(ARM_NEON)
@@ -22,3 +22,8 @@
 void ConvertRGBA4444ToABGR4444NEON(u16 *dst, const u16 *src, u32 numPixels);
 void ConvertRGBA5551ToABGR1555NEON(u16 *dst, const u16 *src, u32 numPixels);
 void ConvertRGB565ToBGR565NEON(u16 *dst, const u16 *src, u32 numPixels);
+
+void ConvertYUV420ToRGBA8888NEON(u32 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+void ConvertYUV420ToRGB565NEON(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+void ConvertYUV420ToRGBA5551NEON(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
+void ConvertYUV420ToRGBA4444NEON(u16 *dst, const u8 *y, const u8 *u, const u8 *v, u32 numPixels);
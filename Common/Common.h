@@ -95,3 +95,10 @@
 #elif !defined(__GNUC__) && (defined(_M_X64) || defined(_M_IX86))
 # define _M_SSE 0x402
 #endif
+
+// Lets a function use AVX2 without building everything for it.  Only call these after checking cpu_info.bAVX2.
+#if defined(_M_SSE) && defined(__GNUC__)
+# define PPSSPP_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_M_SSE)
+# define PPSSPP_TARGET_AVX2
+#endif
@@ -15,9 +15,13 @@
 // Official SVN repository and contact information can be found at
 // http://code.google.com/p/dolphin-emu/
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <vector>
 #include <snappy-c.h>
+#include <zlib.h>
 
 #include "Common/Serialize/Serializer.h"
 #include "Common/Serialize/SerializeFuncs.h"
@@ -185,6 +189,112 @@ PointerWrapSection::~PointerWrapSection() {
 	}
 }
 
+// Chunked states start with the chunk size and count, followed by the compressed size of each chunk.
+static const u32 STATE_CHUNK_SIZE = 1024 * 1024;
+
+static CChunkFileReader::ParallelLoop parallelLoop;
+
+void CChunkFileReader::SetParallelLoop(ParallelLoop loop) {
+	parallelLoop = loop;
+}
+
+// Runs func(i) for each chunk, in parallel if we have a way to.
+static void ForEachChunk(u32 numChunks, const std::function<void(u32)> &func) {
+	if (!parallelLoop || numChunks <= 1) {
+		for (u32 i = 0; i < numChunks; ++i)
+			func(i);
+		return;
+	}
+
+	parallelLoop([&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i)
+			func((u32)i);
+	}, 0, (int)numChunks);
+}
+
+static bool CompressChunks(const u8 *buffer, size_t sz, CChunkFileReader::Compression compression, std::vector<u8> &result) {
+	u32 numChunks = (u32)((sz + STATE_CHUNK_SIZE - 1) / STATE_CHUNK_SIZE);
+	std::vector<std::vector<u8>> chunks(numChunks);
+	std::vector<u8> success(numChunks);
+
+	ForEachChunk(numChunks, [&](u32 i) {
+		const u8 *src = buffer + (size_t)i * STATE_CHUNK_SIZE;
+		size_t srcLen = std::min((size_t)STATE_CHUNK_SIZE, sz - (size_t)i * STATE_CHUNK_SIZE);
+		std::vector<u8> &dest = chunks[i];
+		if (compression == CChunkFileReader::Compression::DEFLATE_CHUNKED) {
+			uLongf destLen = compressBound((uLong)srcLen);
+			dest.resize(destLen);
+			success[i] = compress2(&dest[0], &destLen, src, (uLong)srcLen, Z_BEST_COMPRESSION) == Z_OK;
+			dest.resize(destLen);
+		} else {
+			size_t destLen = snappy_max_compressed_length(srcLen);
+			dest.resize(destLen);
+			success[i] = snappy_compress((const char *)src, srcLen, (char *)&dest[0], &destLen) == SNAPPY_OK;
+			dest.resize(destLen);
+		}
+	});
+
+	if (std::find(success.begin(), success.end(), 0) != success.end())
+		return false;
+
+	size_t total = 2 * sizeof(u32) + numChunks * sizeof(u32);
+	for (const auto &chunk : chunks)
+		total += chunk.size();
+	result.resize(total);
+
+	u32 *table = (u32 *)&result[0];
+	table[0] = STATE_CHUNK_SIZE;
+	table[1] = numChunks;
+	size_t pos = 2 * sizeof(u32) + numChunks * sizeof(u32);
+	for (u32 i = 0; i < numChunks; ++i) {
+		table[2 + i] = (u32)chunks[i].size();
+		memcpy(&result[pos], chunks[i].data(), chunks[i].size());
+		pos += chunks[i].size();
+	}
+	return true;
+}
+
+static bool DecompressChunks(const u8 *buffer, size_t sz, CChunkFileReader::Compression compression, u8 *result, size_t resultSize) {
+	if (sz < 2 * sizeof(u32))
+		return false;
+	u32 chunkSize, numChunks;
+	memcpy(&chunkSize, buffer, sizeof(u32));
+	memcpy(&numChunks, buffer + sizeof(u32), sizeof(u32));
+	if (chunkSize == 0 || numChunks != (resultSize + chunkSize - 1) / chunkSize)
+		return false;
+	size_t tableSize = 2 * sizeof(u32) + (size_t)numChunks * sizeof(u32);
+	if (sz < tableSize)
+		return false;
+
+	// Validate the table and find where each chunk starts.
+	std::vector<size_t> offsets(numChunks);
+	std::vector<u32> sizes(numChunks);
+	size_t pos = tableSize;
+	for (u32 i = 0; i < numChunks; ++i) {
+		memcpy(&sizes[i], buffer + 2 * sizeof(u32) + i * sizeof(u32), sizeof(u32));
+		offsets[i] = pos;
+		pos += sizes[i];
+		if (pos > sz)
+			return false;
+	}
+
+	std::vector<u8> success(numChunks);
+	ForEachChunk(numChunks, [&](u32 i) {
+		const u8 *src = buffer + offsets[i];
+		u8 *dest = result + (size_t)i * chunkSize;
+		size_t expected = std::min((size_t)chunkSize, resultSize - (size_t)i * chunkSize);
+		if (compression == CChunkFileReader::Compression::DEFLATE_CHUNKED) {
+			uLongf destLen = (uLongf)expected;
+			success[i] = uncompress(dest, &destLen, src, sizes[i]) == Z_OK && destLen == expected;
+		} else {
+			size_t destLen = expected;
+			success[i] = snappy_uncompress((const char *)src, sizes[i], (char *)dest, &destLen) == SNAPPY_OK && destLen == expected;
+		}
+	});
+
+	return std::find(success.begin(), success.end(), 0) == success.end();
+}
+
 CChunkFileReader::Error CChunkFileReader::LoadFileHeader(File::IOFile &pFile, SChunkHeader &header, std::string *title) {
 	if (!pFile) {
 		ERROR_LOG(SAVESTATE, "ChunkReader: Can't open file for reading");
@@ -207,6 +317,10 @@ CChunkFileReader::Error CChunkFileReader::LoadFileHeader(File::IOFile &pFile, SC
 		ERROR_LOG(SAVESTATE, "ChunkReader: Wrong file revision, got %d expected >= %d", header.Revision, REVISION_MIN);
 		return ERROR_BAD_FILE;
 	}
+	if (header.Revision > REVISION_CURRENT) {
+		ERROR_LOG(SAVESTATE, "ChunkReader: File revision %d is from a newer version, expected <= %d", header.Revision, REVISION_CURRENT);
+		return ERROR_BAD_FILE;
+	}
 
 	if (header.Revision >= REVISION_TITLE) {
 		char titleFixed[128];
@@ -268,7 +382,26 @@ CChunkFileReader::Error CChunkFileReader::LoadFile(const std::string &filename,
 		return ERROR_BAD_FILE;
 	}
 
-	if (header.Compress) {
+	Compression compression = (Compression)header.Compress;
+	bool chunked = compression == Compression::SNAPPY_CHUNKED || compression == Compression::DEFLATE_CHUNKED;
+	if ((chunked && header.Revision < REVISION_CHUNKED) || header.Compress < 0 || header.Compress > (int)Compression::DEFLATE_CHUNKED) {
+		ERROR_LOG(SAVESTATE, "ChunkReader: Unknown compression %d in file revision %d", header.Compress, header.Revision);
+		delete [] buffer;
+		return ERROR_BAD_FILE;
+	}
+
+	if (chunked) {
+		u8 *uncomp_buffer = new u8[header.UncompressedSize];
+		if (!DecompressChunks(buffer, sz, compression, uncomp_buffer, header.UncompressedSize)) {
+			ERROR_LOG(SAVESTATE, "ChunkReader: Failed to decompress file");
+			delete [] uncomp_buffer;
+			delete [] buffer;
+			return ERROR_BAD_FILE;
+		}
+		_buffer = uncomp_buffer;
+		sz = header.UncompressedSize;
+		delete [] buffer;
+	} else if (compression != Compression::NONE) {
 		u8 *uncomp_buffer = new u8[header.UncompressedSize];
 		size_t uncomp_size = header.UncompressedSize;
 		auto status = snappy_uncompress((const char *)buffer, sz, (char *)uncomp_buffer, &uncomp_size);
@@ -301,7 +434,7 @@ CChunkFileReader::Error CChunkFileReader::LoadFile(const std::string &filename,
 }
 
 // Takes ownership of buffer.
-CChunkFileReader::Error CChunkFileReader::SaveFile(const std::string &filename, const std::string &title, const char *gitVersion, u8 *buffer, size_t sz) {
+CChunkFileReader::Error CChunkFileReader::SaveFile(const std::string &filename, const std::string &title, const char *gitVersion, u8 *buffer, size_t sz, Compression compression) {
 	INFO_LOG(SAVESTATE, "ChunkReader: Writing %s", filename.c_str());
 
 	File::IOFile pFile(filename, "wb");
@@ -311,25 +444,46 @@ CChunkFileReader::Error CChunkFileReader::SaveFile(const std::string &filename,
 		return ERROR_BAD_FILE;
 	}
 
-	// Make sure we can allocate a buffer to compress before compressing.
-	size_t write_len = snappy_max_compressed_length(sz);
-	u8 *compressed_buffer = (u8 *)malloc(write_len);
+	size_t write_len = sz;
 	u8 *write_buffer = buffer;
-	if (!compressed_buffer) {
-		ERROR_LOG(SAVESTATE, "ChunkReader: Unable to allocate compressed buffer");
-		// We'll save uncompressed.  Better than not saving...
-		write_len = sz;
-	} else {
-		snappy_compress((const char *)buffer, sz, (char *)compressed_buffer, &write_len);
-		free(buffer);
+	if (compression == Compression::SNAPPY_CHUNKED || compression == Compression::DEFLATE_CHUNKED) {
+		std::vector<u8> compressed;
+		u8 *compressed_buffer = nullptr;
+		if (CompressChunks(buffer, sz, compression, compressed))
+			compressed_buffer = (u8 *)malloc(compressed.size());
+		if (!compressed_buffer) {
+			ERROR_LOG(SAVESTATE, "ChunkReader: Unable to compress");
+			// We'll save uncompressed.  Better than not saving...
+			compression = Compression::NONE;
+		} else {
+			memcpy(compressed_buffer, compressed.data(), compressed.size());
+			write_len = compressed.size();
+			free(buffer);
+			write_buffer = compressed_buffer;
+		}
+	} else if (compression == Compression::SNAPPY) {
+		// Make sure we can allocate a buffer to compress before compressing.
+		write_len = snappy_max_compressed_length(sz);
+		u8 *compressed_buffer = (u8 *)malloc(write_len);
+		if (!compressed_buffer) {
+			ERROR_LOG(SAVESTATE, "ChunkReader: Unable to allocate compressed buffer");
+			// We'll save uncompressed.  Better than not saving...
+			write_len = sz;
+			compression = Compression::NONE;
+		} else {
+			snappy_compress((const char *)buffer, sz, (char *)compressed_buffer, &write_len);
+			free(buffer);
 
-		write_buffer = compressed_buffer;
+			write_buffer = compressed_buffer;
+		}
 	}
 
 	// Create header
 	SChunkHeader header{};
-	header.Compress = compressed_buffer ? 1 : 0;
-	header.Revision = REVISION_CURRENT;
+	header.Compress = (int)compression;
+	// Keep files older versions can read marked as such.
+	bool chunked = compression == Compression::SNAPPY_CHUNKED || compression == Compression::DEFLATE_CHUNKED;
+	header.Revision = chunked ? REVISION_CHUNKED : REVISION_TITLE;
 	header.ExpectedSize = (u32)write_len;
 	header.UncompressedSize = (u32)sz;
 	truncate_cpy(header.GitVersion, gitVersion);
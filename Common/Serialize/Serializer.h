@@ -29,6 +29,7 @@
 // + Sections can be versioned for backwards/forwards compatibility
 // - Serialization code for anything complex has to be manually written.
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <cstdlib>
@@ -190,9 +191,25 @@ class CChunkFileReader
 		return error;
 	}
 
+	// How the state data is stored in files.  All of these can be loaded.
+	enum class Compression {
+		NONE = 0,
+		// A single snappy stream, as written by older versions.
+		SNAPPY = 1,
+		// Independent chunks, compressed and decompressed in parallel.
+		SNAPPY_CHUNKED = 2,
+		// Smaller, but slower to save.
+		DEFLATE_CHUNKED = 3,
+	};
+
+	// Runs loop(lower, upper) over slices of [lower, upper), maybe in parallel.  The chunked
+	// formats use it if set, and otherwise handle their chunks one after another.
+	typedef std::function<void(const std::function<void(int, int)> &, int, int)> ParallelLoop;
+	static void SetParallelLoop(ParallelLoop loop);
+
 	// Save file template
 	template<class T>
-	static Error Save(const std::string &filename, const std::string &title, const char *gitVersion, T& _class)
+	static Error Save(const std::string &filename, const std::string &title, const char *gitVersion, T& _class, Compression compression = Compression::SNAPPY_CHUNKED)
 	{
 		// Get data
 		size_t const sz = MeasurePtr(_class);
@@ -203,7 +220,7 @@ class CChunkFileReader
 
 		// SaveFile takes ownership of buffer
 		if (error == ERROR_NONE)
-			error = SaveFile(filename, title, gitVersion, buffer, sz);
+			error = SaveFile(filename, title, gitVersion, buffer, sz, compression);
 		return error;
 	}
 	
@@ -246,10 +263,12 @@ class CChunkFileReader
 	enum {
 		REVISION_MIN = 4,
 		REVISION_TITLE = 5,
-		REVISION_CURRENT = REVISION_TITLE,
+		// Older versions can't read the chunked formats, and only this revision may use them.
+		REVISION_CHUNKED = 6,
+		REVISION_CURRENT = REVISION_CHUNKED,
 	};
 
 	static Error LoadFile(const std::string &filename, std::string *gitVersion, u8 *&buffer, size_t &sz, std::string *failureReason);
-	static Error SaveFile(const std::string &filename, const std::string &title, const char *gitVersion, u8 *buffer, size_t sz);
+	static Error SaveFile(const std::string &filename, const std::string &title, const char *gitVersion, u8 *buffer, size_t sz, Compression compression);
 	static Error LoadFileHeader(File::IOFile &pFile, SChunkHeader &header, std::string *title);
 };
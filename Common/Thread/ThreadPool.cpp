@@ -1,134 +1,310 @@
+#include <algorithm>
+
 #include "Common/Thread/ThreadPool.h"
 #include "Common/Thread/ThreadUtil.h"
 
 #include "Common/Log.h"
 #include "Common/MakeUnique.h"
 
-///////////////////////////// WorkerThread
+///////////////////////////// Task
 
-WorkerThread::~WorkerThread() {
-	{
-		std::lock_guard<std::mutex> guard(mutex);
-		active = false;
-		signal.notify_one();
+void Task::Wait() {
+	_assert_msg_(pool_ != nullptr, "Task must be submitted before waiting on it");
+	pool_->Wait(this);
+}
+
+///////////////////////////// TaskDeque
+
+// See "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.) for the orderings.
+bool ThreadPool::TaskDeque::Push(Task *task) {
+	int64_t b = bottom_.load(std::memory_order_relaxed);
+	int64_t t = top_.load(std::memory_order_acquire);
+	if (b - t >= CAPACITY)
+		return false;
+	tasks_[b & (CAPACITY - 1)].store(task, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom_.store(b + 1, std::memory_order_relaxed);
+	return true;
+}
+
+Task *ThreadPool::TaskDeque::Pop() {
+	int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+	bottom_.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = top_.load(std::memory_order_relaxed);
+	if (t > b) {
+		// Empty.
+		bottom_.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
 	}
-	if (thread.joinable()) {
-		thread.join();
+
+	Task *task = tasks_[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (t == b) {
+		// The last one, so we're racing any thieves for it.
+		if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			task = nullptr;
+		bottom_.store(b + 1, std::memory_order_relaxed);
 	}
+	return task;
 }
 
-void WorkerThread::StartUp() {
-	thread = std::thread(std::bind(&WorkerThread::WorkFunc, this));
+Task *ThreadPool::TaskDeque::Steal() {
+	int64_t t = top_.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = bottom_.load(std::memory_order_acquire);
+	if (t >= b)
+		return nullptr;
+
+	Task *task = tasks_[t & (CAPACITY - 1)].load(std::memory_order_acquire);
+	if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		// Someone else got it first.
+		return nullptr;
+	}
+	return task;
 }
 
-void WorkerThread::Process(std::function<void()> work) {
-	std::lock_guard<std::mutex> guard(mutex);
-	work_ = std::move(work);
-	jobsTarget = jobsDone + 1;
-	signal.notify_one();
+///////////////////////////// ThreadPool
+
+ThreadPool::ThreadPool(int numThreads) {
+	if (numThreads <= 0) {
+		numThreads_ = 1;
+		INFO_LOG(JIT, "ThreadPool: Bad number of threads %d", numThreads);
+	} else if (numThreads > MAX_THREADS) {
+		INFO_LOG(JIT, "ThreadPool: Capping number of threads to %d (was %d)", (int)MAX_THREADS, numThreads);
+		numThreads_ = MAX_THREADS;
+	} else {
+		numThreads_ = numThreads;
+	}
+
+	// One less worker thread, since the thread calling ParallelLoop will also do work.
+	workers_.reserve(numThreads_ - 1);
+	for (int i = 0; i < numThreads_ - 1; ++i)
+		workers_.push_back(make_unique<Worker>());
+
+	// Workers don't look at each other's threads until they can lock this.
+	std::lock_guard<std::mutex> guard(mutex_);
+	for (int i = 0; i < numThreads_ - 1; ++i)
+		workers_[i]->thread = std::thread(std::bind(&ThreadPool::WorkerFunc, this, i));
 }
 
-void WorkerThread::WaitForCompletion() {
-	std::unique_lock<std::mutex> guard(doneMutex);
-	while (jobsDone < jobsTarget) {
-		done.wait(guard);
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		stopping_ = true;
+		wakeup_.notify_all();
+	}
+	for (auto &worker : workers_) {
+		if (worker->thread.joinable())
+			worker->thread.join();
 	}
 }
 
-void WorkerThread::WorkFunc() {
-	setCurrentThreadName("Worker");
-	std::unique_lock<std::mutex> guard(mutex);
-	while (active) {
-		// 'active == false' is one of the conditions for signaling,
-		// do not "optimize" it
-		while (active && jobsTarget <= jobsDone) {
-			signal.wait(guard);
-		}
-		if (active) {
-			work_();
+void ThreadPool::WorkerFunc(int index) {
+	setCurrentThreadName("PoolWorker");
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+	}
 
-			std::lock_guard<std::mutex> doneGuard(doneMutex);
-			jobsDone++;
-			done.notify_one();
+	while (true) {
+		Task *task = FindTask(index, TaskPriority::LOW);
+		if (task) {
+			RunTask(task);
+			continue;
 		}
+
+		std::unique_lock<std::mutex> guard(mutex_);
+		sleeping_++;
+		while (queued_ == 0 && !stopping_)
+			wakeup_.wait(guard);
+		sleeping_--;
+		if (stopping_)
+			break;
+	}
+}
+
+int ThreadPool::CurrentWorker() const {
+	std::thread::id id = std::this_thread::get_id();
+	for (size_t i = 0; i < workers_.size(); ++i) {
+		if (workers_[i]->thread.get_id() == id)
+			return (int)i;
 	}
+	return -1;
 }
 
-void LoopWorkerThread::Process(std::function<void(int, int)> work, int start, int end) {
-	std::lock_guard<std::mutex> guard(mutex);
-	work_ = std::move(work);
-	start_ = start;
-	end_ = end;
-	jobsTarget = jobsDone + 1;
-	signal.notify_one();
+bool ThreadPool::Enqueue(Task *task, int worker) {
+	const int priority = (int)task->priority_;
+	if (worker < 0 || !workers_[worker]->deques[priority].Push(task)) {
+		std::lock_guard<std::mutex> guard(sharedMutex_);
+		SharedQueue &queue = shared_[priority];
+		if (queue.count == SharedQueue::CAPACITY)
+			return false;
+		queue.tasks[(queue.head + queue.count) % SharedQueue::CAPACITY] = task;
+		queue.count++;
+	}
+
+	queued_++;
+	submitted_++;
+	return true;
 }
 
-void LoopWorkerThread::WorkFunc() {
-	setCurrentThreadName("LoopWorker");
-	std::unique_lock<std::mutex> guard(mutex);
-	while (active) {
-		// 'active == false' is one of the conditions for signaling,
-		// do not "optimize" it
-		while (active && jobsTarget <= jobsDone) {
-			signal.wait(guard);
+void ThreadPool::Notify(int count) {
+	// Paired with WorkerFunc() and Wait(): either they see the new tasks, or we see them sleeping.
+	if (sleeping_ > 0 || waiting_ > 0) {
+		std::lock_guard<std::mutex> guard(mutex_);
+		if (count == 1)
+			wakeup_.notify_one();
+		else
+			wakeup_.notify_all();
+		// These might be able to help.
+		taskDone_.notify_all();
+	}
+}
+
+void ThreadPool::Submit(Task *task) {
+	task->pool_ = this;
+	task->done_ = false;
+	if (workers_.empty() || !Enqueue(task, CurrentWorker())) {
+		task->Run();
+		task->done_ = true;
+		return;
+	}
+	Notify(1);
+}
+
+Task *ThreadPool::PopShared(int priority) {
+	SharedQueue &queue = shared_[priority];
+	if (queue.count.load(std::memory_order_relaxed) == 0)
+		return nullptr;
+
+	std::lock_guard<std::mutex> guard(sharedMutex_);
+	if (queue.count == 0)
+		return nullptr;
+	Task *task = queue.tasks[queue.head];
+	queue.head = (queue.head + 1) % SharedQueue::CAPACITY;
+	queue.count--;
+	return task;
+}
+
+Task *ThreadPool::FindTask(int worker, TaskPriority lowest) {
+	const int numWorkers = (int)workers_.size();
+	for (int priority = 0; priority <= (int)lowest; ++priority) {
+		Task *task = worker >= 0 ? workers_[worker]->deques[priority].Pop() : nullptr;
+		if (!task)
+			task = PopShared(priority);
+		// Start with the next worker, so thieves spread out.
+		for (int i = 1; !task && i <= numWorkers; ++i) {
+			int victim = (worker + i) % numWorkers;
+			if (victim != worker)
+				task = workers_[victim]->deques[priority].Steal();
 		}
-		if (active) {
-			work_(start_, end_);
 
-			std::lock_guard<std::mutex> doneGuard(doneMutex);
-			jobsDone++;
-			done.notify_one();
+		if (task) {
+			queued_--;
+			return task;
 		}
 	}
+	return nullptr;
 }
 
-///////////////////////////// ThreadPool
+void ThreadPool::RunTask(Task *task) {
+	task->Run();
+	// Paired with Wait(): either it sees this, or we see it waiting.
+	task->done_ = true;
+	if (waiting_ > 0) {
+		std::lock_guard<std::mutex> guard(mutex_);
+		taskDone_.notify_all();
+	}
+}
 
-ThreadPool::ThreadPool(int numThreads) {
-	if (numThreads <= 0) {
-		numThreads_ = 1;
-		INFO_LOG(JIT, "ThreadPool: Bad number of threads %d", numThreads);
-	} else if (numThreads > 8) {
-		INFO_LOG(JIT, "ThreadPool: Capping number of threads to 8 (was %d)", numThreads);
-		numThreads_ = 8;
-	} else {
-		numThreads_ = numThreads;
+void ThreadPool::Wait(Task *task) {
+	if (task->IsDone())
+		return;
+
+	const int worker = CurrentWorker();
+	while (!task->IsDone()) {
+		uint32_t seen = submitted_;
+		Task *other = FindTask(worker, task->priority_);
+		if (other) {
+			RunTask(other);
+			continue;
+		}
+
+		// It must be running elsewhere.  Sleep until something finishes or there's new work to help with.
+		std::unique_lock<std::mutex> guard(mutex_);
+		waiting_++;
+		if (!task->IsDone() && submitted_ == seen)
+			taskDone_.wait(guard);
+		waiting_--;
 	}
 }
 
-void ThreadPool::StartWorkers() {
-	if (!workersStarted) {
-		workers.reserve(numThreads_ - 1);
-		for(int i = 0; i < numThreads_ - 1; ++i) { // create one less worker thread as the thread calling ParallelLoop will also do work
-			auto workerPtr = make_unique<LoopWorkerThread>();
-			workerPtr->StartUp();
-			workers.push_back(std::move(workerPtr));
+namespace {
+
+// Shared by everyone working on a single ParallelLoop, lives on the caller's stack.
+struct LoopState {
+	const std::function<void(int, int)> *loop;
+	int lower;
+	int range;
+	int numChunks;
+	std::atomic<int> nextChunk;
+
+	void RunChunks() {
+		int chunk;
+		while ((chunk = nextChunk++) < numChunks) {
+			int start = lower + (int)((int64_t)range * chunk / numChunks);
+			int end = lower + (int)((int64_t)range * (chunk + 1) / numChunks);
+			(*loop)(start, end);
 		}
-		workersStarted = true;
 	}
+};
+
+class LoopTask : public Task {
+public:
+	LoopTask() : state_(nullptr) {}
+
+	void Init(LoopState *state) {
+		state_ = state;
+	}
+	void Run() override {
+		state_->RunChunks();
+	}
+
+private:
+	LoopState *state_;
+};
+
 }
 
-void ThreadPool::ParallelLoop(const std::function<void(int,int)> &loop, int lower, int upper) {
+void ThreadPool::ParallelLoop(const std::function<void(int,int)> &loop, int lower, int upper, TaskPriority priority) {
 	int range = upper - lower;
-	if (range >= numThreads_ * 2) { // don't parallelize tiny loops (this could be better, maybe add optional parameter that estimates work per iteration)
-		std::lock_guard<std::mutex> guard(mutex);
-		StartWorkers();
-
-		// could do slightly better load balancing for the generic case, 
-		// but doesn't matter since all our loops are power of 2
-		int chunk = range / numThreads_;
-		int s = lower;
-		for (auto& worker : workers) {
-			worker->Process(loop, s, s+chunk);
-			s+=chunk;
-		}
-		// This is the final chunk.
-		loop(s, upper);
-		for (auto& worker : workers) {
-			worker->WaitForCompletion();
+	if (range >= numThreads_ * 2 && !workers_.empty()) { // don't parallelize tiny loops (this could be better, maybe add optional parameter that estimates work per iteration)
+		// Several chunks per thread, so threads that are also busy elsewhere don't hold up the loop.
+		LoopState state;
+		state.loop = &loop;
+		state.lower = lower;
+		state.range = range;
+		state.numChunks = std::min(range, numThreads_ * 4);
+		state.nextChunk = 0;
+
+		// Each helper runs chunks until there are none left, however many other threads have joined.
+		LoopTask helpers[MAX_THREADS - 1];
+		const int worker = CurrentWorker();
+		int numHelpers = 0;
+		for (int i = 0; i < (int)workers_.size(); ++i) {
+			helpers[i].priority_ = priority;
+			helpers[i].pool_ = this;
+			helpers[i].Init(&state);
+			if (!Enqueue(&helpers[i], worker))
+				break;
+			numHelpers++;
 		}
+		Notify(numHelpers);
+
+		state.RunChunks();
+		// Any helpers still queued find nothing left to do, but they still have to be taken off the queues.
+		for (int i = 0; i < numHelpers; ++i)
+			Wait(&helpers[i]);
 	} else {
 		loop(lower, upper);
 	}
 }
-
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -7,71 +9,177 @@
 #include <mutex>
 #include <condition_variable>
 
-// This is the simplest possible worker implementation I can think of
-// but entirely sufficient for the given purpose.
-// Only handles a single item of work at a time.
-class WorkerThread {
-public:
-	WorkerThread() = default;
-	virtual ~WorkerThread();
-
-	void StartUp();
-
-	// submit a new work item
-	void Process(std::function<void()> work);
-	// wait for a submitted work item to be completed
-	void WaitForCompletion();
-
-protected:
-	std::thread thread; // the worker thread
-	std::condition_variable signal; // used to signal new work
-	std::condition_variable done; // used to signal work completion
-	std::mutex mutex, doneMutex; // associated with each respective condition variable
-	bool active = true;
-	int jobsDone = 0;
-	int jobsTarget = 0;
-private:
-	virtual void WorkFunc();
-
-	std::function<void()> work_; // the work to be done by this thread
-
-	WorkerThread(const WorkerThread& other) = delete; // prevent copies
-	void operator =(const WorkerThread &other) = delete;
+enum class TaskPriority {
+	HIGH,
+	NORMAL,
+	LOW,
+	COUNT,
 };
 
-class LoopWorkerThread final : public WorkerThread {
+class ThreadPool;
+
+// A unit of work for the ThreadPool.  The caller owns the storage (the stack is fine),
+// so submitting doesn't allocate, but it must stay alive until ThreadPool::Wait() returns.
+class Task {
 public:
-	LoopWorkerThread() = default;
-	void Process(std::function<void(int, int)> work, int start, int end);
+	explicit Task(TaskPriority priority = TaskPriority::NORMAL) : priority_(priority) {}
+	// Only so tasks can be returned from MakeTask() and friends, never move a submitted task.
+	Task(Task &&other) : priority_(other.priority_) {}
+	virtual ~Task() {}
+
+	virtual void Run() = 0;
+
+	TaskPriority Priority() const {
+		return priority_;
+	}
+	bool IsDone() const {
+		return done_.load(std::memory_order_acquire);
+	}
+	// Same as ThreadPool::Wait() on the pool it was submitted to.
+	void Wait();
 
 private:
-	virtual void WorkFunc() override;
+	friend class ThreadPool;
 
-	int start_;
-	int end_;
-	std::function<void(int, int)> work_; // the work to be done by this thread
+	TaskPriority priority_;
+	ThreadPool *pool_ = nullptr;
+	std::atomic<bool> done_{ false };
+
+	Task(const Task &other) = delete;
+	void operator =(const Task &other) = delete;
 };
 
-// A thread pool manages a set of worker threads, and allows the execution of parallel loops on them
-// individual parallel loops are fully sequentialized to simplify synchronization, which should not 
-// be a problem as they should each use the entire system
+// A work-stealing scheduler.  Each worker has its own deques (one per priority) that it pushes
+// to and pops from, and idle workers steal from the others.  Work from threads outside the pool
+// goes through a shared queue.  Waiting, including for a ParallelLoop, runs other queued work
+// rather than blocking, so loops and tasks can nest freely.
 class ThreadPool {
 public:
 	ThreadPool(int numThreads);
-	// don't need a destructor, "workers" is cleared on delete, 
-	// leading to the stopping and joining of all worker threads (RAII and all that)
+	~ThreadPool();
+
+	// Runs slices of "loop" from "lower" to "upper" and returns when they're all done.
+	// The calling thread does some of the work too.
+	void ParallelLoop(const std::function<void(int,int)> &loop, int lower, int upper, TaskPriority priority = TaskPriority::NORMAL);
 
-	void ParallelLoop(const std::function<void(int,int)> &loop, int lower, int upper);
+	// Queues a task to run on any thread.  If all queues are full, it runs right away instead.
+	void Submit(Task *task);
+	// Returns once the task has run, helping with queued work of at least its priority meanwhile.
+	void Wait(Task *task);
+
+	int NumThreads() const {
+		return numThreads_;
+	}
+
+	enum {
+		MAX_THREADS = 8,
+	};
 
 private:
+	// Chase-Lev deque of a fixed size.  Only the owning worker may Push() or Pop().
+	class TaskDeque {
+	public:
+		bool Push(Task *task);
+		Task *Pop();
+		Task *Steal();
+
+	private:
+		enum {
+			CAPACITY = 256,
+		};
+
+		std::atomic<int64_t> top_{ 0 };
+		std::atomic<int64_t> bottom_{ 0 };
+		std::atomic<Task *> tasks_[CAPACITY];
+	};
+
+	struct Worker {
+		std::thread thread;
+		TaskDeque deques[(int)TaskPriority::COUNT];
+	};
+
+	// For threads outside the pool, guarded by sharedMutex_.
+	struct SharedQueue {
+		enum {
+			CAPACITY = 1024,
+		};
+
+		Task *tasks[CAPACITY];
+		int head = 0;
+		std::atomic<int> count{ 0 };
+	};
+
+	void WorkerFunc(int index);
+	int CurrentWorker() const;
+	bool Enqueue(Task *task, int worker);
+	void Notify(int count);
+	Task *FindTask(int worker, TaskPriority lowest);
+	Task *PopShared(int priority);
+	void RunTask(Task *task);
+
 	int numThreads_;
-	std::vector<std::unique_ptr<LoopWorkerThread>> workers;
-	std::mutex mutex; // used to sequentialize loop execution
+	std::vector<std::unique_ptr<Worker>> workers_;
+
+	SharedQueue shared_[(int)TaskPriority::COUNT];
+	std::mutex sharedMutex_;
+
+	// Queued tasks not yet taken, and how many tasks have ever been queued.
+	std::atomic<int> queued_{ 0 };
+	std::atomic<uint32_t> submitted_{ 0 };
+	// Idle workers sleep on wakeup_, threads in Wait() with nothing to help with on taskDone_.
+	std::atomic<int> sleeping_{ 0 };
+	std::atomic<int> waiting_{ 0 };
+	std::mutex mutex_;
+	std::condition_variable wakeup_;
+	std::condition_variable taskDone_;
+	bool stopping_ = false;
 
-	bool workersStarted = false;
-	void StartWorkers();
-	
 	ThreadPool(const ThreadPool& other) = delete; // prevent copies
 	void operator =(const ThreadPool &other) = delete;
 };
 
+template <typename F>
+class FuncTask : public Task {
+public:
+	FuncTask(F func, TaskPriority priority) : Task(priority), func_(std::move(func)) {}
+	FuncTask(FuncTask &&other) : Task(std::move(other)), func_(std::move(other.func_)) {}
+
+	void Run() override {
+		func_();
+	}
+
+private:
+	F func_;
+};
+
+// Like a std::future, but the storage lives with the caller.
+template <typename T, typename F>
+class FutureTask : public Task {
+public:
+	FutureTask(F func, TaskPriority priority) : Task(priority), func_(std::move(func)) {}
+	FutureTask(FutureTask &&other) : Task(std::move(other)), func_(std::move(other.func_)) {}
+
+	void Run() override {
+		result_ = func_();
+	}
+
+	// Must have been submitted.  Waits for the result if necessary.
+	T &Get() {
+		Wait();
+		return result_;
+	}
+
+private:
+	F func_;
+	T result_;
+};
+
+template <typename F>
+FuncTask<F> MakeTask(F func, TaskPriority priority = TaskPriority::NORMAL) {
+	return FuncTask<F>(std::move(func), priority);
+}
+
+template <typename F>
+auto MakeFutureTask(F func, TaskPriority priority = TaskPriority::NORMAL) -> FutureTask<decltype(func()), F> {
+	return FutureTask<decltype(func()), F>(std::move(func), priority);
+}
@@ -107,6 +107,7 @@ struct Config {
 	bool bHideSlowWarnings;
 	bool bHideStateWarnings;
 	bool bPreloadFunctions;
+	bool bIRDiskCache;
 	uint32_t uJitDisableFlags;
 
 	bool bSeparateSASThread;
@@ -195,6 +196,8 @@ struct Config {
 	int iTexScalingType; // 0 = xBRZ, 1 = Hybrid
 	bool bTexDeposterize;
 	bool bTexHardwareScaling;
+	bool bTexScalingAsync;  // Scale on the thread pool, showing the unscaled texture until it's done
+	bool bTextureDiskCache;  // Keep upscaled textures on disk for next time
 	int iFpsLimit1;
 	int iFpsLimit2;
 	int iMaxRecent;
@@ -202,6 +205,7 @@ struct Config {
 	int iRewindFlipFrequency;
 	bool bUISound;
 	bool bEnableStateUndo;
+	int iSaveStateCompression;  // 0 = fast, 1 = small, 2 = readable by older versions
 	int iAutoLoadSaveState; // 0 = off, 1 = oldest, 2 = newest, >2 = slot number + 3
 	bool bEnableCheats;
 	bool bReloadCheats;
@@ -226,6 +230,8 @@ struct Config {
 	// Sound
 	bool bEnableSound;
 	int iAudioBackend;
+	int iAudioResampler;
+	bool bAtracDecodeAhead;
 	int iGlobalVolume;
 	int iAltSpeedVolume;
 	bool bExtraAudioBuffering;  // For bluetooth
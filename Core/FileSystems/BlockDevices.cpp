@@ -25,6 +25,7 @@
 #include "Common/Swap.h"
 #include "Core/Loaders.h"
 #include "Core/Host.h"
+#include "Core/ThreadPools.h"
 #include "Core/FileSystems/BlockDevices.h"
 
 extern "C"
@@ -40,11 +41,13 @@ BlockDevice *constructBlockDevice(FileLoader *fileLoader) {
 	// Check for CISO
 	if (!fileLoader->Exists())
 		return nullptr;
-	char buffer[4]{};
-	size_t size = fileLoader->ReadAt(0, 1, 4, buffer);
-	if (size == 4 && !memcmp(buffer, "CISO", 4))
+	char buffer[8]{};
+	size_t size = fileLoader->ReadAt(0, 1, 8, buffer);
+	if (size >= 4 && !memcmp(buffer, "CISO", 4))
 		return new CISOFileBlockDevice(fileLoader);
-	else if (size == 4 && !memcmp(buffer, "\x00PBP", 4))
+	else if (size == 8 && !memcmp(buffer, "MComprHD", 8))
+		return new CHDFileBlockDevice(fileLoader);
+	else if (size >= 4 && !memcmp(buffer, "\x00PBP", 4))
 		return new NPDRMDemoBlockDevice(fileLoader);
 	else
 		return new FileBlockDevice(fileLoader);
@@ -377,6 +380,1031 @@ bool CISOFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
 	return true;
 }
 
+// .CHD format (v5 only, as written by current chdman.)
+
+struct CHDHeaderV5 {
+	char tag[8];                    // +00 : 'MComprHD'
+	u32_be length;                  // +08 : header length (124)
+	u32_be version;                 // +0C : 5
+	u32_be compressors[4];          // +10 : codec tags, used by compression types 0-3
+	u64_be logicalBytes;            // +20 : uncompressed size
+	u64_be mapOffset;               // +28 : hunk map offset
+	u64_be metaOffset;              // +30 : first metadata entry
+	u32_be hunkBytes;               // +38 : bytes per hunk
+	u32_be unitBytes;               // +3C : bytes per unit (sector)
+	u8 rawSHA1[20];                 // +40
+	u8 SHA1[20];                    // +54
+	u8 parentSHA1[20];              // +68
+};
+
+static const u32 CHD_V5_HEADER_SIZE = 124;
+// How much decompressed data we keep around.
+static const u32 CHD_CACHE_SIZE = 4 * 1024 * 1024;
+
+static const u32 CHD_CODEC_NONE = 0;
+static const u32 CHD_CODEC_ZLIB = 0x7A6C6962;  // 'zlib'
+static const u32 CHD_CODEC_HUFFMAN = 0x68756666;  // 'huff'
+static const u32 CHD_CODEC_LZMA = 0x6C7A6D61;  // 'lzma'
+// CD codecs compress the sector data and the subcode of each frame separately.
+static const u32 CHD_CODEC_CD_ZLIB = 0x63647A6C;  // 'cdzl'
+static const u32 CHD_CODEC_CD_LZMA = 0x63646C7A;  // 'cdlz'
+
+static const u32 CHD_META_CD_TRACK = 0x43485432;  // 'CHT2'
+static const u32 CHD_META_CD_TRACK_OLD = 0x43485452;  // 'CHTR'
+
+// A CD frame is a 2352 byte sector followed by 96 bytes of subcode.
+static const u32 CHD_CD_FRAME_SIZE = 2448;
+static const u32 CHD_CD_SECTOR_SIZE = 2352;
+
+enum CHDCompression : u8 {
+	CHD_COMPRESSION_TYPE_0 = 0,
+	CHD_COMPRESSION_TYPE_1 = 1,
+	CHD_COMPRESSION_TYPE_2 = 2,
+	CHD_COMPRESSION_TYPE_3 = 3,
+	CHD_COMPRESSION_NONE = 4,
+	CHD_COMPRESSION_SELF = 5,
+	CHD_COMPRESSION_PARENT = 6,
+	// These only appear in the compressed map.
+	CHD_COMPRESSION_RLE_SMALL = 7,
+	CHD_COMPRESSION_RLE_LARGE = 8,
+	CHD_COMPRESSION_SELF_0 = 9,
+	CHD_COMPRESSION_SELF_1 = 10,
+	CHD_COMPRESSION_PARENT_SELF = 11,
+	CHD_COMPRESSION_PARENT_0 = 12,
+	CHD_COMPRESSION_PARENT_1 = 13,
+	// Our own, for unallocated hunks in an uncompressed map.
+	CHD_COMPRESSION_ZEROS = 0xFF,
+};
+
+// MSB first, reads past the end give zeros (check Overflowed() after.)
+class CHDBitReader {
+public:
+	CHDBitReader(const u8 *data, size_t size) : data_(data), size_(size) {}
+
+	u32 Peek(int bits) {
+		if (bits == 0)
+			return 0;
+		while (bitCount_ < bits) {
+			u64 next = pos_ < size_ ? data_[pos_] : 0;
+			pos_++;
+			buffer_ |= next << (56 - bitCount_);
+			bitCount_ += 8;
+		}
+		return (u32)(buffer_ >> (64 - bits));
+	}
+	void Remove(int bits) {
+		buffer_ <<= bits;
+		bitCount_ -= bits;
+	}
+	u64 Read(int bits) {
+		if (bits > 32) {
+			u64 high = Read(bits - 32);
+			return (high << 32) | Read(32);
+		}
+		u32 result = Peek(bits);
+		Remove(bits);
+		return result;
+	}
+	bool Overflowed() const {
+		return pos_ - bitCount_ / 8 > size_;
+	}
+
+private:
+	const u8 *data_;
+	size_t size_;
+	size_t pos_ = 0;
+	u64 buffer_ = 0;
+	int bitCount_ = 0;
+};
+
+// Canonical huffman decoder, used both for the map and the 'huff' codec.
+class CHDHuffmanDecoder {
+public:
+	CHDHuffmanDecoder(int numCodes, int maxBits) : numBits_(numCodes), maxBits_(maxBits), lookup_(1 << maxBits) {}
+
+	bool ImportTreeRLE(CHDBitReader &bits) {
+		const int width = maxBits_ >= 16 ? 5 : (maxBits_ >= 8 ? 4 : 3);
+		size_t cur = 0;
+		while (cur < numBits_.size()) {
+			u8 nodeBits = (u8)bits.Read(width);
+			if (nodeBits != 1) {
+				numBits_[cur++] = nodeBits;
+				continue;
+			}
+			// A 1 is an escape: either a literal 1, or a repeat.
+			nodeBits = (u8)bits.Read(width);
+			if (nodeBits == 1) {
+				numBits_[cur++] = nodeBits;
+				continue;
+			}
+			size_t repeat = (size_t)bits.Read(width) + 3;
+			if (cur + repeat > numBits_.size())
+				return false;
+			while (repeat--)
+				numBits_[cur++] = nodeBits;
+		}
+		return BuildLookup() && !bits.Overflowed();
+	}
+
+	// The tree itself is encoded with a small huffman tree.
+	bool ImportTreeHuffman(CHDBitReader &bits) {
+		CHDHuffmanDecoder small(24, 6);
+		// Node 0 is the repeat escape, it's not covered by start.
+		small.numBits_[0] = (u8)bits.Read(3);
+		const int start = (int)bits.Read(3) + 1;
+		int count = 0;
+		for (int i = 1; i < 24; ++i) {
+			if (i < start || count == 7) {
+				small.numBits_[i] = 0;
+			} else {
+				count = (int)bits.Read(3);
+				small.numBits_[i] = count == 7 ? 0 : count;
+			}
+		}
+		if (!small.BuildLookup())
+			return false;
+
+		int rleFullBits = 0;
+		for (size_t temp = numBits_.size() - 9; temp != 0; temp >>= 1)
+			rleFullBits++;
+
+		u8 last = 0;
+		size_t cur = 0;
+		while (cur < numBits_.size()) {
+			u32 value = small.DecodeOne(bits);
+			if (value != 0) {
+				numBits_[cur++] = last = (u8)(value - 1);
+				continue;
+			}
+			int repeat = (int)bits.Read(3) + 2;
+			if (repeat == 7 + 2)
+				repeat += (int)bits.Read(rleFullBits);
+			for (; repeat != 0 && cur < numBits_.size(); repeat--)
+				numBits_[cur++] = last;
+		}
+		return BuildLookup() && !bits.Overflowed();
+	}
+
+	u32 DecodeOne(CHDBitReader &bits) const {
+		u32 entry = lookup_[bits.Peek(maxBits_)];
+		bits.Remove(entry & 0x1F);
+		return entry >> 5;
+	}
+
+private:
+	bool BuildLookup() {
+		u32 histogram[33]{};
+		for (u8 n : numBits_) {
+			if (n > maxBits_)
+				return false;
+			histogram[n]++;
+		}
+
+		// Assign canonical codes, starting from the longest.
+		u32 curStart = 0;
+		for (int len = 32; len > 0; --len) {
+			u32 nextStart = (curStart + histogram[len]) >> 1;
+			if (len != 1 && nextStart * 2 != curStart + histogram[len])
+				return false;
+			histogram[len] = curStart;
+			curStart = nextStart;
+		}
+
+		std::fill(lookup_.begin(), lookup_.end(), 0);
+		for (size_t i = 0; i < numBits_.size(); ++i) {
+			const int n = numBits_[i];
+			if (n == 0)
+				continue;
+			const int shift = maxBits_ - n;
+			const size_t first = (size_t)histogram[n]++ << shift;
+			const size_t last = first + ((size_t)1 << shift);
+			if (last > lookup_.size())
+				return false;
+			std::fill(lookup_.begin() + first, lookup_.begin() + last, (u32)(i << 5) | n);
+		}
+		return true;
+	}
+
+	std::vector<u8> numBits_;
+	int maxBits_;
+	std::vector<u32> lookup_;
+};
+
+// CRC-16/CCITT, which the compressed map is checked with.
+static u16 CHDCRC16(u16 crc, const u8 *data, size_t size) {
+	for (size_t i = 0; i < size; ++i) {
+		crc ^= data[i] << 8;
+		for (int b = 0; b < 8; ++b)
+			crc = (crc & 0x8000) ? (u16)((crc << 1) ^ 0x1021) : (u16)(crc << 1);
+	}
+	return crc;
+}
+
+// Decodes the raw LZMA streams chdman writes: no header, lc=3 lp=0 pb=2, and usually no end marker,
+// since the decompressed size is always known.  Follows the decoder in the LZMA specification.
+class CHDLzmaDecoder {
+public:
+	bool Decode(const u8 *src, size_t srcSize, u8 *out, u32 outSize) {
+		Prob *first = (Prob *)&probs_;
+		std::fill(first, first + sizeof(probs_) / sizeof(Prob), (Prob)(BIT_MODEL_TOTAL / 2));
+
+		src_ = src;
+		srcSize_ = srcSize;
+		srcPos_ = 5;
+		if (srcSize < 5 || src[0] != 0)
+			return false;
+		range_ = 0xFFFFFFFF;
+		code_ = (src[1] << 24) | (src[2] << 16) | (src[3] << 8) | src[4];
+		if (code_ == range_)
+			return false;
+
+		u32 state = 0;
+		u32 rep0 = 0, rep1 = 0, rep2 = 0, rep3 = 0;
+		u32 pos = 0;
+		while (pos < outSize) {
+			const u32 posState = pos & ((1 << PB) - 1);
+			if (!DecodeBit(&probs_.isMatch[(state << 4) + posState])) {
+				const u8 prevByte = pos > 0 ? out[pos - 1] : 0;
+				Prob *probs = &probs_.literal[0x300 * (prevByte >> (8 - LC))];
+				u32 symbol = 1;
+				if (state >= 7) {
+					// After a match, the byte at rep0 guides the first bits.
+					u32 matchByte = out[pos - rep0 - 1];
+					do {
+						const u32 matchBit = (matchByte >> 7) & 1;
+						matchByte <<= 1;
+						const u32 bit = DecodeBit(&probs[((1 + matchBit) << 8) + symbol]);
+						symbol = (symbol << 1) | bit;
+						if (matchBit != bit)
+							break;
+					} while (symbol < 0x100);
+				}
+				while (symbol < 0x100)
+					symbol = (symbol << 1) | DecodeBit(&probs[symbol]);
+				out[pos++] = (u8)symbol;
+				state = state < 4 ? 0 : (state < 10 ? state - 3 : state - 6);
+				continue;
+			}
+
+			u32 len;
+			if (DecodeBit(&probs_.isRep[state])) {
+				if (pos == 0)
+					return false;
+				if (!DecodeBit(&probs_.isRepG0[state])) {
+					if (!DecodeBit(&probs_.isRep0Long[(state << 4) + posState])) {
+						// A single byte from rep0.
+						state = state < 7 ? 9 : 11;
+						out[pos] = out[pos - rep0 - 1];
+						pos++;
+						continue;
+					}
+				} else {
+					u32 dist;
+					if (!DecodeBit(&probs_.isRepG1[state])) {
+						dist = rep1;
+					} else {
+						if (!DecodeBit(&probs_.isRepG2[state])) {
+							dist = rep2;
+						} else {
+							dist = rep3;
+							rep3 = rep2;
+						}
+						rep2 = rep1;
+					}
+					rep1 = rep0;
+					rep0 = dist;
+				}
+				len = DecodeLen(probs_.repLen, posState);
+				state = state < 7 ? 8 : 11;
+			} else {
+				rep3 = rep2;
+				rep2 = rep1;
+				rep1 = rep0;
+				len = DecodeLen(probs_.len, posState);
+				state = state < 7 ? 7 : 10;
+				rep0 = DecodeDistance(len);
+				if (rep0 == 0xFFFFFFFF)
+					break;
+				if (rep0 >= pos)
+					return false;
+			}
+
+			// Matches are at least 2 bytes.
+			len += 2;
+			for (; len > 0 && pos < outSize; --len, ++pos)
+				out[pos] = out[pos - rep0 - 1];
+		}
+		return pos == outSize && !overflowed_;
+	}
+
+private:
+	typedef u16 Prob;
+
+	static const int LC = 3;
+	static const int PB = 2;
+	static const u32 BIT_MODEL_TOTAL = 1 << 11;
+	static const int MOVE_BITS = 5;
+	// Distances from this slot up use direct bits plus 4 aligned bits, below it they're modeled.
+	static const u32 END_POS_MODEL_INDEX = 14;
+
+	struct LenProbs {
+		Prob choice;
+		Prob choice2;
+		Prob low[1 << PB << 2][1 << 3];
+		Prob mid[1 << PB << 2][1 << 3];
+		Prob high[1 << 8];
+	};
+
+	u32 NextByte() {
+		if (srcPos_ < srcSize_)
+			return src_[srcPos_++];
+		overflowed_ = true;
+		return 0;
+	}
+
+	u32 DecodeBit(Prob *prob) {
+		u32 v = *prob;
+		const u32 bound = (range_ >> 11) * v;
+		u32 symbol;
+		if (code_ < bound) {
+			v += (BIT_MODEL_TOTAL - v) >> MOVE_BITS;
+			range_ = bound;
+			symbol = 0;
+		} else {
+			v -= v >> MOVE_BITS;
+			code_ -= bound;
+			range_ -= bound;
+			symbol = 1;
+		}
+		*prob = (Prob)v;
+		if (range_ < (1 << 24)) {
+			range_ <<= 8;
+			code_ = (code_ << 8) | NextByte();
+		}
+		return symbol;
+	}
+
+	u32 DecodeDirectBits(int numBits) {
+		u32 result = 0;
+		do {
+			range_ >>= 1;
+			code_ -= range_;
+			const u32 t = 0 - (code_ >> 31);
+			code_ += range_ & t;
+			if (range_ < (1 << 24)) {
+				range_ <<= 8;
+				code_ = (code_ << 8) | NextByte();
+			}
+			result = (result << 1) + (t + 1);
+		} while (--numBits);
+		return result;
+	}
+
+	u32 DecodeTree(Prob *probs, int numBits) {
+		u32 m = 1;
+		for (int i = 0; i < numBits; ++i)
+			m = (m << 1) + DecodeBit(&probs[m]);
+		return m - (1 << numBits);
+	}
+
+	u32 DecodeTreeReverse(Prob *probs, int numBits) {
+		u32 m = 1;
+		u32 symbol = 0;
+		for (int i = 0; i < numBits; ++i) {
+			const u32 bit = DecodeBit(&probs[m]);
+			m = (m << 1) + bit;
+			symbol |= bit << i;
+		}
+		return symbol;
+	}
+
+	u32 DecodeLen(LenProbs &probs, u32 posState) {
+		if (!DecodeBit(&probs.choice))
+			return DecodeTree(probs.low[posState], 3);
+		if (!DecodeBit(&probs.choice2))
+			return 8 + DecodeTree(probs.mid[posState], 3);
+		return 16 + DecodeTree(probs.high, 8);
+	}
+
+	u32 DecodeDistance(u32 len) {
+		const u32 lenState = std::min(len, (u32)3);
+		const u32 posSlot = DecodeTree(probs_.posSlot[lenState], 6);
+		if (posSlot < 4)
+			return posSlot;
+		const int numDirectBits = (int)(posSlot >> 1) - 1;
+		u32 dist = (2 | (posSlot & 1)) << numDirectBits;
+		if (posSlot < END_POS_MODEL_INDEX)
+			return dist + DecodeTreeReverse(probs_.posSpecial + dist - posSlot, numDirectBits);
+		dist += DecodeDirectBits(numDirectBits - 4) << 4;
+		return dist + DecodeTreeReverse(probs_.align, 4);
+	}
+
+	// All the probabilities, so they can be reset together.
+	struct {
+		Prob literal[0x300 << LC];
+		Prob isMatch[12 << 4];
+		Prob isRep[12];
+		Prob isRepG0[12];
+		Prob isRepG1[12];
+		Prob isRepG2[12];
+		Prob isRep0Long[12 << 4];
+		Prob posSlot[4][1 << 6];
+		Prob posSpecial[1 + 128 - END_POS_MODEL_INDEX];
+		Prob align[1 << 4];
+		LenProbs len;
+		LenProbs repLen;
+	} probs_;
+
+	const u8 *src_ = nullptr;
+	size_t srcSize_ = 0;
+	size_t srcPos_ = 0;
+	bool overflowed_ = false;
+	u32 range_ = 0;
+	u32 code_ = 0;
+};
+
+// Raw deflate, as both the zlib and cdzl codecs use.
+static bool CHDInflate(u32 hunk, const u8 *src, size_t size, u8 *out, u32 outSize) {
+	z_stream z{};
+	if (inflateInit2(&z, -15) != Z_OK) {
+		ERROR_LOG(LOADER, "CHD hunk %d: unable to initialize inflate: %s", hunk, z.msg ? z.msg : "?");
+		return false;
+	}
+	z.next_in = (Bytef *)src;
+	z.avail_in = (uInt)size;
+	z.next_out = out;
+	z.avail_out = outSize;
+	int status = inflate(&z, Z_FINISH);
+	const u32 totalOut = (u32)z.total_out;
+	inflateEnd(&z);
+	if (status != Z_STREAM_END || totalOut != outSize) {
+		ERROR_LOG(LOADER, "CHD hunk %d: inflate failed - %d bytes, status %d", hunk, totalOut, status);
+		return false;
+	}
+	return true;
+}
+
+CHDFileBlockDevice::CHDFileBlockDevice(FileLoader *fileLoader)
+	: fileLoader_(fileLoader)
+{
+	CHDHeaderV5 hdr;
+	size_t readSize = fileLoader->ReadAt(0, CHD_V5_HEADER_SIZE, 1, &hdr);
+	if (readSize != 1 || memcmp(hdr.tag, "MComprHD", 8) != 0) {
+		ERROR_LOG(LOADER, "Invalid CHD!");
+		NotifyReadError();
+		return;
+	}
+	if (hdr.version != 5 || hdr.length < CHD_V5_HEADER_SIZE) {
+		ERROR_LOG(LOADER, "CHD version %d unsupported, only v5 is supported", (int)hdr.version);
+		NotifyReadError();
+		return;
+	}
+
+	hunkBytes_ = hdr.hunkBytes;
+	unitBytes_ = hdr.unitBytes;
+	const bool isCD = unitBytes_ == CHD_CD_FRAME_SIZE;
+	if ((unitBytes_ != (u32)GetBlockSize() && !isCD) || hunkBytes_ == 0 || (hunkBytes_ % unitBytes_) != 0) {
+		ERROR_LOG(LOADER, "CHD unit size %d / hunk size %d unsupported, must be 2048 byte sectors or CD frames", unitBytes_, hunkBytes_);
+		NotifyReadError();
+		hunkBytes_ = 0;
+		return;
+	}
+	framesPerHunk_ = hunkBytes_ / unitBytes_;
+	for (int i = 0; i < 4; ++i)
+		compressors_[i] = hdr.compressors[i];
+
+	const u64 totalSize = hdr.logicalBytes;
+	const u64 totalFrames = totalSize / unitBytes_;
+	hunks_.resize((size_t)((totalSize + hunkBytes_ - 1) / hunkBytes_));
+	cacheCapacity_ = std::max(CHD_CACHE_SIZE / (framesPerHunk_ * GetBlockSize()), (u32)8);
+
+	bool success = compressors_[0] == CHD_CODEC_NONE ? ReadMap(hdr.mapOffset) : ReadMapCompressed(hdr.mapOffset);
+	if (!success) {
+		ERROR_LOG(LOADER, "Invalid CHD hunk map. File: '%s'", fileLoader->Path().c_str());
+	} else if (isCD) {
+		success = ReadTrackMetadata(hdr.metaOffset, totalFrames);
+		if (!success)
+			ERROR_LOG(LOADER, "CHD has no usable data track. File: '%s'", fileLoader->Path().c_str());
+	} else {
+		numBlocks_ = (u32)totalFrames;
+	}
+
+	// Better to refuse the image now than to fail partway through a game.
+	if (!success || !CheckHunksReadable()) {
+		NotifyReadError();
+		hunks_.clear();
+		numBlocks_ = 0;
+		return;
+	}
+	VERBOSE_LOG(LOADER, "CHD numBlocks=%i numHunks=%i hunkBytes=%i", numBlocks_, (int)hunks_.size(), hunkBytes_);
+}
+
+bool CHDFileBlockDevice::ReadMap(u64 mapOffset) {
+	std::vector<u32_be> entries(hunks_.size());
+	if (fileLoader_->ReadAt(mapOffset, sizeof(u32_be), entries.size(), entries.data()) != entries.size())
+		return false;
+
+	for (size_t i = 0; i < hunks_.size(); ++i) {
+		// Uncompressed maps just point at hunk-sized slots, 0 is never written.
+		u32 slot = entries[i];
+		hunks_[i].type = slot == 0 ? CHD_COMPRESSION_ZEROS : CHD_COMPRESSION_NONE;
+		hunks_[i].offset = (u64)slot * hunkBytes_;
+		hunks_[i].length = hunkBytes_;
+	}
+	return true;
+}
+
+bool CHDFileBlockDevice::ReadMapCompressed(u64 mapOffset) {
+	u8 header[16];
+	if (fileLoader_->ReadAt(mapOffset, 1, sizeof(header), header) != sizeof(header))
+		return false;
+
+	const u32 mapBytes = (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+	u64 curOffset = 0;
+	for (int i = 4; i < 10; ++i)
+		curOffset = (curOffset << 8) | header[i];
+	const u16 mapCRC = (header[10] << 8) | header[11];
+	const int lengthBits = header[12];
+	const int selfBits = header[13];
+	const int parentBits = header[14];
+
+	std::vector<u8> compressed(mapBytes);
+	if (fileLoader_->ReadAt(mapOffset + sizeof(header), 1, mapBytes, compressed.data()) != mapBytes)
+		return false;
+
+	CHDBitReader bits(compressed.data(), compressed.size());
+	CHDHuffmanDecoder decoder(16, 8);
+	if (!decoder.ImportTreeRLE(bits))
+		return false;
+
+	// First the compression types, which are run-length encoded.
+	u8 lastType = 0;
+	int repeat = 0;
+	for (Hunk &hunk : hunks_) {
+		if (repeat > 0) {
+			hunk.type = lastType;
+			repeat--;
+			continue;
+		}
+		u32 value = decoder.DecodeOne(bits);
+		if (value == CHD_COMPRESSION_RLE_SMALL) {
+			hunk.type = lastType;
+			repeat = 2 + decoder.DecodeOne(bits);
+		} else if (value == CHD_COMPRESSION_RLE_LARGE) {
+			hunk.type = lastType;
+			repeat = 2 + 16 + (decoder.DecodeOne(bits) << 4);
+			repeat += decoder.DecodeOne(bits);
+		} else {
+			hunk.type = lastType = (u8)value;
+		}
+	}
+
+	// Then the offsets and lengths, which are mostly implied.
+	const u32 unitsPerHunk = hunkBytes_ / unitBytes_;
+	u64 lastSelf = 0;
+	u64 lastParent = 0;
+	u16 crc = 0xFFFF;
+	for (size_t i = 0; i < hunks_.size(); ++i) {
+		Hunk &hunk = hunks_[i];
+		u64 offset = curOffset;
+		u32 length = 0;
+		u16 hunkCRC = 0;
+		switch (hunk.type) {
+		case CHD_COMPRESSION_TYPE_0:
+		case CHD_COMPRESSION_TYPE_1:
+		case CHD_COMPRESSION_TYPE_2:
+		case CHD_COMPRESSION_TYPE_3:
+			length = (u32)bits.Read(lengthBits);
+			curOffset += length;
+			hunkCRC = (u16)bits.Read(16);
+			break;
+
+		case CHD_COMPRESSION_NONE:
+			length = hunkBytes_;
+			curOffset += length;
+			hunkCRC = (u16)bits.Read(16);
+			break;
+
+		case CHD_COMPRESSION_SELF:
+			lastSelf = offset = bits.Read(selfBits);
+			break;
+
+		case CHD_COMPRESSION_PARENT:
+			lastParent = offset = bits.Read(parentBits);
+			break;
+
+		case CHD_COMPRESSION_SELF_1:
+			lastSelf++;
+			// Fall through.
+		case CHD_COMPRESSION_SELF_0:
+			hunk.type = CHD_COMPRESSION_SELF;
+			offset = lastSelf;
+			break;
+
+		case CHD_COMPRESSION_PARENT_SELF:
+			hunk.type = CHD_COMPRESSION_PARENT;
+			lastParent = offset = (u64)i * unitsPerHunk;
+			break;
+
+		case CHD_COMPRESSION_PARENT_1:
+			lastParent += unitsPerHunk;
+			// Fall through.
+		case CHD_COMPRESSION_PARENT_0:
+			hunk.type = CHD_COMPRESSION_PARENT;
+			offset = lastParent;
+			break;
+
+		default:
+			return false;
+		}
+		hunk.offset = offset;
+		hunk.length = length;
+
+		// The CRC covers the map as it would be stored uncompressed.
+		const u8 raw[12] = {
+			hunk.type,
+			(u8)(length >> 16), (u8)(length >> 8), (u8)length,
+			(u8)(offset >> 40), (u8)(offset >> 32), (u8)(offset >> 24), (u8)(offset >> 16), (u8)(offset >> 8), (u8)offset,
+			(u8)(hunkCRC >> 8), (u8)hunkCRC,
+		};
+		crc = CHDCRC16(crc, raw, sizeof(raw));
+	}
+
+	if (bits.Overflowed() || crc != mapCRC)
+		return false;
+	return true;
+}
+
+bool CHDFileBlockDevice::ReadTrackMetadata(u64 metaOffset, u64 totalFrames) {
+	struct Track {
+		int number;
+		char type[32];
+		int frames;
+		int pregap;
+		char pregapType[32];
+	};
+	std::vector<Track> tracks;
+
+	// Metadata is a linked list of entries, each with a 16 byte header.
+	for (int entries = 0; metaOffset != 0 && entries < 1000; ++entries) {
+		u8 header[16];
+		if (fileLoader_->ReadAt(metaOffset, 1, sizeof(header), header) != sizeof(header))
+			return false;
+		const u32 tag = (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+		const u32 length = (header[5] << 16) | (header[6] << 8) | header[7];
+		u64 next = 0;
+		for (int i = 8; i < 16; ++i)
+			next = (next << 8) | header[i];
+
+		if ((tag == CHD_META_CD_TRACK || tag == CHD_META_CD_TRACK_OLD) && length < 256) {
+			char text[256]{};
+			if (fileLoader_->ReadAt(metaOffset + sizeof(header), 1, length, text) != length)
+				return false;
+
+			Track track{};
+			char subtype[32], pregapSubtype[32];
+			int postgap;
+			int fields;
+			if (tag == CHD_META_CD_TRACK) {
+				fields = sscanf(text, "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d PREGAP:%d PGTYPE:%31s PGSUB:%31s POSTGAP:%d", &track.number, track.type, subtype, &track.frames, &track.pregap, track.pregapType, pregapSubtype, &postgap);
+			} else {
+				fields = sscanf(text, "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d", &track.number, track.type, subtype, &track.frames) == 4 ? 8 : 0;
+			}
+			if (fields != 8 || track.frames <= 0 || track.pregap < 0)
+				return false;
+			tracks.push_back(track);
+		}
+		metaOffset = next;
+	}
+
+	std::sort(tracks.begin(), tracks.end(), [](const Track &a, const Track &b) {
+		return a.number < b.number;
+	});
+
+	// Each track starts on a multiple of 4 frames.  UMD images only have the one data track.
+	u64 frame = 0;
+	for (const Track &track : tracks) {
+		u32 offset;
+		if (!strcmp(track.type, "MODE1") || !strcmp(track.type, "MODE2_FORM1"))
+			offset = 0;
+		else if (!strcmp(track.type, "MODE2") || !strcmp(track.type, "MODE2_FORM_MIX"))
+			offset = 8;
+		else if (!strcmp(track.type, "MODE1_RAW"))
+			offset = 16;
+		else if (!strcmp(track.type, "MODE2_RAW"))
+			offset = 24;
+		else
+			offset = 0xFFFFFFFF;
+
+		if (offset != 0xFFFFFFFF) {
+			// A pregap type starting with V is stored in the image, before the data.
+			const u32 pregap = track.pregapType[0] == 'V' ? track.pregap : 0;
+			if ((u32)track.frames <= pregap || frame + track.frames > totalFrames)
+				return false;
+			firstFrame_ = (u32)frame + pregap;
+			numBlocks_ = track.frames - pregap;
+			sectorOffset_ = offset;
+			return true;
+		}
+		WARN_LOG(LOADER, "CHD: skipping track %d of type %s", track.number, track.type);
+		frame += (track.frames + 3) & ~3;
+	}
+	return false;
+}
+
+bool CHDFileBlockDevice::CheckHunksReadable() const {
+	if (numBlocks_ == 0)
+		return true;
+
+	// Only the data track matters, audio tracks might use codecs we don't have.
+	const u32 firstHunk = firstFrame_ / framesPerHunk_;
+	const u32 lastHunk = (firstFrame_ + numBlocks_ - 1) / framesPerHunk_;
+	for (u32 i = firstHunk; i <= lastHunk; ++i) {
+		const u32 source = SourceHunk(i);
+		const Hunk &hunk = hunks_[source];
+		switch (hunk.type) {
+		case CHD_COMPRESSION_TYPE_0:
+		case CHD_COMPRESSION_TYPE_1:
+		case CHD_COMPRESSION_TYPE_2:
+		case CHD_COMPRESSION_TYPE_3:
+		{
+			const u32 codec = compressors_[hunk.type];
+			const bool cdCodec = codec == CHD_CODEC_CD_ZLIB || codec == CHD_CODEC_CD_LZMA;
+			const bool supported = codec == CHD_CODEC_ZLIB || codec == CHD_CODEC_HUFFMAN || codec == CHD_CODEC_LZMA || cdCodec;
+			if (!supported || (cdCodec && unitBytes_ != CHD_CD_FRAME_SIZE)) {
+				ERROR_LOG(LOADER, "CHD codec %c%c%c%c (hunk %d) unsupported", (char)(codec >> 24), (char)(codec >> 16), (char)(codec >> 8), (char)codec, source);
+				return false;
+			}
+			break;
+		}
+
+		case CHD_COMPRESSION_NONE:
+		case CHD_COMPRESSION_ZEROS:
+			if (hunk.type == CHD_COMPRESSION_NONE && hunk.length != hunkBytes_)
+				return false;
+			break;
+
+		case CHD_COMPRESSION_PARENT:
+			ERROR_LOG(LOADER, "CHD hunk %d is in a parent image, which is not supported", source);
+			return false;
+
+		default:
+			ERROR_LOG(LOADER, "CHD hunk %d: compression type %d unsupported", source, hunk.type);
+			return false;
+		}
+	}
+	return true;
+}
+
+u32 CHDFileBlockDevice::SourceHunk(u32 hunk) const {
+	// Duplicate hunks just point at an earlier copy, so they can share cache entries.
+	for (size_t i = 0; i < hunks_.size() && hunks_[hunk].type == CHD_COMPRESSION_SELF; ++i) {
+		if (hunks_[hunk].offset >= hunks_.size())
+			break;
+		hunk = (u32)hunks_[hunk].offset;
+	}
+	return hunk;
+}
+
+bool CHDFileBlockDevice::ReadCompressed(u32 hunk, std::vector<u8> &compressed, bool uncached) {
+	const Hunk &info = hunks_[hunk];
+	switch (info.type) {
+	case CHD_COMPRESSION_TYPE_0:
+	case CHD_COMPRESSION_TYPE_1:
+	case CHD_COMPRESSION_TYPE_2:
+	case CHD_COMPRESSION_TYPE_3:
+	case CHD_COMPRESSION_NONE:
+		break;
+	case CHD_COMPRESSION_ZEROS:
+		return true;
+	default:
+		ERROR_LOG(LOADER, "CHD hunk %d: compression type %d unsupported", hunk, info.type);
+		return false;
+	}
+
+	FileLoader::Flags flags = uncached ? FileLoader::Flags::HINT_UNCACHED : FileLoader::Flags::NONE;
+	compressed.resize(info.length);
+	size_t readSize = fileLoader_->ReadAt(info.offset, 1, info.length, compressed.data(), flags);
+	if (readSize != info.length) {
+		ERROR_LOG(LOADER, "CHD hunk %d: could only read %d of %d bytes", hunk, (int)readSize, info.length);
+		return false;
+	}
+	return true;
+}
+
+bool CHDFileBlockDevice::DecompressHunk(u32 hunk, const std::vector<u8> &compressed, u8 *sectors) const {
+	const Hunk &info = hunks_[hunk];
+	const u32 blockSize = GetBlockSize();
+	if (info.type == CHD_COMPRESSION_ZEROS) {
+		memset(sectors, 0, framesPerHunk_ * blockSize);
+		return true;
+	}
+	if (compressed.size() != info.length)
+		return false;
+
+	// DVD style images are already just sectors.
+	if (unitBytes_ == blockSize) {
+		if (info.type == CHD_COMPRESSION_NONE) {
+			memcpy(sectors, compressed.data(), hunkBytes_);
+			return true;
+		}
+		u32 stride;
+		return DecompressCodec(hunk, compressors_[info.type], compressed.data(), compressed.size(), sectors, &stride);
+	}
+
+	const u8 *raw = compressed.data();
+	u32 stride = unitBytes_;
+	std::vector<u8> buffer;
+	if (info.type != CHD_COMPRESSION_NONE) {
+		buffer.resize(hunkBytes_);
+		if (!DecompressCodec(hunk, compressors_[info.type], compressed.data(), compressed.size(), buffer.data(), &stride))
+			return false;
+		raw = buffer.data();
+	}
+	for (u32 i = 0; i < framesPerHunk_; ++i)
+		memcpy(sectors + i * blockSize, raw + i * stride + sectorOffset_, blockSize);
+	return true;
+}
+
+bool CHDFileBlockDevice::DecompressCodec(u32 hunk, u32 codec, const u8 *src, size_t size, u8 *raw, u32 *stride) const {
+	*stride = unitBytes_;
+	switch (codec) {
+	case CHD_CODEC_ZLIB:
+		return CHDInflate(hunk, src, size, raw, hunkBytes_);
+
+	case CHD_CODEC_LZMA:
+	{
+		CHDLzmaDecoder decoder;
+		if (!decoder.Decode(src, size, raw, hunkBytes_)) {
+			ERROR_LOG(LOADER, "CHD hunk %d: lzma data invalid", hunk);
+			return false;
+		}
+		return true;
+	}
+
+	case CHD_CODEC_HUFFMAN:
+	{
+		CHDBitReader bits(src, size);
+		CHDHuffmanDecoder decoder(256, 16);
+		if (!decoder.ImportTreeHuffman(bits)) {
+			ERROR_LOG(LOADER, "CHD hunk %d: invalid huffman tree", hunk);
+			return false;
+		}
+		for (u32 i = 0; i < hunkBytes_; ++i)
+			raw[i] = (u8)decoder.DecodeOne(bits);
+		if (bits.Overflowed()) {
+			ERROR_LOG(LOADER, "CHD hunk %d: huffman data truncated", hunk);
+			return false;
+		}
+		return true;
+	}
+
+	case CHD_CODEC_CD_ZLIB:
+	case CHD_CODEC_CD_LZMA:
+	{
+		// A bitmap of frames with their sync and ECC stripped, the length of the sector data,
+		// then the sector data and the subcode, each compressed separately.
+		// Stripped frames still have their user data, which is all we need, so they're left as is.
+		const u32 eccBytes = (framesPerHunk_ + 7) / 8;
+		const u32 lengthBytes = hunkBytes_ >= 65536 ? 3 : 2;
+		if (size < eccBytes + lengthBytes)
+			return false;
+		u32 baseLength = 0;
+		for (u32 i = 0; i < lengthBytes; ++i)
+			baseLength = (baseLength << 8) | src[eccBytes + i];
+		const u8 *base = src + eccBytes + lengthBytes;
+		if (baseLength > size - eccBytes - lengthBytes)
+			return false;
+
+		// The subcode isn't needed.
+		*stride = CHD_CD_SECTOR_SIZE;
+		const u32 baseBytes = framesPerHunk_ * CHD_CD_SECTOR_SIZE;
+		if (codec == CHD_CODEC_CD_ZLIB)
+			return CHDInflate(hunk, base, baseLength, raw, baseBytes);
+		CHDLzmaDecoder decoder;
+		if (!decoder.Decode(base, baseLength, raw, baseBytes)) {
+			ERROR_LOG(LOADER, "CHD hunk %d: lzma data invalid", hunk);
+			return false;
+		}
+		return true;
+	}
+
+	default:
+		ERROR_LOG(LOADER, "CHD hunk %d: codec %08x unsupported", hunk, codec);
+		return false;
+	}
+}
+
+bool CHDFileBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached) {
+	return ReadHunks((u32)blockNumber, 1, outPtr, uncached);
+}
+
+bool CHDFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
+	return ReadHunks(minBlock, count, outPtr, false);
+}
+
+bool CHDFileBlockDevice::ReadHunks(u32 minBlock, int count, u8 *outPtr, bool uncached) {
+	if (minBlock >= numBlocks_ || count <= 0) {
+		memset(outPtr, 0, GetBlockSize() * std::max(count, 0));
+		return false;
+	}
+
+	const u32 lastBlock = std::min(minBlock + count, numBlocks_) - 1;
+	const u32 missingBlocks = count - (lastBlock + 1 - minBlock);
+	if (missingBlocks != 0) {
+		memset(outPtr + GetBlockSize() * (count - missingBlocks), 0, GetBlockSize() * missingBlocks);
+	}
+
+	// On CD images, blocks are frames of the data track.
+	const u32 firstFrame = minBlock + firstFrame_;
+	const u32 lastFrame = lastBlock + firstFrame_;
+	const u32 firstHunk = firstFrame / framesPerHunk_;
+	const u32 lastHunk = lastFrame / framesPerHunk_;
+	const u32 hunkSize = framesPerHunk_ * GetBlockSize();
+
+	auto copyHunk = [&](u32 hunk, const u8 *data) {
+		const u32 start = std::max(firstFrame, hunk * framesPerHunk_);
+		const u32 end = std::min(lastFrame, hunk * framesPerHunk_ + framesPerHunk_ - 1);
+		u8 *dest = outPtr + (start - firstFrame) * GetBlockSize();
+		if (data)
+			memcpy(dest, data + (start - hunk * framesPerHunk_) * GetBlockSize(), (end - start + 1) * GetBlockSize());
+		else
+			memset(dest, 0, (end - start + 1) * GetBlockSize());
+	};
+
+	// Copy what's cached, and find the hunks we don't have yet.
+	std::vector<u32> missing;
+	std::vector<u32> decompress;
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		for (u32 hunk = firstHunk; hunk <= lastHunk; ++hunk) {
+			const u32 source = SourceHunk(hunk);
+			auto cached = cache_.find(source);
+			if (cached != cache_.end()) {
+				lru_.splice(lru_.begin(), lru_, cached->second.lruPos);
+				copyHunk(hunk, cached->second.data.data());
+				continue;
+			}
+			missing.push_back(hunk);
+			if (std::find(decompress.begin(), decompress.end(), source) == decompress.end())
+				decompress.push_back(source);
+		}
+	}
+	if (missing.empty())
+		return true;
+
+	// Reading stays on this thread and in order, which suits slow file loaders best.
+	// Decompressing is the expensive part, so that's spread across the thread pool.
+	std::vector<std::vector<u8>> compressed(decompress.size());
+	std::vector<CachedHunk> decompressed(decompress.size());
+	std::vector<u8> success(decompress.size());
+	for (size_t i = 0; i < decompress.size(); ++i) {
+		success[i] = ReadCompressed(decompress[i], compressed[i], uncached);
+		decompressed[i].data.resize(hunkSize);
+	}
+
+	auto decompressRange = [&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i) {
+			if (success[i])
+				success[i] = DecompressHunk(decompress[i], compressed[i], decompressed[i].data.data());
+		}
+	};
+	if (decompress.size() > 1)
+		GlobalThreadPool::Loop(decompressRange, 0, (int)decompress.size());
+	else
+		decompressRange(0, (int)decompress.size());
+
+	bool result = true;
+	for (u32 hunk : missing) {
+		size_t index = std::find(decompress.begin(), decompress.end(), SourceHunk(hunk)) - decompress.begin();
+		copyHunk(hunk, success[index] ? decompressed[index].data.data() : nullptr);
+		if (!success[index])
+			result = false;
+	}
+
+	if (!result)
+		NotifyReadError();
+
+	// Uncached reads are full scans (like CRC calculation), which would just flush the cache.
+	if (uncached)
+		return result;
+
+	std::lock_guard<std::mutex> guard(lock_);
+	for (size_t i = 0; i < decompress.size(); ++i) {
+		// Another thread might have read the same hunk meanwhile.
+		if (!success[i] || cache_.find(decompress[i]) != cache_.end())
+			continue;
+		if (cache_.size() >= cacheCapacity_) {
+			cache_.erase(lru_.back());
+			lru_.pop_back();
+		}
+		lru_.push_front(decompress[i]);
+		decompressed[i].lruPos = lru_.begin();
+		cache_[decompress[i]] = std::move(decompressed[i]);
+	}
+	return result;
+}
+
 NPDRMDemoBlockDevice::NPDRMDemoBlockDevice(FileLoader *fileLoader)
 	: fileLoader_(fileLoader)
 {
@@ -19,11 +19,15 @@
 
 // Abstractions around read-only blockdevices, such as PSP UMD discs.
 // CISOFileBlockDevice implements compressed iso images, CISO format.
+// CHDFileBlockDevice implements MAME's compressed hunks of data format (v5.)
 //
 // The ISOFileSystemReader reads from a BlockDevice, so it automatically works
 // with CISO images.
 
+#include <list>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Core/ELF/PBPReader.h"
@@ -77,6 +81,54 @@ class CISOFileBlockDevice : public BlockDevice {
 	int ver_;
 };
 
+class CHDFileBlockDevice : public BlockDevice {
+public:
+	CHDFileBlockDevice(FileLoader *fileLoader);
+	bool ReadBlock(int blockNumber, u8 *outPtr, bool uncached = false) override;
+	bool ReadBlocks(u32 minBlock, int count, u8 *outPtr) override;
+	u32 GetNumBlocks() override { return numBlocks_; }
+	bool IsDisc() override { return true; }
+
+private:
+	struct Hunk {
+		u64 offset;
+		u32 length;
+		u8 type;
+	};
+	struct CachedHunk {
+		std::vector<u8> data;
+		std::list<u32>::iterator lruPos;
+	};
+
+	bool ReadMap(u64 mapOffset);
+	bool ReadMapCompressed(u64 mapOffset);
+	bool ReadTrackMetadata(u64 metaOffset, u64 totalFrames);
+	bool CheckHunksReadable() const;
+	u32 SourceHunk(u32 hunk) const;
+	bool ReadCompressed(u32 hunk, std::vector<u8> &compressed, bool uncached);
+	bool DecompressHunk(u32 hunk, const std::vector<u8> &compressed, u8 *sectors) const;
+	bool DecompressCodec(u32 hunk, u32 codec, const u8 *src, size_t size, u8 *raw, u32 *stride) const;
+	bool ReadHunks(u32 minBlock, int count, u8 *outPtr, bool uncached);
+
+	FileLoader *fileLoader_;
+	u32 compressors_[4]{};
+	u32 hunkBytes_ = 0;
+	u32 unitBytes_ = 0;
+	u32 framesPerHunk_ = 0;
+	u32 numBlocks_ = 0;
+	// For CD images, the first frame of the data track and where its 2048 byte sectors start in each frame.
+	u32 firstFrame_ = 0;
+	u32 sectorOffset_ = 0;
+	// The decoded hunk map, read once up front.
+	std::vector<Hunk> hunks_;
+
+	// Recently decompressed hunks, as 2048 byte sectors, most recently used first in lru_.
+	// Only held while looking at these, not while reading or decompressing.
+	std::mutex lock_;
+	std::unordered_map<u32, CachedHunk> cache_;
+	std::list<u32> lru_;
+	size_t cacheCapacity_ = 0;
+};
 
 class FileBlockDevice : public BlockDevice {
 public:
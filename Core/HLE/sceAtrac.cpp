@@ -16,9 +16,12 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include "Common/Serialize/Serializer.h"
 #include "Common/Serialize/SerializeFuncs.h"
+#include "Common/TimeUtil.h"
 #include "Core/HLE/HLE.h"
 #include "Core/HLE/FunctionWrappers.h"
 #include "Core/MIPS/MIPS.h"
@@ -26,6 +29,7 @@
 #include "Core/MemMapHelpers.h"
 #include "Core/Reporting.h"
 #include "Core/Config.h"
+#include "Core/ThreadPools.h"
 #include "Core/Debugger/Breakpoints.h"
 #include "Core/HW/MediaEngine.h"
 #include "Core/HW/BufferQueue.h"
@@ -117,6 +121,8 @@ const u32 ATRAC3PLUS_MAX_SAMPLES = 0x800;
 
 static const int atracDecodeDelay = 2300;
 
+const int PSP_NUM_ATRAC_IDS = 6;
+
 #ifdef USE_FFMPEG
 
 extern "C" {
@@ -172,6 +178,142 @@ struct AVPacket {
 };
 #endif
 
+// Per ID decode timing, shown with the audio debug stats.
+struct AtracDecodeStats {
+	bool decodingAhead;
+	// Frames ready in the decode-ahead ring when the last one was taken.
+	int ready;
+	int aheadPackets;
+	int syncPackets;
+	int restarts;
+	// Time spent in the decoder, on whichever thread decoded.
+	int decodes;
+	double decodeTime;
+	double decodeMax;
+	// Time the emu thread spent getting each packet, decoding or waiting on the ring.
+	double packetTime;
+	double packetMax;
+};
+
+static std::mutex atracStatsLock;
+static AtracDecodeStats atracStats[PSP_NUM_ATRAC_IDS];
+
+static void AtracResetStats(int atracID) {
+	if (atracID < 0 || atracID >= PSP_NUM_ATRAC_IDS)
+		return;
+	std::lock_guard<std::mutex> guard(atracStatsLock);
+	atracStats[atracID] = AtracDecodeStats();
+}
+
+static void AtracNoteDecode(int atracID, double seconds) {
+	if (atracID < 0 || atracID >= PSP_NUM_ATRAC_IDS)
+		return;
+	std::lock_guard<std::mutex> guard(atracStatsLock);
+	AtracDecodeStats &stats = atracStats[atracID];
+	stats.decodes++;
+	stats.decodeTime += seconds;
+	stats.decodeMax = std::max(stats.decodeMax, seconds);
+}
+
+static void AtracNotePacket(int atracID, double seconds, bool ahead, int ready) {
+	if (atracID < 0 || atracID >= PSP_NUM_ATRAC_IDS)
+		return;
+	std::lock_guard<std::mutex> guard(atracStatsLock);
+	AtracDecodeStats &stats = atracStats[atracID];
+	if (ahead) {
+		stats.aheadPackets++;
+		stats.ready = ready;
+	} else {
+		stats.syncPackets++;
+	}
+	stats.packetTime += seconds;
+	stats.packetMax = std::max(stats.packetMax, seconds);
+}
+
+static void AtracNoteDecodingAhead(int atracID, bool decodingAhead) {
+	if (atracID < 0 || atracID >= PSP_NUM_ATRAC_IDS)
+		return;
+	std::lock_guard<std::mutex> guard(atracStatsLock);
+	AtracDecodeStats &stats = atracStats[atracID];
+	if (stats.decodingAhead && !decodingAhead)
+		stats.restarts++;
+	stats.decodingAhead = decodingAhead;
+	if (!decodingAhead)
+		stats.ready = 0;
+}
+
+#ifdef USE_FFMPEG
+// Decodes packets on the global thread pool into a small ring of PCM frames, from the data in dataBuf_.
+// It only ever continues straight on from the last packet the emu thread decoded, so each frame is
+// exactly what decoding that packet on demand would have given, however far ahead it got.  Each task
+// fills the ring and returns, rather than holding a worker while the ring is full, and Take() queues
+// another once it's half empty.  Streamed data lands in dataBuf_ at its file offset, so as the game
+// adds more, Extend() lets it carry on past where it was.  While it's active, it owns the codec and
+// resampler contexts.
+class AtracDecodeAhead {
+public:
+	struct Frame {
+		AtracDecodeResult result = ATDECODE_FEEDME;
+		// Negative error from the decoder or resampler, if any.
+		int error = 0;
+		int samples = 0;
+		std::vector<s16> pcm;
+	};
+
+	AtracDecodeAhead(int atracID, AVCodecContext *codecCtx, SwrContext *swrCtx, int outputChannels)
+		: atracID_(atracID), codecCtx_(codecCtx), swrCtx_(swrCtx), outputChannels_(outputChannels) {
+	}
+	~AtracDecodeAhead();
+
+	// Decodes the packets of data from off up to end, in order.  Data up to fileEnd may be added later.
+	void Start(const u8 *data, u32 off, u32 end, u32 fileEnd, u32 bytesPerFrame);
+	// More data is in place, up to end.
+	void Extend(u32 end);
+	// Waits for the next frame and swaps it into frame.  Returns false if decoding stopped short of it.
+	bool Take(Frame &frame, int *ready);
+
+private:
+	enum { RING_SIZE = 8 };
+
+	class FillTask : public Task {
+	public:
+		explicit FillTask(AtracDecodeAhead *owner) : owner_(owner) {}
+		void Run() override {
+			owner_->Fill();
+		}
+
+	private:
+		AtracDecodeAhead *owner_;
+	};
+
+	void Fill();
+	void Decode(Frame &frame, u32 off, u32 size);
+
+	int atracID_;
+	AVCodecContext *codecCtx_;
+	SwrContext *swrCtx_;
+	AVFrame *avFrame_ = nullptr;
+	int outputChannels_;
+
+	const u8 *data_ = nullptr;
+	u32 nextOff_ = 0;
+	u32 end_ = 0;
+	u32 fileEnd_ = 0;
+	u32 bytesPerFrame_ = 0;
+
+	// Only ever submitted from the emu thread, and never again until it's done.
+	FillTask task_{ this };
+	std::mutex lock_;
+	Frame ring_[RING_SIZE];
+	int readPos_ = 0;
+	int count_ = 0;
+	bool stop_ = false;
+	bool done_ = false;
+	// The next packet isn't all there yet, until Extend().
+	bool starved_ = false;
+};
+#endif // USE_FFMPEG
+
 struct Atrac {
 	Atrac() : atracID_(-1), dataBuf_(0), decodePos_(0), bufferPos_(0),
 		channels_(0), outputChannels_(2), bitrate_(64), bytesPerFrame_(0), bufferMaxSize_(0), jointStereo_(0),
@@ -439,10 +581,25 @@ struct Atrac {
 	SwrContext      *swrCtx_ = nullptr;
 	AVFrame         *frame_ = nullptr;
 	AVPacket        *packet_ = nullptr;
+
+	AtracDecodeAhead *decodeAhead_ = nullptr;
+	// The last frame taken from decodeAhead_, used instead of frame_ when decodedAhead_ is set.
+	AtracDecodeAhead::Frame aheadFrame_;
+	bool decodedAhead_ = false;
+	// File offset of the next packet decodeAhead_ will hand out.
+	u32 aheadNextOff_ = 0;
+	// How much of dataBuf_ decodeAhead_ may read.
+	u32 aheadEnd_ = 0;
+	// If nonzero, where to start decoding ahead after the current packet.
+	u32 aheadStartOff_ = 0;
+	// Set when the decoder was flushed without a seek, and should be prefilled before use.
+	bool needsPrefill_ = false;
 #endif // USE_FFMPEG
 
 #ifdef USE_FFMPEG
 	void ReleaseFFMPEGContext() {
+		StopDecodeAhead();
+
 		// All of these allow null pointers.
 		av_freep(&frame_);
 		swr_free(&swrCtx_);
@@ -470,7 +627,9 @@ struct Atrac {
 
 	void ForceSeekToSample(int sample) {
 #ifdef USE_FFMPEG
+		StopDecodeAhead();
 		avcodec_flush_buffers(codecCtx_);
+		needsPrefill_ = false;
 
 		// Discard any pending packet data.
 		packet_->size = 0;
@@ -494,32 +653,40 @@ struct Atrac {
 		int seekFrame = sample + offsetSamples - unalignedSamples;
 
 		if ((sample != currentSample_ || sample == 0) && codecCtx_ != nullptr) {
-			// Prefill the decode buffer with packets before the first sample offset.
-			avcodec_flush_buffers(codecCtx_);
+			StopDecodeAhead();
 
 			int adjust = 0;
 			if (sample == 0) {
 				int offsetSamples = firstSampleOffset_ + FirstOffsetExtra();
 				adjust = -(int)(offsetSamples % SamplesPerFrame());
 			}
-			const u32 off = FileOffsetBySample(sample + adjust);
-			const u32 backfill = bytesPerFrame_ * 2;
-			const u32 start = off - dataOff_ < backfill ? dataOff_ : off - backfill;
-			for (u32 pos = start; pos < off; pos += bytesPerFrame_) {
-				av_init_packet(packet_);
-				packet_->data = BufferStart() + pos;
-				packet_->size = bytesPerFrame_;
-				packet_->pos = pos;
-
-				// Process the packet, we don't care about success.
-				DecodePacket();
-			}
+			ResetDecoder(FileOffsetBySample(sample + adjust));
 		}
 #endif // USE_FFMPEG
 
 		currentSample_ = sample;
 	}
 
+#ifdef USE_FFMPEG
+	// Flushes the decoder and prefills it with the packets before off.
+	void ResetDecoder(u32 off) {
+		avcodec_flush_buffers(codecCtx_);
+		needsPrefill_ = false;
+
+		const u32 backfill = bytesPerFrame_ * 2;
+		const u32 start = off - dataOff_ < backfill ? dataOff_ : off - backfill;
+		for (u32 pos = start; pos < off; pos += bytesPerFrame_) {
+			av_init_packet(packet_);
+			packet_->data = BufferStart() + pos;
+			packet_->size = bytesPerFrame_;
+			packet_->pos = pos;
+
+			// Process the packet, we don't care about success.
+			DecodePacket();
+		}
+	}
+#endif // USE_FFMPEG
+
 	bool FillPacket(int adjust = 0) {
 		u32 off = FileOffsetBySample(currentSample_ + adjust);
 		if (off < first_.size) {
@@ -555,8 +722,10 @@ struct Atrac {
 			return ATDECODE_FAILED;
 		}
 
+		double startTime = time_now_d();
 		int got_frame = 0;
 		int bytes_read = avcodec_decode_audio4(codecCtx_, frame_, &got_frame, packet_);
+		AtracNoteDecode(atracID_, time_now_d() - startTime);
 #if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 12, 100)
 		av_packet_unref(packet_);
 #else
@@ -579,6 +748,139 @@ struct Atrac {
 #endif // USE_FFMPEG
 	}
 
+#ifdef USE_FFMPEG
+	bool CanDecodeAhead() const {
+		// Decoding ahead reads dataBuf_ directly, not the game's buffer, which changes under it.
+		const bool managed = bufferState_ == ATRAC_STATUS_ALL_DATA_LOADED || bufferState_ == ATRAC_STATUS_HALFWAY_BUFFER || (bufferState_ & ATRAC_STATUS_STREAMED_MASK) == ATRAC_STATUS_STREAMED_MASK;
+		return g_Config.bAtracDecodeAhead && managed && !ignoreDataBuf_ && dataBuf_ != nullptr && codecCtx_ != nullptr && swrCtx_ != nullptr;
+	}
+
+	// Like DecodePacket(), for the packet FillPacket() set up, but takes it from the decode-ahead ring if it's the next one there.
+	AtracDecodeResult DecodeNextPacket() {
+		const u32 off = (u32)packet_->pos;
+		const int size = packet_->size;
+		double startTime = time_now_d();
+		int ready = 0;
+
+		AtracDecodeResult res;
+		decodedAhead_ = false;
+		if (decodeAhead_ && off == aheadNextOff_ && CanDecodeAhead() && decodeAhead_->Take(aheadFrame_, &ready)) {
+			decodedAhead_ = true;
+			aheadNextOff_ += bytesPerFrame_;
+			packet_->size = 0;
+
+			res = aheadFrame_.result;
+			if (res == ATDECODE_BADFRAME) {
+				ERROR_LOG(ME, "Unsupported feature in ATRAC audio.");
+			} else if (res == ATDECODE_FAILED) {
+				ERROR_LOG_REPORT(ME, "avcodec_decode_audio4: Error decoding audio %d / %08x", aheadFrame_.error, aheadFrame_.error);
+				failedDecode_ = true;
+			}
+		} else {
+			StopDecodeAhead();
+			if (needsPrefill_) {
+				// Stopping decoding ahead flushed the decoder, so prefill it the same way a seek would.
+				ResetDecoder(off);
+				av_init_packet(packet_);
+				packet_->data = BufferStart() + off;
+				packet_->size = size;
+				packet_->pos = off;
+			}
+
+			res = DecodePacket();
+			if (res != ATDECODE_FAILED && CanDecodeAhead() && off + bytesPerFrame_ < first_.size) {
+				// Can't start yet, swrCtx_ is still needed for this frame.
+				aheadStartOff_ = off + bytesPerFrame_;
+			}
+		}
+
+		AtracNotePacket(atracID_, time_now_d() - startTime, decodedAhead_, ready);
+		return res;
+	}
+
+	int DecodedSamples() const {
+		return decodedAhead_ ? aheadFrame_.samples : frame_->nb_samples;
+	}
+
+	// Writes count samples from the last decoded frame, starting at skipped.
+	void WriteDecodedSamples(u8 *outbuf, int skipped, int count) {
+		if (decodedAhead_) {
+			if (aheadFrame_.error < 0) {
+				ERROR_LOG(ME, "swr_convert: Error while converting %d", aheadFrame_.error);
+			}
+			memcpy(outbuf, &aheadFrame_.pcm[skipped * outputChannels_], count * outputChannels_ * sizeof(s16));
+			return;
+		}
+
+		int inbufOffset = 0;
+		if (skipped != 0) {
+			AVSampleFormat fmt = (AVSampleFormat)frame_->format;
+			// We want the offset per channel.
+			inbufOffset = av_samples_get_buffer_size(NULL, 1, skipped, fmt, 1);
+		}
+
+		u8 *out = outbuf;
+		const u8 *inbuf[2] = {
+			frame_->extended_data[0] + inbufOffset,
+			frame_->extended_data[1] + inbufOffset,
+		};
+		int avret = swr_convert(swrCtx_, &out, count, inbuf, count);
+		if (avret < 0) {
+			ERROR_LOG(ME, "swr_convert: Error while converting %d", avret);
+		}
+	}
+
+	// Starts decoding ahead after a packet decoded on this thread, once its samples are written out.
+	void StartDecodeAhead() {
+		if (aheadStartOff_ != 0 && !decodeAhead_ && CanDecodeAhead()) {
+			decodeAhead_ = new AtracDecodeAhead(atracID_, codecCtx_, swrCtx_, outputChannels_);
+			decodeAhead_->Start(BufferStart(), aheadStartOff_, first_.size, first_.filesize, bytesPerFrame_);
+			aheadNextOff_ = aheadStartOff_;
+			aheadEnd_ = first_.size;
+			AtracNoteDecodingAhead(atracID_, true);
+		}
+		aheadStartOff_ = 0;
+	}
+#endif // USE_FFMPEG
+
+	// Needed before copying bytes of stream data into dataBuf_ at off.  Decoding ahead only reads
+	// from the next packet the emu thread will use up to aheadEnd_, so data can go in after or behind that.
+	void BeforeAddStreamData(u32 off, u32 bytes) {
+#ifdef USE_FFMPEG
+		if (decodeAhead_ && off < aheadEnd_ && off + bytes > aheadNextOff_)
+			StopDecodeAhead();
+#endif // USE_FFMPEG
+	}
+
+	// Lets decoding ahead continue into stream data added to dataBuf_, once first_.size counts it.
+	void AfterAddStreamData() {
+#ifdef USE_FFMPEG
+		if (decodeAhead_ && first_.size > aheadEnd_) {
+			aheadEnd_ = first_.size;
+			decodeAhead_->Extend(aheadEnd_);
+		}
+#endif // USE_FFMPEG
+	}
+
+	// Needed before anything else uses the decoder or changes dataBuf_.
+	void StopDecodeAhead() {
+#ifdef USE_FFMPEG
+		aheadStartOff_ = 0;
+		decodedAhead_ = false;
+		if (!decodeAhead_)
+			return;
+
+		delete decodeAhead_;
+		decodeAhead_ = nullptr;
+		AtracNoteDecodingAhead(atracID_, false);
+
+		// How far it got depends on timing, so always start over from a flushed decoder.
+		if (codecCtx_)
+			avcodec_flush_buffers(codecCtx_);
+		needsPrefill_ = true;
+#endif // USE_FFMPEG
+	}
+
 	void CalculateStreamInfo(u32 *readOffset);
 
 	u32 StreamBufferEnd() const {
@@ -606,6 +908,132 @@ struct Atrac {
 	void AnalyzeReset();
 };
 
+#ifdef USE_FFMPEG
+AtracDecodeAhead::~AtracDecodeAhead() {
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		stop_ = true;
+	}
+	// A queued task still has to run, but it'll stop before decoding anything.
+	if (data_)
+		task_.Wait();
+	av_frame_free(&avFrame_);
+}
+
+void AtracDecodeAhead::Start(const u8 *data, u32 off, u32 end, u32 fileEnd, u32 bytesPerFrame) {
+	data_ = data;
+	nextOff_ = off;
+	end_ = end;
+	fileEnd_ = fileEnd;
+	bytesPerFrame_ = bytesPerFrame;
+	avFrame_ = av_frame_alloc();
+	GlobalThreadPool::Submit(&task_);
+}
+
+void AtracDecodeAhead::Extend(u32 end) {
+	std::unique_lock<std::mutex> guard(lock_);
+	end_ = end;
+	// If the task hasn't quite finished, Take() will queue the next one.
+	bool resume = starved_ && task_.IsDone();
+	starved_ = false;
+	guard.unlock();
+	if (resume)
+		GlobalThreadPool::Submit(&task_);
+}
+
+bool AtracDecodeAhead::Take(Frame &frame, int *ready) {
+	std::unique_lock<std::mutex> guard(lock_);
+	while (count_ == 0 && !done_ && !starved_) {
+		// A task only stops early when the ring is full or it's out of data, and it may have done
+		// that before the ring drained, without a refill queued yet.  Waiting on a running task
+		// helps with queued work, so this doesn't stall if the pool is busy.
+		bool idle = task_.IsDone();
+		guard.unlock();
+		if (idle)
+			GlobalThreadPool::Submit(&task_);
+		else
+			task_.Wait();
+		guard.lock();
+	}
+	if (count_ == 0)
+		return false;
+
+	*ready = count_;
+	Frame &next = ring_[readPos_];
+	frame.result = next.result;
+	frame.error = next.error;
+	frame.samples = next.samples;
+	// The buffer we hand back gets reused for a later frame.
+	frame.pcm.swap(next.pcm);
+	readPos_ = (readPos_ + 1) % RING_SIZE;
+	count_--;
+
+	// Topping up a frame at a time would mostly be task overhead.
+	bool refill = !done_ && !starved_ && count_ <= RING_SIZE / 2 && task_.IsDone();
+	guard.unlock();
+	if (refill)
+		GlobalThreadPool::Submit(&task_);
+	return true;
+}
+
+void AtracDecodeAhead::Fill() {
+	std::unique_lock<std::mutex> guard(lock_);
+	while (!stop_ && !done_ && count_ < RING_SIZE) {
+		// A packet cut short by the end of the data so far would decode differently once the rest arrives.
+		if (end_ < fileEnd_ && nextOff_ + bytesPerFrame_ > end_) {
+			starved_ = true;
+			break;
+		}
+		// Take doesn't move this slot, it only shrinks the range before it.
+		Frame &frame = ring_[(readPos_ + count_) % RING_SIZE];
+		u32 off = nextOff_;
+		u32 size = std::min(bytesPerFrame_, end_ - off);
+		guard.unlock();
+		Decode(frame, off, size);
+		guard.lock();
+
+		nextOff_ += bytesPerFrame_;
+		count_++;
+		if (frame.result == ATDECODE_FAILED || nextOff_ >= fileEnd_)
+			done_ = true;
+	}
+}
+
+void AtracDecodeAhead::Decode(Frame &frame, u32 off, u32 size) {
+	double startTime = time_now_d();
+
+	AVPacket packet;
+	av_init_packet(&packet);
+	packet.data = const_cast<u8 *>(data_ + off);
+	packet.size = size;
+	packet.pos = off;
+
+	int got_frame = 0;
+	int bytes_read = avcodec_decode_audio4(codecCtx_, avFrame_, &got_frame, &packet);
+	frame.error = 0;
+	frame.samples = 0;
+	if (bytes_read == AVERROR_PATCHWELCOME) {
+		frame.result = ATDECODE_BADFRAME;
+	} else if (bytes_read < 0) {
+		frame.result = ATDECODE_FAILED;
+		frame.error = bytes_read;
+	} else if (!got_frame) {
+		frame.result = ATDECODE_FEEDME;
+	} else {
+		// Converting the whole frame gives the same samples as converting just the part used later.
+		frame.result = ATDECODE_GOTFRAME;
+		frame.samples = avFrame_->nb_samples;
+		frame.pcm.resize(frame.samples * outputChannels_);
+		u8 *out = (u8 *)frame.pcm.data();
+		int avret = swr_convert(swrCtx_, &out, frame.samples, (const u8 **)avFrame_->extended_data, frame.samples);
+		if (avret < 0)
+			frame.error = avret;
+	}
+
+	AtracNoteDecode(atracID_, time_now_d() - startTime);
+}
+#endif // USE_FFMPEG
+
 struct AtracSingleResetBufferInfo {
 	u32_le writePosPtr;
 	u32_le writableBytes;
@@ -618,7 +1046,6 @@ struct AtracResetBufferInfo {
 	AtracSingleResetBufferInfo second;
 };
 
-const int PSP_NUM_ATRAC_IDS = 6;
 static bool atracInited = true;
 static Atrac *atracIDs[PSP_NUM_ATRAC_IDS];
 static u32 atracIDTypes[PSP_NUM_ATRAC_IDS];
@@ -626,6 +1053,8 @@ static u32 atracIDTypes[PSP_NUM_ATRAC_IDS];
 void __AtracInit() {
 	atracInited = true;
 	memset(atracIDs, 0, sizeof(atracIDs));
+	for (int i = 0; i < PSP_NUM_ATRAC_IDS; ++i)
+		AtracResetStats(i);
 
 	// Start with 2 of each in this order.
 	atracIDTypes[0] = PSP_MODE_AT_3_PLUS;
@@ -667,6 +1096,32 @@ void __AtracShutdown() {
 	}
 }
 
+void __AtracGetDebugStats(char *buf, size_t bufSize) {
+	std::lock_guard<std::mutex> guard(atracStatsLock);
+	size_t len = snprintf(buf, bufSize, "Atrac decode ahead: %s\n", g_Config.bAtracDecodeAhead ? "on" : "off");
+	for (int i = 0; i < PSP_NUM_ATRAC_IDS && len < bufSize; ++i) {
+		const AtracDecodeStats &stats = atracStats[i];
+		int packets = stats.aheadPackets + stats.syncPackets;
+		if (packets == 0)
+			continue;
+
+		double decodeAvg = stats.decodes == 0 ? 0.0 : stats.decodeTime / stats.decodes;
+		len += snprintf(buf + len, bufSize - len,
+			"Atrac %d: %s, %d ready (%d ahead, %d on demand, %d restarts)\n"
+			"  Decode: avg %0.1f us, max %0.1f us; per packet: avg %0.1f us, max %0.1f us\n",
+			i,
+			stats.decodingAhead ? "ahead" : "on demand",
+			stats.ready,
+			stats.aheadPackets,
+			stats.syncPackets,
+			stats.restarts,
+			decodeAvg * 1000000.0,
+			stats.decodeMax * 1000000.0,
+			stats.packetTime / packets * 1000000.0,
+			stats.packetMax * 1000000.0);
+	}
+}
+
 static Atrac *getAtrac(int atracID) {
 	if (atracID < 0 || atracID >= PSP_NUM_ATRAC_IDS) {
 		return NULL;
@@ -689,6 +1144,7 @@ static int createAtrac(Atrac *atrac) {
 		if (atracIDTypes[i] == atrac->codecType_ && atracIDs[i] == 0) {
 			atracIDs[i] = atrac;
 			atrac->atracID_ = i;
+			AtracResetStats(i);
 			return i;
 		}
 	}
@@ -701,6 +1157,7 @@ static int deleteAtrac(int atracID) {
 		if (atracIDs[atracID] != nullptr) {
 			delete atracIDs[atracID];
 			atracIDs[atracID] = nullptr;
+			AtracResetStats(atracID);
 
 			return 0;
 		}
@@ -1007,6 +1464,7 @@ u32 _AtracAddStreamData(int atracID, u32 bufPtr, u32 bytesToAdd) {
 	if (!atrac)
 		return 0;
 	int addbytes = std::min(bytesToAdd, atrac->first_.filesize - atrac->first_.fileoffset);
+	atrac->BeforeAddStreamData(atrac->first_.fileoffset, addbytes);
 	Memory::Memcpy(atrac->dataBuf_ + atrac->first_.fileoffset, bufPtr, addbytes);
 	atrac->first_.size += bytesToAdd;
 	if (atrac->first_.size >= atrac->first_.filesize) {
@@ -1015,6 +1473,7 @@ u32 _AtracAddStreamData(int atracID, u32 bufPtr, u32 bytesToAdd) {
 			atrac->bufferState_ = ATRAC_STATUS_ALL_DATA_LOADED;
 	}
 	atrac->first_.fileoffset += addbytes;
+	atrac->AfterAddStreamData();
 	if (atrac->context_.IsValid()) {
 		// refresh context_
 		_AtracGenerateContext(atrac, atrac->context_);
@@ -1118,6 +1577,7 @@ static u32 sceAtracAddStreamData(int atracID, u32 bytesToAdd) {
 		atrac->first_.fileoffset = readOffset;
 		int addbytes = std::min(bytesToAdd, atrac->first_.filesize - atrac->first_.fileoffset);
 		if (!atrac->ignoreDataBuf_) {
+			atrac->BeforeAddStreamData(atrac->first_.fileoffset, addbytes);
 			Memory::Memcpy(atrac->dataBuf_ + atrac->first_.fileoffset, atrac->first_.addr + atrac->first_.offset, addbytes);
 		}
 		atrac->first_.fileoffset += addbytes;
@@ -1134,6 +1594,7 @@ static u32 sceAtracAddStreamData(int atracID, u32 bytesToAdd) {
 
 	atrac->first_.offset += bytesToAdd;
 	atrac->bufferValidBytes_ += bytesToAdd;
+	atrac->AfterAddStreamData();
 
 	return hleLogSuccessI(ME, 0);
 }
@@ -1184,7 +1645,11 @@ u32 _AtracDecodeData(int atracID, u8 *outbuf, u32 outbufPtr, u32 *SamplesNum, u3
 
 				AtracDecodeResult res = ATDECODE_FEEDME;
 				while (atrac->FillPacket(-skipSamples)) {
+#ifdef USE_FFMPEG
+					res = atrac->DecodeNextPacket();
+#else
 					res = atrac->DecodePacket();
+#endif // USE_FFMPEG
 					if (res == ATDECODE_FAILED) {
 						*SamplesNum = 0;
 						*finish = 1;
@@ -1194,9 +1659,10 @@ u32 _AtracDecodeData(int atracID, u8 *outbuf, u32 outbufPtr, u32 *SamplesNum, u3
 					if (res == ATDECODE_GOTFRAME) {
 #ifdef USE_FFMPEG
 						// got a frame
-						int skipped = std::min(skipSamples, atrac->frame_->nb_samples);
+						int frameSamples = atrac->DecodedSamples();
+						int skipped = std::min(skipSamples, frameSamples);
 						skipSamples -= skipped;
-						numSamples = atrac->frame_->nb_samples - skipped;
+						numSamples = frameSamples - skipped;
 
 						// If we're at the end, clamp to samples we want.  It always returns a full chunk.
 						numSamples = std::min(maxSamples, numSamples);
@@ -1207,26 +1673,11 @@ u32 _AtracDecodeData(int atracID, u8 *outbuf, u32 outbufPtr, u32 *SamplesNum, u3
 						}
 
 						if (outbuf != NULL && numSamples != 0) {
-							int inbufOffset = 0;
-							if (skipped != 0) {
-								AVSampleFormat fmt = (AVSampleFormat)atrac->frame_->format;
-								// We want the offset per channel.
-								inbufOffset = av_samples_get_buffer_size(NULL, 1, skipped, fmt, 1);
-							}
-
-							u8 *out = outbuf;
-							const u8 *inbuf[2] = {
-								atrac->frame_->extended_data[0] + inbufOffset,
-								atrac->frame_->extended_data[1] + inbufOffset,
-							};
-							int avret = swr_convert(atrac->swrCtx_, &out, numSamples, inbuf, numSamples);
+							atrac->WriteDecodedSamples(outbuf, skipped, numSamples);
 							if (outbufPtr != 0) {
 								u32 outBytes = numSamples * atrac->outputChannels_ * sizeof(s16);
 								CBreakPoints::ExecMemCheck(outbufPtr, true, outBytes, currentMIPS->pc);
 							}
-							if (avret < 0) {
-								ERROR_LOG(ME, "swr_convert: Error while converting %d", avret);
-							}
 						}
 #endif // USE_FFMPEG
 					}
@@ -1284,6 +1735,11 @@ u32 _AtracDecodeData(int atracID, u8 *outbuf, u32 outbufPtr, u32 *SamplesNum, u3
 				atrac->currentSample_ += atrac->SamplesPerFrame() - numSamples;
 			}
 
+#ifdef USE_FFMPEG
+			// Unless we just seeked, carry on decoding from here in the background.
+			atrac->StartDecodeAhead();
+#endif // USE_FFMPEG
+
 			*finish = finishFlag;
 			*remains = atrac->RemainingFrames();
 		}
@@ -1705,6 +2161,7 @@ static u32 sceAtracResetPlayPosition(int atracID, int sample, int bytesWrittenFi
 			// Okay, it's a valid number of bytes.  Let's set them up.
 			if (bytesWrittenFirstBuf != 0) {
 				if (!atrac->ignoreDataBuf_) {
+					atrac->StopDecodeAhead();
 					Memory::Memcpy(atrac->dataBuf_ + atrac->first_.size, atrac->first_.addr + atrac->first_.size, bytesWrittenFirstBuf);
 				}
 				atrac->first_.fileoffset += bytesWrittenFirstBuf;
@@ -1728,6 +2185,7 @@ static u32 sceAtracResetPlayPosition(int atracID, int sample, int bytesWrittenFi
 
 			if (bytesWrittenFirstBuf != 0) {
 				if (!atrac->ignoreDataBuf_) {
+					atrac->StopDecodeAhead();
 					Memory::Memcpy(atrac->dataBuf_ + atrac->first_.fileoffset, atrac->first_.addr, bytesWrittenFirstBuf);
 				}
 				atrac->first_.fileoffset += bytesWrittenFirstBuf;
@@ -1756,6 +2214,7 @@ static u32 sceAtracResetPlayPosition(int atracID, int sample, int bytesWrittenFi
 static int __AtracUpdateOutputMode(Atrac *atrac, int wanted_channels) {
 	if (atrac->swrCtx_ && atrac->outputChannels_ == wanted_channels)
 		return 0;
+	atrac->StopDecodeAhead();
 	atrac->outputChannels_ = wanted_channels;
 	int64_t wanted_channel_layout = av_get_default_channel_layout(wanted_channels);
 	int64_t dec_channel_layout = av_get_default_channel_layout(atrac->channels_);
@@ -2435,6 +2894,7 @@ static int sceAtracLowLevelDecode(int atracID, u32 sourceAddr, u32 sourceBytesCo
 	int numSamples = (atrac->codecType_ == PSP_MODE_AT_3_PLUS ? ATRAC3PLUS_MAX_SAMPLES : ATRAC3_MAX_SAMPLES);
 
 	if (!atrac->failedDecode_) {
+		atrac->StopDecodeAhead();
 		atrac->FillLowLevelPacket(srcp);
 
 		AtracDecodeResult res = atrac->DecodePacket();
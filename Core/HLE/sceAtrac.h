@@ -25,6 +25,7 @@ void Register_sceAtrac3plus();
 void __AtracInit();
 void __AtracDoState(PointerWrap &p);
 void __AtracShutdown();
+void __AtracGetDebugStats(char *buf, size_t bufSize);
 
 enum AtracStatus : u8 {
 	ATRAC_STATUS_NO_DATA = 1,
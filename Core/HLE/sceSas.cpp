@@ -43,6 +43,7 @@
 #include "Core/MIPS/MIPS.h"
 #include "Core/HW/SasAudio.h"
 #include "Core/MemMap.h"
+#include "Core/Replay.h"
 #include "Core/Reporting.h"
 
 #include "Core/HLE/sceSas.h"
@@ -131,6 +132,14 @@ static void __SasEnqueueMix(u32 outAddr, u32 inAddr = 0, int leftVol = 0, int ri
 		return;
 	}
 
+	if (ReplayIsActive()) {
+		// Other PSP threads could see the output half written, so a replay might not play back the same.
+		// Mix on this thread instead, after anything still queued.
+		__SasDrain();
+		sas->Mix(outAddr, inAddr, leftVol, rightVol);
+		return;
+	}
+
 	if (sasThreadState == SasThreadState::QUEUED) {
 		// Wait for the queue to drain.
 		__SasDrain();
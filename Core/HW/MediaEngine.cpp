@@ -15,6 +15,8 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include "Common/ColorConv.h"
+#include "Common/CPUDetect.h"
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Core/Config.h"
 #include "Core/Debugger/Breakpoints.h"
@@ -122,12 +124,15 @@ MediaEngine::MediaEngine(): m_pdata(0) {
 	m_pFormatCtx = 0;
 	m_pCodecCtxs.clear();
 	m_pFrame = 0;
+	m_pDecodeFrame = 0;
 	m_pFrameRGB = 0;
 	m_pIOContext = 0;
 	m_sws_ctx = 0;
 #endif
 	m_sws_fmt = 0;
 	m_buffer = 0;
+	m_frameRGBPixelMode = GE_CMODE_32BIT_ABGR8888;
+	m_frameRGBDirty = false;
 
 	m_videoStream = -1;
 	m_audioStream = -1;
@@ -348,6 +353,8 @@ void MediaEngine::closeContext()
 		av_frame_free(&m_pFrameRGB);
 	if (m_pFrame)
 		av_frame_free(&m_pFrame);
+	if (m_pDecodeFrame)
+		av_frame_free(&m_pDecodeFrame);
 	if (m_pIOContext && m_pIOContext->buffer)
 		av_free(m_pIOContext->buffer);
 	if (m_pIOContext)
@@ -362,6 +369,7 @@ void MediaEngine::closeContext()
 	m_pIOContext = 0;
 #endif
 	m_buffer = 0;
+	m_frameRGBDirty = false;
 }
 
 bool MediaEngine::loadStream(const u8 *buffer, int readSize, int RingbufferSize)
@@ -471,11 +479,12 @@ bool MediaEngine::setVideoStream(int streamNum, bool force) {
 			return false;
 		}
 
-		AVDictionary *opt = nullptr;
-		// Allow ffmpeg to use any number of threads it wants.  Without this, it doesn't use threads.
-		av_dict_set(&opt, "threads", "0", 0);
-		int openResult = avcodec_open2(m_pCodecCtx, pCodec, &opt);
-		av_dict_free(&opt);
+		// Frame threads keep a few frames decoding ahead of the one we return, which is what
+		// keeps up on slow cores.  Each one adds a frame of delay, and PSP sized video has nothing
+		// to gain from more than a few.  Slices help the odd video that has several.
+		m_pCodecCtx->thread_count = std::min(std::max(cpu_info.num_cores, 1), 4);
+		m_pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+		int openResult = avcodec_open2(m_pCodecCtx, pCodec, nullptr);
 		if (openResult < 0) {
 			return false;
 		}
@@ -512,6 +521,9 @@ bool MediaEngine::setVideoDim(int width, int height)
 	if (!m_pFrame) {
 		m_pFrame = av_frame_alloc();
 	}
+	if (!m_pDecodeFrame) {
+		m_pDecodeFrame = av_frame_alloc();
+	}
 
 	sws_freeContext(m_sws_ctx);
 	m_sws_ctx = NULL;
@@ -589,7 +601,7 @@ bool MediaEngine::stepVideo(int videoPixelMode, bool skipFrame) {
 		return false;
 	if (!m_pCodecCtx)
 		return false;
-	if (!m_pFrame)
+	if (!m_pFrame || !m_pDecodeFrame)
 		return false;
 
 	AVPacket packet;
@@ -610,19 +622,22 @@ bool MediaEngine::stepVideo(int videoPixelMode, bool skipFrame) {
 				av_free_packet(&packet);
 #endif
 
-			int result = avcodec_decode_video2(m_pCodecCtx, m_pFrame, &frameFinished, &packet);
+			// This unrefs m_pDecodeFrame even when no frame comes out, so m_pFrame stays intact until one does.
+			int result = avcodec_decode_video2(m_pCodecCtx, m_pDecodeFrame, &frameFinished, &packet);
 			if (frameFinished) {
+				// A skip must keep showing the last frame we returned, so convert it before replacing it.
+				if (skipFrame)
+					updateFrameRGB();
+				av_frame_unref(m_pFrame);
+				av_frame_move_ref(m_pFrame, m_pDecodeFrame);
+
 				if (!m_pFrameRGB) {
 					setVideoDim();
 				}
 				if (m_pFrameRGB && !skipFrame) {
-					updateSwsFormat(videoPixelMode);
-					// TODO: Technically we could set this to frameWidth instead of m_desWidth for better perf.
-					// Update the linesize for the new format too.  We started with the largest size, so it should fit.
-					m_pFrameRGB->linesize[0] = getPixelFormatBytes(videoPixelMode) * m_desWidth;
-
-					sws_scale(m_sws_ctx, m_pFrame->data, m_pFrame->linesize, 0,
-						m_pCodecCtx->height, m_pFrameRGB->data, m_pFrameRGB->linesize);
+					// Converted when needed, writeVideoImage() can usually skip the RGB frame entirely.
+					m_frameRGBPixelMode = videoPixelMode;
+					m_frameRGBDirty = true;
 				}
 
 				if (av_frame_get_best_effort_timestamp(m_pFrame) != AV_NOPTS_VALUE)
@@ -654,6 +669,27 @@ bool MediaEngine::stepVideo(int videoPixelMode, bool skipFrame) {
 #endif // USE_FFMPEG
 }
 
+void MediaEngine::updateFrameRGB() {
+#ifdef USE_FFMPEG
+	if (!m_frameRGBDirty)
+		return;
+	m_frameRGBDirty = false;
+
+	auto codecIter = m_pCodecCtxs.find(m_videoStream);
+	AVCodecContext *m_pCodecCtx = codecIter == m_pCodecCtxs.end() ? 0 : codecIter->second;
+	if (!m_pCodecCtx || !m_pFrame || !m_pFrame->data[0] || !m_pFrameRGB)
+		return;
+
+	updateSwsFormat(m_frameRGBPixelMode);
+	// TODO: Technically we could set this to frameWidth instead of m_desWidth for better perf.
+	// Update the linesize for the new format too.  We started with the largest size, so it should fit.
+	m_pFrameRGB->linesize[0] = getPixelFormatBytes(m_frameRGBPixelMode) * m_desWidth;
+
+	sws_scale(m_sws_ctx, m_pFrame->data, m_pFrame->linesize, 0,
+		m_pCodecCtx->height, m_pFrameRGB->data, m_pFrameRGB->linesize);
+#endif
+}
+
 // Helpers that null out alpha (which seems to be the case on the PSP.)
 // Some games depend on this, for example Sword Art Online (doesn't clear A's from buffer.)
 inline void writeVideoLineRGBA(void *destp, const void *srcp, int width) {
@@ -731,38 +767,78 @@ int MediaEngine::writeVideoImage(u32 bufferPtr, int frameWidth, int videoPixelMo
 		imgbuf = new u8[videoImageSize];
 	}
 
+	// If the decoded frame hasn't been through swscale yet, we can convert it straight into place.
+	// m_pFrameRGB is left for updateFrameRGB() to fill if something needs it.
+	bool direct = m_frameRGBDirty && m_pFrame->data[0] && m_pFrame->format == AV_PIX_FMT_YUV420P;
+	direct = direct && m_pFrame->width == width && m_pFrame->height == height;
 	switch (videoPixelMode) {
 	case GE_CMODE_32BIT_ABGR8888:
-		for (int y = 0; y < height; y++) {
-			writeVideoLineRGBA(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u32);
-		}
-		break;
-
 	case GE_CMODE_16BIT_BGR5650:
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR5650(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u16);
-		}
-		break;
-
 	case GE_CMODE_16BIT_ABGR5551:
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR5551(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u16);
-		}
+	case GE_CMODE_16BIT_ABGR4444:
 		break;
+	default:
+		direct = false;
+		break;
+	}
 
-	case GE_CMODE_16BIT_ABGR4444:
+	if (direct) {
 		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR4444(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u16);
+			u8 *dest = imgbuf + videoLineSize * y;
+			const u8 *ySrc = m_pFrame->data[0] + m_pFrame->linesize[0] * y;
+			const u8 *uSrc = m_pFrame->data[1] + m_pFrame->linesize[1] * (y >> 1);
+			const u8 *vSrc = m_pFrame->data[2] + m_pFrame->linesize[2] * (y >> 1);
+			switch (videoPixelMode) {
+			case GE_CMODE_32BIT_ABGR8888:
+				ConvertYUV420ToRGBA8888((u32 *)dest, ySrc, uSrc, vSrc, width);
+				break;
+			case GE_CMODE_16BIT_BGR5650:
+				ConvertYUV420ToRGB565((u16 *)dest, ySrc, uSrc, vSrc, width);
+				break;
+			case GE_CMODE_16BIT_ABGR5551:
+				ConvertYUV420ToRGBA5551((u16 *)dest, ySrc, uSrc, vSrc, width);
+				break;
+			case GE_CMODE_16BIT_ABGR4444:
+				ConvertYUV420ToRGBA4444((u16 *)dest, ySrc, uSrc, vSrc, width);
+				break;
+			}
 		}
-		break;
+	} else {
+		updateFrameRGB();
 
-	default:
-		ERROR_LOG_REPORT(ME, "Unsupported video pixel format %d", videoPixelMode);
-		break;
+		switch (videoPixelMode) {
+		case GE_CMODE_32BIT_ABGR8888:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineRGBA(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u32);
+			}
+			break;
+
+		case GE_CMODE_16BIT_BGR5650:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR5650(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u16);
+			}
+			break;
+
+		case GE_CMODE_16BIT_ABGR5551:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR5551(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u16);
+			}
+			break;
+
+		case GE_CMODE_16BIT_ABGR4444:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR4444(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u16);
+			}
+			break;
+
+		default:
+			ERROR_LOG_REPORT(ME, "Unsupported video pixel format %d", videoPixelMode);
+			break;
+		}
 	}
 
 	if (swizzle) {
@@ -796,6 +872,8 @@ int MediaEngine::writeVideoImageWithRange(u32 bufferPtr, int frameWidth, int vid
 	if (!m_pFrame || !m_pFrameRGB)
 		return 0;
 
+	updateFrameRGB();
+
 	// lock the image size
 	u8 *imgbuf = buffer;
 	const u8 *data = m_pFrameRGB->data[0];
@@ -889,6 +967,7 @@ int MediaEngine::writeVideoImageWithRange(u32 bufferPtr, int frameWidth, int vid
 
 u8 *MediaEngine::getFrameImage() {
 #ifdef USE_FFMPEG
+	updateFrameRGB();
 	return m_pFrameRGB->data[0];
 #else
 	return NULL;
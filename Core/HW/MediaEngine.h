@@ -97,6 +97,8 @@ class MediaEngine
 	bool SetupStreams();
 	bool setVideoDim(int width = 0, int height = 0);
 	void updateSwsFormat(int videoPixelMode);
+	// Runs swscale on the last decoded frame, if it hasn't been yet.
+	void updateFrameRGB();
 	int getNextAudioFrame(u8 **buf, int *headerCode1, int *headerCode2);
 
 public:  // TODO: Very little of this below should be public.
@@ -105,7 +107,10 @@ class MediaEngine
 #ifdef USE_FFMPEG
 	AVFormatContext *m_pFormatCtx;
 	std::map<int, AVCodecContext *> m_pCodecCtxs;
+	// The last frame stepVideo() got, kept until another one is finished.
 	AVFrame *m_pFrame;
+	// What the decoder writes into.  It's emptied whenever no frame comes out.
+	AVFrame *m_pDecodeFrame;
 	AVFrame *m_pFrameRGB;
 	AVIOContext *m_pIOContext;
 	SwsContext *m_sws_ctx;
@@ -113,6 +118,9 @@ class MediaEngine
 
 	int m_sws_fmt;
 	u8 *m_buffer;
+	// m_pFrameRGB is behind m_pFrame, and should be converted to this format.
+	int m_frameRGBPixelMode;
+	bool m_frameRGBDirty;
 	int m_videoStream;
 
 	// Used by the demuxer.
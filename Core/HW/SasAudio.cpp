@@ -17,6 +17,8 @@
 
 #include <algorithm>
 
+#include "ppsspp_config.h"
+#include "Common/Common.h"
 #include "Common/Profiler/Profiler.h"
 
 #include "Common/Serialize/SerializeFuncs.h"
@@ -27,6 +29,20 @@
 #include "Core/Util/AudioFormat.h"
 #include "SasAudio.h"
 
+#ifdef _M_SSE
+#include <emmintrin.h>
+#endif
+#if _M_SSE >= 0x401
+#include <smmintrin.h>
+#endif
+#if PPSSPP_ARCH(ARM_NEON)
+#if defined(_MSC_VER) && PPSSPP_ARCH(ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 // #define AUDIO_TO_FILE
 
 static const u8 f[16][2] = {
@@ -127,7 +143,8 @@ void VagDecoder::GetSamples(s16 *outSamples, int numSamples) {
 	u8 *readp = Memory::GetPointerUnchecked(read_);
 	u8 *origp = readp;
 
-	for (int i = 0; i < numSamples; i++) {
+	int i = 0;
+	while (i < numSamples) {
 		if (curSample == 28) {
 			if (loopAtNextBlock_) {
 				VERBOSE_LOG(SASMIX, "Looping VAG from block %d/%d to %d", curBlock_, numBlocks_, loopStartBlock_);
@@ -145,7 +162,11 @@ void VagDecoder::GetSamples(s16 *outSamples, int numSamples) {
 				return;
 			}
 		}
-		outSamples[i] = samples[curSample++];
+		// Copy out as much of the decoded block as we need at once.
+		int count = std::min(28 - curSample, numSamples - i);
+		memcpy(&outSamples[i], &samples[curSample], count * sizeof(s16));
+		curSample += count;
+		i += count;
 	}
 
 	if (readp > origp) {
@@ -476,6 +497,143 @@ bool SasVoice::HaveSamplesEnded() const {
 	}
 }
 
+#ifdef _M_SSE
+// Low 32 bits of each product, which is all we need.
+static inline __m128i MulLo32(__m128i a, __m128i b) {
+#if _M_SSE >= 0x401
+	return _mm_mullo_epi32(a, b);
+#else
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+#endif
+
+// Scales resampled samples by the envelope, and accumulates them into the stereo mix and send buffers.
+static void MixSamples(int *mix, int *send, const int *samples, const int *envelope, int count, int volumeLeft, int volumeRight, int effectLeft, int effectRight) {
+	int i = 0;
+#ifdef _M_SSE
+	const __m128i round = _mm_set1_epi32(1 << 14);
+	const __m128i volL = _mm_set1_epi32(volumeLeft);
+	const __m128i volR = _mm_set1_epi32(volumeRight);
+	const __m128i effL = _mm_set1_epi32(effectLeft);
+	const __m128i effR = _mm_set1_epi32(effectRight);
+	for (; i + 4 <= count; i += 4) {
+		__m128i sample = MulLo32(_mm_loadu_si128((const __m128i *)(samples + i)), _mm_loadu_si128((const __m128i *)(envelope + i)));
+		sample = _mm_srai_epi32(_mm_add_epi32(sample, round), 15);
+
+		__m128i left = _mm_srai_epi32(MulLo32(sample, volL), 12);
+		__m128i right = _mm_srai_epi32(MulLo32(sample, volR), 12);
+		__m128i *mix128 = (__m128i *)(mix + i * 2);
+		_mm_storeu_si128(mix128, _mm_add_epi32(_mm_loadu_si128(mix128), _mm_unpacklo_epi32(left, right)));
+		_mm_storeu_si128(mix128 + 1, _mm_add_epi32(_mm_loadu_si128(mix128 + 1), _mm_unpackhi_epi32(left, right)));
+
+		left = _mm_srai_epi32(MulLo32(sample, effL), 12);
+		right = _mm_srai_epi32(MulLo32(sample, effR), 12);
+		__m128i *send128 = (__m128i *)(send + i * 2);
+		_mm_storeu_si128(send128, _mm_add_epi32(_mm_loadu_si128(send128), _mm_unpacklo_epi32(left, right)));
+		_mm_storeu_si128(send128 + 1, _mm_add_epi32(_mm_loadu_si128(send128 + 1), _mm_unpackhi_epi32(left, right)));
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const int32x4_t round = vdupq_n_s32(1 << 14);
+	for (; i + 4 <= count; i += 4) {
+		int32x4_t sample = vmulq_s32(vld1q_s32(samples + i), vld1q_s32(envelope + i));
+		sample = vshrq_n_s32(vaddq_s32(sample, round), 15);
+
+		int32x4x2_t m = vld2q_s32(mix + i * 2);
+		m.val[0] = vaddq_s32(m.val[0], vshrq_n_s32(vmulq_n_s32(sample, volumeLeft), 12));
+		m.val[1] = vaddq_s32(m.val[1], vshrq_n_s32(vmulq_n_s32(sample, volumeRight), 12));
+		vst2q_s32(mix + i * 2, m);
+
+		int32x4x2_t e = vld2q_s32(send + i * 2);
+		e.val[0] = vaddq_s32(e.val[0], vshrq_n_s32(vmulq_n_s32(sample, effectLeft), 12));
+		e.val[1] = vaddq_s32(e.val[1], vshrq_n_s32(vmulq_n_s32(sample, effectRight), 12));
+		vst2q_s32(send + i * 2, e);
+	}
+#endif
+	for (; i < count; i++) {
+		// We just scale by the envelope before we scale by volumes.
+		// Again, we round up by adding (1 << 14) first (*after* multiplying.)
+		int sample = ((samples[i] * envelope[i]) + (1 << 14)) >> 15;
+
+		// We mix into this 32-bit temp buffer and clip in a second loop
+		// Ideally, the shift right should be there too but for now I'm concerned about
+		// not overflowing.
+		mix[i * 2] += (sample * volumeLeft) >> 12;
+		mix[i * 2 + 1] += (sample * volumeRight) >> 12;
+		send[i * 2] += sample * effectLeft >> 12;
+		send[i * 2 + 1] += sample * effectRight >> 12;
+	}
+}
+
+// Linear interpolation at a fixed pitch, starting at sampleFrac.  Returns where it ended up.
+// Note that the weights add up to PSP_SAS_PITCH_MASK, not PSP_SAS_PITCH_BASE.
+static u32 InterpolateSamples(int *out, const s16 *in, u32 sampleFrac, int pitch, int count) {
+	int i = 0;
+#ifdef _M_SSE
+	const __m128i fracMask = _mm_set1_epi32(PSP_SAS_PITCH_MASK);
+	for (; i + 4 <= count; i += 4) {
+		const u32 f0 = sampleFrac, f1 = f0 + pitch, f2 = f1 + pitch, f3 = f2 + pitch;
+		// Each output needs a sample and the next one.  Load them as one pair, and weight them with
+		// (PSP_SAS_PITCH_MASK - f, f) so that madd does the whole interpolation.
+		s32 pairs[4];
+		memcpy(&pairs[0], in + (f0 >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+		memcpy(&pairs[1], in + (f1 >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+		memcpy(&pairs[2], in + (f2 >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+		memcpy(&pairs[3], in + (f3 >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+		__m128i frac = _mm_and_si128(_mm_setr_epi32(f0, f1, f2, f3), fracMask);
+		__m128i weights = _mm_or_si128(_mm_sub_epi32(fracMask, frac), _mm_slli_epi32(frac, 16));
+		__m128i result = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)pairs), weights);
+		_mm_storeu_si128((__m128i *)(out + i), _mm_srai_epi32(result, PSP_SAS_PITCH_BASE_SHIFT));
+		sampleFrac = f3 + pitch;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const int32x4_t fracMask = vdupq_n_s32(PSP_SAS_PITCH_MASK);
+	for (; i + 4 <= count; i += 4) {
+		const u32 f0 = sampleFrac, f1 = f0 + pitch, f2 = f1 + pitch, f3 = f2 + pitch;
+		const s16 *s0 = in + (f0 >> PSP_SAS_PITCH_BASE_SHIFT);
+		const s16 *s1 = in + (f1 >> PSP_SAS_PITCH_BASE_SHIFT);
+		const s16 *s2 = in + (f2 >> PSP_SAS_PITCH_BASE_SHIFT);
+		const s16 *s3 = in + (f3 >> PSP_SAS_PITCH_BASE_SHIFT);
+		const s16 first[4] = { s0[0], s1[0], s2[0], s3[0] };
+		const s16 second[4] = { s0[1], s1[1], s2[1], s3[1] };
+		const u32 fracs[4] = { f0, f1, f2, f3 };
+		int32x4_t frac = vandq_s32(vreinterpretq_s32_u32(vld1q_u32(fracs)), fracMask);
+		int32x4_t result = vmulq_s32(vmovl_s16(vld1_s16(first)), vsubq_s32(fracMask, frac));
+		result = vmlaq_s32(result, vmovl_s16(vld1_s16(second)), frac);
+		vst1q_s32(out + i, vshrq_n_s32(result, PSP_SAS_PITCH_BASE_SHIFT));
+		sampleFrac = f3 + pitch;
+	}
+#endif
+	for (; i < count; i++) {
+		const s16 *s = in + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+		int f = sampleFrac & PSP_SAS_PITCH_MASK;
+		out[i] = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
+		sampleFrac += pitch;
+	}
+	return sampleFrac;
+}
+
+// Same as clamp_s16 on each value.
+static void ClampToS16(s16 *out, const int *in, int count) {
+	int i = 0;
+#ifdef _M_SSE
+	for (; i + 8 <= count; i += 8) {
+		__m128i lo = _mm_loadu_si128((const __m128i *)(in + i));
+		__m128i hi = _mm_loadu_si128((const __m128i *)(in + i + 4));
+		_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(lo, hi));
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	for (; i + 8 <= count; i += 8) {
+		int16x8_t packed = vcombine_s16(vqmovn_s32(vld1q_s32(in + i)), vqmovn_s32(vld1q_s32(in + i + 4)));
+		vst1q_s16(out + i, packed);
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = clamp_s16(in[i]);
+}
+
 void SasInstance::MixVoice(SasVoice &voice) {
 	switch (voice.type) {
 	case VOICETYPE_VAG:
@@ -499,7 +657,7 @@ void SasInstance::MixVoice(SasVoice &voice) {
 
 		// Resample to the correct pitch, writing exactly "grainSize" samples. We need a buffer that can
 		// fit 4x that, as the max pitch is 0x4000.
-		// TODO: Special case no-resample case (and 2x and 0.5x) for speed, it's not uncommon
+		// TODO: Special case 2x and 0.5x for speed, they're not uncommon
 
 		// Two passes: First read, then resample.
 		mixTemp_[0] = voice.resampleHist[0];
@@ -527,36 +685,22 @@ void SasInstance::MixVoice(SasVoice &voice) {
 		}
 
 		const bool needsInterp = voicePitch != PSP_SAS_PITCH_BASE || (sampleFrac & PSP_SAS_PITCH_MASK) != 0;
-		for (int i = delay; i < grainSize; i++) {
-			const int16_t *s = mixTemp_ + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+		const int count = std::max(0, grainSize - delay);
 
+		// Resample the whole grain first, then apply the envelope and volumes in bulk below.
+		if (needsInterp) {
 			// Linear interpolation. Good enough. Need to make resampleHist bigger if we want more.
-			int sample = s[0];
-			if (needsInterp) {
-				int f = sampleFrac & PSP_SAS_PITCH_MASK;
-				sample = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
-			}
-			sampleFrac += voicePitch;
-
-			// The maximum envelope height (PSP_SAS_ENVELOPE_HEIGHT_MAX) is (1 << 30) - 1.
-			// Reduce it to 14 bits, by shifting off 15.  Round up by adding (1 << 14) first.
-			int envelopeValue = voice.envelope.GetHeight();
-			voice.envelope.Step();
-			envelopeValue = (envelopeValue + (1 << 14)) >> 15;
-
-			// We just scale by the envelope before we scale by volumes.
-			// Again, we round up by adding (1 << 14) first (*after* multiplying.)
-			sample = ((sample * envelopeValue) + (1 << 14)) >> 15;
-
-			// We mix into this 32-bit temp buffer and clip in a second loop
-			// Ideally, the shift right should be there too but for now I'm concerned about
-			// not overflowing.
-			mixBuffer[i * 2] += (sample * voice.volumeLeft) >> 12;
-			mixBuffer[i * 2 + 1] += (sample * voice.volumeRight) >> 12;
-			sendBuffer[i * 2] += sample * voice.effectLeft >> 12;
-			sendBuffer[i * 2 + 1] += sample * voice.effectRight >> 12;
+			sampleFrac = InterpolateSamples(resampled_, mixTemp_, sampleFrac, voicePitch, count);
+		} else {
+			const int16_t *s = mixTemp_ + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+			for (int i = 0; i < count; i++)
+				resampled_[i] = s[i];
+			sampleFrac += voicePitch * count;
 		}
 
+		voice.envelope.StepBlock(envelope_, count);
+		MixSamples(mixBuffer + delay * 2, sendBuffer + delay * 2, resampled_, envelope_, count, voice.volumeLeft, voice.volumeRight, voice.effectLeft, voice.effectRight);
+
 		voice.resampleHist[0] = mixTemp_[tempPos - 2];
 		voice.resampleHist[1] = mixTemp_[tempPos - 1];
 
@@ -642,10 +786,7 @@ void SasInstance::WriteMixedOutput(s16 *outp, const s16 *inp, int leftVol, int r
 				*outp++ = clamp_s16(mixBuffer[i + 1] + sendBufferProcessed[i + 1]);
 			}
 		} else if (dry) {
-			for (int i = 0; i < grainSize * 2; i += 2) {
-				*outp++ = clamp_s16(mixBuffer[i + 0]);
-				*outp++ = clamp_s16(mixBuffer[i + 1]);
-			}
+			ClampToS16(outp, mixBuffer, grainSize * 2);
 		} else {
 			// This is another uncommon case, dry must be off but let's keep it for clarity.
 			for (int i = 0; i < grainSize * 2; i += 2) {
@@ -929,6 +1070,83 @@ inline void ADSREnvelope::Step() {
 	}
 }
 
+// How many linear steps of delta we can take from the current height before Step() would change state.
+// Only valid for the attack, decay, sustain and release states.
+int ADSREnvelope::LinearStepsBeforeTransition(s64 delta) const {
+	const s64 h = height_;
+	const s64 never = PSP_SAS_MAX_GRAIN;
+	switch (state_) {
+	case STATE_ATTACK:
+		// Ends when h >= max or h < 0.
+		if (h < 0 || h >= PSP_SAS_ENVELOPE_HEIGHT_MAX)
+			return 0;
+		if (delta > 0)
+			return (int)std::min(never, (PSP_SAS_ENVELOPE_HEIGHT_MAX - 1 - h) / delta);
+		if (delta < 0)
+			return (int)std::min(never, h / -delta);
+		return (int)never;
+	case STATE_DECAY:
+		// Ends when h < sustainLevel.
+		if (delta >= 0)
+			return h + delta >= sustainLevel ? (int)never : 0;
+		if (h < sustainLevel)
+			return 0;
+		return (int)std::min(never, (h - sustainLevel) / -delta);
+	case STATE_SUSTAIN:
+	case STATE_RELEASE:
+		// Ends when h <= 0.
+		if (delta >= 0)
+			return h + delta > 0 ? (int)never : 0;
+		if (h <= 0)
+			return 0;
+		return (int)std::min(never, (h - 1) / -delta);
+	default:
+		return 0;
+	}
+}
+
+void ADSREnvelope::StepBlock(int *heights, int count) {
+	int i = 0;
+	while (i < count) {
+		int type = -1;
+		int rate = 0;
+		switch (state_) {
+		case STATE_ATTACK: type = attackType; rate = attackRate; break;
+		case STATE_DECAY: type = decayType; rate = decayRate; break;
+		case STATE_SUSTAIN: type = sustainType; rate = sustainRate; break;
+		case STATE_RELEASE: type = releaseType; rate = releaseRate; break;
+		case STATE_OFF:
+		{
+			// Nothing changes from here on.
+			const int value = (GetHeight() + (1 << 14)) >> 15;
+			for (; i < count; i++)
+				heights[i] = value;
+			return;
+		}
+		default: break;
+		}
+
+		// Linear curves are the common case, and until the state changes they're just a ramp.
+		if (type == PSP_SAS_ADSR_CURVE_MODE_LINEAR_INCREASE || type == PSP_SAS_ADSR_CURVE_MODE_LINEAR_DECREASE) {
+			const s64 delta = type == PSP_SAS_ADSR_CURVE_MODE_LINEAR_INCREASE ? rate : -(s64)rate;
+			const int steps = std::min(count - i, LinearStepsBeforeTransition(delta));
+			s64 h = height_;
+			for (int j = 0; j < steps; j++) {
+				heights[i + j] = (int)((std::min(h, (s64)PSP_SAS_ENVELOPE_HEIGHT_MAX) + (1 << 14)) >> 15);
+				h += delta;
+			}
+			height_ = h;
+			i += steps;
+			if (i >= count)
+				break;
+		}
+
+		// The step that changes state, or any other curve, takes the long way.
+		heights[i++] = (GetHeight() + (1 << 14)) >> 15;
+		Step();
+	}
+}
+
 void ADSREnvelope::KeyOn() {
 	SetState(STATE_KEYON);
 }
@@ -159,6 +159,8 @@ class ADSREnvelope {
 	void End();
 
 	inline void Step();
+	// Writes the height for each of count samples, reduced to 15 bits, stepping after each one.
+	void StepBlock(int *heights, int count);
 
 	int GetHeight() const {
 		return height_ > (s64)PSP_SAS_ENVELOPE_HEIGHT_MAX ? PSP_SAS_ENVELOPE_HEIGHT_MAX : height_;
@@ -196,6 +198,7 @@ class ADSREnvelope {
 		STATE_RELEASE = 3,
 	};
 	void SetState(ADSRState state);
+	int LinearStepsBeforeTransition(s64 delta) const;
 
 	ADSRState state_;
 	s64 height_;  // s64 to avoid having to care about overflow when calculating. TODO: this should be fine as s32
@@ -312,4 +315,7 @@ class SasInstance {
 	SasReverb reverb_;
 	int grainSize;
 	int16_t mixTemp_[PSP_SAS_MAX_GRAIN * 4 + 2 + 8];  // some extra margin for very high pitches.
+	// One voice's grain at a time, after resampling, and its envelope.
+	int resampled_[PSP_SAS_MAX_GRAIN];
+	int envelope_[PSP_SAS_MAX_GRAIN];
 };
@@ -27,11 +27,26 @@
 
 #define TARGET_BUFSIZE_DEFAULT 1680 // 40 ms
 #define TARGET_BUFSIZE_EXTRA 3360 // 80 ms
+#define TARGET_BUFSIZE_MIN 1024 // 23 ms, the adaptive target doesn't go below this.
+
+// The target is raised quickly when we underrun while the game is running, and lowered
+// slowly again after a while without any.
+#define TARGET_RAISE_STEP 256
+#define TARGET_LOWER_STEP 64
+#define TARGET_STABLE_SECONDS 5
 
 #define MAX_FREQ_SHIFT  600.0f  // how far off can we be from 44100 Hz
 #define CONTROL_FACTOR  0.2f // in freq_shift per fifo size offset
 #define CONTROL_AVG     32.0f
 
+// The sinc filter phase is picked from the top bits of the 16-bit fraction.
+#define SINC_PHASE_BITS 8
+#define SINC_COEF_BITS  14
+#define SINC_MAX_TAPS   16
+// A copy of the start of the ring is kept after its end, so filter windows never wrap.
+#define RING_GUARD      (SINC_MAX_TAPS * 2)
+
+#include <cmath>
 #include <cstring>
 #include <atomic>
 
@@ -60,9 +75,14 @@
 
 StereoResampler::StereoResampler()
 		: m_maxBufsize(MAX_BUFSIZE_DEFAULT)
-	  , m_targetBufsize(TARGET_BUFSIZE_DEFAULT) {
+	  , m_minTargetBufsize(TARGET_BUFSIZE_MIN)
+	  , m_maxTargetBufsize(MAX_BUFSIZE_DEFAULT / 2)
+	  , m_targetBufsize(TARGET_BUFSIZE_DEFAULT)
+	  , m_indexW(0)
+	  , m_indexR(0)
+	  , pushCount_(0) {
 	// Need to have space for the worst case in case it changes.
-	m_buffer = new int16_t[MAX_BUFSIZE_EXTRA * 2]();
+	m_buffer = new int16_t[MAX_BUFSIZE_EXTRA * 2 + RING_GUARD]();
 
 	// Some Android devices are v-synced to non-60Hz framerates. We simply timestretch audio to fit.
 	// TODO: should only do this if auto frameskip is off?
@@ -84,20 +104,106 @@ StereoResampler::~StereoResampler() {
 }
 
 void StereoResampler::UpdateBufferSize() {
+	int minTarget;
 	if (g_Config.bExtraAudioBuffering) {
 		m_maxBufsize = MAX_BUFSIZE_EXTRA;
-		m_targetBufsize = TARGET_BUFSIZE_EXTRA;
+		minTarget = TARGET_BUFSIZE_EXTRA;
 	} else {
 		m_maxBufsize = MAX_BUFSIZE_DEFAULT;
-		m_targetBufsize = TARGET_BUFSIZE_DEFAULT;
+		minTarget = TARGET_BUFSIZE_MIN;
 
 		int systemBufsize = System_GetPropertyInt(SYSPROP_AUDIO_FRAMES_PER_BUFFER);
-		if (systemBufsize > 0 && m_targetBufsize < systemBufsize + TARGET_BUFSIZE_MARGIN) {
-			m_targetBufsize = std::min(4096, systemBufsize + TARGET_BUFSIZE_MARGIN);
-			if (m_targetBufsize * 2 > MAX_BUFSIZE_DEFAULT)
+		if (systemBufsize > 0 && minTarget < systemBufsize + TARGET_BUFSIZE_MARGIN) {
+			minTarget = std::min(4096, systemBufsize + TARGET_BUFSIZE_MARGIN);
+			if (minTarget * 2 > MAX_BUFSIZE_DEFAULT)
 				m_maxBufsize = MAX_BUFSIZE_EXTRA;
 		}
 	}
+	// Leave room for pushes to land above the target.
+	m_minTargetBufsize.store(minTarget, std::memory_order_relaxed);
+	m_maxTargetBufsize.store(std::max(minTarget, m_maxBufsize / 2), std::memory_order_relaxed);
+}
+
+// Blackman windowed sinc, one row of taps per phase. Each row sums to exactly 1 << SINC_COEF_BITS.
+void StereoResampler::UpdateSincTable(int taps) {
+	const int phases = 1 << SINC_PHASE_BITS;
+	const int half = taps / 2;
+	// The short filter rolls off slowly, so cut off a bit lower to keep aliasing down.
+	const double cutoff = taps >= SINC_MAX_TAPS ? 0.95 : 0.85;
+
+	sincTable_.resize(phases * taps);
+	std::vector<double> row(taps);
+	for (int phase = 0; phase < phases; phase++) {
+		// Tap i is the sample (i - (half - 1)) frames from the read position.
+		double frac = (double)phase / phases;
+		double sum = 0.0;
+		for (int i = 0; i < taps; i++) {
+			double x = (double)(i - (half - 1)) - frac;
+			double t = M_PI * x / half;
+			double window = 0.42 + 0.5 * cos(t) + 0.08 * cos(2.0 * t);
+			double sinc = x == 0.0 ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+			row[i] = sinc * window;
+			sum += row[i];
+		}
+
+		s16 *coefs = &sincTable_[phase * taps];
+		int total = 0;
+		int peak = 0;
+		for (int i = 0; i < taps; i++) {
+			coefs[i] = (s16)lrint(row[i] / sum * (1 << SINC_COEF_BITS));
+			total += coefs[i];
+			if (abs(coefs[i]) > abs(coefs[peak]))
+				peak = i;
+		}
+		// Put the rounding error on the biggest tap, so DC passes through unchanged.
+		coefs[peak] += (1 << SINC_COEF_BITS) - total;
+	}
+	sincTaps_ = taps;
+}
+
+// Applies one phase of the filter to a window of interleaved stereo samples.
+// taps must be a multiple of 8.
+static inline void FilterStereo(s16 *out, const s16 *window, const s16 *coefs, int taps) {
+	s32 left, right;
+#ifdef _M_SSE
+	__m128i acc = _mm_setzero_si128();
+	for (int i = 0; i < taps; i += 4) {
+		// L0 R0 L1 R1 L2 R2 L3 R3 -> L0 L1 R0 R1 L2 L3 R2 R3, to line up with c0 c1 c0 c1 c2 c3 c2 c3.
+		__m128i s = _mm_loadu_si128((const __m128i *)(window + i * 2));
+		s = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+		__m128i c = _mm_loadl_epi64((const __m128i *)(coefs + i));
+		c = _mm_unpacklo_epi32(c, c);
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(s, c));
+	}
+	acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+	left = _mm_cvtsi128_si32(acc);
+	right = _mm_cvtsi128_si32(_mm_srli_si128(acc, 4));
+#elif PPSSPP_ARCH(ARM_NEON)
+	int32x4_t accL = vdupq_n_s32(0);
+	int32x4_t accR = vdupq_n_s32(0);
+	for (int i = 0; i < taps; i += 8) {
+		int16x8x2_t s = vld2q_s16(window + i * 2);
+		int16x8_t c = vld1q_s16(coefs + i);
+		accL = vmlal_s16(accL, vget_low_s16(s.val[0]), vget_low_s16(c));
+		accL = vmlal_s16(accL, vget_high_s16(s.val[0]), vget_high_s16(c));
+		accR = vmlal_s16(accR, vget_low_s16(s.val[1]), vget_low_s16(c));
+		accR = vmlal_s16(accR, vget_high_s16(s.val[1]), vget_high_s16(c));
+	}
+	int32x2_t sumL = vadd_s32(vget_low_s32(accL), vget_high_s32(accL));
+	int32x2_t sumR = vadd_s32(vget_low_s32(accR), vget_high_s32(accR));
+	int32x2_t sum = vpadd_s32(sumL, sumR);
+	left = vget_lane_s32(sum, 0);
+	right = vget_lane_s32(sum, 1);
+#else
+	left = 0;
+	right = 0;
+	for (int i = 0; i < taps; i++) {
+		left += window[i * 2] * coefs[i];
+		right += window[i * 2 + 1] * coefs[i];
+	}
+#endif
+	out[0] = clamp_s16((left + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS);
+	out[1] = clamp_s16((right + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS);
 }
 
 template<bool useShift>
@@ -158,7 +264,44 @@ inline void ClampBufferToS16WithVolume(s16 *out, const s32 *in, size_t size) {
 }
 
 void StereoResampler::Clear() {
-	memset(m_buffer, 0, m_maxBufsize * 2 * sizeof(int16_t));
+	memset(m_buffer, 0, (m_maxBufsize * 2 + RING_GUARD) * sizeof(int16_t));
+}
+
+// Underruns while the game is still pushing audio mean the buffer is too small for the current
+// load, so the target grows. It's shrunk again, a little at a time, while playback is smooth.
+void StereoResampler::AdaptTargetBufsize(bool underrun, unsigned int numSamples, int sampleRate) {
+	u32 pushCount = pushCount_.load(std::memory_order_relaxed);
+	if (pushCount != lastPushCount_) {
+		lastPushCount_ = pushCount;
+		idleMixes_ = 0;
+	} else {
+		idleMixes_++;
+	}
+
+	int target = m_targetBufsize.load(std::memory_order_relaxed);
+	int newTarget = target;
+	if (underrun) {
+		// If nothing has been pushed for a few mixes, the game is paused or loading, not slow.
+		if (idleMixes_ < 4)
+			newTarget += TARGET_RAISE_STEP;
+		stableSamples_ = 0;
+	} else {
+		stableSamples_ += numSamples;
+		if (stableSamples_ >= (int64_t)sampleRate * TARGET_STABLE_SECONDS) {
+			newTarget -= TARGET_LOWER_STEP;
+			stableSamples_ = 0;
+		}
+	}
+
+	// These may change under us from PushSamples, it's fine if one mix sees the old range.
+	const int minTarget = m_minTargetBufsize.load(std::memory_order_relaxed);
+	const int maxTarget = m_maxTargetBufsize.load(std::memory_order_relaxed);
+	newTarget = clamp_value(newTarget, minTarget, std::max(minTarget, maxTarget));
+	if (newTarget > target)
+		targetRaisedCount_++;
+	else if (newTarget < target)
+		targetLoweredCount_++;
+	m_targetBufsize.store(newTarget, std::memory_order_relaxed);
 }
 
 // Executed from sound stream thread, pulling sound out of the buffer.
@@ -175,8 +318,8 @@ unsigned int StereoResampler::Mix(short* samples, unsigned int numSamples, bool
 	// so we will just ignore new written data while interpolating (until it wraps...).
 	// Without this cache, the compiler wouldn't be allowed to optimize the
 	// interpolation loop.
-	u32 indexR = m_indexR.load();
-	u32 indexW = m_indexW.load();
+	u32 indexR = m_indexR.load(std::memory_order_relaxed);
+	u32 indexW = m_indexW.load(std::memory_order_acquire);
 
 	const int INDEX_MASK = (m_maxBufsize * 2 - 1);
 
@@ -199,39 +342,68 @@ unsigned int StereoResampler::Mix(short* samples, unsigned int numSamples, bool
 	// Note that the speed of adjustment here does not take the buffer size into
 	// account. Since this is called once per "output frame", the frame size
 	// will affect how fast this algorithm reacts, which can't be a good thing.
-	float offset = (m_numLeftI - (float)m_targetBufsize) * CONTROL_FACTOR;
+	float offset = (m_numLeftI - (float)m_targetBufsize.load(std::memory_order_relaxed)) * CONTROL_FACTOR;
 	if (offset > MAX_FREQ_SHIFT) offset = MAX_FREQ_SHIFT;
 	if (offset < -MAX_FREQ_SHIFT) offset = -MAX_FREQ_SHIFT;
 
 	output_sample_rate_ = (float)(m_input_sample_rate + offset);
 	const u32 ratio = (u32)(65536.0 * output_sample_rate_ / (double)sample_rate);
 	ratio_ = ratio;
-	// TODO: consider a higher-quality resampling algorithm.
+
+	int taps = 0;
+	if (g_Config.iAudioResampler == AUDIO_RESAMPLER_SINC)
+		taps = 8;
+	else if (g_Config.iAudioResampler == AUDIO_RESAMPLER_SINC_HQ)
+		taps = SINC_MAX_TAPS;
+	if (taps != 0 && taps != sincTaps_)
+		UpdateSincTable(taps);
+
 	// TODO: Add a fast path for 1:1.
 	u32 frac = m_frac;
-	for (currentSample = 0; currentSample < numSamples * 2; currentSample += 2) {
-		if (((indexW - indexR) & INDEX_MASK) <= 2) {
-			// Ran out!
-			// int missing = numSamples * 2 - currentSample;
-			// ILOG("Resampler underrun: %d (numSamples: %d, currentSample: %d)", missing, numSamples, currentSample / 2);
-			underrunCount_++;
-			break;
+	if (taps == 0) {
+		for (currentSample = 0; currentSample < numSamples * 2; currentSample += 2) {
+			if (((indexW - indexR) & INDEX_MASK) <= 2) {
+				// Ran out!
+				// int missing = numSamples * 2 - currentSample;
+				// ILOG("Resampler underrun: %d (numSamples: %d, currentSample: %d)", missing, numSamples, currentSample / 2);
+				underrunCount_++;
+				break;
+			}
+			u32 indexR2 = indexR + 2; //next sample
+			s16 l1 = m_buffer[indexR & INDEX_MASK]; //current
+			s16 r1 = m_buffer[(indexR + 1) & INDEX_MASK]; //current
+			s16 l2 = m_buffer[indexR2 & INDEX_MASK]; //next
+			s16 r2 = m_buffer[(indexR2 + 1) & INDEX_MASK]; //next
+			int sampleL = ((l1 << 16) + (l2 - l1) * (u16)frac) >> 16;
+			int sampleR = ((r1 << 16) + (r2 - r1) * (u16)frac) >> 16;
+			samples[currentSample] = sampleL;
+			samples[currentSample + 1] = sampleR;
+			frac += ratio;
+			indexR += 2 * (frac >> 16);
+			frac &= 0xffff;
+		}
+	} else {
+		// The window reaches (taps / 2 - 1) frames back and taps / 2 frames ahead of the read position.
+		const u32 history = taps - 2;
+		const u32 lookahead = taps;
+		for (currentSample = 0; currentSample < numSamples * 2; currentSample += 2) {
+			if (((indexW - indexR) & INDEX_MASK) <= lookahead) {
+				underrunCount_++;
+				break;
+			}
+			// Thanks to the guard after the ring, the window can be read straight through the wrap.
+			const s16 *window = &m_buffer[(indexR - history) & INDEX_MASK];
+			const s16 *coefs = &sincTable_[(frac >> (16 - SINC_PHASE_BITS)) * taps];
+			FilterStereo(&samples[currentSample], window, coefs, taps);
+			frac += ratio;
+			indexR += 2 * (frac >> 16);
+			frac &= 0xffff;
 		}
-		u32 indexR2 = indexR + 2; //next sample
-		s16 l1 = m_buffer[indexR & INDEX_MASK]; //current
-		s16 r1 = m_buffer[(indexR + 1) & INDEX_MASK]; //current
-		s16 l2 = m_buffer[indexR2 & INDEX_MASK]; //next
-		s16 r2 = m_buffer[(indexR2 + 1) & INDEX_MASK]; //next
-		int sampleL = ((l1 << 16) + (l2 - l1) * (u16)frac) >> 16;
-		int sampleR = ((r1 << 16) + (r2 - r1) * (u16)frac) >> 16;
-		samples[currentSample] = sampleL;
-		samples[currentSample + 1] = sampleR;
-		frac += ratio;
-		indexR += 2 * (frac >> 16);
-		frac &= 0xffff;
 	}
 	m_frac = frac;
 
+	AdaptTargetBufsize(currentSample < numSamples * 2, numSamples, sample_rate);
+
 	// Let's not count the underrun padding here.
 	outputSampleCount_ += currentSample / 2;
 
@@ -245,7 +417,7 @@ unsigned int StereoResampler::Mix(short* samples, unsigned int numSamples, bool
 	}
 
 	// Flush cached variable
-	m_indexR.store(indexR);
+	m_indexR.store(indexR, std::memory_order_release);
 
 	// TODO: What should we actually return here?
 	return currentSample / 2;
@@ -260,17 +432,18 @@ void StereoResampler::PushSamples(const s32 *samples, unsigned int numSamples) {
 	// Cache access in non-volatile variable
 	// indexR isn't allowed to cache in the audio throttling loop as it
 	// needs to get updates to not deadlock.
-	u32 indexW = m_indexW.load();
+	u32 indexW = m_indexW.load(std::memory_order_relaxed);
 
-	u32 cap = m_maxBufsize * 2;
+	// The sinc filters still read a few samples behind m_indexR, so those can't be overwritten yet.
+	u32 cap = m_maxBufsize * 2 - SINC_MAX_TAPS;
 	// If unthrottling, no need to fill up the entire buffer, just screws up timing after releasing unthrottle.
 	if (PSP_CoreParameter().unthrottle) {
-		cap = m_targetBufsize * 2;
+		cap = m_targetBufsize.load(std::memory_order_relaxed) * 2;
 	}
 
 	// Check if we have enough free space
 	// indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-	if (numSamples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= cap) {
+	if (numSamples * 2 + ((indexW - m_indexR.load(std::memory_order_acquire)) & INDEX_MASK) >= cap) {
 		if (!PSP_CoreParameter().unthrottle) {
 			overrunCount_++;
 		}
@@ -286,7 +459,18 @@ void StereoResampler::PushSamples(const s32 *samples, unsigned int numSamples) {
 		ClampBufferToS16WithVolume(&m_buffer[indexW & INDEX_MASK], samples, numSamples * 2);
 	}
 
-	m_indexW += numSamples * 2;
+	// Mirror whatever we wrote to the start of the ring into the guard after its end.
+	const u32 ringSize = m_maxBufsize * 2;
+	const u32 start = indexW & INDEX_MASK;
+	const u32 end = start + numSamples * 2;
+	if (end > ringSize) {
+		memcpy(&m_buffer[ringSize], &m_buffer[0], std::min(end - ringSize, (u32)RING_GUARD) * sizeof(int16_t));
+	} else if (start < RING_GUARD) {
+		memcpy(&m_buffer[ringSize + start], &m_buffer[start], (std::min(end, (u32)RING_GUARD) - start) * sizeof(int16_t));
+	}
+
+	m_indexW.store(indexW + numSamples * 2, std::memory_order_release);
+	pushCount_++;
 	lastPushSize_ = numSamples;
 }
 
@@ -295,8 +479,12 @@ void StereoResampler::GetAudioDebugStats(char *buf, size_t bufSize) {
 
 	double effective_input_sample_rate = (double)inputSampleCount_ / elapsed;
 	double effective_output_sample_rate = (double)outputSampleCount_ / elapsed;
+	static const char *const resamplerNames[] = { "linear", "sinc", "sinc HQ" };
+	int resampler = clamp_value(g_Config.iAudioResampler, (int)AUDIO_RESAMPLER_LINEAR, (int)AUDIO_RESAMPLER_SINC_HQ);
 	snprintf(buf, bufSize,
 		"Audio buffer: %d/%d (target: %d)\n"
+		"Adaptive target: %d-%d (raised %d, lowered %d)\n"
+		"Resampler: %s\n"
 		"Filtered: %0.2f\n"
 		"Underruns: %d\n"
 		"Overruns: %d\n"
@@ -307,7 +495,12 @@ void StereoResampler::GetAudioDebugStats(char *buf, size_t bufSize) {
 		"Ratio: %0.6f\n",
 		lastBufSize_,
 		m_maxBufsize,
-		m_targetBufsize,
+		m_targetBufsize.load(std::memory_order_relaxed),
+		m_minTargetBufsize.load(std::memory_order_relaxed),
+		m_maxTargetBufsize.load(std::memory_order_relaxed),
+		targetRaisedCount_,
+		targetLoweredCount_,
+		resamplerNames[resampler],
 		m_numLeftI,
 		underrunCountTotal_,
 		overrunCountTotal_,
@@ -333,6 +526,8 @@ void StereoResampler::ResetStatCounters() {
 	overrunCount_ = 0;
 	underrunCountTotal_ = 0;
 	overrunCountTotal_ = 0;
+	targetRaisedCount_ = 0;
+	targetLoweredCount_ = 0;
 	inputSampleCount_ = 0;
 	outputSampleCount_ = 0;
 	startTime_ = time_now_d();
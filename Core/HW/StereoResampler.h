@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include <atomic>
+#include <vector>
 
 #include "Common/Serialize/Serializer.h"
 #include "Common/CommonTypes.h"
@@ -32,7 +33,8 @@ class StereoResampler {
 	StereoResampler();
 	~StereoResampler();
 
-	// Called from audio threads
+	// Called from audio threads. The ring buffer is single producer, single consumer:
+	// only Mix advances m_indexR and only PushSamples advances m_indexW.
 	unsigned int Mix(short* samples, unsigned int numSamples, bool consider_framelimit, int sampleRate);
 
 	// Called from main thread
@@ -48,9 +50,15 @@ class StereoResampler {
 
 private:
 	void UpdateBufferSize();
+	void UpdateSincTable(int taps);
+	void AdaptTargetBufsize(bool underrun, unsigned int numSamples, int sampleRate);
 
 	int m_maxBufsize;
-	int m_targetBufsize;
+	// The adaptive target lives between these, and is only changed by Mix.
+	// The range itself is updated by PushSamples, on the emu thread.
+	std::atomic<int> m_minTargetBufsize;
+	std::atomic<int> m_maxTargetBufsize;
+	std::atomic<int> m_targetBufsize;
 
 	unsigned int m_input_sample_rate = 44100;
 	int16_t *m_buffer;
@@ -58,6 +66,18 @@ class StereoResampler {
 	std::atomic<u32> m_indexR;
 	float m_numLeftI = 0.0f;
 
+	// Polyphase windowed sinc filter, one row of taps per phase.
+	std::vector<s16> sincTable_;
+	int sincTaps_ = 0;
+
+	// Lets Mix tell a stalled emulator (paused, loading) from one that can't keep up.
+	std::atomic<u32> pushCount_;
+	u32 lastPushCount_ = 0;
+	int idleMixes_ = 0;
+	int64_t stableSamples_ = 0;
+	int targetRaisedCount_ = 0;
+	int targetLoweredCount_ = 0;
+
 	u32 m_frac = 0;
 	float output_sample_rate_ = 0.0;
 	int lastBufSize_ = 0;
@@ -83,6 +83,8 @@ IdentifiedFileType Identify_File(FileLoader *fileLoader) {
 		return IdentifiedFileType::PSP_ISO;
 	} else if (!strcasecmp(extension.c_str(), ".cso")) {
 		return IdentifiedFileType::PSP_ISO;
+	} else if (!strcasecmp(extension.c_str(), ".chd")) {
+		return IdentifiedFileType::PSP_ISO;
 	} else if (!strcasecmp(extension.c_str(), ".ppst")) {
 		return IdentifiedFileType::PPSSPP_SAVESTATE;
 	} else if (!strcasecmp(extension.c_str(), ".ppdmp")) {
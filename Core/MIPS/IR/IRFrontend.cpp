@@ -221,7 +221,7 @@ MIPSOpcode IRFrontend::GetOffsetInstruction(int offset) {
 	return Memory::Read_Instruction(GetCompilerPC() + 4 * offset);
 }
 
-void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload) {
+void IRFrontend::CompileRawBlock(u32 em_address, u32 &mipsBytes, bool preload) {
 	js.cancel = false;
 	js.preloading = preload;
 	js.blockStart = em_address;
@@ -255,24 +255,32 @@ void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &m
 	}
 
 	mipsBytes = js.compilerPC - em_address;
+}
+
+void IRFrontend::OptimizeBlock(const IRWriter &in, IRWriter &out) {
+	static const IRPassFunc passes[] = {
+		&RemoveLoadStoreLeftRight,
+		&OptimizeFPMoves,
+		&PropagateConstants,
+		&PurgeTemps,
+		// &ReorderLoadStore,
+		// &MergeLoadStore,
+		// &ThreeOpToTwoOp,
+	};
+	if (IRApplyPasses(passes, ARRAY_SIZE(passes), in, out, opts))
+		logBlocks = 1;
+	//if (in.GetInstructions().size() >= 24)
+	//	logBlocks = 1;
+}
+
+void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload) {
+	CompileRawBlock(em_address, mipsBytes, preload);
 
 	IRWriter simplified;
 	IRWriter *code = &ir;
 	if (!js.hadBreakpoints) {
-		static const IRPassFunc passes[] = {
-			&RemoveLoadStoreLeftRight,
-			&OptimizeFPMoves,
-			&PropagateConstants,
-			&PurgeTemps,
-			// &ReorderLoadStore,
-			// &MergeLoadStore,
-			// &ThreeOpToTwoOp,
-		};
-		if (IRApplyPasses(passes, ARRAY_SIZE(passes), ir, simplified, opts))
-			logBlocks = 1;
+		OptimizeBlock(ir, simplified);
 		code = &simplified;
-		//if (ir.GetInstructions().size() >= 24)
-		//	logBlocks = 1;
 	}
 
 	instructions = code->GetInstructions();
@@ -313,6 +321,83 @@ void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &m
 		dontLogBlocks--;
 }
 
+static IROp InvertExitCondition(IROp op) {
+	switch (op) {
+	case IROp::ExitToConstIfEq: return IROp::ExitToConstIfNeq;
+	case IROp::ExitToConstIfNeq: return IROp::ExitToConstIfEq;
+	case IROp::ExitToConstIfGtZ: return IROp::ExitToConstIfLeZ;
+	case IROp::ExitToConstIfLeZ: return IROp::ExitToConstIfGtZ;
+	case IROp::ExitToConstIfGeZ: return IROp::ExitToConstIfLtZ;
+	case IROp::ExitToConstIfLtZ: return IROp::ExitToConstIfGeZ;
+	case IROp::ExitToConstIfFpTrue: return IROp::ExitToConstIfFpFalse;
+	case IROp::ExitToConstIfFpFalse: return IROp::ExitToConstIfFpTrue;
+	default: return IROp::Nop;
+	}
+}
+
+// Rewrites the end of a block so that, instead of exiting to next, it falls through.
+static bool UnlinkTraceExit(std::vector<IRInst> &block, u32 next) {
+	size_t n = block.size();
+	if (n >= 1 && block[n - 1].op == IROp::ExitToConst && block[n - 1].constant == next) {
+		block.pop_back();
+		return true;
+	}
+
+	// A branch ends with the exit for one side, followed directly by the exit for the other.
+	if (n >= 2 && block[n - 1].op == IROp::ExitToConst && block[n - 2].constant == next) {
+		IROp inverted = InvertExitCondition(block[n - 2].op);
+		if (inverted != IROp::Nop) {
+			block[n - 2].op = inverted;
+			block[n - 2].constant = block[n - 1].constant;
+			block.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+int IRFrontend::DoJitTrace(const std::vector<u32> &addresses, std::vector<IRInst> &instructions, u32 &mipsBytes) {
+	// Keep well within the limits of IRBlock.
+	static const size_t MAX_TRACE_INSTRUCTIONS = 4096;
+
+	std::vector<std::vector<IRInst>> blocks;
+	std::vector<u32> blockBytes;
+	size_t total = 0;
+	for (u32 addr : addresses) {
+		u32 bytes;
+		CompileRawBlock(addr, bytes, false);
+		if (js.cancel || js.hadBreakpoints || ir.GetInstructions().empty())
+			break;
+		total += ir.GetInstructions().size();
+		if (total > MAX_TRACE_INSTRUCTIONS)
+			break;
+		blocks.push_back(ir.GetInstructions());
+		blockBytes.push_back(bytes);
+	}
+
+	IRWriter trace;
+	u32 end = 0;
+	int used = 0;
+	for (size_t i = 0; i < blocks.size(); ++i) {
+		end = std::max(end, addresses[i] + blockBytes[i]);
+		used++;
+
+		bool linked = i + 1 < blocks.size() && UnlinkTraceExit(blocks[i], addresses[i + 1]);
+		for (const IRInst &inst : blocks[i])
+			trace.Write(inst);
+		if (!linked)
+			break;
+	}
+	if (used < 2)
+		return used;
+
+	IRWriter simplified;
+	OptimizeBlock(trace, simplified);
+	instructions = simplified.GetInstructions();
+	mipsBytes = end - addresses[0];
+	return used;
+}
+
 void IRFrontend::Comp_RunBlock(MIPSOpcode op) {
 	// This shouldn't be necessary, the dispatcher should catch us before we get here.
 	ERROR_LOG(JIT, "Comp_RunBlock should never be reached!");
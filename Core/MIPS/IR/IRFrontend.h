@@ -89,6 +89,9 @@ class IRFrontend : public MIPSFrontendInterface {
 	bool CheckRounding(u32 blockAddress);  // returns true if we need a do-over
 
 	void DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload);
+	// Compiles the blocks starting at each address into one trace, following the exit from each block to the next.
+	// Returns how many of the blocks made it into the trace, which needs at least 2 to be useful.
+	int DoJitTrace(const std::vector<u32> &addresses, std::vector<IRInst> &instructions, u32 &mipsBytes);
 
 	void EatPrefix() override {
 		js.EatPrefix();
@@ -99,6 +102,9 @@ class IRFrontend : public MIPSFrontendInterface {
 	}
 
 private:
+	void CompileRawBlock(u32 em_address, u32 &mipsBytes, bool preload);
+	void OptimizeBlock(const IRWriter &in, IRWriter &out);
+
 	void RestoreRoundingMode(bool force = false);
 	void ApplyRoundingMode(bool force = false);
 	void UpdateRoundingMode();
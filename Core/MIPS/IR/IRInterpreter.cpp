@@ -1001,3 +1001,181 @@ u32 IRInterpret(MIPSState *mips, const IRInst *inst, int count) {
 	Crash();
 	return 0;
 }
+
+u32 IRInterpretSingle(MIPSState *mips, const IRInst *inst) {
+	// The exit is never taken unless the instruction itself exits early.
+	IRInst insts[2] = { *inst, { IROp::ExitToConst, { 0 }, 0, 0, 0 } };
+	return IRInterpret(mips, insts, 2);
+}
+
+// Threaded handlers for the most common ops.  Everything else goes through IRThreaded_Generic.
+#define IR_THREADED_OP(name, body) \
+	static const IRThreadedInst *IRThreaded_##name(MIPSState *mips, const IRThreadedInst *t) { \
+		const IRInst *inst = &t->inst; \
+		body; \
+		return t + 1; \
+	}
+
+#define IR_THREADED_EXIT_IF(name, cond) \
+	static const IRThreadedInst *IRThreaded_##name(MIPSState *mips, const IRThreadedInst *t) { \
+		const IRInst *inst = &t->inst; \
+		if (cond) { \
+			mips->pc = inst->constant; \
+			return nullptr; \
+		} \
+		return t + 1; \
+	}
+
+IR_THREADED_OP(SetConst, mips->r[inst->dest] = inst->constant)
+IR_THREADED_OP(SetConstF, memcpy(&mips->f[inst->dest], &inst->constant, 4))
+IR_THREADED_OP(Mov, mips->r[inst->dest] = mips->r[inst->src1])
+IR_THREADED_OP(Add, mips->r[inst->dest] = mips->r[inst->src1] + mips->r[inst->src2])
+IR_THREADED_OP(Sub, mips->r[inst->dest] = mips->r[inst->src1] - mips->r[inst->src2])
+IR_THREADED_OP(And, mips->r[inst->dest] = mips->r[inst->src1] & mips->r[inst->src2])
+IR_THREADED_OP(Or, mips->r[inst->dest] = mips->r[inst->src1] | mips->r[inst->src2])
+IR_THREADED_OP(Xor, mips->r[inst->dest] = mips->r[inst->src1] ^ mips->r[inst->src2])
+IR_THREADED_OP(AddConst, mips->r[inst->dest] = mips->r[inst->src1] + inst->constant)
+IR_THREADED_OP(SubConst, mips->r[inst->dest] = mips->r[inst->src1] - inst->constant)
+IR_THREADED_OP(AndConst, mips->r[inst->dest] = mips->r[inst->src1] & inst->constant)
+IR_THREADED_OP(OrConst, mips->r[inst->dest] = mips->r[inst->src1] | inst->constant)
+IR_THREADED_OP(XorConst, mips->r[inst->dest] = mips->r[inst->src1] ^ inst->constant)
+IR_THREADED_OP(ShlImm, mips->r[inst->dest] = mips->r[inst->src1] << (int)inst->src2)
+IR_THREADED_OP(ShrImm, mips->r[inst->dest] = mips->r[inst->src1] >> (int)inst->src2)
+IR_THREADED_OP(SarImm, mips->r[inst->dest] = (s32)mips->r[inst->src1] >> (int)inst->src2)
+IR_THREADED_OP(Shl, mips->r[inst->dest] = mips->r[inst->src1] << (mips->r[inst->src2] & 31))
+IR_THREADED_OP(Shr, mips->r[inst->dest] = mips->r[inst->src1] >> (mips->r[inst->src2] & 31))
+IR_THREADED_OP(Sar, mips->r[inst->dest] = (s32)mips->r[inst->src1] >> (mips->r[inst->src2] & 31))
+IR_THREADED_OP(Slt, mips->r[inst->dest] = (s32)mips->r[inst->src1] < (s32)mips->r[inst->src2])
+IR_THREADED_OP(SltU, mips->r[inst->dest] = mips->r[inst->src1] < mips->r[inst->src2])
+IR_THREADED_OP(SltConst, mips->r[inst->dest] = (s32)mips->r[inst->src1] < (s32)inst->constant)
+IR_THREADED_OP(SltUConst, mips->r[inst->dest] = mips->r[inst->src1] < inst->constant)
+IR_THREADED_OP(MovZ, if (mips->r[inst->src1] == 0) mips->r[inst->dest] = mips->r[inst->src2])
+IR_THREADED_OP(MovNZ, if (mips->r[inst->src1] != 0) mips->r[inst->dest] = mips->r[inst->src2])
+IR_THREADED_OP(Load8, mips->r[inst->dest] = Memory::ReadUnchecked_U8(mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(Load8Ext, mips->r[inst->dest] = (s32)(s8)Memory::ReadUnchecked_U8(mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(Load16, mips->r[inst->dest] = Memory::ReadUnchecked_U16(mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(Load16Ext, mips->r[inst->dest] = (s32)(s16)Memory::ReadUnchecked_U16(mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(Load32, mips->r[inst->dest] = Memory::ReadUnchecked_U32(mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(LoadFloat, mips->f[inst->dest] = Memory::ReadUnchecked_Float(mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(Store8, Memory::WriteUnchecked_U8(mips->r[inst->src3], mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(Store16, Memory::WriteUnchecked_U16(mips->r[inst->src3], mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(Store32, Memory::WriteUnchecked_U32(mips->r[inst->src3], mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(StoreFloat, Memory::WriteUnchecked_Float(mips->f[inst->src3], mips->r[inst->src1] + inst->constant))
+IR_THREADED_OP(FAdd, mips->f[inst->dest] = mips->f[inst->src1] + mips->f[inst->src2])
+IR_THREADED_OP(FSub, mips->f[inst->dest] = mips->f[inst->src1] - mips->f[inst->src2])
+IR_THREADED_OP(FMov, mips->f[inst->dest] = mips->f[inst->src1])
+IR_THREADED_OP(FMovFromGPR, memcpy(&mips->f[inst->dest], &mips->r[inst->src1], 4))
+IR_THREADED_OP(FMovToGPR, memcpy(&mips->r[inst->dest], &mips->f[inst->src1], 4))
+IR_THREADED_OP(Downcount, mips->downcount -= inst->constant)
+IR_THREADED_OP(SetPC, mips->pc = mips->r[inst->src1])
+IR_THREADED_OP(SetPCConst, mips->pc = inst->constant)
+
+IR_THREADED_EXIT_IF(ExitToConst, true)
+IR_THREADED_EXIT_IF(ExitToConstIfEq, mips->r[inst->src1] == mips->r[inst->src2])
+IR_THREADED_EXIT_IF(ExitToConstIfNeq, mips->r[inst->src1] != mips->r[inst->src2])
+IR_THREADED_EXIT_IF(ExitToConstIfGtZ, (s32)mips->r[inst->src1] > 0)
+IR_THREADED_EXIT_IF(ExitToConstIfGeZ, (s32)mips->r[inst->src1] >= 0)
+IR_THREADED_EXIT_IF(ExitToConstIfLtZ, (s32)mips->r[inst->src1] < 0)
+IR_THREADED_EXIT_IF(ExitToConstIfLeZ, (s32)mips->r[inst->src1] <= 0)
+
+static const IRThreadedInst *IRThreaded_ExitToReg(MIPSState *mips, const IRThreadedInst *t) {
+	mips->pc = mips->r[t->inst.src1];
+	return nullptr;
+}
+
+static const IRThreadedInst *IRThreaded_ExitToPC(MIPSState *mips, const IRThreadedInst *t) {
+	return nullptr;
+}
+
+static const IRThreadedInst *IRThreaded_Generic(MIPSState *mips, const IRThreadedInst *t) {
+	u32 exitPC = IRInterpretSingle(mips, &t->inst);
+	if (exitPC != 0) {
+		mips->pc = exitPC;
+		return nullptr;
+	}
+	return t + 1;
+}
+
+static IRThreadedFunc GetThreadedFunc(IROp op) {
+	switch (op) {
+#define IR_THREADED_CASE(name) case IROp::name: return &IRThreaded_##name
+	IR_THREADED_CASE(SetConst);
+	IR_THREADED_CASE(SetConstF);
+	IR_THREADED_CASE(Mov);
+	IR_THREADED_CASE(Add);
+	IR_THREADED_CASE(Sub);
+	IR_THREADED_CASE(And);
+	IR_THREADED_CASE(Or);
+	IR_THREADED_CASE(Xor);
+	IR_THREADED_CASE(AddConst);
+	IR_THREADED_CASE(SubConst);
+	IR_THREADED_CASE(AndConst);
+	IR_THREADED_CASE(OrConst);
+	IR_THREADED_CASE(XorConst);
+	IR_THREADED_CASE(ShlImm);
+	IR_THREADED_CASE(ShrImm);
+	IR_THREADED_CASE(SarImm);
+	IR_THREADED_CASE(Shl);
+	IR_THREADED_CASE(Shr);
+	IR_THREADED_CASE(Sar);
+	IR_THREADED_CASE(Slt);
+	IR_THREADED_CASE(SltU);
+	IR_THREADED_CASE(SltConst);
+	IR_THREADED_CASE(SltUConst);
+	IR_THREADED_CASE(MovZ);
+	IR_THREADED_CASE(MovNZ);
+	IR_THREADED_CASE(Load8);
+	IR_THREADED_CASE(Load8Ext);
+	IR_THREADED_CASE(Load16);
+	IR_THREADED_CASE(Load16Ext);
+	IR_THREADED_CASE(Load32);
+	IR_THREADED_CASE(LoadFloat);
+	IR_THREADED_CASE(Store8);
+	IR_THREADED_CASE(Store16);
+	IR_THREADED_CASE(Store32);
+	IR_THREADED_CASE(StoreFloat);
+	IR_THREADED_CASE(FAdd);
+	IR_THREADED_CASE(FSub);
+	IR_THREADED_CASE(FMov);
+	IR_THREADED_CASE(FMovFromGPR);
+	IR_THREADED_CASE(FMovToGPR);
+	IR_THREADED_CASE(Downcount);
+	IR_THREADED_CASE(SetPC);
+	IR_THREADED_CASE(SetPCConst);
+	IR_THREADED_CASE(ExitToConst);
+	IR_THREADED_CASE(ExitToConstIfEq);
+	IR_THREADED_CASE(ExitToConstIfNeq);
+	IR_THREADED_CASE(ExitToConstIfGtZ);
+	IR_THREADED_CASE(ExitToConstIfGeZ);
+	IR_THREADED_CASE(ExitToConstIfLtZ);
+	IR_THREADED_CASE(ExitToConstIfLeZ);
+	IR_THREADED_CASE(ExitToReg);
+	IR_THREADED_CASE(ExitToPC);
+#undef IR_THREADED_CASE
+	default:
+		return &IRThreaded_Generic;
+	}
+}
+
+void IRThreadedDecode(const IRInst *inst, int count, IRThreadedInst *out) {
+	for (int i = 0; i < count; ++i) {
+		out[i].func = GetThreadedFunc(inst[i].op);
+		out[i].inst = inst[i];
+		out[i].link = -1;
+	}
+}
+
+bool IRThreadedIsStaticExit(IROp op) {
+	switch (op) {
+	case IROp::ExitToConst:
+	case IROp::ExitToConstIfEq:
+	case IROp::ExitToConstIfNeq:
+	case IROp::ExitToConstIfGtZ:
+	case IROp::ExitToConstIfGeZ:
+	case IROp::ExitToConstIfLtZ:
+	case IROp::ExitToConstIfLeZ:
+		return true;
+	default:
+		return false;
+	}
+}
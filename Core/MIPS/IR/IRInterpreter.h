@@ -1,9 +1,7 @@
 #pragma once
 
 #include "Common/CommonTypes.h"
-
-class MIPSState;
-struct IRInst;
+#include "Core/MIPS/IR/IRInst.h"
 
 inline static u32 ReverseBits32(u32 v) {
 	// http://graphics.stanford.edu/~seander/bithacks.html#ReverseParallel
@@ -21,3 +19,20 @@ inline static u32 ReverseBits32(u32 v) {
 }
 
 u32 IRInterpret(MIPSState *mips, const IRInst *inst, int count);
+// Runs a single non-exit instruction. Returns the new PC if it left the block anyway (e.g. breakpoints), otherwise 0.
+u32 IRInterpretSingle(MIPSState *mips, const IRInst *inst);
+
+// Pre-decoded ("call-threaded") form of an IR block, to avoid the big switch for the common ops.
+struct IRThreadedInst;
+// Returns the next instruction to run, or nullptr if the block exited (with the new PC in mips->pc.)
+typedef const IRThreadedInst *(*IRThreadedFunc)(MIPSState *mips, const IRThreadedInst *inst);
+
+struct IRThreadedInst {
+	IRThreadedFunc func;
+	IRInst inst;
+	// For static exits, the block number last jumped to, so blocks can chain without the dispatcher.
+	mutable int link;
+};
+
+void IRThreadedDecode(const IRInst *inst, int count, IRThreadedInst *out);
+bool IRThreadedIsStaticExit(IROp op);
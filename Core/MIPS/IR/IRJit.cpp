@@ -15,17 +15,22 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <set>
 
 #include "ext/xxhash.h"
 #include "Common/Profiler/Profiler.h"
 
+#include "Common/File/FileUtil.h"
 #include "Common/Log.h"
 #include "Common/Serialize/Serializer.h"
 #include "Common/StringUtils.h"
 
+#include "Core/Config.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/ELF/ParamSFO.h"
+#include "Core/HLE/ReplaceTables.h"
 #include "Core/HLE/sceKernelMemory.h"
 #include "Core/MemMap.h"
 #include "Core/MIPS/MIPS.h"
@@ -38,6 +43,7 @@
 #include "Core/MIPS/IR/IRInterpreter.h"
 #include "Core/MIPS/JitCommon/JitCommon.h"
 #include "Core/Reporting.h"
+#include "Core/System.h"
 
 namespace MIPSComp {
 
@@ -50,9 +56,18 @@ IRJit::IRJit(MIPSState *mips) : frontend_(mips->HasDefaultPrefix()), mips_(mips)
 	opts.disableFlags = g_Config.uJitDisableFlags;
 	opts.unalignedLoadStore = opts.disableFlags & (uint32_t)JitDisable::LSU_UNALIGNED;
 	frontend_.SetOptions(opts);
+
+#if PPSSPP_ARCH(AMD64)
+	if (!jo.Disabled(JitDisable::IR_NATIVE))
+		native_.reset(new IRToX86());
+#endif
+	useThreaded_ = !native_ && !jo.Disabled(JitDisable::IR_THREADED);
+	useTraces_ = !jo.Disabled(JitDisable::IR_TRACES);
 }
 
 IRJit::~IRJit() {
+	// Memory is still around at this point, so we can check which blocks are still accurate.
+	SaveDiskCache();
 }
 
 void IRJit::DoState(PointerWrap &p) {
@@ -65,6 +80,9 @@ void IRJit::UpdateFCR31() {
 void IRJit::ClearCache() {
 	INFO_LOG(JIT, "IRJit: Clearing the cache!");
 	blocks_.Clear();
+	pendingTrace_ = -1;
+	if (native_)
+		native_->ClearCache();
 }
 
 void IRJit::InvalidateCacheAt(u32 em_address, int length) {
@@ -74,7 +92,13 @@ void IRJit::InvalidateCacheAt(u32 em_address, int length) {
 void IRJit::Compile(u32 em_address) {
 	PROFILE_THIS_SCOPE("jitc");
 
-	if (g_Config.bPreloadFunctions) {
+	if (!diskCacheChecked_) {
+		// Wait until the first compile, so the game's code is loaded and we know its ID.
+		diskCacheChecked_ = true;
+		LoadDiskCache();
+	}
+
+	if (g_Config.bPreloadFunctions || hasDiskCacheBlocks_) {
 		// Look to see if we've preloaded this block.
 		int block_num = blocks_.FindPreloadBlock(em_address);
 		if (block_num != -1) {
@@ -121,6 +145,9 @@ bool IRJit::CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32
 	IRBlock *b = blocks_.GetBlock(block_num);
 	b->SetInstructions(instructions);
 	b->SetOriginalSize(mipsBytes);
+	CompileNativeBlock(b);
+	if (useThreaded_)
+		b->DecodeThreaded();
 	if (preload) {
 		// Hash, then only update page stats, don't link yet.
 		b->UpdateHash();
@@ -128,12 +155,199 @@ bool IRJit::CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32
 	} else {
 		// Overwrites the first instruction, and also updates stats.
 		// TODO: Should we always hash?  Then we can reuse blocks.
+		if (!diskCachePath_.empty())
+			b->UpdateHash();
 		blocks_.FinalizeBlock(block_num);
 	}
 
 	return true;
 }
 
+void IRJit::CompileNativeBlock(IRBlock *block) {
+	if (!native_)
+		return;
+
+	// Note that this must use the block's own copy, since the native code refers to it.
+	const u8 *entry = native_->ConvertIRToNative(block->GetInstructions(), block->GetNumInstructions());
+	if (!entry) {
+		// Out of code space.  The IR blocks are still fine, so just start over on native code.
+		INFO_LOG(JIT, "IRJit: Native code space full, clearing native code");
+		blocks_.ClearNativeEntries();
+		native_->ClearCache();
+		entry = native_->ConvertIRToNative(block->GetInstructions(), block->GetNumInstructions());
+	}
+	block->SetNativeEntry(entry);
+}
+
+// Bump when the file format changes.  Builds are told apart by IRDiskCacheBuildHash().
+#define IR_DISK_CACHE_MAGIC 0x52494350
+#define IR_DISK_CACHE_VERSION 2
+
+struct IRDiskCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t jitDisableFlags;
+	uint32_t funcReplacements;
+	uint32_t numBlocks;
+	uint32_t reserved;
+	uint64_t buildHash;
+};
+
+// Op numbering and CallReplacement indices change between builds, and the frontend can change
+// without either, so cached IR is only good for the build that wrote it.
+static uint64_t IRDiskCacheBuildHash() {
+	XXH3_state_t *state = XXH3_createState();
+	XXH3_64bits_reset(state);
+	XXH3_64bits_update(state, PPSSPP_GIT_VERSION, strlen(PPSSPP_GIT_VERSION));
+	for (int op = 0; op < 256; ++op) {
+		const IRMeta *meta = GetIRMeta((IROp)op);
+		if (!meta)
+			continue;
+		XXH3_64bits_update(state, &op, sizeof(op));
+		XXH3_64bits_update(state, meta->name, strlen(meta->name));
+		XXH3_64bits_update(state, meta->types, sizeof(meta->types));
+		XXH3_64bits_update(state, &meta->flags, sizeof(meta->flags));
+	}
+	for (int i = 0; i < GetNumReplacementFuncs(); ++i) {
+		const ReplacementTableEntry *entry = GetReplacementFunc(i);
+		XXH3_64bits_update(state, entry->name, strlen(entry->name));
+	}
+	uint64_t hash = XXH3_64bits_digest(state);
+	XXH3_freeState(state);
+	return hash;
+}
+
+struct IRDiskCacheBlockHeader {
+	uint32_t origAddr;
+	uint32_t origSize;
+	uint64_t hash;
+	uint32_t numInstructions;
+	uint32_t reserved;
+};
+
+void IRJit::LoadDiskCache() {
+	if (!g_Config.bIRDiskCache)
+		return;
+	std::string discID = g_paramSFO.GetDiscID();
+	if (discID.empty())
+		return;
+
+	File::CreateFullPath(GetSysDirectory(DIRECTORY_APP_CACHE));
+	diskCachePath_ = GetSysDirectory(DIRECTORY_APP_CACHE) + "/" + discID + ".ircache";
+
+	FILE *f = File::OpenCFile(diskCachePath_, "rb");
+	if (!f)
+		return;
+
+	IRDiskCacheHeader header;
+	bool success = fread(&header, sizeof(header), 1, f) == 1;
+	if (!success || header.magic != IR_DISK_CACHE_MAGIC || header.version != IR_DISK_CACHE_VERSION || header.buildHash != IRDiskCacheBuildHash()) {
+		INFO_LOG(JIT, "IR cache '%s' is damaged or from another build, ignoring", diskCachePath_.c_str());
+		fclose(f);
+		return;
+	}
+	// Different options generate different IR, so just start over.
+	if (header.jitDisableFlags != g_Config.uJitDisableFlags || header.funcReplacements != (uint32_t)g_Config.bFuncReplacements) {
+		fclose(f);
+		return;
+	}
+
+	int loaded = 0;
+	int stale = 0;
+	std::vector<IRInst> instructions;
+	for (uint32_t i = 0; i < header.numBlocks; ++i) {
+		IRDiskCacheBlockHeader blockHeader;
+		if (fread(&blockHeader, sizeof(blockHeader), 1, f) != 1)
+			break;
+		if (blockHeader.numInstructions == 0 || blockHeader.numInstructions > 0xFFFF) {
+			ERROR_LOG(JIT, "Corrupt IR cache file, aborting.");
+			break;
+		}
+		instructions.resize(blockHeader.numInstructions);
+		if (fread(&instructions[0], sizeof(IRInst), instructions.size(), f) != instructions.size())
+			break;
+
+		bool valid = Memory::IsValidRange(blockHeader.origAddr, blockHeader.origSize);
+		for (const IRInst &inst : instructions) {
+			if (!valid)
+				break;
+			valid = GetIRMeta(inst.op) != nullptr;
+		}
+		if (!valid) {
+			ERROR_LOG(JIT, "Corrupt IR cache file, aborting.");
+			break;
+		}
+
+		// Skip if something else already compiled here.
+		if (MIPS_IS_RUNBLOCK(Memory::ReadUnchecked_U32(blockHeader.origAddr)))
+			continue;
+
+		int block_num = blocks_.AllocateBlock(blockHeader.origAddr);
+		if ((block_num & ~MIPS_EMUHACK_VALUE_MASK) != 0)
+			break;
+		IRBlock *b = blocks_.GetBlock(block_num);
+		b->SetInstructions(instructions);
+		b->SetOriginalSize(blockHeader.origSize);
+		b->SetHash(blockHeader.hash);
+		if (!b->HashMatches()) {
+			// The code changed since (or isn't loaded yet.)  Leave it for a real compile.
+			b->Destroy(block_num);
+			stale++;
+			continue;
+		}
+
+		CompileNativeBlock(b);
+		if (useThreaded_)
+			b->DecodeThreaded();
+		// These are found and linked through FindPreloadBlock(), like preloaded functions.
+		blocks_.FinalizeBlock(block_num, true);
+		loaded++;
+	}
+	fclose(f);
+
+	hasDiskCacheBlocks_ = loaded != 0;
+	INFO_LOG(JIT, "Loaded %d blocks from IR cache '%s' (%d stale)", loaded, diskCachePath_.c_str(), stale);
+}
+
+void IRJit::SaveDiskCache() {
+	if (diskCachePath_.empty())
+		return;
+
+	std::vector<int> valid;
+	for (int i = 0; i < blocks_.GetNumBlocks(); ++i) {
+		const IRBlock *b = blocks_.GetBlock(i);
+		if (b->GetNumInstructions() != 0 && b->GetHash() != 0 && b->HashMatches())
+			valid.push_back(i);
+	}
+	if (valid.empty())
+		return;
+
+	FILE *f = File::OpenCFile(diskCachePath_, "wb");
+	if (!f)
+		return;
+	INFO_LOG(JIT, "Saving %d blocks to IR cache '%s'", (int)valid.size(), diskCachePath_.c_str());
+
+	IRDiskCacheHeader header{};
+	header.magic = IR_DISK_CACHE_MAGIC;
+	header.version = IR_DISK_CACHE_VERSION;
+	header.jitDisableFlags = g_Config.uJitDisableFlags;
+	header.funcReplacements = g_Config.bFuncReplacements;
+	header.numBlocks = (uint32_t)valid.size();
+	header.buildHash = IRDiskCacheBuildHash();
+	fwrite(&header, sizeof(header), 1, f);
+
+	for (int i : valid) {
+		const IRBlock *b = blocks_.GetBlock(i);
+		IRDiskCacheBlockHeader blockHeader{};
+		b->GetRange(blockHeader.origAddr, blockHeader.origSize);
+		blockHeader.hash = b->GetHash();
+		blockHeader.numInstructions = b->GetNumInstructions();
+		fwrite(&blockHeader, sizeof(blockHeader), 1, f);
+		fwrite(b->GetInstructions(), sizeof(IRInst), b->GetNumInstructions(), f);
+	}
+	fclose(f);
+}
+
 void IRJit::CompileFunction(u32 start_address, u32 length) {
 	PROFILE_THIS_SCOPE("jitc");
 
@@ -226,7 +440,22 @@ void IRJit::RunLoopUntil(u64 globalticks) {
 			if (opcode == MIPS_EMUHACK_OPCODE) {
 				u32 data = inst & 0xFFFFFF;
 				IRBlock *block = blocks_.GetBlock(data);
-				mips_->pc = IRInterpret(mips_, block->GetInstructions(), block->GetNumInstructions());
+				const u8 *nativeEntry = block->GetNativeEntry();
+				if (block->GetThreadedInstructions() && !nativeEntry) {
+					// Profiles its own exits, since it may run several blocks.
+					RunThreadedBlock(data, block);
+				} else {
+					if (nativeEntry)
+						mips_->pc = native_->GetEnterFunc()(mips_, nativeEntry);
+					else
+						mips_->pc = IRInterpret(mips_, block->GetInstructions(), block->GetNumInstructions());
+					if (useTraces_ && block->RecordExit(mips_->pc))
+						pendingTrace_ = data;
+				}
+				if (pendingTrace_ != -1) {
+					FormTrace(pendingTrace_);
+					pendingTrace_ = -1;
+				}
 				if (!Memory::IsValidAddress(mips_->pc)) {
 					Core_ExecException(mips_->pc, mips_->pc, ExecExceptionType::JUMP);
 					break;
@@ -242,8 +471,130 @@ void IRJit::RunLoopUntil(u64 globalticks) {
 	// RestoreRoundingMode(true);
 }
 
+void IRJit::RunThreadedBlock(int blockNum, IRBlock *block) {
+	const IRThreadedInst *t = block->GetThreadedInstructions();
+	while (true) {
+		const IRThreadedInst *next = t->func(mips_, t);
+		if (next) {
+			t = next;
+			continue;
+		}
+
+		if (useTraces_ && block->RecordExit(mips_->pc)) {
+			// Let the dispatcher form the trace, it may reallocate blocks.
+			pendingTrace_ = blockNum;
+			return;
+		}
+
+		// t is the exit we took.  Only chain on static exits, others go back to the dispatcher.
+		if (mips_->downcount < 0 || !IRThreadedIsStaticExit(t->inst.op))
+			return;
+
+		u32 pc = mips_->pc;
+		IRBlock *target = t->link >= 0 ? blocks_.GetBlock(t->link) : nullptr;
+		u32 targetStart = 0, targetSize = 0;
+		if (target)
+			target->GetRange(targetStart, targetSize);
+		if (!target || !target->IsValid() || targetStart != pc) {
+			// Never linked, or the block was invalidated or cleared since.
+			t->link = -1;
+			if (!Memory::IsValidAddress(pc))
+				return;
+			u32 inst = Memory::ReadUnchecked_U32(pc);
+			if ((inst & 0xFF000000) != MIPS_EMUHACK_OPCODE)
+				return;
+			int targetNum = inst & 0xFFFFFF;
+			target = blocks_.GetBlock(targetNum);
+			if (!target)
+				return;
+			t->link = targetNum;
+		}
+
+		blockNum = t->link;
+		block = target;
+		t = target->GetThreadedInstructions();
+		if (!t)
+			return;
+	}
+}
+
+// Tuning for trace formation, the threshold must be a power of 2.  Besides going back to the head once, traces
+// only extend forward, so the range covers all their code for invalidation.
+static const u32 TRACE_HOT_THRESHOLD = 512;
+static const size_t TRACE_MAX_BLOCKS = 8;
+static const u32 TRACE_MAX_BYTES = 0x1000;
+
+void IRJit::FormTrace(int blockNum) {
+	IRBlock *head = blocks_.GetBlock(blockNum);
+	if (!head || !head->IsValid() || head->GetTraceLength() > 1)
+		return;
+
+	u32 start, size;
+	head->GetRange(start, size);
+	std::vector<u32> addresses;
+	addresses.push_back(start);
+
+	const IRBlock *cur = head;
+	bool looped = false;
+	while (addresses.size() < TRACE_MAX_BLOCKS) {
+		u32 next = cur->GetHotExit();
+		if (next == start && !looped) {
+			// A loop back to the head, so the trace runs through it twice per entry.
+			looped = true;
+			addresses.push_back(start);
+			cur = head;
+			continue;
+		}
+		if (next <= start || std::find(addresses.begin(), addresses.end(), next) != addresses.end())
+			break;
+		if (!Memory::IsValidAddress(next))
+			break;
+		// Only follow blocks that have actually been run, so we have their profile.
+		u32 inst = Memory::ReadUnchecked_U32(next);
+		if (!MIPS_IS_RUNBLOCK(inst))
+			break;
+		const IRBlock *nextBlock = blocks_.GetBlock(inst & MIPS_EMUHACK_VALUE_MASK);
+		if (!nextBlock || !nextBlock->IsValid())
+			break;
+
+		u32 nextStart, nextSize;
+		nextBlock->GetRange(nextStart, nextSize);
+		if (nextStart + nextSize - start > TRACE_MAX_BYTES)
+			break;
+
+		addresses.push_back(next);
+		cur = nextBlock;
+	}
+
+	if (addresses.size() < 2 || blocks_.GetNumBlocks() >= MIPS_EMUHACK_VALUE_MASK)
+		return;
+
+	std::vector<IRInst> instructions;
+	u32 mipsBytes;
+	int length = frontend_.DoJitTrace(addresses, instructions, mipsBytes);
+	if (length < 2)
+		return;
+
+	// The trace takes over the head's address.  The other blocks stay around for other paths into them.
+	head->Destroy(blockNum);
+
+	int traceNum = blocks_.AllocateBlock(start);
+	IRBlock *b = blocks_.GetBlock(traceNum);
+	b->SetInstructions(instructions);
+	b->SetOriginalSize(mipsBytes);
+	b->SetTraceLength(length);
+	CompileNativeBlock(b);
+	if (useThreaded_)
+		b->DecodeThreaded();
+	if (!diskCachePath_.empty())
+		b->UpdateHash();
+	blocks_.FinalizeBlock(traceNum);
+}
+
 bool IRJit::DescribeCodePtr(const u8 *ptr, std::string &name) {
 	// Used in target disassembly viewer.
+	if (native_)
+		return native_->DescribeCodePtr(ptr, name);
 	return false;
 }
 
@@ -303,6 +654,12 @@ void IRBlockCache::FinalizeBlock(int i, bool preload) {
 	}
 }
 
+void IRBlockCache::ClearNativeEntries() {
+	for (IRBlock &b : blocks_) {
+		b.SetNativeEntry(nullptr);
+	}
+}
+
 u32 IRBlockCache::AddressToPage(u32 addr) const {
 	// Use relatively small pages since basic blocks are typically small.
 	return (addr & 0x3FFFFFFF) >> 10;
@@ -387,11 +744,20 @@ void IRBlockCache::ComputeStats(BlockCacheStats &bcStats) const {
 	double totalBloat = 0.0;
 	double maxBloat = 0.0;
 	double minBloat = 1000000000.0;
+	u64 totalRuns = 0;
+	u64 traceRuns = 0;
 	for (const auto &b : blocks_) {
 		double codeSize = (double)b.GetNumInstructions() * sizeof(IRInst);
 		if (codeSize == 0)
 			continue;
 
+		totalRuns += b.GetRunCount();
+		if (b.GetTraceLength() > 1) {
+			bcStats.numTraces++;
+			bcStats.numTracedBlocks += b.GetTraceLength();
+			traceRuns += b.GetRunCount();
+		}
+
 		u32 origAddr, mipsBytes;
 		b.GetRange(origAddr, mipsBytes);
 		double origSize = (double)mipsBytes;
@@ -411,6 +777,7 @@ void IRBlockCache::ComputeStats(BlockCacheStats &bcStats) const {
 	bcStats.minBloat = minBloat;
 	bcStats.maxBloat = maxBloat;
 	bcStats.avgBloat = totalBloat / (double)blocks_.size();
+	bcStats.traceCoverage = totalRuns == 0 ? 0.0f : (float)((double)traceRuns / (double)totalRuns);
 }
 
 int IRBlockCache::GetBlockNumberFromStartAddress(u32 em_address, bool realBlocksOnly) const {
@@ -458,6 +825,61 @@ void IRBlock::Finalize(int number) {
 	}
 }
 
+void IRBlock::FindStaticExits() {
+	finalExit_ = 0;
+	sideExit_ = 0;
+	if (numInstructions_ >= 1 && instr_[numInstructions_ - 1].op == IROp::ExitToConst)
+		finalExit_ = instr_[numInstructions_ - 1].constant;
+	if (finalExit_ != 0 && numInstructions_ >= 2) {
+		const IRInst &inst = instr_[numInstructions_ - 2];
+		switch (inst.op) {
+		case IROp::ExitToConstIfEq:
+		case IROp::ExitToConstIfNeq:
+		case IROp::ExitToConstIfGtZ:
+		case IROp::ExitToConstIfGeZ:
+		case IROp::ExitToConstIfLtZ:
+		case IROp::ExitToConstIfLeZ:
+		case IROp::ExitToConstIfFpTrue:
+		case IROp::ExitToConstIfFpFalse:
+			sideExit_ = inst.constant;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+bool IRBlock::RecordExit(u32 pc) {
+	runCount_++;
+	if (traceLength_ > 1)
+		return false;
+	int side;
+	if (pc == finalExit_ && finalExit_ != 0)
+		side = 0;
+	else if (pc == sideExit_ && sideExit_ != 0)
+		side = 1;
+	else
+		return false;
+	// Try again each time the count doubles, in case the rest of the path wasn't compiled yet.
+	u32 count = ++exitCounts_[side];
+	return count >= TRACE_HOT_THRESHOLD && (count & (count - 1)) == 0;
+}
+
+u32 IRBlock::GetHotExit() const {
+	// Only follow an exit taken at least 3/4 of the time.
+	if ((u64)exitCounts_[0] * 4 >= (u64)runCount_ * 3)
+		return finalExit_;
+	if ((u64)exitCounts_[1] * 4 >= (u64)runCount_ * 3)
+		return sideExit_;
+	return 0;
+}
+
+void IRBlock::DecodeThreaded() {
+	delete[] threaded_;
+	threaded_ = new IRThreadedInst[numInstructions_];
+	IRThreadedDecode(instr_, numInstructions_, threaded_);
+}
+
 void IRBlock::Destroy(int number) {
 	if (origAddr_) {
 		MIPSOpcode opcode = MIPSOpcode(MIPS_EMUHACK_OPCODE | number);
@@ -466,6 +888,7 @@ void IRBlock::Destroy(int number) {
 
 		// Let's mark this invalid so we don't try to clear it again.
 		origAddr_ = 0;
+		nativeEntry_ = nullptr;
 	}
 }
 
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <cstring>
+#include <memory>
 #include <unordered_map>
 
 #include "Common/Common.h"
@@ -27,6 +28,8 @@
 #include "Core/MIPS/IR/IRRegCache.h"
 #include "Core/MIPS/IR/IRInst.h"
 #include "Core/MIPS/IR/IRFrontend.h"
+#include "Core/MIPS/IR/IRInterpreter.h"
+#include "Core/MIPS/x86/IRToX86.h"
 #include "Core/MIPS/MIPSVFPUUtils.h"
 
 #ifndef offsetof
@@ -47,11 +50,21 @@ class IRBlock {
 		origSize_ = b.origSize_;
 		origFirstOpcode_ = b.origFirstOpcode_;
 		hash_ = b.hash_;
+		nativeEntry_ = b.nativeEntry_;
+		threaded_ = b.threaded_;
+		finalExit_ = b.finalExit_;
+		sideExit_ = b.sideExit_;
+		runCount_ = b.runCount_;
+		exitCounts_[0] = b.exitCounts_[0];
+		exitCounts_[1] = b.exitCounts_[1];
+		traceLength_ = b.traceLength_;
 		b.instr_ = nullptr;
+		b.threaded_ = nullptr;
 	}
 
 	~IRBlock() {
 		delete[] instr_;
+		delete[] threaded_;
 	}
 
 	void SetInstructions(const std::vector<IRInst> &inst) {
@@ -60,10 +73,15 @@ class IRBlock {
 		if (!inst.empty()) {
 			memcpy(instr_, &inst[0], sizeof(IRInst) * inst.size());
 		}
+		FindStaticExits();
 	}
 
 	const IRInst *GetInstructions() const { return instr_; }
 	int GetNumInstructions() const { return numInstructions_; }
+	const u8 *GetNativeEntry() const { return nativeEntry_; }
+	void SetNativeEntry(const u8 *entry) { nativeEntry_ = entry; }
+	const IRThreadedInst *GetThreadedInstructions() const { return threaded_; }
+	void DecodeThreaded();
 	MIPSOpcode GetOriginalFirstOp() const { return origFirstOpcode_; }
 	bool HasOriginalFirstOp() const;
 	bool RestoreOriginalFirstOp(int number);
@@ -74,6 +92,8 @@ class IRBlock {
 	void UpdateHash() {
 		hash_ = CalculateHash();
 	}
+	u64 GetHash() const { return hash_; }
+	void SetHash(u64 hash) { hash_ = hash; }
 	bool HashMatches() const {
 		return origAddr_ && hash_ == CalculateHash();
 	}
@@ -87,8 +107,17 @@ class IRBlock {
 	void Finalize(int number);
 	void Destroy(int number);
 
+	// Profiling for trace formation.  Returns true when one of the static exits just became hot.
+	bool RecordExit(u32 pc);
+	// The static exit taken most of the time, if any.
+	u32 GetHotExit() const;
+	u32 GetRunCount() const { return runCount_; }
+	int GetTraceLength() const { return traceLength_; }
+	void SetTraceLength(int length) { traceLength_ = (u8)length; }
+
 private:
 	u64 CalculateHash() const;
+	void FindStaticExits();
 
 	IRInst *instr_;
 	u16 numInstructions_;
@@ -96,6 +125,18 @@ class IRBlock {
 	u32 origSize_;
 	u64 hash_ = 0;
 	MIPSOpcode origFirstOpcode_ = MIPSOpcode(0x68FFFFFF);
+	// Compiled code for this block, if a native backend is in use.
+	const u8 *nativeEntry_ = nullptr;
+	// Pre-decoded copy of instr_, used by the threaded dispatcher.
+	IRThreadedInst *threaded_ = nullptr;
+
+	// The exit at the end of the block, and the conditional one right before it (the two sides of a branch.)
+	u32 finalExit_ = 0;
+	u32 sideExit_ = 0;
+	u32 runCount_ = 0;
+	u32 exitCounts_[2]{};
+	// Number of blocks compiled together into this one.
+	u8 traceLength_ = 1;
 };
 
 class IRBlockCache : public JitBlockCacheDebugInterface {
@@ -104,6 +145,7 @@ class IRBlockCache : public JitBlockCacheDebugInterface {
 	void Clear();
 	void InvalidateICache(u32 address, u32 length);
 	void FinalizeBlock(int i, bool preload = false);
+	void ClearNativeEntries();
 	int GetNumBlocks() const override { return (int)blocks_.size(); }
 	int AllocateBlock(int emAddr) {
 		blocks_.push_back(IRBlock(emAddr));
@@ -172,12 +214,29 @@ class IRJit : public JitInterface {
 
 private:
 	bool CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, bool preload);
+	void CompileNativeBlock(IRBlock *block);
+	void RunThreadedBlock(int blockNum, IRBlock *block);
+	void FormTrace(int blockNum);
+	void LoadDiskCache();
+	void SaveDiskCache();
 	bool ReplaceJalTo(u32 dest);
 
 	JitOptions jo;
 
 	IRFrontend frontend_;
 	IRBlockCache blocks_;
+	// Optional, when not available or disabled we interpret the IR.
+	std::unique_ptr<IRToNativeInterface> native_;
+	// Without native code, use pre-decoded handlers and chain blocks instead of the IRInterpret switch.
+	bool useThreaded_ = false;
+	// Count block exits, and recompile hot paths across several blocks as one trace.
+	bool useTraces_ = false;
+	int pendingTrace_ = -1;
+
+	// Optional cache of compiled IR on disk, per game.  Blocks are revalidated by hash on load.
+	std::string diskCachePath_;
+	bool diskCacheChecked_ = false;
+	bool hasDiskCacheBlocks_ = false;
 
 	MIPSState *mips_;
 
@@ -42,6 +42,10 @@ struct BlockCacheStats {
 	float maxBloat;
 	u32 maxBloatBlock;
 	std::map<float, u32> bloatMap;
+	// Only for backends that form traces out of several blocks.
+	int numTraces = 0;
+	int numTracedBlocks = 0;
+	float traceCoverage = 0.0f;
 };
 
 enum class DestroyType {
@@ -1,299 +1,656 @@
+// Copyright (c) 2012- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
 #include "ppsspp_config.h"
-#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+#if PPSSPP_ARCH(AMD64)
 
+#include <algorithm>
+#include <cstddef>
+
+#include "Common/ABI.h"
+#include "Common/CPUDetect.h"
+#include "Common/StringUtils.h"
+#include "Core/MemMap.h"
+#include "Core/MIPS/MIPS.h"
+#include "Core/MIPS/IR/IRInterpreter.h"
 #include "Core/MIPS/x86/IRToX86.h"
+#include "Core/MIPS/x86/RegCache.h"
+
+// Converts IR blocks (after the simplify passes) directly to x64.
+//
+// The common integer, load/store, and simple FPU ops are lowered natively, with a simple
+// per-block register allocator for the most used GPRs. Everything else calls into the IR
+// interpreter for that single instruction, so we never have to bail out of a whole block.
+//
+// Register usage:
+//   RBX - Base pointer of memory (MEMBASEREG)
+//   R14 - Pointer to fpr/gpr regs (CTXREG), same as the regular x86 jit so MIPSSTATE_VAR works.
+//   RAX, RCX, RDX - Scratch.
+//   RBP, R12, R13, R15 (and RSI, RDI on Win64) - Allocated to IR GPRs, per block.
 
 namespace MIPSComp {
 
-// Initial attempt at converting IR directly to x86.
-// This is intended to be an easy way to benefit from the IR with the current infrastructure.
-// Later tries may go across multiple blocks and a different representation.
+using namespace Gen;
+using namespace X64JitConstants;
 
-struct GPRMapping {
-	Gen::OpArg dest;
-	Gen::OpArg src1;
-	Gen::OpArg src2;
+static const X64Reg allocOrder[] = {
+	RBP, R12, R13, R15,
+#ifdef _WIN32
+	RSI, RDI,
+#endif
 };
 
-struct FPRMapping {
-	Gen::OpArg dest;
-	Gen::OpArg src1;
-	Gen::OpArg src2;
-};
+// Win64 needs shadow space for calls, SysV only needs alignment.
+#ifdef _WIN32
+static const int STACK_FRAME_SIZE = 40;
+#else
+static const int STACK_FRAME_SIZE = 8;
+#endif
 
+// Avoid needing a code space check for each instruction. This is well above the worst case.
+static const int MAX_BYTES_PER_INST = 192;
 
-class GreedyRegallocGPR {
-public:
-	GPRMapping Map(IRInst inst, const IRMeta &meta);
+static bool IsAllocatableGPR(int reg) {
+	// lo/hi, fpcond, etc. are accessed implicitly by some ops, so only allocate real regs and temps.
+	return (reg > MIPS_REG_ZERO && reg < 32) || (reg >= IRTEMP_0 && reg <= IRTEMP_LR_SHIFT);
+}
 
-private:
-	
-};
+static OpArg MIPSState_IRReg(int reg) {
+	// CTXREG points at f[0], and the IR GPR space starts at r[0].
+	return MDisp(CTXREG, (int)(offsetof(MIPSState, r[0]) - offsetof(MIPSState, f[0])) + reg * 4);
+}
 
+IRToX86::IRToX86() {
+	AllocCodeSpace(1024 * 1024 * 16);
+	GenerateFixedCode();
+}
+
+void IRToX86::GenerateFixedCode() {
+	BeginWrite();
+
+	enterBlock_ = (IRNativeEnterFunc)AlignCode16();
+	PUSH(RBX);
+	PUSH(RBP);
+	PUSH(R12);
+	PUSH(R13);
+	PUSH(R14);
+	PUSH(R15);
+#ifdef _WIN32
+	PUSH(RSI);
+	PUSH(RDI);
+#endif
+	SUB(64, R(RSP), Imm8(STACK_FRAME_SIZE));
+
+	MOV(64, R(CTXREG), R(ABI_PARAM1));
+	ADD(64, R(CTXREG), Imm32((u32)offsetof(MIPSState, f[0])));
+	MOV(64, R(MEMBASEREG), ImmPtr(Memory::base));
+	JMPptr(R(ABI_PARAM2));
+
+	// Blocks jump here with the new PC in EAX, and all dirty regs flushed.
+	exitBlock_ = AlignCode16();
+	ADD(64, R(RSP), Imm8(STACK_FRAME_SIZE));
+#ifdef _WIN32
+	POP(RDI);
+	POP(RSI);
+#endif
+	POP(R15);
+	POP(R14);
+	POP(R13);
+	POP(R12);
+	POP(RBP);
+	POP(RBX);
+	RET();
+
+	AlignCode16();
+	fixedCodeSize_ = GetCodePtr() - GetBasePtr();
+	EndWrite();
+}
+
+void IRToX86::ClearCache() {
+	ClearCodeSpace((int)fixedCodeSize_);
+}
 
-GPRMapping GreedyRegallocGPR::Map(IRInst inst, const IRMeta &meta) {
-	GPRMapping mapping;
-	if (meta.types[0] == 'G') {
+bool IRToX86::DescribeCodePtr(const u8 *ptr, std::string &name) const {
+	if (!IsInSpace(ptr))
+		return false;
+
+	if (ptr >= (const u8 *)enterBlock_ && ptr < exitBlock_)
+		name = "enterBlock";
+	else if (ptr >= exitBlock_ && ptr < region + fixedCodeSize_)
+		name = "exitBlock";
+	else
+		name = StringFromFormat("IR native block (%p)", ptr);
+	return true;
+}
+
+void IRToX86::AllocateRegs(const IRInst *instructions, int count) {
+	int uses[256]{};
+	for (int i = 0; i < count; i++) {
+		const IRInst &inst = instructions[i];
+		const IRMeta *meta = GetIRMeta(inst.op);
+		const u8 regs[3] = { inst.dest, inst.src1, inst.src2 };
+		for (int j = 0; j < 3; j++) {
+			if (meta->types[j] == 'G' && IsAllocatableGPR(regs[j]))
+				uses[regs[j]]++;
+		}
+	}
 
+	int order[256];
+	for (int i = 0; i < 256; i++) {
+		order[i] = i;
+		mapping_[i] = INVALID_REG;
+		dirty_[i] = false;
+	}
+	std::stable_sort(order, order + 256, [&](int a, int b) {
+		return uses[a] > uses[b];
+	});
+
+	// Each allocated reg costs a load on entry and a store on exit, so only bother if reused.
+	numMappedRegs_ = 0;
+	for (int i = 0; i < (int)ARRAY_SIZE(allocOrder) && uses[order[i]] >= 2; i++) {
+		mapping_[order[i]] = allocOrder[i];
+		mappedRegs_[numMappedRegs_++] = order[i];
 	}
-	// etc..
-	return mapping;
 }
 
-// Every 4 registers can also be mapped into an SSE register.
-// When changing from single to vec4 mapping, we'll just flush, for now.
-class GreedyRegallocFPR {
-public:
-	FPRMapping Map(IRInst inst, const IRMeta &meta);
-};
+OpArg IRToX86::GPR(int reg) const {
+	if (mapping_[reg] != INVALID_REG)
+		return R(mapping_[reg]);
+	return MIPSState_IRReg(reg);
+}
+
+OpArg IRToX86::FPR(int reg) const {
+	return MDisp(CTXREG, reg * 4);
+}
+
+void IRToX86::MarkDirty(int reg) {
+	dirty_[reg] = true;
+}
+
+void IRToX86::FlushAll(bool clearDirty) {
+	for (int i = 0; i < numMappedRegs_; i++) {
+		int reg = mappedRegs_[i];
+		if (dirty_[reg]) {
+			MOV(32, MIPSState_IRReg(reg), R(mapping_[reg]));
+			if (clearDirty)
+				dirty_[reg] = false;
+		}
+	}
+}
 
-FPRMapping GreedyRegallocFPR::Map(IRInst inst, const IRMeta &meta) {
-	FPRMapping mapping;
+void IRToX86::ReloadAll() {
+	for (int i = 0; i < numMappedRegs_; i++) {
+		int reg = mappedRegs_[i];
+		MOV(32, R(mapping_[reg]), MIPSState_IRReg(reg));
+	}
+}
 
-	return mapping;
+void IRToX86::CompMov(int dest, const OpArg &src) {
+	if (mapping_[dest] != INVALID_REG || src.IsSimpleReg() || src.IsImm()) {
+		MOV(32, GPR(dest), src);
+	} else {
+		MOV(32, R(EAX), src);
+		MOV(32, GPR(dest), R(EAX));
+	}
+	MarkDirty(dest);
 }
 
+void IRToX86::CompBinary(const IRInst &inst, void (XEmitter::*op)(int, const OpArg &, const OpArg &), bool isConst) {
+	OpArg src2 = isConst ? Imm32(inst.constant) : GPR(inst.src2);
+	bool src2Clobbered = !isConst && inst.src2 == inst.dest && inst.src1 != inst.dest;
+	if (mapping_[inst.dest] != INVALID_REG && !src2Clobbered) {
+		if (inst.src1 != inst.dest)
+			MOV(32, GPR(inst.dest), GPR(inst.src1));
+		(this->*op)(32, GPR(inst.dest), src2);
+	} else {
+		MOV(32, R(EAX), GPR(inst.src1));
+		(this->*op)(32, R(EAX), src2);
+		MOV(32, GPR(inst.dest), R(EAX));
+	}
+	MarkDirty(inst.dest);
+}
 
-// This requires that ThreeOpToTwoOp has been run as the last pass.
-void IRToX86::ConvertIRToNative(const IRInst *instructions, int count, const u32 *constants) {
-	// Set up regcaches
-	using namespace Gen;
+void IRToX86::CompShift(const IRInst &inst, void (XEmitter::*op)(int, OpArg, OpArg), bool isImm) {
+	if (isImm) {
+		MOV(32, R(EAX), GPR(inst.src1));
+		if (inst.src2 != 0)
+			(this->*op)(32, R(EAX), Imm8(inst.src2));
+	} else {
+		// x86 masks the shift amount to 5 bits, just like MIPS.
+		MOV(32, R(ECX), GPR(inst.src2));
+		MOV(32, R(EAX), GPR(inst.src1));
+		(this->*op)(32, R(EAX), R(CL));
+	}
+	CompMov(inst.dest, R(EAX));
+}
 
-	GreedyRegallocGPR gprAlloc;
-	GreedyRegallocFPR fprAlloc;
+void IRToX86::CompSetLess(const IRInst &inst, CCFlags cc, bool isConst) {
+	OpArg src2 = isConst ? Imm32(inst.constant) : GPR(inst.src2);
+	MOV(32, R(ECX), GPR(inst.src1));
+	XOR(32, R(EAX), R(EAX));
+	CMP(32, R(ECX), src2);
+	SETcc(cc, R(EAX));
+	CompMov(inst.dest, R(EAX));
+}
+
+void IRToX86::CompMult(const IRInst &inst, bool isSigned, int accumulate) {
+	// The 64-bit low half of the product is the full result either way.
+	if (isSigned) {
+		MOVSX(64, 32, RAX, GPR(inst.src1));
+		MOVSX(64, 32, RCX, GPR(inst.src2));
+	} else {
+		MOV(32, R(EAX), GPR(inst.src1));
+		MOV(32, R(ECX), GPR(inst.src2));
+	}
+	IMUL(64, RAX, R(RCX));
+
+	// lo and hi are adjacent and 8-byte aligned, so we can treat them as one 64-bit value.
+	if (accumulate == 0) {
+		MOV(64, MIPSSTATE_VAR(lo), R(RAX));
+	} else {
+		MOV(64, R(RDX), MIPSSTATE_VAR(lo));
+		if (accumulate > 0)
+			ADD(64, R(RDX), R(RAX));
+		else
+			SUB(64, R(RDX), R(RAX));
+		MOV(64, MIPSSTATE_VAR(lo), R(RDX));
+	}
+}
+
+void IRToX86::CompComputeAddress(const IRInst &inst) {
+	MOV(32, R(EAX), GPR(inst.src1));
+	if (inst.constant != 0)
+		ADD(32, R(EAX), Imm32(inst.constant));
+#ifdef MASKED_PSP_MEMORY
+	AND(32, R(EAX), Imm32(Memory::MEMVIEW32_MASK));
+#endif
+}
+
+void IRToX86::CompExit(const OpArg &pc) {
+	// This is also used for conditional exits, so leave the dirty state alone.
+	if (!pc.IsSimpleReg(EAX))
+		MOV(32, R(EAX), pc);
+	FlushAll(false);
+	JMP(exitBlock_, true);
+}
+
+void IRToX86::CompGeneric(const IRInst *inst, bool mayExit) {
+	FlushAll(true);
+	MOV(64, R(ABI_PARAM1), R(CTXREG));
+	SUB(64, R(ABI_PARAM1), Imm32((u32)offsetof(MIPSState, f[0])));
+	MOV(64, R(ABI_PARAM2), ImmPtr(inst));
+	ABI_CallFunction((const void *)&IRInterpretSingle);
+	if (mayExit) {
+		// Everything was already flushed, so we can leave straight away.
+		TEST(32, R(EAX), R(EAX));
+		FixupBranch skip = J_CC(CC_Z);
+		JMP(exitBlock_, true);
+		SetJumpTarget(skip);
+	}
+	// The interpreter may have changed any reg, so we must reload.
+	ReloadAll();
+}
+
+const u8 *IRToX86::ConvertIRToNative(const IRInst *instructions, int count) {
+	if (GetSpaceLeft() < (size_t)(count + 16) * MAX_BYTES_PER_INST)
+		return nullptr;
+
+	BeginWrite((count + 16) * MAX_BYTES_PER_INST);
+	const u8 *start = AlignCode16();
+
+	AllocateRegs(instructions, count);
+	ReloadAll();
 
-	// Loop through all the instructions, emitting code as we go.
-	// Note that we do need to implement them all - fallbacks are not permitted.
 	for (int i = 0; i < count; i++) {
 		const IRInst *inst = &instructions[i];
-		const IRMeta &meta = *GetIRMeta(inst->op);
-		GPRMapping gpr = gprAlloc.Map(*inst, meta);
-		FPRMapping fpr = fprAlloc.Map(*inst, meta);
 
-		bool symmetric = false;
 		switch (inst->op) {
 		case IROp::Nop:
 			_assert_(false);
 			break;
 
-			// Output-only
 		case IROp::SetConst:
-			code_->MOV(32, gpr.dest, Imm32(constants[inst->src1]));
+			CompMov(inst->dest, Imm32(inst->constant));
 			break;
 		case IROp::SetConstF:
-			code_->MOV(32, gpr.dest, Imm32(constants[inst->src1]));
+			MOV(32, FPR(inst->dest), Imm32(inst->constant));
 			break;
 
-			// Add gets to be special cased because we have LEA.
-		case IROp::Add:
-			if (gpr.dest.IsSimpleReg() && gpr.src1.IsSimpleReg() && gpr.src2.IsSimpleReg()) {
-				code_->LEA(32, gpr.dest.GetSimpleReg(), MRegSum(gpr.src1.GetSimpleReg(), gpr.src2.GetSimpleReg()));
-				break;
-			}
-			// Else fall through.
-			// 3-op arithmetic that directly corresponds to x86
-			// (often 2-op in practice if src1 == dst). x86 only does 2-op though so some of these will need splitting.
-		case IROp::Sub:
-		case IROp::And:
-		case IROp::Or:
-		case IROp::Xor:
-			if (inst->src1 != inst->dest) {
-				code_->MOV(32, gpr.dest, gpr.src1);
-			}
-			// Emit directly
-			switch (inst->op) {
-			case IROp::Add: code_->ADD(32, gpr.dest, gpr.src2); break;
-			case IROp::Sub: code_->SUB(32, gpr.dest, gpr.src2); break;
-			case IROp::And: code_->AND(32, gpr.dest, gpr.src2); break;
-			case IROp::Or: code_->OR(32, gpr.dest, gpr.src2); break;
-			case IROp::Xor: code_->XOR(32, gpr.dest, gpr.src2); break;
-			}
+		case IROp::Mov:
+			if (inst->dest != inst->src1)
+				CompMov(inst->dest, GPR(inst->src1));
 			break;
 
-			// Variable shifts.
-		case IROp::Shl:
-		case IROp::Shr:
-		case IROp::Sar:
-		case IROp::Ror:
+		case IROp::Add: CompBinary(*inst, &XEmitter::ADD, false); break;
+		case IROp::Sub: CompBinary(*inst, &XEmitter::SUB, false); break;
+		case IROp::And: CompBinary(*inst, &XEmitter::AND, false); break;
+		case IROp::Or: CompBinary(*inst, &XEmitter::OR, false); break;
+		case IROp::Xor: CompBinary(*inst, &XEmitter::XOR, false); break;
+		case IROp::AddConst: CompBinary(*inst, &XEmitter::ADD, true); break;
+		case IROp::SubConst: CompBinary(*inst, &XEmitter::SUB, true); break;
+		case IROp::AndConst: CompBinary(*inst, &XEmitter::AND, true); break;
+		case IROp::OrConst: CompBinary(*inst, &XEmitter::OR, true); break;
+		case IROp::XorConst: CompBinary(*inst, &XEmitter::XOR, true); break;
+
+		case IROp::Neg:
+		case IROp::Not:
+			MOV(32, R(EAX), GPR(inst->src1));
+			if (inst->op == IROp::Neg)
+				NEG(32, R(EAX));
+			else
+				NOT(32, R(EAX));
+			CompMov(inst->dest, R(EAX));
+			break;
+
+		case IROp::Shl: CompShift(*inst, &XEmitter::SHL, false); break;
+		case IROp::Shr: CompShift(*inst, &XEmitter::SHR, false); break;
+		case IROp::Sar: CompShift(*inst, &XEmitter::SAR, false); break;
+		case IROp::Ror: CompShift(*inst, &XEmitter::ROR, false); break;
+		case IROp::ShlImm: CompShift(*inst, &XEmitter::SHL, true); break;
+		case IROp::ShrImm: CompShift(*inst, &XEmitter::SHR, true); break;
+		case IROp::SarImm: CompShift(*inst, &XEmitter::SAR, true); break;
+		case IROp::RorImm: CompShift(*inst, &XEmitter::ROR, true); break;
+
+		case IROp::Slt: CompSetLess(*inst, CC_L, false); break;
+		case IROp::SltU: CompSetLess(*inst, CC_B, false); break;
+		case IROp::SltConst: CompSetLess(*inst, CC_L, true); break;
+		case IROp::SltUConst: CompSetLess(*inst, CC_B, true); break;
+
+		case IROp::Clz:
+			if (cpu_info.bLZCNT) {
+				LZCNT(32, EAX, GPR(inst->src1));
+			} else {
+				// BSR leaves the dest undefined on zero, so we select 63 ^ 31 = 32 for that case.
+				MOV(32, R(ECX), Imm32(63));
+				BSR(32, EAX, GPR(inst->src1));
+				CMOVcc(32, EAX, R(ECX), CC_Z);
+				XOR(32, R(EAX), Imm8(31));
+			}
+			CompMov(inst->dest, R(EAX));
+			break;
 
-		case IROp::Slt:
-		case IROp::SltU:
 		case IROp::MovZ:
 		case IROp::MovNZ:
+		{
+			// Moving a reg onto itself does nothing either way.
+			if (inst->dest == inst->src2)
+				break;
+			CMP(32, GPR(inst->src1), Imm32(0));
+			FixupBranch skip = J_CC(inst->op == IROp::MovZ ? CC_NZ : CC_Z, true);
+			CompMov(inst->dest, GPR(inst->src2));
+			SetJumpTarget(skip);
+			break;
+		}
+
 		case IROp::Max:
 		case IROp::Min:
+			MOV(32, R(EAX), GPR(inst->src1));
+			CMP(32, R(EAX), GPR(inst->src2));
+			CMOVcc(32, EAX, GPR(inst->src2), inst->op == IROp::Max ? CC_L : CC_G);
+			CompMov(inst->dest, R(EAX));
 			break;
 
-			// 2-op arithmetic with constant
-		case IROp::AddConst:
-		case IROp::SubConst:
-		case IROp::AndConst:
-		case IROp::OrConst:
-		case IROp::XorConst:
-		case IROp::SltConst:
-		case IROp::SltUConst:
-
-			// 2-op arithmetic with immediate
-		case IROp::ShlImm:
-		case IROp::ShrImm:
-		case IROp::SarImm:
-		case IROp::RorImm:
-
-			// 2-op arithmetic
-		case IROp::Mov:
-			code_->MOV(32, gpr.dest, gpr.src1);
+		case IROp::BSwap16:
+			MOV(32, R(EAX), GPR(inst->src1));
+			BSWAP(32, EAX);
+			ROR(32, R(EAX), Imm8(16));
+			CompMov(inst->dest, R(EAX));
+			break;
+		case IROp::BSwap32:
+			MOV(32, R(EAX), GPR(inst->src1));
+			BSWAP(32, EAX);
+			CompMov(inst->dest, R(EAX));
 			break;
 
-		case IROp::Neg:
-		case IROp::Not:
 		case IROp::Ext8to32:
+			MOVSX(32, 8, EAX, GPR(inst->src1));
+			CompMov(inst->dest, R(EAX));
+			break;
 		case IROp::Ext16to32:
-		case IROp::ReverseBits:
-		case IROp::BSwap16:
-		case IROp::BSwap32:
-		case IROp::Clz:
-			if (inst->dest != inst->src1) {
-				code_->NEG(32, gpr.dest); break;
-			}
+			MOVSX(32, 16, EAX, GPR(inst->src1));
+			CompMov(inst->dest, R(EAX));
 			break;
-				// Multiplier control
+
 		case IROp::MtLo:
+			CompMov(IRREG_LO, GPR(inst->src1));
+			break;
 		case IROp::MtHi:
+			CompMov(IRREG_HI, GPR(inst->src1));
+			break;
 		case IROp::MfLo:
+			CompMov(inst->dest, MIPSSTATE_VAR(lo));
+			break;
 		case IROp::MfHi:
-		case IROp::Mult:
-		case IROp::MultU:
-		case IROp::Madd:
-		case IROp::MaddU:
-		case IROp::Msub:
-		case IROp::MsubU:
-		case IROp::Div:
-		case IROp::DivU:
-
-			// Memory access
+			CompMov(inst->dest, MIPSSTATE_VAR(hi));
+			break;
+
+		case IROp::Mult: CompMult(*inst, true, 0); break;
+		case IROp::MultU: CompMult(*inst, false, 0); break;
+		case IROp::Madd: CompMult(*inst, true, 1); break;
+		case IROp::MaddU: CompMult(*inst, false, 1); break;
+		case IROp::Msub: CompMult(*inst, true, -1); break;
+		case IROp::MsubU: CompMult(*inst, false, -1); break;
+
 		case IROp::Load8:
+			CompComputeAddress(*inst);
+			MOVZX(32, 8, EAX, MRegSum(MEMBASEREG, RAX));
+			CompMov(inst->dest, R(EAX));
+			break;
 		case IROp::Load8Ext:
+			CompComputeAddress(*inst);
+			MOVSX(32, 8, EAX, MRegSum(MEMBASEREG, RAX));
+			CompMov(inst->dest, R(EAX));
+			break;
 		case IROp::Load16:
+			CompComputeAddress(*inst);
+			MOVZX(32, 16, EAX, MRegSum(MEMBASEREG, RAX));
+			CompMov(inst->dest, R(EAX));
+			break;
 		case IROp::Load16Ext:
+			CompComputeAddress(*inst);
+			MOVSX(32, 16, EAX, MRegSum(MEMBASEREG, RAX));
+			CompMov(inst->dest, R(EAX));
+			break;
 		case IROp::Load32:
+			CompComputeAddress(*inst);
+			MOV(32, R(EAX), MRegSum(MEMBASEREG, RAX));
+			CompMov(inst->dest, R(EAX));
+			break;
 		case IROp::LoadFloat:
+			CompComputeAddress(*inst);
+			MOV(32, R(EAX), MRegSum(MEMBASEREG, RAX));
+			MOV(32, FPR(inst->dest), R(EAX));
+			break;
+
 		case IROp::Store8:
+			CompComputeAddress(*inst);
+			MOV(32, R(ECX), GPR(inst->src3));
+			MOV(8, MRegSum(MEMBASEREG, RAX), R(ECX));
+			break;
 		case IROp::Store16:
+			CompComputeAddress(*inst);
+			MOV(32, R(ECX), GPR(inst->src3));
+			MOV(16, MRegSum(MEMBASEREG, RAX), R(ECX));
+			break;
 		case IROp::Store32:
+			CompComputeAddress(*inst);
+			MOV(32, R(ECX), GPR(inst->src3));
+			MOV(32, MRegSum(MEMBASEREG, RAX), R(ECX));
+			break;
 		case IROp::StoreFloat:
-		case IROp::LoadVec4:
-		case IROp::StoreVec4:
-
-			// Output-only SIMD functions
-		case IROp::Vec4Init:
-		case IROp::Vec4Shuffle:
-
-			// 2-op SIMD functions
-		case IROp::Vec4Mov:
-			code_->MOVAPS(fpr.dest.GetSimpleReg(), fpr.src1);
-			break;
-		case IROp::Vec4Neg:
-		case IROp::Vec4Abs:
-			break;
-		case IROp::Vec4ClampToZero:
-			code_->PXOR(XMM0, R(XMM0));
-			code_->PMAXSW(XMM0, fpr.src1);
-			code_->MOVAPD(fpr.dest, XMM0);
-			break;
-		case IROp::Vec4DuplicateUpperBitsAndShift1:
-		case IROp::Vec2ClampToZero:
-
-			// 3-op SIMD functions
-		case IROp::Vec4Add:
-		case IROp::Vec4Sub:
-		case IROp::Vec4Mul:
-		case IROp::Vec4Div:
-
-		case IROp::Vec4Scale:
-		case IROp::Vec4Dot:
-
-			// Pack-unpack
-		case IROp::Vec2Unpack16To31:
-		case IROp::Vec2Unpack16To32:
-		case IROp::Vec4Unpack8To32:
-		case IROp::Vec2Pack32To16:
-		case IROp::Vec2Pack31To16:
-		case IROp::Vec4Pack32To8:
-		case IROp::Vec4Pack31To8:
-
-		case IROp::FCmpVfpuBit:
-		case IROp::FCmpVfpuAggregate:
-		case IROp::FCmovVfpuCC:
-
-			// Trancendental functions (non-simd)
-		case IROp::FSin:
-		case IROp::FCos:
-		case IROp::FRSqrt:
-		case IROp::FRecip:
-		case IROp::FAsin:
-
-			// 3-Op FP
+			CompComputeAddress(*inst);
+			MOV(32, R(ECX), FPR(inst->src3));
+			MOV(32, MRegSum(MEMBASEREG, RAX), R(ECX));
+			break;
+
 		case IROp::FAdd:
 		case IROp::FSub:
-		case IROp::FMul:
 		case IROp::FDiv:
-		case IROp::FMin:
-		case IROp::FMax:
+			MOVSS(XMM0, FPR(inst->src1));
+			if (inst->op == IROp::FAdd)
+				ADDSS(XMM0, FPR(inst->src2));
+			else if (inst->op == IROp::FSub)
+				SUBSS(XMM0, FPR(inst->src2));
+			else
+				DIVSS(XMM0, FPR(inst->src2));
+			MOVSS(FPR(inst->dest), XMM0);
+			break;
+		case IROp::FSqrt:
+			SQRTSS(XMM0, FPR(inst->src1));
+			MOVSS(FPR(inst->dest), XMM0);
+			break;
+		case IROp::FCvtSW:
+			CVTSI2SS(XMM0, FPR(inst->src1));
+			MOVSS(FPR(inst->dest), XMM0);
+			break;
 
-			// 2-Op FP
 		case IROp::FMov:
-		case IROp::FAbs:
-		case IROp::FSqrt:
 		case IROp::FNeg:
-		case IROp::FSat0_1:
-		case IROp::FSatMinus1_1:
-		case IROp::FSign:
-		case IROp::FCeil:
-		case IROp::FFloor:
-		case IROp::FCmp:
-		case IROp::FCvtSW:
-		case IROp::FCvtWS:
-		case IROp::FRound:
-		case IROp::FTrunc:
+		case IROp::FAbs:
+			// Just bits, so no need for SSE here.
+			MOV(32, R(EAX), FPR(inst->src1));
+			if (inst->op == IROp::FNeg)
+				XOR(32, R(EAX), Imm32(0x80000000));
+			else if (inst->op == IROp::FAbs)
+				AND(32, R(EAX), Imm32(0x7FFFFFFF));
+			MOV(32, FPR(inst->dest), R(EAX));
+			break;
 
-			// Cross moves
 		case IROp::FMovFromGPR:
+			MOV(32, R(EAX), GPR(inst->src1));
+			MOV(32, FPR(inst->dest), R(EAX));
+			break;
 		case IROp::FMovToGPR:
+			CompMov(inst->dest, FPR(inst->src1));
+			break;
+
 		case IROp::FpCondToReg:
-		case IROp::VfpuCtrlToReg:
+			CompMov(inst->dest, MIPSSTATE_VAR(fpcond));
+			break;
+		case IROp::ZeroFpCond:
+			MOV(32, MIPSSTATE_VAR(fpcond), Imm32(0));
+			break;
 
-			// VFPU flag/control
+		case IROp::VfpuCtrlToReg:
+			CompMov(inst->dest, MIPSSTATE_VAR_ELEM32(vfpuCtrl[0], inst->src1));
+			break;
 		case IROp::SetCtrlVFPU:
+			MOV(32, MIPSSTATE_VAR_ELEM32(vfpuCtrl[0], inst->dest), Imm32(inst->constant));
+			break;
 		case IROp::SetCtrlVFPUReg:
+			MOV(32, R(EAX), GPR(inst->src1));
+			MOV(32, MIPSSTATE_VAR_ELEM32(vfpuCtrl[0], inst->dest), R(EAX));
+			break;
 		case IROp::SetCtrlVFPUFReg:
-		case IROp::ZeroFpCond:
+			MOV(32, R(EAX), FPR(inst->src1));
+			MOV(32, MIPSSTATE_VAR_ELEM32(vfpuCtrl[0], inst->dest), R(EAX));
+			break;
+
+		case IROp::Downcount:
+			SUB(32, MIPSSTATE_VAR(downcount), Imm32(inst->constant));
+			break;
+		case IROp::SetPC:
+			MOV(32, R(EAX), GPR(inst->src1));
+			MOV(32, MIPSSTATE_VAR(pc), R(EAX));
+			break;
+		case IROp::SetPCConst:
+			MOV(32, MIPSSTATE_VAR(pc), Imm32(inst->constant));
+			break;
 
-			// Block Exits
 		case IROp::ExitToConst:
+			CompExit(Imm32(inst->constant));
+			break;
 		case IROp::ExitToReg:
+			CompExit(GPR(inst->src1));
+			break;
+		case IROp::ExitToPC:
+			CompExit(MIPSSTATE_VAR(pc));
+			break;
+
 		case IROp::ExitToConstIfEq:
 		case IROp::ExitToConstIfNeq:
 		case IROp::ExitToConstIfGtZ:
 		case IROp::ExitToConstIfGeZ:
 		case IROp::ExitToConstIfLtZ:
 		case IROp::ExitToConstIfLeZ:
-		case IROp::ExitToPC:
+		case IROp::ExitToConstIfFpTrue:
+		case IROp::ExitToConstIfFpFalse:
+		{
+			CCFlags skipCC;
+			switch (inst->op) {
+			case IROp::ExitToConstIfEq:
+			case IROp::ExitToConstIfNeq:
+				if (mapping_[inst->src1] != INVALID_REG) {
+					CMP(32, GPR(inst->src1), GPR(inst->src2));
+				} else {
+					MOV(32, R(EAX), GPR(inst->src1));
+					CMP(32, R(EAX), GPR(inst->src2));
+				}
+				skipCC = inst->op == IROp::ExitToConstIfEq ? CC_NE : CC_E;
+				break;
+			case IROp::ExitToConstIfFpTrue:
+			case IROp::ExitToConstIfFpFalse:
+				CMP(32, MIPSSTATE_VAR(fpcond), Imm32(0));
+				skipCC = inst->op == IROp::ExitToConstIfFpTrue ? CC_E : CC_NE;
+				break;
+			default:
+				CMP(32, GPR(inst->src1), Imm32(0));
+				if (inst->op == IROp::ExitToConstIfGtZ)
+					skipCC = CC_LE;
+				else if (inst->op == IROp::ExitToConstIfGeZ)
+					skipCC = CC_L;
+				else if (inst->op == IROp::ExitToConstIfLtZ)
+					skipCC = CC_GE;
+				else
+					skipCC = CC_G;
+				break;
+			}
+			FixupBranch skip = J_CC(skipCC, true);
+			CompExit(Imm32(inst->constant));
+			SetJumpTarget(skip);
+			break;
+		}
+
+		case IROp::ApplyRoundingMode:
+		case IROp::RestoreRoundingMode:
+		case IROp::UpdateRoundingMode:
+			// Not implemented by the interpreter either.
+			break;
 
-			// Utilities
-		case IROp::Downcount:
-		case IROp::SetPC:
-		case IROp::SetPCConst:
-		case IROp::Syscall:
-		case IROp::Interpret:  // SLOW fallback. Can be made faster.
-		case IROp::CallReplacement:
 		case IROp::Break:
+		case IROp::Breakpoint:
+		case IROp::MemoryCheck:
+			CompGeneric(inst, true);
+			break;
+
 		default:
+			// Includes syscalls, replacements, interpret, and most of the FPU/VFPU.
+			CompGeneric(inst, false);
 			break;
-			}
 		}
 	}
 
+	// Blocks always end with an exit, so this should never be reached.
+	INT3();
+
+	EndWrite();
+	return start;
+}
 
-}  // namespace
+}  // namespace MIPSComp
 
-#endif // PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+#endif // PPSSPP_ARCH(AMD64)
@@ -1,23 +1,93 @@
+// Copyright (c) 2012- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <string>
+
+#include "ppsspp_config.h"
+#include "Common/CommonTypes.h"
 #include "Core/MIPS/IR/IRInst.h"
+
+#if PPSSPP_ARCH(AMD64)
 #include "Common/x64Emitter.h"
+#endif
 
 namespace MIPSComp {
 
+// Enters a compiled block and returns the new PC, exactly like IRInterpret.
+typedef u32 (*IRNativeEnterFunc)(MIPSState *mips, const u8 *block);
+
 class IRToNativeInterface {
 public:
 	virtual ~IRToNativeInterface() {}
 
-	virtual void ConvertIRToNative(const IRInst *instructions, int count, const u32 *constants) = 0;
+	// The instructions must stay alive (at the same address) as long as the returned code can run,
+	// since instructions we don't lower natively are called out to the interpreter one at a time.
+	// Returns nullptr if the block could not be compiled, typically because the code space is full.
+	virtual const u8 *ConvertIRToNative(const IRInst *instructions, int count) = 0;
+	virtual void ClearCache() = 0;
+	virtual bool DescribeCodePtr(const u8 *ptr, std::string &name) const = 0;
+	virtual IRNativeEnterFunc GetEnterFunc() const = 0;
 };
 
+#if PPSSPP_ARCH(AMD64)
 
-class IRToX86 : public IRToNativeInterface {
+class IRToX86 : public IRToNativeInterface, public Gen::XCodeBlock {
 public:
-	void SetCodeBlock(Gen::XCodeBlock *code) { code_ = code; }
-	virtual void ConvertIRToNative(const IRInst *instructions, int count, const u32 *constants) override;
+	IRToX86();
+
+	const u8 *ConvertIRToNative(const IRInst *instructions, int count) override;
+	void ClearCache() override;
+	bool DescribeCodePtr(const u8 *ptr, std::string &name) const override;
+	IRNativeEnterFunc GetEnterFunc() const override {
+		return enterBlock_;
+	}
 
 private:
-	Gen::XCodeBlock *code_;
+	void GenerateFixedCode();
+	void AllocateRegs(const IRInst *instructions, int count);
+
+	Gen::OpArg GPR(int reg) const;
+	Gen::OpArg FPR(int reg) const;
+	void MarkDirty(int reg);
+	void FlushAll(bool clearDirty);
+	void ReloadAll();
+
+	void CompMov(int dest, const Gen::OpArg &src);
+	void CompBinary(const IRInst &inst, void (XEmitter::*op)(int, const Gen::OpArg &, const Gen::OpArg &), bool isConst);
+	void CompShift(const IRInst &inst, void (XEmitter::*op)(int, Gen::OpArg, Gen::OpArg), bool isImm);
+	void CompSetLess(const IRInst &inst, Gen::CCFlags cc, bool isConst);
+	void CompMult(const IRInst &inst, bool isSigned, int accumulate);
+	void CompComputeAddress(const IRInst &inst);
+	void CompExit(const Gen::OpArg &pc);
+	void CompGeneric(const IRInst *inst, bool mayExit);
+
+	// Host register assigned to each IR register, or INVALID_REG.
+	Gen::X64Reg mapping_[256];
+	bool dirty_[256];
+	int mappedRegs_[8];
+	int numMappedRegs_ = 0;
+
+	IRNativeEnterFunc enterBlock_ = nullptr;
+	const u8 *exitBlock_ = nullptr;
+	size_t fixedCodeSize_ = 0;
 };
 
+#endif
+
 }  // namespace
@@ -314,7 +314,7 @@ void Reinit() {
 	Core_NotifyLifecycle(CoreLifecycle::MEMORY_REINITED);
 }
 
-void DoState(PointerWrap &p) {
+void DoState(PointerWrap &p, bool includeContents) {
 	auto s = p.Section("Memory", 1, 3);
 	if (!s)
 		return;
@@ -346,6 +346,9 @@ void DoState(PointerWrap &p) {
 		}
 	}
 
+	if (!includeContents)
+		return;
+
 	DoArray(p, GetPointer(PSP_GetKernelMemoryBase()), g_MemorySize);
 	p.DoMarker("RAM");
 
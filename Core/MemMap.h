@@ -128,7 +128,8 @@ void MemoryMap_Shutdown(u32 flags);
 // Init and Shutdown
 bool Init();
 void Shutdown();
-void DoState(PointerWrap &p);
+// Without contents, only the layout is saved (rewind tracks the contents itself.)
+void DoState(PointerWrap &p, bool includeContents = true);
 void Clear();
 // False when shutdown has already been called.
 bool IsActive();
@@ -297,6 +297,10 @@ bool ReplayFlushFile(const std::string &filename) {
 	return success;
 }
 
+bool ReplayIsActive() {
+	return replayState != ReplayState::IDLE;
+}
+
 void ReplayAbort() {
 	replayItems.clear();
 	replayExecPos = 0;
@@ -64,6 +64,8 @@ bool ReplayFlushFile(const std::string &filename);
 
 // Abort any execute or record operation in progress.
 void ReplayAbort();
+// Returns whether a replay is being executed or recorded.
+bool ReplayIsActive();
 
 void ReplayApplyCtrl(uint32_t &buttons, uint8_t analog[2][2], uint64_t t);
 uint32_t ReplayApplyDisk(ReplayAction action, uint32_t result, uint64_t t);
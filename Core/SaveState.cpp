@@ -37,6 +37,7 @@
 #include "Core/Host.h"
 #include "Core/Screenshot.h"
 #include "Core/System.h"
+#include "Core/ThreadPools.h"
 #include "Core/FileSystems/MetaFileSystem.h"
 #include "Core/ELF/ParamSFO.h"
 #include "Core/HLE/HLE.h"
@@ -47,6 +48,7 @@
 #include "Core/MemMap.h"
 #include "Core/MIPS/MIPS.h"
 #include "Core/MIPS/JitCommon/JitBlockCache.h"
+#include "Core/Util/RewindMemory.h"
 #include "HW/MemoryStick.h"
 #include "GPU/GPUState.h"
 
@@ -99,9 +101,27 @@ namespace SaveState
 		return CChunkFileReader::LoadPtr(&data[0], state, errorString);
 	}
 
+	// Rewind keeps RAM, VRAM and scratchpad out of the serialized state, and snapshots them by page instead.
+	static void DoRewindMemoryState(PointerWrap &p, RewindMemory &memory)
+	{
+		Memory::DoState(p, false);
+		memory.SetRegions({
+			{ Memory::GetPointer(PSP_GetKernelMemoryBase()), Memory::g_MemorySize },
+			{ Memory::GetPointer(PSP_GetVidMemBase()), Memory::VRAM_SIZE },
+			{ Memory::GetPointer(PSP_GetScratchpadMemoryBase()), Memory::SCRATCHPAD_SIZE },
+		});
+		if (p.mode == p.MODE_WRITE)
+			memory.Push();
+		else if (p.mode == p.MODE_READ && !memory.Pop(true))
+			p.SetError(p.ERROR_FAILURE);
+	}
+
+	// Set while saving or loading a rewind state, so SaveStart uses it for memory.
+	static RewindMemory *activeRewindMemory = nullptr;
+
 	struct StateRingbuffer
 	{
-		StateRingbuffer(int size) : first_(0), next_(0), size_(size), base_(-1)
+		StateRingbuffer(int size) : first_(0), next_(0), size_(size), base_(-1), memory_(size)
 		{
 			states_.resize(size);
 			baseMapping_.resize(size);
@@ -109,50 +129,81 @@ namespace SaveState
 
 		CChunkFileReader::Error Save()
 		{
+			// The last compress may still be reading the buffer we're about to reuse.
+			if (compressThread_.joinable())
+				compressThread_.join();
 			std::lock_guard<std::mutex> guard(lock_);
 
+			// Memory keeps a snapshot for each state, so it drops its oldest whenever we do.
 			int n = next_++ % size_;
-			if ((next_ % size_) == first_)
-				++first_;
+			if (next_ - first_ > size_)
+				DropOldest();
 
 			static std::vector<u8> buffer;
 			std::vector<u8> *compressBuffer = &buffer;
 			CChunkFileReader::Error err;
 
+			activeRewindMemory = &memory_;
 			if (base_ == -1 || ++baseUsage_ > BASE_USAGE_INTERVAL)
 			{
 				base_ = (base_ + 1) % ARRAY_SIZE(bases_);
 				baseUsage_ = 0;
+				// Anything still diffed against the base we're replacing can't be restored anymore.
+				while (first_ < next_ - 1 && baseMapping_[first_ % size_] == base_)
+					DropOldest();
 				err = SaveToRam(bases_[base_]);
 				// Let's not bother savestating twice.
 				compressBuffer = &bases_[base_];
 			}
 			else
 				err = SaveToRam(buffer);
+			activeRewindMemory = nullptr;
 
 			if (err == CChunkFileReader::ERROR_NONE)
 				ScheduleCompress(&states_[n], compressBuffer, &bases_[base_]);
 			else
+			{
+				// We can't tell if memory got this one, so start over rather than get out of step.
 				states_[n].clear();
+				first_ = next_;
+				memory_.Clear();
+			}
 			baseMapping_[n] = base_;
 			return err;
 		}
 
+		void DropOldest()
+		{
+			++first_;
+			memory_.DropOldest();
+		}
+
 		CChunkFileReader::Error Restore(std::string *errorString)
 		{
+			// Make sure the newest state is done compressing.
+			if (compressThread_.joinable())
+				compressThread_.join();
 			std::lock_guard<std::mutex> guard(lock_);
 
 			// No valid states left.
 			if (Empty())
 				return CChunkFileReader::ERROR_BAD_FILE;
 
-			int n = (--next_ + size_) % size_;
-			if (states_[n].empty())
-				return CChunkFileReader::ERROR_BAD_FILE;
-
-			static std::vector<u8> buffer;
-			LockedDecompress(buffer, states_[n], bases_[baseMapping_[n]]);
-			return LoadFromRam(buffer, errorString);
+			int n = --next_ % size_;
+			int memoryCount = memory_.Count();
+			CChunkFileReader::Error err = CChunkFileReader::ERROR_BAD_FILE;
+			if (!states_[n].empty())
+			{
+				static std::vector<u8> buffer;
+				LockedDecompress(buffer, states_[n], bases_[baseMapping_[n]]);
+				activeRewindMemory = &memory_;
+				err = LoadFromRam(buffer, errorString);
+				activeRewindMemory = nullptr;
+			}
+			// Drop its memory even if loading stopped before getting there, to stay in step.
+			if (memory_.Count() == memoryCount)
+				memory_.Pop(false);
+			return err;
 		}
 
 		void ScheduleCompress(std::vector<u8> *result, const std::vector<u8> *state, const std::vector<u8> *base)
@@ -172,8 +223,27 @@ namespace SaveState
 			if (first_ == 0 && next_ == 0)
 				return;
 
+			// Diff independent groups of blocks in parallel, then stitch them together in order.
+			int numBlocks = (int)((state.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+			int numGroups = (numBlocks + BLOCKS_PER_GROUP - 1) / BLOCKS_PER_GROUP;
+			std::vector<StateBuffer> groups(numGroups);
+			GlobalThreadPool::Loop([&](int lower, int upper) {
+				for (int g = lower; g < upper; ++g)
+					CompressBlocks(groups[g], state, base, g * BLOCKS_PER_GROUP, std::min(numBlocks, (g + 1) * BLOCKS_PER_GROUP));
+			}, 0, numGroups);
+
+			size_t total = 0;
+			for (const StateBuffer &group : groups)
+				total += group.size();
 			result.clear();
-			for (size_t i = 0; i < state.size(); i += BLOCK_SIZE)
+			result.reserve(total);
+			for (const StateBuffer &group : groups)
+				result.insert(result.end(), group.begin(), group.end());
+		}
+
+		void CompressBlocks(std::vector<u8> &result, const std::vector<u8> &state, const std::vector<u8> &base, int startBlock, int endBlock)
+		{
+			for (size_t i = (size_t)startBlock * BLOCK_SIZE; i < std::min(state.size(), (size_t)endBlock * BLOCK_SIZE); i += BLOCK_SIZE)
 			{
 				int blockSize = std::min(BLOCK_SIZE, (int)(state.size() - i));
 				if (i + blockSize > base.size() || memcmp(&state[i], &base[i], blockSize) != 0)
@@ -220,6 +290,7 @@ namespace SaveState
 			std::lock_guard<std::mutex> guard(lock_);
 			first_ = 0;
 			next_ = 0;
+			memory_.Clear();
 		}
 
 		bool Empty() const
@@ -228,6 +299,8 @@ namespace SaveState
 		}
 
 		static const int BLOCK_SIZE;
+		// Blocks diffed together by one worker.
+		static const int BLOCKS_PER_GROUP;
 		// TODO: Instead, based on size of compressed state?
 		static const int BASE_USAGE_INTERVAL;
 
@@ -245,6 +318,9 @@ namespace SaveState
 
 		int base_;
 		int baseUsage_;
+
+		// RAM, VRAM and scratchpad for each state, newest last.
+		RewindMemory memory_;
 	};
 
 	static bool needsProcess = false;
@@ -266,8 +342,18 @@ namespace SaveState
 	const static float rewindMaxWallFrequency = 1.0f;
 	static double rewindLastTime = 0.0f;
 	const int StateRingbuffer::BLOCK_SIZE = 8192;
+	const int StateRingbuffer::BLOCKS_PER_GROUP = 128;
 	const int StateRingbuffer::BASE_USAGE_INTERVAL = 15;
 
+	static CChunkFileReader::Compression StateCompression()
+	{
+		if (g_Config.iSaveStateCompression == 1)
+			return CChunkFileReader::Compression::DEFLATE_CHUNKED;
+		if (g_Config.iSaveStateCompression == 2)
+			return CChunkFileReader::Compression::SNAPPY;
+		return CChunkFileReader::Compression::SNAPPY_CHUNKED;
+	}
+
 	void SaveStart::DoState(PointerWrap &p)
 	{
 		auto s = p.Section("SaveStart", 1, 2);
@@ -295,9 +381,14 @@ namespace SaveState
 		{
 			std::vector<u32> savedBlocks;
 			savedBlocks = MIPSComp::jit->SaveAndClearEmuHackOps();
-			Memory::DoState(p);
+			if (activeRewindMemory)
+				DoRewindMemoryState(p, *activeRewindMemory);
+			else
+				Memory::DoState(p);
 			MIPSComp::jit->RestoreSavedEmuHackOps(savedBlocks);
 		}
+		else if (activeRewindMemory)
+			DoRewindMemoryState(p, *activeRewindMemory);
 		else
 			Memory::DoState(p);
 		RestoreSavedReplacements(savedReplacements);
@@ -812,7 +903,7 @@ namespace SaveState
 					std::size_t lslash = title.find_last_of("/");
 					title = title.substr(lslash + 1);
 				}
-				result = CChunkFileReader::Save(op.filename, title, PPSSPP_GIT_VERSION, state);
+				result = CChunkFileReader::Save(op.filename, title, PPSSPP_GIT_VERSION, state, StateCompression());
 				if (result == CChunkFileReader::ERROR_NONE) {
 					callbackMessage = slot_prefix + sc->T("Saved State");
 					callbackResult = Status::SUCCESS;
@@ -908,6 +999,10 @@ namespace SaveState
 		// Make sure there's a directory for save slots
 		File::CreateFullPath(GetSysDirectory(DIRECTORY_SAVESTATE));
 
+		CChunkFileReader::SetParallelLoop([](const std::function<void(int, int)> &loop, int lower, int upper) {
+			GlobalThreadPool::Loop(loop, lower, upper);
+		});
+
 		std::lock_guard<std::mutex> guard(mutex);
 		rewindStates.Clear();
 
@@ -6,9 +6,24 @@
 std::unique_ptr<ThreadPool> GlobalThreadPool::pool;
 std::once_flag GlobalThreadPool::init_flag;
 
-void GlobalThreadPool::Loop(const std::function<void(int,int)>& loop, int lower, int upper) {
+void GlobalThreadPool::Loop(const std::function<void(int,int)>& loop, int lower, int upper, TaskPriority priority) {
 	std::call_once(init_flag, Inititialize);
-	pool->ParallelLoop(loop, lower, upper);
+	pool->ParallelLoop(loop, lower, upper, priority);
+}
+
+void GlobalThreadPool::Submit(Task *task) {
+	std::call_once(init_flag, Inititialize);
+	pool->Submit(task);
+}
+
+void GlobalThreadPool::Wait(Task *task) {
+	std::call_once(init_flag, Inititialize);
+	pool->Wait(task);
+}
+
+int GlobalThreadPool::NumThreads() {
+	std::call_once(init_flag, Inititialize);
+	return pool->NumThreads();
 }
 
 void GlobalThreadPool::Inititialize() {
@@ -6,7 +6,13 @@ class GlobalThreadPool {
 public:
 	// will execute slices of "loop" from "lower" to "upper"
 	// in parallel on the global thread pool
-	static void Loop(const std::function<void(int,int)>& loop, int lower, int upper);
+	static void Loop(const std::function<void(int,int)>& loop, int lower, int upper, TaskPriority priority = TaskPriority::NORMAL);
+
+	// The task must stay alive until it's done, see ThreadPool::Submit().
+	static void Submit(Task *task);
+	static void Wait(Task *task);
+
+	static int NumThreads();
 
 private:
 	static std::unique_ptr<ThreadPool> pool;
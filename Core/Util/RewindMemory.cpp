@@ -0,0 +1,203 @@
+// Copyright (c) 2012- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstring>
+#include <snappy-c.h>
+
+#include "Common/Log.h"
+#include "Core/ThreadPools.h"
+#include "Core/Util/RewindMemory.h"
+#include "ext/xxhash.h"
+
+RewindMemory::RewindMemory(int maxSnapshots) : maxSnapshots_(maxSnapshots) {
+}
+
+void RewindMemory::SetRegions(const std::vector<Region> &regions) {
+	std::vector<u32> sizes;
+	pagePtrs_.clear();
+	for (const Region &region : regions) {
+		_dbg_assert_((region.size % PAGE_SIZE) == 0);
+		sizes.push_back(region.size);
+		for (u32 offset = 0; offset < region.size; offset += PAGE_SIZE)
+			pagePtrs_.push_back(region.ptr + offset);
+	}
+
+	if (sizes != regionSizes_) {
+		Clear();
+		regionSizes_ = sizes;
+	}
+}
+
+// Changed pages are found by hashing rather than by write-protecting the regions.
+// Syscalls like read() and recv() write straight into PSP memory, and would fail on protected pages.
+void RewindMemory::HashPages(std::vector<u64> &hashes) const {
+	hashes.resize(pagePtrs_.size());
+	GlobalThreadPool::Loop([&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i)
+			hashes[i] = XXH3_64bits(pagePtrs_[i], PAGE_SIZE);
+	}, 0, (int)pagePtrs_.size());
+}
+
+void RewindMemory::Push() {
+	int numPages = (int)pagePtrs_.size();
+	if (!newestValid_) {
+		newest_.resize((size_t)numPages * PAGE_SIZE);
+		hashes_.resize(numPages);
+		GlobalThreadPool::Loop([&](int lower, int upper) {
+			for (int i = lower; i < upper; ++i) {
+				u8 *page = &newest_[(size_t)i * PAGE_SIZE];
+				memcpy(page, pagePtrs_[i], PAGE_SIZE);
+				hashes_[i] = XXH3_64bits(page, PAGE_SIZE);
+			}
+		}, 0, numPages);
+		newestValid_ = true;
+		deltas_.clear();
+		count_ = 1;
+		return;
+	}
+
+	std::vector<u64> hashes;
+	HashPages(hashes);
+	std::vector<u32> changed;
+	for (int i = 0; i < numPages; ++i) {
+		if (hashes[i] != hashes_[i])
+			changed.push_back(i);
+	}
+
+	// The snapshot that's now second newest needs the pages we're about to overwrite.
+	if (count_ > 0) {
+		deltas_.push_back(Delta());
+		CompressNewestPages(deltas_.back(), changed);
+	}
+
+	// Hash what we copied, in case something wrote to a page after we hashed it.
+	GlobalThreadPool::Loop([&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i) {
+			u8 *page = &newest_[(size_t)changed[i] * PAGE_SIZE];
+			memcpy(page, pagePtrs_[changed[i]], PAGE_SIZE);
+			hashes_[changed[i]] = XXH3_64bits(page, PAGE_SIZE);
+		}
+	}, 0, (int)changed.size());
+
+	if (++count_ > maxSnapshots_)
+		DropOldest();
+}
+
+bool RewindMemory::Pop(bool restore) {
+	if (count_ == 0)
+		return false;
+
+	if (restore) {
+		GlobalThreadPool::Loop([&](int lower, int upper) {
+			for (int i = lower; i < upper; ++i)
+				memcpy(pagePtrs_[i], &newest_[(size_t)i * PAGE_SIZE], PAGE_SIZE);
+		}, 0, (int)pagePtrs_.size());
+	}
+
+	--count_;
+	if (count_ == 0)
+		return true;
+
+	// Step the newest back to the snapshot before it.
+	bool success = ApplyToNewest(deltas_.back());
+	deltas_.pop_back();
+	if (!success) {
+		ERROR_LOG(SAVESTATE, "Rewind: Failed to decompress memory, dropping older snapshots");
+		Clear();
+	}
+	return true;
+}
+
+void RewindMemory::DropOldest() {
+	if (count_ == 0)
+		return;
+	if (!deltas_.empty())
+		deltas_.pop_front();
+	--count_;
+}
+
+void RewindMemory::Clear() {
+	count_ = 0;
+	deltas_.clear();
+	newestValid_ = false;
+	newest_.clear();
+	newest_.shrink_to_fit();
+	hashes_.clear();
+}
+
+size_t RewindMemory::DeltaBytes() const {
+	size_t total = 0;
+	for (const Delta &delta : deltas_)
+		total += delta.data.size() + delta.pages.size() * sizeof(u32) + delta.offsets.size() * sizeof(u32);
+	return total;
+}
+
+void RewindMemory::CompressNewestPages(Delta &delta, const std::vector<u32> &pages) const {
+	// Compress into a slot per page in parallel, then pack them.
+	const size_t slotSize = snappy_max_compressed_length(PAGE_SIZE);
+	std::vector<u8> slots(pages.size() * slotSize);
+	std::vector<u32> sizes(pages.size());
+	GlobalThreadPool::Loop([&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i) {
+			const u8 *page = &newest_[(size_t)pages[i] * PAGE_SIZE];
+			u8 *slot = &slots[(size_t)i * slotSize];
+			size_t size = slotSize;
+			if (snappy_compress((const char *)page, PAGE_SIZE, (char *)slot, &size) != SNAPPY_OK || size >= PAGE_SIZE) {
+				memcpy(slot, page, PAGE_SIZE);
+				size = PAGE_SIZE;
+			}
+			sizes[i] = (u32)size;
+		}
+	}, 0, (int)pages.size());
+
+	size_t total = 0;
+	for (u32 size : sizes)
+		total += size;
+	delta.pages = pages;
+	delta.offsets.resize(pages.size() + 1);
+	delta.data.resize(total);
+	u32 offset = 0;
+	for (size_t i = 0; i < pages.size(); ++i) {
+		delta.offsets[i] = offset;
+		memcpy(&delta.data[offset], &slots[i * slotSize], sizes[i]);
+		offset += sizes[i];
+	}
+	delta.offsets[pages.size()] = offset;
+}
+
+bool RewindMemory::ApplyToNewest(const Delta &delta) {
+	std::vector<u8> failed(delta.pages.size());
+	GlobalThreadPool::Loop([&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i) {
+			u8 *page = &newest_[(size_t)delta.pages[i] * PAGE_SIZE];
+			const u8 *src = &delta.data[delta.offsets[i]];
+			size_t srcSize = delta.offsets[i + 1] - delta.offsets[i];
+			size_t size = PAGE_SIZE;
+			if (srcSize == PAGE_SIZE)
+				memcpy(page, src, PAGE_SIZE);
+			else if (snappy_uncompress((const char *)src, srcSize, (char *)page, &size) != SNAPPY_OK || size != PAGE_SIZE)
+				failed[i] = 1;
+			hashes_[delta.pages[i]] = XXH3_64bits(page, PAGE_SIZE);
+		}
+	}, 0, (int)delta.pages.size());
+
+	for (u8 f : failed) {
+		if (f)
+			return false;
+	}
+	return true;
+}
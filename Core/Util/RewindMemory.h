@@ -0,0 +1,85 @@
+// Copyright (c) 2012- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// A stack of snapshots of some memory regions, for rewind.
+// Only the newest snapshot is kept whole.  Each older one is kept as the pages that differ
+// from the snapshot after it, compressed, so the oldest can be dropped without touching the rest.
+class RewindMemory
+{
+public:
+	static const u32 PAGE_SIZE = 0x1000;
+
+	struct Region
+	{
+		u8 *ptr;
+		// Must be a multiple of PAGE_SIZE.
+		u32 size;
+	};
+
+	RewindMemory(int maxSnapshots);
+
+	// Drops all snapshots if the sizes changed.
+	void SetRegions(const std::vector<Region> &regions);
+
+	// Adds the regions as the newest snapshot, dropping the oldest past maxSnapshots.
+	void Push();
+	// Drops the newest snapshot, after copying it back into the regions if restore is set.
+	bool Pop(bool restore);
+	void DropOldest();
+	void Clear();
+
+	int Count() const {
+		return count_;
+	}
+	// What the older snapshots take up.
+	size_t DeltaBytes() const;
+
+private:
+	// The pages that change between a snapshot and the one after it, as they were before.
+	struct Delta
+	{
+		std::vector<u32> pages;
+		// Where each page starts in data, and where the last one ends.  A page PAGE_SIZE long is uncompressed.
+		std::vector<u32> offsets;
+		std::vector<u8> data;
+	};
+
+	void HashPages(std::vector<u64> &hashes) const;
+	void CompressNewestPages(Delta &delta, const std::vector<u32> &pages) const;
+	bool ApplyToNewest(const Delta &delta);
+
+	int maxSnapshots_;
+	int count_ = 0;
+
+	std::vector<u32> regionSizes_;
+	std::vector<u8 *> pagePtrs_;
+
+	// The newest snapshot, and the hash of each of its pages.  Kept when the last snapshot is
+	// dropped, so the next one can still only copy what changed.
+	std::vector<u8> newest_;
+	std::vector<u64> hashes_;
+	bool newestValid_ = false;
+	// For each snapshot but the newest, oldest first.
+	std::deque<Delta> deltas_;
+};
@@ -62,41 +62,6 @@ void IndexGenerator::AddPrim(int prim, int vertexCount, bool clockwise) {
 	}
 }
 
-void IndexGenerator::AddPoints(int numVerts) {
-	u16 *outInds = inds_;
-	const int startIndex = index_;
-	for (int i = 0; i < numVerts; i++)
-		*outInds++ = startIndex + i;
-	inds_ = outInds;
-	// ignore overflow verts
-	index_ += numVerts;
-	count_ += numVerts;
-	prim_ = GE_PRIM_POINTS;
-	seenPrims_ |= 1 << GE_PRIM_POINTS;
-}
-
-void IndexGenerator::AddList(int numVerts, bool clockwise) {
-	u16 *outInds = inds_;
-	const int startIndex = index_;
-	const int v1 = clockwise ? 1 : 2;
-	const int v2 = clockwise ? 2 : 1;
-	for (int i = 0; i < numVerts; i += 3) {
-		*outInds++ = startIndex + i;
-		*outInds++ = startIndex + i + v1;
-		*outInds++ = startIndex + i + v2;
-	}
-	inds_ = outInds;
-	// ignore overflow verts
-	index_ += numVerts;
-	count_ += numVerts;
-	prim_ = GE_PRIM_TRIANGLES;
-	seenPrims_ |= 1 << GE_PRIM_TRIANGLES;
-	if (!clockwise) {
-		// Make sure we don't treat this as pure.
-		seenPrims_ |= 1 << GE_PRIM_TRIANGLE_STRIP;
-	}
-}
-
 alignas(16) static const u16 offsets_clockwise[24] = {
 	0, (u16)(0 + 1), (u16)(0 + 2),
 	1, (u16)(1 + 2), (u16)(1 + 1),
@@ -119,75 +84,174 @@ alignas(16) static const uint16_t offsets_counter_clockwise[24] = {
 	7, (u16)(7 + 1), (u16)(7 + 2),
 };
 
-void IndexGenerator::AddStrip(int numVerts, bool clockwise) {
-	int numTris = numVerts - 2;
+// Plain runs of indices: points, lines, rectangles and clockwise triangle lists.
+alignas(16) static const u16 offsets_sequence[24] = {
+	0, 1, 2, 3, 4, 5, 6, 7,
+	8, 9, 10, 11, 12, 13, 14, 15,
+	16, 17, 18, 19, 20, 21, 22, 23,
+};
 
-#ifdef _M_SSE
-	// In an SSE2 register we can fit 8 16-bit integers.
-	// However, we need to output a multiple of 3 indices.
-	// The first such multiple is 24, which means we'll generate 24 indices per cycle,
-	// which corresponds to 8 triangles. That's pretty cool.
+alignas(16) static const u16 offsets_list_counter_clockwise[24] = {
+	0, 2, 1,
+	3, 5, 4,
+	6, 8, 7,
+	9, 11, 10,
+	12, 14, 13,
+	15, 17, 16,
+	18, 20, 19,
+	21, 23, 22,
+};
 
-	// We allow ourselves to write some extra indices to avoid the fallback loop.
-	// That's alright as we're appending to a buffer - they will get overwritten anyway.
-	int numChunks = (numTris + 7) / 8;
-	__m128i ibase8 = _mm_set1_epi16(index_);
-	__m128i increment = _mm_set1_epi16(8);
-	const __m128i *offsets = (const __m128i *)(clockwise ? offsets_clockwise : offsets_counter_clockwise);
-	__m128i offsets0 = _mm_load_si128(offsets);
-	__m128i offsets1 = _mm_load_si128(offsets + 1);
-	__m128i offsets2 = _mm_load_si128(offsets + 2);
-	__m128i *dst = (__m128i *)inds_;
+alignas(16) static const u16 offsets_line_strip[24] = {
+	0, 1, 1, 2, 2, 3, 3, 4,
+	4, 5, 5, 6, 6, 7, 7, 8,
+	8, 9, 9, 10, 10, 11, 11, 12,
+};
+
+// The first index of each fan triangle is always the center, so that one doesn't advance.
+alignas(16) static const u16 offsets_fan_clockwise[24] = {
+	0, 1, 2,
+	0, 2, 3,
+	0, 3, 4,
+	0, 4, 5,
+	0, 5, 6,
+	0, 6, 7,
+	0, 7, 8,
+	0, 8, 9,
+};
+
+alignas(16) static const u16 offsets_fan_counter_clockwise[24] = {
+	0, 2, 1,
+	0, 3, 2,
+	0, 4, 3,
+	0, 5, 4,
+	0, 6, 5,
+	0, 7, 6,
+	0, 8, 7,
+	0, 9, 8,
+};
+
+alignas(16) static const u16 increments_8[24] = {
+	8, 8, 8, 8, 8, 8, 8, 8,
+	8, 8, 8, 8, 8, 8, 8, 8,
+	8, 8, 8, 8, 8, 8, 8, 8,
+};
+
+alignas(16) static const u16 increments_12[24] = {
+	12, 12, 12, 12, 12, 12, 12, 12,
+	12, 12, 12, 12, 12, 12, 12, 12,
+	12, 12, 12, 12, 12, 12, 12, 12,
+};
+
+alignas(16) static const u16 increments_24[24] = {
+	24, 24, 24, 24, 24, 24, 24, 24,
+	24, 24, 24, 24, 24, 24, 24, 24,
+	24, 24, 24, 24, 24, 24, 24, 24,
+};
+
+alignas(16) static const u16 increments_fan[24] = {
+	0, 8, 8,
+	0, 8, 8,
+	0, 8, 8,
+	0, 8, 8,
+	0, 8, 8,
+	0, 8, 8,
+	0, 8, 8,
+	0, 8, 8,
+};
+
+// Writes numChunks runs of 24 indices, base + offsets, adding increments to the offsets after each run.
+// In an SSE2 register we can fit 8 16-bit integers, and 24 is the first multiple of 3 (for triangles)
+// that fills them, so the tables above are 8 triangles, 12 lines or 24 points long.
+// We allow ourselves to write some extra indices to avoid a fallback loop.
+// That's alright as we're appending to a buffer - they will get overwritten anyway.
+static void GenerateIndexChunks(u16 *dst, int base, const u16 *offsets, const u16 *increments, int numChunks) {
+#ifdef _M_SSE
+	__m128i ibase = _mm_set1_epi16(base);
+	__m128i inds0 = _mm_add_epi16(ibase, _mm_load_si128((const __m128i *)offsets));
+	__m128i inds1 = _mm_add_epi16(ibase, _mm_load_si128((const __m128i *)offsets + 1));
+	__m128i inds2 = _mm_add_epi16(ibase, _mm_load_si128((const __m128i *)offsets + 2));
+	__m128i increment0 = _mm_load_si128((const __m128i *)increments);
+	__m128i increment1 = _mm_load_si128((const __m128i *)increments + 1);
+	__m128i increment2 = _mm_load_si128((const __m128i *)increments + 2);
+	__m128i *dst128 = (__m128i *)dst;
 	for (int i = 0; i < numChunks; i++) {
-		_mm_storeu_si128(dst, _mm_add_epi16(ibase8, offsets0));
-		_mm_storeu_si128(dst + 1, _mm_add_epi16(ibase8, offsets1));
-		_mm_storeu_si128(dst + 2, _mm_add_epi16(ibase8, offsets2));
-		ibase8 = _mm_add_epi16(ibase8, increment);
-		dst += 3;
+		_mm_storeu_si128(dst128, inds0);
+		_mm_storeu_si128(dst128 + 1, inds1);
+		_mm_storeu_si128(dst128 + 2, inds2);
+		inds0 = _mm_add_epi16(inds0, increment0);
+		inds1 = _mm_add_epi16(inds1, increment1);
+		inds2 = _mm_add_epi16(inds2, increment2);
+		dst128 += 3;
 	}
-	inds_ += numTris * 3;
-	// wind doesn't need to be updated, an even number of triangles have been drawn.
 #elif PPSSPP_ARCH(ARM_NEON)
-	int numChunks = (numTris + 7) / 8;
-	uint16x8_t ibase8 = vdupq_n_u16(index_);
-	uint16x8_t increment = vdupq_n_u16(8);
-	const u16 *offsets = clockwise ? offsets_clockwise : offsets_counter_clockwise;
-	uint16x8_t offsets0 = vld1q_u16(offsets);
-	uint16x8_t offsets1 = vld1q_u16(offsets + 8);
-	uint16x8_t offsets2 = vld1q_u16(offsets + 16);
-	u16 *dst = inds_;
+	uint16x8_t ibase = vdupq_n_u16(base);
+	uint16x8_t inds0 = vaddq_u16(ibase, vld1q_u16(offsets));
+	uint16x8_t inds1 = vaddq_u16(ibase, vld1q_u16(offsets + 8));
+	uint16x8_t inds2 = vaddq_u16(ibase, vld1q_u16(offsets + 16));
+	uint16x8_t increment0 = vld1q_u16(increments);
+	uint16x8_t increment1 = vld1q_u16(increments + 8);
+	uint16x8_t increment2 = vld1q_u16(increments + 16);
 	for (int i = 0; i < numChunks; i++) {
-		vst1q_u16(dst, vaddq_u16(ibase8, offsets0));
-		vst1q_u16(dst + 8, vaddq_u16(ibase8, offsets1));
-		vst1q_u16(dst + 16, vaddq_u16(ibase8, offsets2));
-		ibase8 = vaddq_u16(ibase8, increment);
+		vst1q_u16(dst, inds0);
+		vst1q_u16(dst + 8, inds1);
+		vst1q_u16(dst + 16, inds2);
+		inds0 = vaddq_u16(inds0, increment0);
+		inds1 = vaddq_u16(inds1, increment1);
+		inds2 = vaddq_u16(inds2, increment2);
 		dst += 3 * 8;
 	}
-	inds_ += numTris * 3;
 #else
-	// Slow fallback loop.
-	int wind = clockwise ? 1 : 2;
-	int ibase = index_;
-	size_t numPairs = numTris / 2;
-	u16 *outInds = inds_;
-	while (numPairs > 0) {
-		*outInds++ = ibase;
-		*outInds++ = ibase + wind;
-		*outInds++ = ibase + (wind ^ 3);
-		*outInds++ = ibase + 1;
-		*outInds++ = ibase + 1 + (wind ^ 3);
-		*outInds++ = ibase + 1 + wind;
-		ibase += 2;
-		numPairs--;
-	}
-	if (numTris & 1) {
-		*outInds++ = ibase;
-		*outInds++ = ibase + wind;
-		wind ^= 3;  // toggle between 1 and 2
-		*outInds++ = ibase + wind;
+	u16 inds[24];
+	for (int j = 0; j < 24; j++)
+		inds[j] = base + offsets[j];
+	for (int i = 0; i < numChunks; i++) {
+		for (int j = 0; j < 24; j++) {
+			*dst++ = inds[j];
+			inds[j] += increments[j];
+		}
 	}
-	inds_ = outInds;
 #endif
+}
+
+void IndexGenerator::AddPoints(int numVerts) {
+	if (numVerts > 0) {
+		GenerateIndexChunks(inds_, index_, offsets_sequence, increments_24, (numVerts + 23) / 24);
+		inds_ += numVerts;
+	}
+	// ignore overflow verts
+	index_ += numVerts;
+	count_ += numVerts;
+	prim_ = GE_PRIM_POINTS;
+	seenPrims_ |= 1 << GE_PRIM_POINTS;
+}
+
+void IndexGenerator::AddList(int numVerts, bool clockwise) {
+	// A partial triangle at the end still gets all three indices.
+	const int numTris = (numVerts + 2) / 3;
+	if (numTris > 0) {
+		GenerateIndexChunks(inds_, index_, clockwise ? offsets_sequence : offsets_list_counter_clockwise, increments_24, (numTris + 7) / 8);
+		inds_ += numTris * 3;
+	}
+	// ignore overflow verts
+	index_ += numVerts;
+	count_ += numVerts;
+	prim_ = GE_PRIM_TRIANGLES;
+	seenPrims_ |= 1 << GE_PRIM_TRIANGLES;
+	if (!clockwise) {
+		// Make sure we don't treat this as pure.
+		seenPrims_ |= 1 << GE_PRIM_TRIANGLE_STRIP;
+	}
+}
+
+void IndexGenerator::AddStrip(int numVerts, bool clockwise) {
+	int numTris = numVerts - 2;
+
+	// This generates 24 indices per chunk, which corresponds to 8 triangles. That's pretty cool.
+	int numChunks = (numTris + 7) / 8;
+	GenerateIndexChunks(inds_, index_, clockwise ? offsets_clockwise : offsets_counter_clockwise, increments_8, numChunks);
+	inds_ += numTris * 3;
+	// wind doesn't need to be updated, an even number of triangles have been drawn.
 
 	index_ += numVerts;
 	if (numTris > 0)
@@ -206,16 +270,10 @@ void IndexGenerator::AddStrip(int numVerts, bool clockwise) {
 
 void IndexGenerator::AddFan(int numVerts, bool clockwise) {
 	const int numTris = numVerts - 2;
-	u16 *outInds = inds_;
-	const int startIndex = index_;
-	const int v1 = clockwise ? 1 : 2;
-	const int v2 = clockwise ? 2 : 1;
-	for (int i = 0; i < numTris; i++) {
-		*outInds++ = startIndex;
-		*outInds++ = startIndex + i + v1;
-		*outInds++ = startIndex + i + v2;
+	if (numTris > 0) {
+		GenerateIndexChunks(inds_, index_, clockwise ? offsets_fan_clockwise : offsets_fan_counter_clockwise, increments_fan, (numTris + 7) / 8);
+		inds_ += numTris * 3;
 	}
-	inds_ = outInds;
 	index_ += numVerts;
 	count_ += numTris * 3;
 	prim_ = GE_PRIM_TRIANGLES;
@@ -228,13 +286,12 @@ void IndexGenerator::AddFan(int numVerts, bool clockwise) {
 
 //Lines
 void IndexGenerator::AddLineList(int numVerts) {
-	u16 *outInds = inds_;
-	const int startIndex = index_;
-	for (int i = 0; i < numVerts; i += 2) {
-		*outInds++ = startIndex + i;
-		*outInds++ = startIndex + i + 1;
+	// A partial line at the end still gets both indices.
+	const int numInds = (numVerts + 1) & ~1;
+	if (numInds > 0) {
+		GenerateIndexChunks(inds_, index_, offsets_sequence, increments_24, (numInds + 23) / 24);
+		inds_ += numInds;
 	}
-	inds_ = outInds;
 	index_ += numVerts;
 	count_ += numVerts;
 	prim_ = GE_PRIM_LINES;
@@ -243,13 +300,10 @@ void IndexGenerator::AddLineList(int numVerts) {
 
 void IndexGenerator::AddLineStrip(int numVerts) {
 	const int numLines = numVerts - 1;
-	u16 *outInds = inds_;
-	const int startIndex = index_;
-	for (int i = 0; i < numLines; i++) {
-		*outInds++ = startIndex + i;
-		*outInds++ = startIndex + i + 1;
+	if (numLines > 0) {
+		GenerateIndexChunks(inds_, index_, offsets_line_strip, increments_12, (numLines + 11) / 12);
+		inds_ += numLines * 2;
 	}
-	inds_ = outInds;
 	index_ += numVerts;
 	count_ += numLines * 2;
 	prim_ = GE_PRIM_LINES;
@@ -257,28 +311,73 @@ void IndexGenerator::AddLineStrip(int numVerts) {
 }
 
 void IndexGenerator::AddRectangles(int numVerts) {
-	u16 *outInds = inds_;
-	const int startIndex = index_;
 	//rectangles always need 2 vertices, disregard the last one if there's an odd number
 	numVerts = numVerts & ~1;
-	for (int i = 0; i < numVerts; i += 2) {
-		*outInds++ = startIndex + i;
-		*outInds++ = startIndex + i + 1;
+	if (numVerts > 0) {
+		GenerateIndexChunks(inds_, index_, offsets_sequence, increments_24, (numVerts + 23) / 24);
+		inds_ += numVerts;
 	}
-	inds_ = outInds;
 	index_ += numVerts;
 	count_ += numVerts;
 	prim_ = GE_PRIM_RECTANGLES;
 	seenPrims_ |= 1 << GE_PRIM_RECTANGLES;
 }
 
+// Adds offset to each index. The 8-bit and 16-bit versions are the common ones, so they get SIMD.
+template <class ITypeLE>
+static inline void TranslateIndices(u16 *out, const ITypeLE *inds, int count, int offset) {
+	for (int i = 0; i < count; i++)
+		out[i] = offset + inds[i];
+}
+
+static inline void TranslateIndices(u16 *out, const u8 *inds, int count, int offset) {
+	int i = 0;
+#ifdef _M_SSE
+	const __m128i ioffset = _mm_set1_epi16(offset);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= count; i += 16) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(inds + i));
+		_mm_storeu_si128((__m128i *)(out + i), _mm_add_epi16(_mm_unpacklo_epi8(in, zero), ioffset));
+		_mm_storeu_si128((__m128i *)(out + i + 8), _mm_add_epi16(_mm_unpackhi_epi8(in, zero), ioffset));
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const uint16x8_t ioffset = vdupq_n_u16(offset);
+	for (; i + 16 <= count; i += 16) {
+		uint8x16_t in = vld1q_u8(inds + i);
+		vst1q_u16(out + i, vaddw_u8(ioffset, vget_low_u8(in)));
+		vst1q_u16(out + i + 8, vaddw_u8(ioffset, vget_high_u8(in)));
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = offset + inds[i];
+}
+
+static inline void TranslateIndices(u16 *out, const u16 *inds, int count, int offset) {
+	int i = 0;
+#ifdef _M_SSE
+	const __m128i ioffset = _mm_set1_epi16(offset);
+	for (; i + 16 <= count; i += 16) {
+		__m128i in0 = _mm_loadu_si128((const __m128i *)(inds + i));
+		__m128i in1 = _mm_loadu_si128((const __m128i *)(inds + i + 8));
+		_mm_storeu_si128((__m128i *)(out + i), _mm_add_epi16(in0, ioffset));
+		_mm_storeu_si128((__m128i *)(out + i + 8), _mm_add_epi16(in1, ioffset));
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const uint16x8_t ioffset = vdupq_n_u16(offset);
+	for (; i + 16 <= count; i += 16) {
+		vst1q_u16(out + i, vaddq_u16(vld1q_u16(inds + i), ioffset));
+		vst1q_u16(out + i + 8, vaddq_u16(vld1q_u16(inds + i + 8), ioffset));
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = offset + inds[i];
+}
+
 template <class ITypeLE, int flag>
 void IndexGenerator::TranslatePoints(int numInds, const ITypeLE *inds, int indexOffset) {
 	indexOffset = index_ - indexOffset;
-	u16 *outInds = inds_;
-	for (int i = 0; i < numInds; i++)
-		*outInds++ = indexOffset + inds[i];
-	inds_ = outInds;
+	TranslateIndices(inds_, inds, numInds, indexOffset);
+	inds_ += numInds;
 	count_ += numInds;
 	prim_ = GE_PRIM_POINTS;
 	seenPrims_ |= (1 << GE_PRIM_POINTS) | flag;
@@ -287,13 +386,9 @@ void IndexGenerator::TranslatePoints(int numInds, const ITypeLE *inds, int index
 template <class ITypeLE, int flag>
 void IndexGenerator::TranslateLineList(int numInds, const ITypeLE *inds, int indexOffset) {
 	indexOffset = index_ - indexOffset;
-	u16 *outInds = inds_;
 	numInds = numInds & ~1;
-	for (int i = 0; i < numInds; i += 2) {
-		*outInds++ = indexOffset + inds[i];
-		*outInds++ = indexOffset + inds[i + 1];
-	}
-	inds_ = outInds;
+	TranslateIndices(inds_, inds, numInds, indexOffset);
+	inds_ += numInds;
 	count_ += numInds;
 	prim_ = GE_PRIM_LINES;
 	seenPrims_ |= (1 << GE_PRIM_LINES) | flag;
@@ -304,9 +399,16 @@ void IndexGenerator::TranslateLineStrip(int numInds, const ITypeLE *inds, int in
 	indexOffset = index_ - indexOffset;
 	int numLines = numInds - 1;
 	u16 *outInds = inds_;
-	for (int i = 0; i < numLines; i++) {
-		*outInds++ = indexOffset + inds[i];
-		*outInds++ = indexOffset + inds[i + 1];
+	if (numLines > 0) {
+		// Each index after the first is the end of one line and the start of the next.
+		u16 prev = indexOffset + inds[0];
+		for (int i = 0; i < numLines; i++) {
+			u16 next = indexOffset + inds[i + 1];
+			outInds[0] = prev;
+			outInds[1] = next;
+			outInds += 2;
+			prev = next;
+		}
 	}
 	inds_ = outInds;
 	count_ += numLines * 2;
@@ -317,22 +419,24 @@ void IndexGenerator::TranslateLineStrip(int numInds, const ITypeLE *inds, int in
 template <class ITypeLE, int flag>
 void IndexGenerator::TranslateList(int numInds, const ITypeLE *inds, int indexOffset, bool clockwise) {
 	indexOffset = index_ - indexOffset;
+	int numTris = numInds / 3;  // Round to whole triangles
+	numInds = numTris * 3;
 	// We only bother doing this minor optimization in triangle list, since it's by far the most
 	// common operation that can benefit.
 	if (sizeof(ITypeLE) == sizeof(inds_[0]) && indexOffset == 0 && clockwise) {
 		memcpy(inds_, inds, numInds * sizeof(ITypeLE));
 		inds_ += numInds;
 		count_ += numInds;
+	} else if (clockwise) {
+		TranslateIndices(inds_, inds, numInds, indexOffset);
+		inds_ += numInds;
+		count_ += numInds;
 	} else {
 		u16 *outInds = inds_;
-		int numTris = numInds / 3;  // Round to whole triangles
-		numInds = numTris * 3;
-		const int v1 = clockwise ? 1 : 2;
-		const int v2 = clockwise ? 2 : 1;
 		for (int i = 0; i < numInds; i += 3) {
 			*outInds++ = indexOffset + inds[i];
-			*outInds++ = indexOffset + inds[i + v1];
-			*outInds++ = indexOffset + inds[i + v2];
+			*outInds++ = indexOffset + inds[i + 2];
+			*outInds++ = indexOffset + inds[i + 1];
 		}
 		inds_ = outInds;
 		count_ += numInds;
@@ -347,11 +451,22 @@ void IndexGenerator::TranslateStrip(int numInds, const ITypeLE *inds, int indexO
 	indexOffset = index_ - indexOffset;
 	int numTris = numInds - 2;
 	u16 *outInds = inds_;
-	for (int i = 0; i < numTris; i++) {
+	// Two triangles at a time, so the winding toggle becomes constant offsets.
+	const int other = wind ^ 3;
+	int i = 0;
+	for (; i + 1 < numTris; i += 2) {
+		outInds[0] = indexOffset + inds[i];
+		outInds[1] = indexOffset + inds[i + wind];
+		outInds[2] = indexOffset + inds[i + other];
+		outInds[3] = indexOffset + inds[i + 1];
+		outInds[4] = indexOffset + inds[i + 1 + other];
+		outInds[5] = indexOffset + inds[i + 1 + wind];
+		outInds += 6;
+	}
+	if (i < numTris) {
 		*outInds++ = indexOffset + inds[i];
 		*outInds++ = indexOffset + inds[i + wind];
-		wind ^= 3;  // Toggle between 1 and 2
-		*outInds++ = indexOffset + inds[i + wind];
+		*outInds++ = indexOffset + inds[i + other];
 	}
 	inds_ = outInds;
 	count_ += numTris * 3;
@@ -364,16 +479,19 @@ void IndexGenerator::TranslateFan(int numInds, const ITypeLE *inds, int indexOff
 	if (numInds <= 0) return;
 	indexOffset = index_ - indexOffset;
 	int numTris = numInds - 2;
-	u16 *outInds = inds_;
-	const int v1 = clockwise ? 1 : 2;
-	const int v2 = clockwise ? 2 : 1;
-	for (int i = 0; i < numTris; i++) {
-		*outInds++ = indexOffset + inds[0];
-		*outInds++ = indexOffset + inds[i + v1];
-		*outInds++ = indexOffset + inds[i + v2];
+	if (numTris > 0) {
+		u16 *outInds = inds_;
+		const int v1 = clockwise ? 1 : 2;
+		const int v2 = clockwise ? 2 : 1;
+		const u16 center = indexOffset + inds[0];
+		for (int i = 0; i < numTris; i++) {
+			*outInds++ = center;
+			*outInds++ = indexOffset + inds[i + v1];
+			*outInds++ = indexOffset + inds[i + v2];
+		}
+		inds_ = outInds;
+		count_ += numTris * 3;
 	}
-	inds_ = outInds;
-	count_ += numTris * 3;
 	prim_ = GE_PRIM_TRIANGLES;
 	seenPrims_ |= (1 << GE_PRIM_TRIANGLE_FAN) | flag;
 }
@@ -381,14 +499,10 @@ void IndexGenerator::TranslateFan(int numInds, const ITypeLE *inds, int indexOff
 template <class ITypeLE, int flag>
 inline void IndexGenerator::TranslateRectangles(int numInds, const ITypeLE *inds, int indexOffset) {
 	indexOffset = index_ - indexOffset;
-	u16 *outInds = inds_;
 	//rectangles always need 2 vertices, disregard the last one if there's an odd number
 	numInds = numInds & ~1;
-	for (int i = 0; i < numInds; i += 2) {
-		*outInds++ = indexOffset + inds[i];
-		*outInds++ = indexOffset + inds[i+1];
-	}
-	inds_ = outInds;
+	TranslateIndices(inds_, inds, numInds, indexOffset);
+	inds_ += numInds;
 	count_ += numInds;
 	prim_ = GE_PRIM_RECTANGLES;
 	seenPrims_ |= (1 << GE_PRIM_RECTANGLES) | flag;
@@ -156,6 +156,234 @@ static int ColorIndexOffset(int prim, GEShadeMode shadeMode, bool clearMode) {
 	return 0;
 }
 
+// Helpers for the batched transform, one lane per vertex.
+static inline void TransformLanes43(Lanes4f out[3], const Lanes4f in[3], const float m[12], bool translate) {
+	for (int i = 0; i < 3; i++) {
+		out[i] = in[0] * Lanes4f(m[i]) + in[1] * Lanes4f(m[3 + i]) + in[2] * Lanes4f(m[6 + i]);
+		if (translate)
+			out[i] = out[i] + Lanes4f(m[9 + i]);
+	}
+}
+
+static inline void NormalizeLanes(Lanes4f v[3]) {
+	Lanes4f norm = Lanes4f::NormalizeMultiplier(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	for (int i = 0; i < 3; i++)
+		v[i] = v[i] * norm;
+}
+
+static Vec3f ShadingLightPos(int l) {
+	Vec3f pos(getFloat24(gstate.lpos[l * 3]), getFloat24(gstate.lpos[l * 3 + 1]), getFloat24(gstate.lpos[l * 3 + 2]));
+	if (pos.Length2() == 0.0f)
+		return Vec3f(0.0f, 0.0f, 1.0f);
+	return pos.Normalized();
+}
+
+// Same results as the per-vertex loop in Decode(), but the transforms, lighting, UV generation and
+// fog run on LightingBatch::LANES vertices at a time.  Reading and skinning stay per vertex.
+static void TransformBatched(VertexReader &reader, TransformedVertex *transformed, int maxIndex, u32 vertType, int provokeIndOffset, Lighter &lighter, float widthFactor, float heightFactor, float fog_end, float fog_slope) {
+	const int LANES = LightingBatch::LANES;
+	const bool skinningEnabled = vertTypeIsSkinningEnabled(vertType);
+	const int numBoneWeights = vertTypeGetNumBoneWeights(vertType);
+	const bool hasNormal = reader.hasNormal();
+	const bool reverseNormals = gstate.areNormalsReversed();
+	const bool lighting = gstate.isLightingEnabled();
+	const bool lmode = gstate.isUsingSecondaryColor() && lighting;
+	const GETexMapMode uvGenMode = gstate.getUVGenMode();
+	const GETexProjMapMode uvProjMode = gstate.getUVProjMode();
+	const u32 materialAmbientRGBA = gstate.getMaterialAmbientRGBA();
+
+	if (uvGenMode == GE_TEXMAP_TEXTURE_MATRIX && (uvProjMode == GE_PROJMAP_NORMALIZED_NORMAL || uvProjMode == GE_PROJMAP_NORMAL) && !hasNormal) {
+		ERROR_LOG_REPORT(G3D, "Normal projection mapping without normal?");
+	} else if (uvGenMode != GE_TEXMAP_TEXTURE_COORDS && uvGenMode != GE_TEXMAP_UNKNOWN && uvGenMode != GE_TEXMAP_TEXTURE_MATRIX && uvGenMode != GE_TEXMAP_ENVIRONMENT_MAP) {
+		ERROR_LOG_REPORT(G3D, "Impossible UV gen mode? %d", uvGenMode);
+	}
+
+	Vec3f lightpos0(0.0f, 0.0f, 1.0f);
+	Vec3f lightpos1(0.0f, 0.0f, 1.0f);
+	if (uvGenMode == GE_TEXMAP_ENVIRONMENT_MAP) {
+		// Might not have lighting enabled, so don't use lighter.
+		lightpos0 = ShadingLightPos(gstate.getUVLS0());
+		lightpos1 = ShadingLightPos(gstate.getUVLS1());
+	}
+
+	LightingBatch batch;
+	alignas(16) float modelPos[3][LANES];
+	alignas(16) float ruv[2][LANES];
+
+	for (int start = 0; start < maxIndex; start += LANES) {
+		const int count = std::min(LANES, maxIndex - start);
+
+		// Read the vertices into lanes.  Unused lanes repeat the last vertex, and are not written back.
+		for (int lane = 0; lane < LANES; lane++) {
+			int index = start + std::min(lane, count - 1);
+			reader.Goto(index);
+
+			float pos[3];
+			reader.ReadPos(pos);
+
+			float uv[2] = { 0.0f, 0.0f };
+			if (reader.hasUV())
+				reader.ReadUV(uv);
+
+			// Read all the provoking vertex values here.
+			Vec4f unlitColor;
+			Vec3f normal(0, 0, 1);
+			if (provokeIndOffset != 0 && index + provokeIndOffset < maxIndex)
+				reader.Goto(index + provokeIndOffset);
+			if (reader.hasColor0())
+				reader.ReadColor0(unlitColor.AsArray());
+			else
+				unlitColor = Vec4f::FromRGBA(materialAmbientRGBA);
+			if (hasNormal)
+				reader.ReadNrm(normal.AsArray());
+
+			float skinnedPos[3] = { pos[0], pos[1], pos[2] };
+			if (skinningEnabled) {
+				float weights[8];
+				reader.Goto(index);
+				reader.ReadWeights(weights);
+
+				Vec3f psum(0, 0, 0);
+				Vec3f nsum(0, 0, 0);
+				for (int i = 0; i < numBoneWeights; i++) {
+					if (weights[i] != 0.0f) {
+						float out[3];
+						Vec3ByMatrix43(out, pos, gstate.boneMatrix + i * 12);
+						psum += Vec3f(out) * weights[i];
+						if (hasNormal) {
+							Vec3f norm;
+							Norm3ByMatrix43(norm.AsArray(), normal.AsArray(), gstate.boneMatrix + i * 12);
+							nsum += norm * weights[i];
+						}
+					}
+				}
+				memcpy(skinnedPos, psum.AsArray(), sizeof(skinnedPos));
+				if (hasNormal)
+					normal = nsum;
+			}
+			if (hasNormal && reverseNormals)
+				normal = -normal;
+
+			for (int i = 0; i < 3; i++) {
+				modelPos[i][lane] = pos[i];
+				batch.pos[i][lane] = skinnedPos[i];
+				batch.normal[i][lane] = normal[i];
+			}
+			for (int i = 0; i < 4; i++)
+				batch.colorIn[i][lane] = unlitColor[i];
+			ruv[0][lane] = uv[0];
+			ruv[1][lane] = uv[1];
+		}
+
+		Lanes4f pos[3], normal[3], out[3], worldnormal[3];
+		for (int i = 0; i < 3; i++) {
+			pos[i] = Lanes4f::Load(batch.pos[i]);
+			normal[i] = Lanes4f::Load(batch.normal[i]);
+		}
+
+		TransformLanes43(out, pos, gstate.worldMatrix, true);
+		if (hasNormal) {
+			TransformLanes43(worldnormal, normal, gstate.worldMatrix, false);
+			NormalizeLanes(worldnormal);
+		} else {
+			worldnormal[0] = Lanes4f(0.0f);
+			worldnormal[1] = Lanes4f(0.0f);
+			worldnormal[2] = Lanes4f(1.0f);
+		}
+
+		alignas(16) float c0[4][LANES];
+		alignas(16) float c1[4][LANES];
+		if (lighting) {
+			for (int i = 0; i < 3; i++) {
+				out[i].Store(batch.pos[i]);
+				worldnormal[i].Store(batch.normal[i]);
+			}
+			lighter.LightBatch(batch);
+			for (int i = 0; i < 4; i++) {
+				Lanes4f lit0 = Lanes4f::Load(batch.colorOut0[i]);
+				Lanes4f lit1 = Lanes4f::Load(batch.colorOut1[i]);
+				if (lmode) {
+					// Separate colors
+					lit0.Store(c0[i]);
+					lit1.Store(c1[i]);
+				} else {
+					// Summed color into c0 (will clamp in ToRGBA().)
+					(lit0 + lit1).Store(c0[i]);
+					Lanes4f(0.0f).Store(c1[i]);
+				}
+			}
+		} else {
+			memcpy(c0, batch.colorIn, sizeof(c0));
+			memset(c1, 0, sizeof(c1));
+		}
+
+		// Perform texture coordinate generation after the transform and lighting - one style of UV depends on lights.
+		Lanes4f uv[3] = { Lanes4f::Load(ruv[0]), Lanes4f::Load(ruv[1]), Lanes4f(1.0f) };
+		if (uvGenMode == GE_TEXMAP_TEXTURE_MATRIX) {
+			Lanes4f source[3];
+			switch (uvProjMode) {
+			case GE_PROJMAP_POSITION: // Use model space XYZ as source
+				for (int i = 0; i < 3; i++)
+					source[i] = Lanes4f::Load(modelPos[i]);
+				break;
+
+			case GE_PROJMAP_UV: // Use unscaled UV as source
+				source[0] = uv[0];
+				source[1] = uv[1];
+				source[2] = Lanes4f(0.0f);
+				break;
+
+			case GE_PROJMAP_NORMALIZED_NORMAL: // Use normalized normal as source
+				for (int i = 0; i < 3; i++)
+					source[i] = normal[i];
+				NormalizeLanes(source);
+				break;
+
+			case GE_PROJMAP_NORMAL: // Use non-normalized normal as source!
+				for (int i = 0; i < 3; i++)
+					source[i] = normal[i];
+				break;
+			}
+			TransformLanes43(uv, source, gstate.tgenMatrix, true);
+		} else if (uvGenMode == GE_TEXMAP_ENVIRONMENT_MAP) {
+			// Shade mapping - use two light sources to generate U and V.
+			const Lanes4f half(0.5f);
+			uv[0] = (Lanes4f(1.0f) + worldnormal[0] * Lanes4f(lightpos0.x) + worldnormal[1] * Lanes4f(lightpos0.y) + worldnormal[2] * Lanes4f(lightpos0.z)) * half;
+			uv[1] = (Lanes4f(1.0f) + worldnormal[0] * Lanes4f(lightpos1.x) + worldnormal[1] * Lanes4f(lightpos1.y) + worldnormal[2] * Lanes4f(lightpos1.z)) * half;
+			uv[2] = Lanes4f(1.0f);
+		}
+		uv[0] = uv[0] * Lanes4f(widthFactor);
+		uv[1] = uv[1] * Lanes4f(heightFactor);
+
+		// Transform the coord by the view matrix.
+		Lanes4f v[3];
+		TransformLanes43(v, out, gstate.viewMatrix, true);
+		Lanes4f fogCoef = (v[2] + Lanes4f(fog_end)) * Lanes4f(fog_slope);
+
+		alignas(16) float vOut[3][LANES];
+		alignas(16) float uvOut[3][LANES];
+		alignas(16) float fogOut[LANES];
+		for (int i = 0; i < 3; i++) {
+			v[i].Store(vOut[i]);
+			uv[i].Store(uvOut[i]);
+		}
+		fogCoef.Store(fogOut);
+
+		for (int lane = 0; lane < count; lane++) {
+			TransformedVertex &vert = transformed[start + lane];
+			vert.x = vOut[0][lane];
+			vert.y = vOut[1][lane];
+			vert.z = vOut[2][lane];
+			vert.fog = fogOut[lane];
+			vert.u = uvOut[0][lane];
+			vert.v = uvOut[1][lane];
+			vert.w = uvOut[2][lane];
+			vert.color0_32 = Vec4f(c0[0][lane], c0[1][lane], c0[2][lane], c0[3][lane]).ToRGBA();
+			vert.color1_32 = Vec4f(c1[0][lane], c1[1][lane], c1[2][lane], c1[3][lane]).ToRGBA();
+		}
+	}
+}
+
 void SoftwareTransform::Decode(int prim, u32 vertType, const DecVtxFormat &decVtxFormat, int maxIndex, SoftwareTransformResult *result) {
 	u8 *decoded = params_.decoded;
 	TransformedVertex *transformed = params_.transformed;
@@ -227,6 +455,8 @@ void SoftwareTransform::Decode(int prim, u32 vertType, const DecVtxFormat &decVt
 			// Ignore color1 and fog, never used in throughmode anyway.
 			// The w of uv is also never used (hardcoded to 1.0.)
 		}
+	} else if (!params_.perVertexTransform) {
+		TransformBatched(reader, transformed, maxIndex, vertType, provokeIndOffset, lighter, widthFactor, heightFactor, fog_end, fog_slope);
 	} else {
 		// Okay, need to actually perform the full transform.
 		for (int index = 0; index < maxIndex; index++) {
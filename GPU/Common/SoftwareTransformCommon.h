@@ -56,6 +56,8 @@ struct SoftwareTransformParams {
 	bool allowClear;
 	bool allowSeparateAlphaClear;
 	bool provokeFlatFirst;
+	// Use the per-vertex reference transform instead of the batched one.
+	bool perVertexTransform;
 };
 
 class SoftwareTransform {
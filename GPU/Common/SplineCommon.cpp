@@ -17,14 +17,19 @@
 
 #include <string.h>
 #include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "Common/Profiler/Profiler.h"
 
-#include "Common/CPUDetect.h"
+#include "Core/ThreadPools.h"
+#include "ext/xxhash.h"
 
 #include "GPU/Common/GPUStateUtils.h"
 #include "GPU/Common/SplineCommon.h"
 #include "GPU/Common/DrawEngineCommon.h"
+#include "GPU/Common/TransformCommon.h"
 #include "GPU/ge_constants.h"
 #include "GPU/GPUState.h"  // only needed for UVScale stuff
 
@@ -315,6 +320,20 @@ class Tessellator {
 
 		return Sample(u, weights);
 	}
+
+	// Component c of SampleV() for several V weights at once, one per lane.
+	// edges[0] and edges[1] mask the lanes where weights[0] or weights[3] is 1, which take the edge point as is, like SampleV().
+	Lanes4f SampleVLanes(int c, const Lanes4f weights[4], const Lanes4f edges[2]) const {
+		Lanes4f sum = Lanes4f(u[0][c]) * weights[0] + Lanes4f(u[1][c]) * weights[1] + Lanes4f(u[2][c]) * weights[2] + Lanes4f(u[3][c]) * weights[3];
+		sum = Lanes4f::Select(edges[1], Lanes4f(u[3][c]), sum);
+		return Lanes4f::Select(edges[0], Lanes4f(u[0][c]), sum);
+	}
+
+	// The masks SampleVLanes() wants for a set of weights.
+	static void OpenEdges(const Lanes4f weights[4], Lanes4f edges[2]) {
+		edges[0] = weights[0] == Lanes4f(1.0f);
+		edges[1] = weights[3] == Lanes4f(1.0f);
+	}
 };
 
 ControlPoints::ControlPoints(const SimpleVertex *const *points, int size, SimpleBufferManager &managedBuf) {
@@ -333,16 +352,33 @@ void ControlPoints::Convert(const SimpleVertex *const *points, int size) {
 	defcolor = points[0]->color_32;
 }
 
+// Surfaces with at least this many vertices have their columns tessellated on the thread pool.
+static const int PARALLEL_TESS_MIN_VERTS = 4096;
+
 template<class Surface>
 class SubdivisionSurface {
 public:
-	template <bool sampleNrm, bool sampleCol, bool sampleTex, bool useSSE4, bool patchFacing>
-	static void Tessellate(OutputBuffers &output, const Surface &surface, const ControlPoints &points, const Weight2D &weights) {
+	// Tessellates the columns (patch_u, tile_u pairs) from lower to upper.  Each column is a line of vertices along V,
+	// and they don't share any output, so ranges of them can run on different threads.
+	template <bool sampleNrm, bool sampleCol, bool sampleTex, bool patchFacing>
+	static void TessellateColumns(OutputBuffers &output, const Surface &surface, const ControlPoints &points, const Weight2D &weights, int lower, int upper) {
+		const int LANES = 4;
 		const float inv_u = 1.0f / (float)surface.tess_u;
 		const float inv_v = 1.0f / (float)surface.tess_v;
 
-		for (int patch_u = 0; patch_u < surface.num_patches_u; ++patch_u) {
-			const int start_u = surface.GetTessStart(patch_u);
+		// Find the first column, then step along.
+		int patch_u = 0;
+		int tile_u = lower;
+		while (tile_u > surface.tess_u - surface.GetTessStart(patch_u)) {
+			tile_u -= surface.tess_u + 1 - surface.GetTessStart(patch_u);
+			++patch_u;
+		}
+		tile_u += surface.GetTessStart(patch_u);
+
+		for (int column = lower; column < upper; ++column) {
+			const int index_u = surface.GetIndexU(patch_u, tile_u);
+			const Weight &wu = weights.u[index_u];
+
 			for (int patch_v = 0; patch_v < surface.num_patches_v; ++patch_v) {
 				const int start_v = surface.GetTessStart(patch_v);
 
@@ -354,46 +390,94 @@ class SubdivisionSurface {
 				Tessellator<Vec2f> tess_tex(points.tex, idx_v);
 				Tessellator<Vec3f> tess_nrm(points.pos, idx_v);
 
-				for (int tile_u = start_u; tile_u <= surface.tess_u; ++tile_u) {
-					const int index_u = surface.GetIndexU(patch_u, tile_u);
-					const Weight &wu = weights.u[index_u];
+				// Pre-tessellate U lines
+				tess_pos.SampleU(wu.basis);
+				if (sampleCol)
+					tess_col.SampleU(wu.basis);
+				if (sampleTex)
+					tess_tex.SampleU(wu.basis);
+				if (sampleNrm)
+					tess_nrm.SampleU(wu.deriv);
+
+				// Then evaluate the V lines for four vertices at a time, one per lane.
+				for (int tile_v = start_v; tile_v <= surface.tess_v; tile_v += LANES) {
+					const int count = std::min(LANES, surface.tess_v + 1 - tile_v);
+
+					alignas(16) float basis[4][LANES];
+					alignas(16) float deriv[4][LANES];
+					for (int lane = 0; lane < LANES; ++lane) {
+						const Weight &wv = weights.v[surface.GetIndexV(patch_v, tile_v + std::min(lane, count - 1))];
+						for (int i = 0; i < 4; ++i) {
+							basis[i][lane] = wv.basis[i];
+							deriv[i][lane] = wv.deriv[i];
+						}
+					}
+					const Lanes4f wb[4] = { Lanes4f::Load(basis[0]), Lanes4f::Load(basis[1]), Lanes4f::Load(basis[2]), Lanes4f::Load(basis[3]) };
+					Lanes4f wbEdges[2];
+					Tessellator<Vec3f>::OpenEdges(wb, wbEdges);
+
+					alignas(16) float pos[3][LANES];
+					Lanes4f posLanes[3];
+					for (int c = 0; c < 3; ++c) {
+						posLanes[c] = tess_pos.SampleVLanes(c, wb, wbEdges);
+						posLanes[c].Store(pos[c]);
+					}
+
+					alignas(16) float col[4][LANES];
+					if (sampleCol) {
+						for (int c = 0; c < 4; ++c)
+							tess_col.SampleVLanes(c, wb, wbEdges).Store(col[c]);
+					}
+
+					alignas(16) float tex[2][LANES];
+					if (sampleTex) {
+						for (int c = 0; c < 2; ++c)
+							tess_tex.SampleVLanes(c, wb, wbEdges).Store(tex[c]);
+					}
 
-					// Pre-tessellate U lines
-					tess_pos.SampleU(wu.basis);
-					if (sampleCol)
-						tess_col.SampleU(wu.basis);
-					if (sampleTex)
-						tess_tex.SampleU(wu.basis);
-					if (sampleNrm)
-						tess_nrm.SampleU(wu.deriv);
+					alignas(16) float nrm[3][LANES];
+					if (sampleNrm) {
+						const Lanes4f wd[4] = { Lanes4f::Load(deriv[0]), Lanes4f::Load(deriv[1]), Lanes4f::Load(deriv[2]), Lanes4f::Load(deriv[3]) };
+						Lanes4f wdEdges[2];
+						Tessellator<Vec3f>::OpenEdges(wd, wdEdges);
+						Lanes4f derivU[3], derivV[3];
+						for (int c = 0; c < 3; ++c) {
+							derivU[c] = tess_nrm.SampleVLanes(c, wb, wbEdges);
+							derivV[c] = tess_pos.SampleVLanes(c, wd, wdEdges);
+						}
 
-					for (int tile_v = start_v; tile_v <= surface.tess_v; ++tile_v) {
-						const int index_v = surface.GetIndexV(patch_v, tile_v);
-						const Weight &wv = weights.v[index_v];
+						Lanes4f cross[3] = {
+							derivU[1] * derivV[2] - derivU[2] * derivV[1],
+							derivU[2] * derivV[0] - derivU[0] * derivV[2],
+							derivU[0] * derivV[1] - derivU[1] * derivV[0],
+						};
+						Lanes4f norm = Lanes4f::NormalizeMultiplier(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+						if (patchFacing)
+							norm = Lanes4f(0.0f) - norm;
+						for (int c = 0; c < 3; ++c)
+							(cross[c] * norm).Store(nrm[c]);
+					}
 
+					for (int lane = 0; lane < count; ++lane) {
+						const int index_v = surface.GetIndexV(patch_v, tile_v + lane);
 						SimpleVertex &vert = output.vertices[surface.GetIndex(index_u, index_v, patch_u, patch_v)];
 
-						// Tessellate
-						vert.pos = tess_pos.SampleV(wv.basis);
+						vert.pos = Vec3Packedf(pos[0][lane], pos[1][lane], pos[2][lane]);
 						if (sampleCol) {
-							vert.color_32 = tess_col.SampleV(wv.basis).ToRGBA();
+							vert.color_32 = Vec4f(col[0][lane], col[1][lane], col[2][lane], col[3][lane]).ToRGBA();
 						} else {
 							vert.color_32 = points.defcolor;
 						}
 						if (sampleTex) {
-							tess_tex.SampleV(wv.basis).Write(vert.uv);
+							vert.uv[0] = tex[0][lane];
+							vert.uv[1] = tex[1][lane];
 						} else {
 							// Generate texcoord
 							vert.uv[0] = patch_u + tile_u * inv_u;
-							vert.uv[1] = patch_v + tile_v * inv_v;
+							vert.uv[1] = patch_v + (tile_v + lane) * inv_v;
 						}
 						if (sampleNrm) {
-							const Vec3f derivU = tess_nrm.SampleV(wv.basis);
-							const Vec3f derivV = tess_pos.SampleV(wv.deriv);
-
-							vert.nrm = Cross(derivU, derivV).Normalized(useSSE4);
-							if (patchFacing)
-								vert.nrm *= -1.0f;
+							vert.nrm = Vec3Packedf(nrm[0][lane], nrm[1][lane], nrm[2][lane]);
 						} else {
 							vert.nrm.SetZero();
 							vert.nrm.z = 1.0f;
@@ -401,6 +485,26 @@ class SubdivisionSurface {
 					}
 				}
 			}
+
+			if (++tile_u > surface.tess_u) {
+				++patch_u;
+				tile_u = surface.GetTessStart(patch_u);
+			}
+		}
+	}
+
+	template <bool sampleNrm, bool sampleCol, bool sampleTex, bool patchFacing>
+	static void Tessellate(OutputBuffers &output, const Surface &surface, const ControlPoints &points, const Weight2D &weights) {
+		int numColumns = 0;
+		for (int patch_u = 0; patch_u < surface.num_patches_u; ++patch_u)
+			numColumns += surface.tess_u + 1 - surface.GetTessStart(patch_u);
+
+		if (surface.GetNumVertices() >= PARALLEL_TESS_MIN_VERTS && GlobalThreadPool::NumThreads() > 1) {
+			GlobalThreadPool::Loop([&](int lower, int upper) {
+				TessellateColumns<sampleNrm, sampleCol, sampleTex, patchFacing>(output, surface, points, weights, lower, upper);
+			}, 0, numColumns, TaskPriority::HIGH);
+		} else {
+			TessellateColumns<sampleNrm, sampleCol, sampleTex, patchFacing>(output, surface, points, weights, 0, numColumns);
 		}
 
 		surface.BuildIndex(output.indices, output.count);
@@ -414,7 +518,6 @@ class SubdivisionSurface {
 			(origVertType & GE_VTYPE_NRM_MASK) != 0 || gstate.isLightingEnabled(),
 			(origVertType & GE_VTYPE_COL_MASK) != 0,
 			(origVertType & GE_VTYPE_TC_MASK) != 0,
-			cpu_info.bSSE4_1,
 			surface.patchFacing,
 		};
 		static TemplateParameterDispatcher<TessFunc, ARRAY_SIZE(params), Tess> dispatcher; // Initialize only once
@@ -434,6 +537,82 @@ void SoftwareTessellation(OutputBuffers &output, const Surface &surface, u32 ori
 	SubdivisionSurface<Surface>::Tessellate(output, surface, points, weights, origVertType);
 }
 
+bool TessellationCache::Lookup(u64 key, OutputBuffers &output) {
+	auto it = entries_.find(key);
+	if (it == entries_.end())
+		return false;
+
+	Entry &entry = it->second;
+	entry.lastUse = ++useCounter_;
+	memcpy(output.vertices, entry.vertices.data(), entry.vertices.size() * sizeof(SimpleVertex));
+	memcpy(output.indices, entry.indices.data(), entry.indices.size() * sizeof(u16));
+	output.count = (int)entry.indices.size();
+	return true;
+}
+
+void TessellationCache::Store(u64 key, const OutputBuffers &output, int numVertices) {
+	// Small patches are cheaper to tessellate than to copy around, and huge ones would push everything else out.
+	if (numVertices < MIN_VERTICES || numVertices > MAX_VERTICES / 4)
+		return;
+
+	while (!entries_.empty() && (entries_.size() >= MAX_ENTRIES || totalVertices_ + numVertices > MAX_VERTICES))
+		EvictOldest();
+
+	Entry &entry = entries_[key];
+	entry.vertices.assign(output.vertices, output.vertices + numVertices);
+	entry.indices.assign(output.indices, output.indices + output.count);
+	entry.lastUse = ++useCounter_;
+	totalVertices_ += numVertices;
+}
+
+void TessellationCache::Clear() {
+	entries_.clear();
+	totalVertices_ = 0;
+}
+
+void TessellationCache::EvictOldest() {
+	auto oldest = entries_.begin();
+	for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+		if (it->second.lastUse < oldest->second.lastUse)
+			oldest = it;
+	}
+	totalVertices_ -= oldest->second.vertices.size();
+	entries_.erase(oldest);
+}
+
+static TessellationCache tessellationCache;
+
+template<class Surface>
+u64 TessellationKey(const Surface &surface, const SimpleVertex *const *points, int num_points, u32 origVertType) {
+	struct {
+		int tess_u, tess_v;
+		int num_points_u, num_points_v;
+		int type_u, type_v;
+		int primType;
+		u32 vertType;
+		u8 patchFacing;
+		u8 lighting;
+		u8 spline;
+	} params;
+	memset(&params, 0, sizeof(params));
+	params.tess_u = surface.tess_u;
+	params.tess_v = surface.tess_v;
+	params.num_points_u = surface.num_points_u;
+	params.num_points_v = surface.num_points_v;
+	params.type_u = surface.type_u;
+	params.type_v = surface.type_v;
+	params.primType = surface.primType;
+	params.vertType = origVertType;
+	params.patchFacing = surface.patchFacing;
+	params.lighting = gstate.isLightingEnabled();
+	params.spline = std::is_same<Surface, SplineSurface>::value;
+
+	u64 hash = XXH3_64bits(&params, sizeof(params));
+	for (int i = 0; i < num_points; ++i)
+		hash = XXH3_64bits_withSeed(points[i], sizeof(SimpleVertex), hash);
+	return hash;
+}
+
 template<class Surface>
 static void HardwareTessellation(OutputBuffers &output, const Surface &surface, u32 origVertType,
 	const SimpleVertex *const *points, TessellationDataTransfer *tessDataTransfer) {
@@ -480,9 +659,14 @@ using namespace Spline;
 void DrawEngineCommon::ClearSplineBezierWeights() {
 	Bezier3DWeight::weightsCache.Clear();
 	Spline3DWeight::weightsCache.Clear();
+	tessellationCache.Clear();
 }
 
 // Specialize to make instance (to avoid link error).
+template void Spline::SoftwareTessellation<BezierSurface>(OutputBuffers &output, const BezierSurface &surface, u32 origVertType, const ControlPoints &points);
+template void Spline::SoftwareTessellation<SplineSurface>(OutputBuffers &output, const SplineSurface &surface, u32 origVertType, const ControlPoints &points);
+template u64 Spline::TessellationKey<BezierSurface>(const BezierSurface &surface, const SimpleVertex *const *points, int num_points, u32 origVertType);
+template u64 Spline::TessellationKey<SplineSurface>(const SplineSurface &surface, const SimpleVertex *const *points, int num_points, u32 origVertType);
 template void DrawEngineCommon::SubmitCurve<BezierSurface>(const void *control_points, const void *indices, BezierSurface &surface, u32 vertType, int *bytesRead, const char *scope);
 template void DrawEngineCommon::SubmitCurve<SplineSurface>(const void *control_points, const void *indices, SplineSurface &surface, u32 vertType, int *bytesRead, const char *scope);
 
@@ -551,8 +735,12 @@ void DrawEngineCommon::SubmitCurve(const void *control_points, const void *indic
 	if (CanUseHardwareTessellation(surface.primType)) {
 		HardwareTessellation(output, surface, origVertType, points, tessDataTransfer);
 	} else {
-		ControlPoints cpoints(points, num_points, managedBuf);
-		SoftwareTessellation(output, surface, origVertType, cpoints);
+		u64 tessKey = TessellationKey(surface, points, num_points, origVertType);
+		if (!tessellationCache.Lookup(tessKey, output)) {
+			ControlPoints cpoints(points, num_points, managedBuf);
+			SoftwareTessellation(output, surface, origVertType, cpoints);
+			tessellationCache.Store(tessKey, output, surface.GetNumVertices());
+		}
 	}
 
 	u32 vertTypeWithIndex16 = (vertType & ~GE_VTYPE_IDX_MASK) | GE_VTYPE_IDX_16BIT;
@@ -17,6 +17,7 @@
 
 #pragma once
 #include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
@@ -99,6 +100,8 @@ struct BezierSurface : public SurfaceInfo {
 
 	int GetTessStart(int patch) const { return 0; }
 
+	int GetNumVertices() const { return num_verts_per_patch * num_patches_u * num_patches_v; }
+
 	int GetPointIndex(int patch_u, int patch_v) const { return patch_v * 3 * num_points_u + patch_u * 3; }
 
 	int GetIndexU(int patch_u, int tile_u) const { return tile_u; }
@@ -137,6 +140,8 @@ struct SplineSurface : public SurfaceInfo {
 
 	int GetTessStart(int patch) const { return (patch == 0) ? 0 : 1; }
 
+	int GetNumVertices() const { return num_vertices_u * (num_patches_v * tess_v + 1); }
+
 	int GetPointIndex(int patch_u, int patch_v) const { return patch_v * num_points_u + patch_u; }
 
 	int GetIndexU(int patch_u, int tile_u) const { return patch_u * tess_u + tile_u; }
@@ -205,6 +210,39 @@ struct OutputBuffers {
 template<class Surface>
 void SoftwareTessellation(OutputBuffers &output, const Surface &surface, u32 origVertType, const ControlPoints &points);
 
+// Hashes the control points together with everything else that affects the tessellated output.
+template<class Surface>
+u64 TessellationKey(const Surface &surface, const SimpleVertex *const *points, int num_points, u32 origVertType);
+
+// Keeps the output of recent software tessellations, so that static patches drawn again every frame
+// are only tessellated once.  Entries are keyed by TessellationKey(), and the least recently used
+// are dropped to stay within the limits.
+class TessellationCache {
+public:
+	bool Lookup(u64 key, OutputBuffers &output);
+	void Store(u64 key, const OutputBuffers &output, int numVertices);
+	void Clear();
+
+	enum {
+		MIN_VERTICES = 64,
+		MAX_VERTICES = 128 * 1024,
+		MAX_ENTRIES = 64,
+	};
+
+private:
+	struct Entry {
+		std::vector<SimpleVertex> vertices;
+		std::vector<u16> indices;
+		u32 lastUse;
+	};
+
+	void EvictOldest();
+
+	std::unordered_map<u64, Entry> entries_;
+	size_t totalVertices_ = 0;
+	u32 useCounter_ = 0;
+};
+
 } // namespace Spline
 
 // Define function object for TemplateParameterDispatcher
@@ -24,9 +24,11 @@
 #include "Core/Config.h"
 #include "Core/Reporting.h"
 #include "Core/System.h"
+#include "Core/ThreadPools.h"
 #include "GPU/Common/FramebufferManagerCommon.h"
 #include "GPU/Common/TextureCacheCommon.h"
 #include "GPU/Common/TextureDecoder.h"
+#include "GPU/Common/TextureScalerCommon.h"
 #include "GPU/Common/ShaderId.h"
 #include "GPU/Common/GPUStateUtils.h"
 #include "GPU/Debugger/Debugger.h"
@@ -96,6 +98,11 @@ inline int dimHeight(u16 dim) {
 	return 1 << ((dim >> 8) & 0xFF);
 }
 
+static bool ScaleAsync() {
+	// Without a spare thread, it would just scale right away anyway.
+	return g_Config.bTexScalingAsync && GlobalThreadPool::NumThreads() > 1;
+}
+
 // Vulkan color formats:
 // TODO
 TextureCacheCommon::TextureCacheCommon(Draw::DrawContext *draw)
@@ -128,6 +135,7 @@ TextureCacheCommon::TextureCacheCommon(Draw::DrawContext *draw)
 }
 
 TextureCacheCommon::~TextureCacheCommon() {
+	CancelScaleJobs();
 	FreeAlignedMemory(clutBufConverted_);
 	FreeAlignedMemory(clutBufRaw_);
 }
@@ -434,8 +442,10 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 			}
 		}
 
-		if (match && (entry->status & TexCacheEntry::STATUS_TO_SCALE) && standardScaleFactor_ != 1 && texelsScaledThisFrame_ < TEXCACHE_MAX_TEXELS_SCALED) {
-			if ((entry->status & TexCacheEntry::STATUS_CHANGE_FREQUENT) == 0) {
+		if (match && (entry->status & TexCacheEntry::STATUS_TO_SCALE) && standardScaleFactor_ != 1 && (entry->status & TexCacheEntry::STATUS_CHANGE_FREQUENT) == 0) {
+			// With async scaling, only rebuild once the scaled texture is ready.
+			bool scaleReady = ScaleAsync() ? scaledTextures_.count(cachekey) != 0 : texelsScaledThisFrame_ < TEXCACHE_MAX_TEXELS_SCALED;
+			if (scaleReady) {
 				// INFO_LOG(G3D, "Reloading texture to do the scaling we skipped..");
 				match = false;
 				reason = "scaling";
@@ -1054,6 +1064,7 @@ void TextureCacheCommon::NotifyConfigChanged() {
 	standardScaleFactor_ = scaleFactor;
 
 	replacer_.NotifyConfigChanged();
+	diskCache_.NotifyConfigChanged();
 }
 
 void TextureCacheCommon::NotifyVideoUpload(u32 addr, int size, int width, GEBufferFormat fmt) {
@@ -1666,6 +1677,7 @@ void TextureCacheCommon::Clear(bool delete_them) {
 		secondCacheSizeEstimate_ = 0;
 	}
 	videos_.clear();
+	CancelScaleJobs();
 }
 
 void TextureCacheCommon::DeleteTexture(TexCache::iterator it) {
@@ -1674,6 +1686,205 @@ void TextureCacheCommon::DeleteTexture(TexCache::iterator it) {
 	cache_.erase(it);
 }
 
+void TextureScaleQueue::Run() {
+	while (true) {
+		std::unique_ptr<TextureScaleJob> job;
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			if (pending.empty())
+				return;
+			job = std::move(pending.front());
+			pending.pop_front();
+		}
+
+		job->w = job->srcW;
+		job->h = job->srcH;
+		job->output.resize(job->srcW * job->factor * job->srcH * job->factor);
+		job->scaler->ScaleAlways(job->output.data(), job->input.data(), job->fmt, job->w, job->h, job->factor);
+		if (job->diskCache)
+			job->diskCache->Save(job->diskKey, job->output.data(), job->fmt);
+
+		std::lock_guard<std::mutex> guard(mutex);
+		finished.push_back(std::move(job));
+	}
+}
+
+int TextureCacheCommon::ApplyScaleBudget(TexCacheEntry *entry, int scaleFactor, int w, int h, bool hardwareScaling) {
+	pendingScaleFactor_ = 1;
+	if (scaleFactor == 1)
+		return 1;
+
+	if (!hardwareScaling && diskCache_.Contains(DiskCacheKey(*entry, w, h, scaleFactor))) {
+		// Scaled in an earlier session, cheap enough to load right away.
+		entry->status &= ~TexCacheEntry::STATUS_TO_SCALE;
+		entry->status |= TexCacheEntry::STATUS_IS_SCALED;
+		return scaleFactor;
+	}
+
+	if (hardwareScaling || !ScaleAsync()) {
+		if (texelsScaledThisFrame_ >= TEXCACHE_MAX_TEXELS_SCALED && !hardwareScaling) {
+			entry->status |= TexCacheEntry::STATUS_TO_SCALE;
+			return 1;
+		}
+		entry->status &= ~TexCacheEntry::STATUS_TO_SCALE;
+		entry->status |= TexCacheEntry::STATUS_IS_SCALED;
+		texelsScaledThisFrame_ += w * h;
+		return scaleFactor;
+	}
+
+	const u64 cachekey = entry->CacheKey();
+	auto ready = scaledTextures_.find(cachekey);
+	if (ready != scaledTextures_.end()) {
+		const TextureScaleJob *job = ready->second.get();
+		if (job->fullhash == entry->fullhash && job->factor == scaleFactor) {
+			// ScaleTexture() will pick it up.
+			entry->status &= ~TexCacheEntry::STATUS_TO_SCALE;
+			entry->status |= TexCacheEntry::STATUS_IS_SCALED;
+			return scaleFactor;
+		}
+		// The texture changed since, this is no good.
+		scaledTextures_.erase(ready);
+		scalesQueued_.erase(cachekey);
+	}
+
+	// Use the unscaled texture until the scaled one is ready.
+	entry->status |= TexCacheEntry::STATUS_TO_SCALE;
+	if (!scalesQueued_.count(cachekey) && scalesQueued_.size() < TEXCACHE_MAX_SCALES_QUEUED)
+		pendingScaleFactor_ = scaleFactor;
+	return 1;
+}
+
+void TextureCacheCommon::ScaleTexture(TextureScalerCommon &scaler, const TexCacheEntry &entry, u32 *out, u32 *src, u32 &dstFmt, int &w, int &h, int factor) {
+	const u64 cachekey = entry.CacheKey();
+	auto ready = scaledTextures_.find(cachekey);
+	if (ready != scaledTextures_.end()) {
+		TextureScaleJob *job = ready->second.get();
+		if (job->fullhash == entry.fullhash && job->factor == factor && job->srcW == w && job->srcH == h) {
+			memcpy(out, job->output.data(), job->w * job->h * sizeof(u32));
+			dstFmt = job->fmt;
+			w = job->w;
+			h = job->h;
+			scaledTextures_.erase(ready);
+			scalesQueued_.erase(cachekey);
+			return;
+		}
+	}
+
+	TextureDiskCacheKey diskKey = DiskCacheKey(entry, w, h, factor);
+	if (diskCache_.Load(diskKey, out, dstFmt)) {
+		w *= factor;
+		h *= factor;
+		return;
+	}
+
+	scaler.ScaleAlways(out, src, dstFmt, w, h, factor);
+	diskCache_.Save(diskKey, out, dstFmt);
+}
+
+void TextureCacheCommon::QueueScale(TextureScalerCommon &scaler, const TexCacheEntry &entry, const u8 *data, int pitch, int bpp, u32 fmt, int w, int h) {
+	if (pendingScaleFactor_ == 1)
+		return;
+
+	std::unique_ptr<TextureScaleJob> job(new TextureScaleJob());
+	job->scaler = &scaler;
+	job->cachekey = entry.CacheKey();
+	job->fullhash = entry.fullhash;
+	job->generation = scaleGeneration_;
+	job->frame = 0;
+	job->factor = pendingScaleFactor_;
+	job->fmt = fmt;
+	job->srcW = w;
+	job->srcH = h;
+	job->w = w;
+	job->h = h;
+	job->diskCache = diskCache_.Enabled() ? &diskCache_ : nullptr;
+	job->diskKey = DiskCacheKey(entry, w, h, job->factor);
+	// Rounded up to whole u32s, since 16-bit textures may have an odd width.
+	job->input.resize((w * bpp * h + 3) / 4);
+	u8 *dst = (u8 *)job->input.data();
+	for (int y = 0; y < h; ++y) {
+		memcpy(dst + y * w * bpp, data + y * pitch, w * bpp);
+	}
+
+	pendingScaleFactor_ = 1;
+	scalesQueued_.insert(job->cachekey);
+	{
+		std::lock_guard<std::mutex> guard(scaleQueue_.mutex);
+		scaleQueue_.pending.push_back(std::move(job));
+	}
+	if (!scaleQueueRunning_ || scaleQueue_.IsDone()) {
+		scaleQueueRunning_ = true;
+		GlobalThreadPool::Submit(&scaleQueue_);
+	}
+}
+
+void TextureCacheCommon::PollScaleJobs() {
+	if (!scaleQueueRunning_)
+		return;
+
+	bool morePending;
+	{
+		std::lock_guard<std::mutex> guard(scaleQueue_.mutex);
+		for (auto &job : scaleQueue_.finished) {
+			if (job->generation == scaleGeneration_) {
+				u64 cachekey = job->cachekey;
+				job->frame = gpuStats.numFlips;
+				scaledTextures_[cachekey] = std::move(job);
+			}
+		}
+		scaleQueue_.finished.clear();
+		morePending = !scaleQueue_.pending.empty();
+	}
+
+	// Drop results nobody wanted, for example because the texture stopped being used.
+	for (auto it = scaledTextures_.begin(); it != scaledTextures_.end(); ) {
+		if (it->second->frame + TEXCACHE_SCALED_KEEP_FRAMES < gpuStats.numFlips) {
+			scalesQueued_.erase(it->first);
+			it = scaledTextures_.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (scaleQueue_.IsDone()) {
+		// If it ran out of work just as more was queued, it might have missed it.
+		scaleQueueRunning_ = morePending;
+		if (morePending)
+			GlobalThreadPool::Submit(&scaleQueue_);
+	}
+}
+
+void TextureCacheCommon::CancelScaleJobs() {
+	scaleGeneration_++;
+	if (scaleQueueRunning_) {
+		{
+			std::lock_guard<std::mutex> guard(scaleQueue_.mutex);
+			scaleQueue_.pending.clear();
+		}
+		// It might be in the middle of one, using a scaler that's about to go away.
+		GlobalThreadPool::Wait(&scaleQueue_);
+		scaleQueue_.finished.clear();
+		scaleQueueRunning_ = false;
+	}
+	scaledTextures_.clear();
+	scalesQueued_.clear();
+	pendingScaleFactor_ = 1;
+}
+
+TextureDiskCacheKey TextureCacheCommon::DiskCacheKey(const TexCacheEntry &entry, int w, int h, int factor) const {
+	TextureDiskCacheKey key;
+	key.fullhash = entry.fullhash;
+	key.cluthash = entry.cluthash;
+	key.format = entry.format;
+	key.clutformat = IsClutFormat((GETextureFormat)entry.format) ? gstate.getClutPaletteFormat() : 0;
+	key.factor = factor;
+	key.scalingType = g_Config.iTexScalingType;
+	key.deposterize = g_Config.bTexDeposterize;
+	key.w = w;
+	key.h = h;
+	return key;
+}
+
 bool TextureCacheCommon::CheckFullHash(TexCacheEntry *entry, bool &doDelete) {
 	int w = gstate.getTextureWidth(0);
 	int h = gstate.getTextureHeight(0);
@@ -17,15 +17,20 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
+#include <mutex>
+#include <set>
 #include <vector>
 #include <memory>
 
 #include "Common/CommonTypes.h"
 #include "Common/MemoryUtil.h"
+#include "Common/Thread/ThreadPool.h"
 #include "Core/TextureReplacer.h"
 #include "Core/System.h"
 #include "GPU/Common/GPUDebugInterface.h"
+#include "GPU/Common/TextureDiskCache.h"
 #include "GPU/Common/TextureDecoder.h"
 
 enum TextureFiltering {
@@ -51,6 +56,9 @@ enum FramebufferNotificationChannel {
 #define TEXCACHE_FRAME_CHANGE_FREQUENT_REGAIN_TRUST 33
 
 #define TEXCACHE_MAX_TEXELS_SCALED (256*256)  // Per frame
+// With async scaling, how many textures may wait for the thread pool, and for how many frames a result waits to be used.
+#define TEXCACHE_MAX_SCALES_QUEUED 32
+#define TEXCACHE_SCALED_KEEP_FRAMES 60
 
 struct VirtualFramebuffer;
 
@@ -222,6 +230,42 @@ struct AttachCandidate {
 };
 
 class FramebufferManagerCommon;
+class TextureScalerCommon;
+
+// A texture level to be scaled on the thread pool.  The input is a tight copy of the decoded texture.
+struct TextureScaleJob {
+	TextureScalerCommon *scaler;
+	u64 cachekey;
+	u32 fullhash;
+	int generation;
+	// When the result arrived.
+	int frame;
+	int factor;
+	u32 fmt;
+	int srcW;
+	int srcH;
+	int w;
+	int h;
+	// Where to save the result, if anywhere.
+	TextureDiskCache *diskCache;
+	TextureDiskCacheKey diskKey;
+	SimpleBuf<u32> input;
+	SimpleBuf<u32> output;
+};
+
+// Scales jobs one after another, each one spreading out over the pool as usual.
+// Low priority, so drawing work always comes first.
+class TextureScaleQueue : public Task {
+public:
+	TextureScaleQueue() : Task(TaskPriority::LOW) {}
+
+	void Run() override;
+
+	// Guards the lists, the jobs themselves belong to whoever has them.
+	std::mutex mutex;
+	std::deque<std::unique_ptr<TextureScaleJob>> pending;
+	std::vector<std::unique_ptr<TextureScaleJob>> finished;
+};
 
 class TextureCacheCommon {
 public:
@@ -301,6 +345,18 @@ class TextureCacheCommon {
 
 	void DecimateVideos();
 
+	// Decides the scale factor for a texture about to be built, within the per-frame budget.
+	// With async scaling, it's only > 1 when a finished result is waiting, otherwise the texture is queued.
+	int ApplyScaleBudget(TexCacheEntry *entry, int scaleFactor, int w, int h, bool hardwareScaling = false);
+	// Same as scaler.ScaleAlways(), but uses the async result if there is one.
+	void ScaleTexture(TextureScalerCommon &scaler, const TexCacheEntry &entry, u32 *out, u32 *src, u32 &dstFmt, int &w, int &h, int factor);
+	// Call after decoding the level ApplyScaleBudget() was for.  Does nothing unless it decided to queue it.
+	void QueueScale(TextureScalerCommon &scaler, const TexCacheEntry &entry, const u8 *data, int pitch, int bpp, u32 fmt, int w, int h);
+	// Once per frame, picks up finished results.  They're swapped in by the next SetTexture().
+	void PollScaleJobs();
+	void CancelScaleJobs();
+	TextureDiskCacheKey DiskCacheKey(const TexCacheEntry &entry, int w, int h, int factor) const;
+
 	inline u32 QuickTexHash(TextureReplacer &replacer, u32 addr, int bufw, int w, int h, GETextureFormat format, TexCacheEntry *entry) const {
 		if (replacer.Enabled()) {
 			return replacer.ComputeHash(addr, bufw, w, h, format, entry->maxSeenV);
@@ -345,6 +401,14 @@ class TextureCacheCommon {
 
 	std::map<u32, int> videos_;
 
+	TextureScaleQueue scaleQueue_;
+	bool scaleQueueRunning_ = false;
+	int scaleGeneration_ = 0;
+	int pendingScaleFactor_ = 1;
+	std::set<u64> scalesQueued_;
+	std::map<u64, std::unique_ptr<TextureScaleJob>> scaledTextures_;
+	TextureDiskCache diskCache_;
+
 	SimpleBuf<u32> tmpTexBuf32_;
 	SimpleBuf<u32> tmpTexBufRearrange_;
 
@@ -29,6 +29,7 @@
 
 #ifdef _M_SSE
 #include <emmintrin.h>
+#include <immintrin.h>
 #if _M_SSE >= 0x401
 #include <smmintrin.h>
 #endif
@@ -324,6 +325,73 @@ void SetupTextureDecoder() {
 #endif
 }
 
+#ifdef _M_SSE
+// These return how many pixels they did, leaving less than one chunk for the caller.
+PPSSPP_TARGET_AVX2
+static int DeIndexTexture8To32AVX2(u32 *dest, const u8 *indexed, int length, const u32 *clut) {
+	int i = 0;
+	for (; i + 8 <= length; i += 8) {
+		const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(indexed + i)));
+		_mm256_storeu_si256((__m256i *)(dest + i), _mm256_i32gather_epi32((const int *)clut, index, 4));
+	}
+	return i;
+}
+
+PPSSPP_TARGET_AVX2
+static int DeIndexTexture4To32AVX2(u32 *dest, const u8 *indexed, int length, const u32 *clut) {
+	// The whole palette fits in two registers, so permutes beat gathers here.
+	const __m256i clutLo = _mm256_loadu_si256((const __m256i *)clut);
+	const __m256i clutHi = _mm256_loadu_si256((const __m256i *)(clut + 8));
+	const __m256i mask4 = _mm256_set1_epi32(0xF);
+
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		const __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(indexed + i / 2)));
+		const __m256i even = _mm256_and_si256(bytes, mask4);
+		const __m256i odd = _mm256_srli_epi32(bytes, 4);
+
+		// Bit 3 picks the half, moved up to the sign bit for blendv.
+		const __m256 evenHi = _mm256_castsi256_ps(_mm256_slli_epi32(even, 28));
+		const __m256 oddHi = _mm256_castsi256_ps(_mm256_slli_epi32(odd, 28));
+		const __m256i evenColors = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(_mm256_permutevar8x32_epi32(clutLo, even)), _mm256_castsi256_ps(_mm256_permutevar8x32_epi32(clutHi, even)), evenHi));
+		const __m256i oddColors = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(_mm256_permutevar8x32_epi32(clutLo, odd)), _mm256_castsi256_ps(_mm256_permutevar8x32_epi32(clutHi, odd)), oddHi));
+
+		// Interleave the low and high nibbles back into pixel order.
+		const __m256i lo = _mm256_unpacklo_epi32(evenColors, oddColors);
+		const __m256i hi = _mm256_unpackhi_epi32(evenColors, oddColors);
+		_mm256_storeu_si256((__m256i *)(dest + i), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i *)(dest + i + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+	return i;
+}
+#endif
+
+void DeIndexTexture8To32(u32 *dest, const u8 *indexed, int length, const u32 *clut) {
+	int i = 0;
+#ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		i = DeIndexTexture8To32AVX2(dest, indexed, length, clut);
+	}
+#endif
+	for (; i < length; ++i) {
+		dest[i] = clut[indexed[i]];
+	}
+}
+
+void DeIndexTexture4To32(u32 *dest, const u8 *indexed, int length, const u32 *clut) {
+	int i = 0;
+#ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		i = DeIndexTexture4To32AVX2(dest, indexed, length, clut);
+	}
+#endif
+	for (; i < length; i += 2) {
+		u8 index = indexed[i / 2];
+		dest[i + 0] = clut[(index >> 0) & 0xf];
+		dest[i + 1] = clut[(index >> 4) & 0xf];
+	}
+}
+
 // S3TC / DXT Decoder
 class DXTDecoder {
 public:
@@ -601,12 +669,40 @@ CheckAlphaResult CheckAlphaRGBA5551SSE2(const u32 *pixelData, int stride, int w,
 
 	return CHECKALPHA_FULL;
 }
+
+// All the formats work the same way 32 bytes at a time, only the mask differs.  rowBytes must be a multiple of 32.
+PPSSPP_TARGET_AVX2
+static CheckAlphaResult CheckAlphaAVX2(const u32 *pixelData, int strideBytes, int rowBytes, int h, u32 mask32) {
+	const __m256i mask = _mm256_set1_epi32(mask32);
+	const int w32 = rowBytes / 32;
+
+	const u8 *row = (const u8 *)pixelData;
+	__m256i bits = mask;
+	for (int y = 0; y < h; ++y) {
+		const __m256i *p = (const __m256i *)row;
+		for (int i = 0; i < w32; ++i) {
+			bits = _mm256_and_si256(bits, _mm256_loadu_si256(&p[i]));
+		}
+
+		// Checks that every mask bit is still set.
+		if (!_mm256_testc_si256(bits, mask)) {
+			return CHECKALPHA_ANY;
+		}
+
+		row += strideBytes;
+	}
+
+	return CHECKALPHA_FULL;
+}
 #endif
 
 CheckAlphaResult CheckAlphaRGBA8888Basic(const u32 *pixelData, int stride, int w, int h) {
 	// Use SIMD if aligned to 16 bytes / 4 pixels (almost always the case.)
 	if ((w & 3) == 0 && (stride & 3) == 0) {
 #ifdef _M_SSE
+		if (cpu_info.bAVX2 && (w & 7) == 0) {
+			return CheckAlphaAVX2(pixelData, stride * 4, w * 4, h, 0xFF000000);
+		}
 		return CheckAlphaRGBA8888SSE2(pixelData, stride, w, h);
 #elif PPSSPP_ARCH(ARM_NEON)
 		if (cpu_info.bNEON) {
@@ -637,6 +733,9 @@ CheckAlphaResult CheckAlphaABGR4444Basic(const u32 *pixelData, int stride, int w
 	// Use SIMD if aligned to 16 bytes / 8 pixels (usually the case.)
 	if ((w & 7) == 0 && (stride & 7) == 0) {
 #ifdef _M_SSE
+		if (cpu_info.bAVX2 && (w & 15) == 0) {
+			return CheckAlphaAVX2(pixelData, stride * 2, w * 2, h, 0x000F000F);
+		}
 		return CheckAlphaABGR4444SSE2(pixelData, stride, w, h);
 #elif PPSSPP_ARCH(ARM_NEON)
 		if (cpu_info.bNEON) {
@@ -670,6 +769,9 @@ CheckAlphaResult CheckAlphaABGR1555Basic(const u32 *pixelData, int stride, int w
 	// Use SIMD if aligned to 16 bytes / 8 pixels (usually the case.)
 	if ((w & 7) == 0 && (stride & 7) == 0) {
 #ifdef _M_SSE
+		if (cpu_info.bAVX2 && (w & 15) == 0) {
+			return CheckAlphaAVX2(pixelData, stride * 2, w * 2, h, 0x00010001);
+		}
 		return CheckAlphaABGR1555SSE2(pixelData, stride, w, h);
 #elif PPSSPP_ARCH(ARM_NEON)
 		if (cpu_info.bNEON) {
@@ -702,6 +804,9 @@ CheckAlphaResult CheckAlphaRGBA4444Basic(const u32 *pixelData, int stride, int w
 	// Use SSE if aligned to 16 bytes / 8 pixels (usually the case.)
 	if ((w & 7) == 0 && (stride & 7) == 0) {
 #ifdef _M_SSE
+		if (cpu_info.bAVX2 && (w & 15) == 0) {
+			return CheckAlphaAVX2(pixelData, stride * 2, w * 2, h, 0xF000F000);
+		}
 		return CheckAlphaRGBA4444SSE2(pixelData, stride, w, h);
 #elif PPSSPP_ARCH(ARM_NEON)
 		if (cpu_info.bNEON) {
@@ -735,6 +840,9 @@ CheckAlphaResult CheckAlphaRGBA5551Basic(const u32 *pixelData, int stride, int w
 	// Use SSE if aligned to 16 bytes / 8 pixels (usually the case.)
 	if ((w & 7) == 0 && (stride & 7) == 0) {
 #ifdef _M_SSE
+		if (cpu_info.bAVX2 && (w & 15) == 0) {
+			return CheckAlphaAVX2(pixelData, stride * 2, w * 2, h, 0x80008000);
+		}
 		return CheckAlphaRGBA5551SSE2(pixelData, stride, w, h);
 #elif PPSSPP_ARCH(ARM_NEON)
 		if (cpu_info.bNEON) {
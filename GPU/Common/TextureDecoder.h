@@ -33,6 +33,9 @@ enum CheckAlphaResult {
 
 void SetupTextureDecoder();
 
+// Portable version of the texture hash, gives the same results as the SIMD ones.
+u32 QuickTexHashNonSSE(const void *checkp, u32 size);
+
 // Pitch must be aligned to 16 bits (as is the case on a PSP)
 void DoSwizzleTex16(const u32 *ysrcp, u8 *texptr, int bxc, int byc, u32 pitch);
 
@@ -112,13 +115,19 @@ static const u8 textureBitsPerPixel[16] = {
 
 u32 GetTextureBufw(int level, u32 texaddr, GETextureFormat format);
 
+// Plain lookups into a 32-bit palette, with no index shift, mask or offset.
+void DeIndexTexture8To32(u32 *dest, const u8 *indexed, int length, const u32 *clut);
+void DeIndexTexture4To32(u32 *dest, const u8 *indexed, int length, const u32 *clut);
+
 template <typename IndexT, typename ClutT>
 inline void DeIndexTexture(ClutT *dest, const IndexT *indexed, int length, const ClutT *clut) {
 	// Usually, there is no special offset, mask, or shift.
 	const bool nakedIndex = gstate.isClutIndexSimple();
 
 	if (nakedIndex) {
-		if (sizeof(IndexT) == 1) {
+		if (sizeof(IndexT) == 1 && sizeof(ClutT) == 4) {
+			DeIndexTexture8To32((u32 *)dest, (const u8 *)indexed, length, (const u32 *)clut);
+		} else if (sizeof(IndexT) == 1) {
 			for (int i = 0; i < length; ++i) {
 				*dest++ = clut[*indexed++];
 			}
@@ -145,7 +154,9 @@ inline void DeIndexTexture4(ClutT *dest, const u8 *indexed, int length, const Cl
 	// Usually, there is no special offset, mask, or shift.
 	const bool nakedIndex = gstate.isClutIndexSimple();
 
-	if (nakedIndex) {
+	if (nakedIndex && sizeof(ClutT) == 4) {
+		DeIndexTexture4To32((u32 *)dest, indexed, length, (const u32 *)clut);
+	} else if (nakedIndex) {
 		for (int i = 0; i < length; i += 2) {
 			u8 index = *indexed++;
 			dest[i + 0] = clut[(index >> 0) & 0xf];
@@ -0,0 +1,175 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <vector>
+#include <snappy-c.h>
+
+#include "Common/File/DirListing.h"
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Common/StringUtils.h"
+#include "Core/Config.h"
+#include "Core/ELF/ParamSFO.h"
+#include "Core/System.h"
+#include "GPU/Common/TextureDiskCache.h"
+
+static const u32 TEXTURE_DISK_CACHE_MAGIC = 0x43585450;  // PTXC
+// Bump when the file format or anything affecting scaling output changes.
+static const u32 TEXTURE_DISK_CACHE_VERSION = 1;
+
+struct TextureDiskCacheHeader {
+	u32 magic;
+	u32 version;
+	u32 dstFmt;
+	u32 w;
+	u32 h;
+	u32 compressedSize;
+};
+
+std::string TextureDiskCacheKey::Filename() const {
+	return StringFromFormat("%08x%08x_%d_%d_%dx%d_%d%d%d.tex", fullhash, cluthash, format, clutformat, w, h, factor, scalingType, deposterize ? 1 : 0);
+}
+
+void TextureDiskCache::NotifyConfigChanged() {
+	std::lock_guard<std::mutex> guard(mutex_);
+
+	const std::string gameID = g_paramSFO.GetDiscID();
+	enabled_ = g_Config.bTextureDiskCache && !gameID.empty();
+	if (!enabled_) {
+		basePath_.clear();
+		files_.clear();
+		return;
+	}
+
+	// The 8888 format the scalers output differs per backend.
+	std::string path = StringFromFormat("%s/%s.texcache/%d/", GetSysDirectory(DIRECTORY_APP_CACHE).c_str(), gameID.c_str(), (int)GetGPUBackend());
+	if (path == basePath_)
+		return;
+
+	basePath_ = path;
+	if (!File::Exists(basePath_))
+		File::CreateFullPath(basePath_);
+	ScanDirectory();
+}
+
+void TextureDiskCache::ScanDirectory() {
+	files_.clear();
+
+	std::vector<FileInfo> files;
+	getFilesInDir(basePath_.c_str(), &files, "tex");
+	for (const FileInfo &info : files) {
+		if (!info.isDirectory)
+			files_.insert(info.name);
+	}
+	INFO_LOG(G3D, "Texture disk cache: %d textures in %s", (int)files_.size(), basePath_.c_str());
+}
+
+bool TextureDiskCache::Contains(const TextureDiskCacheKey &key) {
+	if (!enabled_)
+		return false;
+	std::lock_guard<std::mutex> guard(mutex_);
+	return files_.count(key.Filename()) != 0;
+}
+
+bool TextureDiskCache::Load(const TextureDiskCacheKey &key, u32 *out, u32 &dstFmt) {
+	if (!Contains(key))
+		return false;
+
+	std::string filename = key.Filename();
+	std::string path;
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		path = basePath_ + filename;
+	}
+
+	const u32 w = key.w * key.factor;
+	const u32 h = key.h * key.factor;
+	bool success = false;
+	FILE *fp = File::OpenCFile(path, "rb");
+	if (fp) {
+		TextureDiskCacheHeader header;
+		const size_t size = w * h * sizeof(u32);
+		bool valid = fread(&header, sizeof(header), 1, fp) == 1 && header.magic == TEXTURE_DISK_CACHE_MAGIC && header.version == TEXTURE_DISK_CACHE_VERSION;
+		// A damaged size shouldn't get to allocate whatever it likes.
+		if (valid && header.w == w && header.h == h && header.compressedSize <= snappy_max_compressed_length(size)) {
+			std::vector<char> compressed(header.compressedSize);
+			size_t uncompressedSize = size;
+			if (fread(compressed.data(), 1, compressed.size(), fp) == compressed.size()) {
+				success = snappy_uncompress(compressed.data(), compressed.size(), (char *)out, &uncompressedSize) == SNAPPY_OK && uncompressedSize == size;
+			}
+			// Otherwise the caller scales from scratch, in whatever format it wants.
+			if (success)
+				dstFmt = header.dstFmt;
+		}
+		fclose(fp);
+	}
+
+	if (!success) {
+		// Probably cut short while saving.  Forget it, so it's scaled and saved again.
+		WARN_LOG(G3D, "Texture disk cache: bad file %s", path.c_str());
+		std::lock_guard<std::mutex> guard(mutex_);
+		files_.erase(filename);
+		File::Delete(path);
+	}
+	return success;
+}
+
+void TextureDiskCache::Save(const TextureDiskCacheKey &key, const u32 *data, u32 dstFmt) {
+	if (!enabled_ || Contains(key))
+		return;
+
+	// The GPU thread and a scaling job can both finish the same texture.  Only one writes it.
+	std::string filename = key.Filename();
+	std::string path;
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		if (files_.count(filename) != 0 || !saving_.insert(filename).second)
+			return;
+		path = basePath_ + filename;
+	}
+	SaveFile(filename, path, key, data, dstFmt);
+
+	std::lock_guard<std::mutex> guard(mutex_);
+	saving_.erase(filename);
+}
+
+void TextureDiskCache::SaveFile(const std::string &filename, const std::string &path, const TextureDiskCacheKey &key, const u32 *data, u32 dstFmt) {
+	const u32 w = key.w * key.factor;
+	const u32 h = key.h * key.factor;
+	const size_t size = w * h * sizeof(u32);
+	size_t compressedSize = snappy_max_compressed_length(size);
+	std::vector<char> compressed(compressedSize);
+	if (snappy_compress((const char *)data, size, compressed.data(), &compressedSize) != SNAPPY_OK)
+		return;
+
+	// Written under another name first, so a half written file never has the real name.
+	const std::string tempPath = path + ".tmp";
+	FILE *fp = File::OpenCFile(tempPath, "wb");
+	if (!fp)
+		return;
+
+	TextureDiskCacheHeader header{ TEXTURE_DISK_CACHE_MAGIC, TEXTURE_DISK_CACHE_VERSION, dstFmt, w, h, (u32)compressedSize };
+	bool success = fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(compressed.data(), 1, compressedSize, fp) == compressedSize;
+	fclose(fp);
+
+	if (success && File::Rename(tempPath, path)) {
+		std::lock_guard<std::mutex> guard(mutex_);
+		files_.insert(filename);
+	} else {
+		File::Delete(tempPath);
+	}
+}
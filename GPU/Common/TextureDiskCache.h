@@ -0,0 +1,72 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Identifies a scaled texture independent of where it was in memory.  Anything that
+// changes the result of decoding and scaling has to be in here.
+struct TextureDiskCacheKey {
+	u32 fullhash;
+	u32 cluthash;
+	u8 format;
+	u8 clutformat;
+	u8 factor;
+	u8 scalingType;
+	bool deposterize;
+	u16 w;
+	u16 h;
+
+	std::string Filename() const;
+};
+
+// Keeps upscaled textures between sessions, so they only have to be scaled once.
+// Files are snappy compressed and live in the app cache, one directory per game.
+// Safe to use from any thread.
+class TextureDiskCache {
+public:
+	// Picks up the game ID and the setting.  Call when either might have changed.
+	void NotifyConfigChanged();
+
+	bool Enabled() const {
+		return enabled_;
+	}
+
+	bool Contains(const TextureDiskCacheKey &key);
+	// The output is w * factor by h * factor, in the 8888 format returned in dstFmt.
+	bool Load(const TextureDiskCacheKey &key, u32 *out, u32 &dstFmt);
+	void Save(const TextureDiskCacheKey &key, const u32 *data, u32 dstFmt);
+
+private:
+	void ScanDirectory();
+	void SaveFile(const std::string &filename, const std::string &path, const TextureDiskCacheKey &key, const u32 *data, u32 dstFmt);
+
+	std::atomic<bool> enabled_{ false };
+	std::string basePath_;
+
+	std::mutex mutex_;
+	// Filenames that exist, so misses don't have to touch the disk.
+	std::set<std::string> files_;
+	// Filenames being written right now.
+	std::set<std::string> saving_;
+};
@@ -20,6 +20,7 @@
 #include <cstring>
 #include <cmath>
 
+#include "ppsspp_config.h"
 #include "GPU/Common/TextureScalerCommon.h"
 
 #include "Core/Config.h"
@@ -30,9 +31,16 @@
 #include "Common/CPUDetect.h"
 #include "ext/xbrz/xbrz.h"
 
+#ifdef _M_SSE
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
 #if _M_SSE >= 0x401
 #include <smmintrin.h>
 #endif
+#if PPSSPP_ARCH(ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 // Report the time and throughput for each larger scaling operation in the log
 //#define SCALING_MEASURE_TIME
@@ -89,92 +97,229 @@ void convolve3x3(u32* data, u32* out, const int kernel[3][3], int width, int hei
 }
 
 // deposterization: smoothes posterized gradients from low-color-depth (e.g. 444, 565, compressed) sources
-void deposterizeH(u32* data, u32* out, int w, int l, int u) {
+inline u32 deposterizePixel(u32 prev, u32 center, u32 next) {
 	static const int T = 8;
+	u32 result = 0;
+	for (int c = 0; c < 4; ++c) {
+		u8 pc = ((prev >> c * 8) & 0xFF);
+		u8 cc = ((center >> c * 8) & 0xFF);
+		u8 nc = ((next >> c * 8) & 0xFF);
+		if ((pc != nc) && ((pc == cc && abs((int)((int)nc) - cc) <= T) || (nc == cc && abs((int)((int)pc) - cc) <= T))) {
+			// blend this component
+			result |= ((nc + pc) / 2) << (c * 8);
+		} else {
+			// no change for this component
+			result |= cc << (c * 8);
+		}
+	}
+	return result;
+}
+
+#ifdef _M_SSE
+// The AVX2 versions of the row kernels do 8 pixels at a time, and return where they stopped.
+// The rest go through the SSE2 loop.
+
+PPSSPP_TARGET_AVX2
+int deposterizeRowAVX2(const u32 *prev, const u32 *center, const u32 *next, u32 *out, int x, int end) {
+	const __m256i T = _mm256_set1_epi8(8);
+	const __m256i zero = _mm256_setzero_si256();
+	for (; x + 8 <= end; x += 8) {
+		__m256i p = _mm256_loadu_si256((const __m256i *)(prev + x));
+		__m256i c = _mm256_loadu_si256((const __m256i *)(center + x));
+		__m256i n = _mm256_loadu_si256((const __m256i *)(next + x));
+		__m256i pNear = _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_or_si256(_mm256_subs_epu8(p, c), _mm256_subs_epu8(c, p)), T), zero);
+		__m256i nNear = _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_or_si256(_mm256_subs_epu8(n, c), _mm256_subs_epu8(c, n)), T), zero);
+		__m256i blend = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(p, c), nNear), _mm256_and_si256(_mm256_cmpeq_epi8(n, c), pNear));
+		blend = _mm256_andnot_si256(_mm256_cmpeq_epi8(p, n), blend);
+		__m256i avg = _mm256_sub_epi8(_mm256_avg_epu8(p, n), _mm256_and_si256(_mm256_xor_si256(p, n), _mm256_set1_epi8(1)));
+		_mm256_storeu_si256((__m256i *)(out + x), _mm256_blendv_epi8(c, avg, blend));
+	}
+	return x;
+}
+
+// Sums the absolute differences of the four bytes of each pixel.
+PPSSPP_TARGET_AVX2
+static inline __m256i distanceAVX2(const u32 *p, __m256i c) {
+	__m256i n = _mm256_loadu_si256((const __m256i *)p);
+	__m256i d = _mm256_or_si256(_mm256_subs_epu8(n, c), _mm256_subs_epu8(c, n));
+	__m256i pairs = _mm256_add_epi16(_mm256_and_si256(d, _mm256_set1_epi16(0x00FF)), _mm256_srli_epi16(d, 8));
+	return _mm256_madd_epi16(pairs, _mm256_set1_epi16(1));
+}
+
+PPSSPP_TARGET_AVX2
+int distanceMaskRowAVX2(const u32 *row, int width, u32 *out, int x, int end) {
+	const u32 *above = row - width;
+	const u32 *below = row + width;
+	for (; x + 8 <= end; x += 8) {
+		__m256i c = _mm256_loadu_si256((const __m256i *)(row + x));
+		__m256i dist = _mm256_add_epi32(distanceAVX2(above + x - 1, c), distanceAVX2(above + x, c));
+		dist = _mm256_add_epi32(dist, distanceAVX2(above + x + 1, c));
+		dist = _mm256_add_epi32(dist, distanceAVX2(row + x - 1, c));
+		dist = _mm256_add_epi32(dist, distanceAVX2(row + x + 1, c));
+		dist = _mm256_add_epi32(dist, distanceAVX2(below + x - 1, c));
+		dist = _mm256_add_epi32(dist, distanceAVX2(below + x, c));
+		dist = _mm256_add_epi32(dist, distanceAVX2(below + x + 1, c));
+		_mm256_storeu_si256((__m256i *)(out + x), dist);
+	}
+	return x;
+}
+#endif
+
+// Same as deposterizePixel() for out[x] from x to end, 4 pixels at a time.  Returns where it stopped.
+int deposterizeRowSIMD(const u32 *prev, const u32 *center, const u32 *next, u32 *out, int x, int end) {
+#ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		x = deposterizeRowAVX2(prev, center, next, out, x, end);
+	}
+	if (cpu_info.bSSE2) {
+		const __m128i T = _mm_set1_epi8(8);
+		const __m128i zero = _mm_setzero_si128();
+		for (; x + 4 <= end; x += 4) {
+			__m128i p = _mm_loadu_si128((const __m128i *)(prev + x));
+			__m128i c = _mm_loadu_si128((const __m128i *)(center + x));
+			__m128i n = _mm_loadu_si128((const __m128i *)(next + x));
+			// Unsigned |a - b| <= T, per byte.
+			__m128i pNear = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_or_si128(_mm_subs_epu8(p, c), _mm_subs_epu8(c, p)), T), zero);
+			__m128i nNear = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_or_si128(_mm_subs_epu8(n, c), _mm_subs_epu8(c, n)), T), zero);
+			__m128i blend = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(p, c), nNear), _mm_and_si128(_mm_cmpeq_epi8(n, c), pNear));
+			blend = _mm_andnot_si128(_mm_cmpeq_epi8(p, n), blend);
+			// _mm_avg_epu8 rounds up, the scalar version rounds down.
+			__m128i avg = _mm_sub_epi8(_mm_avg_epu8(p, n), _mm_and_si128(_mm_xor_si128(p, n), _mm_set1_epi8(1)));
+			_mm_storeu_si128((__m128i *)(out + x), _mm_or_si128(_mm_and_si128(blend, avg), _mm_andnot_si128(blend, c)));
+		}
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	if (cpu_info.bNEON) {
+		const uint8x16_t T = vdupq_n_u8(8);
+		for (; x + 4 <= end; x += 4) {
+			uint8x16_t p = vld1q_u8((const u8 *)(prev + x));
+			uint8x16_t c = vld1q_u8((const u8 *)(center + x));
+			uint8x16_t n = vld1q_u8((const u8 *)(next + x));
+			uint8x16_t pNear = vcleq_u8(vabdq_u8(p, c), T);
+			uint8x16_t nNear = vcleq_u8(vabdq_u8(n, c), T);
+			uint8x16_t blend = vorrq_u8(vandq_u8(vceqq_u8(p, c), nNear), vandq_u8(vceqq_u8(n, c), pNear));
+			blend = vbicq_u8(blend, vceqq_u8(p, n));
+			// vhaddq_u8 rounds down, like the scalar version.
+			vst1q_u8((u8 *)(out + x), vbslq_u8(blend, vhaddq_u8(p, n), c));
+		}
+	}
+#endif
+	return x;
+}
+
+void deposterizeH(u32* data, u32* out, int w, int l, int u) {
 	for (int y = l; y < u; ++y) {
-		for (int x = 0; x < w; ++x) {
-			int inpos = y*w + x;
-			u32 center = data[inpos];
-			if (x == 0 || x == w - 1) {
-				out[y*w + x] = center;
-				continue;
-			}
-			u32 left = data[inpos - 1];
-			u32 right = data[inpos + 1];
-			out[y*w + x] = 0;
-			for (int c = 0; c < 4; ++c) {
-				u8 lc = ((left >> c * 8) & 0xFF);
-				u8 cc = ((center >> c * 8) & 0xFF);
-				u8 rc = ((right >> c * 8) & 0xFF);
-				if ((lc != rc) && ((lc == cc && abs((int)((int)rc) - cc) <= T) || (rc == cc && abs((int)((int)lc) - cc) <= T))) {
-					// blend this component
-					out[y*w + x] |= ((rc + lc) / 2) << (c * 8);
-				} else {
-					// no change for this component
-					out[y*w + x] |= cc << (c * 8);
-				}
-			}
+		const u32 *row = data + y*w;
+		u32 *outRow = out + y*w;
+		outRow[0] = row[0];
+		int x = deposterizeRowSIMD(row - 1, row, row + 1, outRow, 1, w - 1);
+		for (; x < w - 1; ++x) {
+			outRow[x] = deposterizePixel(row[x - 1], row[x], row[x + 1]);
 		}
+		if (w > 1)
+			outRow[w - 1] = row[w - 1];
 	}
 }
 void deposterizeV(u32* data, u32* out, int w, int h, int l, int u) {
-	static const int T = 8;
-	for (int xb = 0; xb < w / BLOCK_SIZE + 1; ++xb) {
-		for (int y = l; y < u; ++y) {
-			for (int x = xb*BLOCK_SIZE; x < (xb + 1)*BLOCK_SIZE && x < w; ++x) {
-				u32 center = data[y    * w + x];
-				if (y == 0 || y == h - 1) {
-					out[y*w + x] = center;
-					continue;
-				}
-				u32 upper = data[(y - 1) * w + x];
-				u32 lower = data[(y + 1) * w + x];
-				out[y*w + x] = 0;
-				for (int c = 0; c < 4; ++c) {
-					u8 uc = ((upper >> c * 8) & 0xFF);
-					u8 cc = ((center >> c * 8) & 0xFF);
-					u8 lc = ((lower >> c * 8) & 0xFF);
-					if ((uc != lc) && ((uc == cc && abs((int)((int)lc) - cc) <= T) || (lc == cc && abs((int)((int)uc) - cc) <= T))) {
-						// blend this component
-						out[y*w + x] |= ((lc + uc) / 2) << (c * 8);
-					} else {
-						// no change for this component
-						out[y*w + x] |= cc << (c * 8);
-					}
-				}
-			}
+	for (int y = l; y < u; ++y) {
+		const u32 *row = data + y*w;
+		u32 *outRow = out + y*w;
+		if (y == 0 || y == h - 1) {
+			memcpy(outRow, row, w * sizeof(u32));
+			continue;
+		}
+		int x = deposterizeRowSIMD(row - w, row, row + w, outRow, 0, w);
+		for (; x < w; ++x) {
+			outRow[x] = deposterizePixel(row[x - w], row[x], row[x + w]);
 		}
 	}
 }
 
 // generates a distance mask value for each pixel in data
 // higher values -> larger distance to the surrounding pixels
-void generateDistanceMask(u32* data, u32* out, int width, int height, int l, int u) {
-	for (int yb = 0; yb < (u - l) / BLOCK_SIZE + 1; ++yb) {
-		for (int xb = 0; xb < width / BLOCK_SIZE + 1; ++xb) {
-			for (int y = l + yb*BLOCK_SIZE; y < l + (yb + 1)*BLOCK_SIZE && y < u; ++y) {
-				for (int x = xb*BLOCK_SIZE; x < (xb + 1)*BLOCK_SIZE && x < width; ++x) {
-					const u32 center = data[y*width + x];
-					u32 dist = 0;
-					for (int yoff = -1; yoff <= 1; ++yoff) {
-						int yy = y + yoff;
-						if (yy == height || yy == -1) {
-							dist += 1200; // assume distance at borders, usually makes for better result
-							continue;
-						}
-						for (int xoff = -1; xoff <= 1; ++xoff) {
-							if (yoff == 0 && xoff == 0) continue;
-							int xx = x + xoff;
-							if (xx == width || xx == -1) {
-								dist += 400; // assume distance at borders, usually makes for better result
-								continue;
-							}
-							dist += DISTANCE(data[yy*width + xx], center);
-						}
-					}
-					out[y*width + x] = dist;
-				}
+inline u32 distanceMaskPixel(const u32 *data, int width, int height, int x, int y) {
+	const u32 center = data[y*width + x];
+	u32 dist = 0;
+	for (int yoff = -1; yoff <= 1; ++yoff) {
+		int yy = y + yoff;
+		if (yy == height || yy == -1) {
+			dist += 1200; // assume distance at borders, usually makes for better result
+			continue;
+		}
+		for (int xoff = -1; xoff <= 1; ++xoff) {
+			if (yoff == 0 && xoff == 0) continue;
+			int xx = x + xoff;
+			if (xx == width || xx == -1) {
+				dist += 400; // assume distance at borders, usually makes for better result
+				continue;
 			}
+			dist += DISTANCE(data[yy*width + xx], center);
+		}
+	}
+	return dist;
+}
+
+// Same as distanceMaskPixel() for a row away from the borders, 4 pixels at a time.  Returns where it stopped.
+int distanceMaskRowSIMD(const u32 *row, int width, u32 *out, int x, int end) {
+	const u32 *above = row - width;
+	const u32 *below = row + width;
+#ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		x = distanceMaskRowAVX2(row, width, out, x, end);
+	}
+	if (cpu_info.bSSE2) {
+		const __m128i ones = _mm_set1_epi16(1);
+		const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+		// Sums the absolute differences of the four bytes of each pixel.
+		auto distance = [&](const u32 *p, __m128i c) {
+			__m128i n = _mm_loadu_si128((const __m128i *)p);
+			__m128i d = _mm_or_si128(_mm_subs_epu8(n, c), _mm_subs_epu8(c, n));
+			__m128i pairs = _mm_add_epi16(_mm_and_si128(d, lowBytes), _mm_srli_epi16(d, 8));
+			return _mm_madd_epi16(pairs, ones);
+		};
+		for (; x + 4 <= end; x += 4) {
+			__m128i c = _mm_loadu_si128((const __m128i *)(row + x));
+			__m128i dist = _mm_add_epi32(distance(above + x - 1, c), distance(above + x, c));
+			dist = _mm_add_epi32(dist, distance(above + x + 1, c));
+			dist = _mm_add_epi32(dist, distance(row + x - 1, c));
+			dist = _mm_add_epi32(dist, distance(row + x + 1, c));
+			dist = _mm_add_epi32(dist, distance(below + x - 1, c));
+			dist = _mm_add_epi32(dist, distance(below + x, c));
+			dist = _mm_add_epi32(dist, distance(below + x + 1, c));
+			_mm_storeu_si128((__m128i *)(out + x), dist);
+		}
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	if (cpu_info.bNEON) {
+		auto distance = [&](const u32 *p, uint8x16_t c) {
+			return vpaddlq_u16(vpaddlq_u8(vabdq_u8(vld1q_u8((const u8 *)p), c)));
+		};
+		for (; x + 4 <= end; x += 4) {
+			uint8x16_t c = vld1q_u8((const u8 *)(row + x));
+			uint32x4_t dist = vaddq_u32(distance(above + x - 1, c), distance(above + x, c));
+			dist = vaddq_u32(dist, distance(above + x + 1, c));
+			dist = vaddq_u32(dist, distance(row + x - 1, c));
+			dist = vaddq_u32(dist, distance(row + x + 1, c));
+			dist = vaddq_u32(dist, distance(below + x - 1, c));
+			dist = vaddq_u32(dist, distance(below + x, c));
+			dist = vaddq_u32(dist, distance(below + x + 1, c));
+			vst1q_u32(out + x, dist);
+		}
+	}
+#endif
+	return x;
+}
+
+void generateDistanceMask(u32* data, u32* out, int width, int height, int l, int u) {
+	for (int y = l; y < u; ++y) {
+		u32 *outRow = out + y*width;
+		int x = 0;
+		if (y > 0 && y < height - 1 && width > 2) {
+			outRow[0] = distanceMaskPixel(data, width, height, 0, y);
+			x = distanceMaskRowSIMD(data + y*width, width, outRow, 1, width - 1);
+		}
+		for (; x < width; ++x) {
+			outRow[x] = distanceMaskPixel(data, width, height, x, y);
 		}
 	}
 }
@@ -215,6 +360,15 @@ inline float mitchell(float x, float B, float C) {
 float bicubicWeights[2][4][5][5][5][5];
 float bicubicInvSums[2][4][5][5];
 
+// The same weights without the zeros, in the same order, so the SIMD path doesn't have to check.
+struct BicubicTaps {
+	int count;
+	u8 sx[25];
+	u8 sy[25];
+	float weights[25];
+};
+BicubicTaps bicubicTaps[2][4][5][5];
+
 // initialize pre-computed weights array
 void initBicubicWeights() {
 	float B[2] = { 1.0f, 0.334f };
@@ -235,6 +389,20 @@ void initBicubicWeights() {
 						}
 					}
 					bicubicInvSums[type][factor - 2][x][y] = 1.0f / sum;
+
+					BicubicTaps &taps = bicubicTaps[type][factor - 2][x][y];
+					taps.count = 0;
+					for (int sx = 0; sx < 5; ++sx) {
+						for (int sy = 0; sy < 5; ++sy) {
+							float weight = bicubicWeights[type][factor - 2][x][y][sx][sy];
+							if (weight != 0.0f) {
+								taps.sx[taps.count] = sx;
+								taps.sy[taps.count] = sy;
+								taps.weights[taps.count] = weight;
+								taps.count++;
+							}
+						}
+					}
 				}
 			}
 		}
@@ -284,35 +452,76 @@ void scaleBicubicT(u32* data, u32* out, int w, int h, int l, int u) {
 template<int f, int T>
 void scaleBicubicTSSE41(u32* data, u32* out, int w, int h, int l, int u) {
 	int outw = w*f;
-	for (int yb = 0; yb < (u - l)*f / BLOCK_SIZE + 1; ++yb) {
-		for (int xb = 0; xb < w*f / BLOCK_SIZE + 1; ++xb) {
-			for (int y = l*f + yb*BLOCK_SIZE; y < l*f + (yb + 1)*BLOCK_SIZE && y < u*f; ++y) {
-				for (int x = xb*BLOCK_SIZE; x < (xb + 1)*BLOCK_SIZE && x < w*f; ++x) {
-					__m128 result = _mm_set1_ps(0.0f);
-					int cx = x / f, cy = y / f;
-					// sample supporting pixels in original image
-					for (int sx = -2; sx <= 2; ++sx) {
-						for (int sy = -2; sy <= 2; ++sy) {
-							float weight = bicubicWeights[T][f - 2][x%f][y%f][sx + 2][sy + 2];
-							if (weight != 0.0f) {
-								// clamp pixel locations
-								int csy = std::max(std::min(sy + cy, h - 1), 0);
-								int csx = std::max(std::min(sx + cx, w - 1), 0);
-								// sample & add weighted components
-								__m128i sample = _mm_cvtsi32_si128(data[csy*w + csx]);
-								sample = _mm_cvtepu8_epi32(sample);
-								__m128 col = _mm_cvtepi32_ps(sample);
-								col = _mm_mul_ps(col, _mm_set1_ps(weight));
-								result = _mm_add_ps(result, col);
-							}
-						}
-					}
-					// generate and write result
-					__m128i pixel = _mm_cvtps_epi32(_mm_mul_ps(result, _mm_set1_ps(bicubicInvSums[T][f - 2][x%f][y%f])));
-					pixel = _mm_packs_epi32(pixel, pixel);
-					pixel = _mm_packus_epi16(pixel, pixel);
-					out[y*outw + x] = _mm_cvtsi128_si32(pixel);
+	for (int y = l*f; y < u*f; ++y) {
+		const int cy = y / f;
+		// Clamp the rows sampled once for the whole row.
+		const u32 *rows[5];
+		for (int sy = -2; sy <= 2; ++sy) {
+			rows[sy + 2] = data + std::max(std::min(sy + cy, h - 1), 0) * w;
+		}
+		for (int x = 0; x < outw; ++x) {
+			const int cx = x / f;
+			int cols[5];
+			for (int sx = -2; sx <= 2; ++sx) {
+				cols[sx + 2] = std::max(std::min(sx + cx, w - 1), 0);
+			}
+			const BicubicTaps &taps = bicubicTaps[T][f - 2][x%f][y%f];
+			__m128 result = _mm_set1_ps(0.0f);
+			// sample supporting pixels in original image
+			for (int i = 0; i < taps.count; ++i) {
+				// sample & add weighted components
+				__m128i sample = _mm_cvtsi32_si128(rows[taps.sy[i]][cols[taps.sx[i]]]);
+				sample = _mm_cvtepu8_epi32(sample);
+				__m128 col = _mm_cvtepi32_ps(sample);
+				col = _mm_mul_ps(col, _mm_set1_ps(taps.weights[i]));
+				result = _mm_add_ps(result, col);
+			}
+			// generate and write result
+			__m128i pixel = _mm_cvtps_epi32(_mm_mul_ps(result, _mm_set1_ps(bicubicInvSums[T][f - 2][x%f][y%f])));
+			pixel = _mm_packs_epi32(pixel, pixel);
+			pixel = _mm_packus_epi16(pixel, pixel);
+			out[y*outw + x] = _mm_cvtsi128_si32(pixel);
+		}
+	}
+}
+#endif
+
+#ifdef _M_SSE
+// Same as scaleBicubicTSSE41(), two output pixels at a time, one per 128-bit half.  Pixels f apart use the same taps,
+// so each pass over the row does one of the f phases, for pairs of source columns.
+template<int f, int T>
+PPSSPP_TARGET_AVX2
+void scaleBicubicTAVX2(u32* data, u32* out, int w, int h, int l, int u) {
+	int outw = w*f;
+	for (int y = l*f; y < u*f; ++y) {
+		const int cy = y / f;
+		const u32 *rows[5];
+		for (int sy = -2; sy <= 2; ++sy) {
+			rows[sy + 2] = data + std::max(std::min(sy + cy, h - 1), 0) * w;
+		}
+		for (int phase = 0; phase < f; ++phase) {
+			const BicubicTaps &taps = bicubicTaps[T][f - 2][phase][y%f];
+			const float invSum = bicubicInvSums[T][f - 2][phase][y%f];
+			for (int cx = 0; cx < w; cx += 2) {
+				// The last column of an odd width pairs with itself.
+				const int cx2 = std::min(cx + 1, w - 1);
+				int cols[2][5];
+				for (int sx = -2; sx <= 2; ++sx) {
+					cols[0][sx + 2] = std::max(std::min(sx + cx, w - 1), 0);
+					cols[1][sx + 2] = std::max(std::min(sx + cx2, w - 1), 0);
+				}
+				__m256 result = _mm256_setzero_ps();
+				for (int i = 0; i < taps.count; ++i) {
+					const u32 *row = rows[taps.sy[i]];
+					__m128i samples = _mm_unpacklo_epi32(_mm_cvtsi32_si128(row[cols[0][taps.sx[i]]]), _mm_cvtsi32_si128(row[cols[1][taps.sx[i]]]));
+					__m256 col = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(samples));
+					result = _mm256_add_ps(result, _mm256_mul_ps(col, _mm256_set1_ps(taps.weights[i])));
 				}
+				__m256i pixels = _mm256_cvtps_epi32(_mm256_mul_ps(result, _mm256_set1_ps(invSum)));
+				pixels = _mm256_packs_epi32(pixels, pixels);
+				pixels = _mm256_packus_epi16(pixels, pixels);
+				out[y*outw + cx*f + phase] = _mm_cvtsi128_si32(_mm256_castsi256_si128(pixels));
+				out[y*outw + cx2*f + phase] = _mm_cvtsi128_si32(_mm256_extracti128_si256(pixels, 1));
 			}
 		}
 	}
@@ -320,6 +529,18 @@ void scaleBicubicTSSE41(u32* data, u32* out, int w, int h, int l, int u) {
 #endif
 
 void scaleBicubicBSpline(int factor, u32* data, u32* out, int w, int h, int l, int u) {
+#ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		switch (factor) {
+		case 2: scaleBicubicTAVX2<2, 0>(data, out, w, h, l, u); break;
+		case 3: scaleBicubicTAVX2<3, 0>(data, out, w, h, l, u); break;
+		case 4: scaleBicubicTAVX2<4, 0>(data, out, w, h, l, u); break;
+		case 5: scaleBicubicTAVX2<5, 0>(data, out, w, h, l, u); break;
+		default: ERROR_LOG(G3D, "Bicubic upsampling only implemented for factors 2 to 5");
+		}
+		return;
+	}
+#endif
 #if _M_SSE >= 0x401
 	if (cpu_info.bSSE4_1) {
 		switch (factor) {
@@ -344,6 +565,18 @@ void scaleBicubicBSpline(int factor, u32* data, u32* out, int w, int h, int l, i
 }
 
 void scaleBicubicMitchell(int factor, u32* data, u32* out, int w, int h, int l, int u) {
+#ifdef _M_SSE
+	if (cpu_info.bAVX2) {
+		switch (factor) {
+		case 2: scaleBicubicTAVX2<2, 1>(data, out, w, h, l, u); break;
+		case 3: scaleBicubicTAVX2<3, 1>(data, out, w, h, l, u); break;
+		case 4: scaleBicubicTAVX2<4, 1>(data, out, w, h, l, u); break;
+		case 5: scaleBicubicTAVX2<5, 1>(data, out, w, h, l, u); break;
+		default: ERROR_LOG(G3D, "Bicubic upsampling only implemented for factors 2 to 5");
+		}
+		return;
+	}
+#endif
 #if _M_SSE >= 0x401
 	if (cpu_info.bSSE4_1) {
 		switch (factor) {
@@ -180,3 +180,112 @@ void Lighter::Light(float colorOut0[4], float colorOut1[4], const float colorIn[
 		colorOut1[i] = lightSum1[i];
 	}
 }
+
+static Lanes4f PowLanes(const Lanes4f &x, float y) {
+	alignas(16) float lanes[4];
+	x.Store(lanes);
+	for (int i = 0; i < 4; i++)
+		lanes[i] = powf(lanes[i], y);
+	return Lanes4f::Load(lanes);
+}
+
+void Lighter::LightBatch(LightingBatch &batch) {
+	const Lanes4f zero(0.0f);
+	const Lanes4f one(1.0f);
+
+	Lanes4f in[4], ambient[4], diffuse[4], specular[4];
+	for (int c = 0; c < 4; c++) {
+		in[c] = Lanes4f::Load(batch.colorIn[c]);
+		ambient[c] = (materialUpdate_ & 1) ? in[c] : Lanes4f(materialAmbient[c]);
+		diffuse[c] = (materialUpdate_ & 2) ? in[c] : Lanes4f(materialDiffuse[c]);
+		specular[c] = (materialUpdate_ & 4) ? in[c] : Lanes4f(materialSpecular[c]);
+	}
+
+	const Lanes4f px = Lanes4f::Load(batch.pos[0]);
+	const Lanes4f py = Lanes4f::Load(batch.pos[1]);
+	const Lanes4f pz = Lanes4f::Load(batch.pos[2]);
+	const Lanes4f nx = Lanes4f::Load(batch.normal[0]);
+	const Lanes4f ny = Lanes4f::Load(batch.normal[1]);
+	const Lanes4f nz = Lanes4f::Load(batch.normal[2]);
+
+	// The light colors have zero alpha, so only the global ambient contributes to it.
+	Lanes4f lightSum0[3], lightSum1[3];
+	for (int c = 0; c < 3; c++) {
+		lightSum0[c] = Lanes4f(globalAmbient[c]) * ambient[c] + Lanes4f(materialEmissive[c]);
+		lightSum1[c] = zero;
+	}
+	Lanes4f alpha0 = Lanes4f(globalAmbient.a) * ambient[3];
+
+	for (int l = 0; l < 4; l++) {
+		if (!gstate.isLightChanEnabled(l))
+			continue;
+
+		GELightType type = gstate.getLightType(l);
+
+		Lanes4f tx(lpos[l * 3]);
+		Lanes4f ty(lpos[l * 3 + 1]);
+		Lanes4f tz(lpos[l * 3 + 2]);
+		if (type != GE_LIGHTTYPE_DIRECTIONAL) {
+			tx = tx - px;
+			ty = ty - py;
+			tz = tz - pz;
+		}
+
+		Lanes4f distanceToLight = Lanes4f::Sqrt(tx * tx + ty * ty + tz * tz);
+		Lanes4f hasDistance = distanceToLight > zero;
+		tx = Lanes4f::Select(hasDistance, tx / distanceToLight, tx);
+		ty = Lanes4f::Select(hasDistance, ty / distanceToLight, ty);
+		tz = Lanes4f::Select(hasDistance, tz / distanceToLight, tz);
+
+		Lanes4f dot = Lanes4f::Select(hasDistance, tx * nx + ty * ny + tz * nz, zero);
+		dot = Lanes4f::Max(dot, zero);
+		if (gstate.isUsingPoweredDiffuseLight(l))
+			dot = PowLanes(dot, specCoef_);
+
+		Lanes4f lightScale = zero;
+		switch (type) {
+		case GE_LIGHTTYPE_DIRECTIONAL:
+			lightScale = one;
+			break;
+		case GE_LIGHTTYPE_POINT:
+			lightScale = Lanes4f::Clamp01(one / (Lanes4f(latt[l * 3]) + Lanes4f(latt[l * 3 + 1]) * distanceToLight + Lanes4f(latt[l * 3 + 2]) * distanceToLight * distanceToLight));
+			break;
+		case GE_LIGHTTYPE_SPOT:
+		case GE_LIGHTTYPE_UNKNOWN:
+			{
+				Vec3f lightDir = Vec3f(Vec3Packedf(&ldir[l * 3])).Normalized();
+				Lanes4f norm = Lanes4f::NormalizeMultiplier(tx * tx + ty * ty + tz * tz);
+				Lanes4f angle = (tx * Lanes4f(lightDir.x) + ty * Lanes4f(lightDir.y) + tz * Lanes4f(lightDir.z)) * norm;
+				Lanes4f att = Lanes4f::Clamp01(one / (Lanes4f(latt[l * 3]) + Lanes4f(latt[l * 3 + 1]) * distanceToLight + Lanes4f(latt[l * 3 + 2]) * distanceToLight * distanceToLight));
+				lightScale = Lanes4f::Select(angle >= Lanes4f(lcutoff[l]), att * PowLanes(angle, lconv[l]), zero);
+			}
+			break;
+		default:
+			// ILLEGAL
+			break;
+		}
+
+		if (gstate.isUsingSpecularLight(l)) {
+			// Real PSP specular, the viewer is always at (0, 0, 1.)
+			Lanes4f hz = tz + one;
+			Lanes4f norm = one / Lanes4f::Sqrt(tx * tx + ty * ty + hz * hz);
+			Lanes4f specDot = (tx * nx + ty * ny + hz * nz) * norm;
+			Lanes4f specScale = Lanes4f::Select(specDot > zero, PowLanes(Lanes4f::Max(specDot, zero), specCoef_) * lightScale, zero);
+			for (int c = 0; c < 3; c++)
+				lightSum1[c] = lightSum1[c] + Lanes4f(lcolor[2][l][c]) * specular[c] * specScale;
+		}
+
+		for (int c = 0; c < 3; c++) {
+			Lanes4f diff = Lanes4f(lcolor[1][l][c]) * diffuse[c] * dot;
+			lightSum0[c] = lightSum0[c] + (Lanes4f(lcolor[0][l][c]) * ambient[c] + diff) * lightScale;
+		}
+	}
+
+	// The colors must eventually be clamped, but we expect the caller to do that.
+	for (int c = 0; c < 3; c++) {
+		lightSum0[c].Store(batch.colorOut0[c]);
+		lightSum1[c].Store(batch.colorOut1[c]);
+	}
+	alpha0.Store(batch.colorOut0[3]);
+	zero.Store(batch.colorOut1[3]);
+}
@@ -19,11 +19,16 @@
 
 #include <cstring>
 
+#include "ppsspp_config.h"
 #include "Common/CommonTypes.h"
 #include "Core/Reporting.h"
 #include "GPU/ge_constants.h"
 #include "GPU/Math3D.h"
 
+#if PPSSPP_ARCH(ARM64) && !defined(_M_SSE)
+#include <arm_neon.h>
+#endif
+
 struct Color4 {
 	float r, g, b, a;
 
@@ -61,12 +66,121 @@ struct Color4 {
 	}
 };
 
+// Four floats, one per vertex, for the structure-of-arrays batch paths.
+// Comparisons return a mask for Select(), all bits set where true.
+struct Lanes4f {
+#if defined(_M_SSE)
+	__m128 v;
+
+	Lanes4f() {}
+	Lanes4f(__m128 _v) : v(_v) {}
+	explicit Lanes4f(float f) : v(_mm_set1_ps(f)) {}
+
+	static Lanes4f Load(const float *p) { return _mm_load_ps(p); }
+	void Store(float *p) const { _mm_store_ps(p, v); }
+
+	Lanes4f operator +(const Lanes4f &o) const { return _mm_add_ps(v, o.v); }
+	Lanes4f operator -(const Lanes4f &o) const { return _mm_sub_ps(v, o.v); }
+	Lanes4f operator *(const Lanes4f &o) const { return _mm_mul_ps(v, o.v); }
+	Lanes4f operator /(const Lanes4f &o) const { return _mm_div_ps(v, o.v); }
+	Lanes4f operator >(const Lanes4f &o) const { return _mm_cmpgt_ps(v, o.v); }
+	Lanes4f operator >=(const Lanes4f &o) const { return _mm_cmpge_ps(v, o.v); }
+	Lanes4f operator ==(const Lanes4f &o) const { return _mm_cmpeq_ps(v, o.v); }
+
+	static Lanes4f Min(const Lanes4f &a, const Lanes4f &b) { return _mm_min_ps(a.v, b.v); }
+	static Lanes4f Max(const Lanes4f &a, const Lanes4f &b) { return _mm_max_ps(a.v, b.v); }
+	static Lanes4f Sqrt(const Lanes4f &a) { return _mm_sqrt_ps(a.v); }
+	// Same precision as Vec3f::Normalized(), so the batch matches the per-vertex path.
+	static Lanes4f NormalizeMultiplier(const Lanes4f &len2) { return _mm_rsqrt_ps(len2.v); }
+	static Lanes4f Select(const Lanes4f &mask, const Lanes4f &a, const Lanes4f &b) {
+		return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+	}
+#elif PPSSPP_ARCH(ARM64)
+	float32x4_t v;
+
+	Lanes4f() {}
+	Lanes4f(float32x4_t _v) : v(_v) {}
+	explicit Lanes4f(float f) : v(vdupq_n_f32(f)) {}
+
+	static Lanes4f Load(const float *p) { return vld1q_f32(p); }
+	void Store(float *p) const { vst1q_f32(p, v); }
+
+	Lanes4f operator +(const Lanes4f &o) const { return vaddq_f32(v, o.v); }
+	Lanes4f operator -(const Lanes4f &o) const { return vsubq_f32(v, o.v); }
+	Lanes4f operator *(const Lanes4f &o) const { return vmulq_f32(v, o.v); }
+	Lanes4f operator /(const Lanes4f &o) const { return vdivq_f32(v, o.v); }
+	Lanes4f operator >(const Lanes4f &o) const { return vreinterpretq_f32_u32(vcgtq_f32(v, o.v)); }
+	Lanes4f operator >=(const Lanes4f &o) const { return vreinterpretq_f32_u32(vcgeq_f32(v, o.v)); }
+	Lanes4f operator ==(const Lanes4f &o) const { return vreinterpretq_f32_u32(vceqq_f32(v, o.v)); }
+
+	static Lanes4f Min(const Lanes4f &a, const Lanes4f &b) { return vminq_f32(a.v, b.v); }
+	static Lanes4f Max(const Lanes4f &a, const Lanes4f &b) { return vmaxq_f32(a.v, b.v); }
+	static Lanes4f Sqrt(const Lanes4f &a) { return vsqrtq_f32(a.v); }
+	static Lanes4f NormalizeMultiplier(const Lanes4f &len2) { return vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(len2.v)); }
+	static Lanes4f Select(const Lanes4f &mask, const Lanes4f &a, const Lanes4f &b) {
+		return vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v);
+	}
+#else
+	float v[4];
+
+	Lanes4f() {}
+	explicit Lanes4f(float f) { v[0] = f; v[1] = f; v[2] = f; v[3] = f; }
+
+	static Lanes4f Load(const float *p) { Lanes4f r; memcpy(r.v, p, sizeof(r.v)); return r; }
+	void Store(float *p) const { memcpy(p, v, sizeof(v)); }
+
+	Lanes4f operator +(const Lanes4f &o) const { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = v[i] + o.v[i]; return r; }
+	Lanes4f operator -(const Lanes4f &o) const { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = v[i] - o.v[i]; return r; }
+	Lanes4f operator *(const Lanes4f &o) const { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = v[i] * o.v[i]; return r; }
+	Lanes4f operator /(const Lanes4f &o) const { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = v[i] / o.v[i]; return r; }
+	Lanes4f operator >(const Lanes4f &o) const { Lanes4f r; for (int i = 0; i < 4; i++) r.SetMask(i, v[i] > o.v[i]); return r; }
+	Lanes4f operator >=(const Lanes4f &o) const { Lanes4f r; for (int i = 0; i < 4; i++) r.SetMask(i, v[i] >= o.v[i]); return r; }
+	Lanes4f operator ==(const Lanes4f &o) const { Lanes4f r; for (int i = 0; i < 4; i++) r.SetMask(i, v[i] == o.v[i]); return r; }
+
+	static Lanes4f Min(const Lanes4f &a, const Lanes4f &b) { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return r; }
+	static Lanes4f Max(const Lanes4f &a, const Lanes4f &b) { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return r; }
+	static Lanes4f Sqrt(const Lanes4f &a) { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = sqrtf(a.v[i]); return r; }
+	static Lanes4f NormalizeMultiplier(const Lanes4f &len2) { Lanes4f r; for (int i = 0; i < 4; i++) r.v[i] = 1.0f / sqrtf(len2.v[i]); return r; }
+	static Lanes4f Select(const Lanes4f &mask, const Lanes4f &a, const Lanes4f &b) {
+		Lanes4f r;
+		for (int i = 0; i < 4; i++) {
+			u32 m;
+			memcpy(&m, &mask.v[i], sizeof(m));
+			r.v[i] = m ? a.v[i] : b.v[i];
+		}
+		return r;
+	}
+
+	void SetMask(int i, bool set) {
+		u32 m = set ? 0xFFFFFFFF : 0;
+		memcpy(&v[i], &m, sizeof(m));
+	}
+#endif
+
+	static Lanes4f Clamp01(const Lanes4f &a) {
+		return Min(Max(a, Lanes4f(0.0f)), Lanes4f(1.0f));
+	}
+};
+
+// A few vertices in structure-of-arrays form, one lane each, for Lighter::LightBatch().
+struct LightingBatch {
+	enum { LANES = 4 };
+
+	alignas(16) float pos[3][LANES];
+	alignas(16) float normal[3][LANES];
+	alignas(16) float colorIn[4][LANES];
+	alignas(16) float colorOut0[4][LANES];
+	alignas(16) float colorOut1[4][LANES];
+};
+
 // Convenient way to do precomputation to save the parts of the lighting calculation
 // that's common between the many vertices of a draw call.
 class Lighter {
 public:
 	Lighter(int vertType);
 	void Light(float colorOut0[4], float colorOut1[4], const float colorIn[4], const Vec3f &pos, const Vec3f &normal);
+	// Same as Light(), for LightingBatch::LANES vertices at a time.
+	void LightBatch(LightingBatch &batch);
 
 private:
 	Color4 globalAmbient;
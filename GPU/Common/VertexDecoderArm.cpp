@@ -40,9 +40,6 @@ bool NEONMorphing = false;
 // Used only in non-NEON mode.
 alignas(16) static float skinMatrix[12];
 
-// Will be used only in NEON mode.
-alignas(16) static float bones[16 * 8];  // First two are kept in registers
-alignas(16) static float boneMask[4] = {1.0f, 1.0f, 1.0f, 0.0f};
 
 // NEON register allocation:
 // Q0: Texture scaling parameters
@@ -53,7 +50,7 @@ alignas(16) static float boneMask[4] = {1.0f, 1.0f, 1.0f, 0.0f};
 // When skinning, we'll use Q4-Q7 as the "matrix accumulator".
 // First two matrices will be preloaded into Q8-Q11 and Q12-Q15 to reduce
 // memory bandwidth requirements.
-// The rest will be dumped to bones as on x86.
+// The rest are read from jitBones as on x86.
 //
 // When morphing, we never skin.  So we're free to use Q4+.
 // Q4 is for color shift values, and Q5 is a secondary multipler inside the morph.
@@ -229,47 +226,13 @@ JittedVertexDecoder VertexDecoderJitCache::Compile(const VertexDecoder &dec, int
 		}
 	}
 
-	// Add code to convert matrices to 4x4.
-	// Later we might want to do this when the matrices are loaded instead.
-	int boneCount = 0;
+	// The bone matrices are already in jitBones as 4x4, see DecodeVerts.
 	if (NEONSkinning && dec.weighttype && g_Config.bSoftwareSkinning) {
-		// Copying from R3 to R4
-		MOVP2R(R3, gstate.boneMatrix);
-		MOVP2R(R4, bones);
-		MOVP2R(R5, boneMask);
-		VLD1(F_32, Q3, R5, 2, ALIGN_128);
-		for (int i = 0; i < dec.nweights; i++) {
-			VLD1(F_32, Q4, R3, 2);  // Load 128 bits even though we just want 96
-			VMUL(F_32, Q4, Q4, Q3);
-			ADD(R3, R3, 12);
-			VLD1(F_32, Q5, R3, 2);
-			VMUL(F_32, Q5, Q5, Q3);
-			ADD(R3, R3, 12);
-			VLD1(F_32, Q6, R3, 2);
-			VMUL(F_32, Q6, Q6, Q3);
-			ADD(R3, R3, 12);
-			VLD1(F_32, Q7, R3, 2);
-			VMUL(F_32, Q7, Q7, Q3);
-			ADD(R3, R3, 12);
-			// First two matrices are in registers.
-			if (i == 0) {
-				VMOV(Q8, Q4);
-				VMOV(Q9, Q5);
-				VMOV(Q10, Q6);
-				VMOV(Q11, Q7);
-				ADD(R4, R4, 16 * 4);
-			} else if (i == 1) {
-				VMOV(Q12, Q4);
-				VMOV(Q13, Q5);
-				VMOV(Q14, Q6);
-				VMOV(Q15, Q7);
-				ADD(R4, R4, 16 * 4);
-			} else {
-				VST1(F_32, Q4, R4, 2, ALIGN_128, REG_UPDATE);
-				VST1(F_32, Q5, R4, 2, ALIGN_128, REG_UPDATE);
-				VST1(F_32, Q6, R4, 2, ALIGN_128, REG_UPDATE);
-				VST1(F_32, Q7, R4, 2, ALIGN_128, REG_UPDATE);
-			}
+		// First two matrices are kept in registers.
+		static const ARMReg boneRegs[8] = { Q8, Q9, Q10, Q11, Q12, Q13, Q14, Q15 };
+		MOVP2R(R4, jitBones);
+		for (int i = 0; i < dec.nweights * 4 && i < 8; i++) {
+			VLD1(F_32, boneRegs[i], R4, 2, ALIGN_128, REG_UPDATE);
 		}
 	}
 
@@ -384,7 +347,7 @@ void VertexDecoderJitCache::Jit_ApplyWeights() {
 		// We construct a matrix in Q4-Q7
 		// We can use Q1 as temp.
 		if (dec_->nweights >= 2) {
-			MOVP2R(scratchReg, bones + 16 * 2);
+			MOVP2R(scratchReg, jitBones + 16 * 2);
 		}
 		for (int i = 0; i < dec_->nweights; i++) {
 			switch (i) {
@@ -27,8 +27,6 @@
 #include "GPU/GPUState.h"
 #include "GPU/Common/VertexDecoderCommon.h"
 
-alignas(16) static float bones[16 * 8];  // First four are kept in registers
-alignas(16) static float boneMask[4] = {1.0f, 1.0f, 1.0f, 0.0f};
 
 static const float by128 = 1.0f / 128.0f;
 static const float by32768 = 1.0f / 32768.0f;
@@ -188,39 +186,15 @@ JittedVertexDecoder VertexDecoderJitCache::Compile(const VertexDecoder &dec, int
 		}
 	}
 
-	// Add code to convert matrices to 4x4.
-	// Later we might want to do this when the matrices are loaded instead.
-	int boneCount = 0;
+	// The bone matrices are already in jitBones as 4x4, see DecodeVerts.
 	if (dec.weighttype && g_Config.bSoftwareSkinning) {
-		// Copying from R3 to R4
-		MOVP2R(X3, gstate.boneMatrix);
-		MOVP2R(X4, bones);
-		MOVP2R(X5, boneMask);
-		fp.LDR(128, INDEX_UNSIGNED, Q3, X5, 0);
-		for (int i = 0; i < dec.nweights; i++) {
-			// Note that INDEX_UNSIGNED does not support offsets not aligned to the data size so we must use POST.
-			fp.LDR(128, INDEX_POST, Q4, X3, 12);  // Load 128 bits even though we just want 96
-			fp.LDR(128, INDEX_POST, Q5, X3, 12);
-			fp.LDR(128, INDEX_POST, Q6, X3, 12);
-			fp.LDR(128, INDEX_POST, Q7, X3, 12);
-			// First four matrices are in registers Q16+.
-			if (i < 4) {
-				fp.FMUL(32, (ARM64Reg)(Q16 + i * 4), Q4, Q3);
-				fp.FMUL(32, (ARM64Reg)(Q17 + i * 4), Q5, Q3);
-				fp.FMUL(32, (ARM64Reg)(Q18 + i * 4), Q6, Q3);
-				fp.FMUL(32, (ARM64Reg)(Q19 + i * 4), Q7, Q3);
-				ADDI2R(X4, X4, 16 * 4);
-			} else {
-				fp.FMUL(32, Q4, Q4, Q3);
-				fp.FMUL(32, Q5, Q5, Q3);
-				fp.FMUL(32, Q6, Q6, Q3);
-				fp.FMUL(32, Q7, Q7, Q3);
-				fp.STR(128, INDEX_UNSIGNED, Q4, X4, 0);
-				fp.STR(128, INDEX_UNSIGNED, Q5, X4, 16);
-				fp.STR(128, INDEX_UNSIGNED, Q6, X4, 32);
-				fp.STR(128, INDEX_UNSIGNED, Q7, X4, 48);
-				ADDI2R(X4, X4, 16 * 4);
-			}
+		// First four matrices are kept in registers Q16+.
+		MOVP2R(X4, jitBones);
+		for (int i = 0; i < dec.nweights && i < 4; i++) {
+			fp.LDR(128, INDEX_UNSIGNED, (ARM64Reg)(Q16 + i * 4), X4, (16 * i) * 4);
+			fp.LDR(128, INDEX_UNSIGNED, (ARM64Reg)(Q17 + i * 4), X4, (16 * i + 4) * 4);
+			fp.LDR(128, INDEX_UNSIGNED, (ARM64Reg)(Q18 + i * 4), X4, (16 * i + 8) * 4);
+			fp.LDR(128, INDEX_UNSIGNED, (ARM64Reg)(Q19 + i * 4), X4, (16 * i + 12) * 4);
 		}
 	}
 
@@ -309,7 +283,7 @@ bool VertexDecoderJitCache::CompileStep(const VertexDecoder &dec, int step) {
 void VertexDecoderJitCache::Jit_ApplyWeights() {
 	// We construct a matrix in Q4-Q7
 	if (dec_->nweights >= 4) {
-		MOVP2R(scratchReg64, bones + 16 * 4);
+		MOVP2R(scratchReg64, jitBones + 16 * 4);
 	}
 	for (int i = 0; i < dec_->nweights; i++) {
 		switch (i) {
@@ -30,6 +30,7 @@
 #include "Core/HDRemaster.h"
 #include "Core/Reporting.h"
 #include "Core/MIPS/JitCommon/JitCommon.h"
+#include "Core/ThreadPools.h"
 #include "Core/Util/AudioFormat.h"  // for clamp_u8
 #include "GPU/Common/ShaderCommon.h"
 #include "GPU/GPUState.h"
@@ -44,8 +45,33 @@ static const u8 possize[4] = { 3, 3, 6, 12 }, posalign[4] = { 1, 1, 2, 4 };
 static const u8 wtsize[4] = { 0, 1, 2, 4 }, wtalign[4] = { 0, 1, 2, 4 };
 
 // When software skinning. This array is only used when non-jitted - when jitted, the matrix
-// is kept in registers.
-alignas(16) static float skinMatrix[12];
+// is kept in registers.  Per thread, since large draws are decoded on several at once.
+alignas(16) static thread_local float skinMatrix[12];
+
+// Draws with at least this many vertices are split up over the thread pool.
+static const int PARALLEL_DECODE_MIN_VERTS = 2048;
+
+alignas(16) float jitBones[16 * 8];
+
+// Converts the active 4x3 bone matrices to the 4x4 ones the jits read.
+static void PrepareJitBones(int nweights) {
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+	// The x86 jit has always had 1 in w of the translation row, the ARM ones 0.
+	const float translationW = 1.0f;
+#else
+	const float translationW = 0.0f;
+#endif
+	for (int i = 0; i < nweights; i++) {
+		const float *src = gstate.boneMatrix + 12 * i;
+		float *dst = jitBones + 16 * i;
+		for (int row = 0; row < 4; row++) {
+			dst[row * 4 + 0] = src[row * 3 + 0];
+			dst[row * 4 + 1] = src[row * 3 + 1];
+			dst[row * 4 + 2] = src[row * 3 + 2];
+			dst[row * 4 + 3] = row == 3 ? translationW : 0.0f;
+		}
+	}
+}
 
 inline int align(int n, int align) {
 	return (n + (align - 1)) & ~(align - 1);
@@ -1277,9 +1303,7 @@ void VertexDecoder::SetVertexType(u32 fmt, const VertexDecoderOptions &options,
 
 void VertexDecoder::DecodeVerts(u8 *decodedptr, const void *verts, int indexLowerBound, int indexUpperBound) const {
 	// Decode the vertices within the found bounds, once each
-	// decoded_ and ptr_ are used in the steps, so can't be turned into locals for speed.
-	decoded_ = decodedptr;
-	ptr_ = (const u8*)verts + indexLowerBound * size;
+	const u8 *startPtr = (const u8*)verts + indexLowerBound * size;
 
 	int count = indexUpperBound - indexLowerBound + 1;
 	int stride = decFmt.stride;
@@ -1291,21 +1315,57 @@ void VertexDecoder::DecodeVerts(u8 *decodedptr, const void *verts, int indexLowe
 		return;
 	}
 
+	if (jitted_ && weighttype) {
+		// Here rather than in the jitted prologue, which may run on several threads at once below.
+		PrepareJitBones(nweights);
+	}
+
+	if (count >= PARALLEL_DECODE_MIN_VERTS && CanDecodeInParallel() && GlobalThreadPool::NumThreads() > 1) {
+		// Every vertex is decoded on its own, so disjoint ranges can go to different threads.
+		GlobalThreadPool::Loop([&](int lower, int upper) {
+			if (jitted_) {
+				jitted_(startPtr + lower * size, decodedptr + lower * stride, upper - lower);
+			} else {
+				// The interpreter keeps its position in the decoder, so each range needs its own.
+				VertexDecoder dec = *this;
+				dec.InterpretVerts(decodedptr + lower * stride, startPtr + lower * size, upper - lower);
+			}
+		}, 0, count, TaskPriority::HIGH);
+		return;
+	}
+
 	if (jitted_) {
 		// We've compiled the steps into optimized machine code, so just jump!
-		jitted_(ptr_, decoded_, count);
+		jitted_(startPtr, decodedptr, count);
 	} else {
-		// Interpret the decode steps
-		for (; count; count--) {
-			for (int i = 0; i < numSteps_; i++) {
-				((*this).*steps_[i])();
-			}
-			ptr_ += size;
-			decoded_ += stride;
+		InterpretVerts(decodedptr, startPtr, count);
+	}
+}
+
+void VertexDecoder::InterpretVerts(u8 *decodedptr, const u8 *ptr, int count) const {
+	// decoded_ and ptr_ are used in the steps, so can't be turned into locals for speed.
+	decoded_ = decodedptr;
+	ptr_ = ptr;
+
+	const int stride = decFmt.stride;
+	for (; count; count--) {
+		for (int i = 0; i < numSteps_; i++) {
+			((*this).*steps_[i])();
 		}
+		ptr_ += size;
+		decoded_ += stride;
 	}
 }
 
+bool VertexDecoder::CanDecodeInParallel() const {
+#if PPSSPP_ARCH(ARM)
+	// The ARM jit passes the skinning matrix through memory for each vertex.
+	if (jitted_ && weighttype != 0)
+		return false;
+#endif
+	return true;
+}
+
 static const char *posnames[4] = { "?", "s8", "s16", "f" };
 static const char *nrmnames[4] = { "", "s8", "s16", "f" };
 static const char *tcnames[4] = { "", "u8", "u16", "f" };
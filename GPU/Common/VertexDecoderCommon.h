@@ -438,6 +438,10 @@ int TranslateNumBones(int bones);
 
 typedef void(*JittedVertexDecoder)(const u8 *src, u8 *dst, int count);
 
+// The active bone matrices as 4x4, for jitted decoders that skin.  DecodeVerts fills this before
+// running them, so the threads decoding parts of a draw only ever read it.
+alignas(16) extern float jitBones[16 * 8];
+
 struct VertexDecoderOptions {
 	bool expandAllWeightsToFloat;
 	bool expand8BitNormalsToFloat;
@@ -550,6 +554,9 @@ class VertexDecoder {
 	// Ugly for speed.
 	int ToString(char *output) const;
 
+	void InterpretVerts(u8 *decoded, const u8 *ptr, int count) const;
+	bool CanDecodeInParallel() const;
+
 	// Mutable decoder state
 	mutable u8 *decoded_;
 	mutable const u8 *ptr_;
@@ -26,10 +26,6 @@
 #include "GPU/GPUState.h"
 #include "GPU/Common/VertexDecoderCommon.h"
 
-// We start out by converting the active matrices into 4x4 which are easier to multiply with
-// using SSE / NEON and store them here.
-alignas(16) static float bones[16 * 8];
-
 using namespace Gen;
 
 alignas(16) static const float by128[4] = {
@@ -46,9 +42,6 @@ alignas(16) static const float by32768_11[4] = {
 	1.0f / 32768.0f, 1.0f / 32768.0f, 1.0f, 1.0f,
 };
 
-alignas(16) static const u32 threeMasks[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0 };
-alignas(16) static const u32 aOne[4] = {0, 0, 0, 0x3F800000};
-
 alignas(16) static const float by16384[4] = {
 	1.0f / 16384.0f, 1.0f / 16384.0f, 1.0f / 16384.0f, 1.0f / 16384.0f,
 };
@@ -213,32 +206,7 @@ JittedVertexDecoder VertexDecoderJitCache::Compile(const VertexDecoder &dec, int
 		}
 	}
 
-	// Add code to convert matrices to 4x4.
-	// Later we might want to do this when the matrices are loaded instead.
-	int boneCount = 0;
-	if (dec.weighttype && g_Config.bSoftwareSkinning) {
-		MOV(PTRBITS, R(tempReg1), ImmPtr(&threeMasks));
-		MOVAPS(XMM4, MatR(tempReg1));
-		MOV(PTRBITS, R(tempReg1), ImmPtr(&aOne));
-		MOVUPS(XMM5, MatR(tempReg1));
-		MOV(PTRBITS, R(tempReg1), ImmPtr(gstate.boneMatrix));
-		MOV(PTRBITS, R(tempReg2), ImmPtr(bones));
-		for (int i = 0; i < dec.nweights; i++) {
-			MOVUPS(XMM0, MDisp(tempReg1, (12 * i) * 4));
-			MOVUPS(XMM1, MDisp(tempReg1, (12 * i + 3) * 4));
-			MOVUPS(XMM2, MDisp(tempReg1, (12 * i + 3 * 2) * 4));
-			MOVUPS(XMM3, MDisp(tempReg1, (12 * i + 3 * 3) * 4));
-			ANDPS(XMM0, R(XMM4));
-			ANDPS(XMM1, R(XMM4));
-			ANDPS(XMM2, R(XMM4));
-			ANDPS(XMM3, R(XMM4));
-			ORPS(XMM3, R(XMM5));
-			MOVAPS(MDisp(tempReg2, (16 * i) * 4), XMM0);
-			MOVAPS(MDisp(tempReg2, (16 * i + 4) * 4), XMM1);
-			MOVAPS(MDisp(tempReg2, (16 * i + 8) * 4), XMM2);
-			MOVAPS(MDisp(tempReg2, (16 * i + 12) * 4), XMM3);
-		}
-	}
+	// The bone matrices are already in jitBones as 4x4, see DecodeVerts.
 
 	// Keep the scale/offset in a few fp registers if we need it.
 	if (prescaleStep) {
@@ -460,7 +428,7 @@ void VertexDecoderJitCache::Jit_WeightsFloat() {
 }
 
 void VertexDecoderJitCache::Jit_WeightsU8Skin() {
-	MOV(PTRBITS, R(tempReg2), ImmPtr(&bones));
+	MOV(PTRBITS, R(tempReg2), ImmPtr(&jitBones));
 
 #ifdef _M_X64
 	if (dec_->nweights > 4) {
@@ -570,7 +538,7 @@ void VertexDecoderJitCache::Jit_WeightsU8Skin() {
 }
 
 void VertexDecoderJitCache::Jit_WeightsU16Skin() {
-	MOV(PTRBITS, R(tempReg2), ImmPtr(&bones));
+	MOV(PTRBITS, R(tempReg2), ImmPtr(&jitBones));
 
 #ifdef _M_X64
 	if (dec_->nweights > 6) {
@@ -684,7 +652,7 @@ void VertexDecoderJitCache::Jit_WeightsU16Skin() {
 }
 
 void VertexDecoderJitCache::Jit_WeightsFloatSkin() {
-	MOV(PTRBITS, R(tempReg2), ImmPtr(&bones));
+	MOV(PTRBITS, R(tempReg2), ImmPtr(&jitBones));
 	for (int j = 0; j < dec_->nweights; j++) {
 		MOVSS(XMM1, MDisp(srcReg, dec_->weightoff + j * 4));
 		SHUFPS(XMM1, R(XMM1), _MM_SHUFFLE(0, 0, 0, 0));
@@ -174,6 +174,7 @@ void TextureCacheD3D11::StartFrame() {
 		// INFO_LOG(G3D, "Scaled %i texels", texelsScaledThisFrame_);
 	}
 	texelsScaledThisFrame_ = 0;
+	PollScaleJobs();
 	if (clearCacheNextFrame_) {
 		Clear(true);
 		clearCacheNextFrame_ = false;
@@ -502,16 +503,7 @@ void TextureCacheD3D11::BuildTexture(TexCacheEntry *const entry) {
 		scaleFactor = 1;
 	}
 
-	if (scaleFactor != 1) {
-		if (texelsScaledThisFrame_ >= TEXCACHE_MAX_TEXELS_SCALED) {
-			entry->status |= TexCacheEntry::STATUS_TO_SCALE;
-			scaleFactor = 1;
-		} else {
-			entry->status &= ~TexCacheEntry::STATUS_TO_SCALE;
-			entry->status |= TexCacheEntry::STATUS_IS_SCALED;
-			texelsScaledThisFrame_ += w * h;
-		}
-	}
+	scaleFactor = ApplyScaleBudget(entry, scaleFactor, w, h);
 
 	// Seems to cause problems in Tactics Ogre.
 	if (badMipSizes) {
@@ -716,9 +708,12 @@ void TextureCacheD3D11::LoadTextureLevel(TexCacheEntry &entry, ReplacedTexture &
 			entry.SetAlphaStatus(TexCacheEntry::STATUS_ALPHA_UNKNOWN);
 		}
 
+		// If it's to be scaled in the background, this gets it started.
+		QueueScale(asyncScaler, entry, (const u8 *)pixelData, decPitch, bpp, (u32)dstFmt, w, h);
+
 		if (scaleFactor > 1) {
 			u32 scaleFmt = (u32)dstFmt;
-			scaler.ScaleAlways((u32 *)mapData, pixelData, scaleFmt, w, h, scaleFactor);
+			ScaleTexture(scaler, entry, (u32 *)mapData, pixelData, scaleFmt, w, h, scaleFactor);
 			pixelData = (u32 *)mapData;
 
 			// We always end up at 8888.  Other parts assume this.
@@ -87,6 +87,8 @@ class TextureCacheD3D11 : public TextureCacheCommon {
 	}
 
 	TextureScalerD3D11 scaler;
+	// Only used by the thread pool, for scaling in the background.
+	TextureScalerD3D11 asyncScaler;
 
 	SamplerCacheD3D11 samplerCache_;
 
@@ -94,7 +96,6 @@ class TextureCacheD3D11 : public TextureCacheCommon {
 	ID3D11Buffer *depalConstants_;
 
 	int decimationCounter_;
-	int texelsScaledThisFrame_;
 	int timesInvalidatedAllThisFrame_;
 
 	FramebufferManagerD3D11 *framebufferManagerD3D11_;
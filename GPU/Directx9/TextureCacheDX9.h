@@ -80,6 +80,8 @@ class TextureCacheDX9 : public TextureCacheCommon {
 	LPDIRECT3DDEVICE9EX deviceEx_;
 
 	TextureScalerDX9 scaler;
+	// Only used by the thread pool, for scaling in the background.
+	TextureScalerDX9 asyncScaler;
 
 	LPDIRECT3DVERTEXDECLARATION9 pFramebufferVertexDecl;
 
@@ -87,7 +89,6 @@ class TextureCacheDX9 : public TextureCacheCommon {
 	float maxAnisotropyLevel;
 
 	int decimationCounter_;
-	int texelsScaledThisFrame_;
 	int timesInvalidatedAllThisFrame_;
 
 	FramebufferManagerDX9 *framebufferManagerDX9_;
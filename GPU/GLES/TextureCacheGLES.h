@@ -84,6 +84,8 @@ class TextureCacheGLES : public TextureCacheCommon {
 	GLRenderManager *render_;
 
 	TextureScalerGLES scaler;
+	// Only used by the thread pool, for scaling in the background.
+	TextureScalerGLES asyncScaler;
 
 	GLRTexture *lastBoundTexture = nullptr;
 
@@ -433,6 +433,9 @@ void GPUCommon::UpdateCmdInfo() {
 		cmdInfo_[GE_CMD_JUMP].func = &GPUCommon::Execute_Jump;
 		cmdInfo_[GE_CMD_CALL].func = &GPUCommon::Execute_Call;
 	}
+
+	// Decoded runs have the old flags baked in.
+	InvalidateStateRuns();
 }
 
 void GPUCommon::BeginHostFrame() {
@@ -1022,11 +1025,31 @@ void GPUCommon::FastRunLoop(DisplayList &list) {
 	PROFILE_THIS_SCOPE("gpuloop");
 	const CommandInfo *cmdInfo = cmdInfo_;
 	int dc = downcount;
-	for (; dc > 0; --dc) {
+	// Where the current run of state-only commands started, if it's being recorded.
+	u32 runStartPC = 0;
+	bool atRunStart = true;
+	while (dc > 0) {
 		// We know that display list PCs have the upper nibble == 0 - no need to mask the pointer
 		const u32 op = *(const u32 *)(Memory::base + list.pc);
 		const u32 cmd = op >> 24;
 		const CommandInfo &info = cmdInfo[cmd];
+		if (info.flags & (FLAG_EXECUTE | FLAG_EXECUTEONCHANGE)) {
+			if (runStartPC != 0 && list.pc - runStartPC >= STATE_RUN_MIN_LENGTH * 4)
+				RecordStateRun(runStartPC, list.pc);
+			runStartPC = 0;
+			atRunStart = true;
+		} else if (atRunStart) {
+			atRunStart = false;
+			DecodedStateRun *run = LookupStateRun(list.pc);
+			const int count = run ? ReplayStateRun(*run, list.pc, dc) : 0;
+			if (count != 0) {
+				list.pc += count * 4;
+				dc -= count;
+				continue;
+			}
+			runStartPC = list.pc;
+		}
+
 		const u32 diff = op ^ gstate.cmdmem[cmd];
 		if (diff == 0) {
 			if (info.flags & FLAG_EXECUTE) {
@@ -1053,10 +1076,63 @@ void GPUCommon::FastRunLoop(DisplayList &list) {
 			}
 		}
 		list.pc += 4;
+		--dc;
 	}
 	downcount = 0;
 }
 
+void GPUCommon::RecordStateRun(u32 startPC, u32 endPC) {
+	DecodedStateRun &run = stateRuns_[(startPC >> 2) & (STATE_RUN_SLOTS - 1)];
+	run.pc = startPC;
+	run.generation = stateRunGeneration_;
+	run.cmds.clear();
+
+	const u32 *ops = (const u32 *)(Memory::base + startPC);
+	for (u32 pc = startPC; pc < endPC; pc += 4) {
+		const u32 op = *ops++;
+		const uint64_t flags = cmdInfo_[op >> 24].flags;
+		run.cmds.push_back({ op, (flags & FLAG_FLUSHBEFOREONCHANGE) != 0, flags >> 8 });
+	}
+}
+
+// Does the same as FastRunLoop() would for each command, returning how many it got through.
+int GPUCommon::ReplayStateRun(DecodedStateRun &run, u32 pc, int maxCount) {
+	const u32 *ops = (const u32 *)(Memory::base + pc);
+	int count = std::min((int)run.cmds.size(), maxCount);
+	u64 dirty = 0;
+	for (int i = 0; i < count; ++i) {
+		const DecodedStateCommand &decoded = run.cmds[i];
+		if (ops[i] != decoded.op) {
+			// The list was changed, so this has to be decoded again.
+			run.cmds.clear();
+			count = i;
+			break;
+		}
+
+		const u32 cmd = decoded.op >> 24;
+		if (decoded.op != gstate.cmdmem[cmd]) {
+			if (decoded.flushOnChange && drawEngineCommon_->GetNumDrawCalls()) {
+				// Earlier changes in the run would have been dirtied by now, so do that first.
+				gstate_c.Dirty(dirty);
+				dirty = 0;
+				drawEngineCommon_->DispatchFlush();
+			}
+			gstate.cmdmem[cmd] = decoded.op;
+			dirty |= decoded.dirty;
+		}
+	}
+
+	if (dirty)
+		gstate_c.Dirty(dirty);
+	return count;
+}
+
+// Drops every decoded run, without touching them.  Changes to the lists in memory don't need this,
+// since replay compares each word anyway.
+void GPUCommon::InvalidateStateRuns() {
+	stateRunGeneration_++;
+}
+
 void GPUCommon::BeginFrame() {
 	immCount_ = 0;
 	if (dumpNextFrame_) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "Common/Common.h"
 #include "Common/MemoryUtil.h"
 #include "GPU/GPUInterface.h"
@@ -320,6 +322,37 @@ class GPUCommon : public GPUInterface, public GPUDebugInterface {
 
 	static CommandInfo cmdInfo_[256];
 
+	// Runs of commands that only change state (nothing to execute) are decoded once, so that
+	// when a game submits the same list again they can be replayed without the command table.
+	// The words are checked against memory as they're replayed, so a changed list is still safe.
+	struct DecodedStateCommand {
+		u32 op;
+		bool flushOnChange;
+		u64 dirty;
+	};
+	struct DecodedStateRun {
+		u32 pc = 0;
+		// Runs from an older generation are stale, see InvalidateStateRuns().
+		u32 generation = 0;
+		std::vector<DecodedStateCommand> cmds;
+	};
+	enum {
+		STATE_RUN_SLOTS = 1024,
+		// Shorter runs aren't worth the lookup.
+		STATE_RUN_MIN_LENGTH = 4,
+	};
+
+	DecodedStateRun *LookupStateRun(u32 pc) {
+		DecodedStateRun &run = stateRuns_[(pc >> 2) & (STATE_RUN_SLOTS - 1)];
+		return run.pc == pc && run.generation == stateRunGeneration_ && !run.cmds.empty() ? &run : nullptr;
+	}
+	void RecordStateRun(u32 startPC, u32 endPC);
+	int ReplayStateRun(DecodedStateRun &run, u32 pc, int maxCount);
+	void InvalidateStateRuns();
+
+	DecodedStateRun stateRuns_[STATE_RUN_SLOTS];
+	u32 stateRunGeneration_ = 1;
+
 	typedef std::list<int> DisplayListQueue;
 
 	int nextListID;
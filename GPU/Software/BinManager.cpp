@@ -0,0 +1,109 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+
+#include "Common/MemoryUtil.h"
+#include "Common/Profiler/Profiler.h"
+#include "Core/Config.h"
+#include "Core/ThreadPools.h"
+#include "GPU/GPUState.h"
+#include "GPU/Software/BinManager.h"
+
+BinManager::BinManager() {
+	queue_ = (BinTriangle *)AllocateAlignedMemory(sizeof(BinTriangle) * MAX_QUEUED, 16);
+}
+
+BinManager::~BinManager() {
+	FreeAlignedMemory(queue_);
+}
+
+void BinManager::AddTriangle(const VertexData &v0, const VertexData &v1, const VertexData &v2) {
+	// Nothing to gain without other threads to draw on.
+	if (g_Config.iNumWorkerThreads <= 1) {
+		Rasterizer::DrawTriangle(v0, v1, v2);
+		return;
+	}
+
+	const Rasterizer::BinCoords bounds = Rasterizer::GetTriangleBounds(v0, v1, v2);
+	if (bounds.Invalid())
+		return;
+
+	if (queueSize_ >= MAX_QUEUED)
+		Flush();
+
+	const int index = queueSize_++;
+	BinTriangle &tri = queue_[index];
+	tri.v0 = v0;
+	tri.v1 = v1;
+	tri.v2 = v2;
+	tri.bounds = bounds;
+
+	// Screen coordinates are offset drawing coordinates, in 16ths of a pixel.  Bounds are within the scissor.
+	const int offsetX = gstate.getOffsetX16();
+	const int offsetY = gstate.getOffsetY16();
+	const int tx1 = std::max(0, (bounds.x1 - offsetX) >> (4 + TILE_SHIFT));
+	const int ty1 = std::max(0, (bounds.y1 - offsetY) >> (4 + TILE_SHIFT));
+	const int tx2 = std::min((int)TILES_X - 1, (bounds.x2 - offsetX) >> (4 + TILE_SHIFT));
+	const int ty2 = std::min((int)TILES_Y - 1, (bounds.y2 - offsetY) >> (4 + TILE_SHIFT));
+	for (int ty = ty1; ty <= ty2; ++ty) {
+		for (int tx = tx1; tx <= tx2; ++tx) {
+			std::vector<int> &tile = tiles_[ty * TILES_X + tx];
+			if (tile.empty())
+				activeTiles_.push_back(ty * TILES_X + tx);
+			tile.push_back(index);
+		}
+	}
+}
+
+void BinManager::DrawTile(int tile) {
+	const int tx = tile % TILES_X;
+	const int ty = tile / TILES_X;
+	Rasterizer::BinCoords range;
+	range.x1 = ((tx << TILE_SHIFT) << 4) + gstate.getOffsetX16();
+	range.y1 = ((ty << TILE_SHIFT) << 4) + gstate.getOffsetY16();
+	range.x2 = range.x1 + ((1 << TILE_SHIFT) << 4) - 1;
+	range.y2 = range.y1 + ((1 << TILE_SHIFT) << 4) - 1;
+
+	for (int index : tiles_[tile]) {
+		const BinTriangle &tri = queue_[index];
+		Rasterizer::DrawTriangle(tri.v0, tri.v1, tri.v2, tri.bounds, range);
+	}
+}
+
+void BinManager::Flush() {
+	if (queueSize_ == 0)
+		return;
+
+	PROFILE_THIS_SCOPE("bin_flush");
+	if (queueSize_ == 1) {
+		// A single triangle is better split up by the rasterizer itself.
+		const BinTriangle &tri = queue_[0];
+		Rasterizer::DrawTriangle(tri.v0, tri.v1, tri.v2);
+	} else {
+		// Tiles never share pixels, so each can be drawn in order independently.
+		GlobalThreadPool::Loop([&](int lower, int upper) {
+			for (int i = lower; i < upper; ++i)
+				DrawTile(activeTiles_[i]);
+		}, 0, (int)activeTiles_.size());
+	}
+
+	for (int tile : activeTiles_)
+		tiles_[tile].clear();
+	activeTiles_.clear();
+	queueSize_ = 0;
+}
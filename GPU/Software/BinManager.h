@@ -0,0 +1,64 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <vector>
+
+#include "GPU/Software/Rasterizer.h"
+
+// Queues triangles into screen tiles, and draws the tiles in parallel on Flush().
+// The rasterizer reads gstate as it draws, so everything queued must share the same state:
+// flush before any state change, and before anything reads or writes the framebuffer.
+class BinManager {
+public:
+	BinManager();
+	~BinManager();
+
+	void AddTriangle(const VertexData &v0, const VertexData &v1, const VertexData &v2);
+	void Flush();
+
+	bool HasPendingWork() const {
+		return queueSize_ != 0;
+	}
+
+private:
+	struct BinTriangle {
+		VertexData v0;
+		VertexData v1;
+		VertexData v2;
+		Rasterizer::BinCoords bounds;
+	};
+
+	void DrawTile(int tile);
+
+	enum {
+		// Tiles are 32x32 pixels.
+		TILE_SHIFT = 5,
+		TILES_X = 1024 >> TILE_SHIFT,
+		TILES_Y = 1024 >> TILE_SHIFT,
+		// Flush early after this many, to limit memory and latency.
+		MAX_QUEUED = 1024,
+	};
+
+	// Aligned, since VertexData has SIMD members.
+	BinTriangle *queue_ = nullptr;
+	int queueSize_ = 0;
+	// Indexes into queue_, in submission order, for each tile.
+	std::vector<int> tiles_[TILES_X * TILES_Y];
+	std::vector<int> activeTiles_;
+};
@@ -19,6 +19,7 @@
 
 #include "GPU/GPUState.h"
 
+#include "GPU/Software/BinManager.h"
 #include "GPU/Software/Clipper.h"
 #include "GPU/Software/Rasterizer.h"
 #include "GPU/Software/RasterizerRectangle.h"
@@ -135,7 +136,7 @@ static void RotateUVThrough(const VertexData &tl, const VertexData &br, VertexDa
 	}
 }
 
-void ProcessRect(const VertexData& v0, const VertexData& v1)
+void ProcessRect(const VertexData& v0, const VertexData& v1, BinManager &binner)
 {
 	if (!gstate.isModeThrough()) {
 		VertexData buf[4];
@@ -172,13 +173,15 @@ void ProcessRect(const VertexData& v0, const VertexData& v1)
 		}
 
 		// Four triangles to do backfaces as well. Two of them will get backface culled.
-		ProcessTriangle(*topleft, *topright, *bottomright, buf[3]);
-		ProcessTriangle(*bottomright, *topright, *topleft, buf[3]);
-		ProcessTriangle(*bottomright, *bottomleft, *topleft, buf[3]);
-		ProcessTriangle(*topleft, *bottomleft, *bottomright, buf[3]);
+		ProcessTriangle(*topleft, *topright, *bottomright, buf[3], binner);
+		ProcessTriangle(*bottomright, *topright, *topleft, buf[3], binner);
+		ProcessTriangle(*bottomright, *bottomleft, *topleft, buf[3], binner);
+		ProcessTriangle(*topleft, *bottomleft, *bottomright, buf[3], binner);
 	} else {
 		// through mode handling
 
+		// Sprites and clears aren't binned.
+		binner.Flush();
 		if (Rasterizer::RectangleFastPath(v0, v1)) {
 			return;
 		}
@@ -224,22 +227,24 @@ void ProcessRect(const VertexData& v0, const VertexData& v1)
 			Rasterizer::ClearRectangle(v0, v1);
 		} else {
 			// Four triangles to do backfaces as well. Two of them will get backface culled.
-			Rasterizer::DrawTriangle(*topleft, *topright, *bottomright);
-			Rasterizer::DrawTriangle(*bottomright, *topright, *topleft);
-			Rasterizer::DrawTriangle(*bottomright, *bottomleft, *topleft);
-			Rasterizer::DrawTriangle(*topleft, *bottomleft, *bottomright);
+			binner.AddTriangle(*topleft, *topright, *bottomright);
+			binner.AddTriangle(*bottomright, *topright, *topleft);
+			binner.AddTriangle(*bottomright, *bottomleft, *topleft);
+			binner.AddTriangle(*topleft, *bottomleft, *bottomright);
 		}
 	}
 }
 
-void ProcessPoint(VertexData& v0)
+void ProcessPoint(VertexData& v0, BinManager &binner)
 {
 	// Points need no clipping. Will be bounds checked in the rasterizer (which seems backwards?)
+	binner.Flush();
 	Rasterizer::DrawPoint(v0);
 }
 
-void ProcessLine(VertexData& v0, VertexData& v1)
+void ProcessLine(VertexData& v0, VertexData& v1, BinManager &binner)
 {
+	binner.Flush();
 	if (gstate.isModeThrough()) {
 		// Actually, should clip this one too so we don't need to do bounds checks in the rasterizer.
 		Rasterizer::DrawLine(v0, v1);
@@ -272,16 +277,16 @@ void ProcessLine(VertexData& v0, VertexData& v1)
 	Rasterizer::DrawLine(data[0], data[1]);
 }
 
-void ProcessTriangle(VertexData& v0, VertexData& v1, VertexData& v2, const VertexData &provoking) {
+void ProcessTriangle(VertexData& v0, VertexData& v1, VertexData& v2, const VertexData &provoking, BinManager &binner) {
 	if (gstate.isModeThrough()) {
 		// In case of cull reordering, make sure the right color is on the final vertex.
 		if (gstate.getShadeMode() == GE_SHADE_FLAT) {
 			VertexData corrected2 = v2;
 			corrected2.color0 = provoking.color0;
 			corrected2.color1 = provoking.color1;
-			Rasterizer::DrawTriangle(v0, v1, corrected2);
+			binner.AddTriangle(v0, v1, corrected2);
 		} else {
-			Rasterizer::DrawTriangle(v0, v1, v2);
+			binner.AddTriangle(v0, v1, v2);
 		}
 		return;
 	}
@@ -361,7 +366,7 @@ void ProcessTriangle(VertexData& v0, VertexData& v1, VertexData& v2, const Verte
 				data[2].color1 = provoking.color1;
 			}
 
-			Rasterizer::DrawTriangle(data[0], data[1], data[2]);
+			binner.AddTriangle(data[0], data[1], data[2]);
 		}
 	}
 }
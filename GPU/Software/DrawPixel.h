@@ -0,0 +1,177 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include "ppsspp_config.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#if PPSSPP_ARCH(ARM)
+#include "Common/ArmEmitter.h"
+#elif PPSSPP_ARCH(ARM64)
+#include "Common/Arm64Emitter.h"
+#elif PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+#include "Common/x64Emitter.h"
+#elif PPSSPP_ARCH(MIPS)
+#include "Common/MipsEmitter.h"
+#else
+#include "Common/FakeEmitter.h"
+#endif
+#include "GPU/ge_constants.h"
+#include "GPU/Math3D.h"
+
+// The GE state that decides what happens to each pixel after texturing.
+struct PixelFuncID {
+	PixelFuncID() : fullKey(0) {
+	}
+
+	union {
+		u64 fullKey;
+		struct {
+			bool clearMode : 1;
+			bool applyDepthRange : 1;
+			bool colorTest : 1;
+			bool stencilTest : 1;
+			bool depthWrite : 1;
+			bool applyFog : 1;
+			bool alphaBlend : 1;
+			bool dithering : 1;
+			bool applyLogicOp : 1;
+			bool applyColorWriteMask : 1;
+			uint8_t fbFormat : 2;
+			uint8_t alphaTestFunc : 3;
+			uint8_t depthTestFunc : 3;
+			uint8_t colorTestFunc : 2;
+			uint8_t stencilTestFunc : 3;
+			uint8_t sFail : 3;
+			uint8_t zFail : 3;
+			uint8_t zPass : 3;
+			uint8_t alphaBlendEq : 3;
+			uint8_t alphaBlendSrc : 4;
+			uint8_t alphaBlendDst : 4;
+			uint8_t logicOp : 4;
+		};
+	};
+
+	// Not part of the key: read by the functions as they run, so they can be shared.
+	struct {
+		u32 colorTestRef;
+		u32 colorTestMask;
+		// Bits set here keep the old framebuffer value.
+		u32 colorWriteMask;
+		u32 fogColor;
+		u32 fixA;
+		u32 fixB;
+		int framebufStride;
+		int depthbufStride;
+		u16 minz;
+		u16 maxz;
+		u8 alphaTestRef;
+		u8 alphaTestMask;
+		u8 stencilTestRef;
+		u8 stencilTestMask;
+		u8 stencilRef;
+		u8 stencilWriteMask;
+		s8 ditherMatrix[16];
+	} cached;
+
+	GEBufferFormat FBFormat() const {
+		return (GEBufferFormat)fbFormat;
+	}
+
+	bool operator == (const PixelFuncID &other) const {
+		return fullKey == other.fullKey;
+	}
+};
+
+namespace std {
+
+template <>
+struct hash<PixelFuncID> {
+	std::size_t operator()(const PixelFuncID &k) const {
+		return hash<u64>()(k.fullKey);
+	}
+};
+
+};
+
+namespace Rasterizer {
+
+// Color must already include texturing and secondary color.  Z is 16-bit, fog 0-255.
+typedef void (*SingleFunc)(int x, int y, int z, int fog, const Math3D::Vec4<int> &color_in, const PixelFuncID &pixelID);
+
+void ComputePixelFuncID(PixelFuncID *id);
+SingleFunc GetSingleFunc(const PixelFuncID &id);
+// Never jitted.  The reference the jit is tested against.
+SingleFunc GetSingleFuncInterpreted(const PixelFuncID &id);
+
+void Init();
+void Shutdown();
+
+bool DescribeCodePtr(const u8 *ptr, std::string &name);
+
+// Shared with the rest of the rasterizer.
+u8 GetPixelStencil(GEBufferFormat fmt, int fbStride, int x, int y);
+Math3D::Vec3<int> AlphaBlendingResult(const PixelFuncID &pixelID, const Math3D::Vec4<int> &source, const Math3D::Vec4<int> &dst);
+
+#if PPSSPP_ARCH(ARM)
+class PixelJitCache : public ArmGen::ARMXCodeBlock {
+#elif PPSSPP_ARCH(ARM64)
+class PixelJitCache : public Arm64Gen::ARM64CodeBlock {
+#elif PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+class PixelJitCache : public Gen::XCodeBlock {
+#elif PPSSPP_ARCH(MIPS)
+class PixelJitCache : public MIPSGen::MIPSCodeBlock {
+#else
+class PixelJitCache : public FakeGen::FakeXCodeBlock {
+#endif
+public:
+	PixelJitCache();
+
+	// Returns a pointer to the code to run, or nullptr if the interpreted path must be used.
+	SingleFunc GetSingle(const PixelFuncID &id);
+	void Clear();
+
+	std::string DescribeCodePtr(const u8 *ptr);
+	std::string DescribePixelFuncID(const PixelFuncID &id);
+
+private:
+	SingleFunc CompileSingle(const PixelFuncID &id);
+
+#if PPSSPP_ARCH(AMD64)
+	bool Jit_ApplyDepthRange(const PixelFuncID &id);
+	bool Jit_AlphaTest(const PixelFuncID &id);
+	bool Jit_ApplyFog(const PixelFuncID &id);
+	bool Jit_ColorTest(const PixelFuncID &id);
+	bool Jit_DepthTest(const PixelFuncID &id);
+	bool Jit_ReadColor(const PixelFuncID &id);
+	bool Jit_AlphaBlend(const PixelFuncID &id);
+	bool Jit_BlendFactor(Gen::X64Reg dest, int factor, bool isDest);
+	bool Jit_Dither(const PixelFuncID &id, Gen::X64Reg vecReg);
+	bool Jit_WriteColor(const PixelFuncID &id);
+
+	// Early outs (failed tests) jump to the end of the function.
+	std::vector<Gen::FixupBranch> discards_;
+#endif
+
+	std::unordered_map<PixelFuncID, SingleFunc> cache_;
+	std::unordered_map<PixelFuncID, const u8 *> addresses_;
+};
+
+};
@@ -0,0 +1,481 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+#if PPSSPP_ARCH(AMD64)
+
+#include <cstddef>
+#include "Common/x64Emitter.h"
+#include "GPU/GPUState.h"
+#include "GPU/Software/DrawPixel.h"
+#include "GPU/Software/SoftGpu.h"
+#include "GPU/ge_constants.h"
+
+using namespace Gen;
+
+namespace Rasterizer {
+
+// Args: x, y, z, fog, color_in ptr, pixelID ptr.
+#ifdef _WIN32
+static const X64Reg xReg = RCX;
+static const X64Reg yReg = RDX;
+static const X64Reg zReg = R8;
+static const X64Reg fogReg = R9;
+// These two are on the stack.
+static const X64Reg colorReg = R10;
+static const X64Reg idReg = R11;
+// Callee saved, so these are pushed.
+static const X64Reg tempReg2 = RSI;
+static const X64Reg tempReg3 = RDI;
+#else
+static const X64Reg xReg = RDI;
+static const X64Reg yReg = RSI;
+static const X64Reg zReg = RDX;
+static const X64Reg fogReg = RCX;
+static const X64Reg colorReg = R8;
+static const X64Reg idReg = R9;
+static const X64Reg tempReg2 = R10;
+static const X64Reg tempReg3 = R11;
+#endif
+
+static const X64Reg tempReg1 = RAX;
+// Free once the color has been loaded.
+static const X64Reg tempReg4 = colorReg;
+
+// The color being drawn, packed as RGBA8888 in the low lane.
+static const X64Reg colorVecReg = XMM0;
+// Only valid within a step that sets it.
+static const X64Reg zeroVecReg = XMM5;
+
+#define CACHED_OFFSET(field) (int)offsetof(PixelFuncID, cached.field)
+
+alignas(16) static const u16 by255i[8] = { 0x8081, 0x8081, 0x8081, 0x8081, 0x8081, 0x8081, 0x8081, 0x8081 };
+alignas(16) static const float by255f[4] = { 1.0f / 255.0f, 1.0f / 255.0f, 1.0f / 255.0f, 1.0f / 255.0f };
+alignas(16) static const u32 const255[4] = { 255, 255, 255, 255 };
+
+// Condition for failing "a OP b" after CMP(a, b), unsigned.
+static CCFlags FailCondition(GEComparison func) {
+	switch (func) {
+	case GE_COMP_EQUAL: return CC_NE;
+	case GE_COMP_NOTEQUAL: return CC_E;
+	case GE_COMP_LESS: return CC_AE;
+	case GE_COMP_LEQUAL: return CC_A;
+	case GE_COMP_GREATER: return CC_BE;
+	case GE_COMP_GEQUAL: return CC_B;
+	default:
+		_assert_msg_(false, "Pixel jit: NEVER/ALWAYS have no condition");
+		return CC_NE;
+	}
+}
+
+SingleFunc PixelJitCache::CompileSingle(const PixelFuncID &id) {
+	// The less common paths stay interpreted.
+	if (id.clearMode || id.stencilTest || id.applyLogicOp)
+		return nullptr;
+	if (id.FBFormat() != GE_FORMAT_8888 && id.FBFormat() != GE_FORMAT_565)
+		return nullptr;
+	if (id.alphaBlend && id.alphaBlendEq > GE_BLENDMODE_MUL_AND_SUBTRACT_REVERSE)
+		return nullptr;
+
+	BeginWrite();
+	const u8 *start = AlignCode16();
+	discards_.clear();
+
+#ifdef _WIN32
+	PUSH(RSI);
+	PUSH(RDI);
+	// Two pushes, the return address, and the shadow space.
+	const int argOffset = 16 + 8 + 32;
+	MOV(PTRBITS, R(colorReg), MDisp(RSP, argOffset));
+	MOV(PTRBITS, R(idReg), MDisp(RSP, argOffset + 8));
+#endif
+
+	// Clamp to 0-255 by saturating down to bytes.
+	MOVDQU(colorVecReg, MatR(colorReg));
+	PACKSSDW(colorVecReg, R(colorVecReg));
+	PACKUSWB(colorVecReg, R(colorVecReg));
+
+	bool success = true;
+	success = success && Jit_ApplyDepthRange(id);
+	success = success && Jit_AlphaTest(id);
+	success = success && Jit_ApplyFog(id);
+	success = success && Jit_ColorTest(id);
+	success = success && Jit_DepthTest(id);
+	success = success && Jit_ReadColor(id);
+	success = success && Jit_AlphaBlend(id);
+	success = success && Jit_WriteColor(id);
+
+	for (auto &fixup : discards_)
+		SetJumpTarget(fixup);
+	discards_.clear();
+
+#ifdef _WIN32
+	POP(RDI);
+	POP(RSI);
+#endif
+	RET();
+
+	EndWrite();
+	if (!success) {
+		ResetCodePtr(GetOffset(start));
+		return nullptr;
+	}
+	return (SingleFunc)start;
+}
+
+bool PixelJitCache::Jit_ApplyDepthRange(const PixelFuncID &id) {
+	if (!id.applyDepthRange)
+		return true;
+
+	CMP(16, R(zReg), MDisp(idReg, CACHED_OFFSET(minz)));
+	discards_.push_back(J_CC(CC_B, true));
+	CMP(16, R(zReg), MDisp(idReg, CACHED_OFFSET(maxz)));
+	discards_.push_back(J_CC(CC_A, true));
+	return true;
+}
+
+bool PixelJitCache::Jit_AlphaTest(const PixelFuncID &id) {
+	GEComparison func = GEComparison(id.alphaTestFunc);
+	if (func == GE_COMP_ALWAYS)
+		return true;
+	if (func == GE_COMP_NEVER) {
+		discards_.push_back(J(true));
+		return true;
+	}
+
+	MOVD_xmm(R(tempReg1), colorVecReg);
+	SHR(32, R(tempReg1), Imm8(24));
+	AND(8, R(tempReg1), MDisp(idReg, CACHED_OFFSET(alphaTestMask)));
+	CMP(8, R(tempReg1), MDisp(idReg, CACHED_OFFSET(alphaTestRef)));
+	discards_.push_back(J_CC(FailCondition(func), true));
+	return true;
+}
+
+bool PixelJitCache::Jit_ApplyFog(const PixelFuncID &id) {
+	if (!id.applyFog)
+		return true;
+
+	// Everything fits in 16 bits: (color * fog + fogColor * (255 - fog)) <= 255 * 255.
+	PXOR(zeroVecReg, R(zeroVecReg));
+	MOVDQA(XMM1, R(colorVecReg));
+	PUNPCKLBW(XMM1, R(zeroVecReg));
+
+	MOVD_xmm(XMM2, R(fogReg));
+	PSHUFLW(XMM2, R(XMM2), 0);
+	MOV(32, R(tempReg1), Imm32(255));
+	SUB(32, R(tempReg1), R(fogReg));
+	MOVD_xmm(XMM3, R(tempReg1));
+	PSHUFLW(XMM3, R(XMM3), 0);
+
+	MOVD_xmm(XMM4, MDisp(idReg, CACHED_OFFSET(fogColor)));
+	PUNPCKLBW(XMM4, R(zeroVecReg));
+
+	PMULLW(XMM1, R(XMM2));
+	PMULLW(XMM4, R(XMM3));
+	PADDW(XMM1, R(XMM4));
+	// This divides by 255 exactly, for anything up to 255 * 255.
+	PMULHUW(XMM1, M(by255i));
+	PSRLW(XMM1, 7);
+	PACKUSWB(XMM1, R(XMM1));
+
+	// Fog doesn't change alpha.
+	MOVD_xmm(R(tempReg1), colorVecReg);
+	MOVD_xmm(R(tempReg2), XMM1);
+	AND(32, R(tempReg1), Imm32(0xFF000000));
+	AND(32, R(tempReg2), Imm32(0x00FFFFFF));
+	OR(32, R(tempReg1), R(tempReg2));
+	MOVD_xmm(colorVecReg, R(tempReg1));
+	return true;
+}
+
+bool PixelJitCache::Jit_ColorTest(const PixelFuncID &id) {
+	if (!id.colorTest)
+		return true;
+
+	GEComparison func = GEComparison(id.colorTestFunc);
+	if (func == GE_COMP_NEVER) {
+		discards_.push_back(J(true));
+		return true;
+	}
+	// Only EQUAL and NOTEQUAL remain (it's two bits, and ALWAYS isn't in the ID.)
+	MOVD_xmm(R(tempReg1), colorVecReg);
+	AND(32, R(tempReg1), MDisp(idReg, CACHED_OFFSET(colorTestMask)));
+	CMP(32, R(tempReg1), MDisp(idReg, CACHED_OFFSET(colorTestRef)));
+	discards_.push_back(J_CC(FailCondition(func), true));
+	return true;
+}
+
+bool PixelJitCache::Jit_DepthTest(const PixelFuncID &id) {
+	GEComparison func = GEComparison(id.depthTestFunc);
+	if (func == GE_COMP_ALWAYS && !id.depthWrite)
+		return true;
+	if (func == GE_COMP_NEVER) {
+		discards_.push_back(J(true));
+		return true;
+	}
+
+	MOV(PTRBITS, R(tempReg2), ImmPtr(&depthbuf.data));
+	MOV(PTRBITS, R(tempReg2), MatR(tempReg2));
+	MOV(32, R(tempReg1), R(yReg));
+	IMUL(32, tempReg1, MDisp(idReg, CACHED_OFFSET(depthbufStride)));
+	ADD(32, R(tempReg1), R(xReg));
+	LEA(64, tempReg2, MComplex(tempReg2, tempReg1, SCALE_2, 0));
+
+	if (func != GE_COMP_ALWAYS) {
+		CMP(16, R(zReg), MatR(tempReg2));
+		discards_.push_back(J_CC(FailCondition(func), true));
+	}
+	if (id.depthWrite)
+		MOV(16, MatR(tempReg2), R(zReg));
+	return true;
+}
+
+// Leaves the pixel address in tempReg2 and the old color, as RGBA8888, in tempReg3.
+bool PixelJitCache::Jit_ReadColor(const PixelFuncID &id) {
+	MOV(PTRBITS, R(tempReg2), ImmPtr(&fb.data));
+	MOV(PTRBITS, R(tempReg2), MatR(tempReg2));
+	MOV(32, R(tempReg1), R(yReg));
+	IMUL(32, tempReg1, MDisp(idReg, CACHED_OFFSET(framebufStride)));
+	ADD(32, R(tempReg1), R(xReg));
+
+	switch (id.FBFormat()) {
+	case GE_FORMAT_8888:
+		LEA(64, tempReg2, MComplex(tempReg2, tempReg1, SCALE_4, 0));
+		MOV(32, R(tempReg3), MatR(tempReg2));
+		return true;
+
+	case GE_FORMAT_565:
+		LEA(64, tempReg2, MComplex(tempReg2, tempReg1, SCALE_2, 0));
+		MOVZX(32, 16, tempReg3, MatR(tempReg2));
+
+		// Spread out to the top bits of each byte first.
+		MOV(32, R(tempReg1), R(tempReg3));
+		AND(32, R(tempReg1), Imm32(0x001F));
+		SHL(32, R(tempReg1), Imm8(3));
+		MOV(32, R(tempReg4), R(tempReg3));
+		AND(32, R(tempReg4), Imm32(0x07E0));
+		SHL(32, R(tempReg4), Imm8(5));
+		OR(32, R(tempReg1), R(tempReg4));
+		AND(32, R(tempReg3), Imm32(0xF800));
+		SHL(32, R(tempReg3), Imm8(8));
+		OR(32, R(tempReg3), R(tempReg1));
+
+		// Now copy the top bits down into the low bits, like Convert5To8/Convert6To8.
+		MOV(32, R(tempReg1), R(tempReg3));
+		SHR(32, R(tempReg1), Imm8(5));
+		AND(32, R(tempReg1), Imm32(0x00070007));
+		OR(32, R(tempReg1), Imm32(0xFF000000));
+		MOV(32, R(tempReg4), R(tempReg3));
+		SHR(32, R(tempReg4), Imm8(6));
+		AND(32, R(tempReg4), Imm32(0x00000300));
+		OR(32, R(tempReg1), R(tempReg4));
+		OR(32, R(tempReg3), R(tempReg1));
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+// Expects source in XMM1 and dest in XMM2, as 32-bit lanes, and zeroVecReg set.
+bool PixelJitCache::Jit_BlendFactor(X64Reg dest, int factor, bool isDest) {
+	// The first two are the "other" color, the rest are shared between source and dest factors.
+	// Since everything is 0-255, 255 - v is the same as v ^ 255.
+	const X64Reg otherColor = isDest ? XMM1 : XMM2;
+	switch (factor) {
+	case GE_SRCBLEND_DSTCOLOR:
+		MOVDQA(dest, R(otherColor));
+		break;
+
+	case GE_SRCBLEND_INVDSTCOLOR:
+		MOVDQA(dest, R(otherColor));
+		PXOR(dest, M(const255));
+		break;
+
+	case GE_SRCBLEND_SRCALPHA:
+		PSHUFD(dest, R(XMM1), _MM_SHUFFLE(3, 3, 3, 3));
+		break;
+
+	case GE_SRCBLEND_INVSRCALPHA:
+		PSHUFD(dest, R(XMM1), _MM_SHUFFLE(3, 3, 3, 3));
+		PXOR(dest, M(const255));
+		break;
+
+	case GE_SRCBLEND_DSTALPHA:
+		PSHUFD(dest, R(XMM2), _MM_SHUFFLE(3, 3, 3, 3));
+		break;
+
+	case GE_SRCBLEND_INVDSTALPHA:
+		PSHUFD(dest, R(XMM2), _MM_SHUFFLE(3, 3, 3, 3));
+		PXOR(dest, M(const255));
+		break;
+
+	case GE_SRCBLEND_DOUBLESRCALPHA:
+		PSHUFD(dest, R(XMM1), _MM_SHUFFLE(3, 3, 3, 3));
+		PADDD(dest, R(dest));
+		break;
+
+	case GE_SRCBLEND_DOUBLEINVSRCALPHA:
+		PSHUFD(dest, R(XMM1), _MM_SHUFFLE(3, 3, 3, 3));
+		PADDD(dest, R(dest));
+		// Values are small, so the high 16 bits are zero and this works as a 32-bit min.
+		PMINSW(dest, M(const255));
+		PXOR(dest, M(const255));
+		break;
+
+	case GE_SRCBLEND_DOUBLEDSTALPHA:
+		PSHUFD(dest, R(XMM2), _MM_SHUFFLE(3, 3, 3, 3));
+		PADDD(dest, R(dest));
+		break;
+
+	case GE_SRCBLEND_DOUBLEINVDSTALPHA:
+		PSHUFD(dest, R(XMM2), _MM_SHUFFLE(3, 3, 3, 3));
+		PADDD(dest, R(dest));
+		PMINSW(dest, M(const255));
+		PXOR(dest, M(const255));
+		break;
+
+	default:
+		// All others are FIXA or FIXB.
+		MOVD_xmm(dest, MDisp(idReg, isDest ? CACHED_OFFSET(fixB) : CACHED_OFFSET(fixA)));
+		PUNPCKLBW(dest, R(zeroVecReg));
+		PUNPCKLWD(dest, R(zeroVecReg));
+		break;
+	}
+	return true;
+}
+
+bool PixelJitCache::Jit_Dither(const PixelFuncID &id, X64Reg vecReg) {
+	MOV(32, R(tempReg1), R(yReg));
+	AND(32, R(tempReg1), Imm8(3));
+	SHL(32, R(tempReg1), Imm8(2));
+	MOV(32, R(tempReg4), R(xReg));
+	AND(32, R(tempReg4), Imm8(3));
+	OR(32, R(tempReg1), R(tempReg4));
+	MOVSX(32, 8, tempReg1, MComplex(idReg, tempReg1, SCALE_1, CACHED_OFFSET(ditherMatrix)));
+
+	MOVD_xmm(XMM3, R(tempReg1));
+	PSHUFD(XMM3, R(XMM3), _MM_SHUFFLE(0, 0, 0, 0));
+	PADDD(vecReg, R(XMM3));
+	return true;
+}
+
+// Leaves the new color in tempReg1, with the old stencil.
+bool PixelJitCache::Jit_AlphaBlend(const PixelFuncID &id) {
+	bool success = true;
+	if (id.alphaBlend) {
+		PXOR(zeroVecReg, R(zeroVecReg));
+		MOVDQA(XMM1, R(colorVecReg));
+		PUNPCKLBW(XMM1, R(zeroVecReg));
+		PUNPCKLWD(XMM1, R(zeroVecReg));
+		MOVD_xmm(XMM2, R(tempReg3));
+		PUNPCKLBW(XMM2, R(zeroVecReg));
+		PUNPCKLWD(XMM2, R(zeroVecReg));
+
+		success = success && Jit_BlendFactor(XMM3, id.alphaBlendSrc, false);
+		success = success && Jit_BlendFactor(XMM4, id.alphaBlendDst, true);
+
+		// Same float math as AlphaBlendingResult(), so the results match exactly.
+		CVTDQ2PS(XMM1, R(XMM1));
+		CVTDQ2PS(XMM3, R(XMM3));
+		MULPS(XMM1, R(XMM3));
+		CVTDQ2PS(XMM2, R(XMM2));
+		CVTDQ2PS(XMM4, R(XMM4));
+		MULPS(XMM2, R(XMM4));
+		switch (GEBlendMode(id.alphaBlendEq)) {
+		case GE_BLENDMODE_MUL_AND_ADD:
+			ADDPS(XMM1, R(XMM2));
+			break;
+		case GE_BLENDMODE_MUL_AND_SUBTRACT:
+			SUBPS(XMM1, R(XMM2));
+			break;
+		case GE_BLENDMODE_MUL_AND_SUBTRACT_REVERSE:
+			SUBPS(XMM2, R(XMM1));
+			MOVAPS(XMM1, R(XMM2));
+			break;
+		default:
+			return false;
+		}
+		MULPS(XMM1, M(by255f));
+		CVTPS2DQ(XMM1, R(XMM1));
+
+		if (id.dithering)
+			success = success && Jit_Dither(id, XMM1);
+
+		PACKSSDW(XMM1, R(XMM1));
+		PACKUSWB(XMM1, R(XMM1));
+		MOVD_xmm(R(tempReg1), XMM1);
+	} else if (id.dithering) {
+		// Dither is added before clamping, so unpack again.
+		PXOR(zeroVecReg, R(zeroVecReg));
+		MOVDQA(XMM1, R(colorVecReg));
+		PUNPCKLBW(XMM1, R(zeroVecReg));
+		PUNPCKLWD(XMM1, R(zeroVecReg));
+		success = success && Jit_Dither(id, XMM1);
+		PACKSSDW(XMM1, R(XMM1));
+		PACKUSWB(XMM1, R(XMM1));
+		MOVD_xmm(R(tempReg1), XMM1);
+	} else {
+		MOVD_xmm(R(tempReg1), colorVecReg);
+	}
+
+	AND(32, R(tempReg1), Imm32(0x00FFFFFF));
+	if (id.FBFormat() == GE_FORMAT_8888) {
+		// Keep the stencil, since there's no stencil test here.
+		MOV(32, R(tempReg4), R(tempReg3));
+		AND(32, R(tempReg4), Imm32(0xFF000000));
+		OR(32, R(tempReg1), R(tempReg4));
+	}
+	return success;
+}
+
+bool PixelJitCache::Jit_WriteColor(const PixelFuncID &id) {
+	if (id.applyColorWriteMask) {
+		// new ^ ((new ^ old) & mask) keeps the old bits where the mask is set.
+		MOV(32, R(tempReg4), R(tempReg1));
+		XOR(32, R(tempReg4), R(tempReg3));
+		AND(32, R(tempReg4), MDisp(idReg, CACHED_OFFSET(colorWriteMask)));
+		XOR(32, R(tempReg1), R(tempReg4));
+	}
+
+	switch (id.FBFormat()) {
+	case GE_FORMAT_8888:
+		MOV(32, MatR(tempReg2), R(tempReg1));
+		return true;
+
+	case GE_FORMAT_565:
+		MOV(32, R(tempReg3), R(tempReg1));
+		SHR(32, R(tempReg3), Imm8(3));
+		AND(32, R(tempReg3), Imm32(0x001F));
+		MOV(32, R(tempReg4), R(tempReg1));
+		SHR(32, R(tempReg4), Imm8(5));
+		AND(32, R(tempReg4), Imm32(0x07E0));
+		OR(32, R(tempReg3), R(tempReg4));
+		SHR(32, R(tempReg1), Imm8(8));
+		AND(32, R(tempReg1), Imm32(0xF800));
+		OR(32, R(tempReg1), R(tempReg3));
+		MOV(16, MatR(tempReg2), R(tempReg1));
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+};
+
+#endif
@@ -29,6 +29,7 @@
 
 #include "GPU/Common/TextureCacheCommon.h"
 #include "GPU/Common/TextureDecoder.h"
+#include "GPU/Software/DrawPixel.h"
 #include "GPU/Software/SoftGpu.h"
 #include "GPU/Software/Rasterizer.h"
 #include "GPU/Software/Sampler.h"
@@ -250,133 +251,6 @@ static inline void GetTextureCoordinates(const VertexData& v0, const VertexData&
 	}
 }
 
-// NOTE: These likely aren't endian safe
-static inline u32 GetPixelColor(int x, int y)
-{
-	switch (gstate.FrameBufFormat()) {
-	case GE_FORMAT_565:
-		return RGB565ToRGBA8888(fb.Get16(x, y, gstate.FrameBufStride()));
-
-	case GE_FORMAT_5551:
-		return RGBA5551ToRGBA8888(fb.Get16(x, y, gstate.FrameBufStride()));
-
-	case GE_FORMAT_4444:
-		return RGBA4444ToRGBA8888(fb.Get16(x, y, gstate.FrameBufStride()));
-
-	case GE_FORMAT_8888:
-		return fb.Get32(x, y, gstate.FrameBufStride());
-
-	case GE_FORMAT_INVALID:
-	case GE_FORMAT_DEPTH16:
-		_dbg_assert_msg_(false, "Software: invalid framebuf format.");
-	}
-	return 0;
-}
-
-static inline void SetPixelColor(int x, int y, u32 value)
-{
-	switch (gstate.FrameBufFormat()) {
-	case GE_FORMAT_565:
-		fb.Set16(x, y, gstate.FrameBufStride(), RGBA8888ToRGB565(value));
-		break;
-
-	case GE_FORMAT_5551:
-		fb.Set16(x, y, gstate.FrameBufStride(), RGBA8888ToRGBA5551(value));
-		break;
-
-	case GE_FORMAT_4444:
-		fb.Set16(x, y, gstate.FrameBufStride(), RGBA8888ToRGBA4444(value));
-		break;
-
-	case GE_FORMAT_8888:
-		fb.Set32(x, y, gstate.FrameBufStride(), value);
-		break;
-
-	case GE_FORMAT_INVALID:
-	case GE_FORMAT_DEPTH16:
-		_dbg_assert_msg_(false, "Software: invalid framebuf format.");
-	}
-}
-
-static inline u16 GetPixelDepth(int x, int y)
-{
-	return depthbuf.Get16(x, y, gstate.DepthBufStride());
-}
-
-static inline void SetPixelDepth(int x, int y, u16 value)
-{
-	depthbuf.Set16(x, y, gstate.DepthBufStride(), value);
-}
-
-static inline u8 GetPixelStencil(int x, int y)
-{
-	if (gstate.FrameBufFormat() == GE_FORMAT_565) {
-		// Always treated as 0 for comparison purposes.
-		return 0;
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_5551) {
-		return ((fb.Get16(x, y, gstate.FrameBufStride()) & 0x8000) != 0) ? 0xFF : 0;
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_4444) {
-		return Convert4To8(fb.Get16(x, y, gstate.FrameBufStride()) >> 12);
-	} else {
-		return fb.Get32(x, y, gstate.FrameBufStride()) >> 24;
-	}
-}
-
-static inline void SetPixelStencil(int x, int y, u8 value)
-{
-	// TODO: This seems like it maybe respects the alpha mask (at least in some scenarios?)
-
-	if (gstate.FrameBufFormat() == GE_FORMAT_565) {
-		// Do nothing
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_5551) {
-		u16 pixel = fb.Get16(x, y, gstate.FrameBufStride()) & ~0x8000;
-		pixel |= value != 0 ? 0x8000 : 0;
-		fb.Set16(x, y, gstate.FrameBufStride(), pixel);
-	} else if (gstate.FrameBufFormat() == GE_FORMAT_4444) {
-		u16 pixel = fb.Get16(x, y, gstate.FrameBufStride()) & ~0xF000;
-		pixel |= (u16)value << 12;
-		fb.Set16(x, y, gstate.FrameBufStride(), pixel);
-	} else {
-		u32 pixel = fb.Get32(x, y, gstate.FrameBufStride()) & ~0xFF000000;
-		pixel |= (u32)value << 24;
-		fb.Set32(x, y, gstate.FrameBufStride(), pixel);
-	}
-}
-
-static inline bool DepthTestPassed(int x, int y, u16 z)
-{
-	u16 reference_z = GetPixelDepth(x, y);
-
-	switch (gstate.getDepthTestFunction()) {
-	case GE_COMP_NEVER:
-		return false;
-
-	case GE_COMP_ALWAYS:
-		return true;
-
-	case GE_COMP_EQUAL:
-		return (z == reference_z);
-
-	case GE_COMP_NOTEQUAL:
-		return (z != reference_z);
-
-	case GE_COMP_LESS:
-		return (z < reference_z);
-
-	case GE_COMP_LEQUAL:
-		return (z <= reference_z);
-
-	case GE_COMP_GREATER:
-		return (z > reference_z);
-
-	case GE_COMP_GEQUAL:
-		return (z >= reference_z);
-
-	default:
-		return 0;
-	}
-}
-
 static inline bool IsRightSideOrFlatBottomLine(const Vec2<int>& vertex, const Vec2<int>& line1, const Vec2<int>& line2)
 {
 	if (line1.y == line2.y) {
@@ -388,164 +262,6 @@ static inline bool IsRightSideOrFlatBottomLine(const Vec2<int>& vertex, const Ve
 	}
 }
 
-static inline bool StencilTestPassed(u8 stencil)
-{
-	// TODO: Does the masking logic make any sense?
-	stencil &= gstate.getStencilTestMask();
-	u8 ref = gstate.getStencilTestRef() & gstate.getStencilTestMask();
-	switch (gstate.getStencilTestFunction()) {
-		case GE_COMP_NEVER:
-			return false;
-
-		case GE_COMP_ALWAYS:
-			return true;
-
-		case GE_COMP_EQUAL:
-			return ref == stencil;
-
-		case GE_COMP_NOTEQUAL:
-			return ref != stencil;
-
-		case GE_COMP_LESS:
-			return ref < stencil;
-
-		case GE_COMP_LEQUAL:
-			return ref <= stencil;
-
-		case GE_COMP_GREATER:
-			return ref > stencil;
-
-		case GE_COMP_GEQUAL:
-			return ref >= stencil;
-	}
-	return true;
-}
-
-static inline u8 ApplyStencilOp(int op, u8 old_stencil) {
-	// TODO: Apply mask to reference or old stencil?
-	u8 reference_stencil = gstate.getStencilTestRef(); // TODO: Apply mask?
-	const u8 write_mask = gstate.getStencilWriteMask();
-
-	switch (op) {
-		case GE_STENCILOP_KEEP:
-			return old_stencil;
-
-		case GE_STENCILOP_ZERO:
-			return old_stencil & write_mask;
-
-		case GE_STENCILOP_REPLACE:
-			return (reference_stencil & ~write_mask) | (old_stencil & write_mask);
-
-		case GE_STENCILOP_INVERT:
-			return (~old_stencil & ~write_mask) | (old_stencil & write_mask);
-
-		case GE_STENCILOP_INCR:
-			switch (gstate.FrameBufFormat()) {
-			case GE_FORMAT_8888:
-				if (old_stencil != 0xFF) {
-					return ((old_stencil + 1) & ~write_mask) | (old_stencil & write_mask);
-				}
-				return old_stencil;
-			case GE_FORMAT_5551:
-				return ~write_mask | (old_stencil & write_mask);
-			case GE_FORMAT_4444:
-				if (old_stencil < 0xF0) {
-					return ((old_stencil + 0x10) & ~write_mask) | (old_stencil & write_mask);
-				}
-				return old_stencil;
-			default:
-				return old_stencil;
-			}
-			break;
-
-		case GE_STENCILOP_DECR:
-			switch (gstate.FrameBufFormat()) {
-			case GE_FORMAT_4444:
-				if (old_stencil >= 0x10)
-					return ((old_stencil - 0x10) & ~write_mask) | (old_stencil & write_mask);
-				break;
-			default:
-				if (old_stencil != 0)
-					return ((old_stencil - 1) & ~write_mask) | (old_stencil & write_mask);
-				return old_stencil;
-			}
-			break;
-	}
-
-	return old_stencil;
-}
-
-static inline u32 ApplyLogicOp(GELogicOp op, u32 old_color, u32 new_color) {
-	// All of the operations here intentionally preserve alpha/stencil.
-	switch (op) {
-	case GE_LOGIC_CLEAR:
-		new_color &= 0xFF000000;
-		break;
-
-	case GE_LOGIC_AND:
-		new_color = new_color & (old_color | 0xFF000000);
-		break;
-
-	case GE_LOGIC_AND_REVERSE:
-		new_color = new_color & (~old_color | 0xFF000000);
-		break;
-
-	case GE_LOGIC_COPY:
-		// No change to new_color.
-		break;
-
-	case GE_LOGIC_AND_INVERTED:
-		new_color = (~new_color & (old_color & 0x00FFFFFF)) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_NOOP:
-		new_color = (old_color & 0x00FFFFFF) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_XOR:
-		new_color = new_color ^ (old_color & 0x00FFFFFF);
-		break;
-
-	case GE_LOGIC_OR:
-		new_color = new_color | (old_color & 0x00FFFFFF);
-		break;
-
-	case GE_LOGIC_NOR:
-		new_color = (~(new_color | old_color) & 0x00FFFFFF) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_EQUIV:
-		new_color = (~(new_color ^ old_color) & 0x00FFFFFF) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_INVERTED:
-		new_color = (~old_color & 0x00FFFFFF) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_OR_REVERSE:
-		new_color = new_color | (~old_color & 0x00FFFFFF);
-		break;
-
-	case GE_LOGIC_COPY_INVERTED:
-		new_color = (~new_color & 0x00FFFFFF) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_OR_INVERTED:
-		new_color = ((~new_color | old_color) & 0x00FFFFFF) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_NAND:
-		new_color = (~(new_color & old_color) & 0x00FFFFFF) | (new_color & 0xFF000000);
-		break;
-
-	case GE_LOGIC_SET:
-		new_color |= 0x00FFFFFF;
-		break;
-	}
-
-	return new_color;
-}
-
 Vec4<int> GetTextureFunctionOutput(const Vec4<int>& prim_color, const Vec4<int>& texcolor)
 {
 	Vec3<int> out_rgb;
@@ -625,321 +341,6 @@ Vec4<int> GetTextureFunctionOutput(const Vec4<int>& prim_color, const Vec4<int>&
 	return Vec4<int>(out_rgb.r(), out_rgb.g(), out_rgb.b(), out_a);
 }
 
-static inline bool ColorTestPassed(const Vec3<int> &color)
-{
-	const u32 mask = gstate.getColorTestMask();
-	const u32 c = color.ToRGB() & mask;
-	const u32 ref = gstate.getColorTestRef() & mask;
-	switch (gstate.getColorTestFunction()) {
-		case GE_COMP_NEVER:
-			return false;
-
-		case GE_COMP_ALWAYS:
-			return true;
-
-		case GE_COMP_EQUAL:
-			return c == ref;
-
-		case GE_COMP_NOTEQUAL:
-			return c != ref;
-
-		default:
-			ERROR_LOG_REPORT(G3D, "Software: Invalid colortest function: %d", gstate.getColorTestFunction());
-			break;
-	}
-	return true;
-}
-
-static inline bool AlphaTestPassed(int alpha)
-{
-	const u8 mask = gstate.getAlphaTestMask() & 0xFF;
-	const u8 ref = gstate.getAlphaTestRef() & mask;
-	alpha &= mask;
-
-	switch (gstate.getAlphaTestFunction()) {
-		case GE_COMP_NEVER:
-			return false;
-
-		case GE_COMP_ALWAYS:
-			return true;
-
-		case GE_COMP_EQUAL:
-			return (alpha == ref);
-
-		case GE_COMP_NOTEQUAL:
-			return (alpha != ref);
-
-		case GE_COMP_LESS:
-			return (alpha < ref);
-
-		case GE_COMP_LEQUAL:
-			return (alpha <= ref);
-
-		case GE_COMP_GREATER:
-			return (alpha > ref);
-
-		case GE_COMP_GEQUAL:
-			return (alpha >= ref);
-	}
-	return true;
-}
-
-static inline Vec3<int> GetSourceFactor(const Vec4<int>& source, const Vec4<int>& dst)
-{
-	switch (gstate.getBlendFuncA()) {
-	case GE_SRCBLEND_DSTCOLOR:
-		return dst.rgb();
-
-	case GE_SRCBLEND_INVDSTCOLOR:
-		return Vec3<int>::AssignToAll(255) - dst.rgb();
-
-	case GE_SRCBLEND_SRCALPHA:
-#if defined(_M_SSE)
-		return Vec3<int>(_mm_shuffle_epi32(source.ivec, _MM_SHUFFLE(3, 3, 3, 3)));
-#else
-		return Vec3<int>::AssignToAll(source.a());
-#endif
-
-	case GE_SRCBLEND_INVSRCALPHA:
-#if defined(_M_SSE)
-		return Vec3<int>(_mm_sub_epi32(_mm_set1_epi32(255), _mm_shuffle_epi32(source.ivec, _MM_SHUFFLE(3, 3, 3, 3))));
-#else
-		return Vec3<int>::AssignToAll(255 - source.a());
-#endif
-
-	case GE_SRCBLEND_DSTALPHA:
-		return Vec3<int>::AssignToAll(dst.a());
-
-	case GE_SRCBLEND_INVDSTALPHA:
-		return Vec3<int>::AssignToAll(255 - dst.a());
-
-	case GE_SRCBLEND_DOUBLESRCALPHA:
-		return Vec3<int>::AssignToAll(2 * source.a());
-
-	case GE_SRCBLEND_DOUBLEINVSRCALPHA:
-		return Vec3<int>::AssignToAll(255 - std::min(2 * source.a(), 255));
-
-	case GE_SRCBLEND_DOUBLEDSTALPHA:
-		return Vec3<int>::AssignToAll(2 * dst.a());
-
-	case GE_SRCBLEND_DOUBLEINVDSTALPHA:
-		return Vec3<int>::AssignToAll(255 - std::min(2 * dst.a(), 255));
-
-	case GE_SRCBLEND_FIXA:
-	default:
-		// All other dest factors (> 10) are treated as FIXA.
-		return Vec3<int>::FromRGB(gstate.getFixA());
-	}
-}
-
-static inline Vec3<int> GetDestFactor(const Vec4<int>& source, const Vec4<int>& dst)
-{
-	switch (gstate.getBlendFuncB()) {
-	case GE_DSTBLEND_SRCCOLOR:
-		return source.rgb();
-
-	case GE_DSTBLEND_INVSRCCOLOR:
-		return Vec3<int>::AssignToAll(255) - source.rgb();
-
-	case GE_DSTBLEND_SRCALPHA:
-#if defined(_M_SSE)
-		return Vec3<int>(_mm_shuffle_epi32(source.ivec, _MM_SHUFFLE(3, 3, 3, 3)));
-#else
-		return Vec3<int>::AssignToAll(source.a());
-#endif
-
-	case GE_DSTBLEND_INVSRCALPHA:
-#if defined(_M_SSE)
-		return Vec3<int>(_mm_sub_epi32(_mm_set1_epi32(255), _mm_shuffle_epi32(source.ivec, _MM_SHUFFLE(3, 3, 3, 3))));
-#else
-		return Vec3<int>::AssignToAll(255 - source.a());
-#endif
-
-	case GE_DSTBLEND_DSTALPHA:
-		return Vec3<int>::AssignToAll(dst.a());
-
-	case GE_DSTBLEND_INVDSTALPHA:
-		return Vec3<int>::AssignToAll(255 - dst.a());
-
-	case GE_DSTBLEND_DOUBLESRCALPHA:
-		return Vec3<int>::AssignToAll(2 * source.a());
-
-	case GE_DSTBLEND_DOUBLEINVSRCALPHA:
-		return Vec3<int>::AssignToAll(255 - std::min(2 * source.a(), 255));
-
-	case GE_DSTBLEND_DOUBLEDSTALPHA:
-		return Vec3<int>::AssignToAll(2 * dst.a());
-
-	case GE_DSTBLEND_DOUBLEINVDSTALPHA:
-		return Vec3<int>::AssignToAll(255 - std::min(2 * dst.a(), 255));
-
-	case GE_DSTBLEND_FIXB:
-	default:
-		// All other dest factors (> 10) are treated as FIXB.
-		return Vec3<int>::FromRGB(gstate.getFixB());
-	}
-}
-
-// Removed inline here - it was never chosen to be inlined by the compiler anyway, too complex.
-Vec3<int> AlphaBlendingResult(const Vec4<int> &source, const Vec4<int> &dst)
-{
-	// Note: These factors cannot go below 0, but they can go above 255 when doubling.
-	Vec3<int> srcfactor = GetSourceFactor(source, dst);
-	Vec3<int> dstfactor = GetDestFactor(source, dst);
-
-	switch (gstate.getBlendEq()) {
-	case GE_BLENDMODE_MUL_AND_ADD:
-	{
-#if defined(_M_SSE)
-		const __m128 s = _mm_mul_ps(_mm_cvtepi32_ps(source.ivec), _mm_cvtepi32_ps(srcfactor.ivec));
-		const __m128 d = _mm_mul_ps(_mm_cvtepi32_ps(dst.ivec), _mm_cvtepi32_ps(dstfactor.ivec));
-		return Vec3<int>(_mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(s, d), _mm_set_ps1(1.0f / 255.0f))));
-#else
-		return (source.rgb() * srcfactor + dst.rgb() * dstfactor) / 255;
-#endif
-	}
-
-	case GE_BLENDMODE_MUL_AND_SUBTRACT:
-	{
-#if defined(_M_SSE)
-		const __m128 s = _mm_mul_ps(_mm_cvtepi32_ps(source.ivec), _mm_cvtepi32_ps(srcfactor.ivec));
-		const __m128 d = _mm_mul_ps(_mm_cvtepi32_ps(dst.ivec), _mm_cvtepi32_ps(dstfactor.ivec));
-		return Vec3<int>(_mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(s, d), _mm_set_ps1(1.0f / 255.0f))));
-#else
-		return (source.rgb() * srcfactor - dst.rgb() * dstfactor) / 255;
-#endif
-	}
-
-	case GE_BLENDMODE_MUL_AND_SUBTRACT_REVERSE:
-	{
-#if defined(_M_SSE)
-		const __m128 s = _mm_mul_ps(_mm_cvtepi32_ps(source.ivec), _mm_cvtepi32_ps(srcfactor.ivec));
-		const __m128 d = _mm_mul_ps(_mm_cvtepi32_ps(dst.ivec), _mm_cvtepi32_ps(dstfactor.ivec));
-		return Vec3<int>(_mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(d, s), _mm_set_ps1(1.0f / 255.0f))));
-#else
-		return (dst.rgb() * dstfactor - source.rgb() * srcfactor) / 255;
-#endif
-	}
-
-	case GE_BLENDMODE_MIN:
-		return Vec3<int>(std::min(source.r(), dst.r()),
-						std::min(source.g(), dst.g()),
-						std::min(source.b(), dst.b()));
-
-	case GE_BLENDMODE_MAX:
-		return Vec3<int>(std::max(source.r(), dst.r()),
-						std::max(source.g(), dst.g()),
-						std::max(source.b(), dst.b()));
-
-	case GE_BLENDMODE_ABSDIFF:
-		return Vec3<int>(::abs(source.r() - dst.r()),
-						::abs(source.g() - dst.g()),
-						::abs(source.b() - dst.b()));
-
-	default:
-		ERROR_LOG_REPORT(G3D, "Software: Unknown blend function %x", gstate.getBlendEq());
-		return Vec3<int>();
-	}
-}
-
-template <bool clearMode>
-inline void DrawSinglePixel(const DrawingCoords &p, u16 z, u8 fog, const Vec4<int> &color_in) {
-	Vec4<int> prim_color = color_in.Clamp(0, 255);
-	// Depth range test - applied in clear mode, if not through mode.
-	if (!gstate.isModeThrough())
-		if (z < gstate.getDepthRangeMin() || z > gstate.getDepthRangeMax())
-			return;
-
-	if (gstate.isAlphaTestEnabled() && !clearMode)
-		if (!AlphaTestPassed(prim_color.a()))
-			return;
-
-	// Fog is applied prior to color test.
-	if (gstate.isFogEnabled() && !gstate.isModeThrough() && !clearMode) {
-		Vec3<int> fogColor = Vec3<int>::FromRGB(gstate.fogcolor);
-		fogColor = (prim_color.rgb() * (int)fog + fogColor * (255 - (int)fog)) / 255;
-		prim_color.r() = fogColor.r();
-		prim_color.g() = fogColor.g();
-		prim_color.b() = fogColor.b();
-	}
-
-	if (gstate.isColorTestEnabled() && !clearMode)
-		if (!ColorTestPassed(prim_color.rgb()))
-			return;
-
-	// In clear mode, it uses the alpha color as stencil.
-	u8 stencil = clearMode ? prim_color.a() : GetPixelStencil(p.x, p.y);
-	if (!clearMode && (gstate.isStencilTestEnabled() || gstate.isDepthTestEnabled())) {
-		if (gstate.isStencilTestEnabled() && !StencilTestPassed(stencil)) {
-			stencil = ApplyStencilOp(gstate.getStencilOpSFail(), stencil);
-			SetPixelStencil(p.x, p.y, stencil);
-			return;
-		}
-
-		// Also apply depth at the same time.  If disabled, same as passing.
-		if (gstate.isDepthTestEnabled() && !DepthTestPassed(p.x, p.y, z)) {
-			if (gstate.isStencilTestEnabled()) {
-				stencil = ApplyStencilOp(gstate.getStencilOpZFail(), stencil);
-				SetPixelStencil(p.x, p.y, stencil);
-			}
-			return;
-		} else if (gstate.isStencilTestEnabled()) {
-			stencil = ApplyStencilOp(gstate.getStencilOpZPass(), stencil);
-		}
-
-		if (gstate.isDepthTestEnabled() && gstate.isDepthWriteEnabled()) {
-			SetPixelDepth(p.x, p.y, z);
-		}
-	} else if (clearMode && gstate.isClearModeDepthMask()) {
-		SetPixelDepth(p.x, p.y, z);
-	}
-
-	const u32 old_color = GetPixelColor(p.x, p.y);
-	u32 new_color;
-
-	// Dithering happens before the logic op and regardless of framebuffer format or clear mode.
-	// We do it while alpha blending because it happens before clamping.
-	if (gstate.isAlphaBlendEnabled() && !clearMode) {
-		const Vec4<int> dst = Vec4<int>::FromRGBA(old_color);
-		Vec3<int> blended = AlphaBlendingResult(prim_color, dst);
-		if (gstate.isDitherEnabled()) {
-			blended += Vec3<int>::AssignToAll(gstate.getDitherValue(p.x, p.y));
-		}
-
-		// ToRGB() always automatically clamps.
-		new_color = blended.ToRGB();
-		new_color |= stencil << 24;
-	} else {
-		if (gstate.isDitherEnabled()) {
-			// We'll discard alpha anyway.
-			prim_color += Vec4<int>::AssignToAll(gstate.getDitherValue(p.x, p.y));
-		}
-
-#if defined(_M_SSE)
-		new_color = Vec3<int>(prim_color.ivec).ToRGB();
-		new_color |= stencil << 24;
-#else
-		new_color = Vec4<int>(prim_color.r(), prim_color.g(), prim_color.b(), stencil).ToRGBA();
-#endif
-	}
-
-	// Logic ops are applied after blending (if blending is enabled.)
-	if (gstate.isLogicOpEnabled() && !clearMode) {
-		// Logic ops don't affect stencil, which happens inside ApplyLogicOp.
-		new_color = ApplyLogicOp(gstate.getLogicOp(), old_color, new_color);
-	}
-
-	if (clearMode) {
-		new_color = (new_color & ~gstate.getClearModeColorMask()) | (old_color & gstate.getClearModeColorMask());
-	}
-	new_color = (new_color & ~gstate.getColorMask()) | (old_color & gstate.getColorMask());
-
-	SetPixelColor(p.x, p.y, new_color);
-}
-
-void DrawSinglePixelNonClear(const DrawingCoords &p, u16 z, u8 fog, const Vec4<int> &color_in) {
-	DrawSinglePixel<false>(p, z, fog, color_in);
-}
 
 static inline void ApplyTexturing(Sampler::Funcs sampler, Vec4<int> &prim_color, float s, float t, int texlevel, int frac_texlevel, bool bilinear, u8 *texptr[], int texbufw[]) {
 	int u[8] = {0}, v[8] = {0};   // 1.23.8 fixed point
@@ -1136,8 +537,7 @@ static inline Vec4<float> EdgeRecip(const Vec4<int> &w0, const Vec4<int> &w1, co
 template <bool clearMode>
 void DrawTriangleSlice(
 	const VertexData& v0, const VertexData& v1, const VertexData& v2,
-	int minX, int minY, int maxX, int maxY,
-	bool byY, int h1, int h2)
+	int minX, int minY, const BinCoords &range)
 {
 	Vec4<int> bias0 = Vec4<int>::AssignToAll(IsRightSideOrFlatBottomLine(v0.screenpos.xy(), v1.screenpos.xy(), v2.screenpos.xy()) ? -1 : 0);
 	Vec4<int> bias1 = Vec4<int>::AssignToAll(IsRightSideOrFlatBottomLine(v1.screenpos.xy(), v2.screenpos.xy(), v0.screenpos.xy()) ? -1 : 0);
@@ -1169,15 +569,11 @@ void DrawTriangleSlice(
 	TriangleEdge e1;
 	TriangleEdge e2;
 
-	if (byY) {
-		maxY = std::min(maxY, minY + h2 * 16 * 2) - 1;
-		minY += h1 * 16 * 2;
-	} else {
-		maxX = std::min(maxX, minX + h2 * 16 * 2) - 1;
-		minX += h1 * 16 * 2;
-	}
+	// Pixel quads stay aligned to the triangle's bounds, so the result doesn't depend on how it's sliced.
+	const int startX = minX + (range.x1 - minX) / 32 * 32;
+	const int startY = minY + (range.y1 - minY) / 32 * 32;
 
-	ScreenCoords pprime(minX, minY, 0);
+	ScreenCoords pprime(startX, startY, 0);
 	Vec4<int> w0_base = e0.Start(v1.screenpos, v2.screenpos, pprime);
 	Vec4<int> w1_base = e1.Start(v2.screenpos, v0.screenpos, pprime);
 	Vec4<int> w2_base = e2.Start(v0.screenpos, v1.screenpos, pprime);
@@ -1187,8 +583,11 @@ void DrawTriangleSlice(
 	const bool flatZ = v0.screenpos.z == v1.screenpos.z && v0.screenpos.z == v2.screenpos.z;
 
 	Sampler::Funcs sampler = Sampler::GetFuncs();
+	PixelFuncID pixelID;
+	ComputePixelFuncID(&pixelID);
+	SingleFunc drawPixel = GetSingleFunc(pixelID);
 
-	for (pprime.y = minY; pprime.y <= maxY; pprime.y += 32,
+	for (pprime.y = startY; pprime.y <= range.y2; pprime.y += 32,
 										w0_base = e0.StepY(w0_base),
 										w1_base = e1.StepY(w1_base),
 										w2_base = e2.StepY(w2_base)) {
@@ -1197,20 +596,23 @@ void DrawTriangleSlice(
 		Vec4<int> w2 = w2_base;
 
 		// TODO: Maybe we can clip the edges instead?
-		int scissorYPlus1 = pprime.y + 16 > maxY ? -1 : 0;
-		Vec4<int> scissor_mask = Vec4<int>(0, maxX - minX, scissorYPlus1, (maxX - minX) | scissorYPlus1);
-		Vec4<int> scissor_step = Vec4<int>(0, -32, 0, -32);
+		// Negative when a row or column of the quad is outside the range.
+		const int scissorY0 = (pprime.y - range.y1) | (range.y2 - pprime.y);
+		const int scissorY1 = (pprime.y + 16 - range.y1) | (range.y2 - pprime.y - 16);
 
-		pprime.x = minX;
+		pprime.x = startX;
 		DrawingCoords p = TransformUnit::ScreenToDrawing(pprime);
 
-		for (; pprime.x <= maxX; pprime.x += 32,
+		for (; pprime.x <= range.x2; pprime.x += 32,
 			w0 = e0.StepX(w0),
 			w1 = e1.StepX(w1),
 			w2 = e2.StepX(w2),
-			scissor_mask = scissor_mask + scissor_step,
 			p.x = (p.x + 2) & 0x3FF) {
 
+			const int scissorX0 = (pprime.x - range.x1) | (range.x2 - pprime.x);
+			const int scissorX1 = (pprime.x + 16 - range.x1) | (range.x2 - pprime.x - 16);
+			Vec4<int> scissor_mask(scissorX0 | scissorY0, scissorX1 | scissorY0, scissorX0 | scissorY1, scissorX1 | scissorY1);
+
 			// If p is on or inside all edges, render pixel
 			Vec4<int> mask = MakeMask(w0, w1, w2, bias0, bias1, bias2, scissor_mask);
 			if (AnyMask(mask)) {
@@ -1286,74 +688,92 @@ void DrawTriangleSlice(
 					subp.x = p.x + (i & 1);
 					subp.y = p.y + (i / 2);
 
-					DrawSinglePixel<clearMode>(subp, (u16)z[i], fog[i], prim_color[i]);
+					drawPixel(subp.x, subp.y, (u16)z[i], fog[i], prim_color[i], pixelID);
 				}
 			}
 		}
 	}
 }
 
-// Draws triangle, vertices specified in counter-clockwise direction
-void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData& v2)
-{
-	PROFILE_THIS_SCOPE("draw_tri");
+BinCoords BinCoords::Intersect(const BinCoords &range) const {
+	BinCoords result;
+	result.x1 = std::max(x1, range.x1);
+	result.y1 = std::max(y1, range.y1);
+	result.x2 = std::min(x2, range.x2);
+	result.y2 = std::min(y2, range.y2);
+	return result;
+}
 
+BinCoords GetTriangleBounds(const VertexData &v0, const VertexData &v1, const VertexData &v2) {
 	Vec2<int> d01((int)v0.screenpos.x - (int)v1.screenpos.x, (int)v0.screenpos.y - (int)v1.screenpos.y);
 	Vec2<int> d02((int)v0.screenpos.x - (int)v2.screenpos.x, (int)v0.screenpos.y - (int)v2.screenpos.y);
-	Vec2<int> d12((int)v1.screenpos.x - (int)v2.screenpos.x, (int)v1.screenpos.y - (int)v2.screenpos.y);
 
 	// Drop primitives which are not in CCW order by checking the cross product
 	if (d01.x * d02.y - d01.y * d02.x < 0)
-		return;
+		return BinCoords{ 0, 0, -1, -1 };
+
+	BinCoords bounds;
+	bounds.x1 = std::min(std::min(v0.screenpos.x, v1.screenpos.x), v2.screenpos.x) & ~0xF;
+	bounds.y1 = std::min(std::min(v0.screenpos.y, v1.screenpos.y), v2.screenpos.y) & ~0xF;
+	bounds.x2 = (std::max(std::max(v0.screenpos.x, v1.screenpos.x), v2.screenpos.x) + 0xF) & ~0xF;
+	bounds.y2 = (std::max(std::max(v0.screenpos.y, v1.screenpos.y), v2.screenpos.y) + 0xF) & ~0xF;
+
+	// The scissor is inclusive, so cover all of the last pixel.
+	ScreenCoords scissorTL = TransformUnit::DrawingToScreen(DrawingCoords(gstate.getScissorX1(), gstate.getScissorY1(), 0));
+	ScreenCoords scissorBR = TransformUnit::DrawingToScreen(DrawingCoords(gstate.getScissorX2(), gstate.getScissorY2(), 0));
+	return bounds.Intersect(BinCoords{ scissorTL.x, scissorTL.y, scissorBR.x + 15, scissorBR.y + 15 });
+}
 
-	int minX = std::min(std::min(v0.screenpos.x, v1.screenpos.x), v2.screenpos.x) & ~0xF;
-	int minY = std::min(std::min(v0.screenpos.y, v1.screenpos.y), v2.screenpos.y) & ~0xF;
-	int maxX = (std::max(std::max(v0.screenpos.x, v1.screenpos.x), v2.screenpos.x) + 0xF) & ~0xF;
-	int maxY = (std::max(std::max(v0.screenpos.y, v1.screenpos.y), v2.screenpos.y) + 0xF) & ~0xF;
+// Draws triangle, vertices specified in counter-clockwise direction
+void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData& v2)
+{
+	PROFILE_THIS_SCOPE("draw_tri");
 
-	DrawingCoords scissorTL(gstate.getScissorX1(), gstate.getScissorY1(), 0);
-	DrawingCoords scissorBR(gstate.getScissorX2(), gstate.getScissorY2(), 0);
-	minX = std::max(minX, (int)TransformUnit::DrawingToScreen(scissorTL).x);
-	maxX = std::min(maxX, (int)TransformUnit::DrawingToScreen(scissorBR).x);
-	minY = std::max(minY, (int)TransformUnit::DrawingToScreen(scissorTL).y);
-	maxY = std::min(maxY, (int)TransformUnit::DrawingToScreen(scissorBR).y);
+	const BinCoords bounds = GetTriangleBounds(v0, v1, v2);
+	if (bounds.Invalid())
+		return;
+
+	auto drawSlice = [&](const BinCoords &range) {
+		if (gstate.isModeClear())
+			DrawTriangleSlice<true>(v0, v1, v2, bounds.x1, bounds.y1, range);
+		else
+			DrawTriangleSlice<false>(v0, v1, v2, bounds.x1, bounds.y1, range);
+	};
 
 	// 32 because we do two pixels at once, and we don't want overlap.
-	int rangeY = (maxY - minY) / 32 + 1;
-	int rangeX = (maxX - minX) / 32 + 1;
+	int rangeY = (bounds.y2 - bounds.y1) / 32 + 1;
+	int rangeX = (bounds.x2 - bounds.x1) / 32 + 1;
 	if (rangeY >= 12 && rangeX >= rangeY * 4) {
-		if (gstate.isModeClear()) {
-			auto bound = [&](int a, int b) -> void {
-				DrawTriangleSlice<true>(v0, v1, v2, minX, minY, maxX, maxY, false, a, b);
-			};
-			GlobalThreadPool::Loop(bound, 0, rangeX);
-		} else {
-			auto bound = [&](int a, int b) -> void {
-				DrawTriangleSlice<false>(v0, v1, v2, minX, minY, maxX, maxY, false, a, b);
-			};
-			GlobalThreadPool::Loop(bound, 0, rangeX);
-		}
+		GlobalThreadPool::Loop([&](int a, int b) {
+			BinCoords range = bounds;
+			range.x1 = bounds.x1 + a * 32;
+			range.x2 = std::min(bounds.x2, bounds.x1 + b * 32 - 1);
+			drawSlice(range);
+		}, 0, rangeX);
 	} else if (rangeY >= 12 && rangeX >= 12) {
-		if (gstate.isModeClear()) {
-			auto bound = [&](int a, int b) -> void {
-				DrawTriangleSlice<true>(v0, v1, v2, minX, minY, maxX, maxY, true, a, b);
-			};
-			GlobalThreadPool::Loop(bound, 0, rangeY);
-		} else {
-			auto bound = [&](int a, int b) -> void {
-				DrawTriangleSlice<false>(v0, v1, v2, minX, minY, maxX, maxY, true, a, b);
-			};
-			GlobalThreadPool::Loop(bound, 0, rangeY);
-		}
+		GlobalThreadPool::Loop([&](int a, int b) {
+			BinCoords range = bounds;
+			range.y1 = bounds.y1 + a * 32;
+			range.y2 = std::min(bounds.y2, bounds.y1 + b * 32 - 1);
+			drawSlice(range);
+		}, 0, rangeY);
 	} else {
-		if (gstate.isModeClear()) {
-			DrawTriangleSlice<true>(v0, v1, v2, minX, minY, maxX, maxY, true, 0, rangeY);
-		} else {
-			DrawTriangleSlice<false>(v0, v1, v2, minX, minY, maxX, maxY, true, 0, rangeY);
-		}
+		drawSlice(bounds);
 	}
 }
 
+void DrawTriangle(const VertexData &v0, const VertexData &v1, const VertexData &v2, const BinCoords &bounds, const BinCoords &range)
+{
+	const BinCoords clipped = bounds.Intersect(range);
+	if (clipped.Invalid())
+		return;
+
+	if (gstate.isModeClear())
+		DrawTriangleSlice<true>(v0, v1, v2, bounds.x1, bounds.y1, clipped);
+	else
+		DrawTriangleSlice<false>(v0, v1, v2, bounds.x1, bounds.y1, clipped);
+}
+
 void DrawPoint(const VertexData &v0)
 {
 	ScreenCoords pos = v0.screenpos;
@@ -1423,11 +843,10 @@ void DrawPoint(const VertexData &v0)
 		fog = ClampFogDepth(v0.fogdepth);
 	}
 
-	if (clearMode) {
-		DrawSinglePixel<true>(p, z, fog, prim_color);
-	} else {
-		DrawSinglePixel<false>(p, z, fog, prim_color);
-	}
+	PixelFuncID pixelID;
+	ComputePixelFuncID(&pixelID);
+	SingleFunc drawPixel = GetSingleFunc(pixelID);
+	drawPixel(p.x, p.y, z, fog, prim_color, pixelID);
 }
 
 void ClearRectangle(const VertexData &v0, const VertexData &v1)
@@ -1461,7 +880,7 @@ void ClearRectangle(const VertexData &v0, const VertexData &v1)
 				memset(row, z, w * 2);
 			} else {
 				for (int x = 0; x < w; ++x) {
-					SetPixelDepth(p.x + x, p.y, z);
+					depthbuf.Set16(p.x + x, p.y, stride, z);
 				}
 			}
 		}
@@ -1603,6 +1022,9 @@ void DrawLine(const VertexData &v0, const VertexData &v1)
 	}
 
 	Sampler::Funcs sampler = Sampler::GetFuncs();
+	PixelFuncID pixelID;
+	ComputePixelFuncID(&pixelID);
+	SingleFunc drawPixel = GetSingleFunc(pixelID);
 
 	float x = a.x > b.x ? a.x - 1 : a.x;
 	float y = a.y > b.y ? a.y - 1 : a.y;
@@ -1677,11 +1099,7 @@ void DrawLine(const VertexData &v0, const VertexData &v1)
 			ScreenCoords pprime = ScreenCoords((int)x, (int)y, (int)z);
 
 			DrawingCoords p = TransformUnit::ScreenToDrawing(pprime);
-			if (clearMode) {
-				DrawSinglePixel<true>(p, z, fog, prim_color);
-			} else {
-				DrawSinglePixel<false>(p, z, fog, prim_color);
-			}
+			drawPixel(p.x, p.y, (u16)z, fog, prim_color, pixelID);
 		}
 
 		x += xinc;
@@ -1699,7 +1117,7 @@ bool GetCurrentStencilbuffer(GPUDebugBuffer &buffer)
 	u8 *row = buffer.GetData();
 	for (int y = gstate.getRegionY1(); y <= gstate.getRegionY2(); ++y) {
 		for (int x = gstate.getRegionX1(); x <= gstate.getRegionX2(); ++x) {
-			row[x - gstate.getRegionX1()] = GetPixelStencil(x, y);
+			row[x - gstate.getRegionX1()] = GetPixelStencil(gstate.FrameBufFormat(), gstate.FrameBufStride(), x, y);
 		}
 		row += w;
 	}
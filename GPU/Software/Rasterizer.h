@@ -23,8 +23,27 @@ struct GPUDebugBuffer;
 
 namespace Rasterizer {
 
+// Screen coordinates (in 16ths of a pixel) to draw within, inclusive.
+struct BinCoords {
+	int x1;
+	int y1;
+	int x2;
+	int y2;
+
+	bool Invalid() const {
+		return x2 < x1 || y2 < y1;
+	}
+
+	BinCoords Intersect(const BinCoords &range) const;
+};
+
+// Returns the area a triangle covers within the scissor, or an invalid range if it's culled.
+BinCoords GetTriangleBounds(const VertexData &v0, const VertexData &v1, const VertexData &v2);
+
 // Draws a triangle if its vertices are specified in counter-clockwise order
 void DrawTriangle(const VertexData& v0, const VertexData& v1, const VertexData& v2);
+// Draws only the part within range, on the calling thread.  Bounds must be from GetTriangleBounds().
+void DrawTriangle(const VertexData &v0, const VertexData &v1, const VertexData &v2, const BinCoords &bounds, const BinCoords &range);
 void DrawPoint(const VertexData &v0);
 void DrawLine(const VertexData &v0, const VertexData &v1);
 void ClearRectangle(const VertexData &v0, const VertexData &v1);
@@ -33,8 +52,6 @@ bool GetCurrentStencilbuffer(GPUDebugBuffer &buffer);
 bool GetCurrentTexture(GPUDebugBuffer &buffer, int level);
 
 // Shared functions with RasterizerRectangle.cpp
-Vec3<int> AlphaBlendingResult(const Vec4<int> &source, const Vec4<int> &dst);
-void DrawSinglePixelNonClear(const DrawingCoords &p, u16 z, u8 fog, const Vec4<int> &color_in);
 Vec4<int> GetTextureFunctionOutput(const Vec4<int>& prim_color, const Vec4<int>& texcolor);
 
 }  // namespace Rasterizer
@@ -15,6 +15,7 @@
 
 #include "Rasterizer.h"
 #include "GPU/Common/TextureCacheCommon.h"
+#include "GPU/Software/DrawPixel.h"
 #include "GPU/Software/SoftGpu.h"
 #include "GPU/Software/Rasterizer.h"
 #include "GPU/Software/Sampler.h"
@@ -30,14 +31,14 @@ extern bool currentDialogActive;
 namespace Rasterizer {
 
 // Through mode, with the specific Darkstalker settings.
-inline void DrawSinglePixel5551(u16 *pixel, const u32 color_in) {
+inline void DrawSinglePixel5551(u16 *pixel, const u32 color_in, const PixelFuncID &pixelID) {
 	u32 new_color;
 	if ((color_in >> 24) == 255) {
 		new_color = color_in & 0xFFFFFF;
 	} else {
 		const u32 old_color = RGBA5551ToRGBA8888(*pixel);
 		const Vec4<int> dst = Vec4<int>::FromRGBA(old_color);
-		Vec3<int> blended = AlphaBlendingResult(Vec4<int>::FromRGBA(color_in), dst);
+		Vec3<int> blended = AlphaBlendingResult(pixelID, Vec4<int>::FromRGBA(color_in), dst);
 		// ToRGB() always automatically clamps.
 		new_color = blended.ToRGB();
 	}
@@ -86,6 +87,9 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 
 	ScreenCoords pprime(v0.screenpos.x, v0.screenpos.y, 0);
 	Sampler::NearestFunc nearestFunc = Sampler::GetNearestFunc();  // Looks at gstate.
+	PixelFuncID pixelID;
+	ComputePixelFuncID(&pixelID);
+	SingleFunc drawPixel = GetSingleFunc(pixelID);
 
 	DrawingCoords pos0 = TransformUnit::ScreenToDrawing(v0.screenpos);
 	DrawingCoords pos1 = TransformUnit::ScreenToDrawing(v1.screenpos);
@@ -94,7 +98,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 	DrawingCoords scissorBR(gstate.getScissorX2(), gstate.getScissorY2(), 0);
 
 	int z = pos0.z;
-	float fog = 1.0f;
+	int fog = 1;
 
 	bool isWhite = v0.color0 == Vec4<int>(255, 255, 255, 255);
 
@@ -146,7 +150,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 					for (int x = pos0.x; x < pos1.x; x++) {
 						u32 tex_color = nearestFunc(s, t, texptr, texbufw, 0);
 						if (tex_color & 0xFF000000) {
-							DrawSinglePixel5551(pixel, tex_color);
+							DrawSinglePixel5551(pixel, tex_color, pixelID);
 						}
 						s += ds;
 						pixel++;
@@ -157,7 +161,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 						Vec4<int> tex_color = Vec4<int>::FromRGBA(nearestFunc(s, t, texptr, texbufw, 0));
 						prim_color = ModulateRGBA(prim_color, tex_color);
 						if (prim_color.a() > 0) {
-							DrawSinglePixel5551(pixel, prim_color.ToRGBA());
+							DrawSinglePixel5551(pixel, prim_color.ToRGBA(), pixelID);
 						}
 						s += ds;
 						pixel++;
@@ -174,8 +178,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 					Vec4<int> prim_color = v0.color0;
 					Vec4<int> tex_color = Vec4<int>::FromRGBA(nearestFunc(s, t, texptr, texbufw, 0));
 					prim_color = GetTextureFunctionOutput(prim_color, tex_color);
-					DrawingCoords pos(x, y, z);
-					DrawSinglePixelNonClear(pos, (u16)z, 1.0f, prim_color);
+					drawPixel(x, y, (u16)z, 1, prim_color, pixelID);
 					s += ds;
 				}
 				t += dt;
@@ -206,7 +209,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 				u16 *pixel = fb.Get16Ptr(pos0.x, y, gstate.FrameBufStride());
 				for (int x = pos0.x; x < pos1.x; x++) {
 					Vec4<int> prim_color = v0.color0;
-					DrawSinglePixel5551(pixel, prim_color.ToRGBA());
+					DrawSinglePixel5551(pixel, prim_color.ToRGBA(), pixelID);
 					pixel++;
 				}
 			}
@@ -214,8 +217,7 @@ void DrawSprite(const VertexData& v0, const VertexData& v1) {
 			for (int y = pos0.y; y < pos1.y; y++) {
 				for (int x = pos0.x; x < pos1.x; x++) {
 					Vec4<int> prim_color = v0.color0;
-					DrawingCoords pos(x, y, z);
-					DrawSinglePixelNonClear(pos, (u16)z, fog, prim_color);
+					drawPixel(x, y, (u16)z, fog, prim_color, pixelID);
 				}
 			}
 		}
@@ -35,6 +35,7 @@
 #include "Common/Profiler/Profiler.h"
 #include "Common/GPU/thin3d.h"
 
+#include "GPU/Software/DrawPixel.h"
 #include "GPU/Software/Rasterizer.h"
 #include "GPU/Software/Sampler.h"
 #include "GPU/Software/SoftGpu.h"
@@ -66,6 +67,7 @@ SoftGPU::SoftGPU(GraphicsContext *gfxCtx, Draw::DrawContext *draw)
 	displayFormat_ = GE_FORMAT_8888;
 
 	Sampler::Init();
+	Rasterizer::Init();
 	drawEngine_ = new SoftwareDrawEngine();
 	drawEngineCommon_ = drawEngine_;
 	presentation_ = new PresentationCommon(draw_);
@@ -121,6 +123,7 @@ SoftGPU::~SoftGPU() {
 	}
 
 	Sampler::Shutdown();
+	Rasterizer::Shutdown();
 }
 
 void SoftGPU::SetDisplayFramebuffer(u32 framebuf, u32 stride, GEBufferFormat format) {
@@ -283,6 +286,7 @@ void SoftGPU::CopyToCurrentFboFromDisplayRam(int srcwidth, int srcheight) {
 }
 
 void SoftGPU::CopyDisplayToOutput(bool reallyDirty) {
+	drawEngine_->transformUnit.Flush();
 	// The display always shows 480x272.
 	CopyToCurrentFboFromDisplayRam(FB_WIDTH, FB_HEIGHT);
 	framebufferDirty_ = false;
@@ -309,6 +313,7 @@ void SoftGPU::FastRunLoop(DisplayList &list) {
 		u32 cmd = op >> 24;
 
 		u32 diff = op ^ gstate.cmdmem[cmd];
+		PreExecuteOp(op, diff);
 		gstate.cmdmem[cmd] = op;
 		ExecuteOp(op, diff);
 
@@ -316,6 +321,114 @@ void SoftGPU::FastRunLoop(DisplayList &list) {
 	}
 }
 
+// Whether queued triangles must be drawn before this command runs.
+// Anything consumed while transforming vertices is fine, the rest is read by the rasterizer.
+static bool NeedsFlushBefore(u32 cmd, u32 diff) {
+	switch (cmd) {
+	case GE_CMD_NOP:
+	case GE_CMD_PRIM:
+	case GE_CMD_BEZIER:
+	case GE_CMD_SPLINE:
+	case GE_CMD_BOUNDINGBOX:
+	case GE_CMD_VADDR:
+	case GE_CMD_IADDR:
+	case GE_CMD_BASE:
+	case GE_CMD_OFFSETADDR:
+	case GE_CMD_ORIGIN:
+	case GE_CMD_JUMP:
+	case GE_CMD_BJUMP:
+	case GE_CMD_CALL:
+	case GE_CMD_RET:
+	case GE_CMD_MORPHWEIGHT0:
+	case GE_CMD_MORPHWEIGHT1:
+	case GE_CMD_MORPHWEIGHT2:
+	case GE_CMD_MORPHWEIGHT3:
+	case GE_CMD_MORPHWEIGHT4:
+	case GE_CMD_MORPHWEIGHT5:
+	case GE_CMD_MORPHWEIGHT6:
+	case GE_CMD_MORPHWEIGHT7:
+	case GE_CMD_PATCHDIVISION:
+	case GE_CMD_PATCHPRIMITIVE:
+	case GE_CMD_PATCHFACING:
+	case GE_CMD_WORLDMATRIXNUMBER:
+	case GE_CMD_WORLDMATRIXDATA:
+	case GE_CMD_VIEWMATRIXNUMBER:
+	case GE_CMD_VIEWMATRIXDATA:
+	case GE_CMD_PROJMATRIXNUMBER:
+	case GE_CMD_PROJMATRIXDATA:
+	case GE_CMD_TGENMATRIXNUMBER:
+	case GE_CMD_TGENMATRIXDATA:
+	case GE_CMD_BONEMATRIXNUMBER:
+	case GE_CMD_BONEMATRIXDATA:
+	case GE_CMD_VIEWPORTXSCALE:
+	case GE_CMD_VIEWPORTYSCALE:
+	case GE_CMD_VIEWPORTZSCALE:
+	case GE_CMD_VIEWPORTXCENTER:
+	case GE_CMD_VIEWPORTYCENTER:
+	case GE_CMD_VIEWPORTZCENTER:
+	case GE_CMD_LIGHTINGENABLE:
+	case GE_CMD_LIGHTENABLE0:
+	case GE_CMD_LIGHTENABLE1:
+	case GE_CMD_LIGHTENABLE2:
+	case GE_CMD_LIGHTENABLE3:
+	case GE_CMD_LIGHTMODE:
+	case GE_CMD_LIGHTTYPE0:
+	case GE_CMD_LIGHTTYPE1:
+	case GE_CMD_LIGHTTYPE2:
+	case GE_CMD_LIGHTTYPE3:
+	case GE_CMD_LX0: case GE_CMD_LY0: case GE_CMD_LZ0:
+	case GE_CMD_LX1: case GE_CMD_LY1: case GE_CMD_LZ1:
+	case GE_CMD_LX2: case GE_CMD_LY2: case GE_CMD_LZ2:
+	case GE_CMD_LX3: case GE_CMD_LY3: case GE_CMD_LZ3:
+	case GE_CMD_LDX0: case GE_CMD_LDY0: case GE_CMD_LDZ0:
+	case GE_CMD_LDX1: case GE_CMD_LDY1: case GE_CMD_LDZ1:
+	case GE_CMD_LDX2: case GE_CMD_LDY2: case GE_CMD_LDZ2:
+	case GE_CMD_LDX3: case GE_CMD_LDY3: case GE_CMD_LDZ3:
+	case GE_CMD_LKA0: case GE_CMD_LKB0: case GE_CMD_LKC0:
+	case GE_CMD_LKA1: case GE_CMD_LKB1: case GE_CMD_LKC1:
+	case GE_CMD_LKA2: case GE_CMD_LKB2: case GE_CMD_LKC2:
+	case GE_CMD_LKA3: case GE_CMD_LKB3: case GE_CMD_LKC3:
+	case GE_CMD_LKS0: case GE_CMD_LKS1: case GE_CMD_LKS2: case GE_CMD_LKS3:
+	case GE_CMD_LKO0: case GE_CMD_LKO1: case GE_CMD_LKO2: case GE_CMD_LKO3:
+	case GE_CMD_LAC0: case GE_CMD_LDC0: case GE_CMD_LSC0:
+	case GE_CMD_LAC1: case GE_CMD_LDC1: case GE_CMD_LSC1:
+	case GE_CMD_LAC2: case GE_CMD_LDC2: case GE_CMD_LSC2:
+	case GE_CMD_LAC3: case GE_CMD_LDC3: case GE_CMD_LSC3:
+	case GE_CMD_AMBIENTCOLOR:
+	case GE_CMD_AMBIENTALPHA:
+	case GE_CMD_MATERIALUPDATE:
+	case GE_CMD_MATERIALAMBIENT:
+	case GE_CMD_MATERIALDIFFUSE:
+	case GE_CMD_MATERIALEMISSIVE:
+	case GE_CMD_MATERIALSPECULAR:
+	case GE_CMD_MATERIALALPHA:
+	case GE_CMD_MATERIALSPECULARCOEF:
+		return false;
+
+	case GE_CMD_LOADCLUT:
+	case GE_CMD_TRANSFERSTART:
+	case GE_CMD_TEXFLUSH:
+	case GE_CMD_TEXSYNC:
+	case GE_CMD_SIGNAL:
+	case GE_CMD_FINISH:
+	case GE_CMD_END:
+		return true;
+
+	default:
+		return diff != 0;
+	}
+}
+
+void SoftGPU::PreExecuteOp(u32 op, u32 diff) {
+	if (NeedsFlushBefore(op >> 24, diff))
+		drawEngine_->transformUnit.Flush();
+}
+
+void SoftGPU::FinishDeferred() {
+	// The list stalled or ended, so the CPU may look at (or change) anything now.
+	drawEngine_->transformUnit.Flush();
+}
+
 void SoftGPU::ExecuteOp(u32 op, u32 diff) {
 	u32 cmd = op >> 24;
 	u32 data = op & 0xFFFFFF;
@@ -887,6 +1000,7 @@ void SoftGPU::NotifyVideoUpload(u32 addr, int size, int width, int format)
 
 bool SoftGPU::PerformMemoryCopy(u32 dest, u32 src, int size)
 {
+	drawEngine_->transformUnit.Flush();
 	// Nothing to update.
 	InvalidateCache(dest, size, GPU_INVALIDATE_HINT);
 	GPURecord::NotifyMemcpy(dest, src, size);
@@ -897,6 +1011,7 @@ bool SoftGPU::PerformMemoryCopy(u32 dest, u32 src, int size)
 
 bool SoftGPU::PerformMemorySet(u32 dest, u8 v, int size)
 {
+	drawEngine_->transformUnit.Flush();
 	// Nothing to update.
 	InvalidateCache(dest, size, GPU_INVALIDATE_HINT);
 	GPURecord::NotifyMemset(dest, v, size);
@@ -907,6 +1022,7 @@ bool SoftGPU::PerformMemorySet(u32 dest, u8 v, int size)
 
 bool SoftGPU::PerformMemoryDownload(u32 dest, int size)
 {
+	drawEngine_->transformUnit.Flush();
 	// Nothing to update.
 	InvalidateCache(dest, size, GPU_INVALIDATE_HINT);
 	return false;
@@ -914,6 +1030,7 @@ bool SoftGPU::PerformMemoryDownload(u32 dest, int size)
 
 bool SoftGPU::PerformMemoryUpload(u32 dest, int size)
 {
+	drawEngine_->transformUnit.Flush();
 	// Nothing to update.
 	InvalidateCache(dest, size, GPU_INVALIDATE_HINT);
 	GPURecord::NotifyUpload(dest, size);
@@ -922,10 +1039,12 @@ bool SoftGPU::PerformMemoryUpload(u32 dest, int size)
 
 bool SoftGPU::PerformStencilUpload(u32 dest, int size)
 {
+	drawEngine_->transformUnit.Flush();
 	return false;
 }
 
 bool SoftGPU::FramebufferDirty() {
+	drawEngine_->transformUnit.Flush();
 	if (g_Config.iFrameSkip != 0) {
 		bool dirty = framebufferDirty_;
 		framebufferDirty_ = false;
@@ -935,6 +1054,7 @@ bool SoftGPU::FramebufferDirty() {
 }
 
 bool SoftGPU::GetCurrentFramebuffer(GPUDebugBuffer &buffer, GPUDebugFramebufferType type, int maxRes) {
+	drawEngine_->transformUnit.Flush();
 	int x1 = gstate.getRegionX1();
 	int y1 = gstate.getRegionY1();
 	int x2 = gstate.getRegionX2() + 1;
@@ -971,6 +1091,7 @@ bool SoftGPU::GetOutputFramebuffer(GPUDebugBuffer &buffer) {
 
 bool SoftGPU::GetCurrentDepthbuffer(GPUDebugBuffer &buffer)
 {
+	drawEngine_->transformUnit.Flush();
 	const int w = gstate.getRegionX2() - gstate.getRegionX1() + 1;
 	const int h = gstate.getRegionY2() - gstate.getRegionY1() + 1;
 	buffer.Allocate(w, h, GPU_DBG_FORMAT_16BIT);
@@ -988,6 +1109,7 @@ bool SoftGPU::GetCurrentDepthbuffer(GPUDebugBuffer &buffer)
 
 bool SoftGPU::GetCurrentStencilbuffer(GPUDebugBuffer &buffer)
 {
+	drawEngine_->transformUnit.Flush();
 	return Rasterizer::GetCurrentStencilbuffer(buffer);
 }
 
@@ -1017,5 +1139,9 @@ bool SoftGPU::DescribeCodePtr(const u8 *ptr, std::string &name) {
 		name = "SamplerJit:" + subname;
 		return true;
 	}
+	if (Rasterizer::DescribeCodePtr(ptr, subname)) {
+		name = "PixelJit:" + subname;
+		return true;
+	}
 	return false;
 }
@@ -27,6 +27,7 @@
 #include "GPU/Common/SplineCommon.h"
 #include "GPU/Debugger/Debugger.h"
 #include "GPU/Software/TransformUnit.h"
+#include "GPU/Software/BinManager.h"
 #include "GPU/Software/Clipper.h"
 #include "GPU/Software/Lighting.h"
 #include "GPU/Software/RasterizerRectangle.h"
@@ -35,10 +36,12 @@
 
 TransformUnit::TransformUnit() {
 	buf = (u8 *)AllocateMemoryPages(TRANSFORM_BUF_SIZE, MEM_PROT_READ | MEM_PROT_WRITE);
+	binner_ = new BinManager();
 }
 
 TransformUnit::~TransformUnit() {
 	FreeMemoryPages(buf, DECODED_VERTEX_BUFFER_SIZE);
+	delete binner_;
 }
 
 SoftwareDrawEngine::SoftwareDrawEngine() {
@@ -377,26 +380,26 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 				case GE_PRIM_TRIANGLES:
 				{
 					if (!gstate.isCullEnabled() || gstate.isModeClear()) {
-						Clipper::ProcessTriangle(data[0], data[1], data[2], data[2]);
-						Clipper::ProcessTriangle(data[2], data[1], data[0], data[2]);
+						Clipper::ProcessTriangle(data[0], data[1], data[2], data[2], *binner_);
+						Clipper::ProcessTriangle(data[2], data[1], data[0], data[2], *binner_);
 					} else if (!gstate.getCullMode()) {
-						Clipper::ProcessTriangle(data[2], data[1], data[0], data[2]);
+						Clipper::ProcessTriangle(data[2], data[1], data[0], data[2], *binner_);
 					} else {
-						Clipper::ProcessTriangle(data[0], data[1], data[2], data[2]);
+						Clipper::ProcessTriangle(data[0], data[1], data[2], data[2], *binner_);
 					}
 					break;
 				}
 
 				case GE_PRIM_RECTANGLES:
-					Clipper::ProcessRect(data[0], data[1]);
+					Clipper::ProcessRect(data[0], data[1], *binner_);
 					break;
 
 				case GE_PRIM_LINES:
-					Clipper::ProcessLine(data[0], data[1]);
+					Clipper::ProcessLine(data[0], data[1], *binner_);
 					break;
 
 				case GE_PRIM_POINTS:
-					Clipper::ProcessPoint(data[0]);
+					Clipper::ProcessPoint(data[0], *binner_);
 					break;
 
 				default:
@@ -430,7 +433,7 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 					--skip_count;
 				} else {
 					// We already incremented data_index, so data_index & 1 is previous one.
-					Clipper::ProcessLine(data[data_index & 1], data[(data_index & 1) ^ 1]);
+					Clipper::ProcessLine(data[data_index & 1], data[(data_index & 1) ^ 1], *binner_);
 				}
 			}
 			break;
@@ -456,7 +459,7 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 
 				// If a strip is effectively a rectangle, draw it as such!
 				if (Rasterizer::DetectRectangleFromThroughModeStrip(data)) {
-					Clipper::ProcessRect(data[0], data[3]);
+					Clipper::ProcessRect(data[0], data[3], *binner_);
 					break;
 				}
 			}
@@ -483,14 +486,14 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 				}
 
 				if (!gstate.isCullEnabled() || gstate.isModeClear()) {
-					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index]);
-					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index]);
+					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index], *binner_);
+					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index], *binner_);
 				} else if ((!gstate.getCullMode()) ^ ((data_index - 1) % 2)) {
 					// We need to reverse the vertex order for each second primitive,
 					// but we additionally need to do that for every primitive if CCW cullmode is used.
-					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index]);
+					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index], *binner_);
 				} else {
-					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index]);
+					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index], *binner_);
 				}
 			}
 			break;
@@ -537,14 +540,14 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 				}
 
 				if (!gstate.isCullEnabled() || gstate.isModeClear()) {
-					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index]);
-					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index]);
+					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index], *binner_);
+					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index], *binner_);
 				} else if ((!gstate.getCullMode()) ^ ((data_index - 1) % 2)) {
 					// We need to reverse the vertex order for each second primitive,
 					// but we additionally need to do that for every primitive if CCW cullmode is used.
-					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index]);
+					Clipper::ProcessTriangle(data[2], data[1], data[0], data[provoking_index], *binner_);
 				} else {
-					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index]);
+					Clipper::ProcessTriangle(data[0], data[1], data[2], data[provoking_index], *binner_);
 				}
 			}
 			break;
@@ -558,6 +561,10 @@ void TransformUnit::SubmitPrimitive(void* vertices, void* indices, GEPrimitiveTy
 	GPUDebug::NotifyDraw();
 }
 
+void TransformUnit::Flush() {
+	binner_->Flush();
+}
+
 // TODO: This probably is not the best interface.
 // Also, we should try to merge this into the similar function in DrawEngineCommon.
 bool TransformUnit::GetCurrentSimpleVertices(int count, std::vector<GPUDebugVertex> &vertices, std::vector<u16> &indices) {
@@ -115,6 +115,7 @@ struct VertexData
 class VertexReader;
 
 class SoftwareDrawEngine;
+class BinManager;
 
 class TransformUnit {
 public:
@@ -134,8 +135,14 @@ class TransformUnit {
 	bool GetCurrentSimpleVertices(int count, std::vector<GPUDebugVertex> &vertices, std::vector<u16> &indices);
 	VertexData ReadVertex(VertexReader& vreader);
 
+	// Draws everything queued so far.  Must be called before state changes or framebuffer access.
+	void Flush();
+
 	bool outside_range_flag = false;
 	u8 *buf;
+
+private:
+	BinManager *binner_;
 };
 
 class SoftwareDrawEngine : public DrawEngineCommon {
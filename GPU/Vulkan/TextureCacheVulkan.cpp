@@ -446,6 +446,7 @@ void TextureCacheVulkan::StartFrame() {
 
 	timesInvalidatedAllThisFrame_ = 0;
 	texelsScaledThisFrame_ = 0;
+	PollScaleJobs();
 
 	if (clearCacheNextFrame_) {
 		Clear(true);
@@ -780,16 +781,7 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 		scaleFactor = 1;
 	}
 
-	if (scaleFactor != 1) {
-		if (texelsScaledThisFrame_ >= TEXCACHE_MAX_TEXELS_SCALED && !hardwareScaling) {
-			entry->status |= TexCacheEntry::STATUS_TO_SCALE;
-			scaleFactor = 1;
-		} else {
-			entry->status &= ~TexCacheEntry::STATUS_TO_SCALE;
-			entry->status |= TexCacheEntry::STATUS_IS_SCALED;
-			texelsScaledThisFrame_ += w * h;
-		}
-	}
+	scaleFactor = ApplyScaleBudget(entry, scaleFactor, w, h, hardwareScaling);
 
 	// TODO
 	if (scaleFactor > 1) {
@@ -1092,11 +1084,14 @@ void TextureCacheVulkan::LoadTextureLevel(TexCacheEntry &entry, uint8_t *writePt
 			entry.SetAlphaStatus(TexCacheEntry::STATUS_ALPHA_UNKNOWN);
 		}
 
+		// If it's to be scaled in the background, this gets it started.
+		QueueScale(asyncScaler, entry, (const u8 *)pixelData, decPitch, bpp, (u32)dstFmt, w, h);
+
 		if (scaleFactor > 1) {
 			u32 fmt = dstFmt;
 			// CPU scaling reads from the destination buffer so we want cached RAM.
 			uint8_t *rearrange = (uint8_t *)AllocateAlignedMemory(w * scaleFactor * h * scaleFactor * 4, 16);
-			scaler.ScaleAlways((u32 *)rearrange, pixelData, fmt, w, h, scaleFactor);
+			ScaleTexture(scaler, entry, (u32 *)rearrange, pixelData, fmt, w, h, scaleFactor);
 			pixelData = (u32 *)writePtr;
 			dstFmt = (VkFormat)fmt;
 
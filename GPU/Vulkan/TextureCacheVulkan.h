@@ -127,9 +127,10 @@ class TextureCacheVulkan : public TextureCacheCommon {
 	SamplerCache samplerCache_;
 
 	TextureScalerVulkan scaler;
+	// Only used by the thread pool, for scaling in the background.
+	TextureScalerVulkan asyncScaler;
 
 	int decimationCounter_ = 0;
-	int texelsScaledThisFrame_ = 0;
 	int timesInvalidatedAllThisFrame_ = 0;
 
 	FramebufferManagerVulkan *framebufferManagerVulkan_;
@@ -367,6 +367,9 @@ static const JitDisableFlag jitDisableFlags[] = {
 	{ MIPSComp::JitDisable::CACHE_POINTERS, "Cached pointers" },
 	{ MIPSComp::JitDisable::REGALLOC_GPR, "GPR Regalloc across instructions" },
 	{ MIPSComp::JitDisable::REGALLOC_FPR, "FPR Regalloc across instructions" },
+	{ MIPSComp::JitDisable::IR_NATIVE, "IR native codegen" },
+	{ MIPSComp::JitDisable::IR_THREADED, "IR threaded dispatch" },
+	{ MIPSComp::JitDisable::IR_TRACES, "IR trace formation" },
 };
 
 void JitDebugScreen::CreateViews() {
@@ -886,6 +889,10 @@ UI::EventReturn JitCompareScreen::OnShowStats(UI::EventParams &e) {
 	NOTICE_LOG(JIT, "Average Bloat: %0.2f%%", 100 * bcStats.avgBloat);
 	NOTICE_LOG(JIT, "Min Bloat: %0.2f%%  (%08x)", 100 * bcStats.minBloat, bcStats.minBloatBlock);
 	NOTICE_LOG(JIT, "Max Bloat: %0.2f%%  (%08x)", 100 * bcStats.maxBloat, bcStats.maxBloatBlock);
+	if (bcStats.numTraces != 0) {
+		NOTICE_LOG(JIT, "Traces: %i (covering %i blocks)", bcStats.numTraces, bcStats.numTracedBlocks);
+		NOTICE_LOG(JIT, "Trace coverage: %0.2f%% of block runs", 100 * bcStats.traceCoverage);
+	}
 
 	int ctr = 0, sz = (int)bcStats.bloatMap.size();
 	for (auto iter : bcStats.bloatMap) {
@@ -534,6 +534,28 @@ void GameSettingsScreen::CreateViews() {
 		return !g_Config.bSoftwareRendering && !UsingHardwareTextureScaling();
 	});
 
+	CheckBox *texScalingAsync = graphicsSettings->Add(new CheckBox(&g_Config.bTexScalingAsync, gr->T("Upscale in background")));
+	texScalingAsync->OnClick.Add([=](EventParams &e) {
+		if (g_Config.bTexScalingAsync == true) {
+			settingInfo_->Show(gr->T("Upscale in background Tip", "Avoids stutter when new textures appear, they look blurry for a moment instead"), e.v);
+		}
+		return UI::EVENT_CONTINUE;
+	});
+	texScalingAsync->SetEnabledFunc([]() {
+		return !g_Config.bSoftwareRendering && !UsingHardwareTextureScaling();
+	});
+
+	CheckBox *textureDiskCache = graphicsSettings->Add(new CheckBox(&g_Config.bTextureDiskCache, gr->T("Keep upscaled textures on disk")));
+	textureDiskCache->OnClick.Add([=](EventParams &e) {
+		if (g_Config.bTextureDiskCache == true) {
+			settingInfo_->Show(gr->T("Keep upscaled textures on disk Tip", "Faster next time, but uses storage space"), e.v);
+		}
+		return UI::EVENT_CONTINUE;
+	});
+	textureDiskCache->SetEnabledFunc([]() {
+		return !g_Config.bSoftwareRendering && !UsingHardwareTextureScaling() && g_Config.iTexScalingLevel != 1;
+	});
+
 	ChoiceWithValueDisplay *textureShaderChoice = graphicsSettings->Add(new ChoiceWithValueDisplay(&g_Config.sTextureShaderName, gr->T("Texture Shader"), &TextureTranslateName));
 	textureShaderChoice->OnClick.Handle(this, &GameSettingsScreen::OnTextureShader);
 	textureShaderChoice->SetEnabledFunc([]() {
@@ -616,6 +638,10 @@ void GameSettingsScreen::CreateViews() {
 	altVolume->SetZeroLabel(a->T("Mute"));
 	altVolume->SetNegativeDisable(a->T("Use global volume"));
 
+	static const char *resamplers[] = { "Linear (fast)", "Sinc", "Sinc (high quality)" };
+	PopupMultiChoice *resamplerChoice = audioSettings->Add(new PopupMultiChoice(&g_Config.iAudioResampler, a->T("Audio resampler"), resamplers, 0, ARRAY_SIZE(resamplers), a->GetName(), screenManager()));
+	resamplerChoice->SetEnabledPtr(&g_Config.bEnableSound);
+
 #ifdef _WIN32
 	if (IsVistaOrHigher()) {
 		static const char *backend[] = { "Auto", "DSound (compatible)", "WASAPI (fast)" };
@@ -929,6 +955,8 @@ void GameSettingsScreen::CreateViews() {
 
 	systemSettings->Add(new Choice(sy->T("Restore Default Settings")))->OnClick.Handle(this, &GameSettingsScreen::OnRestoreDefaultSettings);
 	systemSettings->Add(new CheckBox(&g_Config.bEnableStateUndo, sy->T("Savestate slot backups")));
+	static const char *saveStateCompressionChoices[] = { "Fast", "Small", "Compatible with older versions" };
+	systemSettings->Add(new PopupMultiChoice(&g_Config.iSaveStateCompression, sy->T("Savestate compression"), saveStateCompressionChoices, 0, ARRAY_SIZE(saveStateCompressionChoices), sy->GetName(), screenManager()));
 	static const char *autoLoadSaveStateChoices[] = { "Off", "Oldest Save", "Newest Save", "Slot 1", "Slot 2", "Slot 3", "Slot 4", "Slot 5" };
 	systemSettings->Add(new PopupMultiChoice(&g_Config.iAutoLoadSaveState, sy->T("Auto Load Savestate"), autoLoadSaveStateChoices, 0, ARRAY_SIZE(autoLoadSaveStateChoices), sy->GetName(), screenManager()));
 #if defined(USING_WIN_UI) || defined(USING_QT_UI) || PPSSPP_PLATFORM(ANDROID)
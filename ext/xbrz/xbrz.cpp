@@ -20,6 +20,11 @@
 #include <limits>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XBRZ_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace
 {
 template <uint32_t N> inline
@@ -206,60 +211,30 @@ double distYCbCr(uint32_t pix1, uint32_t pix2, double lumaWeight)
 }
 
 
-struct DistYCbCrBuffer //30% perf boost compared to distYCbCr()!
+//distYCbCr() with a luminance weight of 1, after rounding the color differences to odd numbers, as float.
+//this used to be looked up in a 64 MB table of all 2^24 rounded differences ("30% perf boost compared to distYCbCr()!"),
+//but working it out is faster again once the colors vary enough for the table to miss the cache, and gives the same result
+inline
+double distYCbCrRounded(uint32_t pix1, uint32_t pix2)
 {
-public:
-	static double dist(uint32_t pix1, uint32_t pix2)
-	{
-#if defined _MSC_VER && _MSC_VER < 1900
-#error function scope static initialization is not yet thread-safe!
-#endif
-		static const DistYCbCrBuffer inst;
-		return inst.distImpl(pix1, pix2);
-	}
-
-private:
-	DistYCbCrBuffer() : buffer(256 * 256 * 256)
-	{
-		for (uint32_t i = 0; i < 256 * 256 * 256; ++i) //startup time: 114 ms on Intel Core i5 (four cores)
-		{
-			const int r_diff = getByte<2>(i) * 2 - 255;
-			const int g_diff = getByte<1>(i) * 2 - 255;
-			const int b_diff = getByte<0>(i) * 2 - 255;
+	//slightly reduce precision (division by 2) to squeeze value into single byte, as the table did
+	const int r_diff = (static_cast<int>(getRed  (pix1)) - getRed  (pix2) + 255) / 2 * 2 - 255;
+	const int g_diff = (static_cast<int>(getGreen(pix1)) - getGreen(pix2) + 255) / 2 * 2 - 255;
+	const int b_diff = (static_cast<int>(getBlue (pix1)) - getBlue (pix2) + 255) / 2 * 2 - 255;
 
-			const double k_b = 0.0593; //ITU-R BT.2020 conversion
-			const double k_r = 0.2627; //
-			const double k_g = 1 - k_b - k_r;
-
-			const double scale_b = 0.5 / (1 - k_b);
-			const double scale_r = 0.5 / (1 - k_r);
-
-			const double y   = k_r * r_diff + k_g * g_diff + k_b * b_diff; //[!], analog YCbCr!
-			const double c_b = scale_b * (b_diff - y);
-			const double c_r = scale_r * (r_diff - y);
-
-			buffer[i] = static_cast<float>(std::sqrt(square(y) + square(c_b) + square(c_r)));
-		}
-	}
-
-	double distImpl(uint32_t pix1, uint32_t pix2) const
-	{
-		//if (pix1 == pix2) -> 8% perf degradation!
-		//	return 0;
-		//if (pix1 > pix2)
-		//	  std::swap(pix1, pix2); -> 30% perf degradation!!!
+	const double k_b = 0.0593; //ITU-R BT.2020 conversion
+	const double k_r = 0.2627; //
+	const double k_g = 1 - k_b - k_r;
 
-		const int r_diff = static_cast<int>(getRed  (pix1)) - getRed  (pix2);
-		const int g_diff = static_cast<int>(getGreen(pix1)) - getGreen(pix2);
-		const int b_diff = static_cast<int>(getBlue (pix1)) - getBlue (pix2);
+	const double scale_b = 0.5 / (1 - k_b);
+	const double scale_r = 0.5 / (1 - k_r);
 
-		return buffer[(((r_diff + 255) / 2) << 16) | //slightly reduce precision (division by 2) to squeeze value into single byte
-					  (((g_diff + 255) / 2) <<  8) |
-					  (( b_diff + 255) / 2)];
-	}
+	const double y   = k_r * r_diff + k_g * g_diff + k_b * b_diff; //[!], analog YCbCr!
+	const double c_b = scale_b * (b_diff - y);
+	const double c_r = scale_r * (r_diff - y);
 
-	std::vector<float> buffer; //consumes 64 MB memory; using double is only 2% faster, but takes 128 MB
-};
+	return static_cast<float>(std::sqrt(square(y) + square(c_b) + square(c_r)));
+}
 
 
 enum BlendType
@@ -299,23 +274,21 @@ input kernel area naming convention:
 | M | N | O | P |
 -----------------
 */
-template <class ColorDistance>
-FORCE_INLINE //detect blend direction
-BlendResult preProcessCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg) //result: F, G, J, K corners of "GradientType"
+inline
+bool cornersNeedNoBlend(const Kernel_4x4& ker) //checked before working out any color distances
 {
-	BlendResult result = {};
-
-	if ((ker.f == ker.g &&
-		 ker.j == ker.k) ||
-		(ker.f == ker.j &&
-		 ker.g == ker.k))
-		return result;
+	return (ker.f == ker.g &&
+			ker.j == ker.k) ||
+		   (ker.f == ker.j &&
+			ker.g == ker.k);
+}
 
-	auto dist = [&](uint32_t pix1, uint32_t pix2) { return ColorDistance::dist(pix1, pix2, cfg.luminanceWeight); };
+const int diagonalWeight = 4; //weight of the center diagonal against the four next to it
 
-	const int weight = 4;
-	double jg = dist(ker.i, ker.f) + dist(ker.f, ker.c) + dist(ker.n, ker.k) + dist(ker.k, ker.h) + weight * dist(ker.j, ker.g);
-	double fk = dist(ker.e, ker.j) + dist(ker.j, ker.o) + dist(ker.b, ker.g) + dist(ker.g, ker.l) + weight * dist(ker.f, ker.k);
+FORCE_INLINE //detect blend direction from the color distances along the J-G and F-K diagonals
+BlendResult blendCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg, double jg, double fk)
+{
+	BlendResult result = {};
 
 	if (jg < fk) //test sample: 70% of values max(jg, fk) / min(jg, fk) are between 1.1 and 3.7 with median being 1.8
 	{
@@ -338,6 +311,88 @@ BlendResult preProcessCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg)
 	return result;
 }
 
+template <class ColorDistance>
+FORCE_INLINE //detect blend direction
+BlendResult preProcessCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg) //result: F, G, J, K corners of "GradientType"
+{
+	if (cornersNeedNoBlend(ker))
+		return BlendResult();
+
+	auto dist = [&](uint32_t pix1, uint32_t pix2) { return ColorDistance::dist(pix1, pix2, cfg.luminanceWeight); };
+
+	const int weight = diagonalWeight;
+	double jg = dist(ker.i, ker.f) + dist(ker.f, ker.c) + dist(ker.n, ker.k) + dist(ker.k, ker.h) + weight * dist(ker.j, ker.g);
+	double fk = dist(ker.e, ker.j) + dist(ker.j, ker.o) + dist(ker.b, ker.g) + dist(ker.g, ker.l) + weight * dist(ker.f, ker.k);
+
+	return blendCorners(ker, cfg, jg, fk);
+}
+
+
+/*
+All ten distances preProcessCorners() needs are between diagonal neighbors, and each one is shared by five
+kernels. Away from the image borders they're worked out a row at a time instead, and kept for the three rows
+a kernel spans. Row y holds, for each x:
+	down[x] = dist(P(x, y),     P(x + 1, y + 1))  -> F-K diagonal
+	up  [x] = dist(P(x, y + 1), P(x + 1, y))      -> J-G diagonal
+*/
+template <class ColorDistance>
+class DiagonalDistances
+{
+public:
+	DiagonalDistances(const uint32_t* src, int srcWidth, const xbrz::ScalerCfg& cfg) :
+		src_(src),
+		srcWidth_(srcWidth),
+		cfg_(cfg),
+		buffer_(3 * 2 * srcWidth) {}
+
+	//same result as preProcessCorners() for the kernel at (x, y), for 1 <= x < srcWidth - 2 and 1 <= y < srcHeight - 2
+	FORCE_INLINE
+	BlendResult preProcessCorners(const Kernel_4x4& ker, int x, int y)
+	{
+		if (cornersNeedNoBlend(ker))
+			return BlendResult();
+
+		const double* downAbove = down(y - 1);
+		const double* downCenter = down(y);
+		const double* downBelow = down(y + 1);
+		const double* upAbove = up(y - 1);
+		const double* upCenter = up(y);
+		const double* upBelow = up(y + 1);
+
+		//same terms in the same order as preProcessCorners(), so the sums round the same way
+		const int weight = diagonalWeight;
+		double jg = upCenter[x - 1] + upAbove[x] + upBelow[x] + upCenter[x + 1] + weight * upCenter[x];
+		double fk = downCenter[x - 1] + downBelow[x] + downAbove[x] + downCenter[x + 1] + weight * downCenter[x];
+
+		return blendCorners(ker, cfg_, jg, fk);
+	}
+
+private:
+	const double* down(int y) { return row(y); }
+	const double* up  (int y) { return row(y) + srcWidth_; }
+
+	const double* row(int y)
+	{
+		const int slot = y % 3;
+		double* out = &buffer_[slot * 2 * srcWidth_];
+		if (rowY_[slot] != y)
+		{
+			const uint32_t* s_0  = src_ + srcWidth_ * y;
+			const uint32_t* s_p1 = s_0 + srcWidth_;
+			ColorDistance::distRow(s_0, s_p1 + 1, out, srcWidth_ - 1, cfg_.luminanceWeight);
+			ColorDistance::distRow(s_p1, s_0 + 1, out + srcWidth_, srcWidth_ - 1, cfg_.luminanceWeight);
+			rowY_[slot] = y;
+		}
+		return out;
+	}
+
+	const uint32_t* src_;
+	const int srcWidth_;
+	const xbrz::ScalerCfg& cfg_;
+	std::vector<double> buffer_;
+	int rowY_[3] = { -1, -1, -1 };
+};
+
 struct Kernel_3x3
 {
 	uint32_t
@@ -571,6 +626,8 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 	}
 	//------------------------------------------------------------------------------------
 
+	DiagonalDistances<ColorDistance> diagonals(src, srcWidth, cfg);
+
 	for (int y = yFirst; y < yLast; ++y)
 	{
 		uint32_t* out = trg + Scaler::scale * y * trgWidth; //consider MT "striped" access
@@ -582,6 +639,8 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 
 		unsigned char blend_xy1 = 0; //corner blending for current (x, y + 1) position
 
+		const bool innerRow = y >= 1 && y + 2 < srcHeight;
+
 		for (int x = 0; x < srcWidth; ++x, out += Scaler::scale)
 		{
 #ifdef _DEBUG
@@ -617,7 +676,9 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 			//evaluate the four corners on bottom-right of current pixel
 			unsigned char blend_xy = 0; //for current (x, y) position
 			{
-				const BlendResult res = preProcessCorners<ColorDistance>(ker4, cfg);
+				const BlendResult res = innerRow && x >= 1 && x + 2 < srcWidth ?
+					diagonals.preProcessCorners(ker4, x, y) :
+					preProcessCorners<ColorDistance>(ker4, cfg);
 				/*
 				preprocessing blend result:
 				---------
@@ -1035,12 +1096,19 @@ struct ColorDistanceRGB
 {
 	static double dist(uint32_t pix1, uint32_t pix2, double luminanceWeight)
 	{
-		return DistYCbCrBuffer::dist(pix1, pix2);
+		return distYCbCrRounded(pix1, pix2);
 
 		//if (pix1 == pix2) //about 4% perf boost
 		//	return 0;
 		//return distYCbCr(pix1, pix2, luminanceWeight);
 	}
+
+	//out[x] = dist(pix1[x], pix2[x])
+	static void distRow(const uint32_t* pix1, const uint32_t* pix2, double* out, int count, double luminanceWeight)
+	{
+		for (int x = 0; x < count; ++x)
+			out[x] = dist(pix1[x], pix2[x], luminanceWeight);
+	}
 };
 
 struct ColorDistanceARGB
@@ -1057,15 +1125,70 @@ struct ColorDistanceARGB
 			3. if a1 = 1,  ??? maybe: 255 * (1 - a2) + a2 * distYCbCr()
 		*/
 
-		//return std::min(a1, a2) * DistYCbCrBuffer::dist(pix1, pix2) + 255 * abs(a1 - a2);
+		//return std::min(a1, a2) * distYCbCrRounded(pix1, pix2) + 255 * abs(a1 - a2);
 		//=> following code is 15% faster:
-		const double d = DistYCbCrBuffer::dist(pix1, pix2);
+		const double d = distYCbCrRounded(pix1, pix2);
 		if (a1 < a2)
 			return a1 * d + 255 * (a2 - a1);
 		else
 			return a2 * d + 255 * (a1 - a2);
 
-		//alternative? return std::sqrt(a1 * a2 * square(DistYCbCrBuffer::dist(pix1, pix2)) + square(255 * (a1 - a2)));
+		//alternative? return std::sqrt(a1 * a2 * square(distYCbCrRounded(pix1, pix2)) + square(255 * (a1 - a2)));
+	}
+
+	//out[x] = dist(pix1[x], pix2[x])
+	static void distRow(const uint32_t* pix1, const uint32_t* pix2, double* out, int count, double luminanceWeight)
+	{
+		int x = 0;
+#ifdef XBRZ_SSE2
+		//distYCbCrRounded() two at a time, with the same double math in the same order, so the results match exactly
+		const double k_b = 0.0593; //ITU-R BT.2020 conversion
+		const double k_r = 0.2627; //
+		const double k_g = 1 - k_b - k_r;
+
+		const double scale_b = 0.5 / (1 - k_b);
+		const double scale_r = 0.5 / (1 - k_r);
+
+		const __m128i zero = _mm_setzero_si128();
+		for (; x + 2 <= count; x += 2)
+		{
+			const __m128i p1 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pix1 + x)), zero);
+			const __m128i p2 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pix2 + x)), zero);
+
+			//(diff + 255) / 2 * 2 - 255
+			__m128i diff = _mm_srai_epi16(_mm_add_epi16(_mm_sub_epi16(p1, p2), _mm_set1_epi16(255)), 1);
+			diff = _mm_sub_epi16(_mm_add_epi16(diff, diff), _mm_set1_epi16(255));
+
+			//r0 r1 g0 g1 and b0 b1 a0 a1, as 32 bit
+			const __m128i diff0 = _mm_srai_epi32(_mm_unpacklo_epi16(diff, diff), 16);
+			const __m128i diff1 = _mm_srai_epi32(_mm_unpackhi_epi16(diff, diff), 16);
+			const __m128i rg = _mm_unpacklo_epi32(diff0, diff1);
+			const __m128i ba = _mm_unpackhi_epi32(diff0, diff1);
+
+			const __m128d r_diff = _mm_cvtepi32_pd(rg);
+			const __m128d g_diff = _mm_cvtepi32_pd(_mm_shuffle_epi32(rg, _MM_SHUFFLE(3, 2, 3, 2)));
+			const __m128d b_diff = _mm_cvtepi32_pd(ba);
+
+			const __m128d y   = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(k_r), r_diff), _mm_mul_pd(_mm_set1_pd(k_g), g_diff)), _mm_mul_pd(_mm_set1_pd(k_b), b_diff));
+			const __m128d c_b = _mm_mul_pd(_mm_set1_pd(scale_b), _mm_sub_pd(b_diff, y));
+			const __m128d c_r = _mm_mul_pd(_mm_set1_pd(scale_r), _mm_sub_pd(r_diff, y));
+			const __m128d len = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(y, y), _mm_mul_pd(c_b, c_b)), _mm_mul_pd(c_r, c_r)));
+			const __m128d d = _mm_cvtps_pd(_mm_cvtpd_ps(len)); //rounded to float, too
+
+			//b0 b1 a0 a1 of both pixels, as 32 bit
+			const __m128i ba1 = _mm_unpackhi_epi32(_mm_unpacklo_epi16(p1, zero), _mm_unpackhi_epi16(p1, zero));
+			const __m128i ba2 = _mm_unpackhi_epi32(_mm_unpacklo_epi16(p2, zero), _mm_unpackhi_epi16(p2, zero));
+			const __m128d a1 = _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(ba1, _MM_SHUFFLE(3, 2, 3, 2))), _mm_set1_pd(255.0));
+			const __m128d a2 = _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(ba2, _MM_SHUFFLE(3, 2, 3, 2))), _mm_set1_pd(255.0));
+
+			const __m128d less = _mm_cmplt_pd(a1, a2);
+			const __m128d dist1 = _mm_add_pd(_mm_mul_pd(a1, d), _mm_mul_pd(_mm_set1_pd(255), _mm_sub_pd(a2, a1)));
+			const __m128d dist2 = _mm_add_pd(_mm_mul_pd(a2, d), _mm_mul_pd(_mm_set1_pd(255), _mm_sub_pd(a1, a2)));
+			_mm_storeu_pd(out + x, _mm_or_pd(_mm_and_pd(less, dist1), _mm_andnot_pd(less, dist2)));
+		}
+#endif
+		for (; x < count; ++x)
+			out[x] = dist(pix1[x], pix2[x], luminanceWeight);
 	}
 };
 
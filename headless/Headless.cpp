@@ -24,6 +24,7 @@
 #include "Core/CoreTiming.h"
 #include "Core/System.h"
 #include "Core/HLE/sceUtility.h"
+#include "Core/MIPS/JitCommon/JitState.h"
 #include "Core/Host.h"
 #include "Core/SaveState.h"
 #include "GPU/Common/FramebufferManagerCommon.h"
@@ -121,10 +122,13 @@ int printUsage(const char *progname, const char *reason)
 	}
 #endif
 	fprintf(stderr, "  --timeout=SECONDS     abort test it if takes longer than SECONDS\n");
+	fprintf(stderr, "  --bench               print how long each test took to run\n");
 
 	fprintf(stderr, "  -v, --verbose         show the full passed/failed result\n");
 	fprintf(stderr, "  -i                    use the interpreter\n");
 	fprintf(stderr, "  --ir                  use ir interpreter\n");
+	fprintf(stderr, "  --ir=MODE             use ir interpreter with a specific dispatch mode\n");
+	fprintf(stderr, "                        options: native (default), threaded, switch\n");
 	fprintf(stderr, "  -j                    use jit (default)\n");
 	fprintf(stderr, "  -c, --compare         compare with output in file.expected\n");
 	fprintf(stderr, "\nSee headless.txt for details.\n");
@@ -146,7 +150,7 @@ static HeadlessHost *getHost(GPUCore gpuCore) {
 	}
 }
 
-bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, bool autoCompare, bool verbose, double timeout)
+bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, bool autoCompare, bool verbose, double timeout, bool bench)
 {
 	if (teamCityMode) {
 		// Kinda ugly, trying to guesstimate the test name from filename...
@@ -184,6 +188,7 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, bool
 	if (coreParameter.graphicsContext && coreParameter.graphicsContext->GetDrawContext())
 		coreParameter.graphicsContext->GetDrawContext()->BeginFrame();
 
+	double startTime = time_now_d();
 	coreState = CORE_RUNNING;
 	while (coreState == CORE_RUNNING)
 	{
@@ -207,6 +212,9 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, bool
 	}
 	PSP_EndHostFrame();
 
+	if (bench)
+		fprintf(stderr, "%s: %0.3f seconds\n", coreParameter.fileToStart.c_str(), time_now_d() - startTime);
+
 	if (coreParameter.graphicsContext && coreParameter.graphicsContext->GetDrawContext())
 		coreParameter.graphicsContext->GetDrawContext()->EndFrame();
 
@@ -242,6 +250,8 @@ int main(int argc, const char* argv[])
 	const char *stateToLoad = 0;
 	GPUCore gpuCore = GPUCORE_NULL;
 	CPUCore cpuCore = CPUCore::JIT;
+	uint32_t jitDisableFlags = 0;
+	bool bench = false;
 
 	std::vector<std::string> testFilenames;
 	const char *mountIso = 0;
@@ -271,6 +281,21 @@ int main(int argc, const char* argv[])
 			cpuCore = CPUCore::JIT;
 		else if (!strcmp(argv[i], "--ir"))
 			cpuCore = CPUCore::IR_JIT;
+		else if (!strncmp(argv[i], "--ir=", strlen("--ir=")))
+		{
+			const char *irMode = argv[i] + strlen("--ir=");
+			cpuCore = CPUCore::IR_JIT;
+			if (!strcmp(irMode, "native"))
+				jitDisableFlags = 0;
+			else if (!strcmp(irMode, "threaded"))
+				jitDisableFlags = (uint32_t)MIPSComp::JitDisable::IR_NATIVE;
+			else if (!strcmp(irMode, "switch"))
+				jitDisableFlags = (uint32_t)MIPSComp::JitDisable::IR_NATIVE | (uint32_t)MIPSComp::JitDisable::IR_THREADED;
+			else
+				return printUsage(argv[0], "Unknown ir mode specified after --ir=. Allowed: native, threaded, switch.");
+		}
+		else if (!strcmp(argv[i], "--bench"))
+			bench = true;
 		else if (!strcmp(argv[i], "-c") || !strcmp(argv[i], "--compare"))
 			autoCompare = true;
 		else if (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"))
@@ -398,6 +423,7 @@ int main(int argc, const char* argv[])
 	g_Config.sMACAddress = "12:34:56:78:9A:BC";
 	g_Config.iFirmwareVersion = PSP_DEFAULT_FIRMWARE;
 	g_Config.iPSPModel = PSP_MODEL_SLIM;
+	g_Config.uJitDisableFlags = jitDisableFlags;
 
 #ifdef _WIN32
 	g_Config.internalDataDirectory = "";
@@ -442,7 +468,7 @@ int main(int argc, const char* argv[])
 		coreParameter.fileToStart = testFilenames[i];
 		if (autoCompare)
 			printf("%s:\n", coreParameter.fileToStart.c_str());
-		bool passed = RunAutoTest(headlessHost, coreParameter, autoCompare, verbose, timeout);
+		bool passed = RunAutoTest(headlessHost, coreParameter, autoCompare, verbose, timeout, bench);
 		if (autoCompare)
 		{
 			std::string testName = GetTestName(coreParameter.fileToStart);
@@ -0,0 +1,304 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstdio>
+#include <cstring>
+
+#include "Core/MemMap.h"
+#include "unittest/IRTestBlocks.h"
+
+// Few enough that values get reused, and more than the backend has host regs for.
+static const u8 gprs[] = { MIPS_REG_ZERO, 1, 2, 3, 4, 5, 6, 7, MIPS_REG_RA, IRTEMP_0, IRTEMP_1 };
+static const int NUM_FPRS = 8;
+
+static const float interestingFloats[] = { 0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 3.0f, 1e30f, -1e-30f, 65536.0f, 1e-40f };
+
+static u8 RandomGPR(TestRandom &rng) {
+	return gprs[rng.Range(0, (int)ARRAY_SIZE(gprs) - 1)];
+}
+
+static u8 RandomDestGPR(TestRandom &rng) {
+	return gprs[rng.Range(1, (int)ARRAY_SIZE(gprs) - 1)];
+}
+
+static u8 RandomFPR(TestRandom &rng) {
+	return (u8)rng.Range(0, NUM_FPRS - 1);
+}
+
+static u32 RandomConstant(TestRandom &rng) {
+	switch (rng.Range(0, 3)) {
+	case 0: return (u32)rng.Range(-16, 16);
+	case 1: return 0x80000000 >> rng.Range(0, 31);
+	default: return rng.Next() ^ (rng.Next() << 16);
+	}
+}
+
+static u32 RandomFloatBits(TestRandom &rng) {
+	if (rng.Range(0, 1)) {
+		float f = interestingFloats[rng.Range(0, (int)ARRAY_SIZE(interestingFloats) - 1)];
+		u32 bits;
+		memcpy(&bits, &f, 4);
+		return bits;
+	}
+	return rng.Next() ^ (rng.Next() << 16);
+}
+
+// Offset from MEM_REG, aligned to the access size.
+static u32 RandomMemOffset(TestRandom &rng, int size) {
+	return (u32)(rng.Range(-0x100, 0x100) & ~(size - 1));
+}
+
+static void AddRandomInst(IRTestBlock &block, TestRandom &rng) {
+	static const IROp binaryOps[] = {
+		IROp::Add, IROp::Sub, IROp::And, IROp::Or, IROp::Xor,
+		IROp::Shl, IROp::Shr, IROp::Sar, IROp::Ror,
+		IROp::Slt, IROp::SltU, IROp::MovZ, IROp::MovNZ, IROp::Max, IROp::Min,
+	};
+	static const IROp constOps[] = {
+		IROp::AddConst, IROp::SubConst, IROp::AndConst, IROp::OrConst, IROp::XorConst, IROp::SltConst, IROp::SltUConst,
+	};
+	static const IROp shiftImmOps[] = { IROp::ShlImm, IROp::ShrImm, IROp::SarImm, IROp::RorImm };
+	static const IROp unaryOps[] = {
+		IROp::Mov, IROp::Neg, IROp::Not, IROp::Clz, IROp::BSwap16, IROp::BSwap32, IROp::Ext8to32, IROp::Ext16to32, IROp::ReverseBits,
+	};
+	static const IROp multOps[] = { IROp::Mult, IROp::MultU, IROp::Madd, IROp::MaddU, IROp::Msub, IROp::MsubU, IROp::Div, IROp::DivU };
+	static const IROp loadOps[] = { IROp::Load8, IROp::Load8Ext, IROp::Load16, IROp::Load16Ext, IROp::Load32 };
+	static const int loadSizes[] = { 1, 1, 2, 2, 4 };
+	static const IROp storeOps[] = { IROp::Store8, IROp::Store16, IROp::Store32 };
+	static const int storeSizes[] = { 1, 2, 4 };
+	static const IROp fpuBinaryOps[] = { IROp::FAdd, IROp::FSub, IROp::FDiv, IROp::FMul, IROp::FMin, IROp::FMax };
+	static const IROp fpuUnaryOps[] = { IROp::FMov, IROp::FNeg, IROp::FAbs, IROp::FSqrt, IROp::FCvtSW };
+	static const IROp exitOps[] = {
+		IROp::ExitToConstIfEq, IROp::ExitToConstIfNeq, IROp::ExitToConstIfGtZ,
+		IROp::ExitToConstIfGeZ, IROp::ExitToConstIfLtZ, IROp::ExitToConstIfLeZ,
+	};
+
+	int pick;
+	switch (rng.Range(0, 18)) {
+	case 0:
+		block.Add(IROp::SetConst, RandomDestGPR(rng), 0, 0, RandomConstant(rng));
+		break;
+	case 1:
+	case 2:
+	case 3:
+		block.Add(binaryOps[rng.Range(0, (int)ARRAY_SIZE(binaryOps) - 1)], RandomDestGPR(rng), RandomGPR(rng), RandomGPR(rng));
+		break;
+	case 4:
+		block.Add(constOps[rng.Range(0, (int)ARRAY_SIZE(constOps) - 1)], RandomDestGPR(rng), RandomGPR(rng), 0, RandomConstant(rng));
+		break;
+	case 5:
+		block.Add(shiftImmOps[rng.Range(0, (int)ARRAY_SIZE(shiftImmOps) - 1)], RandomDestGPR(rng), RandomGPR(rng), (u8)rng.Range(0, 31));
+		break;
+	case 6:
+		block.Add(unaryOps[rng.Range(0, (int)ARRAY_SIZE(unaryOps) - 1)], RandomDestGPR(rng), RandomGPR(rng), 0);
+		break;
+	case 7:
+		block.Add(multOps[rng.Range(0, (int)ARRAY_SIZE(multOps) - 1)], 0, RandomGPR(rng), RandomGPR(rng));
+		break;
+	case 8:
+		pick = rng.Range(0, 3);
+		if (pick == 0)
+			block.Add(IROp::MtLo, 0, RandomGPR(rng), 0);
+		else if (pick == 1)
+			block.Add(IROp::MtHi, 0, RandomGPR(rng), 0);
+		else
+			block.Add(pick == 2 ? IROp::MfLo : IROp::MfHi, RandomDestGPR(rng), 0, 0);
+		break;
+	case 9:
+		pick = rng.Range(0, (int)ARRAY_SIZE(loadOps) - 1);
+		block.Add(loadOps[pick], RandomDestGPR(rng), MEM_REG, 0, RandomMemOffset(rng, loadSizes[pick]));
+		break;
+	case 10:
+		pick = rng.Range(0, (int)ARRAY_SIZE(storeOps) - 1);
+		block.Add(storeOps[pick], RandomGPR(rng), MEM_REG, 0, RandomMemOffset(rng, storeSizes[pick]));
+		break;
+	case 11:
+		// These are unaligned by nature, and stay interpreted.
+		pick = rng.Range(0, 5);
+		if (pick == 0)
+			block.Add(IROp::LoadFloat, RandomFPR(rng), MEM_REG, 0, RandomMemOffset(rng, 4));
+		else if (pick == 1)
+			block.Add(IROp::StoreFloat, RandomFPR(rng), MEM_REG, 0, RandomMemOffset(rng, 4));
+		else if (pick == 2)
+			block.Add(IROp::Load32Left, RandomDestGPR(rng), MEM_REG, 0, RandomMemOffset(rng, 1));
+		else if (pick == 3)
+			block.Add(IROp::Load32Right, RandomDestGPR(rng), MEM_REG, 0, RandomMemOffset(rng, 1));
+		else if (pick == 4)
+			block.Add(IROp::Store32Left, RandomGPR(rng), MEM_REG, 0, RandomMemOffset(rng, 1));
+		else
+			block.Add(IROp::Store32Right, RandomGPR(rng), MEM_REG, 0, RandomMemOffset(rng, 1));
+		break;
+	case 12:
+		block.Add(fpuBinaryOps[rng.Range(0, (int)ARRAY_SIZE(fpuBinaryOps) - 1)], RandomFPR(rng), RandomFPR(rng), RandomFPR(rng));
+		break;
+	case 13:
+		pick = rng.Range(0, 3);
+		if (pick == 0)
+			block.Add(IROp::SetConstF, RandomFPR(rng), 0, 0, RandomFloatBits(rng));
+		else if (pick == 1)
+			block.Add(IROp::FMovFromGPR, RandomFPR(rng), RandomGPR(rng), 0);
+		else if (pick == 2)
+			block.Add(IROp::FMovToGPR, RandomDestGPR(rng), RandomFPR(rng), 0);
+		else
+			block.Add(fpuUnaryOps[rng.Range(0, (int)ARRAY_SIZE(fpuUnaryOps) - 1)], RandomFPR(rng), RandomFPR(rng), 0);
+		break;
+	case 14:
+		pick = rng.Range(0, 3);
+		if (pick == 0)
+			block.Add(IROp::FCmp, (u8)rng.Range(IRFpCompareMode::False, IRFpCompareMode::LessEqualUnordered), RandomFPR(rng), RandomFPR(rng));
+		else if (pick == 1)
+			block.Add(IROp::FpCondToReg, RandomDestGPR(rng), 0, 0);
+		else if (pick == 2)
+			block.Add(IROp::ZeroFpCond, 0, 0, 0);
+		else
+			block.Add(IROp::Vec4Add, (u8)(rng.Range(0, 1) * 4), (u8)(rng.Range(0, 1) * 4), (u8)(rng.Range(0, 1) * 4));
+		break;
+	case 15:
+		pick = rng.Range(0, 3);
+		if (pick == 0)
+			block.Add(IROp::VfpuCtrlToReg, RandomDestGPR(rng), (u8)rng.Range(0, 15), 0);
+		else if (pick == 1)
+			block.Add(IROp::SetCtrlVFPU, (u8)rng.Range(0, 15), 0, 0, RandomConstant(rng));
+		else if (pick == 2)
+			block.Add(IROp::SetCtrlVFPUReg, (u8)rng.Range(0, 15), RandomGPR(rng), 0);
+		else
+			block.Add(IROp::SetCtrlVFPUFReg, (u8)rng.Range(0, 15), RandomFPR(rng), 0);
+		break;
+	case 16:
+		pick = rng.Range(0, 2);
+		if (pick == 0)
+			block.Add(IROp::Downcount, 0, 0, 0, (u32)rng.Range(1, 200));
+		else if (pick == 1)
+			block.Add(IROp::SetPC, 0, RandomGPR(rng), 0);
+		else
+			block.Add(IROp::SetPCConst, 0, 0, 0, block.NextExitPC());
+		break;
+	default:
+		// Rarely taken with random values, unless comparing a reg with itself.
+		pick = rng.Range(0, (int)ARRAY_SIZE(exitOps) - 1);
+		block.Add(exitOps[pick], 0, RandomGPR(rng), pick < 2 ? RandomGPR(rng) : 0, block.NextExitPC());
+		break;
+	}
+}
+
+void GenerateBlock(IRTestBlock &block, TestRandom &rng) {
+	block.insts.clear();
+	block.exits = 0;
+
+	int count = rng.Range(1, 40);
+	for (int i = 0; i < count; ++i)
+		AddRandomInst(block, rng);
+
+	switch (rng.Range(0, 2)) {
+	case 0: block.Add(IROp::ExitToConst, 0, 0, 0, block.NextExitPC()); break;
+	case 1: block.Add(IROp::ExitToReg, 0, RandomGPR(rng), 0); break;
+	default: block.Add(IROp::ExitToPC, 0, 0, 0); break;
+	}
+}
+
+void IRTestState::Randomize(TestRandom &rng) {
+	for (int i = 0; i < 32; ++i) {
+		r[i] = RandomConstant(rng);
+		fi[i] = RandomFloatBits(rng);
+	}
+	r[MIPS_REG_ZERO] = 0;
+	r[MEM_REG] = MEM_REG_VALUE;
+	for (int i = 0; i < 16; ++i) {
+		t[i] = RandomConstant(rng);
+		vfpuCtrl[i] = rng.Next();
+	}
+	pc = 0x08804000 - 4;
+	lo = rng.Next();
+	hi = rng.Next();
+	fcr31 = 0;
+	fpcond = rng.Range(0, 1);
+	downcount = rng.Range(0, 1000);
+	exitPC = 0;
+	memory.resize(MEM_SIZE);
+	rng.Fill(memory.data(), MEM_SIZE);
+}
+
+void IRTestState::Apply(MIPSState *mips) const {
+	memcpy(mips->r, r, sizeof(r));
+	memcpy(mips->fi, fi, sizeof(fi));
+	memcpy(mips->t, t, sizeof(t));
+	memcpy(mips->vfpuCtrl, vfpuCtrl, sizeof(vfpuCtrl));
+	mips->pc = pc;
+	mips->lo = lo;
+	mips->hi = hi;
+	mips->fcr31 = fcr31;
+	mips->fpcond = fpcond;
+	mips->downcount = downcount;
+	memcpy(Memory::base, memory.data(), MEM_SIZE);
+}
+
+void IRTestState::Capture(const MIPSState *mips, u32 newPC) {
+	memcpy(r, mips->r, sizeof(r));
+	memcpy(fi, mips->fi, sizeof(fi));
+	memcpy(t, mips->t, sizeof(t));
+	memcpy(vfpuCtrl, mips->vfpuCtrl, sizeof(vfpuCtrl));
+	pc = mips->pc;
+	lo = mips->lo;
+	hi = mips->hi;
+	fcr31 = mips->fcr31;
+	fpcond = mips->fpcond;
+	downcount = mips->downcount;
+	exitPC = newPC;
+	memory.assign(Memory::base, Memory::base + MEM_SIZE);
+}
+
+#define COMPARE_STATE(name, a, b) \
+	if ((a) != (b)) { \
+		printf("%s: %s is %08x, expected %08x\n", test, name, (u32)(b), (u32)(a)); \
+		return false; \
+	}
+
+bool CompareStates(const char *test, const IRTestState &expected, const IRTestState &actual) {
+	char name[32];
+	for (int i = 0; i < 32; ++i) {
+		snprintf(name, sizeof(name), "r%d", i);
+		COMPARE_STATE(name, expected.r[i], actual.r[i]);
+		snprintf(name, sizeof(name), "f%d", i);
+		COMPARE_STATE(name, expected.fi[i], actual.fi[i]);
+	}
+	for (int i = 0; i < 16; ++i) {
+		snprintf(name, sizeof(name), "t%d", i);
+		COMPARE_STATE(name, expected.t[i], actual.t[i]);
+		snprintf(name, sizeof(name), "vfpuCtrl[%d]", i);
+		COMPARE_STATE(name, expected.vfpuCtrl[i], actual.vfpuCtrl[i]);
+	}
+	COMPARE_STATE("pc", expected.pc, actual.pc);
+	COMPARE_STATE("lo", expected.lo, actual.lo);
+	COMPARE_STATE("hi", expected.hi, actual.hi);
+	COMPARE_STATE("fcr31", expected.fcr31, actual.fcr31);
+	COMPARE_STATE("fpcond", expected.fpcond, actual.fpcond);
+	COMPARE_STATE("downcount", expected.downcount, actual.downcount);
+	COMPARE_STATE("exit pc", expected.exitPC, actual.exitPC);
+	for (u32 i = 0; i < MEM_SIZE; ++i) {
+		snprintf(name, sizeof(name), "memory[%04x]", i);
+		COMPARE_STATE(name, expected.memory[i], actual.memory[i]);
+	}
+	return true;
+}
+
+void PrintBlock(const IRTestBlock &block) {
+	char buf[256];
+	for (const IRInst &inst : block.insts) {
+		DisassembleIR(buf, sizeof(buf), inst);
+		printf("  %s\n", buf);
+	}
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/MIPS/MIPS.h"
+#include "Core/MIPS/IR/IRInst.h"
+#include "unittest/UnitTest.h"
+
+// Random IR blocks, and the state to run them from, for comparing ways of running IR.
+// Memory::base has to point at MEM_SIZE bytes of scratch memory while they run.
+
+// Loads and stores go through this, relative to the scratch memory.
+static const u8 MEM_REG = MIPS_REG_SP;
+static const u32 MEM_SIZE = 0x4000;
+static const u32 MEM_REG_VALUE = 0x2000;
+
+struct IRTestBlock {
+	std::vector<IRInst> insts;
+	int exits = 0;
+
+	void Add(IROp op, u8 dest, u8 src1, u8 src2, u32 constant = 0) {
+		IRInst inst;
+		inst.op = op;
+		inst.dest = dest;
+		inst.src1 = src1;
+		inst.src2 = src2;
+		inst.constant = constant;
+		insts.push_back(inst);
+	}
+
+	// Each exit gets its own PC, so we can tell which one was taken.
+	u32 NextExitPC() {
+		return 0x08804000 + 4 * exits++;
+	}
+};
+
+struct IRTestState {
+	u32 r[32];
+	u32 fi[32];
+	u32 t[16];
+	u32 vfpuCtrl[16];
+	u32 pc;
+	u32 lo;
+	u32 hi;
+	u32 fcr31;
+	u32 fpcond;
+	int downcount;
+	u32 exitPC;
+	std::vector<u8> memory;
+
+	void Randomize(TestRandom &rng);
+	void Apply(MIPSState *mips) const;
+	void Capture(const MIPSState *mips, u32 newPC);
+};
+
+void GenerateBlock(IRTestBlock &block, TestRandom &rng);
+// Prints what differs, prefixed by test, and returns false if anything does.
+bool CompareStates(const char *test, const IRTestState &expected, const IRTestState &actual);
+void PrintBlock(const IRTestBlock &block);
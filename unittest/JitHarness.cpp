@@ -16,15 +16,21 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include "ppsspp_config.h"
 
 #include "Common/System/NativeApp.h"
 #include "Common/System/System.h"
 #include "Common/TimeUtil.h"
+#include "Common/StringUtils.h"
+#include "Core/Config.h"
 #include "Core/ConfigValues.h"
 #include "Core/MIPS/JitCommon/JitCommon.h"
 #include "Core/MIPS/JitCommon/JitBlockCache.h"
+#include "Core/MIPS/JitCommon/JitState.h"
 #include "Core/MIPS/MIPSCodeUtils.h"
 #include "Core/MIPS/MIPSDebugInterface.h"
 #include "Core/MIPS/MIPSAsm.h"
@@ -33,6 +39,8 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/HLE.h"
+#include "unittest/JitHarness.h"
+#include "unittest/UnitTest.h"
 
 // Temporary hacks around annoying linking errors.  Copied from Headless.
 void NativeUpdate() { }
@@ -198,3 +206,117 @@ bool TestJit() {
 
 	return jit_speed >= interp_speed;
 }
+
+struct IRTraceRun {
+	u32 r[32];
+	u32 lo;
+	u32 hi;
+	std::vector<u8> data;
+	int numTraces;
+};
+
+static const u32 TRACE_LOOP_COUNT = 3000;
+
+// Runs a loop that's a single block on the IR jit, long enough for it to get hot and be traced.
+static bool RunIRTraceLoop(u32 disableFlags, IRTraceRun &run) {
+	SetupJitHarness();
+
+	const u32 base = PSP_GetUserMemoryBase();
+	const u32 dataAddr = base + 0x00100000;
+	const u32 loopAddr = base + 12;
+	const std::string lines[] = {
+		StringFromFormat("addiu r1, zero, %d", TRACE_LOOP_COUNT),
+		"addiu r2, zero, 0",
+		StringFromFormat("lui r4, 0x%04x", dataAddr >> 16),
+		// loopAddr
+		"addu r2, r2, r1",
+		"xor r3, r3, r2",
+		"sw r2, 0(r4)",
+		"addiu r4, r4, 4",
+		"addiu r1, r1, -1",
+		StringFromFormat("bne r1, zero, 0x%08x", loopAddr),
+		"sll r3, r3, 1",
+	};
+
+	bool success = true;
+	u32 addr = base;
+	for (const std::string &line : lines) {
+		if (!MIPSAsm::MipsAssembleOpcode(line.c_str(), currentDebugMIPS, addr)) {
+			printf("ERROR: %ls\n", MIPSAsm::GetAssembleError().c_str());
+			success = false;
+		}
+		addr += 4;
+	}
+	Memory::Write_U32(MIPS_MAKE_SYSCALL("UnitTestFakeSyscalls", "UnitTestTerminator"), addr);
+	Memory::Write_U32(MIPS_MAKE_BREAK(1), addr + 4);
+
+	if (success) {
+		const u32 oldFlags = g_Config.uJitDisableFlags;
+		g_Config.uJitDisableFlags = disableFlags;
+		mipsr4k.UpdateCore(CPUCore::IR_JIT);
+		g_Config.uJitDisableFlags = oldFlags;
+
+		currentMIPS->pc = base;
+		coreState = CORE_RUNNING;
+		while (coreState == CORE_RUNNING)
+			mipsr4k.RunLoopUntil(1000000);
+
+		memcpy(run.r, currentMIPS->r, sizeof(run.r));
+		run.lo = currentMIPS->lo;
+		run.hi = currentMIPS->hi;
+		const u8 *data = Memory::GetPointer(dataAddr);
+		run.data.assign(data, data + TRACE_LOOP_COUNT * 4);
+
+		BlockCacheStats stats;
+		MIPSComp::jit->GetBlockCacheDebugInterface()->ComputeStats(stats);
+		run.numTraces = stats.numTraces;
+	}
+
+	DestroyJitHarness();
+	return success;
+}
+
+static bool CompareIRTraceRuns(const char *name, const IRTraceRun &expected, const IRTraceRun &actual) {
+	for (int i = 0; i < 32; ++i) {
+		if (expected.r[i] != actual.r[i]) {
+			printf("IRTraces %s: r%d is %08x, expected %08x\n", name, i, actual.r[i], expected.r[i]);
+			return false;
+		}
+	}
+	if (expected.lo != actual.lo || expected.hi != actual.hi) {
+		printf("IRTraces %s: lo/hi differ\n", name);
+		return false;
+	}
+	if (expected.data != actual.data) {
+		printf("IRTraces %s: stored values differ\n", name);
+		return false;
+	}
+	return true;
+}
+
+bool TestIRTraces() {
+	IRTraceRun untraced;
+	RET(RunIRTraceLoop((u32)MIPSComp::JitDisable::IR_TRACES, untraced));
+	EXPECT_EQ_INT(untraced.numTraces, 0);
+	EXPECT_EQ_INT(untraced.r[1], 0);
+
+	// With each way of running IR, since a trace is just another block to them.
+	static const struct {
+		const char *name;
+		u32 disableFlags;
+	} modes[] = {
+		{ "default", 0 },
+		{ "threaded", (u32)MIPSComp::JitDisable::IR_NATIVE },
+		{ "interpreted", (u32)MIPSComp::JitDisable::IR_NATIVE | (u32)MIPSComp::JitDisable::IR_THREADED },
+	};
+	for (const auto &mode : modes) {
+		IRTraceRun traced;
+		RET(RunIRTraceLoop(mode.disableFlags, traced));
+		if (traced.numTraces == 0) {
+			printf("IRTraces %s: the loop wasn't traced\n", mode.name);
+			return false;
+		}
+		RET(CompareIRTraceRuns(mode.name, untraced, traced));
+	}
+	return true;
+}
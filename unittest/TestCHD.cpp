@@ -0,0 +1,266 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/FileSystems/BlockDevices.h"
+#include "Core/Host.h"
+#include "Core/Loaders.h"
+#include "unittest/UnitTest.h"
+
+struct CHDFixture {
+	const char *name;
+	const u8 *data;
+	size_t size;
+	u32 unitBytes;
+	u32 framesPerHunk;
+	// Where the 2048 byte sector is in each frame.
+	u32 sectorOffset;
+	// The first frame of the data track.
+	u32 firstFrame;
+	// 0 if the image should be refused.
+	u32 numBlocks;
+	// The uncompressed hunk left out of data, which goes right after it.
+	u32 tailHunk;
+	// For each hunk, the hunk its data is really in.
+	const u8 *sources;
+	size_t numHunks;
+};
+
+// Regenerate with gen_chd_fixtures.py.
+#include "unittest/TestCHDImages.h"
+
+static const u32 SECTOR_SIZE = 2048;
+
+// Sector contents for the images, must match fill_sector() in gen_chd_fixtures.py.
+// Mostly repeats at various distances, so it compresses but still gives the decoders some work.
+static void FillSector(u32 seed, u8 *data) {
+	TestRandom rng(seed * 0x9E37 + 1);
+	u32 pos = 0;
+	while (pos < SECTOR_SIZE) {
+		const int kind = rng.Range(0, 15);
+		const u32 len = std::min((u32)rng.Range(4, 128), SECTOR_SIZE - pos);
+		const u32 dist = (u32)rng.Range(1, 300);
+		for (u32 i = 0; i < len; ++i, ++pos) {
+			if (kind == 0)
+				data[pos] = (u8)rng.Next();
+			else if (kind == 1 || pos < dist)
+				data[pos] = (u8)('a' + rng.Range(0, 7));
+			else
+				data[pos] = data[pos - dist];
+		}
+	}
+}
+
+class MemoryFileLoader : public FileLoader {
+public:
+	MemoryFileLoader(const std::vector<u8> &data) : data_(data) {}
+
+	bool Exists() override {
+		return true;
+	}
+	bool IsDirectory() override {
+		return false;
+	}
+	s64 FileSize() override {
+		return (s64)data_.size();
+	}
+	std::string Path() const override {
+		return "test.chd";
+	}
+	size_t ReadAt(s64 absolutePos, size_t bytes, size_t count, void *data, Flags flags = Flags::NONE) override {
+		if (absolutePos < 0 || (size_t)absolutePos >= data_.size() || bytes == 0)
+			return 0;
+		count = std::min(count, (data_.size() - (size_t)absolutePos) / bytes);
+		memcpy(data, &data_[(size_t)absolutePos], bytes * count);
+		return count;
+	}
+
+private:
+	std::vector<u8> data_;
+};
+
+// Counts read errors shown to the user.
+class CHDTestHost : public Host {
+public:
+	bool InitGraphics(std::string *error_string, GraphicsContext **ctx) override {
+		return false;
+	}
+	void ShutdownGraphics() override {}
+	void InitSound() override {}
+	void ShutdownSound() override {}
+	void NotifyUserMessage(const std::string &message, float duration, u32 color, const char *id) override {
+		messages++;
+	}
+
+	int messages = 0;
+};
+
+static std::vector<u8> FixtureImage(const CHDFixture &fixture) {
+	std::vector<u8> image(fixture.data, fixture.data + fixture.size);
+	std::vector<u8> tail(fixture.framesPerHunk * fixture.unitBytes);
+	for (u32 i = 0; i < fixture.framesPerHunk; ++i) {
+		const u32 frame = fixture.tailHunk * fixture.framesPerHunk + i;
+		if (frame >= fixture.firstFrame && frame < fixture.firstFrame + fixture.numBlocks)
+			FillSector(frame, &tail[i * fixture.unitBytes + fixture.sectorOffset]);
+	}
+	image.insert(image.end(), tail.begin(), tail.end());
+	return image;
+}
+
+static std::vector<u8> ExpectedSectors(const CHDFixture &fixture) {
+	std::vector<u8> sectors(fixture.numBlocks * SECTOR_SIZE);
+	for (u32 block = 0; block < fixture.numBlocks; ++block) {
+		const u32 frame = fixture.firstFrame + block;
+		const u32 source = fixture.sources[frame / fixture.framesPerHunk];
+		FillSector(source * fixture.framesPerHunk + frame % fixture.framesPerHunk, &sectors[block * SECTOR_SIZE]);
+	}
+	return sectors;
+}
+
+static bool TestCHDFixture(const CHDFixture &fixture, CHDTestHost &testHost) {
+	MemoryFileLoader loader(FixtureImage(fixture));
+	const std::vector<u8> expected = ExpectedSectors(fixture);
+	std::vector<u8> buffer(SECTOR_SIZE * (fixture.numBlocks + 2));
+
+	testHost.messages = 0;
+	CHDFileBlockDevice device(&loader);
+	EXPECT_EQ_INT(device.GetNumBlocks(), fixture.numBlocks);
+	if (fixture.numBlocks == 0) {
+		// Refused up front, rather than failing reads later.
+		EXPECT_FALSE(device.ReadBlock(0, buffer.data()));
+		EXPECT_EQ_INT(testHost.messages, 1);
+		return true;
+	}
+
+	// A block at a time uncached, then all at once, then a block at a time from the cache.
+	for (int pass = 0; pass < 2; ++pass) {
+		for (u32 block = 0; block < fixture.numBlocks; ++block) {
+			EXPECT_TRUE(device.ReadBlock(block, buffer.data(), pass == 0));
+			if (memcmp(buffer.data(), &expected[block * SECTOR_SIZE], SECTOR_SIZE) != 0) {
+				printf("CHD %s: block %d differs (pass %d)\n", fixture.name, block, pass);
+				return false;
+			}
+		}
+		if (pass == 0) {
+			EXPECT_TRUE(device.ReadBlocks(0, fixture.numBlocks, buffer.data()));
+			if (memcmp(buffer.data(), expected.data(), expected.size()) != 0) {
+				printf("CHD %s: blocks read together differ\n", fixture.name);
+				return false;
+			}
+		}
+	}
+
+	// Past the end is zeros.
+	memset(buffer.data(), 0xCC, buffer.size());
+	EXPECT_TRUE(device.ReadBlocks(fixture.numBlocks - 1, 3, buffer.data()));
+	EXPECT_TRUE(memcmp(buffer.data(), &expected[(fixture.numBlocks - 1) * SECTOR_SIZE], SECTOR_SIZE) == 0);
+	EXPECT_TRUE(std::all_of(buffer.begin() + SECTOR_SIZE, buffer.begin() + 3 * SECTOR_SIZE, [](u8 v) { return v == 0; }));
+	EXPECT_FALSE(device.ReadBlock(fixture.numBlocks, buffer.data()));
+	EXPECT_EQ_INT(testHost.messages, 0);
+	return true;
+}
+
+// Reads from several threads at once, with a fresh cache, so they race to decompress the same hunks.
+static bool TestCHDThreads(const CHDFixture &fixture) {
+	MemoryFileLoader loader(FixtureImage(fixture));
+	const std::vector<u8> expected = ExpectedSectors(fixture);
+	CHDFileBlockDevice device(&loader);
+
+	std::vector<int> failures(4);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < (int)failures.size(); ++t) {
+		threads.push_back(std::thread([&, t]() {
+			TestRandom rng(t + 1);
+			u8 buffer[SECTOR_SIZE * 3];
+			for (int i = 0; i < 200; ++i) {
+				const u32 block = rng.Range(0, fixture.numBlocks - 1);
+				const int count = std::min(rng.Range(1, 3), (int)(fixture.numBlocks - block));
+				if (!device.ReadBlocks(block, count, buffer) || memcmp(buffer, &expected[block * SECTOR_SIZE], count * SECTOR_SIZE) != 0)
+					failures[t]++;
+			}
+		}));
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+	for (int t = 0; t < (int)failures.size(); ++t) {
+		if (failures[t] != 0) {
+			printf("CHD %s: %d reads failed on thread %d\n", fixture.name, failures[t], t);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Damaged hunks have to fail (or read garbage), not crash.
+static bool TestCHDCorrupt(const CHDFixture &fixture) {
+	const std::vector<u8> image = FixtureImage(fixture);
+	TestRandom rng(0xC4D);
+	std::vector<u8> buffer(fixture.numBlocks * SECTOR_SIZE);
+	for (int i = 0; i < 300; ++i) {
+		std::vector<u8> damaged = image;
+		// Only the hunks, which start after the header and the map.
+		const int pos = rng.Range(512, (int)fixture.size - 1);
+		damaged[pos] ^= (u8)rng.Range(1, 255);
+		MemoryFileLoader loader(damaged);
+		CHDFileBlockDevice device(&loader);
+		EXPECT_EQ_INT(device.GetNumBlocks(), fixture.numBlocks);
+		device.ReadBlocks(0, fixture.numBlocks, buffer.data());
+	}
+	return true;
+}
+
+static void TimeCHD(const CHDFixture &fixture) {
+	MemoryFileLoader loader(FixtureImage(fixture));
+	CHDFileBlockDevice device(&loader);
+	std::vector<u8> buffer(SECTOR_SIZE);
+	u32 block = 0;
+	double rate = TimeWorkRate([&]() {
+		device.ReadBlock(block, buffer.data(), true);
+		block = (block + 1) % fixture.numBlocks;
+		return SECTOR_SIZE;
+	});
+	printf("CHD %s: %0.1f MB/s uncached\n", fixture.name, rate / (1024.0 * 1024.0));
+}
+
+static bool RunCHDTests(CHDTestHost &testHost) {
+	for (const CHDFixture &fixture : chdFixtures)
+		RET(TestCHDFixture(fixture, testHost));
+	RET(TestCHDThreads(chdFixtures[0]));
+	RET(TestCHDThreads(chdFixtures[2]));
+	RET(TestCHDCorrupt(chdFixtures[0]));
+	RET(TestCHDCorrupt(chdFixtures[3]));
+	TimeCHD(chdFixtures[0]);
+	TimeCHD(chdFixtures[2]);
+	return true;
+}
+
+bool TestCHD() {
+	// Read errors are reported through the host.
+	Host *oldHost = host;
+	CHDTestHost testHost;
+	host = &testHost;
+	bool result = RunCHDTests(testHost);
+	host = oldHost;
+	return result;
+}
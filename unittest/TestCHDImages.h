@@ -0,0 +1,361 @@
+// Generated by gen_chd_fixtures.py, do not edit.
+
+#pragma once
+
+static const u8 chdDVD[] = {
+	0x4d, 0x43, 0x6f, 0x6d, 0x70, 0x72, 0x48, 0x44, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x05, 0x6c, 0x7a, 0x6d, 0x61, 0x7a, 0x6c, 0x69, 0x62,
+	0x68, 0x75, 0x66, 0x66, 0x66, 0x6c, 0x61, 0x63, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7c,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0x06, 0xee, 0x10, 0x08, 0x01, 0x00, 0x44, 0x44, 0x44, 0x44,
+	0x44, 0x44, 0x44, 0x44, 0x01, 0x50, 0x24, 0x03, 0x12, 0x00, 0x00, 0x02, 0x48, 0x00, 0x00, 0x00, 0x03, 0x50, 0x00, 0x00, 0x0a, 0xd5, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x32, 0x1a, 0x08, 0xd3, 0xa0, 0x0d, 0xe1, 0x46, 0x93, 0x32, 0x52, 0xab, 0xab, 0xcf, 0x37, 0x93, 0x89, 0xd5, 0x98, 0xa7, 0xdb,
+	0xe3, 0xaa, 0x59, 0x16, 0x55, 0x38, 0x6a, 0xf0, 0x85, 0xa8, 0x90, 0x2a, 0x72, 0xf5, 0x70, 0x23, 0x53, 0x34, 0x49, 0x7a, 0x5d, 0xc2, 0x1e, 0x06,
+	0x8d, 0xc7, 0x22, 0x22, 0xf5, 0x68, 0x88, 0x29, 0x68, 0x52, 0xa6, 0x44, 0xeb, 0x7e, 0x18, 0xce, 0x17, 0xfe, 0xb7, 0xb5, 0x4a, 0xbc, 0x44, 0xed,
+	0xf6, 0xae, 0xdf, 0xae, 0x3f, 0xb2, 0x9d, 0x35, 0xcf, 0x72, 0x25, 0x6a, 0xf7, 0x6e, 0xaa, 0x1e, 0x94, 0xa6, 0x14, 0xca, 0x3e, 0xf3, 0x4a, 0x96,
+	0x9c, 0x0c, 0x55, 0xcc, 0x95, 0xbe, 0x65, 0xf8, 0xa3, 0xf5, 0xa9, 0xdb, 0xdd, 0x5e, 0xbe, 0xa3, 0x84, 0xa5, 0x91, 0x36, 0x53, 0xd8, 0x8d, 0xc0,
+	0x52, 0x25, 0x8d, 0xfa, 0x2d, 0x1c, 0x67, 0x9b, 0xca, 0xde, 0x21, 0x4a, 0x3f, 0x16, 0x8b, 0x78, 0x11, 0x03, 0xf1, 0xa9, 0xfa, 0x39, 0x53, 0x40,
+	0x0b, 0x54, 0xef, 0x97, 0x98, 0x33, 0x3e, 0xb6, 0xf2, 0xae, 0x05, 0x87, 0x19, 0xa4, 0x5e, 0x28, 0x6b, 0x98, 0xf7, 0xc8, 0xd4, 0xe6, 0xd1, 0x04,
+	0xc8, 0xbf, 0x0f, 0xf3, 0x9b, 0xef, 0x8b, 0x20, 0x5c, 0x4e, 0x37, 0x4f, 0xe1, 0x2d, 0xe6, 0x3a, 0x95, 0x2a, 0xb5, 0x49, 0x52, 0x67, 0x26, 0x48,
+	0xc6, 0x29, 0x59, 0xce, 0x1c, 0x1d, 0xa9, 0xde, 0x46, 0xa8, 0x7d, 0xb5, 0x5b, 0xe9, 0x41, 0xf6, 0xea, 0xf6, 0x2a, 0x85, 0x3a, 0x2c, 0x7e, 0x48,
+	0x0d, 0x3e, 0x39, 0xda, 0xad, 0x61, 0x43, 0xea, 0x54, 0x0a, 0x79, 0x76, 0x58, 0xc4, 0x43, 0xb3, 0xb7, 0x18, 0xb4, 0x14, 0x88, 0x01, 0xab, 0xad,
+	0x7a, 0x49, 0x0b, 0x8b, 0x5b, 0x0e, 0x72, 0x55, 0xa0, 0x58, 0xa4, 0x77, 0x32, 0x76, 0x06, 0x56, 0x0b, 0xf8, 0x38, 0x01, 0x46, 0xea, 0xda, 0x20,
+	0x85, 0xe4, 0x43, 0x4f, 0x44, 0x8b, 0xa4, 0xfc, 0x9f, 0x25, 0x38, 0x37, 0xa0, 0x13, 0x34, 0x16, 0x8e, 0x03, 0x19, 0x04, 0xb4, 0x9b, 0x05, 0x60,
+	0x74, 0x4c, 0xf3, 0x6d, 0xca, 0xbe, 0xf3, 0x4a, 0x96, 0xea, 0x7f, 0xbf, 0x66, 0x72, 0xb9, 0x2c, 0x7a, 0x09, 0x87, 0xbb, 0x48, 0x91, 0x17, 0x75,
+	0xf7, 0x30, 0x28, 0xb8, 0xf0, 0x1f, 0x50, 0x5d, 0xbb, 0x63, 0x6b, 0x50, 0x82, 0x5d, 0xaf, 0x6a, 0x5d, 0x5c, 0xe4, 0xe4, 0x76, 0x9b, 0x3f, 0x3d,
+	0x73, 0x5c, 0xca, 0xb0, 0x14, 0x09, 0xe7, 0x06, 0x77, 0x69, 0x45, 0xe2, 0xec, 0x24, 0x21, 0x93, 0x6c, 0x91, 0x22, 0x2f, 0xdd, 0xdc, 0x56, 0xe1,
+	0x42, 0xbb, 0x46, 0xbb, 0x5e, 0xfa, 0xc7, 0x90, 0x81, 0x08, 0x85, 0x80, 0x88, 0xd3, 0x52, 0x97, 0x58, 0x04, 0x5a, 0x6e, 0xa2, 0xa0, 0xe4, 0x2a,
+	0x7e, 0x29, 0x98, 0xaf, 0xf8, 0x5b, 0xd6, 0x0e, 0x65, 0xb4, 0xa1, 0x91, 0xd7, 0x3c, 0xd7, 0xbb, 0x0f, 0xca, 0xae, 0x1a, 0x08, 0xf3, 0xec, 0xff,
+	0xbc, 0xb6, 0x47, 0x6c, 0x6a, 0xc1, 0xe6, 0x23, 0x4b, 0x12, 0x22, 0xe4, 0x39, 0xf6, 0x95, 0x11, 0xe7, 0xf4, 0xb3, 0x03, 0xec, 0xdb, 0x52, 0x1d,
+	0x02, 0xc4, 0xf3, 0x5d, 0x6a, 0x12, 0xf1, 0xd2, 0x42, 0xfa, 0x9d, 0xa9, 0xc2, 0x67, 0x20, 0x2f, 0x4d, 0x3f, 0x63, 0xa8, 0x1d, 0xfe, 0xd2, 0x40,
+	0x86, 0x68, 0xc0, 0xc7, 0x78, 0xfc, 0x09, 0x61, 0x2a, 0x9c, 0xdd, 0x00, 0x7d, 0xeb, 0xd2, 0xb5, 0x2c, 0xfd, 0x6d, 0x5a, 0x5d, 0xaf, 0x2c, 0xef,
+	0x00, 0xf3, 0xa6, 0x94, 0xf4, 0xb6, 0xf3, 0x1f, 0x4b, 0xd2, 0x7a, 0x79, 0x8a, 0x82, 0xee, 0xe3, 0x53, 0xc4, 0x5b, 0x37, 0x5e, 0xb4, 0x25, 0xdb,
+	0x29, 0x44, 0x72, 0x98, 0xf8, 0x6d, 0x8c, 0x3c, 0xa3, 0x5c, 0xf7, 0x26, 0x4b, 0xd3, 0x3e, 0x71, 0x50, 0x88, 0x3f, 0xe2, 0x56, 0x93, 0x77, 0x3e,
+	0x61, 0x84, 0x5a, 0xea, 0xc0, 0x0f, 0xd6, 0xb6, 0x18, 0x86, 0x0e, 0x9e, 0xcd, 0xce, 0x43, 0x04, 0xeb, 0xe6, 0xbe, 0x0c, 0xc7, 0x6d, 0x98, 0xa4,
+	0x08, 0x06, 0x27, 0x31, 0xd2, 0x38, 0xd0, 0x61, 0xfb, 0x66, 0xe5, 0xa2, 0xa8, 0x0b, 0x35, 0xe8, 0x63, 0x0d, 0x1f, 0x4b, 0x46, 0x64, 0xef, 0x73,
+	0xb0, 0x01, 0x2c, 0x58, 0x58, 0x7f, 0x95, 0x83, 0xca, 0xe1, 0x75, 0x38, 0x25, 0x76, 0x87, 0x47, 0x7e, 0x34, 0x1f, 0xc5, 0x60, 0x22, 0xa2, 0xee,
+	0x8b, 0x4a, 0xc4, 0x4e, 0x0e, 0x07, 0x88, 0x16, 0x39, 0x1d, 0x55, 0x78, 0x6e, 0xd0, 0x5f, 0x25, 0x97, 0x87, 0x8c, 0x59, 0x92, 0xc9, 0x18, 0xe2,
+	0x87, 0x47, 0x3c, 0xc7, 0xbb, 0x31, 0x3a, 0xbc, 0x9b, 0x56, 0xc0, 0xda, 0x5d, 0xee, 0x30, 0xb9, 0x81, 0x37, 0xeb, 0x66, 0xcd, 0xf0, 0xd7, 0x73,
+	0xaf, 0xc8, 0xb5, 0x7d, 0xc2, 0xe5, 0x1b, 0x6f, 0xfa, 0xd5, 0x75, 0xca, 0xba, 0x28, 0xd9, 0x24, 0x3a, 0x5d, 0x0b, 0x28, 0x7d, 0x2a, 0x29, 0xc7,
+	0x4d, 0xca, 0xad, 0xcb, 0x09, 0x3e, 0x07, 0xa2, 0x93, 0x41, 0xd8, 0xd5, 0x0f, 0x0e, 0xd9, 0x5c, 0x83, 0x3e, 0x8a, 0xee, 0xc1, 0xca, 0x16, 0x88,
+	0x81, 0x9f, 0xc2, 0x8c, 0x58, 0xd8, 0x0d, 0x98, 0x5b, 0x7c, 0xde, 0x51, 0xaf, 0x80, 0x86, 0xd6, 0x0f, 0x5f, 0x76, 0xe3, 0x5f, 0x78, 0x56, 0x7a,
+	0x02, 0xac, 0xe0, 0xd2, 0x04, 0x15, 0x50, 0x55, 0xfe, 0x37, 0xf8, 0xd6, 0x3d, 0xa8, 0xa5, 0x62, 0xbc, 0xa2, 0xdc, 0x1f, 0xd6, 0x68, 0x6c, 0xfa,
+	0x1a, 0x21, 0x7c, 0xfc, 0x1e, 0x55, 0xc4, 0x64, 0x5c, 0x95, 0x3d, 0xd3, 0xf9, 0x71, 0x43, 0x7e, 0xaa, 0x98, 0xe1, 0xfa, 0x96, 0x03, 0x33, 0xbf,
+	0x27, 0x59, 0x4c, 0x9e, 0xab, 0x6c, 0x10, 0xba, 0xed, 0x9a, 0xf2, 0x85, 0x30, 0x02, 0xcf, 0xff, 0x4b, 0x30, 0xc6, 0x00, 0xc5, 0x56, 0x3b, 0x68,
+	0x54, 0x51, 0x10, 0x35, 0x8a, 0x45, 0x12, 0x10, 0xb1, 0x13, 0x02, 0x41, 0x24, 0x60, 0x44, 0x45, 0x0b, 0x91, 0x60, 0x13, 0xd0, 0x22, 0x90, 0x26,
+	0x45, 0x90, 0x80, 0x18, 0x76, 0xfe, 0x03, 0x56, 0x69, 0xb5, 0x50, 0x11, 0x9b, 0x34, 0xe9, 0xac, 0x24, 0x08, 0x16, 0x62, 0x1b, 0xb0, 0x30, 0xb0,
+	0x24, 0x85, 0x1f, 0x50, 0x2b, 0xb1, 0xb0, 0x16, 0x11, 0xd4, 0x22, 0x58, 0x09, 0x6a, 0xe1, 0x79, 0x76, 0x31, 0xba, 0x59, 0xdf, 0x6f, 0x77, 0xd9,
+	0xe5, 0xbe, 0x7b, 0x67, 0xe6, 0xcc, 0xcc, 0xde, 0x9d, 0x73, 0xc8, 0x3d, 0x84, 0x28, 0x82, 0x55, 0xd3, 0x45, 0xb0, 0x36, 0x0d, 0x25, 0x17, 0xa7,
+	0x60, 0x61, 0x4a, 0xbc, 0x89, 0x83, 0x53, 0x98, 0xa5, 0xb0, 0xd0, 0xe0, 0xb0, 0x64, 0xb6, 0xa0, 0x48, 0x27, 0x51, 0x0a, 0x12, 0x44, 0xe1, 0xd0,
+	0x30, 0xac, 0x22, 0x33, 0xad, 0x30, 0x34, 0x84, 0x0a, 0x31, 0x56, 0x63, 0x23, 0x33, 0xc4, 0xea, 0x89, 0xc5, 0x04, 0xaf, 0x60, 0x67, 0x02, 0x02,
+	0x82, 0xb2, 0x02, 0xc3, 0x5c, 0x93, 0x01, 0x93, 0x2c, 0x26, 0x92, 0x8d, 0x7b, 0xd4, 0x9e, 0x66, 0xfd, 0x2e, 0x65, 0xea, 0xad, 0x01, 0xb7, 0x5c,
+	0xbc, 0x20, 0x15, 0x61, 0x4b, 0x25, 0x4a, 0xc7, 0xfd, 0xd1, 0x4c, 0xc5, 0x77, 0x04, 0xce, 0xc5, 0x13, 0xed, 0xce, 0x84, 0x15, 0x6e, 0x0d, 0xfc,
+	0xe0, 0x40, 0xb8, 0x2a, 0x8e, 0x1d, 0x58, 0x85, 0xe0, 0x46, 0x21, 0xbe, 0x31, 0xb3, 0xe3, 0x66, 0xb1, 0x31, 0xb0, 0x11, 0x99, 0x93, 0xb0, 0x07,
+	0x54, 0x37, 0x09, 0x78, 0x38, 0xd6, 0x0d, 0x3d, 0xf5, 0x32, 0x68, 0xef, 0xf3, 0xcf, 0x93, 0x92, 0x85, 0x35, 0x5f, 0xef, 0x2e, 0xd5, 0xfc, 0x9c,
+	0x99, 0x58, 0xbd, 0x39, 0x79, 0xe7, 0xe5, 0xd4, 0x9e, 0xe1, 0x0b, 0x6b, 0x39, 0xb6, 0x6f, 0x6a, 0xe3, 0xd3, 0xf3, 0x77, 0xe3, 0x57, 0x46, 0x2e,
+	0xdb, 0xd1, 0xe1, 0xb9, 0x13, 0x8f, 0x36, 0x87, 0xde, 0x1c, 0xfe, 0x72, 0x7d, 0xa9, 0xb3, 0x7f, 0xf9, 0xe3, 0xf1, 0xd9, 0xf5, 0xd7, 0xef, 0x9f,
+	0x5c, 0xba, 0xf5, 0x78, 0xf4, 0xea, 0xf8, 0x4a, 0xf7, 0xd9, 0xed, 0xb1, 0x91, 0xad, 0x99, 0x17, 0x5b, 0xe7, 0x5e, 0x75, 0x8f, 0x3d, 0x9c, 0xfc,
+	0x7c, 0x7a, 0xf4, 0xfc, 0xf7, 0x8b, 0x5f, 0xef, 0x2f, 0x74, 0x1e, 0xac, 0x9d, 0x99, 0x3e, 0xb5, 0xb2, 0xd4, 0x59, 0x3c, 0xf8, 0xf4, 0xc7, 0xc6,
+	0xdb, 0xbb, 0x07, 0xee, 0x9d, 0x3d, 0x34, 0xbf, 0x77, 0x6e, 0x62, 0xb6, 0x3b, 0x74, 0xed, 0xe4, 0xc2, 0x87, 0x1b, 0xdf, 0x8e, 0xcc, 0x2f, 0x56,
+	0x2e, 0xb9, 0x8e, 0xa2, 0xda, 0x0c, 0x5c, 0x32, 0x99, 0xbe, 0xce, 0x06, 0x55, 0x65, 0xe3, 0x69, 0xef, 0x82, 0xb5, 0xd3, 0xbb, 0x8a, 0xcb, 0x0e,
+	0xfb, 0xba, 0x53, 0xe9, 0xa7, 0x29, 0x4a, 0xe0, 0x37, 0x8c, 0xe9, 0xc0, 0x74, 0xc5, 0x98, 0xc5, 0xf8, 0x55, 0x05, 0xa9, 0x63, 0x24, 0x63, 0x0b,
+	0xc3, 0x1c, 0x2c, 0x8e, 0x71, 0x2f, 0xfe, 0x57, 0x3b, 0x88, 0x81, 0x04, 0x67, 0x32, 0x38, 0x12, 0x6c, 0x89, 0x41, 0xef, 0xc5, 0x4f, 0x09, 0x59,
+	0xa0, 0x60, 0x50, 0x37, 0x77, 0x18, 0xab, 0x62, 0x4c, 0xa5, 0xa9, 0x1a, 0x76, 0x60, 0x05, 0xca, 0xc0, 0xb0, 0xc7, 0xdf, 0x8c, 0xa0, 0x0f, 0x1c,
+	0x52, 0x41, 0x21, 0x24, 0x20, 0x1a, 0x00, 0x95, 0xd8, 0x2b, 0xd8, 0x56, 0x1d, 0x33, 0xbe, 0xa0, 0x62, 0x09, 0x07, 0x91, 0x40, 0x4d, 0x08, 0xa9,
+	0xa9, 0x40, 0x8e, 0x00, 0x91, 0x40, 0x0a, 0x88, 0x06, 0xb6, 0xf8, 0x4d, 0x41, 0x0a, 0xf5, 0x41, 0x50, 0x27, 0xe6, 0x82, 0x64, 0x11, 0x02, 0x0c,
+	0x41, 0x90, 0x1d, 0x49, 0x80, 0x02, 0x91, 0x00, 0xce, 0x20, 0x43, 0x24, 0xa8, 0x47, 0xad, 0xa5, 0xd1, 0x7b, 0xc1, 0x0c, 0xf8, 0xb1, 0x82, 0xdb,
+	0xf6, 0x5a, 0x5a, 0xee, 0x42, 0xc9, 0xfc, 0x5b, 0x69, 0x4b, 0xc9, 0x1c, 0x6a, 0x69, 0x52, 0xa5, 0xbd, 0xf6, 0xd2, 0x19, 0x40, 0x96, 0x6d, 0x5a,
+	0xf5, 0x5b, 0x5c, 0x2d, 0x06, 0x95, 0x5f, 0xcd, 0x94, 0x5c, 0x7b, 0xed, 0x75, 0x67, 0xd2, 0x22, 0x6a, 0xeb, 0x3d, 0xda, 0x86, 0xf0, 0xa7, 0xeb,
+	0xff, 0x07, 0xf8, 0x05, 0x00, 0x32, 0x18, 0x89, 0x4e, 0xdb, 0xdf, 0xf7, 0x58, 0xfa, 0x9f, 0x96, 0x6a, 0xfb, 0xff, 0xd3, 0x77, 0x38, 0x23, 0x90,
+	0x7a, 0xe1, 0x2e, 0x6d, 0x93, 0x1d, 0x31, 0xf3, 0x49, 0x8d, 0xc7, 0xe6, 0x68, 0xef, 0xa7, 0x1c, 0x30, 0x5e, 0xa0, 0xec, 0x66, 0x8b, 0x34, 0x6a,
+	0x46, 0x2a, 0xb3, 0xc8, 0x37, 0x27, 0xfa, 0x69, 0x6f, 0xd0, 0xe9, 0xec, 0xe0, 0x8f, 0xf1, 0xdc, 0xf1, 0x0d, 0x97, 0xda, 0xb3, 0xe1, 0xfd, 0x01,
+	0xa0, 0x03, 0xf9, 0x9b, 0x89, 0x10, 0x4f, 0x37, 0x8e, 0x39, 0x10, 0xac, 0x2d, 0xaf, 0x03, 0x2e, 0x97, 0xef, 0xb4, 0x43, 0x27, 0xe6, 0x76, 0x7a,
+	0x47, 0x9b, 0xc0, 0x54, 0x87, 0x7e, 0x2c, 0x7d, 0x14, 0x1f, 0x21, 0x1d, 0x79, 0xe6, 0xcd, 0xb1, 0x79, 0x3b, 0x0e, 0x74, 0xb0, 0x38, 0x5d, 0x53,
+	0x12, 0x58, 0x39, 0xea, 0xe8, 0x27, 0x09, 0x12, 0xa5, 0xd7, 0x6d, 0xd3, 0xb9, 0xcb, 0x0d, 0xbd, 0xf7, 0xe1, 0x41, 0xb2, 0xcc, 0x15, 0x08, 0x48,
+	0x38, 0x60, 0xf1, 0x90, 0xcc, 0x41, 0x4c, 0xd1, 0x4b, 0xcb, 0x6f, 0x1d, 0xfa, 0x6a, 0x64, 0xd2, 0xa5, 0xb9, 0x12, 0x7e, 0xff, 0x83, 0x41, 0xe1,
+	0x59, 0x9f, 0xa7, 0x72, 0x26, 0x5e, 0xd3, 0x3a, 0xed, 0x14, 0xaf, 0x1b, 0xd6, 0x38, 0x2c, 0x20, 0x28, 0xc3, 0xee, 0xa1, 0x98, 0xe8, 0xe8, 0xd5,
+	0x0c, 0xf5, 0x14, 0x7e, 0x50, 0x2e, 0x76, 0x2c, 0xc0, 0x53, 0xa7, 0x95, 0xc8, 0xcc, 0x5e, 0x01, 0x8b, 0x3a, 0xa0, 0x3a, 0x95, 0x3e, 0xd8, 0x5a,
+	0x6c, 0xc8, 0x78, 0x25, 0xea, 0x18, 0xe6, 0xf9, 0x6b, 0xe5, 0x9e, 0x1f, 0x27, 0x45, 0xd3, 0xb5, 0x8a, 0xc7, 0x25, 0xc2, 0xfd, 0x02, 0x0a, 0x58,
+	0x02, 0x33, 0x16, 0x4c, 0x4e, 0x45, 0x95, 0x11, 0x54, 0x64, 0x6a, 0xf4, 0x1d, 0x45, 0x47, 0x36, 0x54, 0x21, 0x66, 0xb6, 0x68, 0xf1, 0xe3, 0x47,
+	0x9b, 0x3e, 0xd4, 0x7d, 0xb1, 0x48, 0x00, 0xc9, 0xee, 0x06, 0xfd, 0xf6, 0x21, 0xd7, 0xe9, 0x71, 0x6f, 0xfc, 0xca, 0x69, 0xc7, 0x3b, 0xd4, 0xc8,
+	0x3b, 0x2b, 0xee, 0x57, 0x5e, 0x57, 0xc5, 0x45, 0xcd, 0x03, 0xf7, 0x61, 0x36, 0x5a, 0x97, 0x8d, 0xa7, 0x3a, 0xb2, 0x61, 0xc8, 0x51, 0xf2, 0xcc,
+	0x09, 0x03, 0x4c, 0xb6, 0x95, 0xf4, 0x96, 0x24, 0x7f, 0x44, 0x41, 0x15, 0x73, 0x1b, 0x72, 0x89, 0xed, 0xd8, 0x23, 0x64, 0x66, 0x8c, 0xce, 0x5a,
+	0x1d, 0x40, 0x48, 0x43, 0xb0, 0x70, 0x61, 0xd8, 0x7d, 0xec, 0x11, 0xf5, 0xee, 0x4f, 0xb9, 0x2e, 0xf5, 0xf9, 0x47, 0xab, 0xf2, 0x7f, 0x8c, 0x0d,
+	0x04, 0x2b, 0xaa, 0x1b, 0x15, 0xc4, 0x01, 0x36, 0x44, 0xdc, 0xa7, 0x2d, 0xe4, 0x6a, 0x79, 0x05, 0x6e, 0xb4, 0xb2, 0x66, 0x62, 0x57, 0xfc, 0xb3,
+	0xc8, 0x6d, 0x63, 0x75, 0x3f, 0xb6, 0xc7, 0xe5, 0x50, 0x0b, 0x83, 0x2e, 0xc4, 0x92, 0xf8, 0x48, 0xeb, 0x19, 0x57, 0x21, 0xc6, 0xf7, 0xdf, 0x6e,
+	0x96, 0x63, 0x8c, 0x8a, 0xbe, 0x30, 0x9d, 0x21, 0x47, 0xf5, 0xc3, 0x11, 0x66, 0x54, 0x29, 0xdf, 0xad, 0x05, 0xeb, 0x7e, 0x99, 0x70, 0xbb, 0x22,
+	0x1d, 0xbf, 0x2b, 0xde, 0x22, 0x13, 0x8e, 0x94, 0x4d, 0xcb, 0x01, 0x53, 0x42, 0x82, 0x80, 0xea, 0x57, 0x2e, 0x85, 0xfa, 0x06, 0x9b, 0x72, 0x5c,
+	0x42, 0x07, 0x72, 0xf9, 0xf4, 0xc2, 0x58, 0xfb, 0x24, 0x49, 0x25, 0x5a, 0x3e, 0x2b, 0x28, 0x3d, 0xa7, 0xb1, 0x33, 0xa8, 0xcf, 0x97, 0xa2, 0xbe,
+	0x8a, 0xf9, 0xb2, 0x4f, 0xe7, 0x1d, 0x98, 0x9c, 0x91, 0x92, 0xb4, 0x65, 0x3c, 0xed, 0xd7, 0xc7, 0x0e, 0x44, 0x8a, 0x70, 0x63, 0x04, 0x25, 0x64,
+	0x89, 0x38, 0xff, 0x1e, 0xfe, 0xb6, 0x94, 0x0b, 0xd6, 0x3b, 0x36, 0x55, 0x49, 0x8d, 0x4b, 0x65, 0xcc, 0x0a, 0xbb, 0x96, 0x0b, 0xaf, 0x54, 0x4c,
+	0x31, 0xe3, 0x61, 0x62, 0xac, 0x02, 0x92, 0x4e, 0x86, 0x40, 0x52, 0xca, 0x80, 0xc5, 0xbb, 0x3c, 0x52, 0x25, 0xad, 0xa8, 0x71, 0x04, 0x81, 0xe3,
+	0x0f, 0xda, 0x06, 0x32, 0x21, 0x40, 0xe3, 0x3a, 0xeb, 0x67, 0x5d, 0x1a, 0x7b, 0x6e, 0x68, 0x82, 0x1f, 0x47, 0x68, 0x76, 0xe3, 0x5f, 0xb3, 0x82,
+	0x37, 0x73, 0x20, 0xce, 0x5d, 0xa0, 0x8d, 0x0b, 0x33, 0x79, 0xee, 0x1f, 0xed, 0xcd, 0x65, 0x07, 0xf2, 0x20, 0xc5, 0xe3, 0x14, 0x92, 0xa1, 0x6d,
+	0x25, 0x00, 0x7c, 0xa8, 0x0b, 0xf1, 0x79, 0x35, 0x7d, 0x19, 0x72, 0x5e, 0x0d, 0x84, 0x4b, 0x8c, 0x3a, 0x1e, 0x9b, 0x01, 0x29, 0xb1, 0x0e, 0x02,
+	0x6a, 0xd2, 0x65, 0x9d, 0x53, 0x3d, 0xab, 0x84, 0x22, 0x0c, 0x2a, 0x55, 0x2f, 0x93, 0x73, 0x47, 0x0b, 0x5b, 0x6a, 0xba, 0xae, 0xd3, 0xee, 0xe7,
+	0xcb, 0xb7, 0x1a, 0xf3, 0x4b, 0xbc, 0x2c, 0x44, 0xce, 0xda, 0x1a, 0xfe, 0x31, 0x52, 0x44, 0xa4, 0xc2, 0x3d, 0x0e, 0x62, 0x19, 0x5a, 0x10, 0xe2,
+	0x1e, 0xe3, 0x66, 0x13, 0xf5, 0xc5, 0x8c, 0x12, 0x19, 0x40, 0x47, 0xa1, 0x90, 0x76, 0x0b, 0x07, 0xf4, 0xec, 0x35, 0xb4, 0x51, 0x2c, 0xed, 0xaf,
+	0xae, 0xfb, 0xd0, 0x75, 0x24, 0xd2, 0xee, 0x5e, 0xa5, 0xd8, 0x49, 0x16, 0x26, 0xa8, 0xa6, 0x4e, 0xf3, 0x74, 0x01, 0x38, 0x11, 0xb5, 0xae, 0x59,
+	0x21, 0x75, 0x0a, 0x7b, 0x80, 0xba, 0xc8, 0xef, 0x6f, 0x40, 0x65, 0x87, 0xde, 0x30, 0x05, 0xf8, 0xb2, 0x32, 0xd0, 0x36, 0x41, 0x4a, 0x95, 0xe1,
+	0x67, 0x43, 0x50, 0xe0, 0x73, 0xff, 0xa9, 0xcb, 0x4b, 0x3a, 0x94, 0x8f, 0x6d, 0x6c, 0xf4, 0x4b, 0x97, 0xd2, 0xff, 0x0d, 0xf3, 0xfb, 0xc6, 0x39,
+	0x09, 0x11, 0xfe, 0x62, 0xbe, 0xcd, 0x39, 0x5e, 0x8b, 0xea, 0x83, 0xae, 0xe5, 0x2c, 0x20, 0x37, 0x2d, 0x23, 0x17, 0xb0, 0x02, 0x86, 0x86, 0xe4,
+	0xd2, 0x79, 0x88, 0x42, 0xb4, 0x74, 0x1a, 0xc9, 0x92, 0xa1, 0x20, 0x72, 0x98, 0x46, 0x2a, 0xbb, 0x2b, 0x45, 0xb9, 0x62, 0x01, 0x43, 0x00, 0x0b,
+	0xac, 0xa2, 0x24, 0xae, 0x92, 0xb5, 0xa1, 0xc6, 0x95, 0x9c, 0x5a, 0x36, 0xd8, 0x9a, 0xde, 0x1d, 0x1b, 0x42, 0x0f, 0x9c, 0x52, 0x08, 0x45, 0x38,
+	0x44, 0x94, 0x46, 0xf8, 0x30, 0x76, 0xa5, 0x3f, 0xfb, 0x98, 0xbd, 0xbb, 0xa1, 0x01, 0x68, 0xb1, 0xb7, 0x1f, 0xe6, 0x01, 0x49, 0x5e, 0x91, 0x60,
+	0x0b, 0xbe, 0xab, 0xe7, 0xbc, 0xdd, 0x54, 0xee, 0xfd, 0x00, 0x4e, 0xdf, 0x7d, 0xd2, 0x6d, 0x2b, 0x63, 0xfb, 0xcc, 0xae, 0x6a, 0x9f, 0x0b, 0x33,
+	0xe4, 0xd1, 0xf9, 0xfd, 0x54, 0x42, 0x08, 0x82, 0x20, 0x0e, 0xbd, 0x5c, 0x95, 0x2b, 0x09, 0xf7, 0x02, 0xb7, 0x4b, 0x00, 0x40, 0x17, 0x97, 0xd4,
+	0xae, 0xf0, 0xdb, 0x40, 0x17, 0x58, 0x05, 0xdc, 0xea, 0x84, 0xaa, 0x35, 0x77, 0x1a, 0xd2, 0x36, 0x89, 0xa1, 0x92, 0xc0, 0x56, 0xa7, 0xb9, 0xb4,
+	0x9b, 0xcd, 0xeb, 0xbe, 0x9e, 0x6b, 0xdb, 0xc0, 0x24, 0xe8, 0x09, 0xf9, 0xe6, 0x93, 0x4a, 0xfc, 0x66, 0x6a, 0xef, 0x50, 0xd1, 0x5e, 0xda, 0xea,
+	0x6a, 0x6a, 0xaf, 0xdd, 0xb4, 0xc3, 0x33, 0xfb, 0xfa, 0x6e, 0xf7, 0xaf, 0x31, 0x4c, 0xf5, 0xe9, 0xa2, 0x3d, 0xf7, 0xfa, 0x9a, 0x3c, 0xcc, 0xe9,
+	0x89, 0x67, 0x66, 0xd5, 0x5b, 0xb6, 0xb7, 0xd7, 0xab, 0x66, 0xbc, 0xd3, 0x75, 0xa6, 0x3d, 0xc5, 0xd3, 0xfb, 0x7a, 0xf6, 0xf7, 0x7b, 0x43, 0xcd,
+	0xf9, 0x89, 0xb6, 0xcc, 0xd3, 0xe2, 0x35, 0x78, 0x7f, 0x33, 0x6f, 0x13, 0x71, 0xfd, 0x3b, 0x35, 0xe9, 0x7a, 0xa9, 0x8b, 0x69, 0x79, 0x97, 0x69,
+	0x7f, 0xe1, 0xa1, 0xa2, 0x76, 0x69, 0x9f, 0x7c, 0x11, 0x80, 0x81, 0x6e, 0x04, 0x60, 0x2a, 0x24, 0x09, 0x40, 0x6c, 0x09, 0x00, 0x88, 0x00, 0x02,
+	0x00, 0x0e, 0x58, 0x06, 0x00, 0x04, 0xe0, 0x09, 0x80, 0x5c, 0x09, 0xc0, 0xb1, 0xc8, 0x46, 0x07, 0x81, 0xf1, 0xf0, 0x3a, 0x01, 0x20, 0x6c, 0x01,
+	0xc1, 0xf4, 0x60, 0x70, 0x00, 0xc3, 0x80, 0x40, 0x06, 0xc0, 0xb9, 0x30, 0x2f, 0x85, 0x42, 0x20, 0x3e, 0x38, 0x07, 0x02, 0xa0, 0x84, 0x08, 0xc2,
+	0x50, 0x0f, 0x00, 0x20, 0x1f, 0x80, 0x1c, 0x05, 0xc2, 0x62, 0x70, 0x99, 0x88, 0x88, 0x64, 0xd0, 0xed, 0x73, 0x74, 0x4f, 0x6f, 0x77, 0xb4, 0x3c,
+	0xdf, 0x98, 0x9b, 0x6c, 0xcd, 0x3e, 0x23, 0x57, 0x87, 0xf3, 0x36, 0xf1, 0x37, 0x1f, 0xd3, 0xb3, 0x5e, 0x97, 0xaa, 0x98, 0xb6, 0x97, 0x99, 0x76,
+	0x97, 0xfe, 0x1a, 0x1a, 0x27, 0x66, 0x99, 0xf7, 0xc4, 0xe1, 0x33, 0x11, 0x10, 0xc9, 0xa1, 0xda, 0xe6, 0xe8, 0x9e, 0xde, 0xef, 0x68, 0x79, 0xbf,
+	0x31, 0x36, 0xd9, 0x9a, 0x7e, 0xd0, 0xf3, 0x7e, 0x62, 0x6d, 0xb3, 0x34, 0xf8, 0x8d, 0x5e, 0x3c, 0x46, 0xaf, 0x0f, 0xe6, 0x6d, 0xe2, 0x6e, 0x3f,
+	0xa7, 0x66, 0xbc, 0x32, 0x68, 0x76, 0xb9, 0xba, 0x27, 0xb7, 0xbb, 0xda, 0x1e, 0x6f, 0xcc, 0x4d, 0xb6, 0x66, 0x9f, 0x11, 0xab, 0xc3, 0xf9, 0x9b,
+	0x78, 0x9b, 0x8f, 0xe9, 0xd9, 0xaf, 0x4b, 0xd5, 0x4c, 0x5b, 0x4b, 0xcc, 0xbb, 0x4b, 0xff, 0x0d, 0x0d, 0x13, 0xb3, 0x4c, 0xfb, 0xe2, 0x70, 0x99,
+	0x88, 0x88, 0x64, 0xd0, 0xed, 0x73, 0x74, 0x4f, 0x6f, 0x77, 0xb4, 0x3c, 0xdc, 0xdc, 0x7f, 0x4e, 0xcd, 0x78, 0x64, 0xd0, 0xed, 0x73, 0x74, 0x4f,
+	0x6f, 0x77, 0xb4, 0x3b, 0x4b, 0xcc, 0xbb, 0x4b, 0xff, 0x0d, 0x0d, 0x13, 0xb3, 0x4c, 0xfb, 0xe2, 0x70, 0x99, 0x88, 0x88, 0x64, 0xd2, 0xf8, 0x9c,
+	0x26, 0x62, 0x22, 0x19, 0x34, 0x3b, 0x5c, 0xdd, 0x13, 0xdb, 0xdd, 0xed, 0x0f, 0x37, 0xe6, 0x26, 0xdb, 0x33, 0x4f, 0xda, 0x1e, 0x6f, 0xcc, 0x4d,
+	0xb6, 0x66, 0x9f, 0x11, 0xab, 0xc7, 0x88, 0xd5, 0xe1, 0xfc, 0xcd, 0xbc, 0x4d, 0xc7, 0xf4, 0xec, 0xd7, 0x86, 0x4d, 0x0e, 0xd7, 0x37, 0x44, 0xf6,
+	0xf7, 0x7b, 0x43, 0xcd, 0xf9, 0x89, 0xb6, 0xcc, 0xd3, 0xe2, 0x35, 0x78, 0x7f, 0x33, 0x6f, 0x7e, 0x62, 0x6d, 0xb3, 0x34, 0xfd, 0xa1, 0xe6, 0xfc,
+	0xdb, 0xc4, 0xdc, 0x7f, 0x4e, 0xcd, 0x78, 0x64, 0xd0, 0xed, 0x73, 0x74, 0x4f, 0x6f, 0x77, 0xb4, 0x3c, 0xdf, 0x98, 0x9b, 0x6c, 0xcd, 0x3e, 0x23,
+	0x57, 0x87, 0xf3, 0x36, 0xf7, 0xe6, 0x26, 0xdb, 0x33, 0x4f, 0xda, 0x1e, 0x6f, 0xcd, 0xbc, 0x4d, 0xc7, 0xf4, 0xec, 0xd7, 0x86, 0x4d, 0x0e, 0xd7,
+	0x37, 0x44, 0xf6, 0xf7, 0x7b, 0x43, 0xcd, 0xf9, 0x89, 0xb6, 0xcc, 0xd3, 0xe0, 0x5a, 0x84, 0x20, 0x14, 0x85, 0x15, 0x71, 0xd5, 0xcf, 0xd2, 0x1e,
+	0x85, 0x4c, 0xc2, 0xe3, 0xe3, 0xc1, 0xa0, 0xc1, 0x4a, 0xd0, 0xf8, 0xf9, 0x99, 0x09, 0x52, 0x50, 0x34, 0x08, 0x03, 0xcb, 0x9b, 0xa2, 0x7b, 0x7b,
+	0xbd, 0xa1, 0xe6, 0xfc, 0xc4, 0xdb, 0x66, 0x69, 0xf0, 0x2d, 0x42, 0x10, 0x0a, 0x42, 0x8a, 0xb8, 0xea, 0xe7, 0xe9, 0x0f, 0x42, 0xa6, 0x61, 0x71,
+	0xf1, 0xe0, 0xd0, 0x60, 0xa5, 0x68, 0x7c, 0x7c, 0xcc, 0x84, 0xa9, 0x2b, 0x66, 0x69, 0xfb, 0x43, 0xcd, 0xf9, 0xb7, 0x89, 0xb8, 0xfe, 0x9d, 0x9a,
+	0xf0, 0xc9, 0xa1, 0xda, 0xe6, 0xe8, 0x9e, 0xde, 0xef, 0x68, 0x79, 0xbf, 0x31, 0x36, 0xd9, 0x9a, 0x7c, 0x0b, 0x50, 0x84, 0x02, 0x90, 0xa2, 0xae,
+	0x3a, 0xb9, 0xfa, 0x43, 0xd0, 0xa9, 0x98, 0x5c, 0x7c, 0x78, 0x34, 0x18, 0x29, 0x5a, 0x1f, 0x1f, 0x33, 0x21, 0x2a, 0x4a, 0x06, 0x81, 0x00, 0x79,
+	0x73, 0x74, 0x4f, 0x6f, 0x77, 0xb4, 0x3c, 0xdf, 0x98, 0x9b, 0x6c, 0xcd, 0x3e, 0x05, 0xa8, 0x42, 0x01, 0x48, 0x51, 0x57, 0x1d, 0x5c, 0xfd, 0x21,
+	0xec, 0xc4, 0x3e, 0x69, 0xa9, 0x99, 0x78, 0xa9, 0xb6, 0xa7, 0x76, 0xd7, 0x55, 0x4e, 0xd7, 0x5e, 0x6e, 0xbd, 0x67, 0x9d, 0xfe, 0x86, 0xcd, 0x50,
+	0xf1, 0x6d, 0x15, 0xa6, 0x6f, 0x78, 0x6f, 0x9a, 0xbe, 0xde, 0xb4, 0x5c, 0xfb, 0x8a, 0x9f, 0xe5, 0xfd, 0x54, 0x7f, 0xd9, 0xa3, 0xf8, 0xbd, 0x1a,
+	0x33, 0x3c, 0xdb, 0x78, 0xfe, 0x9d, 0x9a, 0xf0, 0xc9, 0xa1, 0xda, 0xe6, 0xe8, 0x9e, 0xde, 0xef, 0x68, 0x79, 0xbf, 0x31, 0x36, 0xd9, 0x9a, 0x7c,
+	0x0b, 0x50, 0x84, 0x02, 0x90, 0xa2, 0xae, 0x3a, 0xb9, 0xfa, 0x43, 0xd0, 0xa9, 0x98, 0x5c, 0x7c, 0x78, 0x34, 0x18, 0x29, 0x5a, 0x1f, 0x1f, 0x33,
+	0x21, 0x2a, 0x4b, 0x55, 0x4e, 0xd7, 0x5e, 0x6e, 0xbd, 0x67, 0x9d, 0xfe, 0x86, 0xcd, 0x50, 0xf1, 0x6d, 0x15, 0xa6, 0x6f, 0x78, 0x6f, 0x9a, 0xbe,
+	0xde, 0xb4, 0x5c, 0xfb, 0x8a, 0x9f, 0xe5, 0xfd, 0x54, 0x7f, 0xd9, 0xa3, 0xf8, 0xbd, 0x19, 0x9a, 0x3f, 0x8b, 0xd1, 0xa3, 0x33, 0xcd, 0xb7, 0x8f,
+	0xe9, 0xd9, 0xaf, 0x0c, 0x9a, 0x1d, 0xae, 0x6e, 0x89, 0xed, 0xee, 0xf6, 0x87, 0x9b, 0xf3, 0x13, 0x6d, 0x99, 0xa7, 0xc0, 0xb5, 0x08, 0x40, 0x29,
+	0x0a, 0x2a, 0xe3, 0xab, 0x9f, 0xa4, 0x3d, 0x0a, 0x99, 0x85, 0xc7, 0xc7, 0x83, 0x41, 0x82, 0x95, 0xa1, 0xf1, 0xf3, 0x32, 0x12, 0xa4, 0xb5, 0x54,
+	0xed, 0x75, 0xe6, 0xeb, 0xd6, 0x79, 0xdf, 0xe8, 0x6c, 0xd5, 0x0f, 0x16, 0xd1, 0x5a, 0x6b, 0x45, 0xcf, 0xb8, 0xa9, 0xfe, 0x5f, 0xd5, 0x47, 0xfd,
+	0x9a, 0x3f, 0x8b, 0xd1, 0xa3, 0x33, 0xcd, 0xb7, 0x8f, 0xe9, 0xd9, 0xaf, 0x0c, 0x9a, 0x1d, 0xae, 0x6e, 0x89, 0xed, 0xee, 0xf6, 0x87, 0x9b, 0xf3,
+	0x13, 0x6d, 0xb7, 0xad, 0x17, 0x3e, 0xe2, 0xa7, 0xf9, 0x7f, 0x55, 0x1f, 0xf6, 0x68, 0xfe, 0x2f, 0x46, 0x66, 0x8f, 0xe2, 0xf4, 0x68, 0xcc, 0xf3,
+	0x6d, 0xe3, 0xfa, 0x76, 0x6b, 0xc3, 0x26, 0x87, 0x6b, 0x9b, 0xa2, 0x7b, 0x7b, 0xbd, 0xa1, 0xe6, 0xfc, 0xc4, 0xdb, 0x66, 0x69, 0xf0, 0x2d, 0x42,
+	0x10, 0x0a, 0x42, 0x8a, 0xb8, 0xea, 0xe7, 0xe9, 0x0f, 0x42, 0xa6, 0x61, 0x71, 0xf1, 0xe0, 0xd0, 0x60, 0xa5, 0x68, 0x7c, 0x7f, 0xc5, 0xe8, 0xd1,
+	0x99, 0xe6, 0xdb, 0xc7, 0xf4, 0xec, 0xd7, 0x86, 0x4d, 0x0e, 0xd7, 0x37, 0x44, 0xf6, 0xf7, 0x7b, 0x43, 0xcd, 0xf9, 0x89, 0xb6, 0xcc, 0xd3, 0xe0,
+	0x5a, 0x84, 0x20, 0x14, 0x85, 0x15, 0x71, 0xd5, 0xcf, 0xd2, 0x1e, 0x85, 0x4c, 0xc2, 0xe3, 0xe3, 0xc1, 0xa0, 0xc1, 0x4a, 0xd0, 0xf8, 0xfd, 0x67,
+	0x9d, 0xfe, 0x86, 0xcd, 0x50, 0xf1, 0x6d, 0x15, 0xa6, 0xb4, 0x5c, 0xfb, 0x8a, 0x9f, 0xe5, 0xfd, 0x54, 0x7f, 0xd9, 0xa3, 0xf8, 0xbd, 0x1a, 0x33,
+	0x3c, 0xdb, 0x78, 0xfe, 0x9d, 0x9a, 0xf0, 0xc9, 0xa1, 0xda, 0xe6, 0xe8, 0x9e, 0xde, 0xef, 0x68, 0x79, 0xbf, 0x31, 0x36, 0xdb, 0x7a, 0xd1, 0x73,
+	0xd5, 0x81, 0x40, 0x3a, 0x03, 0x03, 0x80, 0x2c, 0x03, 0xa0, 0x60, 0x0c, 0x80, 0x40, 0x06, 0x80, 0xa0, 0x12, 0x82, 0x60, 0x58, 0x0a, 0x00, 0xd0,
+	0x1f, 0x00, 0x50, 0x32, 0x1c, 0x5c, 0x10, 0x84, 0x20, 0x78, 0x11, 0x18, 0x82, 0x40, 0x0c, 0x0b, 0x82, 0x20, 0x0a, 0x20, 0x01, 0x20, 0x0c, 0x24,
+	0x4e, 0x03, 0xc0, 0x42, 0x0a, 0x80, 0x98, 0x02, 0x00, 0x58, 0x17, 0x01, 0x13, 0x00, 0x19, 0x3b, 0x08, 0x0f, 0xd1, 0xc3, 0xcd, 0xf9, 0x89, 0xb6,
+	0xcc, 0xd3, 0xe0, 0x5a, 0x84, 0x20, 0x14, 0x85, 0x15, 0x71, 0xd5, 0xcf, 0xd2, 0x1e, 0x85, 0x4c, 0xc2, 0xe3, 0xe3, 0xc1, 0xa0, 0xc1, 0x4a, 0xd0,
+	0xf8, 0xff, 0x8b, 0xd1, 0xa3, 0x33, 0xcd, 0xb7, 0x8f, 0xe9, 0xd9, 0xaf, 0x0c, 0x9a, 0x1d, 0xae, 0x6e, 0x89, 0xed, 0xee, 0xf6, 0x87, 0x9b, 0xf3,
+	0x12, 0xf3, 0xbf, 0xd0, 0xd9, 0xaa, 0x1e, 0x2d, 0xa2, 0xb4, 0xd6, 0x8b, 0x9f, 0x71, 0x53, 0xfc, 0xbf, 0xaa, 0x8f, 0xfb, 0x34, 0x7f, 0x17, 0xa3,
+	0x46, 0x67, 0x9b, 0x6f, 0x1f, 0xd3, 0xb3, 0x5e, 0x19, 0x34, 0x3b, 0x5c, 0xdd, 0x13, 0xdb, 0xdd, 0xed, 0x0f, 0x37, 0x77, 0x77, 0x77, 0x77, 0x77,
+	0x77, 0x77, 0x77, 0x77, 0x67, 0xe8, 0xe1, 0xe6, 0xfc, 0xc4, 0xdb, 0x66, 0x69, 0xf0, 0x2d, 0x42, 0x10, 0x0a, 0x42, 0x8a, 0xb8, 0xea, 0xe7, 0xe9,
+	0x0f, 0x42, 0xa6, 0x61, 0x71, 0xf1, 0xe0, 0xd4, 0x47, 0xd3, 0xea, 0x9d, 0xdf, 0xcd, 0x35, 0xc5, 0xb7, 0x66, 0x9b, 0xbf, 0x1e, 0x9a, 0x6a, 0xd9,
+	0xb5, 0xdb, 0x7d, 0x99, 0xa2, 0x65, 0xef, 0xff, 0xb5, 0x4b, 0x4e, 0xbf, 0x79, 0xa3, 0xc6, 0x7c, 0xfb, 0x44, 0x7d, 0x3e, 0xa9, 0xdd, 0xfc, 0xd3,
+	0x5c, 0x5b, 0x76, 0x69, 0xbb, 0xf1, 0xe3, 0xe9, 0xf5, 0x4e, 0xef, 0xe6, 0x9a, 0xe2, 0xdb, 0xb3, 0x4d, 0xdf, 0x8f, 0x4d, 0x35, 0x6c, 0xda, 0xed,
+	0xbe, 0xcc, 0xd1, 0x32, 0xf7, 0xff, 0xda, 0xa5, 0xa7, 0x5f, 0xbd, 0x1d, 0xef, 0xf9, 0x68, 0x6a, 0x78, 0x8a, 0x6c, 0xde, 0x73, 0x6f, 0x76, 0xd0,
+	0xd2, 0xd5, 0xbd, 0xb3, 0xbb, 0xd3, 0xdf, 0xf5, 0xb5, 0x37, 0xa8, 0x9a, 0x8a, 0xd5, 0x5e, 0x2b, 0xbc, 0x6a, 0x7b, 0x68, 0xb8, 0xd3, 0x11, 0xf4,
+	0xfa, 0xa7, 0x77, 0xf3, 0x4d, 0x71, 0x6d, 0xd9, 0xa6, 0xef, 0xc7, 0xa6, 0x9a, 0xb6, 0x6d, 0x76, 0xdf, 0x66, 0x68, 0x99, 0x7b, 0xff, 0xed, 0x52,
+	0xd3, 0xaf, 0xde, 0x68, 0xf1, 0x9f, 0x3e, 0xd1, 0x1f, 0x4f, 0xaa, 0x77, 0x7f, 0x34, 0xd7, 0x16, 0xd1, 0x9f, 0x3e, 0xd1, 0x1f, 0x4f, 0xaa, 0x77,
+	0x7f, 0x34, 0xd7, 0x16, 0xd1, 0x9f, 0x3e, 0xd1, 0x1f, 0x4f, 0xaa, 0x77, 0x7f, 0x34, 0xd7, 0x16, 0xd1, 0x9f, 0x3e, 0xd1, 0x1f, 0x4f, 0xaa, 0x77,
+	0x7f, 0x34, 0xd7, 0x16, 0xd1, 0x9f, 0x3e, 0xd1, 0x1f, 0x4e, 0xd4, 0xde, 0xa2, 0x6a, 0x2b, 0x55, 0x78, 0xae, 0xf1, 0xa9, 0xed, 0xa2, 0xe3, 0x4c,
+	0x47, 0xd3, 0xea, 0x9d, 0xdf, 0xcd, 0x35, 0xc5, 0xb7, 0x66, 0x9b, 0xbf, 0x1e, 0x9a, 0x6e, 0xfc, 0x7a, 0x69, 0xab, 0x66, 0xd7, 0x6d, 0xf6, 0x66,
+	0x89, 0x97, 0xbf, 0xfe, 0xd5, 0x2d, 0x3a, 0xfd, 0xe6, 0x8f, 0x19, 0xf3, 0xed, 0x11, 0xf4, 0xfa, 0xa7, 0x77, 0xf3, 0x4d, 0x71, 0x6d, 0x19, 0xf3,
+	0xb4, 0xd5, 0xb3, 0x6b, 0xb6, 0xfb, 0x33, 0x44, 0xcb, 0xdf, 0xff, 0x6a, 0x96, 0x9d, 0x7e, 0xf3, 0x47, 0x8c, 0xf9, 0xf6, 0x88, 0xfa, 0x7d, 0x53,
+	0xbb, 0xf9, 0xa6, 0xb8, 0xb6, 0x8c, 0xf9, 0xf6, 0x88, 0xfa, 0x7d, 0x53, 0xbb, 0xf9, 0xa6, 0xb8, 0xb6, 0x8c, 0xf9, 0xf6, 0x88, 0xfa, 0x7d, 0x53,
+	0xbb, 0xf9, 0xa6, 0xb8, 0xb6, 0x8d, 0x71, 0x6d, 0x19, 0xf3, 0xed, 0x11, 0xf4, 0xed, 0x4d, 0xea, 0x26, 0xa2, 0xb5, 0x57, 0x8a, 0xef, 0x1a, 0x9f,
+	0x3e, 0x76, 0x9a, 0xb6, 0x6d, 0x76, 0xdf, 0x66, 0x68, 0x99, 0x7b, 0xff, 0xed, 0x52, 0xd3, 0xaf, 0xde, 0x68, 0xf1, 0x9f, 0x3e, 0xd1, 0x1f, 0x4f,
+	0xaa, 0x77, 0x7f, 0x34, 0xd7, 0x16, 0xd1, 0x9f, 0x3e, 0xd1, 0x1f, 0x4f, 0xaa, 0x77, 0x7f, 0x34, 0xd7, 0x16, 0xd1, 0x9f, 0x3e, 0xd1, 0x1f, 0x57,
+	0xee, 0xd7, 0x75, 0x9a, 0xe5, 0x9d, 0xe2, 0x6e, 0x62, 0x19, 0xb4, 0xff, 0x14, 0xf3, 0xb3, 0xdc, 0x45, 0xb4, 0x67, 0xcf, 0xb4, 0x47, 0xd3, 0xb5,
+	0x37, 0xa8, 0x9a, 0x8a, 0xd5, 0x5e, 0x2b, 0xbc, 0x6a, 0x7c, 0xf9, 0xda, 0x6a, 0xd9, 0xb5, 0xdb, 0x7d, 0x99, 0xa2, 0x65, 0xef, 0xff, 0xb5, 0x7f,
+	0xf6, 0xaf, 0xfe, 0xd5, 0xff, 0x6f, 0xb1, 0x79, 0x19, 0xc1, 0x20, 0xda, 0xa3, 0x53, 0x21, 0xa2, 0xb4, 0x35, 0x2a, 0x12, 0xa7, 0x2c, 0x3a, 0x20,
+	0x4c, 0x60, 0x4e, 0x30, 0x38, 0x8a, 0x80, 0x44, 0x2e, 0xb5, 0x7c, 0x62, 0x25, 0x14, 0x07, 0x8b, 0xc4, 0x65, 0x42, 0xb1, 0xd1, 0x62, 0x34, 0x78,
+	0x36, 0x42, 0x1c, 0x18, 0x0b, 0x1f, 0x29, 0x12, 0x08, 0x43, 0x28, 0x46, 0xc4, 0xa5, 0xa7, 0x29, 0x09, 0x90, 0x53, 0x14, 0x17, 0x2c, 0x3c, 0x56,
+	0x52, 0x0e, 0x82, 0xc2, 0x62, 0xc2, 0xd5, 0x21, 0x28, 0x9c, 0x44, 0x7a, 0x09, 0x02, 0x81, 0xd2, 0xfe, 0x3c, 0x60, 0x11, 0x03, 0x49, 0xd1, 0x81,
+	0x50, 0x54, 0x1c, 0x08, 0x01, 0x30, 0x6c, 0xfc, 0x19, 0x08, 0xc2, 0x43, 0xa0, 0x60, 0x3a, 0x0f, 0x03, 0xe2, 0xa1, 0x30, 0x42, 0xac, 0x55, 0x7f,
+	0xfd, 0xab, 0xff, 0xb5, 0x7f, 0xf6, 0xaf, 0xfb, 0x7d, 0x8b, 0xc8, 0xce, 0x09, 0x06, 0xd5, 0x1a, 0x99, 0x0d, 0x15, 0xa1, 0xa9, 0x50, 0x95, 0x39,
+	0x61, 0xd1, 0x02, 0x63, 0x02, 0x71, 0x81, 0xc4, 0x54, 0x02, 0x21, 0x75, 0xab, 0xe3, 0x11, 0x28, 0xa0, 0x3c, 0x5e, 0x23, 0x2a, 0x15, 0x8e, 0x8b,
+	0x11, 0xa3, 0xc1, 0xb2, 0x10, 0xe0, 0xc0, 0x58, 0xf9, 0x48, 0x90, 0x42, 0x19, 0x42, 0x36, 0x25, 0x2d, 0x39, 0x48, 0x4c, 0x82, 0x98, 0xa0, 0xb9,
+	0x61, 0xe2, 0xb2, 0x90, 0x74, 0x16, 0x13, 0x16, 0x14, 0x17, 0x2c, 0x3c, 0x56, 0x52, 0x0e, 0x82, 0xc2, 0x62, 0xc2, 0xd5, 0x21, 0x28, 0x9c, 0x44,
+	0x7a, 0x09, 0x02, 0x81, 0xd2, 0xfe, 0x3c, 0x60, 0x11, 0x03, 0x49, 0xd1, 0x81, 0x50, 0x54, 0x1c, 0x08, 0x01, 0x30, 0x6c, 0xfc, 0x19, 0x11, 0x1e,
+	0x82, 0x40, 0xa0, 0x74, 0xbf, 0x8f, 0x18, 0x04, 0x40, 0xd2, 0x74, 0x60, 0x54, 0x15, 0x07, 0x02, 0x00, 0x4c, 0x1b, 0x3f, 0x06, 0x42, 0x30, 0x90,
+	0xe8, 0x18, 0x0e, 0x83, 0xc0, 0xf8, 0xa8, 0x4c, 0x10, 0xab, 0x15, 0x5f, 0xff, 0x6a, 0xff, 0xed, 0x5f, 0xfd, 0xab, 0xfe, 0xdf, 0x62, 0xf2, 0x33,
+	0x82, 0x41, 0xb5, 0x46, 0xa6, 0x43, 0x45, 0x68, 0x6a, 0x54, 0x25, 0x4e, 0x58, 0x74, 0x40, 0x98, 0xc0, 0x9c, 0x60, 0x71, 0x15, 0x00, 0x88, 0x5d,
+	0x6a, 0xf8, 0xc4, 0x4a, 0x28, 0x0f, 0x17, 0x88, 0xca, 0x85, 0x63, 0xa2, 0xc4, 0x68, 0xf0, 0x6c, 0x84, 0x38, 0x30, 0x16, 0x3e, 0x52, 0x24, 0x10,
+	0x86, 0x50, 0x8d, 0x89, 0x4b, 0x4e, 0x52, 0x13, 0x20, 0xa6, 0x28, 0x2e, 0x58, 0x78, 0xad, 0x4a, 0x84, 0xa9, 0xcb, 0x0e, 0x88, 0x13, 0x18, 0x13,
+	0x8c, 0x0e, 0x22, 0xa0, 0x11, 0x0b, 0xad, 0x5f, 0x18, 0x89, 0x45, 0x01, 0xe2, 0xf1, 0x19, 0x50, 0xac, 0x74, 0x58, 0x11, 0x84, 0x87, 0x40, 0xc0,
+	0x74, 0x1e, 0x07, 0xc5, 0x42, 0x60, 0x85, 0x58, 0xaa, 0xff, 0xfb, 0x57, 0xff, 0x6a, 0xff, 0xed, 0x5f, 0xf6, 0xfb, 0x17, 0x91, 0x9c, 0x12, 0x0d,
+	0xaa, 0x35, 0x32, 0x1a, 0x2b, 0x43, 0x52, 0xa1, 0x2a, 0x72, 0xc3, 0xa2, 0x04, 0xc6, 0x04, 0xe3, 0x03, 0x88, 0xa8, 0x04, 0x42, 0xeb, 0x57, 0xc6,
+	0x22, 0x51, 0x40, 0x78, 0xbc, 0x46, 0x54, 0x2b, 0x1d, 0x16, 0x23, 0x47, 0x83, 0x64, 0x21, 0xc1, 0x80, 0xb1, 0xf2, 0x91, 0x20, 0x84, 0x32, 0x84,
+	0x6c, 0x4a, 0x5a, 0x72, 0x90, 0x99, 0x05, 0x31, 0x41, 0x72, 0xc3, 0xc5, 0x6a, 0x54, 0x25, 0x4e, 0x58, 0x74, 0x40, 0x50, 0x5c, 0xb0, 0xf0, 0x32,
+	0x84, 0x6c, 0x4a, 0x5a, 0x72, 0x90, 0x99, 0x05, 0x31, 0x41, 0x72, 0xc3, 0xc5, 0x6a, 0x54, 0x25, 0x4e, 0x58, 0x74, 0x40, 0x98, 0xc0, 0x9c, 0x60,
+	0x71, 0x15, 0x00, 0x88, 0x5d, 0x6a, 0xfb, 0xfd, 0xab, 0xfe, 0xdf, 0x62, 0xf2, 0x33, 0x82, 0x41, 0xb5, 0x46, 0xa6, 0x43, 0x45, 0x68, 0x6a, 0x54,
+	0x25, 0x4e, 0x58, 0x74, 0x40, 0x98, 0xc0, 0x9c, 0x60, 0x71, 0x15, 0x00, 0x88, 0x5d, 0x6a, 0xf8, 0xc4, 0x4a, 0x28, 0x0f, 0x17, 0x88, 0xca, 0x85,
+	0x63, 0xa2, 0xc4, 0x68, 0xf0, 0x6c, 0x84, 0x38, 0x30, 0x16, 0x3e, 0x52, 0x24, 0x10, 0x86, 0x50, 0x8d, 0x89, 0x4b, 0x4e, 0x52, 0x13, 0x20, 0xa6,
+	0x28, 0x2e, 0x58, 0x78, 0xad, 0x05, 0x31, 0x41, 0x72, 0xc3, 0xc5, 0x6a, 0x54, 0x25, 0x4e, 0x58, 0x74, 0x40, 0x98, 0xa8, 0x56, 0x3a, 0x2c, 0x46,
+	0x8f, 0x06, 0xc8, 0x43, 0x83, 0x01, 0x63, 0xe5, 0x22, 0x41, 0x08, 0x65, 0x08, 0xd8, 0x94, 0xb4, 0xe5, 0x21, 0x32, 0x0a, 0x62, 0x82, 0xe5, 0x87,
+	0x8a, 0xd0, 0x53, 0x14, 0x17, 0x2c, 0x3c, 0x56, 0xa5, 0x42, 0x54, 0xe5, 0x87, 0x44, 0x09, 0x8a, 0x85, 0x63, 0xa2, 0xc4, 0x68, 0xf0, 0x6c, 0x84,
+	0x38, 0x30, 0x16, 0x3e, 0x52, 0x24, 0x10, 0x86, 0x50, 0x8d, 0x89, 0x4b, 0x4e, 0x52, 0x13, 0x20, 0xa6, 0x28, 0x2e, 0x58, 0x78, 0xad, 0x05, 0x31,
+	0x41, 0x72, 0xc3, 0xc5, 0x6a, 0x54, 0x25, 0x4e, 0x58, 0x74, 0x40, 0x98, 0xa8, 0x56, 0x3a, 0x2c, 0x46, 0x8f, 0x06, 0xc8, 0x43, 0x83, 0x01, 0x63,
+	0xe5, 0x26, 0xc4, 0xa5, 0xa7, 0x29, 0x09, 0x90, 0x53, 0x14, 0x17, 0x2c, 0x3c, 0x56, 0xa5, 0x42, 0x54, 0xe5, 0x87, 0x44, 0x09, 0x8c, 0x09, 0xc6,
+	0x07, 0x11, 0x50, 0x08, 0x85, 0xd6, 0xaf, 0xbf, 0xda, 0xbf, 0xed, 0xf6, 0x2f, 0x23, 0x38, 0x24, 0x1b, 0x54, 0x6a, 0x64, 0x34, 0x56, 0x86, 0xa5,
+	0x42, 0x54, 0xe7, 0xca, 0x4d, 0x89, 0x4b, 0x4e, 0x52, 0x13, 0x20, 0xa6, 0x28, 0x2e, 0x58, 0x78, 0xad, 0x4a, 0x84, 0xa9, 0xcb, 0x0e, 0x88, 0x13,
+	0x18, 0x13, 0x8c, 0x0e, 0x22, 0xa0, 0x11, 0x0b, 0xad, 0x5f, 0x7f, 0xb5, 0x7f, 0xdb, 0xec, 0x5e, 0x46, 0x70, 0x48, 0x36, 0xa8, 0xd4, 0xc8, 0x68,
+	0xad, 0x0d, 0x4a, 0x84, 0xa9, 0xcf, 0x94, 0x9b, 0x12, 0x96, 0x9c, 0xa4, 0x26, 0x41, 0x4c, 0x50, 0x5c, 0xb0, 0xf1, 0x5a, 0x95, 0x09, 0x53, 0x96,
+	0x1d, 0x10, 0x26, 0x30, 0x27, 0x18, 0x1c, 0x45, 0x40, 0x22, 0x17, 0x5a, 0xbe, 0xff, 0x6a, 0xff, 0xe2, 0xf2, 0x33, 0x82, 0x41, 0xb5, 0x46, 0xa6,
+	0x43, 0x45, 0x68, 0x6a, 0x54, 0x25, 0x4e, 0x7c, 0xa4, 0xd8, 0x94, 0xb4, 0xe5, 0x21, 0x32, 0x0a, 0x62, 0x82, 0xe5, 0x87, 0x8a, 0xd4, 0xa8, 0x4a,
+	0x9c, 0xb0, 0xe8, 0x81, 0x31, 0x81, 0x38, 0xc0, 0xe2, 0x2a, 0x01, 0x10, 0xba, 0xd5, 0xf7, 0x20, 0x4c, 0x60, 0x4e, 0x30, 0x38, 0x8a, 0x80, 0x44,
+	0x2e, 0xb5, 0x7d, 0xfe, 0xd5, 0xff, 0x6f, 0xb1, 0x79, 0x19, 0xc1, 0x20, 0xda, 0xa3, 0x53, 0x21, 0xa2, 0xb4, 0x35, 0x2a, 0x12, 0xa7, 0x3e, 0x52,
+	0x6c, 0x4a, 0x5a, 0x72, 0x90, 0x99, 0x05, 0x31, 0x41, 0x72, 0xc3, 0xc5, 0x6a, 0x54, 0x25, 0x4e, 0x58, 0x74, 0x40, 0x98, 0xc0, 0x9c, 0x60, 0x71,
+	0x15, 0x00, 0x88, 0x5d, 0x6a, 0xfb, 0xfd, 0xab, 0xff, 0x8b, 0xc8, 0xce, 0x09, 0x06, 0xd5, 0x1a, 0x99, 0x0d, 0x15, 0xa1, 0xa9, 0x50, 0x95, 0x39,
+	0xf2, 0x93, 0x62, 0x52, 0xd3, 0x94, 0x84, 0xc8, 0x29, 0x8a, 0x0b, 0x96, 0x1e, 0x2b, 0x52, 0xa1, 0x2a, 0x72, 0xc3, 0xa2, 0x0d, 0x8b, 0xc8, 0xce,
+	0x09, 0x06, 0xd5, 0x1a, 0x99, 0x0d, 0x15, 0xa1, 0xa9, 0x50, 0x95, 0x39, 0xf2, 0x93, 0x62, 0x52, 0xd3, 0x94, 0x84, 0xc8, 0x29, 0x8a, 0x0b, 0x96,
+	0x00,
+};
+static const u8 chdDVDSources[] = { 0, 1, 0, 3, 4, 5 };
+
+static const u8 chdDVDFlac[] = {
+	0x4d, 0x43, 0x6f, 0x6d, 0x70, 0x72, 0x48, 0x44, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x05, 0x6c, 0x7a, 0x6d, 0x61, 0x7a, 0x6c, 0x69, 0x62,
+	0x68, 0x75, 0x66, 0x66, 0x66, 0x6c, 0x61, 0x63, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7c,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa6, 0xcb, 0x80, 0x10, 0x08, 0x01, 0x00, 0x44, 0x44, 0x44, 0x44,
+	0x44, 0x44, 0x44, 0x44, 0x01, 0x53, 0x40, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+static const u8 chdDVDFlacSources[] = { 0, 1, 0, 3, 4 };
+
+static const u8 chdCDMode1[] = {
+	0x4d, 0x43, 0x6f, 0x6d, 0x70, 0x72, 0x48, 0x44, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x05, 0x63, 0x64, 0x6c, 0x7a, 0x63, 0x64, 0x7a, 0x6c,
+	0x63, 0x64, 0x66, 0x6c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4c, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xb9,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x00, 0x13, 0x20, 0x00, 0x00, 0x09, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x43, 0x48, 0x54, 0x52, 0x01, 0x00, 0x00, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x52, 0x41, 0x43,
+	0x4b, 0x3a, 0x31, 0x20, 0x54, 0x59, 0x50, 0x45, 0x3a, 0x4d, 0x4f, 0x44, 0x45, 0x31, 0x5f, 0x52, 0x41, 0x57, 0x20, 0x53, 0x55, 0x42, 0x54, 0x59,
+	0x50, 0x45, 0x3a, 0x4e, 0x4f, 0x4e, 0x45, 0x20, 0x46, 0x52, 0x41, 0x4d, 0x45, 0x53, 0x3a, 0x37, 0x00, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xde, 0x00, 0x07, 0x10, 0x08, 0x01, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x01, 0x54, 0x03, 0x2f, 0x00, 0x00, 0x02,
+	0x6b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x03, 0x26, 0x00, 0x00, 0x3f, 0xf5, 0x12, 0x17, 0x41, 0xf0, 0x00, 0x8f, 0x85, 0x93, 0x94, 0x1b, 0x96,
+	0x6a, 0x50, 0xac, 0x12, 0x4f, 0x3d, 0x10, 0x15, 0x43, 0x60, 0xf1, 0x95, 0x18, 0xf6, 0x52, 0xd2, 0xd8, 0xee, 0x70, 0xdb, 0x55, 0x7d, 0xba, 0x67,
+	0x90, 0x46, 0xa8, 0x06, 0xd0, 0xe6, 0x6f, 0x7b, 0x59, 0x29, 0x9a, 0x64, 0xc2, 0x61, 0x95, 0xc9, 0x87, 0xf4, 0x0f, 0xc9, 0x95, 0x39, 0x7d, 0x1f,
+	0x14, 0x76, 0x28, 0x0c, 0x7b, 0x9a, 0x03, 0x07, 0x15, 0x63, 0x69, 0xe9, 0x5b, 0xda, 0x2a, 0x20, 0x2c, 0x7f, 0x56, 0x61, 0xb9, 0xd6, 0xa2, 0x3a,
+	0xa0, 0x0d, 0xf4, 0x32, 0x8c, 0xee, 0x33, 0x04, 0x14, 0x1c, 0xb2, 0xbc, 0xea, 0xf9, 0x77, 0x13, 0x12, 0x66, 0xf0, 0xdc, 0x5b, 0x43, 0xff, 0x28,
+	0xe8, 0x25, 0xcb, 0x53, 0x89, 0xbe, 0xed, 0xe9, 0x3f, 0xbd, 0x84, 0x21, 0xc2, 0xea, 0xf0, 0x18, 0x30, 0xca, 0xd6, 0xad, 0x15, 0xf5, 0xf1, 0x4e,
+	0x9c, 0x29, 0xfb, 0xf4, 0x6c, 0x54, 0xa1, 0x9c, 0x78, 0x09, 0x82, 0xf3, 0xb7, 0x2c, 0xd9, 0x6b, 0x39, 0x02, 0xec, 0xa6, 0xbd, 0x56, 0x46, 0x8b,
+	0x73, 0xb6, 0x0a, 0x4f, 0x19, 0x3c, 0x91, 0xc9, 0x94, 0xa4, 0x20, 0x5f, 0x49, 0x1e, 0x3d, 0xa1, 0x72, 0xcc, 0x3b, 0x81, 0xa9, 0x44, 0xe3, 0x89,
+	0x56, 0xd1, 0x8c, 0xe9, 0x1f, 0xa8, 0x19, 0xf6, 0x98, 0x19, 0x7a, 0x21, 0x1e, 0x41, 0xf9, 0x78, 0x1e, 0xe7, 0xdd, 0x11, 0x6e, 0xb9, 0x87, 0xd8,
+	0x7c, 0x32, 0x27, 0x3a, 0x19, 0x05, 0xbf, 0x14, 0x17, 0x7d, 0xc6, 0x35, 0x8c, 0x06, 0x0c, 0xfa, 0xec, 0xad, 0x31, 0x3a, 0x98, 0x7d, 0xcb, 0x59,
+	0x8b, 0x7e, 0x48, 0x24, 0x32, 0x2f, 0x26, 0x47, 0x56, 0xae, 0xde, 0xc7, 0xee, 0x2d, 0x67, 0xb5, 0x9f, 0x39, 0xd7, 0xa7, 0x60, 0xa6, 0x1b, 0xd7,
+	0xec, 0x0b, 0x33, 0xdb, 0xe0, 0x82, 0x30, 0x10, 0x24, 0xbb, 0x87, 0x61, 0xc6, 0xeb, 0xa0, 0x93, 0xc2, 0x50, 0x2a, 0x05, 0x6d, 0xd9, 0x05, 0x11,
+	0x17, 0xd9, 0xb9, 0x74, 0x8a, 0x4a, 0xce, 0x23, 0xfd, 0xcc, 0xa8, 0x7e, 0x6d, 0xb8, 0x00, 0xe0, 0x26, 0x5f, 0xcd, 0x64, 0x2e, 0x12, 0xeb, 0x32,
+	0xad, 0xcd, 0xc0, 0x93, 0x92, 0xf2, 0xc2, 0x89, 0x3f, 0x85, 0xe7, 0xf9, 0xfd, 0xcb, 0xe0, 0x5c, 0xf9, 0x5d, 0xdd, 0x6d, 0x8a, 0x57, 0x71, 0x6d,
+	0xa9, 0x54, 0xd4, 0x3c, 0xfa, 0xac, 0xd5, 0x00, 0x59, 0xa3, 0x9a, 0xc2, 0xd7, 0x7f, 0xdd, 0xe9, 0xcb, 0x63, 0x3f, 0x88, 0x8f, 0x8b, 0x5e, 0x81,
+	0x48, 0x21, 0x21, 0xbe, 0x88, 0xdf, 0xc2, 0xa6, 0xd1, 0x23, 0x38, 0x22, 0xf5, 0x2f, 0x7d, 0x14, 0x5f, 0x92, 0xec, 0x11, 0x6a, 0x97, 0xf0, 0xa2,
+	0x3d, 0xc8, 0xe0, 0x52, 0xce, 0x9a, 0xde, 0xca, 0x0f, 0x70, 0x1a, 0x2b, 0x95, 0x3e, 0x0c, 0x5f, 0x7d, 0xe1, 0xfe, 0x74, 0x7f, 0x19, 0x23, 0x80,
+	0x1d, 0xa2, 0xcc, 0x61, 0xf2, 0x25, 0xa0, 0xee, 0xbe, 0xd4, 0xa6, 0xfc, 0x13, 0x1a, 0xca, 0xd5, 0x75, 0xca, 0x78, 0xb4, 0x4f, 0x71, 0x2a, 0x0f,
+	0xae, 0x6c, 0x5e, 0x43, 0x6f, 0x2c, 0xda, 0x07, 0xf4, 0x06, 0xd0, 0x3e, 0xd2, 0xed, 0xb8, 0x45, 0x0a, 0xbe, 0x81, 0x06, 0x45, 0x4c, 0xb7, 0xb1,
+	0x41, 0x7b, 0xac, 0x2f, 0xdb, 0xd8, 0x51, 0x23, 0x4b, 0xe9, 0xea, 0x89, 0x54, 0x8f, 0x97, 0xf7, 0xbd, 0x74, 0x32, 0x27, 0x2a, 0x99, 0xe9, 0xfc,
+	0xf0, 0x5e, 0xe0, 0x9c, 0x47, 0x8e, 0x81, 0xff, 0x81, 0x89, 0x0c, 0x9a, 0xea, 0xf7, 0xd3, 0x78, 0x03, 0x5b, 0xc0, 0x11, 0xf3, 0x84, 0xa6, 0x33,
+	0x58, 0x60, 0x38, 0xa7, 0x7f, 0xe6, 0xfb, 0x14, 0xc7, 0x09, 0xe6, 0xb4, 0xaf, 0x68, 0x83, 0x9f, 0x30, 0x6c, 0x6a, 0xae, 0x6b, 0xb4, 0x47, 0x44,
+	0x17, 0x92, 0x20, 0x07, 0xb3, 0x24, 0xb8, 0x27, 0xb9, 0xab, 0xbb, 0x22, 0x46, 0xfc, 0x7e, 0x25, 0xc7, 0xd9, 0xec, 0x7b, 0xe9, 0x73, 0x19, 0xc5,
+	0x56, 0xf2, 0xd1, 0xc7, 0xdc, 0x5b, 0x0f, 0xa3, 0x25, 0xa5, 0xfd, 0x48, 0xc9, 0x70, 0x33, 0xa4, 0x6c, 0x4c, 0xf1, 0x73, 0x5e, 0x01, 0x92, 0x4b,
+	0x57, 0x64, 0x88, 0xbf, 0x51, 0x04, 0x58, 0x3e, 0xa1, 0x9f, 0xb6, 0x97, 0x04, 0xe7, 0x44, 0xc0, 0x33, 0x65, 0xde, 0x31, 0x90, 0xfd, 0x3a, 0x76,
+	0xba, 0x22, 0x87, 0x0a, 0x32, 0x88, 0x05, 0x8c, 0x52, 0x21, 0x88, 0xf1, 0xbd, 0xa7, 0x73, 0x06, 0xed, 0x26, 0x10, 0x2f, 0x06, 0x93, 0x6f, 0x2a,
+	0x5f, 0x3e, 0x23, 0x21, 0xcd, 0x0a, 0xf5, 0x70, 0xd7, 0xa5, 0xa5, 0x11, 0xd4, 0x64, 0xd5, 0x18, 0x1a, 0x0d, 0x15, 0xea, 0xa3, 0xf4, 0xe2, 0xfb,
+	0xc5, 0x4f, 0x99, 0x13, 0xb2, 0x33, 0x5f, 0xff, 0x2a, 0x5b, 0xf6, 0x5e, 0x1b, 0x98, 0x4e, 0xf9, 0x66, 0x21, 0x9e, 0x89, 0x96, 0x11, 0x10, 0x51,
+	0x7b, 0x63, 0xc0, 0xdb, 0x69, 0x3e, 0x5f, 0x75, 0xff, 0xb1, 0x98, 0x0b, 0xad, 0x69, 0x1c, 0x78, 0xc3, 0xfc, 0xb6, 0x78, 0x17, 0xc7, 0xec, 0xdd,
+	0xaa, 0x69, 0x56, 0xad, 0xfc, 0xa5, 0x39, 0x82, 0xa2, 0x34, 0x82, 0x71, 0xe8, 0xab, 0x9f, 0x4e, 0xb0, 0xac, 0x16, 0xd8, 0xdf, 0xd3, 0xb7, 0x4d,
+	0x61, 0x1f, 0x05, 0x16, 0x05, 0x29, 0x51, 0x8a, 0x4e, 0xb4, 0x1d, 0xc8, 0xcc, 0xf4, 0xdd, 0xe5, 0x2b, 0x57, 0xcf, 0x95, 0xb1, 0x31, 0xbe, 0x4e,
+	0xd3, 0x98, 0x66, 0x04, 0xe6, 0xcf, 0xab, 0x38, 0x0f, 0xfa, 0x1c, 0x24, 0x04, 0xb3, 0x48, 0xdc, 0x73, 0x5e, 0xca, 0x1f, 0x7c, 0xc6, 0xfe, 0x9d,
+	0x93, 0x79, 0x11, 0x48, 0x5f, 0x0a, 0xff, 0x4c, 0x66, 0x48, 0xd4, 0xcf, 0x96, 0xf7, 0x2b, 0x87, 0x88, 0x0e, 0xb3, 0xd7, 0x61, 0x4c, 0xc9, 0x40,
+	0x1c, 0xb8, 0x61, 0x91, 0x21, 0xec, 0xb5, 0x8b, 0xc1, 0xd0, 0xe7, 0xa7, 0x61, 0xb0, 0x49, 0x7c, 0xb7, 0x74, 0xff, 0x83, 0x49, 0x3d, 0x1a, 0x63,
+	0x60, 0x18, 0xda, 0x00, 0x00, 0x00, 0x02, 0x62, 0xed, 0x56, 0x3b, 0x68, 0x54, 0x51, 0x10, 0xdd, 0xdd, 0x60, 0x91, 0x04, 0x44, 0xec, 0x84, 0x40,
+	0x10, 0x09, 0x18, 0x51, 0xd1, 0x42, 0x24, 0xd8, 0x08, 0x5a, 0x04, 0xd2, 0xa4, 0x08, 0x12, 0x10, 0xc3, 0xce, 0x7f, 0xc0, 0x2a, 0xad, 0x16, 0x2a,
+	0x62, 0x63, 0x93, 0xce, 0x4a, 0x82, 0x60, 0x21, 0xb6, 0x01, 0x0b, 0x85, 0x25, 0x16, 0x7e, 0x40, 0xad, 0xc4, 0xc2, 0x5a, 0x44, 0x50, 0x8b, 0x60,
+	0x25, 0xa8, 0xa0, 0x67, 0x2d, 0x84, 0x35, 0x66, 0xb3, 0xbe, 0x7d, 0xfb, 0xb6, 0xc9, 0x5d, 0xf6, 0x71, 0xdf, 0xbd, 0x33, 0x73, 0x66, 0x86, 0xe1,
+	0x9d, 0x53, 0xfb, 0xf9, 0x67, 0xd5, 0x6a, 0x8d, 0x46, 0x9d, 0xdc, 0x43, 0x88, 0x22, 0x58, 0x35, 0x5d, 0x04, 0x7b, 0xd3, 0x50, 0x72, 0x71, 0x0a,
+	0x16, 0xa6, 0xc4, 0x8f, 0x38, 0x38, 0x85, 0x59, 0xda, 0x16, 0x1a, 0x1c, 0x96, 0xcc, 0x16, 0x14, 0xe9, 0x24, 0x4a, 0x41, 0x82, 0x28, 0x1c, 0x1a,
+	0x86, 0x5d, 0x64, 0xa6, 0xb5, 0x0d, 0x0d, 0xa1, 0x42, 0x8c, 0xd5, 0xd8, 0xc8, 0x0c, 0xb1, 0xba, 0x62, 0x31, 0xc1, 0x2b, 0xd8, 0x99, 0x80, 0x80,
+	0xa0, 0xac, 0xc0, 0x30, 0xd7, 0x64, 0xc0, 0x24, 0x8b, 0x89, 0xe4, 0xc0, 0x3d, 0x4a, 0x4f, 0xb3, 0x7c, 0x97, 0x22, 0xf5, 0x96, 0x80, 0x5b, 0x2c,
+	0x5e, 0x90, 0x8a, 0xb0, 0xa5, 0x12, 0xa5, 0x63, 0x7e, 0x34, 0x53, 0xf1, 0x8c, 0xc0, 0xbd, 0x78, 0xa2, 0xdd, 0x99, 0xb0, 0xc2, 0xd4, 0xc0, 0x0f,
+	0x0e, 0x84, 0x51, 0x71, 0x9c, 0xc0, 0x2a, 0x04, 0x13, 0x85, 0xf8, 0xc6, 0xcc, 0x8e, 0xc9, 0x62, 0x63, 0x60, 0x23, 0x32, 0x27, 0xe1, 0x0c, 0xa8,
+	0x6e, 0x12, 0xf0, 0x70, 0xec, 0x07, 0xf4, 0xd6, 0xcd, 0xa0, 0xba, 0xff, 0x96, 0x37, 0x05, 0x0b, 0x1b, 0x7c, 0xbd, 0xdb, 0x54, 0xf3, 0x63, 0x76,
+	0x6a, 0xf5, 0xea, 0xf4, 0x8d, 0x17, 0x33, 0xb5, 0xd1, 0x33, 0x6b, 0x39, 0x31, 0x32, 0xb3, 0xfe, 0xf1, 0xd9, 0xdb, 0xc9, 0x0b, 0x63, 0xe7, 0xed,
+	0xc0, 0xe8, 0xfc, 0xe1, 0xfb, 0x8f, 0xeb, 0xaf, 0xf7, 0x7d, 0xbe, 0xbc, 0xdc, 0xdc, 0x75, 0xf3, 0xc3, 0xa1, 0xb9, 0x47, 0xaf, 0xde, 0x3d, 0x3c,
+	0x77, 0xed, 0xc1, 0xf8, 0xc5, 0xc9, 0x95, 0xd6, 0xd3, 0xeb, 0x13, 0x63, 0x1b, 0xb3, 0xcf, 0x37, 0x4e, 0xbe, 0x6c, 0x1d, 0xbc, 0x37, 0xfd, 0xe9,
+	0xd8, 0xf8, 0xa9, 0x6f, 0x67, 0xbf, 0xdc, 0x59, 0x6c, 0xde, 0x5d, 0x3b, 0x7e, 0xfa, 0xe8, 0xca, 0x72, 0x73, 0x69, 0xcf, 0x93, 0xef, 0xeb, 0x6f,
+	0x6e, 0xed, 0xbe, 0x7d, 0x62, 0xef, 0x42, 0x63, 0x7e, 0x6a, 0xae, 0x55, 0xbf, 0x74, 0x64, 0xf1, 0xfd, 0x95, 0xaf, 0xfb, 0x17, 0x96, 0xfa, 0x2e,
+	0xb9, 0x8c, 0xa2, 0xaa, 0x0c, 0x5c, 0x30, 0x99, 0x9e, 0xee, 0x86, 0x55, 0xe5, 0xc0, 0xd3, 0xde, 0x06, 0x6b, 0xb3, 0x77, 0x3f, 0x2e, 0x9b, 0xec,
+	0xcb, 0x4e, 0xa5, 0x97, 0xa6, 0xd4, 0x76, 0x56, 0xf7, 0xd5, 0xa1, 0x97, 0x46, 0xea, 0x4a, 0xd0, 0x03, 0xa0, 0xb5, 0x00, 0x1b, 0x81, 0x96, 0x40,
+	0x57, 0xaa, 0x10, 0x41, 0xa0, 0x30, 0x1c, 0x81, 0xfc, 0xa0, 0x7a, 0x40, 0x8f, 0xe2, 0xff, 0xb4, 0x83, 0x78, 0x4a, 0x68, 0x0c, 0x86, 0xa6, 0x80,
+	0xba, 0x00, 0x31, 0x7a, 0x7b, 0xf4, 0x21, 0xa3, 0x14, 0x8a, 0xc3, 0xcd, 0x1d, 0xc6, 0xaa, 0xf8, 0xac, 0xa7, 0xa9, 0x1a, 0x4e, 0x60, 0x05, 0x8a,
+	0x05, 0x39, 0xe2, 0xb3, 0x44, 0xd0, 0x53, 0x0e, 0x69, 0xa5, 0x10, 0x5e, 0x10, 0x59, 0x80, 0x4a, 0x9c, 0xb5, 0xd5, 0x89, 0x3a, 0x38, 0xb1, 0x2d,
+	0x5d, 0x24, 0x1c, 0xc4, 0x0b, 0xf5, 0x25, 0xa4, 0xa6, 0x02, 0xf9, 0x06, 0x44, 0x02, 0x89, 0x22, 0x1a, 0xd8, 0xf5, 0x37, 0x65, 0x2b, 0xd4, 0x1a,
+	0x41, 0xcd, 0x99, 0x0b, 0x92, 0x45, 0x08, 0x30, 0x2a, 0x41, 0xa6, 0x25, 0x01, 0x0a, 0xc4, 0x0b, 0x38, 0x83, 0x6c, 0x93, 0x00, 0x8f, 0x6f, 0x59,
+	0x6b, 0x61, 0xf4, 0x6e, 0x30, 0x43, 0x7e, 0xed, 0xc3, 0xad, 0xb3, 0x96, 0x8a, 0xbb, 0x50, 0x30, 0xff, 0x4a, 0xda, 0x52, 0x30, 0x87, 0x52, 0x9a,
+	0xd4, 0xd7, 0x59, 0x75, 0xe9, 0x0c, 0x21, 0xcb, 0x2a, 0xad, 0x7a, 0x2d, 0xae, 0x14, 0x83, 0xbe, 0xd7, 0x60, 0x4a, 0x2e, 0xbd, 0xf6, 0xb2, 0x33,
+	0xa9, 0x10, 0xb5, 0xf2, 0x1e, 0x75, 0x20, 0xfc, 0xed, 0xfa, 0xff, 0x01, 0x76, 0x04, 0x51, 0xf7, 0xf5, 0x0b, 0x63, 0x60, 0x18, 0xda, 0x00, 0x00,
+};
+static const u8 chdCDMode1Sources[] = { 0, 1, 0, 3 };
+
+static const u8 chdCDMode2[] = {
+	0x4d, 0x43, 0x6f, 0x6d, 0x70, 0x72, 0x48, 0x44, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x05, 0x63, 0x64, 0x6c, 0x7a, 0x63, 0x64, 0x7a, 0x6c,
+	0x63, 0x64, 0x66, 0x6c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x49,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x00, 0x13, 0x20, 0x00, 0x00, 0x09, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x43, 0x48, 0x54, 0x32, 0x01, 0x00, 0x00, 0x52, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xde, 0x54, 0x52, 0x41, 0x43,
+	0x4b, 0x3a, 0x31, 0x20, 0x54, 0x59, 0x50, 0x45, 0x3a, 0x41, 0x55, 0x44, 0x49, 0x4f, 0x20, 0x53, 0x55, 0x42, 0x54, 0x59, 0x50, 0x45, 0x3a, 0x4e,
+	0x4f, 0x4e, 0x45, 0x20, 0x46, 0x52, 0x41, 0x4d, 0x45, 0x53, 0x3a, 0x35, 0x20, 0x50, 0x52, 0x45, 0x47, 0x41, 0x50, 0x3a, 0x30, 0x20, 0x50, 0x47,
+	0x54, 0x59, 0x50, 0x45, 0x3a, 0x4d, 0x4f, 0x44, 0x45, 0x31, 0x20, 0x50, 0x47, 0x53, 0x55, 0x42, 0x3a, 0x52, 0x57, 0x20, 0x50, 0x4f, 0x53, 0x54,
+	0x47, 0x41, 0x50, 0x3a, 0x30, 0x00, 0x43, 0x48, 0x54, 0x32, 0x01, 0x00, 0x00, 0x5b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x52,
+	0x41, 0x43, 0x4b, 0x3a, 0x32, 0x20, 0x54, 0x59, 0x50, 0x45, 0x3a, 0x4d, 0x4f, 0x44, 0x45, 0x32, 0x5f, 0x52, 0x41, 0x57, 0x20, 0x53, 0x55, 0x42,
+	0x54, 0x59, 0x50, 0x45, 0x3a, 0x4e, 0x4f, 0x4e, 0x45, 0x20, 0x46, 0x52, 0x41, 0x4d, 0x45, 0x53, 0x3a, 0x35, 0x20, 0x50, 0x52, 0x45, 0x47, 0x41,
+	0x50, 0x3a, 0x32, 0x20, 0x50, 0x47, 0x54, 0x59, 0x50, 0x45, 0x3a, 0x56, 0x4d, 0x4f, 0x44, 0x45, 0x32, 0x5f, 0x52, 0x41, 0x57, 0x20, 0x50, 0x47,
+	0x53, 0x55, 0x42, 0x3a, 0x52, 0x57, 0x20, 0x50, 0x4f, 0x53, 0x54, 0x47, 0x41, 0x50, 0x3a, 0x30, 0x00, 0x00, 0x00, 0x00, 0x27, 0x00, 0x00, 0x00,
+	0x00, 0x01, 0x80, 0x1b, 0x60, 0x10, 0x08, 0x01, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x10, 0x45, 0x00, 0x10, 0x00,
+	0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x01, 0xef, 0x00, 0x00, 0x00, 0x00, 0x04,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0xed, 0xc1, 0x31, 0x01, 0x00,
+	0x00, 0x00, 0xc2, 0xa0, 0xf5, 0x4f, 0x6d, 0x07, 0x6f, 0xa0, 0x00, 0x00, 0x00, 0x00, 0xe0, 0x37, 0x63, 0x60, 0x18, 0xda, 0x00, 0x00, 0x00, 0x01,
+	0xe6, 0x00, 0x00, 0x3f, 0xf5, 0x12, 0x17, 0x41, 0xf8, 0x7e, 0x61, 0x81, 0x3b, 0x07, 0xc7, 0xbb, 0x91, 0x99, 0xe4, 0x0b, 0xab, 0x53, 0xcf, 0xa1,
+	0x5b, 0x42, 0x92, 0x54, 0xff, 0x2f, 0xc6, 0x57, 0xd9, 0x8e, 0xe7, 0xc9, 0x95, 0xc4, 0xa9, 0xd8, 0xce, 0x84, 0x7d, 0x9f, 0x48, 0x90, 0xf3, 0xef,
+	0x23, 0xb3, 0x38, 0x39, 0x45, 0x8e, 0x29, 0x36, 0xc9, 0x96, 0xa5, 0xa3, 0xfd, 0x72, 0xea, 0xed, 0xad, 0x7d, 0xb9, 0x57, 0x0c, 0x7b, 0x95, 0xe6,
+	0xac, 0x8f, 0x94, 0x6d, 0x69, 0x2c, 0x75, 0x10, 0x0a, 0xa9, 0xab, 0x05, 0x1f, 0x7c, 0x05, 0x08, 0xcb, 0xaf, 0x76, 0xd8, 0x80, 0x1a, 0xfd, 0xfa,
+	0xb5, 0x58, 0x3e, 0x53, 0xd9, 0x06, 0x19, 0xba, 0xf3, 0xed, 0x67, 0x2e, 0x47, 0x28, 0x9e, 0x93, 0x4f, 0x93, 0x6b, 0xd1, 0x22, 0xdb, 0x03, 0x5a,
+	0x6d, 0xfb, 0xb1, 0x20, 0xd6, 0xf7, 0x3b, 0xf4, 0x4f, 0xe0, 0x12, 0x7d, 0x5c, 0x2d, 0x22, 0xd7, 0x14, 0xbd, 0x72, 0x0a, 0x0d, 0xc7, 0xb7, 0x61,
+	0xb5, 0x1c, 0x46, 0xd9, 0x6a, 0x5a, 0xfe, 0x68, 0x89, 0x46, 0x62, 0x9f, 0xb7, 0x86, 0x4e, 0xbd, 0x86, 0x39, 0xfe, 0x11, 0x43, 0xd7, 0x6f, 0xf2,
+	0x49, 0xcb, 0xa6, 0xeb, 0xa9, 0xd0, 0x21, 0xe7, 0x50, 0x0c, 0x69, 0x0f, 0x6c, 0x54, 0xda, 0x41, 0x96, 0xf0, 0x02, 0x26, 0x0d, 0x90, 0xec, 0x21,
+	0xfd, 0x1f, 0xfc, 0x4b, 0x7b, 0x65, 0x26, 0x4c, 0xeb, 0xb7, 0xdf, 0x81, 0x4d, 0x87, 0xa8, 0x3f, 0x66, 0xc6, 0x30, 0x2a, 0x5e, 0xf5, 0xe2, 0xeb,
+	0x86, 0x6e, 0xfc, 0x14, 0x57, 0x1a, 0xe9, 0xf6, 0x54, 0x58, 0x2c, 0x37, 0xf5, 0x8d, 0xee, 0x48, 0x68, 0xa1, 0xe1, 0x7e, 0x33, 0xed, 0xff, 0xff,
+	0xf4, 0x64, 0x28, 0xdf, 0xa7, 0xad, 0x57, 0x0c, 0xff, 0x89, 0x46, 0xb0, 0x94, 0xea, 0x0f, 0xd5, 0xad, 0x6c, 0xbc, 0x3d, 0xdd, 0xd4, 0x10, 0x2b,
+	0xc6, 0xb6, 0x20, 0xe5, 0x08, 0xfb, 0x76, 0xed, 0xd0, 0xb3, 0x74, 0xbb, 0xea, 0x17, 0x38, 0x5a, 0x14, 0x65, 0xda, 0x1f, 0xe4, 0xfe, 0xb8, 0x1d,
+	0x3f, 0xf7, 0xe8, 0xa0, 0x01, 0xc8, 0x0d, 0x84, 0x12, 0x1e, 0x24, 0xea, 0x08, 0x36, 0x1c, 0x29, 0x48, 0xb6, 0xdd, 0xe8, 0x29, 0x3c, 0x23, 0x72,
+	0xd3, 0x6e, 0xc1, 0x19, 0xd1, 0x06, 0xc3, 0xbd, 0x1d, 0x57, 0x44, 0x82, 0x02, 0x2f, 0x96, 0x28, 0x0a, 0x8e, 0x9c, 0x36, 0x09, 0x1c, 0x0c, 0x84,
+	0xd6, 0x2e, 0x8d, 0xf5, 0xb0, 0xc5, 0xfc, 0x0c, 0xea, 0x49, 0xb9, 0x03, 0xc6, 0x50, 0x09, 0x3e, 0x30, 0xde, 0x20, 0x97, 0xf9, 0x61, 0x9a, 0x60,
+	0xdf, 0x78, 0xe0, 0x7b, 0x1b, 0x3d, 0x53, 0x68, 0xac, 0xec, 0x48, 0x32, 0x5d, 0xbb, 0x8b, 0x7f, 0xe2, 0x32, 0xc7, 0x79, 0x70, 0x17, 0x6d, 0xba,
+	0x5e, 0x1c, 0x05, 0xcd, 0xd1, 0x60, 0x2e, 0x69, 0x80, 0xb9, 0x10, 0x9e, 0xbd, 0xb3, 0x90, 0x82, 0x8e, 0x0d, 0x37, 0x59, 0x09, 0xaa, 0x69, 0x31,
+	0x2e, 0x79, 0xf2, 0x3c, 0xc3, 0xd5, 0x2b, 0x70, 0x8d, 0x6c, 0x09, 0x92, 0xf2, 0x8b, 0x3c, 0xed, 0xe9, 0xc5, 0x9b, 0xd8, 0x9e, 0x23, 0x0e, 0x47,
+	0x9f, 0x6c, 0xe8, 0x9a, 0x67, 0x14, 0xb2, 0x74, 0x5b, 0x4c, 0x44, 0x50, 0x5e, 0xac, 0xb5, 0x5a, 0x27, 0xf1, 0xe3, 0x16, 0x39, 0x88, 0x4f, 0xe0,
+	0xee, 0xe3, 0xf7, 0xe2, 0x38, 0xeb, 0x7c, 0x07, 0xd4, 0xfa, 0xe2, 0xed, 0x4c, 0x23, 0xfc, 0x44, 0xb7, 0x11, 0xb8, 0x3b, 0xf7, 0x99, 0x92, 0xf7,
+	0x80, 0x1f, 0xff, 0x3d, 0x05, 0xfa, 0x00, 0x63, 0x60, 0x18, 0xda, 0x00, 0x00,
+};
+static const u8 chdCDMode2Sources[] = { 0, 1, 2, 3, 4, 5, 6, 4 };
+
+static const CHDFixture chdFixtures[] = {
+	{ "DVD", chdDVD, sizeof(chdDVD), 2048, 2, 0, 0, 12, 5, chdDVDSources, sizeof(chdDVDSources) },
+	{ "DVDFlac", chdDVDFlac, sizeof(chdDVDFlac), 2048, 2, 0, 0, 0, 4, chdDVDFlacSources, sizeof(chdDVDFlacSources) },
+	{ "CDMode1", chdCDMode1, sizeof(chdCDMode1), 2448, 2, 16, 0, 7, 3, chdCDMode1Sources, sizeof(chdCDMode1Sources) },
+	{ "CDMode2", chdCDMode2, sizeof(chdCDMode2), 2448, 2, 24, 10, 3, 6, chdCDMode2Sources, sizeof(chdCDMode2Sources) },
+};
@@ -0,0 +1,224 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Common/ColorConv.h"
+#include "Common/CommonTypes.h"
+#include "unittest/UnitTest.h"
+
+namespace Reference {
+
+static int Clamp8(int v) {
+	return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// The same fixed point math, one pixel at a time.
+static void YUVToRGB(u8 y, u8 u, u8 v, int rgb[3]) {
+	int luma = (y - 16) * 74 + 32;
+	rgb[0] = Clamp8((luma + 102 * (v - 128)) >> 6);
+	rgb[1] = Clamp8((luma - 52 * (v - 128) - 25 * (u - 128)) >> 6);
+	rgb[2] = Clamp8((luma + 129 * (u - 128)) >> 6);
+}
+
+static u32 YUVToRGBA8888(u8 y, u8 u, u8 v) {
+	int rgb[3];
+	YUVToRGB(y, u, v, rgb);
+	return rgb[0] | (rgb[1] << 8) | (rgb[2] << 16);
+}
+
+static u16 YUVToRGB565(u8 y, u8 u, u8 v) {
+	int rgb[3];
+	YUVToRGB(y, u, v, rgb);
+	return (rgb[0] >> 3) | ((rgb[1] >> 2) << 5) | ((rgb[2] >> 3) << 11);
+}
+
+static u16 YUVToRGBA5551(u8 y, u8 u, u8 v) {
+	int rgb[3];
+	YUVToRGB(y, u, v, rgb);
+	return (rgb[0] >> 3) | ((rgb[1] >> 3) << 5) | ((rgb[2] >> 3) << 10);
+}
+
+static u16 YUVToRGBA4444(u8 y, u8 u, u8 v) {
+	int rgb[3];
+	YUVToRGB(y, u, v, rgb);
+	return (rgb[0] >> 4) | ((rgb[1] >> 4) << 4) | ((rgb[2] >> 4) << 8);
+}
+
+// The BT.601 limited range formulas, in float.
+static void YUVToRGBFloat(u8 y, u8 u, u8 v, float rgb[3]) {
+	float luma = 1.164f * (y - 16);
+	rgb[0] = luma + 1.596f * (v - 128);
+	rgb[1] = luma - 0.813f * (v - 128) - 0.391f * (u - 128);
+	rgb[2] = luma + 2.018f * (u - 128);
+	for (int i = 0; i < 3; ++i)
+		rgb[i] = rgb[i] < 0.0f ? 0.0f : (rgb[i] > 255.0f ? 255.0f : rgb[i]);
+}
+
+}  // namespace Reference
+
+struct YUVLine {
+	std::vector<u8> y;
+	std::vector<u8> u;
+	std::vector<u8> v;
+
+	void Resize(int width) {
+		y.resize(width);
+		u.resize((width + 1) / 2);
+		v.resize((width + 1) / 2);
+	}
+};
+
+// Fills a line with random values, with runs of the extremes mixed in so clamping gets hit.
+static void RandomLine(TestRandom &rng, YUVLine &line, int width) {
+	line.Resize(width);
+	std::vector<u8> *planes[] = { &line.y, &line.u, &line.v };
+	for (std::vector<u8> *plane : planes) {
+		rng.Fill(plane->data(), plane->size());
+		for (u8 &value : *plane) {
+			int pick = rng.Range(0, 15);
+			if (pick == 0)
+				value = 0;
+			else if (pick == 1)
+				value = 255;
+		}
+	}
+}
+
+template <typename T, typename F, typename R>
+static bool CheckLine(const char *name, F convert, R reference, const YUVLine &line, int width, int offset) {
+	// Start part way into the buffer, so the stores aren't always aligned, and check nothing past the end changed.
+	std::vector<T> dest(width + offset + 4, (T)0xDEADBEEF);
+	convert(&dest[offset], line.y.data(), line.u.data(), line.v.data(), width);
+
+	for (int x = 0; x < width; ++x) {
+		T expected = reference(line.y[x], line.u[x / 2], line.v[x / 2]);
+		if (dest[offset + x] != expected) {
+			printf("%s: width %d, offset %d, pixel %d is %08x, expected %08x (yuv %d %d %d)\n", name, width, offset, x, (u32)dest[offset + x], (u32)expected, line.y[x], line.u[x / 2], line.v[x / 2]);
+			return false;
+		}
+	}
+	for (int i = 0; i < offset; ++i) {
+		if (dest[i] != (T)0xDEADBEEF) {
+			printf("%s: width %d, offset %d, wrote before the start\n", name, width, offset);
+			return false;
+		}
+	}
+	for (int i = width + offset; i < (int)dest.size(); ++i) {
+		if (dest[i] != (T)0xDEADBEEF) {
+			printf("%s: width %d, offset %d, wrote past the end\n", name, width, offset);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool TestYUV420Line(const YUVLine &line, int width, int offset) {
+	RET(CheckLine<u32>("YUV420ToRGBA8888", ConvertYUV420ToRGBA8888, Reference::YUVToRGBA8888, line, width, offset));
+	RET(CheckLine<u16>("YUV420ToRGB565", ConvertYUV420ToRGB565, Reference::YUVToRGB565, line, width, offset));
+	RET(CheckLine<u16>("YUV420ToRGBA5551", ConvertYUV420ToRGBA5551, Reference::YUVToRGBA5551, line, width, offset));
+	RET(CheckLine<u16>("YUV420ToRGBA4444", ConvertYUV420ToRGBA4444, Reference::YUVToRGBA4444, line, width, offset));
+	return true;
+}
+
+// The fixed point math should stay within 2 of the real formulas, rounded, for every input.
+static bool TestYUV420Accuracy() {
+	YUVLine line;
+	line.Resize(256);
+	std::vector<u32> dest(256);
+	float maxError = 0.0f;
+	for (int u = 0; u < 256; ++u) {
+		for (int v = 0; v < 256; ++v) {
+			for (int y = 0; y < 256; ++y) {
+				line.y[y] = (u8)y;
+				line.u[y / 2] = (u8)u;
+				line.v[y / 2] = (u8)v;
+			}
+			ConvertYUV420ToRGBA8888(dest.data(), line.y.data(), line.u.data(), line.v.data(), 256);
+
+			for (int y = 0; y < 256; ++y) {
+				float rgb[3];
+				Reference::YUVToRGBFloat((u8)y, (u8)u, (u8)v, rgb);
+				for (int c = 0; c < 3; ++c) {
+					float error = fabsf((float)((dest[y] >> (c * 8)) & 0xFF) - roundf(rgb[c]));
+					if (error > maxError)
+						maxError = error;
+				}
+				if ((dest[y] >> 24) != 0) {
+					printf("YUV420ToRGBA8888: alpha not zero for yuv %d %d %d\n", y, u, v);
+					return false;
+				}
+			}
+		}
+	}
+
+	if (maxError > 2.0f) {
+		printf("YUV420ToRGBA8888: off by up to %f from BT.601\n", maxError);
+		return false;
+	}
+	return true;
+}
+
+static bool TestYUV420() {
+	TestRandom rng(0x7C0);
+	YUVLine line;
+
+	// Odd widths and anything below a full SIMD block take the scalar tail.
+	for (int width = 1; width <= 70; ++width) {
+		for (int offset = 0; offset < 3; ++offset) {
+			RandomLine(rng, line, width);
+			RET(TestYUV420Line(line, width, offset));
+		}
+	}
+	for (int i = 0; i < 50; ++i) {
+		int width = rng.Range(1, 720);
+		RandomLine(rng, line, width);
+		RET(TestYUV420Line(line, width, rng.Range(0, 3)));
+	}
+
+	RET(TestYUV420Accuracy());
+
+	// A PSP video frame, a line at a time like the media engine does it.
+	const int width = 480, height = 272;
+	RandomLine(rng, line, width);
+	std::vector<u32> dest32(width);
+	std::vector<u16> dest16(width);
+	double rate32 = TimeWorkRate([&]() {
+		for (int y = 0; y < height; ++y)
+			ConvertYUV420ToRGBA8888(dest32.data(), line.y.data(), line.u.data(), line.v.data(), width);
+		return width * height;
+	});
+	double rate16 = TimeWorkRate([&]() {
+		for (int y = 0; y < height; ++y)
+			ConvertYUV420ToRGB565(dest16.data(), line.y.data(), line.u.data(), line.v.data(), width);
+		return width * height;
+	});
+	printf("YUV420 to 8888: %0.1f Mpixels/s, to 565: %0.1f Mpixels/s\n", rate32 / 1000000.0, rate16 / 1000000.0);
+
+	return true;
+}
+
+bool TestColorConv() {
+	// Picks the NEON versions where that's a runtime choice.
+	SetupColorConv();
+
+	RET(TestYUV420());
+	return true;
+}
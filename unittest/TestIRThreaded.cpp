@@ -0,0 +1,77 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+#include <cstdio>
+#include <vector>
+
+#include "Core/MemMap.h"
+#include "Core/MIPS/IR/IRInterpreter.h"
+#include "unittest/IRTestBlocks.h"
+
+// Runs a block the way IRJit::RunThreadedBlock does, without chaining to the next one.
+static u32 RunThreaded(MIPSState *mips, const IRThreadedInst *t) {
+	while (t)
+		t = t->func(mips, t);
+	return mips->pc;
+}
+
+static bool TestThreadedBlock(MIPSState *mips, const IRTestBlock &block, TestRandom &rng) {
+	std::vector<IRThreadedInst> threaded(block.insts.size());
+	IRThreadedDecode(block.insts.data(), (int)block.insts.size(), threaded.data());
+
+	for (int i = 0; i < 4; ++i) {
+		IRTestState initial, expected, actual;
+		initial.Randomize(rng);
+
+		// The dispatcher sets the PC from what the interpreter returns.
+		initial.Apply(mips);
+		mips->pc = IRInterpret(mips, block.insts.data(), (int)block.insts.size());
+		expected.Capture(mips, mips->pc);
+
+		initial.Apply(mips);
+		actual.Capture(mips, RunThreaded(mips, threaded.data()));
+
+		if (!CompareStates("IRThreaded", expected, actual)) {
+			PrintBlock(block);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TestIRThreaded() {
+	// Normally done by IRJit, needed for GetIRMeta().
+	InitIR();
+
+	std::vector<u8> scratch(MEM_SIZE);
+	u8 *oldBase = Memory::base;
+	Memory::base = scratch.data();
+
+	TestRandom rng(0x7EAD);
+	IRTestBlock block;
+
+	bool success = true;
+	const int count = 5000;
+	for (int i = 0; i < count && success; ++i) {
+		GenerateBlock(block, rng);
+		success = TestThreadedBlock(&mipsr4k, block, rng);
+	}
+	if (success)
+		printf("IRThreaded: %d random blocks matched the interpreter\n", count);
+
+	Memory::base = oldBase;
+	return success;
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+#if PPSSPP_ARCH(AMD64)
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/MemMap.h"
+#include "Core/MIPS/MIPS.h"
+#include "Core/MIPS/IR/IRInst.h"
+#include "Core/MIPS/IR/IRInterpreter.h"
+#include "Core/MIPS/x86/IRToX86.h"
+#include "unittest/IRTestBlocks.h"
+
+using namespace MIPSComp;
+
+static bool TestIRBlock(IRToX86 *native, MIPSState *mips, const IRTestBlock &block, TestRandom &rng) {
+	const u8 *code = native->ConvertIRToNative(block.insts.data(), (int)block.insts.size());
+	if (!code) {
+		native->ClearCache();
+		code = native->ConvertIRToNative(block.insts.data(), (int)block.insts.size());
+	}
+	if (!code) {
+		printf("IRToX86: failed to compile a block of %d instructions\n", (int)block.insts.size());
+		return false;
+	}
+
+	for (int i = 0; i < 4; ++i) {
+		IRTestState initial, expected, actual;
+		initial.Randomize(rng);
+
+		initial.Apply(mips);
+		expected.Capture(mips, IRInterpret(mips, block.insts.data(), (int)block.insts.size()));
+
+		initial.Apply(mips);
+		actual.Capture(mips, native->GetEnterFunc()(mips, code));
+
+		if (!CompareStates("IRToX86", expected, actual)) {
+			PrintBlock(block);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TestIRToX86() {
+	// Normally done by IRJit, needed for GetIRMeta().
+	InitIR();
+
+	// The native code embeds Memory::base, so point it at scratch memory before creating it.
+	std::vector<u8> scratch(MEM_SIZE);
+	u8 *oldBase = Memory::base;
+	Memory::base = scratch.data();
+
+	IRToX86 *native = new IRToX86();
+	TestRandom rng(0x1287);
+	IRTestBlock block;
+
+	bool success = true;
+	const int count = 5000;
+	for (int i = 0; i < count && success; ++i) {
+		GenerateBlock(block, rng);
+		success = TestIRBlock(native, &mipsr4k, block, rng);
+	}
+	if (success)
+		printf("IRToX86: %d random blocks matched the interpreter\n", count);
+
+	delete native;
+	Memory::base = oldBase;
+	return success;
+}
+
+#endif
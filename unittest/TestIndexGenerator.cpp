@@ -0,0 +1,262 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstdio>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "GPU/ge_constants.h"
+#include "GPU/Common/IndexGenerator.h"
+#include "unittest/UnitTest.h"
+
+// Straightforward versions of the index generation, one index at a time.
+namespace Reference {
+
+static void AddPrim(std::vector<u16> &out, int index, int prim, int count, bool clockwise) {
+	const int v1 = clockwise ? 1 : 2;
+	const int v2 = clockwise ? 2 : 1;
+	switch (prim) {
+	case GE_PRIM_POINTS:
+		for (int i = 0; i < count; i++)
+			out.push_back(index + i);
+		break;
+	case GE_PRIM_LINES:
+		for (int i = 0; i < count; i += 2) {
+			out.push_back(index + i);
+			out.push_back(index + i + 1);
+		}
+		break;
+	case GE_PRIM_LINE_STRIP:
+		for (int i = 0; i < count - 1; i++) {
+			out.push_back(index + i);
+			out.push_back(index + i + 1);
+		}
+		break;
+	case GE_PRIM_TRIANGLES:
+		for (int i = 0; i < count; i += 3) {
+			out.push_back(index + i);
+			out.push_back(index + i + v1);
+			out.push_back(index + i + v2);
+		}
+		break;
+	case GE_PRIM_TRIANGLE_STRIP:
+	{
+		int wind = clockwise ? 1 : 2;
+		for (int i = 0; i < count - 2; i++) {
+			out.push_back(index + i);
+			out.push_back(index + i + wind);
+			wind ^= 3;
+			out.push_back(index + i + wind);
+		}
+		break;
+	}
+	case GE_PRIM_TRIANGLE_FAN:
+		for (int i = 0; i < count - 2; i++) {
+			out.push_back(index);
+			out.push_back(index + i + v1);
+			out.push_back(index + i + v2);
+		}
+		break;
+	case GE_PRIM_RECTANGLES:
+		for (int i = 0; i < (count & ~1); i++)
+			out.push_back(index + i);
+		break;
+	}
+}
+
+template <class T>
+static void TranslatePrim(std::vector<u16> &out, int offset, int prim, int count, const T *inds, bool clockwise) {
+	const int v1 = clockwise ? 1 : 2;
+	const int v2 = clockwise ? 2 : 1;
+	switch (prim) {
+	case GE_PRIM_POINTS:
+		for (int i = 0; i < count; i++)
+			out.push_back(offset + inds[i]);
+		break;
+	case GE_PRIM_LINES:
+	case GE_PRIM_RECTANGLES:
+		for (int i = 0; i < (count & ~1); i++)
+			out.push_back(offset + inds[i]);
+		break;
+	case GE_PRIM_LINE_STRIP:
+		for (int i = 0; i < count - 1; i++) {
+			out.push_back(offset + inds[i]);
+			out.push_back(offset + inds[i + 1]);
+		}
+		break;
+	case GE_PRIM_TRIANGLES:
+		for (int i = 0; i < count / 3 * 3; i += 3) {
+			out.push_back(offset + inds[i]);
+			out.push_back(offset + inds[i + v1]);
+			out.push_back(offset + inds[i + v2]);
+		}
+		break;
+	case GE_PRIM_TRIANGLE_STRIP:
+	{
+		int wind = clockwise ? 1 : 2;
+		for (int i = 0; i < count - 2; i++) {
+			out.push_back(offset + inds[i]);
+			out.push_back(offset + inds[i + wind]);
+			wind ^= 3;
+			out.push_back(offset + inds[i + wind]);
+		}
+		break;
+	}
+	case GE_PRIM_TRIANGLE_FAN:
+		for (int i = 0; i < count - 2; i++) {
+			out.push_back(offset + inds[0]);
+			out.push_back(offset + inds[i + v1]);
+			out.push_back(offset + inds[i + v2]);
+		}
+		break;
+	}
+}
+
+}  // namespace Reference
+
+static const char *const primNames[] = { "points", "lines", "line strip", "triangles", "triangle strip", "triangle fan", "rectangles" };
+
+// Generous, since the generator may write a chunk past the end.
+static const int MAX_INDICES = 128 * 1024;
+
+static bool CompareIndices(const char *what, int prim, const std::vector<u16> &expected, const u16 *actual, int actualCount) {
+	if ((int)expected.size() != actualCount) {
+		printf("IndexGenerator %s %s: %d indices, expected %d\n", what, primNames[prim], actualCount, (int)expected.size());
+		return false;
+	}
+	for (int i = 0; i < actualCount; i++) {
+		if (expected[i] != actual[i]) {
+			printf("IndexGenerator %s %s: index %d of %d is %d, expected %d\n", what, primNames[prim], i, actualCount, actual[i], expected[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+template <class T>
+static bool TestTranslate(TestRandom &rng, std::vector<u16> &buffer) {
+	IndexGenerator gen;
+	std::vector<T> src(1024);
+	for (int prim = GE_PRIM_POINTS; prim <= GE_PRIM_RECTANGLES; prim++) {
+		for (int count : { 0, 1, 2, 3, 4, 5, 7, 17, 33, 100, 1024 }) {
+			for (bool clockwise : { true, false }) {
+				for (T &ind : src)
+					ind = (T)(rng.Next() & 0xFF);
+				gen.Setup(buffer.data());
+
+				std::vector<u16> expected;
+				// Translate twice, so the second one gets a nonzero offset.
+				int firstOffset = 0;
+				Reference::TranslatePrim(expected, -firstOffset, prim, count, src.data(), clockwise);
+				gen.TranslatePrim(prim, count, src.data(), firstOffset, clockwise);
+				gen.Advance(256);
+
+				int secondOffset = 3;
+				Reference::TranslatePrim(expected, 256 - secondOffset, prim, count, src.data(), clockwise);
+				gen.TranslatePrim(prim, count, src.data(), secondOffset, clockwise);
+
+				if (!CompareIndices("translate", prim, expected, buffer.data(), (int)expected.size()))
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool TestAddPrims(std::vector<u16> &buffer) {
+	IndexGenerator gen;
+	for (int prim = GE_PRIM_POINTS; prim <= GE_PRIM_RECTANGLES; prim++) {
+		for (int count = 0; count <= 60; count++) {
+			for (bool clockwise : { true, false }) {
+				gen.Setup(buffer.data());
+				std::vector<u16> expected;
+				// Rectangles drop an odd vertex entirely.
+				int used1 = prim == GE_PRIM_RECTANGLES ? (count & ~1) : count;
+				int used2 = prim == GE_PRIM_RECTANGLES ? ((count + 1) & ~1) : count + 1;
+				// Two draws in a row, as when merging.
+				Reference::AddPrim(expected, 0, prim, count, clockwise);
+				gen.AddPrim(prim, count, clockwise);
+				Reference::AddPrim(expected, used1, prim, count + 1, clockwise);
+				gen.AddPrim(prim, count + 1, clockwise);
+
+				if (gen.MaxIndex() != used1 + used2) {
+					printf("IndexGenerator add %s: next index %d, expected %d\n", primNames[prim], gen.MaxIndex(), used1 + used2);
+					return false;
+				}
+				if (!CompareIndices("add", prim, expected, buffer.data(), (int)expected.size()))
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Indices per second, in millions.
+template <typename F>
+static double TimeIndices(F func) {
+	return TimeWorkRate([&] {
+		int total = 0;
+		for (int i = 0; i < 64; ++i)
+			total += func();
+		return total;
+	}) / 1000000.0;
+}
+
+bool TestIndexGenerator() {
+	std::vector<u16> buffer(MAX_INDICES);
+	TestRandom rng(0x1DE5);
+
+	if (!TestAddPrims(buffer))
+		return false;
+	if (!TestTranslate<u8>(rng, buffer))
+		return false;
+	if (!TestTranslate<u16>(rng, buffer))
+		return false;
+	if (!TestTranslate<u32>(rng, buffer))
+		return false;
+
+	// A stream of typical small draws, as merged into one batch.
+	IndexGenerator gen;
+	std::vector<u8> inds8(1024);
+	std::vector<u16> inds16(1024);
+	for (int i = 0; i < 1024; i++) {
+		inds8[i] = (u8)(rng.Next() & 0xFF);
+		inds16[i] = (u16)(rng.Next() & 0xFFFF);
+	}
+	for (int prim = GE_PRIM_POINTS; prim <= GE_PRIM_RECTANGLES; prim++) {
+		double added = TimeIndices([&]() {
+			gen.Setup(buffer.data());
+			for (int i = 0; i < 64; i++)
+				gen.AddPrim(prim, 300, true);
+			return gen.VertexCount();
+		});
+		double translated8 = TimeIndices([&]() {
+			gen.Setup(buffer.data());
+			for (int i = 0; i < 32; i++)
+				gen.TranslatePrim(prim, 1024, inds8.data(), 0, true);
+			return gen.VertexCount();
+		});
+		double translated16 = TimeIndices([&]() {
+			gen.Setup(buffer.data());
+			for (int i = 0; i < 32; i++)
+				gen.TranslatePrim(prim, 1024, inds16.data(), 0, true);
+			return gen.VertexCount();
+		});
+		printf("IndexGenerator %s: %0.1f Minds/s generated, %0.1f Minds/s from u8, %0.1f Minds/s from u16\n", primNames[prim], added, translated8, translated16);
+	}
+	return true;
+}
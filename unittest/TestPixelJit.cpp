@@ -0,0 +1,234 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "GPU/ge_constants.h"
+#include "GPU/Math3D.h"
+#include "GPU/Software/DrawPixel.h"
+#include "GPU/Software/SoftGpu.h"
+#include "unittest/UnitTest.h"
+
+using namespace Math3D;
+
+static const int BUF_STRIDE = 16;
+static const int BUF_HEIGHT = 8;
+
+// Mostly what the jit handles, with the rest mixed in so those keep falling back.
+static PixelFuncID RandomPixelFuncID(TestRandom &rng) {
+	PixelFuncID id;
+	id.applyDepthRange = rng.Range(0, 1) != 0;
+	id.colorTest = rng.Range(0, 2) == 0;
+	id.depthWrite = rng.Range(0, 1) != 0;
+	id.applyFog = rng.Range(0, 2) == 0;
+	id.alphaBlend = rng.Range(0, 1) != 0;
+	id.dithering = rng.Range(0, 2) == 0;
+	id.applyColorWriteMask = rng.Range(0, 3) == 0;
+	id.clearMode = rng.Range(0, 15) == 0;
+	id.stencilTest = rng.Range(0, 15) == 0;
+	id.applyLogicOp = rng.Range(0, 15) == 0;
+
+	static const GEBufferFormat formats[] = { GE_FORMAT_8888, GE_FORMAT_565, GE_FORMAT_8888, GE_FORMAT_565, GE_FORMAT_5551, GE_FORMAT_4444 };
+	id.fbFormat = formats[rng.Range(0, 5)];
+	id.alphaTestFunc = rng.Range(0, 1) ? GE_COMP_ALWAYS : rng.Range(0, 7);
+	id.depthTestFunc = rng.Range(0, 1) ? GE_COMP_ALWAYS : rng.Range(0, 7);
+	// ComputePixelFuncID leaves colorTest off for ALWAYS.
+	static const GEComparison colorFuncs[] = { GE_COMP_NEVER, GE_COMP_EQUAL, GE_COMP_NOTEQUAL };
+	id.colorTestFunc = id.colorTest ? colorFuncs[rng.Range(0, 2)] : 0;
+	if (id.stencilTest) {
+		id.stencilTestFunc = rng.Range(0, 7);
+		id.sFail = rng.Range(0, 5);
+		id.zFail = rng.Range(0, 5);
+		id.zPass = rng.Range(0, 5);
+	}
+	if (id.alphaBlend) {
+		id.alphaBlendEq = rng.Range(0, 7) == 0 ? rng.Range(3, 5) : rng.Range(0, 2);
+		// Past 10 act as the fixed colors.
+		id.alphaBlendSrc = rng.Range(0, 11);
+		id.alphaBlendDst = rng.Range(0, 11);
+	}
+	if (id.applyLogicOp)
+		id.logicOp = rng.Range(0, 15);
+	if (id.clearMode) {
+		id.alphaTestFunc = GE_COMP_ALWAYS;
+		id.depthTestFunc = GE_COMP_ALWAYS;
+	}
+
+	// Set up the way ComputePixelFuncID does it.
+	id.cached.colorTestMask = rng.Next();
+	id.cached.colorTestRef = rng.Next() & id.cached.colorTestMask;
+	id.cached.colorWriteMask = id.applyColorWriteMask ? rng.Next() | (rng.Next() << 24) : 0;
+	id.cached.fogColor = rng.Next();
+	id.cached.fixA = rng.Next();
+	id.cached.fixB = rng.Next();
+	id.cached.framebufStride = BUF_STRIDE;
+	id.cached.depthbufStride = BUF_STRIDE;
+	id.cached.minz = (u16)rng.Range(0, 0x8000);
+	id.cached.maxz = (u16)rng.Range(id.cached.minz, 0xFFFF);
+	id.cached.alphaTestMask = rng.Range(0, 3) == 0 ? (u8)rng.Next() : 0xFF;
+	id.cached.alphaTestRef = (u8)rng.Next() & id.cached.alphaTestMask;
+	id.cached.stencilTestMask = (u8)rng.Next();
+	id.cached.stencilRef = (u8)rng.Next();
+	id.cached.stencilTestRef = id.cached.stencilRef & id.cached.stencilTestMask;
+	id.cached.stencilWriteMask = (u8)rng.Next();
+	for (int i = 0; i < 16; ++i)
+		id.cached.ditherMatrix[i] = (s8)rng.Range(-4, 3);
+	return id;
+}
+
+// Mostly in range, but sometimes past either end to check the clamping.
+static int RandomComponent(TestRandom &rng) {
+	int pick = rng.Range(0, 7);
+	if (pick == 0)
+		return rng.Range(-300, -1);
+	if (pick == 1)
+		return rng.Range(256, 600);
+	return rng.Range(0, 255);
+}
+
+static bool TestPixelFuncID(Rasterizer::PixelJitCache *cache, TestRandom &rng, const PixelFuncID &id, bool *compiled) {
+	Rasterizer::SingleFunc jitted = cache->GetSingle(id);
+	*compiled = jitted != nullptr;
+	if (!jitted)
+		return true;
+	Rasterizer::SingleFunc interpreted = Rasterizer::GetSingleFuncInterpreted(id);
+
+	const size_t bufSize = BUF_STRIDE * BUF_HEIGHT * 4;
+	std::vector<u8> fbInitial(bufSize), depthInitial(bufSize);
+	std::vector<u8> fbJit(bufSize), depthJit(bufSize);
+	std::vector<u8> fbInterp(bufSize), depthInterp(bufSize);
+
+	for (int i = 0; i < 64; ++i) {
+		rng.Fill(fbInitial.data(), bufSize);
+		rng.Fill(depthInitial.data(), bufSize);
+		fbJit = fbInitial;
+		depthJit = depthInitial;
+		fbInterp = fbInitial;
+		depthInterp = depthInitial;
+
+		int x = rng.Range(0, BUF_STRIDE - 1);
+		int y = rng.Range(0, BUF_HEIGHT - 1);
+		// Sometimes exactly the depth range or the old depth, to hit the equal cases.
+		int z = rng.Range(0, 0xFFFF);
+		if (rng.Range(0, 7) == 0)
+			z = rng.Range(0, 1) ? id.cached.minz : id.cached.maxz;
+		else if (rng.Range(0, 7) == 0)
+			z = depthInitial[(y * BUF_STRIDE + x) * 2] | (depthInitial[(y * BUF_STRIDE + x) * 2 + 1] << 8);
+		int fog = rng.Range(0, 255);
+		Vec4<int> color(RandomComponent(rng), RandomComponent(rng), RandomComponent(rng), RandomComponent(rng));
+		if (rng.Range(0, 7) == 0)
+			color.a() = id.cached.alphaTestRef;
+
+		fb.data = fbInterp.data();
+		depthbuf.data = depthInterp.data();
+		interpreted(x, y, z, fog, color, id);
+
+		fb.data = fbJit.data();
+		depthbuf.data = depthJit.data();
+		jitted(x, y, z, fog, color, id);
+
+		if (fbJit != fbInterp || depthJit != depthInterp) {
+			std::string name = cache->DescribePixelFuncID(id);
+			printf("Pixel jit: %s differs at %d,%d z=%04x fog=%d color=%d,%d,%d,%d\n", name.c_str(), x, y, z, fog, color.r(), color.g(), color.b(), color.a());
+			int bpp = id.FBFormat() == GE_FORMAT_8888 ? 4 : 2;
+			int offset = (y * BUF_STRIDE + x) * bpp;
+			u32 before = 0, jit = 0, interp = 0;
+			memcpy(&before, &fbInitial[offset], bpp);
+			memcpy(&jit, &fbJit[offset], bpp);
+			memcpy(&interp, &fbInterp[offset], bpp);
+			printf("  color from %08x: jit %08x, expected %08x\n", before, jit, interp);
+			offset = (y * BUF_STRIDE + x) * 2;
+			u16 depthBefore, depthJitValue, depthInterpValue;
+			memcpy(&depthBefore, &depthInitial[offset], 2);
+			memcpy(&depthJitValue, &depthJit[offset], 2);
+			memcpy(&depthInterpValue, &depthInterp[offset], 2);
+			printf("  depth from %04x: jit %04x, expected %04x\n", depthBefore, depthJitValue, depthInterpValue);
+			return false;
+		}
+	}
+	return true;
+}
+
+// One common case, blended 8888 with a depth test.
+static void TimePixelFuncs(Rasterizer::PixelJitCache *cache, TestRandom &rng) {
+	PixelFuncID id = RandomPixelFuncID(rng);
+	id.clearMode = false;
+	id.stencilTest = false;
+	id.applyLogicOp = false;
+	id.colorTest = false;
+	id.fbFormat = GE_FORMAT_8888;
+	id.alphaTestFunc = GE_COMP_ALWAYS;
+	id.depthTestFunc = GE_COMP_GEQUAL;
+	id.alphaBlend = true;
+	id.alphaBlendEq = GE_BLENDMODE_MUL_AND_ADD;
+	id.alphaBlendSrc = GE_SRCBLEND_SRCALPHA;
+	id.alphaBlendDst = GE_DSTBLEND_INVSRCALPHA;
+
+	Rasterizer::SingleFunc jitted = cache->GetSingle(id);
+	Rasterizer::SingleFunc interpreted = Rasterizer::GetSingleFuncInterpreted(id);
+	if (!jitted)
+		return;
+
+	std::vector<u8> fbData(BUF_STRIDE * BUF_HEIGHT * 4), depthData(BUF_STRIDE * BUF_HEIGHT * 4);
+	rng.Fill(fbData.data(), fbData.size());
+	memset(depthData.data(), 0, depthData.size());
+	fb.data = fbData.data();
+	depthbuf.data = depthData.data();
+
+	auto drawAll = [&](Rasterizer::SingleFunc func) {
+		Vec4<int> color(200, 100, 50, 128);
+		for (int y = 0; y < BUF_HEIGHT; ++y) {
+			for (int x = 0; x < BUF_STRIDE; ++x)
+				func(x, y, 0x1234, 128, color, id);
+		}
+		return BUF_STRIDE * BUF_HEIGHT;
+	};
+	double jitRate = TimeWorkRate([&]() { return drawAll(jitted); });
+	double interpRate = TimeWorkRate([&]() { return drawAll(interpreted); });
+	printf("Pixel jit: %0.1f Mpixels/s, interpreted: %0.1f Mpixels/s\n", jitRate / 1000000.0, interpRate / 1000000.0);
+}
+
+bool TestPixelJit() {
+	u8 *oldFb = fb.data;
+	u8 *oldDepth = depthbuf.data;
+
+	Rasterizer::PixelJitCache *cache = new Rasterizer::PixelJitCache();
+	TestRandom rng(0x91E1);
+
+	bool success = true;
+	int compiledCount = 0;
+	const int count = 3000;
+	for (int i = 0; i < count && success; ++i) {
+		PixelFuncID id = RandomPixelFuncID(rng);
+		bool compiled = false;
+		success = TestPixelFuncID(cache, rng, id, &compiled);
+		if (compiled)
+			compiledCount++;
+	}
+	if (success) {
+		printf("Pixel jit: %d of %d random IDs compiled and matched\n", compiledCount, count);
+		TimePixelFuncs(cache, rng);
+	}
+
+	delete cache;
+	fb.data = oldFb;
+	depthbuf.data = oldDepth;
+	return success;
+}
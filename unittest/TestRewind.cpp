@@ -0,0 +1,216 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/Util/RewindMemory.h"
+#include "unittest/UnitTest.h"
+
+static const u32 PAGE_SIZE = RewindMemory::PAGE_SIZE;
+// Same as rewind itself.
+static const int MAX_SNAPSHOTS = 20;
+
+// Like RAM, VRAM and scratchpad, but smaller.
+struct TestMemory {
+	std::vector<u8> regions[3];
+
+	TestMemory() {
+		regions[0].resize(96 * PAGE_SIZE);
+		regions[1].resize(8 * PAGE_SIZE);
+		regions[2].resize(1 * PAGE_SIZE);
+	}
+
+	std::vector<RewindMemory::Region> Regions() {
+		std::vector<RewindMemory::Region> result;
+		for (std::vector<u8> &region : regions)
+			result.push_back({ region.data(), (u32)region.size() });
+		return result;
+	}
+
+	std::vector<u8> Contents() const {
+		std::vector<u8> result;
+		for (const std::vector<u8> &region : regions)
+			result.insert(result.end(), region.begin(), region.end());
+		return result;
+	}
+};
+
+// Changes a few pages, like a frame or so of a game would.  Some compress well, some don't.
+static void ChangeMemory(TestRandom &rng, TestMemory &memory) {
+	int count = rng.Range(0, 8);
+	for (int i = 0; i < count; ++i) {
+		std::vector<u8> &region = memory.regions[rng.Range(0, 7) == 0 ? rng.Range(1, 2) : 0];
+		u32 offset = rng.Range(0, (int)(region.size() - 1));
+		u32 size = std::min((u32)rng.Range(1, PAGE_SIZE * 2), (u32)region.size() - offset);
+		if (rng.Range(0, 1))
+			rng.Fill(&region[offset], size);
+		else
+			memset(&region[offset], rng.Range(0, 255), size);
+	}
+}
+
+static bool CheckContents(const TestMemory &memory, const std::vector<u8> &expected, int index) {
+	std::vector<u8> contents = memory.Contents();
+	if (contents != expected) {
+		size_t diff = 0;
+		while (contents[diff] == expected[diff])
+			++diff;
+		printf("Rewind: snapshot %d differs at offset %08x (page %d)\n", index, (u32)diff, (int)(diff / PAGE_SIZE));
+		return false;
+	}
+	return true;
+}
+
+// Saves well past the limit, then restores each of the ones that should be kept, newest first.
+static bool TestRewindPastLimit() {
+	TestRandom rng(0x8E41);
+	TestMemory memory;
+	RewindMemory rewind(MAX_SNAPSHOTS);
+	rewind.SetRegions(memory.Regions());
+	rng.Fill(memory.regions[0].data(), memory.regions[0].size() / 2);
+
+	const int count = MAX_SNAPSHOTS * 4 + 7;
+	std::deque<std::vector<u8>> expected;
+	for (int i = 0; i < count; ++i) {
+		ChangeMemory(rng, memory);
+		rewind.Push();
+		expected.push_back(memory.Contents());
+		if ((int)expected.size() > MAX_SNAPSHOTS)
+			expected.pop_front();
+		EXPECT_EQ_INT(rewind.Count(), (int)expected.size());
+	}
+
+	// Deltas should be compressed, and hold only what changed.
+	size_t raw = expected.back().size() * (MAX_SNAPSHOTS - 1);
+	if (rewind.DeltaBytes() * 4 > raw) {
+		printf("Rewind: %d bytes of deltas, for %d bytes of memory\n", (int)rewind.DeltaBytes(), (int)raw);
+		return false;
+	}
+
+	for (int i = 0; i < MAX_SNAPSHOTS; ++i) {
+		// Scribble over everything, it all has to come back.
+		ChangeMemory(rng, memory);
+		EXPECT_TRUE(rewind.Pop(true));
+		RET(CheckContents(memory, expected.back(), count - 1 - i));
+		expected.pop_back();
+	}
+	EXPECT_EQ_INT(rewind.Count(), 0);
+	EXPECT_FALSE(rewind.Pop(true));
+	return true;
+}
+
+// Saving and rewinding mixed together, the way it happens in a game.
+static bool TestRewindMixed() {
+	TestRandom rng(0x2231);
+	TestMemory memory;
+	RewindMemory rewind(MAX_SNAPSHOTS);
+	rewind.SetRegions(memory.Regions());
+
+	std::deque<std::vector<u8>> expected;
+	for (int i = 0; i < 2000; ++i) {
+		int action = rng.Range(0, 9);
+		if (action < 6) {
+			ChangeMemory(rng, memory);
+			rewind.Push();
+			expected.push_back(memory.Contents());
+			if ((int)expected.size() > MAX_SNAPSHOTS)
+				expected.pop_front();
+		} else if (action < 8) {
+			bool restore = action == 6 || rng.Range(0, 3) != 0;
+			EXPECT_EQ_INT((int)rewind.Pop(restore), (int)!expected.empty());
+			if (!expected.empty()) {
+				if (restore)
+					RET(CheckContents(memory, expected.back(), i));
+				expected.pop_back();
+			}
+		} else if (action == 8) {
+			rewind.DropOldest();
+			if (!expected.empty())
+				expected.pop_front();
+		} else {
+			ChangeMemory(rng, memory);
+		}
+		EXPECT_EQ_INT(rewind.Count(), (int)expected.size());
+	}
+
+	while (!expected.empty()) {
+		EXPECT_TRUE(rewind.Pop(true));
+		RET(CheckContents(memory, expected.back(), (int)expected.size()));
+		expected.pop_back();
+	}
+
+	// A different layout can't use the old snapshots.
+	rewind.Push();
+	memory.regions[0].resize(memory.regions[0].size() + PAGE_SIZE);
+	rewind.SetRegions(memory.Regions());
+	EXPECT_EQ_INT(rewind.Count(), 0);
+	return true;
+}
+
+// Older snapshots keep what pages were before, so a cleared block should be cheap to keep.
+static bool TestRewindCompressed() {
+	TestRandom rng(0x51);
+	TestMemory memory;
+	RewindMemory rewind(MAX_SNAPSHOTS);
+	rewind.SetRegions(memory.Regions());
+	rewind.Push();
+
+	const u32 size = 32 * PAGE_SIZE;
+	rng.Fill(memory.regions[0].data(), size);
+	rewind.Push();
+	if (rewind.DeltaBytes() > size / 16) {
+		printf("Rewind: %d bytes kept for %d bytes of zeros\n", (int)rewind.DeltaBytes(), (int)size);
+		return false;
+	}
+
+	EXPECT_TRUE(rewind.Pop(true));
+	EXPECT_TRUE(rewind.Pop(true));
+	std::vector<u8> zeros(size);
+	EXPECT_TRUE(memcmp(memory.regions[0].data(), zeros.data(), size) == 0);
+	return true;
+}
+
+// About what rewind takes each second, 32MB of RAM with a few hundred pages changed.
+static void TimeRewind() {
+	TestRandom rng(0x99);
+	std::vector<u8> ram(32 * 1024 * 1024);
+	rng.Fill(ram.data(), ram.size() / 64);
+	RewindMemory rewind(MAX_SNAPSHOTS);
+	rewind.SetRegions({ { ram.data(), (u32)ram.size() } });
+	rewind.Push();
+
+	double rate = TimeWorkRate([&]() {
+		for (int i = 0; i < 300; ++i)
+			ram[rng.Range(0, (int)(ram.size() / PAGE_SIZE) - 1) * PAGE_SIZE] ^= 1;
+		rewind.Push();
+		return 1;
+	}, 0.2);
+	printf("Rewind: %0.1f snapshots/s of 32MB, %d KB kept\n", rate, (int)(rewind.DeltaBytes() / 1024));
+}
+
+bool TestRewind() {
+	RET(TestRewindPastLimit());
+	RET(TestRewindMixed());
+	RET(TestRewindCompressed());
+	TimeRewind();
+	return true;
+}
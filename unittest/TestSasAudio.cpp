@@ -0,0 +1,426 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/MemMap.h"
+#include "Core/HW/SasAudio.h"
+#include "Core/Util/AudioFormat.h"
+#include "unittest/UnitTest.h"
+
+// The envelope as SasInstance used to step it, one sample at a time.
+namespace Reference {
+
+class Envelope {
+public:
+	Envelope(const ADSREnvelope &params) : p_(params) {}
+
+	void KeyOn() { state_ = KEYON; }
+	void KeyOff() { SetState(RELEASE); }
+	void End() {
+		SetState(OFF);
+		height_ = 0;
+	}
+
+	bool NeedsKeyOn() const { return state_ == KEYON; }
+	bool HasEnded() const { return state_ == OFF; }
+
+	int Height15() const {
+		s64 h = std::min(height_, (s64)PSP_SAS_ENVELOPE_HEIGHT_MAX);
+		return ((int)h + (1 << 14)) >> 15;
+	}
+
+	void Step() {
+		switch (state_) {
+		case ATTACK:
+			Walk(p_.attackType, p_.attackRate);
+			if (height_ >= PSP_SAS_ENVELOPE_HEIGHT_MAX || height_ < 0)
+				SetState(DECAY);
+			break;
+		case DECAY:
+			Walk(p_.decayType, p_.decayRate);
+			if (height_ < p_.sustainLevel)
+				SetState(SUSTAIN);
+			break;
+		case SUSTAIN:
+			Walk(p_.sustainType, p_.sustainRate);
+			if (height_ <= 0) {
+				height_ = 0;
+				SetState(RELEASE);
+			}
+			break;
+		case RELEASE:
+			Walk(p_.releaseType, p_.releaseRate);
+			if (height_ <= 0) {
+				height_ = 0;
+				SetState(OFF);
+			}
+			break;
+		case OFF:
+			break;
+		case KEYON:
+			height_ = 0;
+			SetState(KEYON_STEP);
+			break;
+		case KEYON_STEP:
+			height_++;
+			if (height_ >= 31) {
+				height_ = 0;
+				SetState(ATTACK);
+			}
+			break;
+		}
+	}
+
+private:
+	enum State { KEYON_STEP, KEYON, OFF, ATTACK, DECAY, SUSTAIN, RELEASE };
+
+	void SetState(State state) {
+		if (height_ > PSP_SAS_ENVELOPE_HEIGHT_MAX)
+			height_ = PSP_SAS_ENVELOPE_HEIGHT_MAX;
+		state_ = state;
+	}
+
+	void Walk(int type, int rate) {
+		s64 expDelta;
+		switch (type) {
+		case PSP_SAS_ADSR_CURVE_MODE_LINEAR_INCREASE:
+			height_ += rate;
+			break;
+		case PSP_SAS_ADSR_CURVE_MODE_LINEAR_DECREASE:
+			height_ -= rate;
+			break;
+		case PSP_SAS_ADSR_CURVE_MODE_LINEAR_BENT:
+			height_ += height_ <= (s64)PSP_SAS_ENVELOPE_HEIGHT_MAX * 3 / 4 ? rate : rate / 4;
+			break;
+		case PSP_SAS_ADSR_CURVE_MODE_EXPONENT_DECREASE:
+			expDelta = height_ - PSP_SAS_ENVELOPE_HEIGHT_MAX;
+			expDelta += (-expDelta * rate) >> 32;
+			height_ = expDelta + PSP_SAS_ENVELOPE_HEIGHT_MAX - (rate + 3UL) / 4UL;
+			break;
+		case PSP_SAS_ADSR_CURVE_MODE_EXPONENT_INCREASE:
+			expDelta = height_ - PSP_SAS_ENVELOPE_HEIGHT_MAX;
+			expDelta += (-expDelta * rate) >> 32;
+			height_ = expDelta + 0x4000 + PSP_SAS_ENVELOPE_HEIGHT_MAX;
+			break;
+		case PSP_SAS_ADSR_CURVE_MODE_DIRECT:
+			height_ = rate;
+			break;
+		}
+	}
+
+	const ADSREnvelope &p_;
+	State state_ = OFF;
+	s64 height_ = 0;
+};
+
+// A voice as SasInstance used to mix it, resampling and enveloping one sample at a time.
+struct Voice {
+	explicit Voice(const SasVoice &v) : sas(v), env(sas.envelope) {}
+
+	void Mix(int *mix, int *send, int grainSize) {
+		int delay = 0;
+		if (env.NeedsKeyOn()) {
+			const bool ignorePitch = sas.type == VOICETYPE_PCM && sas.pitch > PSP_SAS_PITCH_BASE;
+			delay = ignorePitch ? 32 : (32 * (u32)sas.pitch) >> PSP_SAS_PITCH_BASE_SHIFT;
+			if (sas.type == VOICETYPE_VAG)
+				++delay;
+		}
+
+		s16 temp[PSP_SAS_MAX_GRAIN * 4 + 2 + 8];
+		temp[0] = sas.resampleHist[0];
+		temp[1] = sas.resampleHist[1];
+
+		u32 sampleFrac = sas.sampleFrac;
+		int samplesToRead = (sampleFrac + sas.pitch * std::max(0, grainSize - delay)) >> PSP_SAS_PITCH_BASE_SHIFT;
+		int readPos = 2;
+		if (env.NeedsKeyOn()) {
+			readPos = 0;
+			samplesToRead += 2;
+		}
+		sas.ReadSamples(&temp[readPos], samplesToRead);
+		int tempPos = readPos + samplesToRead;
+
+		for (int i = 0; i < delay; ++i)
+			env.Step();
+
+		const bool needsInterp = sas.pitch != PSP_SAS_PITCH_BASE || (sampleFrac & PSP_SAS_PITCH_MASK) != 0;
+		for (int i = delay; i < grainSize; i++) {
+			const s16 *s = temp + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+			int sample = s[0];
+			if (needsInterp) {
+				int f = sampleFrac & PSP_SAS_PITCH_MASK;
+				sample = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
+			}
+			sampleFrac += sas.pitch;
+
+			int envelopeValue = env.Height15();
+			env.Step();
+			sample = ((sample * envelopeValue) + (1 << 14)) >> 15;
+
+			mix[i * 2] += (sample * sas.volumeLeft) >> 12;
+			mix[i * 2 + 1] += (sample * sas.volumeRight) >> 12;
+			send[i * 2] += sample * sas.effectLeft >> 12;
+			send[i * 2 + 1] += sample * sas.effectRight >> 12;
+		}
+
+		sas.resampleHist[0] = temp[tempPos - 2];
+		sas.resampleHist[1] = temp[tempPos - 1];
+		sas.sampleFrac = sampleFrac - (tempPos - 2) * PSP_SAS_PITCH_BASE;
+
+		if (sas.HaveSamplesEnded())
+			env.End();
+		if (env.HasEnded()) {
+			sas.playing = false;
+			sas.on = false;
+		}
+	}
+
+	SasVoice sas;
+	Envelope env;
+};
+
+}  // namespace Reference
+
+static void RandomEnvelope(TestRandom &rng, ADSREnvelope &env) {
+	env.attackType = rng.Next() % 6;
+	env.decayType = rng.Next() % 6;
+	env.sustainType = rng.Next() % 6;
+	env.releaseType = rng.Next() % 6;
+	// Mostly ramps that finish within a few grains, sometimes stalled ones.
+	env.attackRate = rng.Next() % 8 == 0 ? 0 : (int)(rng.Next() << 7);
+	env.decayRate = rng.Next() % 8 == 0 ? 0 : (int)(rng.Next() << 5);
+	env.sustainRate = rng.Next() % 8 == 0 ? 0 : (int)(rng.Next() << 3);
+	env.releaseRate = rng.Next() % 8 == 0 ? 0 : (int)(rng.Next() << 5);
+	env.sustainLevel = (int)(rng.Next() << 6);
+}
+
+static bool TestEnvelopeBlocks() {
+	TestRandom rng(0x5A5);
+	for (int run = 0; run < 500; run++) {
+		ADSREnvelope env;
+		RandomEnvelope(rng, env);
+		Reference::Envelope ref(env);
+		env.KeyOn();
+		ref.KeyOn();
+
+		int heights[PSP_SAS_MAX_GRAIN];
+		int keyOffAt = 256 + rng.Next() % 8192;
+		for (int pos = 0; pos < 16384; ) {
+			int count = std::min(1 + (int)(rng.Next() % PSP_SAS_MAX_GRAIN), 16384 - pos);
+			if (pos < keyOffAt && pos + count > keyOffAt)
+				count = keyOffAt - pos;
+			if (pos == keyOffAt) {
+				env.KeyOff();
+				ref.KeyOff();
+			}
+
+			env.StepBlock(heights, count);
+			for (int i = 0; i < count; i++) {
+				int expected = ref.Height15();
+				ref.Step();
+				if (heights[i] != expected) {
+					printf("SAS envelope %d (curves %d %d %d %d): sample %d is %d, expected %d\n", run,
+						env.attackType, env.decayType, env.sustainType, env.releaseType, pos + i, heights[i], expected);
+					return false;
+				}
+			}
+			pos += count;
+		}
+	}
+	return true;
+}
+
+// Whole grains from SasInstance against the per-sample mixer above, which they should match exactly.
+static bool TestMixGrains(TestRandom &rng, int grainSize) {
+	const u32 vagAddr = 0x08800000;
+	const u32 pcmAddr = 0x08900000;
+	const u32 outAddr = 0x08A00000;
+	const int numBlocks = 4000;
+
+	u8 *vag = Memory::GetPointer(vagAddr);
+	for (int b = 0; b < numBlocks; b++) {
+		u8 *block = vag + b * 16;
+		block[0] = ((rng.Next() % 5) << 4) | (rng.Next() % 13);
+		block[1] = b == 10 ? 6 : (b == numBlocks - 2 ? 3 : 0);
+		for (int i = 2; i < 16; i++)
+			block[i] = (u8)rng.Next();
+	}
+	rng.Fill(Memory::GetPointer(pcmAddr), 0x40000);
+
+	// Includes the slowest and fastest pitches, and some that don't need interpolating.
+	static const int pitches[] = { 0x1000, 0x0800, 0x1234, 0x3FFF, 0x0FFF, 0x2000, 0x0010, 0x4000 };
+	SasInstance *sas = new SasInstance();
+	sas->SetGrainSize(grainSize);
+	sas->outputMode = PSP_SAS_OUTPUTMODE_RAW;
+	for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
+		SasVoice &voice = sas->voices[v];
+		if (v % 5 == 4) {
+			voice.type = VOICETYPE_PCM;
+			voice.pcmAddr = pcmAddr;
+			voice.pcmSize = 3000 + v * 100;
+		} else {
+			voice.type = VOICETYPE_VAG;
+			voice.vagAddr = vagAddr + 16 * v * 7;
+			voice.vagSize = (numBlocks - v * 7) * 16;
+		}
+		voice.loop = (v & 3) == 1;
+		voice.pitch = pitches[v % ARRAY_SIZE(pitches)];
+		voice.volumeLeft = rng.Range(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		voice.volumeRight = rng.Range(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		voice.effectLeft = rng.Range(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		voice.effectRight = rng.Range(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		RandomEnvelope(rng, voice.envelope);
+		voice.playing = true;
+		voice.on = true;
+		voice.ChangedParams(true);
+		voice.KeyOn();
+	}
+
+	std::vector<std::unique_ptr<Reference::Voice>> refVoices;
+	for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
+		refVoices.emplace_back(new Reference::Voice(sas->voices[v]));
+		refVoices.back()->env.KeyOn();
+	}
+
+	std::vector<int> mix(grainSize * 2);
+	std::vector<int> send(grainSize * 2);
+	bool success = true;
+	for (int grain = 0; grain < 100 && success; grain++) {
+		// Let some voices go and start others, so keyon delays and releases get covered.
+		if (grain % 25 == 10) {
+			for (int v = grain % 7; v < PSP_SAS_VOICES_MAX; v += 5) {
+				sas->voices[v].KeyOff();
+				refVoices[v]->sas.on = false;
+				refVoices[v]->env.KeyOff();
+			}
+		}
+		if (grain % 25 == 20) {
+			for (int v = grain % 3; v < PSP_SAS_VOICES_MAX; v += 4) {
+				sas->voices[v].playing = true;
+				sas->voices[v].on = true;
+				sas->voices[v].KeyOn();
+				refVoices[v]->sas.playing = true;
+				refVoices[v]->sas.on = true;
+				refVoices[v]->sas.KeyOn();
+				refVoices[v]->env.KeyOn();
+			}
+		}
+
+		sas->Mix(outAddr);
+		std::fill(mix.begin(), mix.end(), 0);
+		std::fill(send.begin(), send.end(), 0);
+		for (auto &ref : refVoices) {
+			if (ref->sas.playing && !ref->sas.paused)
+				ref->Mix(mix.data(), send.data(), grainSize);
+		}
+
+		// Raw output is left, right, send left, send right, each a whole grain.
+		const s16 *out = (const s16 *)Memory::GetPointer(outAddr);
+		for (int i = 0; i < grainSize * 4 && success; i++) {
+			const int channel = i / grainSize;
+			const int pos = (i % grainSize) * 2 + (channel & 1);
+			const s16 expected = clamp_s16(channel < 2 ? mix[pos] : send[pos]);
+			if (out[i] != expected) {
+				printf("SAS mix, grain size %d: grain %d channel %d sample %d is %d, expected %d\n", grainSize, grain, channel, i % grainSize, out[i], expected);
+				success = false;
+			}
+		}
+		for (int v = 0; v < PSP_SAS_VOICES_MAX && success; v++) {
+			const SasVoice &voice = sas->voices[v];
+			const SasVoice &ref = refVoices[v]->sas;
+			if (voice.playing != ref.playing || voice.sampleFrac != ref.sampleFrac) {
+				printf("SAS mix, grain size %d: grain %d voice %d playing %d frac %08x, expected %d %08x\n", grainSize, grain, v, voice.playing, voice.sampleFrac, ref.playing, ref.sampleFrac);
+				success = false;
+			}
+		}
+	}
+
+	delete sas;
+	return success;
+}
+
+// Mixes a grain with all 32 voices playing VAG at assorted pitches, the worst case for a game.
+static double TimeMix32Voices(int grainSize) {
+	const u32 vagAddr = 0x08800000;
+	const u32 outAddr = 0x08A00000;
+	const int numBlocks = 16384;
+
+	TestRandom rng(0x5A5);
+	u8 *vag = Memory::GetPointer(vagAddr);
+	for (int b = 0; b < numBlocks; b++) {
+		u8 *block = vag + b * 16;
+		block[0] = ((rng.Next() % 5) << 4) | (rng.Next() % 13);
+		block[1] = b == 0 ? 6 : (b == numBlocks - 1 ? 3 : 0);
+		for (int i = 2; i < 16; i++)
+			block[i] = (u8)rng.Next();
+	}
+
+	static const int pitches[] = { 0x1000, 0x0800, 0x1234, 0x2000, 0x0C00, 0x3FFF, 0x0FFF, 0x1800 };
+	SasInstance *sas = new SasInstance();
+	sas->SetGrainSize(grainSize);
+	for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
+		SasVoice &voice = sas->voices[v];
+		voice.type = VOICETYPE_VAG;
+		voice.vagAddr = vagAddr;
+		voice.vagSize = numBlocks * 16;
+		voice.loop = true;
+		voice.pitch = pitches[v % ARRAY_SIZE(pitches)];
+		voice.volumeLeft = 0x800;
+		voice.volumeRight = 0x400;
+		voice.effectLeft = 0x200;
+		voice.effectRight = 0x200;
+		voice.envelope.SetSimpleEnvelope(0x000F, 0x1FC0);
+		voice.playing = true;
+		voice.on = true;
+		voice.ChangedParams(true);
+		voice.KeyOn();
+	}
+
+	double grainsPerSecond = TimeWorkRate([&] {
+		for (int i = 0; i < 16; i++)
+			sas->Mix(outAddr);
+		return 16;
+	}, 0.1);
+	delete sas;
+	return 1000000.0 / grainsPerSecond;
+}
+
+bool TestSasAudio() {
+	if (!TestEnvelopeBlocks())
+		return false;
+
+	Memory::g_MemorySize = Memory::RAM_NORMAL_SIZE;
+	Memory::Init();
+	TestRandom rng(0x5A5);
+	for (int grainSize : { 64, 256, 1000, 2048 }) {
+		if (!TestMixGrains(rng, grainSize)) {
+			Memory::Shutdown();
+			return false;
+		}
+	}
+	for (int grainSize : { 256, 1024, 2048 }) {
+		double us = TimeMix32Voices(grainSize);
+		printf("SAS mix, 32 voices, grain %d: %0.1f us per grain\n", grainSize, us);
+	}
+	Memory::Shutdown();
+	return true;
+}
@@ -0,0 +1,230 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Common/Common.h"
+#include "GPU/GPUCommon.h"
+#include "GPU/GPUState.h"
+#include "GPU/ge_constants.h"
+#include "GPU/Common/SoftwareTransformCommon.h"
+#include "GPU/Common/VertexDecoderCommon.h"
+#include "unittest/UnitTest.h"
+
+static u32 ToFloat24(float f) {
+	u32 bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits >> 8;
+}
+
+struct TransformSetup {
+	const char *name;
+	bool lighting;
+	bool secondaryColor;
+	bool skinning;
+	int uvGenMode;
+	int uvProjMode;
+};
+
+static const TransformSetup transformSetups[] = {
+	{ "unlit", false, false, false, GE_TEXMAP_TEXTURE_COORDS, 0 },
+	{ "lit", true, false, false, GE_TEXMAP_TEXTURE_COORDS, 0 },
+	{ "lit, secondary color", true, true, false, GE_TEXMAP_TEXTURE_COORDS, 0 },
+	{ "lit, skinned", true, false, true, GE_TEXMAP_TEXTURE_COORDS, 0 },
+	{ "texgen position", false, false, false, GE_TEXMAP_TEXTURE_MATRIX, GE_PROJMAP_POSITION },
+	{ "texgen uv", false, false, false, GE_TEXMAP_TEXTURE_MATRIX, GE_PROJMAP_UV },
+	{ "texgen normalized normal", false, false, false, GE_TEXMAP_TEXTURE_MATRIX, GE_PROJMAP_NORMALIZED_NORMAL },
+	{ "texgen normal", false, false, true, GE_TEXMAP_TEXTURE_MATRIX, GE_PROJMAP_NORMAL },
+	{ "environment map", true, false, false, GE_TEXMAP_ENVIRONMENT_MAP, 0 },
+};
+
+static void SetupTransformState(TestRandom &rng, const TransformSetup &setup) {
+	for (int i = 0; i < 12; ++i) {
+		gstate.worldMatrix[i] = rng.Float(-2.0f, 2.0f);
+		gstate.viewMatrix[i] = rng.Float(-2.0f, 2.0f);
+		gstate.tgenMatrix[i] = rng.Float(-2.0f, 2.0f);
+	}
+	for (int i = 0; i < 8 * 12; ++i) {
+		gstate.boneMatrix[i] = rng.Float(-1.0f, 1.0f);
+	}
+
+	gstate.lightingEnable = setup.lighting ? 1 : 0;
+	gstate.lmode = setup.secondaryColor ? 1 : 0;
+	gstate.texmapmode = setup.uvGenMode | (setup.uvProjMode << 8);
+	gstate.texshade = 0 | (3 << 8);
+	gstate.reversenormals = 0;
+	gstate.materialupdate = 3;
+	gstate.materialemissive = 0x102030;
+	gstate.materialambient = 0x806040;
+	gstate.materialalpha = 0xC0;
+	gstate.materialdiffuse = 0xA0B0C0;
+	gstate.materialspecular = 0xFFFFFF;
+	gstate.materialspecularcoef = ToFloat24(8.0f);
+	gstate.ambientcolor = 0x202020;
+	gstate.ambientalpha = 0xFF;
+	gstate.fog1 = ToFloat24(10.0f);
+	gstate.fog2 = ToFloat24(0.05f);
+	gstate.texsize[0] = 8 | (8 << 8);
+	gstate_c.curTextureWidth = 256;
+	gstate_c.curTextureHeight = 256;
+
+	// One of each light type, with all three computations.
+	static const u32 ltypes[4] = {
+		(GE_LIGHTTYPE_DIRECTIONAL << 8) | GE_LIGHTCOMP_BOTH,
+		(GE_LIGHTTYPE_POINT << 8) | GE_LIGHTCOMP_ONLYDIFFUSE,
+		(GE_LIGHTTYPE_SPOT << 8) | GE_LIGHTCOMP_BOTH,
+		(GE_LIGHTTYPE_POINT << 8) | GE_LIGHTCOMP_ONLYPOWDIFFUSE,
+	};
+	for (int l = 0; l < 4; ++l) {
+		gstate.lightEnable[l] = 1;
+		gstate.ltype[l] = ltypes[l];
+		for (int i = 0; i < 3; ++i) {
+			gstate.lpos[l * 3 + i] = ToFloat24(rng.Float(-4.0f, 4.0f));
+			gstate.ldir[l * 3 + i] = ToFloat24(rng.Float(-1.0f, 1.0f));
+			gstate.lcolor[l * 3 + i] = rng.Next() & 0xFFFFFF;
+		}
+		gstate.latt[l * 3 + 0] = ToFloat24(1.0f);
+		gstate.latt[l * 3 + 1] = ToFloat24(0.25f);
+		gstate.latt[l * 3 + 2] = ToFloat24(0.0625f);
+		gstate.lconv[l] = ToFloat24(2.0f);
+		gstate.lcutoff[l] = ToFloat24(0.25f);
+	}
+}
+
+class TransformTestHarness {
+public:
+	TransformTestHarness(TestRandom &rng, int count, bool skinning) : count_(count) {
+		u32 vtype = GE_VTYPE_TC_FLOAT | GE_VTYPE_COL_8888 | GE_VTYPE_NRM_FLOAT | GE_VTYPE_POS_FLOAT;
+		if (skinning)
+			vtype |= GE_VTYPE_WEIGHT_FLOAT | (1 << GE_VTYPE_WEIGHTCOUNT_SHIFT);
+
+		VertexDecoderOptions options{};
+		dec_.SetVertexType(vtype, options);
+		vertType_ = vtype;
+
+		// Fill a raw PSP vertex stream, in the order weights, uv, color, normal, position.
+		int floats = dec_.VertexSize() / 4;
+		std::vector<float> src(count * floats);
+		for (int i = 0; i < count; ++i) {
+			float *v = &src[i * floats];
+			int n = 0;
+			if (skinning) {
+				float w = rng.Float(0.0f, 1.0f);
+				v[n++] = w;
+				v[n++] = 1.0f - w;
+			}
+			v[n++] = rng.Float(0.0f, 1.0f);
+			v[n++] = rng.Float(0.0f, 1.0f);
+			u32 color = rng.Next() | (rng.Next() << 24);
+			memcpy(&v[n++], &color, sizeof(color));
+			for (int j = 0; j < 6; ++j)
+				v[n++] = rng.Float(-1.0f, 1.0f);
+		}
+
+		decoded_.resize(count * dec_.GetDecVtxFmt().stride);
+		dec_.DecodeVerts(decoded_.data(), src.data(), 0, count - 1);
+	}
+
+	const std::vector<TransformedVertex> &Run(bool perVertex) {
+		std::vector<TransformedVertex> &out = perVertex ? reference_ : batched_;
+		out.resize(count_);
+
+		SoftwareTransformParams params{};
+		params.decoded = decoded_.data();
+		params.transformed = out.data();
+		params.perVertexTransform = perVertex;
+
+		SoftwareTransformResult result{};
+		SoftwareTransform swTransform(params);
+		swTransform.Decode(GE_PRIM_TRIANGLES, vertType_, dec_.GetDecVtxFmt(), count_, &result);
+		return out;
+	}
+
+	bool Compare(const char *name) {
+		Run(true);
+		Run(false);
+		for (int i = 0; i < count_; ++i) {
+			const TransformedVertex &a = reference_[i];
+			const TransformedVertex &b = batched_[i];
+			bool same = true;
+			for (int j = 0; j < 4; ++j)
+				same = same && NearlyEqual(a.pos[j], b.pos[j]);
+			for (int j = 0; j < 3; ++j)
+				same = same && NearlyEqual(a.uv[j], b.uv[j]);
+			for (int j = 0; j < 4; ++j) {
+				same = same && abs(a.color0[j] - b.color0[j]) <= 1;
+				same = same && abs(a.color1[j] - b.color1[j]) <= 1;
+			}
+			if (!same) {
+				printf("%s: vertex %d differs: pos %f %f %f fog %f uv %f %f %f col %08x %08x vs pos %f %f %f fog %f uv %f %f %f col %08x %08x\n", name, i,
+					a.x, a.y, a.z, a.fog, a.u, a.v, a.w, a.color0_32, a.color1_32,
+					b.x, b.y, b.z, b.fog, b.u, b.v, b.w, b.color0_32, b.color1_32);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Vertices per second, in millions.
+	double Time(bool perVertex) {
+		return TimeWorkRate([&] {
+			for (int i = 0; i < 8; ++i)
+				Run(perVertex);
+			return count_ * 8;
+		}) / 1000000.0;
+	}
+
+private:
+	static bool NearlyEqual(float a, float b) {
+		return fabsf(a - b) <= 0.001f * std::max(1.0f, std::max(fabsf(a), fabsf(b)));
+	}
+
+	VertexDecoder dec_;
+	u32 vertType_;
+	int count_;
+	std::vector<u8> decoded_;
+	std::vector<TransformedVertex> reference_;
+	std::vector<TransformedVertex> batched_;
+};
+
+bool TestSoftwareTransform() {
+	gstate_c.uv.uScale = 1.0f;
+	gstate_c.uv.vScale = 1.0f;
+
+	TestRandom rng;
+	for (const TransformSetup &setup : transformSetups) {
+		SetupTransformState(rng, setup);
+
+		// Odd counts leave a partial batch at the end.
+		for (int count : { 1, 3, 5, 1027 }) {
+			TransformTestHarness harness(rng, count, setup.skinning);
+			if (!harness.Compare(setup.name))
+				return false;
+		}
+
+		TransformTestHarness harness(rng, 4096, setup.skinning);
+		double perVertex = harness.Time(true);
+		double batched = harness.Time(false);
+		printf("Software transform, %s: %0.1f Mverts/s batched, %0.1f Mverts/s per vertex\n", setup.name, batched, perVertex);
+	}
+	return true;
+}
@@ -0,0 +1,407 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Core/Config.h"
+#include "GPU/GPUState.h"
+#include "GPU/ge_constants.h"
+#include "GPU/Common/SplineCommon.h"
+#include "unittest/UnitTest.h"
+
+using namespace Spline;
+
+namespace Reference {
+
+// Basis values and derivatives of the four control points that affect t, in double precision.
+struct Basis {
+	int first;
+	double value[4];
+	double deriv[4];
+};
+
+// Cubic Bernstein polynomials, t in 0..1.
+static Basis Bezier(double t) {
+	Basis b;
+	b.first = 0;
+	b.value[0] = (1 - t) * (1 - t) * (1 - t);
+	b.value[1] = 3 * t * (1 - t) * (1 - t);
+	b.value[2] = 3 * t * t * (1 - t);
+	b.value[3] = t * t * t;
+	b.deriv[0] = -3 * (1 - t) * (1 - t);
+	b.deriv[1] = 3 * (1 - t) * (1 - 3 * t);
+	b.deriv[2] = 3 * t * (2 - 3 * t);
+	b.deriv[3] = 3 * t * t;
+	return b;
+}
+
+// Cubic B-spline over count control points by Cox-de Boor, t in 0..count-3.  The knots are uniform,
+// and repeated four times at each open edge.
+static Basis BSpline(double t, int count, int type) {
+	const int n = count - 3;
+	std::vector<double> knots(count + 4);
+	for (int i = 0; i < count + 4; ++i) {
+		double k = i - 3;
+		if ((type & 1) != 0 && k < 0)
+			k = 0;
+		if ((type & 2) != 0 && k > n)
+			k = n;
+		knots[i] = k;
+	}
+
+	// The span holding t, the last one for the very end.
+	int span = 3;
+	while (span < n + 2 && t >= knots[span + 1])
+		++span;
+
+	// N[d][i] is the degree d basis of control point i.
+	std::vector<double> N[4];
+	for (int d = 0; d < 4; ++d)
+		N[d].assign(count + 3, 0.0);
+	N[0][span] = 1.0;
+	auto ratio = [](double num, double den) { return den == 0.0 ? 0.0 : num / den; };
+	for (int d = 1; d <= 3; ++d) {
+		for (int i = 0; i + d + 1 < count + 4; ++i) {
+			N[d][i] = ratio(t - knots[i], knots[i + d] - knots[i]) * N[d - 1][i] + ratio(knots[i + d + 1] - t, knots[i + d + 1] - knots[i + 1]) * N[d - 1][i + 1];
+		}
+	}
+
+	Basis b;
+	b.first = span - 3;
+	for (int j = 0; j < 4; ++j) {
+		int i = b.first + j;
+		b.value[j] = N[3][i];
+		b.deriv[j] = 3 * (ratio(N[2][i], knots[i + 3] - knots[i]) - ratio(N[2][i + 1], knots[i + 4] - knots[i + 1]));
+	}
+	return b;
+}
+
+struct Vertex {
+	double pos[3];
+	double nrm[3];
+	double col[4];
+	double uv[2];
+	bool corner;
+};
+
+// Evaluates one output vertex the slow way, straight from the control points.
+static Vertex Evaluate(const SimpleVertex *const *points, int num_points_u, const Basis &bu, const Basis &bv, bool patchFacing) {
+	Vertex v{};
+	double du[3]{}, dv[3]{};
+	for (int j = 0; j < 4; ++j) {
+		for (int i = 0; i < 4; ++i) {
+			const SimpleVertex &p = *points[(bv.first + j) * num_points_u + bu.first + i];
+			const double w = bu.value[i] * bv.value[j];
+			for (int c = 0; c < 3; ++c) {
+				v.pos[c] += p.pos[c] * w;
+				du[c] += p.pos[c] * bu.deriv[i] * bv.value[j];
+				dv[c] += p.pos[c] * bu.value[i] * bv.deriv[j];
+			}
+			for (int c = 0; c < 4; ++c)
+				v.col[c] += p.color[c] * w;
+			for (int c = 0; c < 2; ++c)
+				v.uv[c] += p.uv[c] * w;
+		}
+	}
+
+	double cross[3] = {
+		du[1] * dv[2] - du[2] * dv[1],
+		du[2] * dv[0] - du[0] * dv[2],
+		du[0] * dv[1] - du[1] * dv[0],
+	};
+	double len = sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+	for (int c = 0; c < 3; ++c)
+		v.nrm[c] = (patchFacing ? -cross[c] : cross[c]) / len;
+
+	// Both directions on an edge point, so the vertex is a control point as is.
+	auto onEdge = [](const Basis &b) { return b.value[0] == 1.0 || b.value[3] == 1.0; };
+	v.corner = onEdge(bu) && onEdge(bv);
+	return v;
+}
+
+}  // namespace Reference
+
+struct TestPatch {
+	std::vector<SimpleVertex> vertices;
+	std::vector<const SimpleVertex *> points;
+
+	std::vector<Vec3f> pos;
+	std::vector<Vec2f> tex;
+	std::vector<Vec4f> col;
+	ControlPoints cpoints;
+
+	void Randomize(TestRandom &rng, int count) {
+		vertices.resize(count);
+		points.resize(count);
+		for (int i = 0; i < count; ++i) {
+			SimpleVertex &v = vertices[i];
+			v.uv[0] = rng.Float(0.0f, 1.0f);
+			v.uv[1] = rng.Float(0.0f, 1.0f);
+			v.color_32 = rng.Next() | (rng.Next() << 24);
+			v.nrm = Vec3Packedf(0.0f, 0.0f, 1.0f);
+			v.pos = Vec3Packedf(rng.Float(-1.0f, 1.0f), rng.Float(-1.0f, 1.0f), rng.Float(-1.0f, 1.0f));
+			points[i] = &vertices[i];
+		}
+		Convert();
+	}
+
+	void Convert() {
+		const int count = (int)vertices.size();
+		pos.resize(count);
+		tex.resize(count);
+		col.resize(count);
+		cpoints.pos = pos.data();
+		cpoints.tex = tex.data();
+		cpoints.col = col.data();
+		cpoints.Convert(points.data(), count);
+	}
+};
+
+struct TestOutput {
+	std::vector<SimpleVertex> vertices;
+	std::vector<u16> indices;
+	OutputBuffers output;
+
+	explicit TestOutput(int numVertices) : vertices(numVertices), indices(numVertices * 6) {
+		output.vertices = vertices.data();
+		output.indices = indices.data();
+		output.count = 0;
+	}
+};
+
+// Without texture coordinates in the vertex type, ref.uv should already hold the generated ones.
+static bool CheckVertex(const char *name, int index, const SimpleVertex &vert, const Reference::Vertex &ref, u32 vertType, bool sampleNrm) {
+	bool ok = true;
+	for (int c = 0; c < 3; ++c) {
+		// The edges are special cased, and come out as exactly the control point.
+		if (ref.corner ? vert.pos[c] != (float)ref.pos[c] : fabs(vert.pos[c] - ref.pos[c]) > 0.0001)
+			ok = false;
+	}
+	if (sampleNrm) {
+		for (int c = 0; c < 3; ++c) {
+			if (fabs(vert.nrm[c] - ref.nrm[c]) > 0.002)
+				ok = false;
+		}
+	} else if (vert.nrm[0] != 0.0f || vert.nrm[1] != 0.0f || vert.nrm[2] != 1.0f) {
+		ok = false;
+	}
+	if (vertType & GE_VTYPE_COL_MASK) {
+		for (int c = 0; c < 4; ++c) {
+			if (fabs(vert.color[c] - ref.col[c]) > 1.0)
+				ok = false;
+		}
+	}
+	for (int c = 0; c < 2; ++c) {
+		if (fabs(vert.uv[c] - ref.uv[c]) > 0.0001)
+			ok = false;
+	}
+
+	if (!ok) {
+		printf("%s: vertex %d is pos %f %f %f nrm %f %f %f color %08x uv %f %f\n", name, index, vert.pos[0], vert.pos[1], vert.pos[2], vert.nrm[0], vert.nrm[1], vert.nrm[2], (u32)vert.color_32, vert.uv[0], vert.uv[1]);
+		printf("  expected pos %f %f %f nrm %f %f %f color %f %f %f %f uv %f %f\n", ref.pos[0], ref.pos[1], ref.pos[2], ref.nrm[0], ref.nrm[1], ref.nrm[2], ref.col[0], ref.col[1], ref.col[2], ref.col[3], ref.uv[0], ref.uv[1]);
+	}
+	return ok;
+}
+
+// Compares every vertex against the reference, and the indices against a fresh BuildIndex().
+static bool CheckOutput(const char *name, const BezierSurface &surface, const TestPatch &patch, const OutputBuffers &output, u32 vertType, bool sampleNrm) {
+	for (int patch_u = 0; patch_u < surface.num_patches_u; ++patch_u) {
+		for (int patch_v = 0; patch_v < surface.num_patches_v; ++patch_v) {
+			for (int tile_u = 0; tile_u <= surface.tess_u; ++tile_u) {
+				for (int tile_v = 0; tile_v <= surface.tess_v; ++tile_v) {
+					Reference::Basis bu = Reference::Bezier((double)tile_u / surface.tess_u);
+					Reference::Basis bv = Reference::Bezier((double)tile_v / surface.tess_v);
+					bu.first = patch_u * 3;
+					bv.first = patch_v * 3;
+					Reference::Vertex ref = Reference::Evaluate(patch.points.data(), surface.num_points_u, bu, bv, surface.patchFacing);
+					if (!(vertType & GE_VTYPE_TC_MASK)) {
+						ref.uv[0] = patch_u + (double)tile_u / surface.tess_u;
+						ref.uv[1] = patch_v + (double)tile_v / surface.tess_v;
+					}
+
+					int index = surface.GetIndex(tile_u, tile_v, patch_u, patch_v);
+					RET(CheckVertex(name, index, output.vertices[index], ref, vertType, sampleNrm));
+				}
+			}
+		}
+	}
+
+	std::vector<u16> indices(surface.GetNumVertices() * 6);
+	int count = 0;
+	surface.BuildIndex(indices.data(), count);
+	if (output.count != count || memcmp(output.indices, indices.data(), count * sizeof(u16)) != 0) {
+		printf("%s: indices differ\n", name);
+		return false;
+	}
+	return true;
+}
+
+static bool CheckOutput(const char *name, const SplineSurface &surface, const TestPatch &patch, const OutputBuffers &output, u32 vertType, bool sampleNrm) {
+	const int num_vertices_v = surface.num_patches_v * surface.tess_v + 1;
+	for (int index_u = 0; index_u < surface.num_vertices_u; ++index_u) {
+		for (int index_v = 0; index_v < num_vertices_v; ++index_v) {
+			Reference::Basis bu = Reference::BSpline((double)index_u / surface.tess_u, surface.num_points_u, surface.type_u);
+			Reference::Basis bv = Reference::BSpline((double)index_v / surface.tess_v, surface.num_points_v, surface.type_v);
+			Reference::Vertex ref = Reference::Evaluate(patch.points.data(), surface.num_points_u, bu, bv, surface.patchFacing);
+			if (!(vertType & GE_VTYPE_TC_MASK)) {
+				ref.uv[0] = (double)index_u / surface.tess_u;
+				ref.uv[1] = (double)index_v / surface.tess_v;
+			}
+
+			int index = surface.GetIndex(index_u, index_v, 0, 0);
+			RET(CheckVertex(name, index, output.vertices[index], ref, vertType, sampleNrm));
+		}
+	}
+
+	std::vector<u16> indices(surface.GetNumVertices() * 6);
+	int count = 0;
+	surface.BuildIndex(indices.data(), count);
+	if (output.count != count || memcmp(output.indices, indices.data(), count * sizeof(u16)) != 0) {
+		printf("%s: indices differ\n", name);
+		return false;
+	}
+	return true;
+}
+
+static void SetupSurface(BezierSurface &surface, TestRandom &rng, int patches_u, int patches_v) {
+	surface.num_patches_u = patches_u;
+	surface.num_patches_v = patches_v;
+	surface.num_points_u = patches_u * 3 + 1;
+	surface.num_points_v = patches_v * 3 + 1;
+	surface.type_u = 0;
+	surface.type_v = 0;
+}
+
+static void SetupSurface(SplineSurface &surface, TestRandom &rng, int patches_u, int patches_v) {
+	surface.num_patches_u = patches_u;
+	surface.num_patches_v = patches_v;
+	surface.num_points_u = patches_u + 3;
+	surface.num_points_v = patches_v + 3;
+	// A single patch open at both ends doesn't get the clamped knots the reference uses (see Spline3DWeight::CalcKnots),
+	// so that one is left out.
+	surface.type_u = rng.Range(0, patches_u > 1 ? 3 : 2);
+	surface.type_v = rng.Range(0, patches_v > 1 ? 3 : 2);
+}
+
+// Tessellates through the cache the way DrawEngineCommon::SubmitCurve() does, and checks the first
+// (tessellated) and the second (cached) result.
+template <class Surface>
+static bool TestSurface(const char *name, TessellationCache &cache, TestRandom &rng, int patches_u, int patches_v, int tess) {
+	Surface surface{};
+	SetupSurface(surface, rng, patches_u, patches_v);
+	surface.tess_u = tess;
+	surface.tess_v = tess + rng.Range(0, 2);
+	surface.primType = GE_PATCHPRIM_TRIANGLES;
+	surface.patchFacing = rng.Range(0, 1) != 0;
+	surface.Init(65536);
+
+	TestPatch patch;
+	patch.Randomize(rng, surface.num_points_u * surface.num_points_v);
+
+	static const u32 vertTypes[] = {
+		GE_VTYPE_POS_FLOAT,
+		GE_VTYPE_POS_FLOAT | GE_VTYPE_NRM_FLOAT,
+		GE_VTYPE_POS_FLOAT | GE_VTYPE_COL_8888,
+		GE_VTYPE_POS_FLOAT | GE_VTYPE_TC_FLOAT,
+		GE_VTYPE_POS_FLOAT | GE_VTYPE_NRM_FLOAT | GE_VTYPE_COL_8888 | GE_VTYPE_TC_FLOAT,
+	};
+	for (u32 vertType : vertTypes) {
+		for (int lighting = 0; lighting < 2; ++lighting) {
+			gstate.lightingEnable = lighting;
+			const bool sampleNrm = (vertType & GE_VTYPE_NRM_MASK) != 0 || lighting != 0;
+			const int numVertices = surface.GetNumVertices();
+
+			u64 key = TessellationKey(surface, patch.points.data(), (int)patch.points.size(), vertType);
+			TestOutput first(numVertices);
+			if (cache.Lookup(key, first.output)) {
+				printf("%s: found in the cache before it was stored\n", name);
+				return false;
+			}
+			SoftwareTessellation(first.output, surface, vertType, patch.cpoints);
+			cache.Store(key, first.output, numVertices);
+			RET(CheckOutput(name, surface, patch, first.output, vertType, sampleNrm));
+
+			// The same draw again should come out of the cache unchanged, unless it's too small to keep.
+			TestOutput second(numVertices);
+			bool cached = cache.Lookup(key, second.output);
+			if (cached != (numVertices >= TessellationCache::MIN_VERTICES)) {
+				printf("%s: %d vertices were %s\n", name, numVertices, cached ? "cached" : "not cached");
+				return false;
+			}
+			if (cached) {
+				if (second.output.count != first.output.count || memcmp(second.vertices.data(), first.vertices.data(), numVertices * sizeof(SimpleVertex)) != 0 || memcmp(second.indices.data(), first.indices.data(), first.output.count * sizeof(u16)) != 0) {
+					printf("%s: cached output differs\n", name);
+					return false;
+				}
+				RET(CheckOutput(name, surface, patch, second.output, vertType, sampleNrm));
+			}
+		}
+	}
+
+	// Moving a single control point has to miss.
+	u64 key = TessellationKey(surface, patch.points.data(), (int)patch.points.size(), GE_VTYPE_POS_FLOAT);
+	patch.vertices[rng.Range(0, (int)patch.vertices.size() - 1)].pos[1] += 0.5f;
+	patch.Convert();
+	if (TessellationKey(surface, patch.points.data(), (int)patch.points.size(), GE_VTYPE_POS_FLOAT) == key) {
+		printf("%s: key ignores a moved control point\n", name);
+		return false;
+	}
+
+	return true;
+}
+
+static bool TestTessellationCacheEviction() {
+	TessellationCache cache;
+	const int numVertices = TessellationCache::MIN_VERTICES;
+	TestOutput output(numVertices);
+	output.output.count = 6;
+
+	// Going one over the limit drops the least recently used, which isn't the first after a lookup.
+	for (u64 key = 0; key < TessellationCache::MAX_ENTRIES; ++key)
+		cache.Store(key, output.output, numVertices);
+	EXPECT_TRUE(cache.Lookup(0, output.output));
+	cache.Store(TessellationCache::MAX_ENTRIES, output.output, numVertices);
+	EXPECT_TRUE(cache.Lookup(0, output.output));
+	EXPECT_FALSE(cache.Lookup(1, output.output));
+	EXPECT_TRUE(cache.Lookup(TessellationCache::MAX_ENTRIES, output.output));
+
+	cache.Clear();
+	EXPECT_FALSE(cache.Lookup(0, output.output));
+	return true;
+}
+
+bool TestSpline() {
+	g_Config.iSplineBezierQuality = HIGH_QUALITY;
+	TestRandom rng(0x5B1);
+	TessellationCache cache;
+
+	// Tessellation factors around the four lanes per step, and large enough surfaces to go wide.
+	for (int tess = 1; tess <= 9; ++tess) {
+		RET(TestSurface<BezierSurface>("Bezier", cache, rng, rng.Range(1, 3), rng.Range(1, 3), tess));
+		RET(TestSurface<SplineSurface>("Spline", cache, rng, rng.Range(1, 4), rng.Range(1, 4), tess));
+	}
+	RET(TestSurface<BezierSurface>("Bezier", cache, rng, 8, 8, 10));
+	RET(TestSurface<SplineSurface>("Spline", cache, rng, 12, 12, 8));
+
+	RET(TestTessellationCacheEviction());
+	return true;
+}
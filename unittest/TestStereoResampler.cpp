@@ -0,0 +1,163 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Math/math_util.h"
+#include "Core/Config.h"
+#include "Core/ConfigValues.h"
+#include "Core/HW/StereoResampler.h"
+#include "unittest/UnitTest.h"
+
+static const char *const resamplerNames[] = { "linear", "sinc", "sinc HQ" };
+
+// Like the PSP's hardware blocks, pushed at 44100 Hz.
+static const int PUSH_FRAMES = 441;
+// Pulled by the host at 48000 Hz.
+static const int MIX_FRAMES = 480;
+// Frames at the start that are still blending in the silence before the first push.
+static const int WARMUP_FRAMES = 64;
+
+// Streams a generated signal through the resampler, as the emulator and host would.
+// Returns false on any underrun, since the buffer is kept well fed.
+template <typename F>
+static bool Stream(StereoResampler &resampler, F generate, int mixes, std::vector<s16> &output) {
+	std::vector<s32> block(PUSH_FRAMES * 2);
+	int pushed = 0;
+	auto push = [&]() {
+		for (int i = 0; i < PUSH_FRAMES; i++)
+			generate(pushed + i, &block[i * 2]);
+		resampler.PushSamples(block.data(), PUSH_FRAMES);
+		pushed += PUSH_FRAMES;
+	};
+
+	// Fill up to around the default target first.
+	for (int i = 0; i < 4; i++)
+		push();
+
+	output.resize(mixes * MIX_FRAMES * 2);
+	for (int m = 0; m < mixes; m++) {
+		push();
+		unsigned int mixed = resampler.Mix(&output[m * MIX_FRAMES * 2], MIX_FRAMES, false, 48000);
+		if (mixed != MIX_FRAMES) {
+			printf("Resampler: underrun in mix %d (%d of %d frames)\n", m, mixed, MIX_FRAMES);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool TestConstant(int quality) {
+	StereoResampler resampler;
+	std::vector<s16> output;
+	bool success = Stream(resampler, [](int i, s32 *out) {
+		out[0] = 1000;
+		out[1] = -2000;
+	}, 100, output);
+	if (!success)
+		return false;
+
+	for (size_t i = WARMUP_FRAMES * 2; i < output.size(); i += 2) {
+		if (output[i] != 1000 || output[i + 1] != -2000) {
+			printf("Resampler %s: frame %d is %d,%d, expected 1000,-2000\n", resamplerNames[quality], (int)i / 2, output[i], output[i + 1]);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool TestSine(int quality) {
+	const double amplitude = 16000.0;
+	const double freq = 1000.0;
+
+	StereoResampler resampler;
+	std::vector<s16> output;
+	// Enough to go around the ring many times.
+	bool success = Stream(resampler, [&](int i, s32 *out) {
+		double v = amplitude * sin(2.0 * M_PI * freq * i / 44100.0);
+		out[0] = (s32)v;
+		out[1] = (s32)-v;
+	}, 200, output);
+	if (!success)
+		return false;
+
+	// The output rate drifts a little, but a sample can never jump further than the slope allows.
+	const int maxStep = (int)(2.0 * M_PI * freq / 48000.0 * amplitude * 1.1);
+	double sumSquares = 0.0;
+	for (size_t i = WARMUP_FRAMES * 2; i < output.size(); i += 2) {
+		if (abs(output[i] + output[i + 1]) > 1) {
+			printf("Resampler %s: frame %d channels differ, %d,%d\n", resamplerNames[quality], (int)i / 2, output[i], output[i + 1]);
+			return false;
+		}
+		if (i >= (WARMUP_FRAMES + 1) * 2 && abs(output[i] - output[i - 2]) > maxStep) {
+			printf("Resampler %s: frame %d jumps from %d to %d\n", resamplerNames[quality], (int)i / 2, output[i - 2], output[i]);
+			return false;
+		}
+		sumSquares += (double)output[i] * output[i];
+	}
+
+	double rms = sqrt(sumSquares / (output.size() / 2 - WARMUP_FRAMES));
+	double expected = amplitude / sqrt(2.0);
+	if (fabs(rms - expected) > expected * 0.02) {
+		printf("Resampler %s: sine RMS %0.1f, expected %0.1f\n", resamplerNames[quality], rms, expected);
+		return false;
+	}
+	return true;
+}
+
+// Output frames per second, in millions.
+static double TimeMix() {
+	StereoResampler resampler;
+	std::vector<s32> block(PUSH_FRAMES * 2);
+	for (int i = 0; i < PUSH_FRAMES * 2; i++)
+		block[i] = (i * 7919) % 65536 - 32768;
+	std::vector<s16> output(MIX_FRAMES * 2);
+
+	return TimeWorkRate([&] {
+		int frames = 0;
+		for (int i = 0; i < 16; i++) {
+			resampler.PushSamples(block.data(), PUSH_FRAMES);
+			frames += resampler.Mix(output.data(), MIX_FRAMES, false, 48000);
+		}
+		return frames;
+	}) / 1000000.0;
+}
+
+bool TestStereoResampler() {
+	int oldVolume = g_Config.iGlobalVolume;
+	int oldResampler = g_Config.iAudioResampler;
+	bool oldExtraBuffering = g_Config.bExtraAudioBuffering;
+	g_Config.iGlobalVolume = VOLUME_MAX;
+	g_Config.bExtraAudioBuffering = false;
+
+	bool success = true;
+	for (int quality = AUDIO_RESAMPLER_LINEAR; quality <= AUDIO_RESAMPLER_SINC_HQ && success; quality++) {
+		g_Config.iAudioResampler = quality;
+		success = TestConstant(quality) && TestSine(quality);
+		if (success)
+			printf("Resampler %s: %0.1f Mframes/s\n", resamplerNames[quality], TimeMix());
+	}
+
+	g_Config.iGlobalVolume = oldVolume;
+	g_Config.iAudioResampler = oldResampler;
+	g_Config.bExtraAudioBuffering = oldExtraBuffering;
+	return success;
+}
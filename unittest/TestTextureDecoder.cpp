@@ -0,0 +1,483 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Common/ColorConv.h"
+#include "Common/CPUDetect.h"
+#include "GPU/Common/TextureDecoder.h"
+#include "unittest/UnitTest.h"
+
+// Plain versions of everything, to check the optimized paths against.
+namespace Reference {
+
+static void UnswizzleTex16(const u8 *texptr, u32 *ydestp, int bxc, int byc, u32 pitch) {
+	// A block is 16 bytes by 8 rows, stored one after another.
+	for (int by = 0; by < byc; ++by) {
+		for (int bx = 0; bx < bxc; ++bx) {
+			for (int row = 0; row < 8; ++row) {
+				u8 *dest = (u8 *)ydestp + (by * 8 + row) * pitch + bx * 16;
+				memcpy(dest, texptr, 16);
+				texptr += 16;
+			}
+		}
+	}
+}
+
+static CheckAlphaResult CheckAlpha(const u32 *pixelData, int stride, int w, int h, int bpp, u32 alphaMask) {
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			u32 pixel = bpp == 4 ? pixelData[y * stride + x] : ((const u16 *)pixelData)[y * stride * 2 + x];
+			if ((pixel & alphaMask) != alphaMask)
+				return CHECKALPHA_ANY;
+		}
+	}
+	return CHECKALPHA_FULL;
+}
+
+static void DeIndexTexture4(u16 *dest, const u8 *indexed, int length, u16 color, int shift) {
+	for (int i = 0; i < length; ++i) {
+		int index = (indexed[i / 2] >> ((i & 1) * 4)) & 0xF;
+		dest[i] = color | (index << shift);
+	}
+}
+
+// DXT blocks, texel by texel straight from the bytes.  Each starts with a byte of 2-bit color
+// indices per row, then two 565 colors with red in the low bits.
+static u32 DXTColor(const u8 *block, int x, int y, bool opaque) {
+	const u16 c1 = block[4] | (block[5] << 8);
+	const u16 c2 = block[6] | (block[7] << 8);
+	int index = (block[y] >> (x * 2)) & 3;
+	if (index == 3 && c1 <= c2)
+		return 0;
+
+	u32 color = opaque ? 0xFF000000 : 0;
+	for (int shift : { 0, 5, 11 }) {
+		int bits = shift == 5 ? 6 : 5;
+		int mask = (1 << bits) - 1;
+		int v1 = ((c1 >> shift) & mask) << (8 - bits);
+		int v2 = ((c2 >> shift) & mask) << (8 - bits);
+		int v;
+		switch (index) {
+		case 0: v = v1; break;
+		case 1: v = v2; break;
+		case 2: v = c1 > c2 ? (2 * v1 + v2) / 3 : (v1 + v2) / 2; break;
+		default: v = (v1 + 2 * v2) / 3; break;
+		}
+		// The low bits end up in the third byte.
+		color |= v << (shift == 0 ? 16 : (shift == 5 ? 8 : 0));
+	}
+	return color;
+}
+
+static u32 DXT3Alpha(const u8 *block, int x, int y) {
+	int nibble = (block[8 + y * 2 + x / 2] >> ((x & 1) * 4)) & 0xF;
+	return nibble << 4;
+}
+
+// Ideal value, the decoder may be off by a fraction.
+static float DXT5Alpha(const u8 *block, int x, int y) {
+	u64 indices = 0;
+	for (int i = 0; i < 6; ++i)
+		indices |= (u64)block[8 + i] << (i * 8);
+	int index = (int)(indices >> ((y * 4 + x) * 3)) & 7;
+
+	const int a1 = block[14];
+	const int a2 = block[15];
+	if (index == 0)
+		return (float)a1;
+	if (index == 1)
+		return (float)a2;
+	if (a1 > a2)
+		return (a1 * (8 - index) + a2 * (index - 1)) / 7.0f;
+	if (index == 6)
+		return 0.0f;
+	if (index == 7)
+		return 255.0f;
+	return (a1 * (6 - index) + a2 * (index - 1)) / 5.0f;
+}
+
+}
+
+// Runs func for a while and returns how many GB of texture it got through per second.
+static double TimeDecoder(size_t bytes, const std::function<void()> &func) {
+	return TimeWorkRate([&] {
+		for (int i = 0; i < 16; ++i) {
+			func();
+		}
+		return (double)bytes * 16;
+	}) / 1000000000.0;
+}
+
+// Also times it without AVX2 where available, since most paths have both.
+static void BenchmarkDecoder(const char *name, int w, int h, size_t bytes, const std::function<void()> &func) {
+	double speed = TimeDecoder(bytes, func);
+	if (cpu_info.bAVX2) {
+		cpu_info.bAVX2 = false;
+		double withoutAVX2 = TimeDecoder(bytes, func);
+		cpu_info.bAVX2 = true;
+		printf("%s %dx%d: %0.2f GB/s (%0.2f GB/s without AVX2)\n", name, w, h, speed, withoutAVX2);
+	} else {
+		printf("%s %dx%d: %0.2f GB/s\n", name, w, h, speed);
+	}
+}
+
+static const int benchmarkSizes[] = { 64, 256, 512 };
+
+static bool TestDecoderQuickTexHash(TestRandom &rng) {
+	std::vector<u8> buf(512 * 512 * 4);
+	rng.Fill(buf.data(), 512 * 512 * 4);
+
+	// The fast path needs 16-byte alignment and a size in 64-byte steps, try both.
+	for (int i = 0; i < 200; ++i) {
+		int offset = (rng.Next() & 1) ? 0 : rng.Range(1, 15) * 4;
+		u32 size = (rng.Next() & 1) ? rng.Range(1, 1024) * 64 : rng.Range(1, 8192) * 8;
+		const u8 *p = buf.data() + offset;
+		EXPECT_EQ_HEX(StableQuickTexHash(p, size), QuickTexHashNonSSE(p, size));
+	}
+
+	for (int size : benchmarkSizes) {
+		u32 bytes = size * size * 4;
+		u32 sink = 0;
+		BenchmarkDecoder("QuickTexHash 8888", size, size, bytes, [&] {
+			sink += DoQuickTexHash(buf.data(), bytes);
+		});
+		if (sink == 0x12345678)
+			printf("(unlikely)\n");
+	}
+	return true;
+}
+
+static bool TestDecoderUnswizzle(TestRandom &rng) {
+	std::vector<u8> src(512 * 512 * 4);
+	std::vector<u32> dest(512 * 512 + 4);
+	std::vector<u32> expected(512 * 512 + 4);
+	rng.Fill(src.data(), 512 * 512 * 4);
+
+	for (int i = 0; i < 200; ++i) {
+		int bxc = rng.Range(1, 32);
+		int byc = rng.Range(1, 32);
+		// The SIMD path needs both aligned, try misaligned too.
+		u32 pitch = bxc * 16 + ((rng.Next() & 1) ? 0 : rng.Range(1, 3) * 4);
+		int offset = (rng.Next() & 1) ? 0 : 1;
+		memset(dest.data(), 0, (512 * 512 + 4) * 4);
+		memset(expected.data(), 0, (512 * 512 + 4) * 4);
+
+		DoUnswizzleTex16(src.data(), dest.data() + offset, bxc, byc, pitch);
+		Reference::UnswizzleTex16(src.data(), expected.data() + offset, bxc, byc, pitch);
+		if (memcmp(dest.data(), expected.data(), (offset + byc * 8 * pitch / 4) * 4) != 0) {
+			printf("Unswizzle mismatch: %dx%d blocks, pitch %d, offset %d\n", bxc, byc, pitch, offset);
+			return false;
+		}
+	}
+
+	for (int size : benchmarkSizes) {
+		u32 pitch = size * 4;
+		BenchmarkDecoder("Unswizzle 8888", size, size, pitch * size, [&] {
+			DoUnswizzleTex16(src.data(), dest.data(), pitch / 16, size / 8, pitch);
+		});
+	}
+	return true;
+}
+
+static bool TestDecoderCheckAlpha(TestRandom &rng) {
+	typedef CheckAlphaResult (*CheckAlphaFunc)(const u32 *pixelData, int stride, int w, int h);
+	struct AlphaFormat {
+		const char *name;
+		CheckAlphaFunc func;
+		int bpp;
+		u32 alphaMask;
+	};
+	static const AlphaFormat formats[] = {
+		{ "CheckAlpha RGBA8888", &CheckAlphaRGBA8888Basic, 4, 0xFF000000 },
+		{ "CheckAlpha ABGR4444", &CheckAlphaABGR4444Basic, 2, 0x000F },
+		{ "CheckAlpha RGBA4444", &CheckAlphaRGBA4444Basic, 2, 0xF000 },
+		{ "CheckAlpha ABGR1555", &CheckAlphaABGR1555Basic, 2, 0x0001 },
+		{ "CheckAlpha RGBA5551", &CheckAlphaRGBA5551Basic, 2, 0x8000 },
+	};
+
+	std::vector<u32> buf(512 * 512);
+	for (const AlphaFormat &format : formats) {
+		const int pixelsPerWord = 4 / format.bpp;
+		for (int i = 0; i < 300; ++i) {
+			// Widths and strides are in pixels, and the SIMD paths want them in steps of 16 bytes.
+			int w = (rng.Next() & 1) ? rng.Range(1, 32) * 8 : rng.Range(1, 256);
+			int h = rng.Range(1, 64);
+			int strideBytes = ((w * format.bpp + 3) & ~3) + ((rng.Next() & 1) ? 0 : rng.Range(1, 4) * 4);
+			int stride = strideBytes / 4;
+
+			// The padding is opaque too, since the plain 16-bit checks look at pixels in pairs.
+			rng.Fill(buf.data(), strideBytes * h);
+			for (int y = 0; y < h; ++y) {
+				for (int x = 0; x < stride * pixelsPerWord; ++x) {
+					if (format.bpp == 4)
+						buf[y * stride + x] |= format.alphaMask;
+					else
+						((u16 *)buf.data())[y * stride * 2 + x] |= format.alphaMask;
+				}
+			}
+			// Half the time, make one pixel not opaque.
+			if (rng.Next() & 1) {
+				int x = rng.Range(0, w - 1);
+				int y = rng.Range(0, h - 1);
+				if (format.bpp == 4)
+					buf[y * stride + x] &= ~format.alphaMask;
+				else
+					((u16 *)buf.data())[y * stride * 2 + x] &= ~format.alphaMask;
+			}
+
+			CheckAlphaResult expected = Reference::CheckAlpha(buf.data(), stride, w, h, format.bpp, format.alphaMask);
+			CheckAlphaResult actual = format.func(buf.data(), stride * pixelsPerWord, w, h);
+			if (actual != expected) {
+				printf("%s mismatch: %dx%d, stride %d: %d vs %d\n", format.name, w, h, stride, actual, expected);
+				return false;
+			}
+		}
+
+		for (int size : benchmarkSizes) {
+			// All opaque, so it has to look at everything.
+			for (int i = 0; i < size * size / pixelsPerWord; ++i)
+				buf[i] = 0xFFFFFFFF;
+			BenchmarkDecoder(format.name, size, size, size * size * format.bpp, [&] {
+				format.func(buf.data(), size, size, size);
+			});
+		}
+	}
+	return true;
+}
+
+static bool TestDecoderDeIndex4(TestRandom &rng) {
+	std::vector<u8> indexed(512 * 512 / 2);
+	std::vector<u16> dest(512 * 512);
+	std::vector<u16> expected(512 * 512);
+	rng.Fill(indexed.data(), 512 * 512 / 2);
+
+	for (int i = 0; i < 200; ++i) {
+		int length = rng.Range(1, 128) * 4;
+		u16 color = (u16)rng.Next();
+
+		DeIndexTexture4Optimal(dest.data(), indexed.data(), length, (u16)(color & 0xFFF0));
+		Reference::DeIndexTexture4(expected.data(), indexed.data(), length, color & 0xFFF0, 0);
+		if (memcmp(dest.data(), expected.data(), length * 2) != 0) {
+			printf("DeIndexTexture4Optimal mismatch: length %d, color %04x\n", length, color);
+			return false;
+		}
+
+		DeIndexTexture4OptimalRev(dest.data(), indexed.data(), length, (u16)(color & 0x0FFF));
+		Reference::DeIndexTexture4(expected.data(), indexed.data(), length, color & 0x0FFF, 12);
+		if (memcmp(dest.data(), expected.data(), length * 2) != 0) {
+			printf("DeIndexTexture4OptimalRev mismatch: length %d, color %04x\n", length, color);
+			return false;
+		}
+	}
+
+	for (int size : benchmarkSizes) {
+		BenchmarkDecoder("DeIndexTexture4Optimal CLUT4", size, size, size * size / 2, [&] {
+			for (int y = 0; y < size; ++y)
+				DeIndexTexture4Optimal(dest.data() + y * size, indexed.data() + y * size / 2, size, (u16)0xABC0);
+		});
+	}
+	return true;
+}
+
+static bool TestDecoderDeIndex32(TestRandom &rng) {
+	std::vector<u8> indexed(512 * 512);
+	std::vector<u32> clut(256);
+	std::vector<u32> dest(512 * 512);
+	rng.Fill(indexed.data(), indexed.size());
+	rng.Fill(clut.data(), clut.size() * 4);
+
+	for (int i = 0; i < 200; ++i) {
+		int length = rng.Range(1, 256) * 2;
+		int offset = rng.Range(0, 15);
+
+		DeIndexTexture8To32(dest.data(), indexed.data() + offset, length, clut.data());
+		for (int x = 0; x < length; ++x) {
+			if (dest[x] != clut[indexed[offset + x]]) {
+				printf("DeIndexTexture8To32 mismatch: length %d, pixel %d\n", length, x);
+				return false;
+			}
+		}
+
+		DeIndexTexture4To32(dest.data(), indexed.data() + offset, length, clut.data());
+		for (int x = 0; x < length; ++x) {
+			if (dest[x] != clut[(indexed[offset + x / 2] >> ((x & 1) * 4)) & 0xF]) {
+				printf("DeIndexTexture4To32 mismatch: length %d, pixel %d\n", length, x);
+				return false;
+			}
+		}
+	}
+
+	for (int size : benchmarkSizes) {
+		BenchmarkDecoder("DeIndexTexture CLUT8 to 8888", size, size, size * size, [&] {
+			DeIndexTexture8To32(dest.data(), indexed.data(), size * size, clut.data());
+		});
+		BenchmarkDecoder("DeIndexTexture CLUT4 to 8888", size, size, size * size / 2, [&] {
+			DeIndexTexture4To32(dest.data(), indexed.data(), size * size, clut.data());
+		});
+	}
+	return true;
+}
+
+static bool TestDecoderColorConv(TestRandom &rng) {
+	std::vector<u16> src(512 * 512 + 8);
+	std::vector<u32> dest32(512 * 512 + 8);
+	std::vector<u16> dest16(512 * 512 + 8);
+	rng.Fill(src.data(), src.size() * 2);
+
+	for (int i = 0; i < 200; ++i) {
+		u32 length = rng.Range(1, 300);
+		int offset = rng.Range(0, 7);
+		const u16 *s = src.data() + offset;
+
+		ConvertRGBA4444ToRGBA8888(dest32.data() + offset, s, length);
+		for (u32 x = 0; x < length; ++x)
+			EXPECT_EQ_HEX(dest32[offset + x], RGBA4444ToRGBA8888(s[x]));
+		ConvertRGBA5551ToRGBA8888(dest32.data() + offset, s, length);
+		for (u32 x = 0; x < length; ++x)
+			EXPECT_EQ_HEX(dest32[offset + x], RGBA5551ToRGBA8888(s[x]));
+		ConvertRGB565ToRGBA8888(dest32.data() + offset, s, length);
+		for (u32 x = 0; x < length; ++x)
+			EXPECT_EQ_HEX(dest32[offset + x], RGB565ToRGBA8888(s[x]));
+
+		ConvertRGBA4444ToABGR4444(dest16.data() + offset, s, length);
+		for (u32 x = 0; x < length; ++x)
+			EXPECT_EQ_HEX(dest16[offset + x], (u16)((s[x] >> 12) | ((s[x] >> 4) & 0x00F0) | ((s[x] << 4) & 0x0F00) | (s[x] << 12)));
+		ConvertRGBA5551ToABGR1555(dest16.data() + offset, s, length);
+		for (u32 x = 0; x < length; ++x)
+			EXPECT_EQ_HEX(dest16[offset + x], (u16)((s[x] >> 15) | ((s[x] >> 9) & 0x003E) | ((s[x] << 1) & 0x07C0) | (s[x] << 11)));
+		ConvertRGB565ToBGR565(dest16.data() + offset, s, length);
+		for (u32 x = 0; x < length; ++x)
+			EXPECT_EQ_HEX(dest16[offset + x], (u16)((s[x] >> 11) | (s[x] & 0x07E0) | (s[x] << 11)));
+	}
+
+	for (int size : benchmarkSizes) {
+		const u32 pixels = size * size;
+		BenchmarkDecoder("ConvertRGBA4444ToRGBA8888", size, size, pixels * 2, [&] {
+			ConvertRGBA4444ToRGBA8888(dest32.data(), src.data(), pixels);
+		});
+		BenchmarkDecoder("ConvertRGBA5551ToRGBA8888", size, size, pixels * 2, [&] {
+			ConvertRGBA5551ToRGBA8888(dest32.data(), src.data(), pixels);
+		});
+		BenchmarkDecoder("ConvertRGB565ToRGBA8888", size, size, pixels * 2, [&] {
+			ConvertRGB565ToRGBA8888(dest32.data(), src.data(), pixels);
+		});
+		BenchmarkDecoder("ConvertRGBA4444ToABGR4444", size, size, pixels * 2, [&] {
+			ConvertRGBA4444ToABGR4444(dest16.data(), src.data(), pixels);
+		});
+	}
+	return true;
+}
+
+static bool TestDecoderDXT(TestRandom &rng) {
+	std::vector<u8> blocks(512 * 512);
+	std::vector<u32> dest(512 * 512);
+	rng.Fill(blocks.data(), 512 * 512);
+
+	// Equal colors take the other interpolation mode, make sure some blocks have them.
+	for (int i = 0; i < 1000; i += 7) {
+		memcpy(&blocks[i * 16 + 6], &blocks[i * 16 + 4], 2);
+		blocks[i * 16 + 15] = blocks[i * 16 + 14];
+	}
+
+	// Each texel against the reference, and nothing written outside the block.
+	for (int i = 0; i < 1000; ++i) {
+		const u8 *block = &blocks[i * 16];
+		const int height = rng.Range(1, 4);
+		const int type = i % 4;
+		for (int j = 0; j < 8 * 8; ++j)
+			dest[j] = 0xDEADBEEF;
+		switch (type) {
+		case 0: DecodeDXT1Block(dest.data(), (const DXT1Block *)block, 8, height, false); break;
+		case 1: DecodeDXT1Block(dest.data(), (const DXT1Block *)block, 8, height, true); break;
+		case 2: DecodeDXT3Block(dest.data(), (const DXT3Block *)block, 8, height); break;
+		case 3: DecodeDXT5Block(dest.data(), (const DXT5Block *)block, 8, height); break;
+		}
+
+		for (int y = 0; y < 8; ++y) {
+			for (int x = 0; x < 8; ++x) {
+				const u32 actual = dest[y * 8 + x];
+				if (x >= 4 || y >= height) {
+					EXPECT_EQ_HEX(actual, 0xDEADBEEF);
+					continue;
+				}
+
+				// DXT3 and DXT5 start with a DXT1 block, but with alpha from elsewhere.
+				u32 expected = Reference::DXTColor(block, x, y, type == 0);
+				if (type == 2)
+					expected |= Reference::DXT3Alpha(block, x, y) << 24;
+				if (type == 3) {
+					float alpha = Reference::DXT5Alpha(block, x, y);
+					if (fabsf((float)(actual >> 24) - alpha) >= 1.0f) {
+						printf("DXT5 block %d texel %d,%d: alpha %d, expected %0.2f\n", i, x, y, actual >> 24, alpha);
+						return false;
+					}
+					expected |= actual & 0xFF000000;
+				}
+				if (actual != expected) {
+					printf("DXT type %d block %d texel %d,%d: %08x, expected %08x\n", type, i, x, y, actual, expected);
+					return false;
+				}
+			}
+		}
+	}
+
+	for (int size : benchmarkSizes) {
+		const int blocksPerRow = size / 4;
+		BenchmarkDecoder("DXT1", size, size, size * size / 2, [&] {
+			const DXT1Block *src = (const DXT1Block *)blocks.data();
+			for (int y = 0; y < size; y += 4) {
+				for (int x = 0; x < blocksPerRow; ++x)
+					DecodeDXT1Block(dest.data() + y * size + x * 4, src++, size, 4, false);
+			}
+		});
+		BenchmarkDecoder("DXT3", size, size, size * size, [&] {
+			const DXT3Block *src = (const DXT3Block *)blocks.data();
+			for (int y = 0; y < size; y += 4) {
+				for (int x = 0; x < blocksPerRow; ++x)
+					DecodeDXT3Block(dest.data() + y * size + x * 4, src++, size, 4);
+			}
+		});
+		BenchmarkDecoder("DXT5", size, size, size * size, [&] {
+			const DXT5Block *src = (const DXT5Block *)blocks.data();
+			for (int y = 0; y < size; y += 4) {
+				for (int x = 0; x < blocksPerRow; ++x)
+					DecodeDXT5Block(dest.data() + y * size + x * 4, src++, size, 4);
+			}
+		});
+	}
+	return true;
+}
+
+bool TestTextureDecoder() {
+	SetupTextureDecoder();
+
+	TestRandom rng;
+	RET(TestDecoderQuickTexHash(rng));
+	RET(TestDecoderUnswizzle(rng));
+	RET(TestDecoderCheckAlpha(rng));
+	RET(TestDecoderDeIndex4(rng));
+	RET(TestDecoderDeIndex32(rng));
+	RET(TestDecoderColorConv(rng));
+	RET(TestDecoderDXT(rng));
+	return true;
+}
@@ -0,0 +1,196 @@
+// Copyright (c) 2021- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Common/CPUDetect.h"
+#include "GPU/Common/TextureScalerCommon.h"
+#include "unittest/UnitTest.h"
+
+enum class ScalerTestType {
+	DEPOSTERIZE,
+	XBRZ,
+	HYBRID,
+	BICUBIC,
+	HYBRID_BICUBIC,
+};
+
+static const char *const scalerTestNames[] = {
+	"Deposterize",
+	"xBRZ",
+	"Hybrid",
+	"Bicubic",
+	"Hybrid + Bicubic",
+};
+
+// Always 8888, so the scalers can be called directly.
+class TextureScalerTestHarness : public TextureScalerCommon {
+public:
+	void Run(ScalerTestType type, int factor, u32 *source, u32 *dest, int width, int height) {
+		switch (type) {
+		case ScalerTestType::DEPOSTERIZE: DePosterize(source, dest, width, height); break;
+		case ScalerTestType::XBRZ: ScaleXBRZ(factor, source, dest, width, height); break;
+		case ScalerTestType::HYBRID: ScaleHybrid(factor, source, dest, width, height); break;
+		case ScalerTestType::BICUBIC: ScaleBicubicMitchell(factor, source, dest, width, height); break;
+		case ScalerTestType::HYBRID_BICUBIC: ScaleHybrid(factor, source, dest, width, height, true); break;
+		}
+	}
+
+	// Returns megapixels of output per second.
+	double RunTimed(ScalerTestType type, int factor, u32 *source, u32 *dest, int width, int height) {
+		int outFactor = type == ScalerTestType::DEPOSTERIZE ? 1 : factor;
+		return TimeWorkRate([&] {
+			Run(type, factor, source, dest, width, height);
+			return (double)width * outFactor * height * outFactor;
+		}, 0.1) / 1000000.0;
+	}
+
+protected:
+	void ConvertTo8888(u32 format, u32 *source, u32 *&dest, int width, int height) override {
+		dest = source;
+	}
+	int BytesPerPixel(u32 format) override {
+		return 4;
+	}
+	u32 Get8888Format() override {
+		return 0;
+	}
+};
+
+struct ScalerSIMDFlags {
+	bool sse2;
+	bool sse4_1;
+	bool avx2;
+	bool neon;
+};
+
+static ScalerSIMDFlags DisableScalerSIMD() {
+	ScalerSIMDFlags saved{ cpu_info.bSSE2, cpu_info.bSSE4_1, cpu_info.bAVX2, cpu_info.bNEON };
+	cpu_info.bSSE2 = false;
+	cpu_info.bSSE4_1 = false;
+	cpu_info.bAVX2 = false;
+	cpu_info.bNEON = false;
+	return saved;
+}
+
+static void RestoreScalerSIMD(const ScalerSIMDFlags &saved) {
+	cpu_info.bSSE2 = saved.sse2;
+	cpu_info.bSSE4_1 = saved.sse4_1;
+	cpu_info.bAVX2 = saved.avx2;
+	cpu_info.bNEON = saved.neon;
+}
+
+// Posterized gradients with some noisy blocks, so every path has something to do.
+static void GenerateTestTexture(u32 *data, int w, int h) {
+	u32 seed = 0x1234567;
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			seed = seed * 1103515245 + 12345;
+			u32 r = (x * 255 / w) & 0xF0;
+			u32 g = (y * 255 / h) & 0xF8;
+			u32 b = ((x + y) * 127 / (w + h)) & 0xF0;
+			u32 a = (x / 8 + y / 8) & 1 ? 0xFF : 0x80;
+			if (((x / 8) ^ (y / 16)) % 5 == 0) {
+				r = (seed >> 8) & 0xFF;
+				g = (seed >> 16) & 0xFF;
+			}
+			data[y * w + x] = (a << 24) | (b << 16) | (g << 8) | r;
+		}
+	}
+}
+
+static bool PixelsClose(u32 a, u32 b, int tolerance) {
+	for (int c = 0; c < 32; c += 8) {
+		if (abs((int)((a >> c) & 0xFF) - (int)((b >> c) & 0xFF)) > tolerance)
+			return false;
+	}
+	return true;
+}
+
+static bool CompareScaled(const char *name, int factor, const std::vector<u32> &a, const std::vector<u32> &b, int outPixels, int tolerance, const char *what) {
+	for (int i = 0; i < outPixels; ++i) {
+		if (!PixelsClose(a[i], b[i], tolerance)) {
+			printf("%s %dx: Mismatch %s at pixel %d: %08x vs %08x\n", name, factor, what, i, a[i], b[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Checks the fastest path against the one without AVX2 and the one without any SIMD, and times each when timed
+// is set.  Odd sizes make the SIMD loops leave a remainder.
+static bool TestScalerSize(TextureScalerTestHarness &scaler, int w, int h, bool timed) {
+	static const int MAX_FACTOR = 5;
+
+	std::vector<u32> source(w * h);
+	std::vector<u32> simd(w * h * MAX_FACTOR * MAX_FACTOR);
+	std::vector<u32> sse(w * h * MAX_FACTOR * MAX_FACTOR);
+	std::vector<u32> scalar(w * h * MAX_FACTOR * MAX_FACTOR);
+	GenerateTestTexture(source.data(), w, h);
+
+	for (int t = 0; t < (int)ARRAY_SIZE(scalerTestNames); ++t) {
+		ScalerTestType type = (ScalerTestType)t;
+		const int firstFactor = type == ScalerTestType::DEPOSTERIZE ? 1 : 2;
+		const int lastFactor = type == ScalerTestType::DEPOSTERIZE ? 1 : MAX_FACTOR;
+		// The SSE4.1 and AVX2 bicubic round to nearest, the plain one rounds up.
+		const int tolerance = type == ScalerTestType::BICUBIC || type == ScalerTestType::HYBRID_BICUBIC ? 1 : 0;
+
+		for (int factor = firstFactor; factor <= lastFactor; ++factor) {
+			const int outFactor = type == ScalerTestType::DEPOSTERIZE ? 1 : factor;
+			const int outPixels = w * outFactor * h * outFactor;
+
+			scaler.Run(type, factor, source.data(), simd.data(), w, h);
+			double simdSpeed = timed ? scaler.RunTimed(type, factor, source.data(), simd.data(), w, h) : 0.0;
+
+			const bool hasAVX2 = cpu_info.bAVX2;
+			double sseSpeed = 0.0;
+			if (hasAVX2) {
+				cpu_info.bAVX2 = false;
+				scaler.Run(type, factor, source.data(), sse.data(), w, h);
+				sseSpeed = timed ? scaler.RunTimed(type, factor, source.data(), sse.data(), w, h) : 0.0;
+				cpu_info.bAVX2 = true;
+			}
+
+			ScalerSIMDFlags saved = DisableScalerSIMD();
+			scaler.Run(type, factor, source.data(), scalar.data(), w, h);
+			double scalarSpeed = timed ? scaler.RunTimed(type, factor, source.data(), scalar.data(), w, h) : 0.0;
+			RestoreScalerSIMD(saved);
+
+			if (timed && hasAVX2) {
+				printf("%s %dx: %0.2f MP/s (%0.2f MP/s without AVX2, %0.2f MP/s without SIMD)\n", scalerTestNames[t], factor, simdSpeed, sseSpeed, scalarSpeed);
+			} else if (timed) {
+				printf("%s %dx: %0.2f MP/s (%0.2f MP/s without SIMD)\n", scalerTestNames[t], factor, simdSpeed, scalarSpeed);
+			}
+
+			if (hasAVX2)
+				RET(CompareScaled(scalerTestNames[t], factor, simd, sse, outPixels, tolerance, "without AVX2"));
+			RET(CompareScaled(scalerTestNames[t], factor, simd, scalar, outPixels, tolerance, "without SIMD"));
+		}
+	}
+
+	return true;
+}
+
+bool TestTextureScaler() {
+	TextureScalerTestHarness scaler;
+	RET(TestScalerSize(scaler, 37, 29, false));
+	RET(TestScalerSize(scaler, 128, 96, true));
+	return true;
+}
@@ -15,6 +15,8 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <vector>
+
 #include "Common/Common.h"
 #include "Common/TimeUtil.h"
 #include "Core/Config.h"
@@ -631,6 +633,46 @@ static bool TestVertexFloatSkin() {
 	return !dec.HasFailed();
 }
 
+// Big draws are decoded on several threads, which must match decoding each vertex alone.
+static bool TestVertexFloatSkinParallel() {
+	static const int COUNT = 8192;
+
+	g_Config.bSoftwareSkinning = true;
+	for (int i = 0; i < 8 * 12; ++i) {
+		gstate.boneMatrix[i] = (float)((i * 7) % 11) - 5.0f;
+	}
+
+	// Two weights, then normal and position.
+	int vtype = GE_VTYPE_POS_FLOAT | GE_VTYPE_NRM_FLOAT | GE_VTYPE_WEIGHT_FLOAT | (1 << GE_VTYPE_WEIGHTCOUNT_SHIFT);
+	std::vector<float> src(COUNT * 8);
+	for (int i = 0; i < COUNT * 8; ++i) {
+		src[i] = (float)((i * 13) % 17) * 0.125f - 1.0f;
+	}
+
+	bool failed = false;
+	for (int jit = 0; jit <= 1; ++jit) {
+		VertexDecoderJitCache cache;
+		VertexDecoderOptions options{};
+		VertexDecoder dec;
+		dec.SetVertexType(vtype, options, jit == 1 ? &cache : nullptr);
+		const int stride = dec.GetDecVtxFmt().stride;
+
+		std::vector<u8> all(COUNT * stride);
+		std::vector<u8> single(COUNT * stride);
+		dec.DecodeVerts(all.data(), src.data(), 0, COUNT - 1);
+		for (int i = 0; i < COUNT; ++i) {
+			dec.DecodeVerts(single.data() + i * stride, src.data(), i, i);
+		}
+
+		if (memcmp(all.data(), single.data(), COUNT * stride) != 0) {
+			printf("TestVertexFloatSkinParallel: mismatch (%s)\n", jit == 1 ? "jit" : "steps");
+			failed = true;
+		}
+	}
+
+	return !failed;
+}
+
 // TODO: Morph (col, pos, nrm), weights (no skin), morph + weights?
 
 typedef bool (*VertexTestFunc)();
@@ -652,6 +694,7 @@ static VertexTestFunc vertdecTestFuncs[] = {
 	&TestVertex8Skin,
 	&TestVertex16Skin,
 	&TestVertexFloatSkin,
+	&TestVertexFloatSkinParallel,
 };
 
 bool TestVertexJit() {
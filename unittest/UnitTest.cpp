@@ -47,6 +47,7 @@
 #include "Common/ArmEmitter.h"
 #include "Common/BitScan.h"
 #include "Common/CPUDetect.h"
+#include "Common/Thread/ThreadPool.h"
 #include "Common/Log.h"
 #include "Core/Config.h"
 #include "Core/FileSystems/ISOFileSystem.h"
@@ -513,6 +514,62 @@ bool TestCLZ() {
 	return true;
 }
 
+struct SquareTask : public Task {
+	void Run() override {
+		result = value * value;
+	}
+
+	int value = 0;
+	int result = 0;
+};
+
+bool TestThreadPool() {
+	ThreadPool pool(4);
+
+	// Every index exactly once.
+	std::vector<std::atomic<int>> counts(10000);
+	for (auto &count : counts)
+		count = 0;
+	pool.ParallelLoop([&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i)
+			counts[i]++;
+	}, 0, (int)counts.size());
+	for (auto &count : counts)
+		EXPECT_EQ_INT(count.load(), 1);
+
+	// Loops within loops, which would deadlock if the inner ones just blocked.
+	std::atomic<int> total(0);
+	pool.ParallelLoop([&](int lower, int upper) {
+		for (int i = lower; i < upper; ++i) {
+			pool.ParallelLoop([&](int l, int u) {
+				total += u - l;
+			}, 0, 100, TaskPriority::HIGH);
+		}
+	}, 0, 64);
+	EXPECT_EQ_INT(total.load(), 6400);
+
+	SquareTask tasks[100];
+	for (int i = 0; i < 100; ++i) {
+		tasks[i].value = i;
+		pool.Submit(&tasks[i]);
+	}
+	for (int i = 0; i < 100; ++i) {
+		pool.Wait(&tasks[i]);
+		EXPECT_EQ_INT(tasks[i].result, i * i);
+	}
+
+	// Tasks that wait on other tasks.
+	auto outer = MakeFutureTask([&] {
+		auto inner = MakeFutureTask([] { return 21; }, TaskPriority::HIGH);
+		pool.Submit(&inner);
+		return inner.Get() * 2;
+	}, TaskPriority::LOW);
+	pool.Submit(&outer);
+	EXPECT_EQ_INT(outer.Get(), 42);
+
+	return true;
+}
+
 static bool TestMemMap() {
 	Memory::g_MemorySize = Memory::RAM_DOUBLE_SIZE;
 
@@ -572,6 +629,19 @@ bool TestArmEmitter();
 bool TestArm64Emitter();
 bool TestX64Emitter();
 bool TestShaderGenerators();
+bool TestTextureScaler();
+bool TestTextureDecoder();
+bool TestSoftwareTransform();
+bool TestIndexGenerator();
+bool TestSasAudio();
+bool TestStereoResampler();
+bool TestColorConv();
+bool TestSpline();
+bool TestPixelJit();
+bool TestRewind();
+bool TestCHD();
+bool TestIRToX86();
+bool TestIRThreaded();
 
 TestItem availableTests[] = {
 #if PPSSPP_ARCH(ARM64) || PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(X86)
@@ -594,7 +664,24 @@ TestItem availableTests[] = {
 	TEST_ITEM(ParseLBN),
 	TEST_ITEM(QuickTexHash),
 	TEST_ITEM(CLZ),
+	TEST_ITEM(ThreadPool),
 	TEST_ITEM(ShaderGenerators),
+	TEST_ITEM(TextureScaler),
+	TEST_ITEM(TextureDecoder),
+	TEST_ITEM(SoftwareTransform),
+	TEST_ITEM(IndexGenerator),
+	TEST_ITEM(SasAudio),
+	TEST_ITEM(StereoResampler),
+	TEST_ITEM(ColorConv),
+	TEST_ITEM(Spline),
+	TEST_ITEM(PixelJit),
+	TEST_ITEM(Rewind),
+	TEST_ITEM(CHD),
+	TEST_ITEM(IRTraces),
+	TEST_ITEM(IRThreaded),
+#if PPSSPP_ARCH(AMD64)
+	TEST_ITEM(IRToX86),
+#endif
 };
 
 int main(int argc, const char *argv[]) {
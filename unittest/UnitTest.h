@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+#include "Common/TimeUtil.h"
+
 #define EXPECT_TRUE(a) if (!(a)) { printf("%s:%i: Test Fail\n", __FUNCTION__, __LINE__); return false; }
 #define EXPECT_FALSE(a) if ((a)) { printf("%s:%i: Test Fail\n", __FUNCTION__, __LINE__); return false; }
 #define EXPECT_EQ_INT(a, b) if ((a) != (b)) { printf("%s:%i: Test Fail\n%d\nvs\n%d\n", __FUNCTION__, __LINE__, a, b); return false; }
@@ -9,3 +14,45 @@
 #define EXPECT_EQ_STR(a, b) if (a != b) { printf("%s: Test Fail\n%s\nvs\n%s\n", __FUNCTION__, a.c_str(), b.c_str()); return false; }
 
 #define RET(a) if (!(a)) { return false; }
+
+// Repeatable random inputs for tests, so a failure shows up the same way on every run.
+class TestRandom {
+public:
+	explicit TestRandom(u32 seed = 0x5EED) : state_(seed) {}
+
+	// 24 random bits.
+	u32 Next() {
+		state_ = state_ * 1103515245 + 12345;
+		return state_ >> 8;
+	}
+	// Between lo and hi, inclusive.
+	int Range(int lo, int hi) {
+		return lo + (int)(Next() % (u32)(hi - lo + 1));
+	}
+	// Between lo and hi, in steps of 1/256.
+	float Float(float lo, float hi) {
+		return lo + (hi - lo) * (float)(Next() & 0xFF) * (1.0f / 256.0f);
+	}
+	void Fill(void *data, size_t size) {
+		u8 *p = (u8 *)data;
+		for (size_t i = 0; i < size; ++i)
+			p[i] = (u8)Next();
+	}
+
+private:
+	u32 state_;
+};
+
+// Calls func until at least the given time has passed.  func returns how much work it did
+// (pixels, bytes, vertices...), and the result is that work per second.
+template <typename F>
+double TimeWorkRate(F func, double seconds = 0.05) {
+	double total = 0.0;
+	double st = time_now_d();
+	double elapsed;
+	do {
+		total += (double)func();
+		elapsed = time_now_d() - st;
+	} while (elapsed < seconds);
+	return total / elapsed;
+}
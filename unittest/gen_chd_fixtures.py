@@ -0,0 +1,345 @@
+#!/usr/bin/env python3
+# Generates the small CHD images TestCHD.cpp reads, into TestCHDImages.h.
+#
+# Each image is a v5 CHD with a compressed map.  The last stored hunk of each image is uncompressed,
+# and left out to keep the header small: the test appends it itself, from the same sector contents.
+
+import heapq
+import lzma
+import struct
+import zlib
+
+SECTOR = 2048
+CD_FRAME = 2448
+CD_SECTOR = 2352
+
+TYPE_0, TYPE_1, TYPE_2, TYPE_3, NONE, SELF = 0, 1, 2, 3, 4, 5
+
+
+def tag(s):
+    return struct.unpack('>I', s.encode())[0]
+
+
+class TestRandom:
+    # Same as TestRandom in UnitTest.h.
+    def __init__(self, seed):
+        self.state = seed & 0xFFFFFFFF
+
+    def next(self):
+        self.state = (self.state * 1103515245 + 12345) & 0xFFFFFFFF
+        return self.state >> 8
+
+    def range(self, lo, hi):
+        return lo + self.next() % (hi - lo + 1)
+
+
+def fill_sector(seed):
+    # Same as FillSector in TestCHD.cpp.
+    rng = TestRandom(seed * 0x9E37 + 1)
+    data = bytearray(SECTOR)
+    pos = 0
+    while pos < SECTOR:
+        kind = rng.range(0, 15)
+        length = min(rng.range(4, 128), SECTOR - pos)
+        dist = rng.range(1, 300)
+        for _ in range(length):
+            if kind == 0:
+                data[pos] = rng.next() & 0xFF
+            elif kind == 1 or pos < dist:
+                data[pos] = ord('a') + rng.range(0, 7)
+            else:
+                data[pos] = data[pos - dist]
+            pos += 1
+    return bytes(data)
+
+
+def compress_lzma(data):
+    return lzma.compress(data, format=lzma.FORMAT_RAW, filters=[{'id': lzma.FILTER_LZMA1, 'lc': 3, 'lp': 0, 'pb': 2, 'dict_size': 1 << 16}])
+
+
+def compress_deflate(data):
+    c = zlib.compressobj(9, zlib.DEFLATED, -15)
+    return c.compress(data) + c.flush()
+
+
+def crc16(crc, data):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+class BitWriter:
+    def __init__(self):
+        self.bits = []
+
+    def write(self, value, count):
+        for i in reversed(range(count)):
+            self.bits.append((value >> i) & 1)
+
+    def data(self):
+        bits = self.bits + [0] * (-len(self.bits) % 8)
+        return bytes(int(''.join(map(str, bits[i:i + 8])), 2) for i in range(0, len(bits), 8))
+
+
+def huffman_lengths(freqs, max_bits):
+    """Code lengths for each symbol, squashing the counts until they fit in max_bits."""
+    while True:
+        used = [i for i, f in enumerate(freqs) if f > 0]
+        if len(used) == 1:
+            # A single code still needs a complete tree.
+            used.append(0 if used[0] != 0 else 1)
+        heap = [(max(freqs[i], 1), i, [i]) for i in used]
+        heapq.heapify(heap)
+        lengths = [0] * len(freqs)
+        while len(heap) > 1:
+            fa, ia, a = heapq.heappop(heap)
+            fb, ib, b = heapq.heappop(heap)
+            for i in a + b:
+                lengths[i] += 1
+            heapq.heappush(heap, (fa + fb, min(ia, ib), a + b))
+        if max(lengths) <= max_bits:
+            return lengths
+        freqs = [(f + 1) // 2 for f in freqs]
+
+
+def canonical_codes(lengths):
+    # Same assignment as CHDHuffmanDecoder::BuildLookup: longest codes first.
+    histogram = [0] * 33
+    for n in lengths:
+        histogram[n] += 1
+    start = 0
+    for n in range(32, 0, -1):
+        next_start = (start + histogram[n]) >> 1
+        histogram[n] = start
+        start = next_start
+    codes = [0] * len(lengths)
+    for i, n in enumerate(lengths):
+        if n:
+            codes[i] = histogram[n]
+            histogram[n] += 1
+    return codes
+
+
+def compress_huffman(data):
+    """The 'huff' codec: the tree, huffman coded itself, then the bytes."""
+    freqs = [0] * 256
+    for b in data:
+        freqs[b] += 1
+    lengths = huffman_lengths(freqs, 16)
+    codes = canonical_codes(lengths)
+
+    # The lengths, as literals (length + 1) or 0 for a repeat of the last one.
+    tokens = []
+    i = 0
+    while i < 256:
+        last = lengths[i]
+        tokens.append((last + 1, None))
+        i += 1
+        run = 0
+        while i + run < 256 and lengths[i + run] == last:
+            run += 1
+        i += run
+        while run >= 2:
+            take = min(run, 9 + 255)
+            tokens.append((0, take))
+            run -= take
+        if run == 1:
+            tokens.append((last + 1, None))
+
+    small_freqs = [0] * 24
+    for symbol, _ in tokens:
+        small_freqs[symbol] += 1
+    small_lengths = huffman_lengths(small_freqs, 6)
+    small_codes = canonical_codes(small_lengths)
+
+    bits = BitWriter()
+    bits.write(small_lengths[0], 3)
+    start = next(i for i in range(1, 24) if small_lengths[i])
+    assert start <= 8
+    bits.write(start - 1, 3)
+    end = max(i for i in range(24) if small_lengths[i])
+    for i in range(start, 24):
+        if i > end:
+            # 7 ends the list, the rest are unused.
+            bits.write(7, 3)
+            break
+        bits.write(small_lengths[i], 3)
+
+    for symbol, repeat in tokens:
+        bits.write(small_codes[symbol], small_lengths[symbol])
+        if symbol == 0:
+            if repeat < 9:
+                bits.write(repeat - 2, 3)
+            else:
+                bits.write(7, 3)
+                bits.write(repeat - 9, 8)
+
+    for b in data:
+        bits.write(codes[b], lengths[b])
+    return bits.data()
+
+
+def compress_map(hunks, first_offset, hunk_bytes):
+    # Every code 4 bits long, so each type is written as itself.
+    bits = BitWriter()
+    for _ in range(16):
+        bits.write(4, 4)
+    for hunk_type, _ in hunks:
+        bits.write(hunk_type, 4)
+
+    length_bits, self_bits, parent_bits = 16, 8, 1
+    crc = 0xFFFF
+    offset = first_offset
+    for hunk_type, value in hunks:
+        if hunk_type == SELF:
+            bits.write(value, self_bits)
+            raw = struct.pack('>B3s6sH', SELF, b'\0\0\0', value.to_bytes(6, 'big'), 0)
+        else:
+            length = hunk_bytes if hunk_type == NONE else len(value)
+            if hunk_type != NONE:
+                bits.write(length, length_bits)
+            bits.write(0, 16)
+            raw = struct.pack('>B3s6sH', hunk_type, length.to_bytes(3, 'big'), offset.to_bytes(6, 'big'), 0)
+            offset += length
+        crc = crc16(crc, raw)
+
+    compressed = bits.data()
+    header = struct.pack('>I6sHBBBB', len(compressed), first_offset.to_bytes(6, 'big'), crc, length_bits, self_bits, parent_bits, 0)
+    return header + compressed, offset
+
+
+def build_chd(compressors, hunks, hunk_bytes, unit_bytes, logical_bytes, metadata=()):
+    """hunks: (type, compressed bytes) or (SELF, source hunk) or (NONE, None), with NONE stored last."""
+    meta = b''
+    for i, text in enumerate(metadata):
+        data = text.encode() + b'\0'
+        next_offset = 0  # Patched below.
+        meta += struct.pack('>IB3sQ', tag('CHT2' if 'PGTYPE' in text else 'CHTR'), 1, len(data).to_bytes(3, 'big'), next_offset) + data
+
+    # Header, then metadata, then the map, then the hunks.
+    meta_offset = 124 if meta else 0
+    map_offset = 124 + len(meta)
+    map_size = len(compress_map(hunks, 0, hunk_bytes)[0])
+    first_offset = map_offset + map_size
+    map_data, end = compress_map(hunks, first_offset, hunk_bytes)
+
+    # Link the metadata entries together.
+    linked = bytearray(meta)
+    pos = 0
+    while pos < len(linked):
+        length = int.from_bytes(linked[pos + 5:pos + 8], 'big')
+        next_pos = pos + 16 + length
+        if next_pos < len(linked):
+            linked[pos + 8:pos + 16] = struct.pack('>Q', 124 + next_pos)
+        pos = next_pos
+
+    header = b'MComprHD' + struct.pack('>II4IQQQII', 124, 5, *compressors, logical_bytes, map_offset, meta_offset, hunk_bytes, unit_bytes) + bytes(60)
+    image = header + bytes(linked) + map_data
+    assert len(image) == first_offset
+    for hunk_type, value in hunks:
+        if hunk_type not in (SELF, NONE):
+            image += value
+    tail = end - len(image)
+    assert tail in (0, hunk_bytes)
+    return image
+
+
+def cd_frame(frame, mode, data_frames):
+    """A raw frame as chdman stores it: the 2352 byte sector, then 96 bytes of subcode."""
+    sector = bytearray(CD_SECTOR)
+    if frame in data_frames:
+        sector[0:12] = b'\0' + b'\xff' * 10 + b'\0'
+        lba = frame + 150
+        bcd = lambda v: (v // 10) * 16 + v % 10
+        sector[12:16] = bytes([bcd(lba // 4500), bcd(lba // 75 % 60), bcd(lba % 75), 1 if mode == 'MODE1_RAW' else 2])
+        offset = 16 if mode == 'MODE1_RAW' else 24
+        if mode == 'MODE2_RAW':
+            sector[16:24] = b'\0\0\x08\0\0\0\x08\0'
+        sector[offset:offset + SECTOR] = fill_sector(frame)
+    return bytes(sector), bytes(96)
+
+
+def cd_hunk(codec, frames, mode, data_frames, stripped=()):
+    base = b''
+    subcode = b''
+    ecc = bytearray((len(frames) + 7) // 8)
+    for i, frame in enumerate(frames):
+        sector, sub = cd_frame(frame, mode, data_frames)
+        if frame in stripped:
+            # chdman drops the sync and ECC of frames it can regenerate them for.
+            ecc[i // 8] |= 0x80 >> (i % 8)
+            sector = bytes(12) + sector[12:16 + SECTOR] + bytes(CD_SECTOR - 16 - SECTOR)
+        base += sector
+        subcode += sub
+    compressed = compress_lzma(base) if codec == 'cdlz' else compress_deflate(base)
+    hunk_bytes = len(frames) * CD_FRAME
+    return bytes(ecc) + len(compressed).to_bytes(3 if hunk_bytes >= 65536 else 2, 'big') + compressed + compress_deflate(subcode)
+
+
+def dvd_hunk(codec, first):
+    data = fill_sector(first) + fill_sector(first + 1)
+    if codec == 'huff':
+        return compress_huffman(data)
+    return compress_lzma(data) if codec == 'lzma' else compress_deflate(data)
+
+
+def fixtures():
+    result = []
+
+    # DVD style: 2 sectors per hunk.
+    compressors = [tag('lzma'), tag('zlib'), tag('huff'), tag('flac')]
+    hunks = [(TYPE_0, dvd_hunk('lzma', 0)), (TYPE_1, dvd_hunk('zlib', 2)), (SELF, 0), (TYPE_0, dvd_hunk('lzma', 6)), (TYPE_2, dvd_hunk('huff', 8)), (NONE, None)]
+    image = build_chd(compressors, hunks, 2 * SECTOR, SECTOR, 12 * SECTOR)
+    result.append(('DVD', image, dict(unitBytes=SECTOR, framesPerHunk=2, sectorOffset=0, firstFrame=0, numBlocks=12, tailHunk=5, sources=[0, 1, 0, 3, 4, 5])))
+
+    # A hunk needs flac, so this is refused before anything is decompressed.
+    hunks = [(TYPE_0, bytes(16)), (TYPE_1, bytes(16)), (SELF, 0), (TYPE_3, bytes(16)), (NONE, None)]
+    image = build_chd(compressors, hunks, 2 * SECTOR, SECTOR, 10 * SECTOR)
+    result.append(('DVDFlac', image, dict(unitBytes=SECTOR, framesPerHunk=2, sectorOffset=0, firstFrame=0, numBlocks=0, tailHunk=4, sources=[0, 1, 0, 3, 4])))
+
+    # One MODE1_RAW track of 7 frames, padded to 8.  2 frames per hunk.
+    compressors = [tag('cdlz'), tag('cdzl'), tag('cdfl'), 0]
+    data = range(0, 7)
+    hunks = [(TYPE_0, cd_hunk('cdlz', [0, 1], 'MODE1_RAW', data, stripped=[1])), (TYPE_1, cd_hunk('cdzl', [2, 3], 'MODE1_RAW', data)), (SELF, 0), (NONE, None)]
+    image = build_chd(compressors, hunks, 2 * CD_FRAME, CD_FRAME, 8 * CD_FRAME, ['TRACK:1 TYPE:MODE1_RAW SUBTYPE:NONE FRAMES:7'])
+    result.append(('CDMode1', image, dict(unitBytes=CD_FRAME, framesPerHunk=2, sectorOffset=16, firstFrame=0, numBlocks=7, tailHunk=3, sources=[0, 1, 0, 3])))
+
+    # An audio track in flac first, then MODE2_RAW with 2 frames of pregap stored in the image.
+    data = range(10, 13)
+    flac = (TYPE_2, bytes(16))
+    hunks = [flac, flac, flac, flac, (TYPE_1, cd_hunk('cdzl', [8, 9], 'MODE2_RAW', data)), (TYPE_0, cd_hunk('cdlz', [10, 11], 'MODE2_RAW', data)), (NONE, None), (SELF, 4)]
+    metadata = [
+        'TRACK:1 TYPE:AUDIO SUBTYPE:NONE FRAMES:5 PREGAP:0 PGTYPE:MODE1 PGSUB:RW POSTGAP:0',
+        'TRACK:2 TYPE:MODE2_RAW SUBTYPE:NONE FRAMES:5 PREGAP:2 PGTYPE:VMODE2_RAW PGSUB:RW POSTGAP:0',
+    ]
+    image = build_chd(compressors, hunks, 2 * CD_FRAME, CD_FRAME, 16 * CD_FRAME, metadata)
+    result.append(('CDMode2', image, dict(unitBytes=CD_FRAME, framesPerHunk=2, sectorOffset=24, firstFrame=10, numBlocks=3, tailHunk=6, sources=[0, 1, 2, 3, 4, 5, 6, 4])))
+
+    return result
+
+
+def main():
+    out = ['// Generated by gen_chd_fixtures.py, do not edit.', '', '#pragma once', '']
+    for name, image, info in fixtures():
+        out.append('static const u8 chd%s[] = {' % name)
+        for i in range(0, len(image), 24):
+            out.append('\t' + ' '.join('0x%02x,' % b for b in image[i:i + 24]))
+        out.append('};')
+        out.append('static const u8 chd%sSources[] = { %s };' % (name, ', '.join(map(str, info['sources']))))
+        out.append('')
+
+    out.append('static const CHDFixture chdFixtures[] = {')
+    for name, image, info in fixtures():
+        out.append('\t{ "%s", chd%s, sizeof(chd%s), %d, %d, %d, %d, %d, %d, chd%sSources, sizeof(chd%sSources) },' % (
+            name, name, name, info['unitBytes'], info['framesPerHunk'], info['sectorOffset'], info['firstFrame'], info['numBlocks'], info['tailHunk'], name, name))
+    out.append('};')
+    out.append('')
+
+    with open('TestCHDImages.h', 'w') as f:
+        f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()